@@ -54,6 +54,116 @@ extern "C" { // }
 	#define mu_strncmp strncmp
 #endif
 
+#if !defined(mu_sinf)   || \
+	!defined(mu_cosf)   || \
+	!defined(mu_tanf)   || \
+	!defined(mu_asinf)  || \
+	!defined(mu_acosf)  || \
+	!defined(mu_atanf)  || \
+	!defined(mu_atan2f) || \
+	!defined(mu_sinhf)  || \
+	!defined(mu_coshf)  || \
+	!defined(mu_tanhf)  || \
+	!defined(mu_asinhf) || \
+	!defined(mu_acoshf) || \
+	!defined(mu_atanhf) || \
+	!defined(mu_powf)   || \
+	!defined(mu_expf)   || \
+	!defined(mu_logf)   || \
+	!defined(mu_exp2f)  || \
+	!defined(mu_log2f)  || \
+	!defined(mu_sqrtf)  || \
+	!defined(mu_floorf) || \
+	!defined(mu_ceilf)  || \
+	!defined(mu_truncf) || \
+	!defined(mu_roundf) || \
+	!defined(mu_fmodf)  || \
+	!defined(mu_fmaf)   || \
+	!defined(mu_ldexpf)
+
+	#include <math.h>
+
+	#ifndef mu_sinf
+		#define mu_sinf sinf
+	#endif
+	#ifndef mu_cosf
+		#define mu_cosf cosf
+	#endif
+	#ifndef mu_tanf
+		#define mu_tanf tanf
+	#endif
+	#ifndef mu_asinf
+		#define mu_asinf asinf
+	#endif
+	#ifndef mu_acosf
+		#define mu_acosf acosf
+	#endif
+	#ifndef mu_atanf
+		#define mu_atanf atanf
+	#endif
+	#ifndef mu_atan2f
+		#define mu_atan2f atan2f
+	#endif
+	#ifndef mu_sinhf
+		#define mu_sinhf sinhf
+	#endif
+	#ifndef mu_coshf
+		#define mu_coshf coshf
+	#endif
+	#ifndef mu_tanhf
+		#define mu_tanhf tanhf
+	#endif
+	#ifndef mu_asinhf
+		#define mu_asinhf asinhf
+	#endif
+	#ifndef mu_acoshf
+		#define mu_acoshf acoshf
+	#endif
+	#ifndef mu_atanhf
+		#define mu_atanhf atanhf
+	#endif
+	#ifndef mu_powf
+		#define mu_powf powf
+	#endif
+	#ifndef mu_expf
+		#define mu_expf expf
+	#endif
+	#ifndef mu_logf
+		#define mu_logf logf
+	#endif
+	#ifndef mu_exp2f
+		#define mu_exp2f exp2f
+	#endif
+	#ifndef mu_log2f
+		#define mu_log2f log2f
+	#endif
+	#ifndef mu_sqrtf
+		#define mu_sqrtf sqrtf
+	#endif
+	#ifndef mu_floorf
+		#define mu_floorf floorf
+	#endif
+	#ifndef mu_ceilf
+		#define mu_ceilf ceilf
+	#endif
+	#ifndef mu_truncf
+		#define mu_truncf truncf
+	#endif
+	#ifndef mu_roundf
+		#define mu_roundf roundf
+	#endif
+	#ifndef mu_fmodf
+		#define mu_fmodf fmodf
+	#endif
+	#ifndef mu_fmaf
+		#define mu_fmaf fmaf
+	#endif
+	#ifndef mu_ldexpf
+		#define mu_ldexpf ldexpf
+	#endif
+
+#endif
+
 #if !defined(int8_m)   || \
 	!defined(uint8_m)  || \
 	!defined(int16_m)  || \
@@ -239,9 +349,148 @@ enum muVGCShader {
 };
 typedef enum muVGCShader muVGCShader;
 
+// (Same values as VkDescriptorType)
+enum muVGCDescriptorType {
+	MUVGC_DESCRIPTOR_TYPE_UNIFORM_BUFFER=6,
+	MUVGC_DESCRIPTOR_TYPE_STORAGE_BUFFER=7
+};
+typedef enum muVGCDescriptorType muVGCDescriptorType;
+
+/* structs */
+
+// A macro defined before the shader's code, as '#define name value' would
+// define it (its value being 1 if value is 0)
+struct muVGCDefine {
+	const char* name;
+	const char* value;
+};
+typedef struct muVGCDefine muVGCDefine;
+
+// The defines of one permutation of a shader
+struct muVGCDefineSet {
+	const muVGCDefine* defines;
+	size_m define_len;
+};
+typedef struct muVGCDefineSet muVGCDefineSet;
+
+// A file that '#include' can refer to by name
+struct muVGCIncludeFile {
+	const char* name;
+	const char* code;
+};
+typedef struct muVGCIncludeFile muVGCIncludeFile;
+
+// Returns the code of the file with the given name (as written between the
+// quotes or angle brackets of '#include'), or 0 if there's no such file;
+// the code is copied, so it only needs to stay valid until the callback is
+// next called
+typedef const char* (*muVGCIncludeCallback)(void* user_data, const char* name);
+
+// Included files, each lexed once and kept for as long as the cache is, so
+// that shaders compiled with the same cache share them. A file is assumed
+// not to change once cached (a new cache is needed if one does), and a
+// cache can't be used by two compiles at once.
+typedef struct muVGCIncludeCache muVGCIncludeCache;
+
+// Compile options; a zeroed struct (or passing MU_NULL_PTR) gives the
+// defaults
+struct muVGCOptions {
+	// Leave out debug instructions (OpSource, OpSourceExtension, OpName)
+	muBool strip_debug;
+	// Remove vertex shader outputs that the next stage doesn't read, bit N
+	// of next_stage_input_locations being set meaning that it reads
+	// location N
+	muBool prune_outputs;
+	uint32_m next_stage_input_locations;
+	// Macros defined before the shader's code
+	const muVGCDefine* defines;
+	size_m define_len;
+	// Files that '#include' can refer to, looked for by name in
+	// include_files first and then through include_callback (if given)
+	const muVGCIncludeFile* include_files;
+	size_m include_file_len;
+	muVGCIncludeCallback include_callback;
+	void* include_user_data;
+	// Cache of included files to use (if 0, one lasting only for the
+	// compile is used)
+	muVGCIncludeCache* include_cache;
+};
+typedef struct muVGCOptions muVGCOptions;
+
+// A descriptor binding the shader uses
+struct muVGCDescriptorBinding {
+	uint32_m set;
+	uint32_m binding;
+	muVGCDescriptorType type;
+	// Number of descriptors (the array size, 1 if it isn't an array)
+	uint32_m count;
+	// Size of the block in bytes; for a buffer block ending with an array
+	// without a length, the size with none of that array's elements
+	uint32_m size;
+};
+typedef struct muVGCDescriptorBinding muVGCDescriptorBinding;
+
+// The range of a push constant block (both rounded out to multiples of 4,
+// as Vulkan needs them to be)
+struct muVGCPushConstantRange {
+	uint32_m offset;
+	uint32_m size;
+};
+typedef struct muVGCPushConstantRange muVGCPushConstantRange;
+
+// An input or output with a location (built-ins don't have one)
+struct muVGCInterfaceLocation {
+	uint32_m location;
+	uint32_m component;
+	// Number of locations it takes up, and of components within them (4
+	// for types taking up whole locations)
+	uint32_m location_count;
+	uint32_m component_count;
+};
+typedef struct muVGCInterfaceLocation muVGCInterfaceLocation;
+
+// What a compiled shader uses, as pipeline creation needs it; only what's
+// still in the SPIR-V after optimization is listed. Free with
+// mu_free_vulkan_glsl_reflection.
+struct muVGCReflection {
+	muVGCShader shader;
+	// (Sorted by set, then binding)
+	muVGCDescriptorBinding* bindings;
+	size_m binding_len;
+	// (A size of 0 meaning there's no push constant block)
+	muVGCPushConstantRange push_constants;
+	// (Sorted by location, then component)
+	muVGCInterfaceLocation* inputs;
+	size_m input_len;
+	muVGCInterfaceLocation* outputs;
+	size_m output_len;
+	// Local size of a compute shader, and the SpecIds specializing it (+1,
+	// 0 meaning none)
+	uint32_m workgroup_size[3];
+	uint32_m workgroup_size_spec_ids[3];
+};
+typedef struct muVGCReflection muVGCReflection;
+
 /* functions */
 
 MUDEF muString mu_compile_vulkan_glsl(muResult* result, const char* code, muVGCShader shader);
+MUDEF muString mu_compile_vulkan_glsl_with_options(muResult* result, const char* code, muVGCShader shader, const muVGCOptions* options);
+MUDEF muString mu_compile_vulkan_glsl_with_reflection(muResult* result, const char* code, muVGCShader shader, const muVGCOptions* options, muVGCReflection* reflection);
+MUDEF void mu_free_vulkan_glsl_reflection(muVGCReflection* reflection);
+
+// Compiles a permutation of the code for each define set (its defines being
+// added to those of the options), into bytecodes[i] and results[i] (results
+// can be 0). The code is lexed once for all of them; a permutation whose
+// defines only differ from an earlier one's in macros that preprocessing the
+// earlier one never looked up takes its result without being preprocessed,
+// and permutations that preprocess to the same tokens share one compile.
+MUDEF void mu_compile_vulkan_glsl_permutations(muResult* results, muString* bytecodes, const char* code, muVGCShader shader, const muVGCOptions* options, const muVGCDefineSet* define_sets, size_m define_set_len);
+
+MUDEF muVGCIncludeCache* mu_create_vulkan_glsl_include_cache(void);
+MUDEF void mu_destroy_vulkan_glsl_include_cache(muVGCIncludeCache* cache);
+
+MUDEF muString mu_compress_spirv(muResult* result, const char* spirv, size_m spirv_len);
+MUDEF muString mu_decompress_spirv(muResult* result, const char* data, size_m data_len);
 
 #ifdef __cplusplus
 }
@@ -1125,109 +1374,6 @@ extern "C" { // }
 		return ub[0] + (ub[1] << 8);
 	}
 
-	// Instruction sections
-
-	size_m muVGC_hop_to_naming_section(muString bytecode) {
-		for (size_m i = 20; i <= mu_string_strlen(bytecode);) {
-			int instruction = muVGC_get_halfword(&bytecode.s[i]);
-			int step = muVGC_get_halfword(&bytecode.s[i+2]);
-			if (step == 0) {
-				return 20;
-			}
-
-			// Go to OpSource call
-			if (instruction == 3) {
-				i += step * 4;
-				instruction = muVGC_get_halfword(&bytecode.s[i]);
-				step = muVGC_get_halfword(&bytecode.s[i+2]);
-
-				// Go past all calls to:
-				// OpSourceContinued, OpSource, OpSourceExtension, OpName, OpMemberName,
-				// OpString, OpLine, OpNoLine, OpModuleProcessed
-				while (i < mu_string_strlen(bytecode) && (
-					(instruction >= 2 && instruction <= 8) || 
-					(instruction == 317) || (instruction == 330))
-				) {
-					i += step * 4;
-					instruction = muVGC_get_halfword(&bytecode.s[i]);
-					step = muVGC_get_halfword(&bytecode.s[i+2]);
-				}
-
-				return i;
-			}
-
-			i += step * 4;
-		}
-
-		return 20;
-	}
-
-	size_m muVGC_hop_to_decoration_section(muString bytecode) {
-		for (size_m i = muVGC_hop_to_naming_section(bytecode); i <= mu_string_strlen(bytecode);) {
-			int instruction = muVGC_get_halfword(&bytecode.s[i]);
-			int step = muVGC_get_halfword(&bytecode.s[i+2]);
-
-			// Go past all calls to:
-			// OpDecorate, OpMemberDecorate, OpDecorationGroup, OpGroupDecorate, OpGroupMemberDecorate,
-			// OpDecorateId, OpDecorateString, OpMemberDecorateString
-			while (i < mu_string_strlen(bytecode) && (
-				(instruction >= 71 && instruction <= 75) || 
-				(instruction == 332) || (instruction == 5632) || 
-				(instruction == 5633))
-			) {
-				i += step * 4;
-				instruction = muVGC_get_halfword(&bytecode.s[i]);
-				step = muVGC_get_halfword(&bytecode.s[i+2]);
-			}
-
-			return i;
-
-			//i += step * 4;
-		}
-
-		return 20;
-	}
-
-	size_m muVGC_hop_to_variable_section(muString bytecode) {
-		for (size_m i = muVGC_hop_to_decoration_section(bytecode); i <= mu_string_strlen(bytecode);) {
-			int instruction = muVGC_get_halfword(&bytecode.s[i]);
-			int step = muVGC_get_halfword(&bytecode.s[i+2]);
-
-			// Go past all calls to:
-			// Type-Declaration Instructions
-			// Constant-Creation Instructions
-			// Memory Instructions
-			while (i < mu_string_strlen(bytecode) && (
-				(instruction >= 19 && instruction <= 39) || 
-				(instruction == 322) || (instruction == 327) ||
-				(instruction == 4456) || (instruction == 6086) ||
-				(instruction == 6090) ||
-
-				(instruction >= 41 && instruction <= 46) ||
-				(instruction >= 48 && instruction <= 52) ||
-				(instruction == 6091) || (instruction == 6092) ||
-
-				(instruction >= 59 && instruction <= 70) || 
-				(instruction >= 401 && instruction <= 403) ||
-				(instruction == 4457) || (instruction == 4458))
-			) {
-				i += step * 4;
-				instruction = muVGC_get_halfword(&bytecode.s[i]);
-				step = muVGC_get_halfword(&bytecode.s[i+2]);
-			}
-
-			return i;
-
-			//i += step * 4;
-		}
-
-		return 20;
-	}
-
-	size_m muVGC_hop_to_function_section(muString bytecode) {
-		return mu_string_strlen(bytecode);
-	}
-
 /* CODE MODIFICATION FUNCS */
 
 	void muVGC_clear_code(char* s, size_m beg, size_m end) {
@@ -1325,222 +1471,734 @@ extern "C" { // }
 		return muVGC_handle_line_continuation(result, code);
 	}
 
-/* MACRO HANDLING */
-
-	muResult muVGC_is_version_valid(muString code, const char* og, size_m* number_index, size_m* beg, size_m* end) {
-		size_m i = muVGC_get_next_non_empty_char(code.s, mu_string_strlen(code), 0);
-		if (i >= mu_string_strlen(code)) {
-			muVGC_print_syntax_error(og, 0);
-			mu_print("string passed contains no readable code\n");
-			return MU_FAILURE;
-		}
-
-		*beg = i;
-		if (code.s[i] != '#') {
-			muVGC_print_syntax_error(og, i);
-			mu_print("expected '#' as first token to specify version\n");
-			return MU_FAILURE;
-		}
-
-		i = muVGC_get_next_non_space(code.s, mu_string_strlen(code), i+1);
-		if ((i+8 >= mu_string_strlen(code)) || (mu_strncmp(&code.s[i], "version ", 8) != 0)) {
-			muVGC_print_syntax_error(og, i);
-			mu_print("expected 'version' after token '#'\n");
-			return MU_FAILURE;
-		}
-
-		i = muVGC_get_next_non_space(code.s, mu_string_strlen(code), i+7);
-		*number_index = i;
-		if (i >= mu_string_strlen(code) || (code.s[i] >= '0' && code.s[i] <= '9') == MU_FALSE) {
-			muVGC_print_syntax_error(og, i);
-			mu_print("expected number after '#version'\n");
-			return MU_FAILURE;
-		}
-
-		size_m end_i = muVGC_get_next_empty_char(code.s, mu_string_strlen(code), i);
-		for (size_m j = i; j < end_i; j++) {
-			if ((code.s[j] >= '0' && code.s[j] <= '9') == MU_FALSE) {
-				muVGC_print_syntax_error(og, i);
-				mu_print("expected number after '#version'\n");
-				return MU_FAILURE;
-			}
-		}
-		i = end_i;
-		*end = end_i;
-
-		i = muVGC_get_next_non_space(code.s, mu_string_strlen(code), i);
-		if (i >= mu_string_strlen(code) || code.s[i] == '\n') {
-			return MU_SUCCESS;
-		}
-
-		end_i = muVGC_get_next_empty_char(code.s, mu_string_strlen(code), i);
-		if ((end_i-i != 4) || (mu_strncmp(&code.s[i], "core", 4) != 0)) {
-			muVGC_print_syntax_error(og, i);
-			mu_print("expected anything after '#version N' to be 'core'\n");
-			return MU_FAILURE;
-		}
-
-		i = end_i;
-		end_i = muVGC_get_next_new_line(code.s, mu_string_strlen(code), end_i);
-		for (size_m j = i; j < end_i; j++) {
-			if (muVGC_is_character_empty(code.s[j]) == MU_FALSE) {
-				muVGC_print_syntax_error(og, j);
-				mu_print("expected only newline after version directive\n");
-				return MU_FAILURE;
-			}
-		}
-		*end = end_i;
+/* KEYWORD HANDLING */
+
+	// Basic types
+
+	enum muVGCBasicType {
+		#define MUVGC_BASIC_TYPE_FIRST MUVGC_TYPE_VOID
+		// Transparent types
+		#define MUVGC_TRANSPARENT_TYPE_FIRST MUVGC_TYPE_VOID
+		MUVGC_TYPE_VOID,
+		MUVGC_TYPE_BOOL,
+		MUVGC_TYPE_INT,
+		MUVGC_TYPE_UINT,
+		MUVGC_TYPE_FLOAT,
+		MUVGC_TYPE_DOUBLE,
+		MUVGC_TYPE_VEC2,
+		MUVGC_TYPE_VEC3,
+		MUVGC_TYPE_VEC4,
+		MUVGC_TYPE_DVEC2,
+		MUVGC_TYPE_DVEC3,
+		MUVGC_TYPE_DVEC4,
+		MUVGC_TYPE_BVEC2,
+		MUVGC_TYPE_BVEC3,
+		MUVGC_TYPE_BVEC4,
+		MUVGC_TYPE_IVEC2,
+		MUVGC_TYPE_IVEC3,
+		MUVGC_TYPE_IVEC4,
+		MUVGC_TYPE_UVEC2,
+		MUVGC_TYPE_UVEC3,
+		MUVGC_TYPE_UVEC4,
+		MUVGC_TYPE_MAT2,
+		MUVGC_TYPE_MAT3,
+		MUVGC_TYPE_MAT4,
+		MUVGC_TYPE_MAT2X2,
+		MUVGC_TYPE_MAT2X3,
+		MUVGC_TYPE_MAT2X4,
+		MUVGC_TYPE_MAT3X2,
+		MUVGC_TYPE_MAT3X3,
+		MUVGC_TYPE_MAT3X4,
+		MUVGC_TYPE_MAT4X2,
+		MUVGC_TYPE_MAT4X3,
+		MUVGC_TYPE_MAT4X4,
+		MUVGC_TYPE_DMAT2,
+		MUVGC_TYPE_DMAT3,
+		MUVGC_TYPE_DMAT4,
+		MUVGC_TYPE_DMAT2X2,
+		MUVGC_TYPE_DMAT2X3,
+		MUVGC_TYPE_DMAT2X4,
+		MUVGC_TYPE_DMAT3X2,
+		MUVGC_TYPE_DMAT3X3,
+		MUVGC_TYPE_DMAT3X4,
+		MUVGC_TYPE_DMAT4X2,
+		MUVGC_TYPE_DMAT4X3,
+		MUVGC_TYPE_DMAT4X4,
+		// (GL_EXT_shader_explicit_arithmetic_types)
+		MUVGC_TYPE_FLOAT16,
+		MUVGC_TYPE_F16VEC2,
+		MUVGC_TYPE_F16VEC3,
+		MUVGC_TYPE_F16VEC4,
+		MUVGC_TYPE_INT16,
+		MUVGC_TYPE_I16VEC2,
+		MUVGC_TYPE_I16VEC3,
+		MUVGC_TYPE_I16VEC4,
+		MUVGC_TYPE_UINT16,
+		MUVGC_TYPE_U16VEC2,
+		MUVGC_TYPE_U16VEC3,
+		MUVGC_TYPE_U16VEC4,
+		MUVGC_TYPE_INT8,
+		MUVGC_TYPE_I8VEC2,
+		MUVGC_TYPE_I8VEC3,
+		MUVGC_TYPE_I8VEC4,
+		MUVGC_TYPE_UINT8,
+		MUVGC_TYPE_U8VEC2,
+		MUVGC_TYPE_U8VEC3,
+		MUVGC_TYPE_U8VEC4,
+		#define MUVGC_TRANSPARENT_TYPE_LAST MUVGC_TYPE_U8VEC4
+		// Floating-Point Opaque Types
+		#define MUVGC_FLOATING_POINT_OPAQUE_TYPE_FIRST MUVGC_TYPE_SAMPLER1D
+		MUVGC_TYPE_SAMPLER1D,
+		MUVGC_TYPE_IMAGE1D,
+		MUVGC_TYPE_SAMPLER2D,
+		MUVGC_TYPE_IMAGE2D,
+		MUVGC_TYPE_SAMPLER3D,
+		MUVGC_TYPE_IMAGE3D,
+		MUVGC_TYPE_SAMPLERCUBE,
+		MUVGC_TYPE_IMAGECUBE,
+		MUVGC_TYPE_SAMPLER2DRECT,
+		MUVGC_TYPE_IMAGE2DRECT,
+		MUVGC_TYPE_SAMPLER1DARRAY,
+		MUVGC_TYPE_IMAGE1DARRAY,
+		MUVGC_TYPE_SAMPLER2DARRAY,
+		MUVGC_TYPE_IMAGE2DARRAY,
+		MUVGC_TYPE_SAMPLERBUFFER,
+		MUVGC_TYPE_IMAGEBUFFER,
+		MUVGC_TYPE_SAMPLER2DMS,
+		MUVGC_TYPE_IMAGE2DMS,
+		MUVGC_TYPE_SAMPLER2DMSARRAY,
+		MUVGC_TYPE_IMAGE2DMSARRAY,
+		MUVGC_TYPE_SAMPLERCUBEARRAY,
+		MUVGC_TYPE_IMAGECUBEARRAY,
+		MUVGC_TYPE_SAMPLER1DSHADOW,
+		MUVGC_TYPE_SAMPLER2DSHADOW,
+		MUVGC_TYPE_SAMPLER2DRECTSHADOW,
+		MUVGC_TYPE_SAMPLER1DARRAYSHADOW,
+		MUVGC_TYPE_SAMPLER2DARRAYSHADOW,
+		MUVGC_TYPE_SAMPLERCUBESHADOW,
+		MUVGC_TYPE_SAMPLERCUBEARRAYSHADOW,
+		#define MUVGC_FLOATING_POINT_OPAQUE_TYPE_LAST MUVGC_TYPE_SAMPLERCUBEARRAYSHADOW
+		// Signed Integer Opaque Types
+		#define MUVGC_SIGNED_INTEGER_OPAQUE_TYPE_FIRST MUVGC_TYPE_ISAMPLER1D
+		MUVGC_TYPE_ISAMPLER1D,
+		MUVGC_TYPE_IIMAGE1D,
+		MUVGC_TYPE_ISAMPLER2D,
+		MUVGC_TYPE_IIMAGE2D,
+		MUVGC_TYPE_ISAMPLER3D,
+		MUVGC_TYPE_IIMAGE3D,
+		MUVGC_TYPE_ISAMPLERCUBE,
+		MUVGC_TYPE_IIMAGECUBE,
+		MUVGC_TYPE_ISAMPLER2DRECT,
+		MUVGC_TYPE_IIMAGE2DRECT,
+		MUVGC_TYPE_ISAMPLER1DARRAY,
+		MUVGC_TYPE_IIMAGE1DARRAY,
+		MUVGC_TYPE_ISAMPLER2DARRAY,
+		MUVGC_TYPE_IIMAGE2DARRAY,
+		MUVGC_TYPE_ISAMPLERBUFFER,
+		MUVGC_TYPE_IIMAGEBUFFER,
+		MUVGC_TYPE_ISAMPLER2DMS,
+		MUVGC_TYPE_IIMAGE2DMS,
+		MUVGC_TYPE_ISAMPLER2DMSARRAY,
+		MUVGC_TYPE_IIMAGE2DMSARRAY,
+		MUVGC_TYPE_ISAMPLERCUBEARRAY,
+		MUVGC_TYPE_IIMAGECUBEARRAY,
+		#define MUVGC_SIGNED_INTEGER_OPAQUE_TYPE_LAST MUVGC_TYPE_IIMAGECUBEARRAY
+		// Unsigned Integer Opaque Types
+		#define MUVGC_UNSIGNED_INTEGER_OPAQUE_TYPE_FIRST MUVGC_TYPE_USAMPLER1D
+		MUVGC_TYPE_USAMPLER1D,
+		MUVGC_TYPE_UIMAGE1D,
+		MUVGC_TYPE_USAMPLER2D,
+		MUVGC_TYPE_UIMAGE2D,
+		MUVGC_TYPE_USAMPLER3D,
+		MUVGC_TYPE_UIMAGE3D,
+		MUVGC_TYPE_USAMPLERCUBE,
+		MUVGC_TYPE_UIMAGECUBE,
+		MUVGC_TYPE_USAMPLER2DRECT,
+		MUVGC_TYPE_UIMAGE2DRECT,
+		MUVGC_TYPE_USAMPLER1DARRAY,
+		MUVGC_TYPE_UIMAGE1DARRAY,
+		MUVGC_TYPE_USAMPLER2DARRAY,
+		MUVGC_TYPE_UIMAGE2DARRAY,
+		MUVGC_TYPE_USAMPLERBUFFER,
+		MUVGC_TYPE_UIMAGEBUFFER,
+		MUVGC_TYPE_USAMPLER2DMS,
+		MUVGC_TYPE_UIMAGE2DMS,
+		MUVGC_TYPE_USAMPLER2DMSARRAY,
+		MUVGC_TYPE_UIMAGE2DMSARRAY,
+		MUVGC_TYPE_USAMPLERCUBEARRAY,
+		MUVGC_TYPE_UIMAGECUBEARRAY
+		#define MUVGC_UNSIGNED_INTEGER_OPAQUE_TYPE_LAST MUVGC_TYPE_UIMAGECUBEARRAY
+		#define MUVGC_BASIC_TYPE_LAST MUVGC_TYPE_UIMAGECUBEARRAY
+		#define MUVGC_TYPE_UNKNOWN 2345
+	};
+	typedef enum muVGCBasicType muVGCBasicType;
+
+	const char* muVGC_global_basic_type_names[] = {
+		"void",
+		"bool",
+		"int",
+		"uint",
+		"float",
+		"double",
+		"vec2",
+		"vec3",
+		"vec4",
+		"dvec2",
+		"dvec3",
+		"dvec4",
+		"bvec2",
+		"bvec3",
+		"bvec4",
+		"ivec2",
+		"ivec3",
+		"ivec4",
+		"uvec2",
+		"uvec3",
+		"uvec4",
+		"mat2",
+		"mat3",
+		"mat4",
+		"mat2x2",
+		"mat2x3",
+		"mat2x4",
+		"mat3x2",
+		"mat3x3",
+		"mat3x4",
+		"mat4x2",
+		"mat4x3",
+		"mat4x4",
+		"dmat2",
+		"dmat3",
+		"dmat4",
+		"dmat2x2",
+		"dmat2x3",
+		"dmat2x4",
+		"dmat3x2",
+		"dmat3x3",
+		"dmat3x4",
+		"dmat4x2",
+		"dmat4x3",
+		"dmat4x4",
+		"float16_t",
+		"f16vec2",
+		"f16vec3",
+		"f16vec4",
+		"int16_t",
+		"i16vec2",
+		"i16vec3",
+		"i16vec4",
+		"uint16_t",
+		"u16vec2",
+		"u16vec3",
+		"u16vec4",
+		"int8_t",
+		"i8vec2",
+		"i8vec3",
+		"i8vec4",
+		"uint8_t",
+		"u8vec2",
+		"u8vec3",
+		"u8vec4",
+		"sampler1D",
+		"image1D",
+		"sampler2D",
+		"image2D",
+		"sampler3D",
+		"image3D",
+		"samplerCube",
+		"imageCube",
+		"sampler2DRect",
+		"image2DRect",
+		"sampler1DArray",
+		"image1DArray",
+		"sampler2DArray",
+		"image2DArray",
+		"samplerBuffer",
+		"imageBuffer",
+		"sampler2DMS",
+		"image2DMS",
+		"sampler2DMSArray",
+		"image2DMSArray",
+		"samplerCubeArray",
+		"imageCubeArray",
+		"sampler1DShadow",
+		"sampler2DShadow",
+		"sampler2DRectShadow",
+		"sampler1DArrayShadow",
+		"sampler2DArrayShadow",
+		"samplerCubeShadow",
+		"samplerCubeArrayShadow",
+		"isampler1D",
+		"iimage1D",
+		"isampler2D",
+		"iimage2D",
+		"isampler3D",
+		"iimage3D",
+		"isamplerCube",
+		"iimageCube",
+		"isampler2DRect",
+		"iimage2DRect",
+		"isampler1DArray",
+		"iimage1DArray",
+		"isampler2DArray",
+		"iimage2DArray",
+		"isamplerBuffer",
+		"iimageBuffer",
+		"isampler2DMS",
+		"iimage2DMS",
+		"isampler2DMSArray",
+		"iimage2DMSArray",
+		"isamplerCubeArray",
+		"iimageCubeArray",
+		"usampler1D",
+		"uimage1D",
+		"usampler2D",
+		"uimage2D",
+		"usampler3D",
+		"uimage3D",
+		"usamplerCube",
+		"uimageCube",
+		"usampler2DRect",
+		"uimage2DRect",
+		"usampler1DArray",
+		"uimage1DArray",
+		"usampler2DArray",
+		"uimage2DArray",
+		"usamplerBuffer",
+		"uimageBuffer",
+		"usampler2DMS",
+		"uimage2DMS",
+		"usampler2DMSArray",
+		"uimage2DMSArray",
+		"usamplerCubeArray",
+		"uimageCubeArray"
+	};
 
-		return MU_SUCCESS;
+	const char* muVGC_get_basic_type_name(muVGCBasicType type) {
+		return muVGC_global_basic_type_names[type];
 	}
 
-	muString muVGC_macro_handle_first_words(muResult* result, muString bytecode) {
-		char first_words[] = {
-			// Magic number
-			0x03, 0x02, 0x23, 0x07,
-			// Version
-			0x00, 0x00, 0x01, 0x00,
-			// Generator number (using glslc's for now)
-			0x0b, 0x00, 0x0d, 0x00,
-			// Bound
-			0x00, 0x00, 0x00, 0x00,
-			// Instruction schema
-			0x00, 0x00, 0x00, 0x00
-		};
-		bytecode = mu_string_insert_raw(bytecode, first_words, sizeof(first_words), 0);
+	// Keywords
 
-		return bytecode;
-	}
+	enum muVGCKeywordType {
+		MUVGC_KEYWORD_TYPE_KEYWORD,
+		MUVGC_KEYWORD_TYPE_RESERVED,
+		// Layout image format qualifiers & attribute names; these are still
+		// lexed as identifiers
+		MUVGC_KEYWORD_TYPE_FORMAT,
+		MUVGC_KEYWORD_TYPE_ATTRIBUTE
+	};
+	typedef enum muVGCKeywordType muVGCKeywordType;
+
+	// Attributes (as in [[unroll]]), as bits
+	enum muVGCAttribute {
+		MUVGC_ATTRIBUTE_INLINE=1,
+		MUVGC_ATTRIBUTE_DONT_INLINE=2,
+		MUVGC_ATTRIBUTE_UNROLL=4,
+		MUVGC_ATTRIBUTE_DONT_UNROLL=8,
+		MUVGC_ATTRIBUTE_DEPENDENCY_INFINITE=16,
+		MUVGC_ATTRIBUTE_FLATTEN=32,
+		MUVGC_ATTRIBUTE_BRANCH=64
+	};
+	typedef enum muVGCAttribute muVGCAttribute;
+
+	// Precision qualifiers
+	enum muVGCPrecision {
+		MUVGC_PRECISION_NONE=0,
+		MUVGC_PRECISION_LOW=1,
+		MUVGC_PRECISION_MEDIUM=2,
+		MUVGC_PRECISION_HIGH=3
+	};
+	typedef enum muVGCPrecision muVGCPrecision;
+
+	struct muVGCKeyword {
+		const char* name;
+		size_m namelen;
+		muVGCKeywordType type;
+		muVGCBasicType basic_type;
+		// (SPIR-V ImageFormat)
+		uint32_m image_format;
+		// The precision qualifier it is & the attribute it names (if any)
+		muVGCPrecision precision;
+		uint32_m attribute;
+	};
+	typedef struct muVGCKeyword muVGCKeyword;
+
+	#define MUVGC_KEYWORD(name, type, basic_type) { name, sizeof(name)-1, type, basic_type, 0, MUVGC_PRECISION_NONE, 0 }
+	#define MUVGC_FORMAT_KEYWORD(name, image_format) { name, sizeof(name)-1, MUVGC_KEYWORD_TYPE_FORMAT, MUVGC_TYPE_UNKNOWN, image_format, MUVGC_PRECISION_NONE, 0 }
+	#define MUVGC_PRECISION_KEYWORD(name, precision) { name, sizeof(name)-1, MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN, 0, precision, 0 }
+	#define MUVGC_ATTRIBUTE_KEYWORD(name, attribute) { name, sizeof(name)-1, MUVGC_KEYWORD_TYPE_ATTRIBUTE, MUVGC_TYPE_UNKNOWN, 0, MUVGC_PRECISION_NONE, attribute }
+
+	const muVGCKeyword muVGC_global_keywords[] = {
+		MUVGC_KEYWORD("do", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("if", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("in", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("for", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("out", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("int", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_INT),
+		MUVGC_KEYWORD("flat", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("case", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("else", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("void", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_VOID),
+		MUVGC_KEYWORD("bool", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_BOOL),
+		MUVGC_KEYWORD("true", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("mat2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT2),
+		MUVGC_KEYWORD("mat3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT3),
+		MUVGC_KEYWORD("mat4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT4),
+		MUVGC_KEYWORD("vec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_VEC2),
+		MUVGC_KEYWORD("vec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_VEC3),
+		MUVGC_KEYWORD("vec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_VEC4),
+		MUVGC_KEYWORD("uint", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UINT),
+		MUVGC_PRECISION_KEYWORD("lowp", MUVGC_PRECISION_LOW),
+		MUVGC_KEYWORD("const", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("break", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("while", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("inout", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("float", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_FLOAT),
+		MUVGC_KEYWORD("false", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("dmat2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT2),
+		MUVGC_KEYWORD("dmat3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT3),
+		MUVGC_KEYWORD("dmat4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT4),
+		MUVGC_KEYWORD("ivec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IVEC2),
+		MUVGC_KEYWORD("ivec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IVEC3),
+		MUVGC_KEYWORD("ivec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IVEC4),
+		MUVGC_KEYWORD("bvec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_BVEC2),
+		MUVGC_KEYWORD("bvec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_BVEC3),
+		MUVGC_KEYWORD("bvec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_BVEC4),
+		MUVGC_KEYWORD("dvec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DVEC2),
+		MUVGC_KEYWORD("dvec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DVEC3),
+		MUVGC_KEYWORD("dvec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DVEC4),
+		MUVGC_KEYWORD("uvec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UVEC2),
+		MUVGC_KEYWORD("uvec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UVEC3),
+		MUVGC_KEYWORD("uvec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UVEC4),
+		MUVGC_PRECISION_KEYWORD("highp", MUVGC_PRECISION_HIGH),
+		MUVGC_KEYWORD("int8_t", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_INT8),
+		MUVGC_KEYWORD("i8vec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_I8VEC2),
+		MUVGC_KEYWORD("i8vec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_I8VEC3),
+		MUVGC_KEYWORD("i8vec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_I8VEC4),
+		MUVGC_KEYWORD("u8vec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_U8VEC2),
+		MUVGC_KEYWORD("u8vec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_U8VEC3),
+		MUVGC_KEYWORD("u8vec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_U8VEC4),
+		MUVGC_KEYWORD("uint8_t", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UINT8),
+		MUVGC_KEYWORD("int16_t", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_INT16),
+		MUVGC_KEYWORD("f16vec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_F16VEC2),
+		MUVGC_KEYWORD("f16vec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_F16VEC3),
+		MUVGC_KEYWORD("f16vec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_F16VEC4),
+		MUVGC_KEYWORD("i16vec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_I16VEC2),
+		MUVGC_KEYWORD("i16vec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_I16VEC3),
+		MUVGC_KEYWORD("i16vec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_I16VEC4),
+		MUVGC_KEYWORD("u16vec2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_U16VEC2),
+		MUVGC_KEYWORD("u16vec3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_U16VEC3),
+		MUVGC_KEYWORD("u16vec4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_U16VEC4),
+		MUVGC_KEYWORD("uint16_t", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UINT16),
+		MUVGC_KEYWORD("float16_t", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_FLOAT16),
+		MUVGC_KEYWORD("patch", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("buffer", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("shared", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("layout", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("smooth", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("switch", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("double", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DOUBLE),
+		MUVGC_KEYWORD("return", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("mat2x2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT2X2),
+		MUVGC_KEYWORD("mat2x3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT2X3),
+		MUVGC_KEYWORD("mat2x4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT2X4),
+		MUVGC_KEYWORD("mat3x2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT3X2),
+		MUVGC_KEYWORD("mat3x3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT3X3),
+		MUVGC_KEYWORD("mat3x4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT3X4),
+		MUVGC_KEYWORD("mat4x2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT4X2),
+		MUVGC_KEYWORD("mat4x3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT4X3),
+		MUVGC_KEYWORD("mat4x4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_MAT4X4),
+		MUVGC_KEYWORD("struct", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("sample", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("uniform", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("varying", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("default", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("precise", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("discard", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("dmat2x2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT2X2),
+		MUVGC_KEYWORD("dmat2x3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT2X3),
+		MUVGC_KEYWORD("dmat2x4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT2X4),
+		MUVGC_KEYWORD("dmat3x2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT3X2),
+		MUVGC_KEYWORD("dmat3x3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT3X3),
+		MUVGC_KEYWORD("dmat3x4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT3X4),
+		MUVGC_KEYWORD("dmat4x2", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT4X2),
+		MUVGC_KEYWORD("dmat4x3", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT4X3),
+		MUVGC_KEYWORD("dmat4x4", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_DMAT4X4),
+		MUVGC_PRECISION_KEYWORD("mediump", MUVGC_PRECISION_MEDIUM),
+		MUVGC_KEYWORD("image1D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGE1D),
+		MUVGC_KEYWORD("image2D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGE2D),
+		MUVGC_KEYWORD("image3D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGE3D),
+		MUVGC_KEYWORD("coherent", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("volatile", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("restrict", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("readonly", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("centroid", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("continue", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("iimage1D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGE1D),
+		MUVGC_KEYWORD("uimage1D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGE1D),
+		MUVGC_KEYWORD("iimage2D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGE2D),
+		MUVGC_KEYWORD("uimage2D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGE2D),
+		MUVGC_KEYWORD("iimage3D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGE3D),
+		MUVGC_KEYWORD("uimage3D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGE3D),
+		MUVGC_KEYWORD("attribute", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("writeonly", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("invariant", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("precision", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("sampler1D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER1D),
+		MUVGC_KEYWORD("sampler2D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER2D),
+		MUVGC_KEYWORD("sampler3D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER3D),
+		MUVGC_KEYWORD("imageCube", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGECUBE),
+		MUVGC_KEYWORD("image2DMS", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGE2DMS),
+		MUVGC_KEYWORD("subroutine", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("isampler1D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLER1D),
+		MUVGC_KEYWORD("isampler2D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLER2D),
+		MUVGC_KEYWORD("isampler3D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLER3D),
+		MUVGC_KEYWORD("usampler1D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLER1D),
+		MUVGC_KEYWORD("usampler2D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLER2D),
+		MUVGC_KEYWORD("usampler3D", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLER3D),
+		MUVGC_KEYWORD("iimageCube", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGECUBE),
+		MUVGC_KEYWORD("uimageCube", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGECUBE),
+		MUVGC_KEYWORD("iimage2DMS", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGE2DMS),
+		MUVGC_KEYWORD("uimage2DMS", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGE2DMS),
+		MUVGC_KEYWORD("atomic_uint", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("samplerCube", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLERCUBE),
+		MUVGC_KEYWORD("sampler2DMS", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER2DMS),
+		MUVGC_KEYWORD("image2DRect", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGE2DRECT),
+		MUVGC_KEYWORD("imageBuffer", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGEBUFFER),
+		MUVGC_KEYWORD("isamplerCube", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLERCUBE),
+		MUVGC_KEYWORD("usamplerCube", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLERCUBE),
+		MUVGC_KEYWORD("isampler2DMS", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLER2DMS),
+		MUVGC_KEYWORD("usampler2DMS", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLER2DMS),
+		MUVGC_KEYWORD("iimage2DRect", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGE2DRECT),
+		MUVGC_KEYWORD("uimage2DRect", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGE2DRECT),
+		MUVGC_KEYWORD("iimageBuffer", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGEBUFFER),
+		MUVGC_KEYWORD("uimageBuffer", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGEBUFFER),
+		MUVGC_KEYWORD("image1DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGE1DARRAY),
+		MUVGC_KEYWORD("image2DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGE2DARRAY),
+		MUVGC_KEYWORD("noperspective", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("sampler2DRect", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER2DRECT),
+		MUVGC_KEYWORD("samplerBuffer", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLERBUFFER),
+		MUVGC_KEYWORD("iimage1DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGE1DARRAY),
+		MUVGC_KEYWORD("uimage1DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGE1DARRAY),
+		MUVGC_KEYWORD("iimage2DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGE2DARRAY),
+		MUVGC_KEYWORD("uimage2DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGE2DARRAY),
+		MUVGC_KEYWORD("sampler1DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER1DARRAY),
+		MUVGC_KEYWORD("sampler2DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER2DARRAY),
+		MUVGC_KEYWORD("isampler2DRect", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLER2DRECT),
+		MUVGC_KEYWORD("usampler2DRect", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLER2DRECT),
+		MUVGC_KEYWORD("isamplerBuffer", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLERBUFFER),
+		MUVGC_KEYWORD("usamplerBuffer", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLERBUFFER),
+		MUVGC_KEYWORD("imageCubeArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGECUBEARRAY),
+		MUVGC_KEYWORD("image2DMSArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IMAGE2DMSARRAY),
+		MUVGC_KEYWORD("sampler1DShadow", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER1DSHADOW),
+		MUVGC_KEYWORD("sampler2DShadow", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER2DSHADOW),
+		MUVGC_KEYWORD("isampler1DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLER1DARRAY),
+		MUVGC_KEYWORD("isampler2DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLER2DARRAY),
+		MUVGC_KEYWORD("usampler1DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLER1DARRAY),
+		MUVGC_KEYWORD("usampler2DArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLER2DARRAY),
+		MUVGC_KEYWORD("iimageCubeArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGECUBEARRAY),
+		MUVGC_KEYWORD("uimageCubeArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGECUBEARRAY),
+		MUVGC_KEYWORD("iimage2DMSArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_IIMAGE2DMSARRAY),
+		MUVGC_KEYWORD("uimage2DMSArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_UIMAGE2DMSARRAY),
+		MUVGC_KEYWORD("sampler2DMSArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER2DMSARRAY),
+		MUVGC_KEYWORD("samplerCubeArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLERCUBEARRAY),
+		MUVGC_KEYWORD("samplerCubeShadow", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLERCUBESHADOW),
+		MUVGC_KEYWORD("isampler2DMSArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLER2DMSARRAY),
+		MUVGC_KEYWORD("usampler2DMSArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLER2DMSARRAY),
+		MUVGC_KEYWORD("isamplerCubeArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_ISAMPLERCUBEARRAY),
+		MUVGC_KEYWORD("usamplerCubeArray", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_USAMPLERCUBEARRAY),
+		MUVGC_KEYWORD("sampler2DRectShadow", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER2DRECTSHADOW),
+		MUVGC_KEYWORD("sampler1DArrayShadow", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER1DARRAYSHADOW),
+		MUVGC_KEYWORD("sampler2DArrayShadow", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLER2DARRAYSHADOW),
+		MUVGC_KEYWORD("samplerCubeArrayShadow", MUVGC_KEYWORD_TYPE_KEYWORD, MUVGC_TYPE_SAMPLERCUBEARRAYSHADOW),
+		MUVGC_KEYWORD("asm", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("enum", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("this", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("goto", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("long", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("half", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("cast", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("class", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("union", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("short", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("fixed", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("input", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("hvec2", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("hvec3", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("hvec4", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("fvec2", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("fvec3", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("fvec4", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("using", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("common", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("active", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		// (also the name of the inline attribute)
+		{ "inline", 6, MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN, 0, MUVGC_PRECISION_NONE, MUVGC_ATTRIBUTE_INLINE },
+		MUVGC_KEYWORD("public", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("static", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("extern", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("superp", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("output", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("filter", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("sizeof", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("typedef", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("template", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("resource", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("noinline", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("external", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("unsigned", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("partition", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("interface", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("namespace", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_KEYWORD("sampler3DRect", MUVGC_KEYWORD_TYPE_RESERVED, MUVGC_TYPE_UNKNOWN),
+		MUVGC_FORMAT_KEYWORD("rgba32f", 1),
+		MUVGC_FORMAT_KEYWORD("rgba16f", 2),
+		MUVGC_FORMAT_KEYWORD("r32f", 3),
+		MUVGC_FORMAT_KEYWORD("rgba8", 4),
+		MUVGC_FORMAT_KEYWORD("rgba8_snorm", 5),
+		MUVGC_FORMAT_KEYWORD("rg32f", 6),
+		MUVGC_FORMAT_KEYWORD("rg16f", 7),
+		MUVGC_FORMAT_KEYWORD("r11f_g11f_b10f", 8),
+		MUVGC_FORMAT_KEYWORD("r16f", 9),
+		MUVGC_FORMAT_KEYWORD("rgba16", 10),
+		MUVGC_FORMAT_KEYWORD("rgb10_a2", 11),
+		MUVGC_FORMAT_KEYWORD("rg16", 12),
+		MUVGC_FORMAT_KEYWORD("rg8", 13),
+		MUVGC_FORMAT_KEYWORD("r16", 14),
+		MUVGC_FORMAT_KEYWORD("r8", 15),
+		MUVGC_FORMAT_KEYWORD("rgba16_snorm", 16),
+		MUVGC_FORMAT_KEYWORD("rg16_snorm", 17),
+		MUVGC_FORMAT_KEYWORD("rg8_snorm", 18),
+		MUVGC_FORMAT_KEYWORD("r16_snorm", 19),
+		MUVGC_FORMAT_KEYWORD("r8_snorm", 20),
+		MUVGC_FORMAT_KEYWORD("rgba32i", 21),
+		MUVGC_FORMAT_KEYWORD("rgba16i", 22),
+		MUVGC_FORMAT_KEYWORD("rgba8i", 23),
+		MUVGC_FORMAT_KEYWORD("r32i", 24),
+		MUVGC_FORMAT_KEYWORD("rg32i", 25),
+		MUVGC_FORMAT_KEYWORD("rg16i", 26),
+		MUVGC_FORMAT_KEYWORD("rg8i", 27),
+		MUVGC_FORMAT_KEYWORD("r16i", 28),
+		MUVGC_FORMAT_KEYWORD("r8i", 29),
+		MUVGC_FORMAT_KEYWORD("rgba32ui", 30),
+		MUVGC_FORMAT_KEYWORD("rgba16ui", 31),
+		MUVGC_FORMAT_KEYWORD("rgba8ui", 32),
+		MUVGC_FORMAT_KEYWORD("r32ui", 33),
+		MUVGC_FORMAT_KEYWORD("rgb10_a2ui", 34),
+		MUVGC_FORMAT_KEYWORD("rg32ui", 35),
+		MUVGC_FORMAT_KEYWORD("rg16ui", 36),
+		MUVGC_FORMAT_KEYWORD("rg8ui", 37),
+		MUVGC_FORMAT_KEYWORD("r16ui", 38),
+		MUVGC_FORMAT_KEYWORD("r8ui", 39),
+		MUVGC_ATTRIBUTE_KEYWORD("dont_inline", MUVGC_ATTRIBUTE_DONT_INLINE),
+		MUVGC_ATTRIBUTE_KEYWORD("unroll", MUVGC_ATTRIBUTE_UNROLL),
+		MUVGC_ATTRIBUTE_KEYWORD("dont_unroll", MUVGC_ATTRIBUTE_DONT_UNROLL),
+		MUVGC_ATTRIBUTE_KEYWORD("dependency_infinite", MUVGC_ATTRIBUTE_DEPENDENCY_INFINITE),
+		MUVGC_ATTRIBUTE_KEYWORD("flatten", MUVGC_ATTRIBUTE_FLATTEN),
+		MUVGC_ATTRIBUTE_KEYWORD("branch", MUVGC_ATTRIBUTE_BRANCH)
+	};
 
-	muString muVGC_macro_handle_first_instructions(muResult* result, muString bytecode, muVGCShader shader, int64_m version) {
-		char shader_capability = 0, execution_model = 0;
+	// Keyword hash table
+
+	// Open-addressed table (linear probing) of 1-based indexes into
+	// muVGC_global_keywords, 0 meaning an empty slot. This is generated
+	// offline by inserting every keyword in order with muVGC_hash_name, so
+	// it has to be regenerated whenever muVGC_global_keywords changes (debug
+	// builds check that it has been; see muVGC_keyword_hash_table_is_current).
+
+	#define MUVGC_KEYWORD_HASH_TABLE_SIZE 512
+
+	const uint16_m muVGC_global_keyword_hash_table[MUVGC_KEYWORD_HASH_TABLE_SIZE] = {
+		167, 184, 190,   0,   0, 125,   2, 166, 201, 218, 249, 213, 251,   0,   0, 243,
+		  0,   0,   0, 121,   1,  33, 138, 140, 182,   0, 181, 250,   0,  95, 172, 200,
+		 80,   0, 133,   0, 157, 197, 212, 108,   0,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0,   0,   0,  56, 204,   0,   0, 259,   0, 116, 206,  54,   0,   0,   0,
+		153,  29,  90,   0, 105,   0,   0,   0,   0,   0,  49, 180, 261, 225, 158, 189,
+		118, 264,   0,  82, 253,   0,   0,   0, 147,   0,   0,   0,   0,   0,   6,   5,
+		 10,  75, 155, 237,   0,   0,   0, 215,   0,   0,   0,  48,  37,  87, 106, 151,
+		175, 221,  96, 245, 202,  16,   0, 210,   0, 238,   0,  64,   0,   0,   0,   0,
+		  0, 185,  34,  41,   0,   0,   0,   0,   0,   0, 216,   0, 128, 258,   0,   0,
+		107,   0,   0,   0,  98,   0,   0,   0,   0, 248,   0,   0,   0,   0,   3,   0,
+		183,  19,  57,  35,  40, 104, 149,  45,  50,  53,  63,  81,  93, 173, 188,  67,
+		220,   8, 244, 195,   0, 161,   0,  31,   0, 137, 159, 239,   0, 260,   0,   0,
+		  0,  77, 123,   0, 152, 169,   0,   0,   0, 146, 234,   0,  74,  60,  23,   0,
+		 92,   0, 162, 254,  65, 262,   0, 127,  47,  38,  51,  88,   0,  13, 134, 163,
+		240, 168,  17, 177, 136, 102, 252, 257,   0,   0,   0, 179, 145,   0,   0, 112,
+		  0,   0,  85,   0, 191,   0,   0,  42,  71,  43, 198,  89,   0,  99, 211,  66,
+		226, 150,   0,  18, 165, 209,   0, 143,  69,   0,   0,   0,   0,   0,   0,   0,
+		 39,   0,   0, 124,  44,   0,  52, 113,  94,  61, 115, 242,   0, 142,   0,   0,
+		196,   0,   0, 227,  30,  62, 110, 217, 255, 141,   0,   0, 208,   0,  78, 203,
+		219,   0,   0,   0,   0,   0,   0, 263,   0, 117,   0, 100, 148,  11, 228, 176,
+		232, 256,   0,   0, 160, 222, 266,   0, 171,   0,  14, 109,   0,   0,   0,  97,
+		  0,   0,   0, 187,   0,   0, 178,   0,  26,   0,   0,  58, 154,   0,   0,   0,
+		  0,   0,   0,  20,  72, 241, 199,  27,   0,   0, 164,  15,   0, 101, 235,   0,
+		  0,  68,   0,   0,   0,   0,   0,   0,  22,   0, 111,  83, 194, 231,   0, 114,
+		205,  86,   0, 144,   0,  25,   0,   0,   0, 132, 233,   0,   0,   0,   0,   0,
+		  4, 156,   0, 229,   0,   0,   0,   0, 230,   0,   7, 246,   0,   0,   0,   0,
+		247,   0,   0,   0,   0,   0,  76, 119, 129,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0, 224,   0,   0,   0,   0, 207,   0,   0,   0,   0,   0,   0,   0,  70,
+		  0, 122,   0,   0,   0,   0,   0,  55,  59, 265, 139,   0,   0,   0,   0,   0,
+		  0,  73,   0,   0,  21,  28,  91, 126, 120, 170, 174, 192, 236,   0,  84,   0,
+		  0,   0,  24, 135,   0,  12, 186,  79,   0,   0,   0,   0,   0,   0,  46, 223,
+		  9,   0,   0, 131,   0, 214,   0, 103, 130, 193,   0,   0,   0,   0,  32,  36
+	};
 
-		switch (shader) {
-			default: {
-				mu_print("[muVGC] Error compiling Vulkan GLSL code; shader passed in is unknown value\n");
-				*result = MU_FAILURE;
-				return bytecode;
-			} break;
-			case MUVGC_VERTEX: case MUVGC_TESSELLATION_CONTROL: case MUVGC_TESSELLATION_EVALUATION: case MUVGC_GEOMETRY: case MUVGC_COMPUTE: {
-				mu_print("[muVGC] Error compiling Vulkan GLSL code; shader passed in has not been implemented yet. Sorry\n");
-				*result = MU_FAILURE;
-				return bytecode;
-			} break;
-			case MUVGC_FRAGMENT: {
-				shader_capability = 1;
-				execution_model = 4;
-			} break;
+	// (FNV-1a)
+	uint32_m muVGC_hash_name(const char* name, size_m namelen) {
+		uint32_m hash = 2166136261u;
+		for (size_m i = 0; i < namelen; i++) {
+			hash ^= (unsigned char)name[i];
+			hash *= 16777619u;
 		}
+		return hash;
+	}
 
-		switch (version) {
-			default: {
-				mu_print("[muVGC] Error compiling Vulkan GLSL code; invalid version number\n");
-				*result = MU_FAILURE;
-				return bytecode;
+	const muVGCKeyword* muVGC_find_keyword(const char* name, size_m namelen) {
+		size_m slot = muVGC_hash_name(name, namelen) & (MUVGC_KEYWORD_HASH_TABLE_SIZE-1);
+		while (muVGC_global_keyword_hash_table[slot] != 0) {
+			const muVGCKeyword* keyword = &muVGC_global_keywords[muVGC_global_keyword_hash_table[slot]-1];
+			if (keyword->namelen == namelen && mu_strncmp(keyword->name, name, namelen) == 0) {
+				return keyword;
 			}
-
-			case 110: case 120: case 130: {
-				mu_print("[muVGC] Error compiling Vulkan GLSL code; version number must be at least 140\n");
-				*result = MU_FAILURE;
-				return bytecode;
-			} break;
-
-			case 140: case 150:
-			case 330: case 400: case 410: case 420: case 430:
-			case 440: case 450: case 460: break;
+			slot = (slot+1) & (MUVGC_KEYWORD_HASH_TABLE_SIZE-1);
 		}
-
-		char b0[] = {
-			// OpCapability shader_capability
-			17, 0, 2, 0,
-			shader_capability, 0, 0, 0,
-			// %1 = OpExtInstImport "GLSL.std.450"
-			11, 0, 6, 0,
-			1, 0, 0, 0,
-			'G', 'L', 'S', 'L',
-			'.', 's', 't', 'd',
-			'.', '4', '5', '0',
-			0, 0, 0, 0,
-			// OpMemoryModel Logical GLSL450
-			14, 0, 3, 0,
-			0, 0, 0, 0,
-			1, 0, 0, 0,
-			// OpEntryPoint Fragment %4 "main"
-			15, 0, 5, 0,
-			execution_model, 0, 0, 0,
-			4, 0, 0, 0,
-			'm', 'a', 'i', 'n',
-			0, 0, 0, 0,
-			// OpExecutionMode %4 OriginUpperLeft
-			16, 0, 3, 0,
-			4, 0, 0, 0,
-			7, 0, 0, 0,
-			// OpSource GLSL 450
-			3, 0, 3, 0,
-			2, 0, 0, 0,
-			version & 0xFF, (version >> 8) & 0xFF, (version >> 16) & 0xFF, (version >> 24) & 0xFF,
-			// OpSourceExtension "GL_GOOGLE_cpp_style_line_directive"
-			4, 0, 10, 0,
-			'G', 'L', '_', 'G',
-			'O', 'O', 'G', 'L',
-			'E', '_', 'c', 'p',
-			'p', '_', 's', 't',
-			'y', 'l', 'e', '_',
-			'l', 'i', 'n', 'e',
-			'_', 'd', 'i', 'r',
-			'e', 'c', 't', 'i',
-			'v', 'e', 0, 0,
-			// OpSourceExtension "GL_GOOGLE_include_directive"
-			4, 0, 8, 0,
-			'G', 'L', '_', 'G',
-			'O', 'O', 'G', 'L',
-			'E', '_', 'i', 'n',
-			'c', 'l', 'u', 'd',
-			'e', '_', 'd', 'i',
-			'r', 'e', 'c', 't',
-			'i', 'v', 'e', 0,
-		};
-		bytecode = mu_string_insert_raw(bytecode, b0, sizeof(b0), mu_string_strlen(bytecode));
-
-		return bytecode;
+		return MU_NULL_PTR;
 	}
 
-	muString muVGC_macro_handle_version(muResult* result, muString code, const char* og, muString bytecode, muVGCShader shader) {
-		size_m number_index = 0, beg = 0, end = 0;
-		if (muVGC_is_version_valid(code, og, &number_index, &beg, &end) != MU_SUCCESS) {
-			*result = MU_FAILURE;
-			return bytecode;
+	#ifndef NDEBUG
+	// Whether the table holds every keyword (and nothing else), so that a
+	// copy left stale by a change to muVGC_global_keywords fails compiles
+	// instead of misreading names
+	muBool muVGC_keyword_hash_table_is_current(void) {
+		size_m keyword_len = sizeof(muVGC_global_keywords)/sizeof(muVGC_global_keywords[0]);
+		size_m filled = 0;
+		for (size_m slot = 0; slot < MUVGC_KEYWORD_HASH_TABLE_SIZE; slot++) {
+			if (muVGC_global_keyword_hash_table[slot] > keyword_len) {
+				return MU_FALSE;
+			}
+			if (muVGC_global_keyword_hash_table[slot] != 0) {
+				filled++;
+			}
 		}
-
-		int64_m version = mu_get_integer_from_string(&code.s[number_index], (end-beg)-number_index);
-		muVGC_clear_code(code.s, beg, end);
-
-		muResult res = MU_SUCCESS;
-		bytecode = muVGC_macro_handle_first_words(&res, bytecode);
-		if (res != MU_SUCCESS) {
-			*result = MU_FAILURE;
-			return bytecode;
+		if (filled != keyword_len) {
+			return MU_FALSE;
 		}
-
-		bytecode = muVGC_macro_handle_first_instructions(&res, bytecode, shader, version);
-		if (res != MU_SUCCESS) {
-			*result = MU_FAILURE;
-			return bytecode;
+		for (size_m i = 0; i < keyword_len; i++) {
+			if (muVGC_find_keyword(muVGC_global_keywords[i].name, muVGC_global_keywords[i].namelen) != &muVGC_global_keywords[i]) {
+				return MU_FALSE;
+			}
 		}
-
-		return bytecode;
+		return MU_TRUE;
 	}
+	#endif
 
-	muString muVGC_handle_macros(muResult* result, muString code, const char* og, muString bytecode, muVGCShader shader) {
-		muResult res = MU_SUCCESS;
-
-		bytecode = muVGC_macro_handle_version(&res, code, og, bytecode, shader);
-		if (res != MU_SUCCESS) {
-			*result = MU_FAILURE;
-			return bytecode;
+	muVGCBasicType muVGC_get_basic_type(const char* name, size_m namelen) {
+		const muVGCKeyword* keyword = muVGC_find_keyword(name, namelen);
+		if (keyword == MU_NULL_PTR) {
+			return MUVGC_TYPE_UNKNOWN;
 		}
-
-		return bytecode;
+		return keyword->basic_type;
 	}
 
 /* TOKEN HANDLING */
@@ -1580,7 +2238,10 @@ extern "C" { // }
 		MUVGC_TOKEN_COLON,
 		MUVGC_TOKEN_SEMICOLON,
 		MUVGC_TOKEN_COMMA,
-		MUVGC_TOKEN_QUESTION_MARK
+		MUVGC_TOKEN_QUESTION_MARK,
+		// (Only in directives & macros)
+		MUVGC_TOKEN_HASH,
+		MUVGC_TOKEN_DOUBLE_HASH
 	};
 	typedef enum muVGCTokenType muVGCTokenType;
 
@@ -1619,6 +2280,8 @@ extern "C" { // }
 			case MUVGC_TOKEN_SEMICOLON: mu_print("semicolon"); break;
 			case MUVGC_TOKEN_COMMA: mu_print("comma"); break;
 			case MUVGC_TOKEN_QUESTION_MARK: mu_print("question mark"); break;
+			case MUVGC_TOKEN_HASH: mu_print("hash"); break;
+			case MUVGC_TOKEN_DOUBLE_HASH: mu_print("double hash"); break;
 		}
 	}
 
@@ -1629,6 +2292,8 @@ extern "C" { // }
 		size_m index;
 		size_m length;
 		size_m effective_length;
+		// The keyword (or format/attribute name) it was lexed as, if any
+		const muVGCKeyword* keyword;
 	};
 	typedef struct muVGCToken muVGCToken;
 
@@ -1666,378 +2331,14 @@ extern "C" { // }
 			// Get type
 			token.type = MUVGC_TOKEN_IDENTIFIER;
 
-			// (keywords)
-			switch (token.length) {
-				default: break;
-				case 2: {
-					if (
-						(mu_strncmp(&code[token.index], "do", 2) == 0) ||
-						(mu_strncmp(&code[token.index], "if", 2) == 0) ||
-						(mu_strncmp(&code[token.index], "in", 2) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 3: {
-					if (
-						(mu_strncmp(&code[token.index], "for", 3) == 0) ||
-						(mu_strncmp(&code[token.index], "out", 3) == 0) ||
-						(mu_strncmp(&code[token.index], "int", 3) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 4: {
-					if (
-						(mu_strncmp(&code[token.index], "flat", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "case", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "else", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "void", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "bool", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "true", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "mat2", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "mat3", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "mat4", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "vec2", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "vec3", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "vec4", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "uint", 4) == 0) ||
-						(mu_strncmp(&code[token.index], "lowp", 4) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 5: {
-					if (
-						(mu_strncmp(&code[token.index], "const", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "break", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "while", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "inout", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "float", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "false", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat2", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat3", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat4", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "ivec2", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "ivec3", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "ivec4", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "bvec2", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "bvec3", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "bvec4", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "dvec2", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "dvec3", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "dvec4", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "uvec2", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "uvec3", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "uvec4", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "highp", 5) == 0) ||
-						(mu_strncmp(&code[token.index], "patch", 5) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 6: {
-					if (
-						(mu_strncmp(&code[token.index], "buffer", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "shared", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "layout", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "smooth", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "switch", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "double", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "return", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat2x2", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat2x3", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat2x4", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat3x2", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat3x3", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat3x4", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat4x2", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat4x3", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "mat4x4", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "struct", 6) == 0) ||
-						(mu_strncmp(&code[token.index], "sample", 6) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 7: {
-					if (
-						(mu_strncmp(&code[token.index], "uniform", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "varying", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "default", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "precise", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "discard", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat2x2", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat2x3", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat2x4", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat3x2", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat3x3", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat3x4", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat4x2", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat4x3", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "dmat4x4", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "mediump", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "image1D", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "image2D", 7) == 0) ||
-						(mu_strncmp(&code[token.index], "image3D", 7) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 8: {
-					if (
-						(mu_strncmp(&code[token.index], "coherent", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "volatile", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "restrict", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "readonly", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "centroid", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "continue", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "iimage1D", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "uimage1D", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "iimage2D", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "uimage2D", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "iimage3D", 8) == 0) ||
-						(mu_strncmp(&code[token.index], "uimage3D", 8) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 9: {
-					if (
-						(mu_strncmp(&code[token.index], "attribute", 9) == 0) ||
-						(mu_strncmp(&code[token.index], "writeonly", 9) == 0) ||
-						(mu_strncmp(&code[token.index], "invariant", 9) == 0) ||
-						(mu_strncmp(&code[token.index], "precision", 9) == 0) ||
-						(mu_strncmp(&code[token.index], "sampler1D", 9) == 0) ||
-						(mu_strncmp(&code[token.index], "sampler2D", 9) == 0) ||
-						(mu_strncmp(&code[token.index], "sampler3D", 9) == 0) ||
-						(mu_strncmp(&code[token.index], "imageCube", 9) == 0) ||
-						(mu_strncmp(&code[token.index], "image2DMS", 9) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 10: {
-					if (
-						(mu_strncmp(&code[token.index], "subroutine", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "isampler1D", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "isampler2D", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "isampler3D", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "usampler1D", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "usampler2D", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "usampler3D", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "iimageCube", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "uimageCube", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "iimage2DMS", 10) == 0) ||
-						(mu_strncmp(&code[token.index], "uimage2DMS", 10) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 11: {
-					if (
-						(mu_strncmp(&code[token.index], "atomic_uint", 11) == 0) ||
-						(mu_strncmp(&code[token.index], "samplerCube", 11) == 0) ||
-						(mu_strncmp(&code[token.index], "sampler2DMS", 11) == 0) ||
-						(mu_strncmp(&code[token.index], "image2DRect", 11) == 0) ||
-						(mu_strncmp(&code[token.index], "imageBuffer", 11) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 12: {
-					if (
-						(mu_strncmp(&code[token.index], "isamplerCube", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "usamplerCube", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "isampler2DMS", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "usampler2DMS", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "iimage2DRect", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "uimage2DRect", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "iimageBuffer", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "uimageBuffer", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "image1DArray", 12) == 0) ||
-						(mu_strncmp(&code[token.index], "image2DArray", 12) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 13: {
-					if (
-						(mu_strncmp(&code[token.index], "noperspective", 13) == 0) ||
-						(mu_strncmp(&code[token.index], "sampler2DRect", 13) == 0) ||
-						(mu_strncmp(&code[token.index], "samplerBuffer", 13) == 0) ||
-						(mu_strncmp(&code[token.index], "iimage1DArray", 13) == 0) ||
-						(mu_strncmp(&code[token.index], "uimage1DArray", 13) == 0) ||
-						(mu_strncmp(&code[token.index], "iimage2DArray", 13) == 0) ||
-						(mu_strncmp(&code[token.index], "uimage2DArray", 13) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 14: {
-					if (
-						(mu_strncmp(&code[token.index], "sampler1DArray", 14) == 0) ||
-						(mu_strncmp(&code[token.index], "sampler2DArray", 14) == 0) ||
-						(mu_strncmp(&code[token.index], "isampler2DRect", 14) == 0) ||
-						(mu_strncmp(&code[token.index], "usampler2DRect", 14) == 0) ||
-						(mu_strncmp(&code[token.index], "isamplerBuffer", 14) == 0) ||
-						(mu_strncmp(&code[token.index], "usamplerBuffer", 14) == 0) ||
-						(mu_strncmp(&code[token.index], "imageCubeArray", 14) == 0) ||
-						(mu_strncmp(&code[token.index], "image2DMSArray", 14) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 15: {
-					if (
-						(mu_strncmp(&code[token.index], "sampler1DShadow", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "sampler2DShadow", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "isampler1DArray", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "isampler2DArray", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "usampler1DArray", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "usampler2DArray", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "iimageCubeArray", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "uimageCubeArray", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "iimage2DMSArray", 15) == 0) ||
-						(mu_strncmp(&code[token.index], "uimage2DMSArray", 15) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 16: {
-					if (
-						(mu_strncmp(&code[token.index], "sampler2DMSArray", 16) == 0) ||
-						(mu_strncmp(&code[token.index], "samplerCubeArray", 16) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 17: {
-					if (
-						(mu_strncmp(&code[token.index], "samplerCubeShadow", 17) == 0) ||
-						(mu_strncmp(&code[token.index], "isampler2DMSArray", 17) == 0) ||
-						(mu_strncmp(&code[token.index], "usampler2DMSArray", 17) == 0) ||
-						(mu_strncmp(&code[token.index], "isamplerCubeArray", 17) == 0) ||
-						(mu_strncmp(&code[token.index], "usamplerCubeArray", 17) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 19: {
-					if (
-						(mu_strncmp(&code[token.index], "sampler2DRectShadow", 19) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 20: {
-					if (
-						(mu_strncmp(&code[token.index], "sampler1DArrayShadow", 20) == 0) ||
-						(mu_strncmp(&code[token.index], "sampler2DArrayShadow", 20) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-				case 22: {
-					if (
-						(mu_strncmp(&code[token.index], "samplerCubeArrayShadow", 22) == 0)
-					) {
-						token.type = MUVGC_TOKEN_KEYWORD;
-					}
-				} break;
-			}
-
-			// (reserved keywords)
-			if (token.type == MUVGC_TOKEN_IDENTIFIER) {
-				switch (token.length) {
-					default: break;
-					case 3: {
-						if (
-							(mu_strncmp(&code[token.index], "asm", 3) == 0)
-						) {
-							token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
-						}
-					} break;
-					case 4: {
-						if (
-							(mu_strncmp(&code[token.index], "enum", 4) == 0) ||
-							(mu_strncmp(&code[token.index], "this", 4) == 0) ||
-							(mu_strncmp(&code[token.index], "goto", 4) == 0) ||
-							(mu_strncmp(&code[token.index], "long", 4) == 0) ||
-							(mu_strncmp(&code[token.index], "half", 4) == 0) ||
-							(mu_strncmp(&code[token.index], "cast", 4) == 0)
-						) {
-							token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
-						}
-					} break;
-					case 5: {
-						if (
-							(mu_strncmp(&code[token.index], "class", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "union", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "short", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "fixed", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "input", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "hvec2", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "hvec3", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "hvec4", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "fvec2", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "fvec3", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "fvec4", 5) == 0) ||
-							(mu_strncmp(&code[token.index], "using", 5) == 0)
-						) {
-							token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
-						}
-					} break;
-					case 6: {
-						if (
-							(mu_strncmp(&code[token.index], "common", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "active", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "inline", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "public", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "static", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "extern", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "superp", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "output", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "filter", 6) == 0) ||
-							(mu_strncmp(&code[token.index], "sizeof", 6) == 0)
-						) {
-							token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
-						}
-					} break;
-					case 7: {
-						if (
-							(mu_strncmp(&code[token.index], "typedef", 7) == 0)
-						) {
-							token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
-						}
-					} break;
-					case 8: {
-						if (
-							(mu_strncmp(&code[token.index], "template", 8) == 0) ||
-							(mu_strncmp(&code[token.index], "resource", 8) == 0) ||
-							(mu_strncmp(&code[token.index], "noinline", 8) == 0) ||
-							(mu_strncmp(&code[token.index], "external", 8) == 0) ||
-							(mu_strncmp(&code[token.index], "unsigned", 8) == 0)
-						) {
-							token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
-						}
-					} break;
-					case 9: {
-						if (
-							(mu_strncmp(&code[token.index], "partition", 9) == 0) ||
-							(mu_strncmp(&code[token.index], "interface", 9) == 0) ||
-							(mu_strncmp(&code[token.index], "namespace", 9) == 0)
-						) {
-							token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
-						}
-					} break;
-					case 13: {
-						if (
-							(mu_strncmp(&code[token.index], "sampler3DRect", 13) == 0)
-						) {
-							token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
-						}
-					} break;
+			// (keywords & reserved keywords)
+			const muVGCKeyword* keyword = muVGC_find_keyword(&code[token.index], token.length);
+			token.keyword = keyword;
+			if (keyword != MU_NULL_PTR) {
+				if (keyword->type == MUVGC_KEYWORD_TYPE_KEYWORD) {
+					token.type = MUVGC_TOKEN_KEYWORD;
+				} else if (keyword->type == MUVGC_KEYWORD_TYPE_RESERVED) {
+					token.type = MUVGC_TOKEN_RESERVED_KEYWORD;
 				}
 			}
 		}
@@ -2089,7 +2390,7 @@ extern "C" { // }
 				token.type = MUVGC_TOKEN_PERIOD;
 			} break;
 			case '+': {
-				token.type = MUVGC_TOKEN_PERIOD;
+				token.type = MUVGC_TOKEN_PLUS;
 			} break;
 			case '-': {
 				token.type = MUVGC_TOKEN_DASH;
@@ -2157,1446 +2458,13820 @@ extern "C" { // }
 			case '?': {
 				token.type = MUVGC_TOKEN_QUESTION_MARK;
 			} break;
+			case '#': {
+				if (code[token.index+1] == '#') {
+					token.type = MUVGC_TOKEN_DOUBLE_HASH;
+					token.length = 2;
+				} else {
+					token.type = MUVGC_TOKEN_HASH;
+				}
+			} break;
 		}
 
 		return token;
 	}
 
-	// final handling
-
-	muVGCToken* muVGC_tokenize_code(const char* code, size_m codelen, const char* og, size_m* len) {
-		// Intentionally, length is one less than necessary to not store EOF token
-		*len = 0;
-
-		// I do end up tokenizing twice, once to count how many tokens needed &
-		// once to gather the tokens again. This could be optimized, but I can't
-		// think of an immediate way...
-
-		muVGCToken token = muVGC_get_token(code, codelen, muVGC_get_next_non_empty_char(code, codelen, 0));
-		while (token.type != MUVGC_TOKEN_END_OF_FILE) {
-			if (token.type == MUVGC_TOKEN_UNKNOWN) {
-				muVGC_print_syntax_error(og, token.index);
-				mu_print("unrecognized symbol\n");
-				return MU_NULL_PTR;
-			}
+	// Tokens that macros expand to point at the text of the macro's
+	// definition (or at text the preprocessor added past the end of the
+	// code), so a token's value is always wherever its index says, and the
+	// original code positioning is left as it is
+	char* muVGC_get_token_value(const char* code, muVGCToken token) {
+		return (char*)&code[token.index];
+	}
 
-			token = muVGC_get_token(code, codelen, muVGC_get_next_non_empty_char(code, codelen, token.index + token.length));
-			*len += 1;
+	// Returns the value of an integer constant token (decimal only for now)
+	uint32_m muVGC_get_integer_token_value(const char* code, muVGCToken token) {
+		uint32_m value = 0;
+		for (size_m i = 0; i < token.length; i++) {
+			value = value*10 + (uint32_m)(code[token.index+i]-'0');
 		}
-		
-		if (*len == 0) {
-			mu_print("[muVGC] Syntax error; expected at least one token after version\n");
-			return MU_NULL_PTR;
-		}
-		muVGCToken* tokens = mu_malloc(sizeof(muVGCToken) * (*len));
+		return value;
+	}
 
-		token = muVGC_get_token(code, codelen, muVGC_get_next_non_empty_char(code, codelen, 0));
-		tokens[0] = token;
-		size_m index = 0;
-		while (token.type != MUVGC_TOKEN_END_OF_FILE) {
-			token = muVGC_get_token(code, codelen, muVGC_get_next_non_empty_char(code, codelen, token.index + token.length));
-			index++;
-			if (token.type != MUVGC_TOKEN_END_OF_FILE) {
-				tokens[index] = token;
+	// Returns the value of a float constant token (as in 1.5, .5 or 1.5f)
+	float muVGC_get_float_token_value(const char* code, muVGCToken token) {
+		// (Digits past what a 64-bit integer holds exactly are dropped,
+		// which is well below float precision)
+		uint64_m mantissa = 0;
+		int32_m exponent = 0;
+		muBool fraction = MU_FALSE;
+		for (size_m i = 0; i < token.length; i++) {
+			char c = code[token.index+i];
+			if (c == '.') {
+				fraction = MU_TRUE;
+				continue;
 			}
-		}
-
-		/*for (size_m i = 0; i < *len; i++) {
-			muVGC_print_token_type(tokens[i].type);
-			mu_print(" ( '");
-			for (size_m j = 0; j < tokens[i].length; j++) {
-				mu_printf("%c", code[tokens[i].index+j]);
+			if (c < '0' || c > '9') break;
+			if (mantissa < 100000000000000000ULL) {
+				mantissa = mantissa*10 + (uint64_m)(c-'0');
+				exponent -= (fraction == MU_TRUE) ? 1 : 0;
+			} else {
+				exponent += (fraction == MU_TRUE) ? 0 : 1;
 			}
-			mu_print("' )");
-			mu_print("\n");
-		}*/
-
-		return tokens;
+		}
+		double scale = 1.0;
+		for (int32_m i = 0; i < exponent || i < -exponent; i++) {
+			scale *= 10.0;
+		}
+		return (float)((exponent < 0) ? (double)mantissa / scale : (double)mantissa * scale);
 	}
 
-	// This function exists for now because I'll most likely add a way for
-	// macros to override token values without messing up original code
-	// spacing, essentially taking advantage of the tokens to store the
-	// original code positioning
-	char* muVGC_get_token_value(const char* code, muVGCToken token) {
-		return (char*)&code[token.index];
-	}
+/* MODULE HANDLING */
+
+	// The compiler doesn't write SPIR-V bytes while it walks statements;
+	// instead it builds an in-memory module whose instructions map 1:1 onto
+	// SPIR-V instructions. Instructions, operands, blocks and functions live
+	// in arenas owned by the module and refer to each other by index, and
+	// every result id is dense (below module->bound) and maps back to its
+	// defining instruction. Optimization passes run over the module, and
+	// muVGC_module_serialize writes the final binary once they're done.
+
+	// Opcodes
+
+	enum muVGCOpcode {
+		MUVGC_OP_NOP=0,
+		MUVGC_OP_UNDEF=1,
+		MUVGC_OP_SOURCE=3,
+		MUVGC_OP_SOURCE_EXTENSION=4,
+		MUVGC_OP_NAME=5,
+		MUVGC_OP_MEMBER_NAME=6,
+		MUVGC_OP_STRING=7,
+		MUVGC_OP_EXTENSION=10,
+		MUVGC_OP_EXT_INST_IMPORT=11,
+		MUVGC_OP_EXT_INST=12,
+		MUVGC_OP_MEMORY_MODEL=14,
+		MUVGC_OP_ENTRY_POINT=15,
+		MUVGC_OP_EXECUTION_MODE=16,
+		MUVGC_OP_CAPABILITY=17,
+		MUVGC_OP_TYPE_VOID=19,
+		MUVGC_OP_TYPE_BOOL=20,
+		MUVGC_OP_TYPE_INT=21,
+		MUVGC_OP_TYPE_FLOAT=22,
+		MUVGC_OP_TYPE_VECTOR=23,
+		MUVGC_OP_TYPE_MATRIX=24,
+		MUVGC_OP_TYPE_IMAGE=25,
+		MUVGC_OP_TYPE_SAMPLER=26,
+		MUVGC_OP_TYPE_SAMPLED_IMAGE=27,
+		MUVGC_OP_TYPE_ARRAY=28,
+		MUVGC_OP_TYPE_RUNTIME_ARRAY=29,
+		MUVGC_OP_TYPE_STRUCT=30,
+		MUVGC_OP_TYPE_POINTER=32,
+		MUVGC_OP_TYPE_FUNCTION=33,
+		MUVGC_OP_CONSTANT_TRUE=41,
+		MUVGC_OP_CONSTANT_FALSE=42,
+		MUVGC_OP_CONSTANT=43,
+		MUVGC_OP_CONSTANT_COMPOSITE=44,
+		MUVGC_OP_CONSTANT_NULL=46,
+		MUVGC_OP_SPEC_CONSTANT_TRUE=48,
+		MUVGC_OP_SPEC_CONSTANT_FALSE=49,
+		MUVGC_OP_SPEC_CONSTANT=50,
+		MUVGC_OP_SPEC_CONSTANT_COMPOSITE=51,
+		MUVGC_OP_SPEC_CONSTANT_OP=52,
+		MUVGC_OP_FUNCTION=54,
+		MUVGC_OP_FUNCTION_PARAMETER=55,
+		MUVGC_OP_FUNCTION_END=56,
+		MUVGC_OP_FUNCTION_CALL=57,
+		MUVGC_OP_VARIABLE=59,
+		MUVGC_OP_LOAD=61,
+		MUVGC_OP_STORE=62,
+		MUVGC_OP_ACCESS_CHAIN=65,
+		MUVGC_OP_IN_BOUNDS_ACCESS_CHAIN=66,
+		MUVGC_OP_DECORATE=71,
+		MUVGC_OP_MEMBER_DECORATE=72,
+		MUVGC_OP_VECTOR_SHUFFLE=79,
+		MUVGC_OP_COMPOSITE_CONSTRUCT=80,
+		MUVGC_OP_COMPOSITE_EXTRACT=81,
+		MUVGC_OP_COMPOSITE_INSERT=82,
+		MUVGC_OP_COPY_OBJECT=83,
+		MUVGC_OP_TRANSPOSE=84,
+		MUVGC_OP_CONVERT_F_TO_U=109,
+		MUVGC_OP_CONVERT_F_TO_S=110,
+		MUVGC_OP_CONVERT_S_TO_F=111,
+		MUVGC_OP_CONVERT_U_TO_F=112,
+		MUVGC_OP_BITCAST=124,
+		MUVGC_OP_S_NEGATE=126,
+		MUVGC_OP_F_NEGATE=127,
+		MUVGC_OP_I_ADD=128,
+		MUVGC_OP_F_ADD=129,
+		MUVGC_OP_I_SUB=130,
+		MUVGC_OP_F_SUB=131,
+		MUVGC_OP_I_MUL=132,
+		MUVGC_OP_F_MUL=133,
+		MUVGC_OP_U_DIV=134,
+		MUVGC_OP_S_DIV=135,
+		MUVGC_OP_F_DIV=136,
+		MUVGC_OP_U_MOD=137,
+		MUVGC_OP_S_REM=138,
+		MUVGC_OP_S_MOD=139,
+		MUVGC_OP_F_REM=140,
+		MUVGC_OP_F_MOD=141,
+		MUVGC_OP_VECTOR_TIMES_SCALAR=142,
+		MUVGC_OP_MATRIX_TIMES_SCALAR=143,
+		MUVGC_OP_VECTOR_TIMES_MATRIX=144,
+		MUVGC_OP_MATRIX_TIMES_VECTOR=145,
+		MUVGC_OP_MATRIX_TIMES_MATRIX=146,
+		MUVGC_OP_OUTER_PRODUCT=147,
+		MUVGC_OP_DOT=148,
+		MUVGC_OP_ANY=154,
+		MUVGC_OP_ALL=155,
+		MUVGC_OP_IS_NAN=156,
+		MUVGC_OP_IS_INF=157,
+		MUVGC_OP_LOGICAL_EQUAL=164,
+		MUVGC_OP_LOGICAL_NOT_EQUAL=165,
+		MUVGC_OP_LOGICAL_OR=166,
+		MUVGC_OP_LOGICAL_AND=167,
+		MUVGC_OP_LOGICAL_NOT=168,
+		MUVGC_OP_SELECT=169,
+		MUVGC_OP_I_EQUAL=170,
+		MUVGC_OP_I_NOT_EQUAL=171,
+		MUVGC_OP_U_GREATER_THAN=172,
+		MUVGC_OP_S_GREATER_THAN=173,
+		MUVGC_OP_U_GREATER_THAN_EQUAL=174,
+		MUVGC_OP_S_GREATER_THAN_EQUAL=175,
+		MUVGC_OP_U_LESS_THAN=176,
+		MUVGC_OP_S_LESS_THAN=177,
+		MUVGC_OP_U_LESS_THAN_EQUAL=178,
+		MUVGC_OP_S_LESS_THAN_EQUAL=179,
+		MUVGC_OP_F_ORD_EQUAL=180,
+		MUVGC_OP_F_UNORD_EQUAL=181,
+		MUVGC_OP_F_ORD_NOT_EQUAL=182,
+		MUVGC_OP_F_UNORD_NOT_EQUAL=183,
+		MUVGC_OP_F_ORD_LESS_THAN=184,
+		MUVGC_OP_F_UNORD_LESS_THAN=185,
+		MUVGC_OP_F_ORD_GREATER_THAN=186,
+		MUVGC_OP_F_UNORD_GREATER_THAN=187,
+		MUVGC_OP_F_ORD_LESS_THAN_EQUAL=188,
+		MUVGC_OP_F_UNORD_LESS_THAN_EQUAL=189,
+		MUVGC_OP_F_ORD_GREATER_THAN_EQUAL=190,
+		MUVGC_OP_F_UNORD_GREATER_THAN_EQUAL=191,
+		MUVGC_OP_SHIFT_RIGHT_LOGICAL=194,
+		MUVGC_OP_SHIFT_RIGHT_ARITHMETIC=195,
+		MUVGC_OP_SHIFT_LEFT_LOGICAL=196,
+		MUVGC_OP_BITWISE_OR=197,
+		MUVGC_OP_BITWISE_XOR=198,
+		MUVGC_OP_BITWISE_AND=199,
+		MUVGC_OP_NOT=200,
+		MUVGC_OP_CONTROL_BARRIER=224,
+		MUVGC_OP_MEMORY_BARRIER=225,
+		MUVGC_OP_ATOMIC_EXCHANGE=229,
+		MUVGC_OP_ATOMIC_I_ADD=234,
+		MUVGC_OP_ATOMIC_S_MIN=236,
+		MUVGC_OP_ATOMIC_U_MIN=237,
+		MUVGC_OP_ATOMIC_S_MAX=238,
+		MUVGC_OP_ATOMIC_U_MAX=239,
+		MUVGC_OP_ATOMIC_AND=240,
+		MUVGC_OP_ATOMIC_OR=241,
+		MUVGC_OP_ATOMIC_XOR=242,
+		MUVGC_OP_PHI=245,
+		MUVGC_OP_LOOP_MERGE=246,
+		MUVGC_OP_SELECTION_MERGE=247,
+		MUVGC_OP_LABEL=248,
+		MUVGC_OP_BRANCH=249,
+		MUVGC_OP_BRANCH_CONDITIONAL=250,
+		MUVGC_OP_SWITCH=251,
+		MUVGC_OP_KILL=252,
+		MUVGC_OP_RETURN=253,
+		MUVGC_OP_RETURN_VALUE=254,
+		MUVGC_OP_UNREACHABLE=255,
+		MUVGC_OP_GROUP_NON_UNIFORM_ELECT=333,
+		MUVGC_OP_GROUP_NON_UNIFORM_ALL=334,
+		MUVGC_OP_GROUP_NON_UNIFORM_ANY=335,
+		MUVGC_OP_GROUP_NON_UNIFORM_ALL_EQUAL=336,
+		MUVGC_OP_GROUP_NON_UNIFORM_BROADCAST=337,
+		MUVGC_OP_GROUP_NON_UNIFORM_BROADCAST_FIRST=338,
+		MUVGC_OP_GROUP_NON_UNIFORM_BALLOT=339,
+		MUVGC_OP_GROUP_NON_UNIFORM_INVERSE_BALLOT=340,
+		MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_BIT_EXTRACT=341,
+		MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_BIT_COUNT=342,
+		MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_FIND_LSB=343,
+		MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_FIND_MSB=344,
+		MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE=345,
+		MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_XOR=346,
+		MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_UP=347,
+		MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_DOWN=348,
+		MUVGC_OP_GROUP_NON_UNIFORM_I_ADD=349,
+		MUVGC_OP_GROUP_NON_UNIFORM_F_ADD=350,
+		MUVGC_OP_GROUP_NON_UNIFORM_I_MUL=351,
+		MUVGC_OP_GROUP_NON_UNIFORM_F_MUL=352,
+		MUVGC_OP_GROUP_NON_UNIFORM_S_MIN=353,
+		MUVGC_OP_GROUP_NON_UNIFORM_U_MIN=354,
+		MUVGC_OP_GROUP_NON_UNIFORM_F_MIN=355,
+		MUVGC_OP_GROUP_NON_UNIFORM_S_MAX=356,
+		MUVGC_OP_GROUP_NON_UNIFORM_U_MAX=357,
+		MUVGC_OP_GROUP_NON_UNIFORM_F_MAX=358,
+		MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_AND=359,
+		MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_OR=360,
+		MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_XOR=361,
+		MUVGC_OP_GROUP_NON_UNIFORM_LOGICAL_AND=362,
+		MUVGC_OP_GROUP_NON_UNIFORM_LOGICAL_OR=363,
+		MUVGC_OP_GROUP_NON_UNIFORM_LOGICAL_XOR=364
+	};
+	typedef enum muVGCOpcode muVGCOpcode;
+
+	// Sections (in the order of the SPIR-V logical layout)
+
+	enum muVGCSection {
+		MUVGC_SECTION_CAPABILITY=0,
+		MUVGC_SECTION_EXTENSION=1,
+		MUVGC_SECTION_EXT_INST_IMPORT=2,
+		MUVGC_SECTION_MEMORY_MODEL=3,
+		MUVGC_SECTION_ENTRY_POINT=4,
+		MUVGC_SECTION_EXECUTION_MODE=5,
+		// OpString, OpSource, OpSourceExtension, ...
+		MUVGC_SECTION_DEBUG_SOURCE=6,
+		// OpName, OpMemberName
+		MUVGC_SECTION_DEBUG_NAME=7,
+		// OpDecorate, OpMemberDecorate, ...
+		MUVGC_SECTION_ANNOTATION=8,
+		// Types, constants and global variables
+		MUVGC_SECTION_GLOBAL=9,
+		// Function instructions aren't kept in a section list, but in the
+		// blocks of their function
+		MUVGC_SECTION_FUNCTION=10
+
+		#define MUVGC_SECTION_FIRST MUVGC_SECTION_CAPABILITY
+		#define MUVGC_SECTION_LAST  MUVGC_SECTION_FUNCTION
+	};
+	typedef enum muVGCSection muVGCSection;
+
+	// Storage classes
+
+	enum muVGCStorageClass {
+		MUVGC_STORAGE_CLASS_UNIFORM_CONSTANT=0,
+		MUVGC_STORAGE_CLASS_INPUT=1,
+		MUVGC_STORAGE_CLASS_UNIFORM=2,
+		MUVGC_STORAGE_CLASS_OUTPUT=3,
+		MUVGC_STORAGE_CLASS_WORKGROUP=4,
+		MUVGC_STORAGE_CLASS_CROSS_WORKGROUP=5,
+		MUVGC_STORAGE_CLASS_PRIVATE=6,
+		MUVGC_STORAGE_CLASS_FUNCTION=7,
+		MUVGC_STORAGE_CLASS_GENERIC=8,
+		MUVGC_STORAGE_CLASS_PUSH_CONSTANT=9,
+		MUVGC_STORAGE_CLASS_ATOMIC_COUNTER=10,
+		MUVGC_STORAGE_CLASS_IMAGE=11,
+		MUVGC_STORAGE_CLASS_STORAGE_BUFFER=12
+	};
+	typedef enum muVGCStorageClass muVGCStorageClass;
+
+	// Capabilities
+
+	enum muVGCCapability {
+		MUVGC_CAPABILITY_SHADER=1,
+		MUVGC_CAPABILITY_FLOAT16=9,
+		MUVGC_CAPABILITY_FLOAT64=10,
+		MUVGC_CAPABILITY_INT64=11,
+		MUVGC_CAPABILITY_INT16=22,
+		MUVGC_CAPABILITY_INT8=39,
+		// (SPIR-V 1.3)
+		MUVGC_CAPABILITY_GROUP_NON_UNIFORM=61,
+		MUVGC_CAPABILITY_GROUP_NON_UNIFORM_VOTE=62,
+		MUVGC_CAPABILITY_GROUP_NON_UNIFORM_ARITHMETIC=63,
+		MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT=64,
+		MUVGC_CAPABILITY_GROUP_NON_UNIFORM_SHUFFLE=65,
+		MUVGC_CAPABILITY_GROUP_NON_UNIFORM_SHUFFLE_RELATIVE=66,
+		MUVGC_CAPABILITY_GROUP_NON_UNIFORM_CLUSTERED=67,
+		// (SPV_KHR_16bit_storage)
+		MUVGC_CAPABILITY_STORAGE_BUFFER_16BIT_ACCESS=4433,
+		MUVGC_CAPABILITY_UNIFORM_AND_STORAGE_BUFFER_16BIT_ACCESS=4434,
+		MUVGC_CAPABILITY_STORAGE_PUSH_CONSTANT_16=4435,
+		MUVGC_CAPABILITY_STORAGE_INPUT_OUTPUT_16=4436,
+		// (SPV_KHR_8bit_storage)
+		MUVGC_CAPABILITY_STORAGE_BUFFER_8BIT_ACCESS=4448,
+		MUVGC_CAPABILITY_UNIFORM_AND_STORAGE_BUFFER_8BIT_ACCESS=4449,
+		MUVGC_CAPABILITY_STORAGE_PUSH_CONSTANT_8=4450
+	};
+	typedef enum muVGCCapability muVGCCapability;
 
-/* INSTRUCTION HANDLING */
+	// Function control (bitmask)
 
-	// 3.49.2 Debug Instructions
+	enum muVGCFunctionControl {
+		MUVGC_FUNCTION_CONTROL_NONE=0,
+		MUVGC_FUNCTION_CONTROL_INLINE=1,
+		MUVGC_FUNCTION_CONTROL_DONT_INLINE=2,
+		MUVGC_FUNCTION_CONTROL_PURE=4,
+		MUVGC_FUNCTION_CONTROL_CONST=8
+	};
+	typedef enum muVGCFunctionControl muVGCFunctionControl;
 
-		muString muVGC_op_name(muString bytecode, uint32_m id_target, char* name, size_m namelen) {
-			size_m i = muVGC_hop_to_naming_section(bytecode);
+	// Loop control (bitmask)
 
-			size_m datanamelen = namelen;
-			if ((datanamelen % 4) == 0) {
-				datanamelen++;
-			}
-			while (((datanamelen) % 4) != 0) {
-				datanamelen++;
-			}
-			uint16_m fulllen = (datanamelen / 4) + 2;
+	enum muVGCLoopControl {
+		MUVGC_LOOP_CONTROL_NONE=0,
+		MUVGC_LOOP_CONTROL_UNROLL=1,
+		MUVGC_LOOP_CONTROL_DONT_UNROLL=2,
+		MUVGC_LOOP_CONTROL_DEPENDENCY_INFINITE=4,
+		MUVGC_LOOP_CONTROL_DEPENDENCY_LENGTH=8
+	};
+	typedef enum muVGCLoopControl muVGCLoopControl;
 
-			char b[] = {
-				5, 0, MUVGC_2_BYTE_LE(fulllen),
-				MUVGC_4_BYTE_LE(id_target)
-			};
-			bytecode = mu_string_insert_raw(bytecode, b, sizeof(b), i);
-			i += sizeof(b);
+	// Selection control (bitmask)
 
-			bytecode = mu_string_insert_raw(bytecode, name, namelen, i);
-			i += namelen;
+	enum muVGCSelectionControl {
+		MUVGC_SELECTION_CONTROL_NONE=0,
+		MUVGC_SELECTION_CONTROL_FLATTEN=1,
+		MUVGC_SELECTION_CONTROL_DONT_FLATTEN=2
+	};
+	typedef enum muVGCSelectionControl muVGCSelectionControl;
 
-			char four_empty[] = { 0, 0, 0, 0 };
-			return mu_string_insert_raw(bytecode, four_empty, datanamelen-namelen, i);
-		}
+	// Execution modes
 
-	// 3.49.6 Type-Declaration Instructions (Get)
+	enum muVGCExecutionMode {
+		MUVGC_EXECUTION_MODE_ORIGIN_UPPER_LEFT=7,
+		MUVGC_EXECUTION_MODE_LOCAL_SIZE=17
+	};
+	typedef enum muVGCExecutionMode muVGCExecutionMode;
+
+	// Decorations
+
+	enum muVGCDecoration {
+		MUVGC_DECORATION_RELAXED_PRECISION=0,
+		MUVGC_DECORATION_SPEC_ID=1,
+		MUVGC_DECORATION_BLOCK=2,
+		MUVGC_DECORATION_ROW_MAJOR=4,
+		MUVGC_DECORATION_COL_MAJOR=5,
+		MUVGC_DECORATION_ARRAY_STRIDE=6,
+		MUVGC_DECORATION_MATRIX_STRIDE=7,
+		MUVGC_DECORATION_BUILT_IN=11,
+		MUVGC_DECORATION_NO_PERSPECTIVE=13,
+		MUVGC_DECORATION_FLAT=14,
+		MUVGC_DECORATION_RESTRICT=19,
+		MUVGC_DECORATION_VOLATILE=21,
+		MUVGC_DECORATION_COHERENT=23,
+		MUVGC_DECORATION_NON_WRITABLE=24,
+		MUVGC_DECORATION_NON_READABLE=25,
+		MUVGC_DECORATION_LOCATION=30,
+		MUVGC_DECORATION_COMPONENT=31,
+		MUVGC_DECORATION_BINDING=33,
+		MUVGC_DECORATION_DESCRIPTOR_SET=34,
+		MUVGC_DECORATION_OFFSET=35
+	};
+	typedef enum muVGCDecoration muVGCDecoration;
+
+	// Built-ins (for the BuiltIn decoration)
+
+	enum muVGCBuiltIn {
+		MUVGC_BUILT_IN_POSITION=0,
+		MUVGC_BUILT_IN_POINT_SIZE=1,
+		MUVGC_BUILT_IN_FRAG_COORD=15,
+		MUVGC_BUILT_IN_NUM_WORKGROUPS=24,
+		MUVGC_BUILT_IN_WORKGROUP_SIZE=25,
+		MUVGC_BUILT_IN_WORKGROUP_ID=26,
+		MUVGC_BUILT_IN_LOCAL_INVOCATION_ID=27,
+		MUVGC_BUILT_IN_GLOBAL_INVOCATION_ID=28,
+		MUVGC_BUILT_IN_LOCAL_INVOCATION_INDEX=29,
+		MUVGC_BUILT_IN_SUBGROUP_SIZE=36,
+		MUVGC_BUILT_IN_NUM_SUBGROUPS=38,
+		MUVGC_BUILT_IN_SUBGROUP_ID=40,
+		MUVGC_BUILT_IN_SUBGROUP_LOCAL_INVOCATION_ID=41,
+		MUVGC_BUILT_IN_VERTEX_INDEX=42,
+		MUVGC_BUILT_IN_INSTANCE_INDEX=43,
+		MUVGC_BUILT_IN_SUBGROUP_EQ_MASK=4416,
+		MUVGC_BUILT_IN_SUBGROUP_GE_MASK=4417,
+		MUVGC_BUILT_IN_SUBGROUP_GT_MASK=4418,
+		MUVGC_BUILT_IN_SUBGROUP_LE_MASK=4419,
+		MUVGC_BUILT_IN_SUBGROUP_LT_MASK=4420
+	};
+	typedef enum muVGCBuiltIn muVGCBuiltIn;
 
-		muString muVGC_get_void_type(muString bytecode, uint32_m* void_type, uint32_m* global_id) {
-			size_m dec = muVGC_hop_to_decoration_section(bytecode);
-			size_m var = muVGC_hop_to_variable_section(bytecode);
+	// Scopes
 
-			for (size_m i = dec; i < var;) {
-				int16_m instruction = muVGC_get_halfword(&bytecode.s[i]);
-				int16_m step = muVGC_get_halfword(&bytecode.s[i+2]);
+	enum muVGCScope {
+		MUVGC_SCOPE_DEVICE=1,
+		MUVGC_SCOPE_WORKGROUP=2,
+		MUVGC_SCOPE_SUBGROUP=3
+	};
+	typedef enum muVGCScope muVGCScope;
 
-				if (instruction == 19 && step == 2) {
-					*void_type = muVGC_get_word(&bytecode.s[i+4]);
-					return bytecode;
-				}
+	// Group operations
 
-				i += step * 4;
-			}
+	enum muVGCGroupOperation {
+		MUVGC_GROUP_OPERATION_REDUCE=0,
+		MUVGC_GROUP_OPERATION_INCLUSIVE_SCAN=1,
+		MUVGC_GROUP_OPERATION_EXCLUSIVE_SCAN=2,
+		MUVGC_GROUP_OPERATION_CLUSTERED_REDUCE=3
+	};
+	typedef enum muVGCGroupOperation muVGCGroupOperation;
 
-			char b[] = {
-				19, 0, 2, 0,
-				MUVGC_4_BYTE_LE(*global_id)
-			};
-			*void_type = *global_id;
-			*global_id += 1;
-			return mu_string_insert_raw(bytecode, b, sizeof(b), var);
-		}
+	// (For group instructions that don't take a group operation)
+	#define MUVGC_NO_GROUP_OPERATION ((uint32_m)-1)
 
-		muString muVGC_get_bool_type(muString bytecode, uint32_m* bool_type, uint32_m* global_id) {
-			size_m dec = muVGC_hop_to_decoration_section(bytecode);
-			size_m var = muVGC_hop_to_variable_section(bytecode);
+	// Memory semantics (bitmask)
 
-			for (size_m i = dec; i < var;) {
-				int16_m instruction = muVGC_get_halfword(&bytecode.s[i]);
-				int16_m step = muVGC_get_halfword(&bytecode.s[i+2]);
+	enum muVGCMemorySemantics {
+		MUVGC_MEMORY_SEMANTICS_NONE=0,
+		MUVGC_MEMORY_SEMANTICS_ACQUIRE_RELEASE=0x8,
+		MUVGC_MEMORY_SEMANTICS_UNIFORM_MEMORY=0x40,
+		MUVGC_MEMORY_SEMANTICS_WORKGROUP_MEMORY=0x100,
+		MUVGC_MEMORY_SEMANTICS_IMAGE_MEMORY=0x800
+	};
+	typedef enum muVGCMemorySemantics muVGCMemorySemantics;
 
-				if (instruction == 20 && step == 2) {
-					*bool_type = muVGC_get_word(&bytecode.s[i+4]);
-					return bytecode;
-				}
+	// SPIR-V versions (as the header's version word)
 
-				i += step * 4;
-			}
+	#define MUVGC_SPIRV_VERSION_1_0 0x00010000
+	// (Group non-uniform instructions, Vulkan 1.1)
+	#define MUVGC_SPIRV_VERSION_1_3 0x00010300
 
-			char b[] = {
-				20, 0, 2, 0,
-				MUVGC_4_BYTE_LE(*global_id)
-			};
-			*bool_type = *global_id;
-			*global_id += 1;
-			return mu_string_insert_raw(bytecode, b, sizeof(b), var);
-		}
+	// Structs
 
-		muString muVGC_get_int_type(muString bytecode, uint32_m* int_type, uint32_m* global_id, uint32_m width, uint32_m signedness) {
-			size_m dec = muVGC_hop_to_decoration_section(bytecode);
-			size_m var = muVGC_hop_to_variable_section(bytecode);
+	struct muVGCOperand {
+		muBool is_id;
+		uint32_m word;
+	};
+	typedef struct muVGCOperand muVGCOperand;
+
+	#define MUVGC_ID(id) { MU_TRUE, (uint32_m)(id) }
+	#define MUVGC_LITERAL(word) { MU_FALSE, (uint32_m)(word) }
+
+	struct muVGCInstruction {
+		muBool active;
+		uint16_m opcode;
+		// 0 if the instruction has no result type/id
+		uint32_m result_type;
+		uint32_m result_id;
+		// (into module->operands)
+		size_m operand_index;
+		size_m operand_len;
+	};
+	typedef struct muVGCInstruction muVGCInstruction;
 
-			for (size_m i = dec; i < var;) {
-				int16_m instruction = muVGC_get_halfword(&bytecode.s[i]);
-				int16_m step = muVGC_get_halfword(&bytecode.s[i+2]);
+	struct muVGCIndexList {
+		size_m* indexes;
+		size_m len;
+		size_m allocated_len;
+	};
+	typedef struct muVGCIndexList muVGCIndexList;
 
-				if (instruction == 21 && step == 4 && muVGC_get_word(&bytecode.s[i+8]) == width && muVGC_get_word(&bytecode.s[i+12]) == signedness) {
-					*int_type = muVGC_get_word(&bytecode.s[i+4]);
-					return bytecode;
-				}
+	struct muVGCBlock {
+		// The OpLabel instruction
+		size_m label;
+		// Every instruction after OpLabel, ending with the terminator
+		muVGCIndexList instructions;
+	};
+	typedef struct muVGCBlock muVGCBlock;
+
+	struct muVGCFunction {
+		muBool active;
+		// The OpFunction instruction; OpFunctionEnd is implied
+		size_m instruction;
+		muVGCIndexList parameters;
+		// (into module->blocks, first one being the entry block)
+		muVGCIndexList blocks;
+	};
+	typedef struct muVGCFunction muVGCFunction;
+
+	// Rules for laying out the members of uniform, storage & push constant
+	// blocks in memory (see muVGC_get_type_layout)
+	enum muVGCLayoutRules {
+		MUVGC_LAYOUT_STD140=0,
+		MUVGC_LAYOUT_STD430=1,
+		MUVGC_LAYOUT_SCALAR=2
+	};
+	typedef enum muVGCLayoutRules muVGCLayoutRules;
+
+	// (Array length of runtime arrays)
+	#define MUVGC_RUNTIME_ARRAY_LENGTH ((uint32_m)-1)
+
+	struct muVGCTypeLayout {
+		// What's laid out: a type, or an array of 'array_length' of it (0
+		// meaning it isn't an array)
+		uint32_m type;
+		uint32_m array_length;
+		muVGCLayoutRules rules;
+		// (Only ever true for matrices & arrays of them)
+		muBool row_major;
+		// The type to declare a member of this layout as; for arrays, an
+		// array type decorated with the stride
+		uint32_m layout_type;
+		uint32_m size;
+		uint32_m alignment;
+		// (0 for anything but arrays)
+		uint32_m array_stride;
+		// (0 for anything but matrices & arrays of them)
+		uint32_m matrix_stride;
+	};
+	typedef struct muVGCTypeLayout muVGCTypeLayout;
+
+	// A declared variable that reflection describes, by its id (0 once
+	// it's been optimized away)
+	struct muVGCReflectedVariable {
+		uint32_m id;
+		uint32_m storage_class;
+		// (Blocks; for push constant blocks, 'offset' is where the first
+		// member starts)
+		uint32_m set;
+		uint32_m binding;
+		uint32_m offset;
+		uint32_m size;
+		// (Inputs & outputs)
+		muVGCInterfaceLocation location;
+	};
+	typedef struct muVGCReflectedVariable muVGCReflectedVariable;
+
+	struct muVGCModule {
+		muVGCInstruction* instructions;
+		size_m instruction_len;
+		size_m allocated_instruction_len;
+
+		muVGCOperand* operands;
+		size_m operand_len;
+		size_m allocated_operand_len;
+
+		muVGCBlock* blocks;
+		size_m block_len;
+		size_m allocated_block_len;
+
+		muVGCFunction* functions;
+		size_m function_len;
+		size_m allocated_function_len;
+
+		muVGCIndexList sections[MUVGC_SECTION_LAST+1];
+
+		// Defining instruction of each id, +1 (0 meaning undefined)
+		size_m* definitions;
+		size_m allocated_definition_len;
+
+		// Next unused id
+		uint32_m bound;
+		// Id of the entry point function
+		uint32_m entry_point;
+		// Stage being compiled
+		muVGCShader shader;
+		// SPIR-V version the module needs (1.0 unless something it uses
+		// only exists in a later one)
+		uint32_m version;
+
+		// Whether debug instructions are left out
+		muBool strip_debug;
+
+		// Explicit layouts worked out so far
+		muVGCTypeLayout* layouts;
+		size_m layout_len;
+		size_m allocated_layout_len;
+
+		// Blocks & inputs/outputs for reflection, in the order they were
+		// declared, and the local size of a compute shader (with the
+		// SpecIds specializing it, +1, 0 meaning none)
+		muVGCReflectedVariable* reflected_variables;
+		size_m reflected_variable_len;
+		size_m allocated_reflected_variable_len;
+		uint32_m local_size[3];
+		uint32_m local_size_spec_ids[3];
+
+		// Hash table of the types & constants that can be shared (see
+		// muVGC_module_get_global), as their instruction +1 (0 meaning an
+		// empty slot), its capacity being a power of 2
+		size_m* global_table;
+		size_m global_table_capacity;
+		size_m global_table_len;
+
+		// Replacements of ids not yet applied (see
+		// muVGC_module_replace_uses), 0 meaning none
+		uint32_m* replacements;
+		size_m allocated_replacement_len;
+		size_m replacement_len;
+	};
+	typedef struct muVGCModule muVGCModule;
 
-				i += step * 4;
-			}
+	// Use lists, built on demand; the instructions using id 'i' are
+	// instructions[first[i]] up to instructions[first[i+1]]
+	struct muVGCUses {
+		size_m* first;
+		size_m* instructions;
+	};
+	typedef struct muVGCUses muVGCUses;
 
-			char b[] = {
-				21, 0, 4, 0,
-				MUVGC_4_BYTE_LE(*global_id),
-				MUVGC_4_BYTE_LE(width),
-				MUVGC_4_BYTE_LE(signedness)
-			};
-			*int_type = *global_id;
-			*global_id += 1;
-			return mu_string_insert_raw(bytecode, b, sizeof(b), var);
+	// Index lists
+
+	void muVGC_index_list_add(muVGCIndexList* list, size_m index) {
+		if (list->indexes == MU_NULL_PTR) {
+			list->allocated_len = 2;
+			list->indexes = mu_malloc(sizeof(size_m) * list->allocated_len);
+		} else if (list->len >= list->allocated_len) {
+			list->allocated_len *= 2;
+			list->indexes = mu_realloc(list->indexes, sizeof(size_m) * list->allocated_len);
 		}
+		list->indexes[list->len] = index;
+		list->len += 1;
+	}
 
-		muString muVGC_get_float_type(muString bytecode, uint32_m* float_type, uint32_m* global_id, uint32_m width) {
-			size_m dec = muVGC_hop_to_decoration_section(bytecode);
-			size_m var = muVGC_hop_to_variable_section(bytecode);
+	void muVGC_index_list_insert(muVGCIndexList* list, size_m index, size_m i) {
+		muVGC_index_list_add(list, index);
+		for (size_m j = list->len-1; j > i; j--) {
+			list->indexes[j] = list->indexes[j-1];
+		}
+		list->indexes[i] = index;
+	}
 
-			for (size_m i = dec; i < var;) {
-				int16_m instruction = muVGC_get_halfword(&bytecode.s[i]);
-				int16_m step = muVGC_get_halfword(&bytecode.s[i+2]);
+	void muVGC_index_list_free(muVGCIndexList* list) {
+		if (list->indexes != MU_NULL_PTR) {
+			mu_free(list->indexes);
+			list->indexes = MU_NULL_PTR;
+		}
+		list->len = 0;
+		list->allocated_len = 0;
+	}
 
-				if (instruction == 22 && step == 3 && muVGC_get_word(&bytecode.s[i+8]) == width) {
-					*float_type = muVGC_get_word(&bytecode.s[i+4]);
-					return bytecode;
-				}
+	// Module creation/destruction
 
-				i += step * 4;
-			}
+	void muVGC_initialize_module(muVGCModule* module) {
+		muVGCModule empty = { 0 };
+		*module = empty;
+		// (id 0 is never valid)
+		module->bound = 1;
+		module->version = MUVGC_SPIRV_VERSION_1_0;
+	}
 
-			char b[] = {
-				22, 0, 3, 0,
-				MUVGC_4_BYTE_LE(*global_id),
-				MUVGC_4_BYTE_LE(width)
-			};
-			*float_type = *global_id;
-			*global_id += 1;
-			return mu_string_insert_raw(bytecode, b, sizeof(b), var);
+	void muVGC_free_module(muVGCModule* module) {
+		for (size_m i = 0; i < module->block_len; i++) {
+			muVGC_index_list_free(&module->blocks[i].instructions);
 		}
+		for (size_m i = 0; i < module->function_len; i++) {
+			muVGC_index_list_free(&module->functions[i].parameters);
+			muVGC_index_list_free(&module->functions[i].blocks);
+		}
+		for (size_m i = MUVGC_SECTION_FIRST; i <= MUVGC_SECTION_LAST; i++) {
+			muVGC_index_list_free(&module->sections[i]);
+		}
+		if (module->instructions != MU_NULL_PTR) mu_free(module->instructions);
+		if (module->operands != MU_NULL_PTR) mu_free(module->operands);
+		if (module->blocks != MU_NULL_PTR) mu_free(module->blocks);
+		if (module->functions != MU_NULL_PTR) mu_free(module->functions);
+		if (module->definitions != MU_NULL_PTR) mu_free(module->definitions);
+		if (module->layouts != MU_NULL_PTR) mu_free(module->layouts);
+		if (module->reflected_variables != MU_NULL_PTR) mu_free(module->reflected_variables);
+		if (module->global_table != MU_NULL_PTR) mu_free(module->global_table);
+		if (module->replacements != MU_NULL_PTR) mu_free(module->replacements);
+		muVGC_initialize_module(module);
+	}
 
-		muString muVGC_get_vector_type(muString bytecode, uint32_m* vec_type, uint32_m* global_id, uint32_m component_type, uint32_m component_count) {
-			size_m dec = muVGC_hop_to_decoration_section(bytecode);
-			size_m var = muVGC_hop_to_variable_section(bytecode);
-
-			for (size_m i = dec; i < var;) {
-				int16_m instruction = muVGC_get_halfword(&bytecode.s[i]);
-				int16_m step = muVGC_get_halfword(&bytecode.s[i+2]);
-
-				if (instruction == 23 && step == 4 && muVGC_get_word(&bytecode.s[i+8]) == component_type && muVGC_get_word(&bytecode.s[i+12]) == component_count) {
-					*vec_type = muVGC_get_word(&bytecode.s[i+4]);
-					return bytecode;
-				}
+	// Ids
 
-				i += step * 4;
+	void muVGC_module_set_definition(muVGCModule* module, uint32_m id, size_m instruction) {
+		if (id >= module->allocated_definition_len) {
+			size_m old_len = module->allocated_definition_len;
+			if (module->allocated_definition_len == 0) {
+				module->allocated_definition_len = 16;
+			}
+			while (id >= module->allocated_definition_len) {
+				module->allocated_definition_len *= 2;
+			}
+			module->definitions = mu_realloc(module->definitions, sizeof(size_m) * module->allocated_definition_len);
+			for (size_m i = old_len; i < module->allocated_definition_len; i++) {
+				module->definitions[i] = 0;
 			}
-
-			char b[] = {
-				23, 0, 4, 0,
-				MUVGC_4_BYTE_LE(*global_id),
-				MUVGC_4_BYTE_LE(component_type),
-				MUVGC_4_BYTE_LE(component_count)
-			};
-			*vec_type = *global_id;
-			*global_id += 1;
-			return mu_string_insert_raw(bytecode, b, sizeof(b), var);
 		}
+		module->definitions[id] = instruction;
+	}
 
-		muString muVGC_get_matrix_type(muString bytecode, uint32_m* mat_type, uint32_m* global_id, uint32_m column_type, uint32_m column_count) {
-			size_m dec = muVGC_hop_to_decoration_section(bytecode);
-			size_m var = muVGC_hop_to_variable_section(bytecode);
+	uint32_m muVGC_module_new_id(muVGCModule* module) {
+		uint32_m id = module->bound;
+		module->bound += 1;
+		return id;
+	}
 
-			for (size_m i = dec; i < var;) {
-				int16_m instruction = muVGC_get_halfword(&bytecode.s[i]);
-				int16_m step = muVGC_get_halfword(&bytecode.s[i+2]);
+	// Returns the defining instruction of an id, or MU_NULL_PTR
+	muVGCInstruction* muVGC_module_get_definition(muVGCModule* module, uint32_m id) {
+		if (id >= module->allocated_definition_len || module->definitions[id] == 0) {
+			return MU_NULL_PTR;
+		}
+		return &module->instructions[module->definitions[id]-1];
+	}
 
-				if (instruction == 24 && step == 4 && muVGC_get_word(&bytecode.s[i+8]) == column_type && muVGC_get_word(&bytecode.s[i+12]) == column_count) {
-					*mat_type = muVGC_get_word(&bytecode.s[i+4]);
-					return bytecode;
-				}
+	// Instructions
 
-				i += step * 4;
-			}
+	muVGCOperand* muVGC_module_get_operands(muVGCModule* module, size_m instruction) {
+		return &module->operands[module->instructions[instruction].operand_index];
+	}
 
-			char b[] = {
-				24, 0, 4, 0,
-				MUVGC_4_BYTE_LE(*global_id),
-				MUVGC_4_BYTE_LE(column_type),
-				MUVGC_4_BYTE_LE(column_count)
-			};
-			*mat_type = *global_id;
-			*global_id += 1;
-			return mu_string_insert_raw(bytecode, b, sizeof(b), var);
+	void muVGC_module_reserve_operands(muVGCModule* module, size_m len) {
+		if (module->operand_len + len > module->allocated_operand_len) {
+			if (module->allocated_operand_len == 0) {
+				module->allocated_operand_len = 64;
+			}
+			while (module->operand_len + len > module->allocated_operand_len) {
+				module->allocated_operand_len *= 2;
+			}
+			module->operands = mu_realloc(module->operands, sizeof(muVGCOperand) * module->allocated_operand_len);
 		}
+	}
 
-		muString muVGC_get_image_type(muString bytecode, uint32_m* img_type, uint32_m* global_id, 
-			uint32_m sampled_type, uint32_m dim, uint32_m depth, uint32_m arrayed, uint32_m ms, 
-			uint32_m sampled, uint32_m image_format, uint32_m access_qualifier, muBool apply_access_qualifier) {
+	size_m muVGC_module_add_instruction(
+		muVGCModule* module, uint16_m opcode, uint32_m result_type, uint32_m result_id,
+		const muVGCOperand* operands, size_m operand_len) {
 
-			size_m dec = muVGC_hop_to_decoration_section(bytecode);
-			size_m var = muVGC_hop_to_variable_section(bytecode);
+		if (module->instruction_len >= module->allocated_instruction_len) {
+			module->allocated_instruction_len = (module->allocated_instruction_len == 0) ? 32 : module->allocated_instruction_len*2;
+			module->instructions = mu_realloc(module->instructions, sizeof(muVGCInstruction) * module->allocated_instruction_len);
+		}
 
-			for (size_m i = dec; i < var;) {
-				int16_m instruction = muVGC_get_halfword(&bytecode.s[i]);
-				int16_m step = muVGC_get_halfword(&bytecode.s[i+2]);
+		muVGC_module_reserve_operands(module, operand_len);
+		for (size_m i = 0; i < operand_len; i++) {
+			module->operands[module->operand_len+i] = operands[i];
+		}
 
-				if (apply_access_qualifier) {
-					if (
-						instruction == 25 && step == 10 && 
-						muVGC_get_word(&bytecode.s[i+8]) == sampled_type && muVGC_get_word(&bytecode.s[i+12]) == dim &&
-						muVGC_get_word(&bytecode.s[i+16]) == depth && muVGC_get_word(&bytecode.s[i+20]) == arrayed &&
-						muVGC_get_word(&bytecode.s[i+24]) == ms && muVGC_get_word(&bytecode.s[i+28]) == sampled &&
-						muVGC_get_word(&bytecode.s[i+32]) == image_format && muVGC_get_word(&bytecode.s[i+36]) == access_qualifier) {
+		size_m index = module->instruction_len;
+		muVGCInstruction* instruction = &module->instructions[index];
+		instruction->active = MU_TRUE;
+		instruction->opcode = opcode;
+		instruction->result_type = result_type;
+		instruction->result_id = result_id;
+		instruction->operand_index = module->operand_len;
+		instruction->operand_len = operand_len;
 
-						*img_type = muVGC_get_word(&bytecode.s[i+4]);
-						return bytecode;
-					}
-				} else {
-					if (
-						instruction == 25 && step == 9 && 
-						muVGC_get_word(&bytecode.s[i+8]) == sampled_type && muVGC_get_word(&bytecode.s[i+12]) == dim &&
-						muVGC_get_word(&bytecode.s[i+16]) == depth && muVGC_get_word(&bytecode.s[i+20]) == arrayed &&
-						muVGC_get_word(&bytecode.s[i+24]) == ms && muVGC_get_word(&bytecode.s[i+28]) == sampled &&
-						muVGC_get_word(&bytecode.s[i+32]) == image_format) {
+		module->operand_len += operand_len;
+		module->instruction_len += 1;
 
-						*img_type = muVGC_get_word(&bytecode.s[i+4]);
-						return bytecode;
-					}
-				}
+		if (result_id != 0) {
+			muVGC_module_set_definition(module, result_id, index+1);
+		}
+		return index;
+	}
 
-				i += step * 4;
+	// Appends an operand to an instruction, moving its operands to the end
+	// of the arena first if they aren't there already
+	void muVGC_module_add_operand(muVGCModule* module, size_m instruction, muVGCOperand operand) {
+		muVGCInstruction* inst = &module->instructions[instruction];
+		if (inst->operand_index + inst->operand_len != module->operand_len) {
+			muVGC_module_reserve_operands(module, inst->operand_len + 1);
+			for (size_m i = 0; i < inst->operand_len; i++) {
+				module->operands[module->operand_len+i] = module->operands[inst->operand_index+i];
 			}
+			inst->operand_index = module->operand_len;
+			module->operand_len += inst->operand_len;
+		}
+		muVGC_module_reserve_operands(module, 1);
+		module->operands[module->operand_len] = operand;
+		module->operand_len += 1;
+		inst->operand_len += 1;
+	}
 
-			char b[] = {
-				25, 0, 10, 0,
-				MUVGC_4_BYTE_LE(*global_id),
-				MUVGC_4_BYTE_LE(sampled_type),
-				MUVGC_4_BYTE_LE(dim),
-				MUVGC_4_BYTE_LE(depth),
-				MUVGC_4_BYTE_LE(arrayed),
-				MUVGC_4_BYTE_LE(ms),
-				MUVGC_4_BYTE_LE(sampled),
-				MUVGC_4_BYTE_LE(image_format),
-				MUVGC_4_BYTE_LE(access_qualifier)
-			};
-			*img_type = *global_id;
-			*global_id += 1;
-			if (apply_access_qualifier != MU_TRUE) {
-				b[2] = 9;
-				return mu_string_insert_raw(bytecode, b, sizeof(b)-4, var);
+	// Appends a nul-terminated, nul-padded literal string
+	void muVGC_module_add_string_operand(muVGCModule* module, size_m instruction, const char* s, size_m len) {
+		for (size_m i = 0; i <= len; i += 4) {
+			muVGCOperand operand = MUVGC_LITERAL(0);
+			for (size_m j = 0; j < 4 && i+j < len; j++) {
+				operand.word |= ((uint32_m)(unsigned char)s[i+j]) << (j*8);
 			}
-			return mu_string_insert_raw(bytecode, b, sizeof(b), var);
+			muVGC_module_add_operand(module, instruction, operand);
 		}
+	}
 
-		muString muVGC_get_function_type(
-			muString bytecode, uint32_m* type, uint32_m* global_id,
-			uint32_m return_type, uint32_m* parameter_types, size_m parameter_len) {
+	// Whether the string operand starting at operand 'first' of an instruction is s
+	muBool muVGC_module_string_operand_equals(muVGCModule* module, size_m instruction, size_m first, const char* s, size_m len) {
+		muVGCInstruction* inst = &module->instructions[instruction];
+		if (inst->operand_len < first + len/4 + 1) {
+			return MU_FALSE;
+		}
+		muVGCOperand* operands = &module->operands[inst->operand_index+first];
+		for (size_m i = 0; i <= len; i++) {
+			uint32_m c = (i < len) ? (uint32_m)(unsigned char)s[i] : 0;
+			if (((operands[i/4].word >> ((i%4)*8)) & 0xFF) != c) {
+				return MU_FALSE;
+			}
+		}
+		return MU_TRUE;
+	}
 
-			size_m dec = muVGC_hop_to_decoration_section(bytecode);
-			size_m var = muVGC_hop_to_variable_section(bytecode);
+	void muVGC_module_remove_instruction(muVGCModule* module, size_m instruction) {
+		muVGCInstruction* inst = &module->instructions[instruction];
+		if (inst->result_id != 0 && muVGC_module_get_definition(module, inst->result_id) == inst) {
+			module->definitions[inst->result_id] = 0;
+		}
+		inst->active = MU_FALSE;
+	}
 
-			for (size_m i = dec; i < var;) {
-				int16_m instruction = muVGC_get_halfword(&bytecode.s[i]);
-				int16_m step = muVGC_get_halfword(&bytecode.s[i+2]);
+	size_m muVGC_module_emit(
+		muVGCModule* module, muVGCSection section, uint16_m opcode, uint32_m result_type, uint32_m result_id,
+		const muVGCOperand* operands, size_m operand_len) {
 
-				if (instruction == 33 && step == 3 + parameter_len && muVGC_get_word(&bytecode.s[i+8]) == return_type) {
-					muBool good = MU_TRUE;
-					for (size_m j = 0; j < parameter_len; j++) {
-						// Is 12 correct here? @TODO Check later
-						if (muVGC_get_word(&bytecode.s[i+12+(j*4)]) != parameter_types[j]) {
-							good = MU_FALSE;
-							break;
-						}
-					}
-					if (good == MU_TRUE) {
-						*type = muVGC_get_word(&bytecode.s[i+4]);
-						return bytecode;
-					}
-				}
+		size_m index = muVGC_module_add_instruction(module, opcode, result_type, result_id, operands, operand_len);
+		muVGC_index_list_add(&module->sections[section], index);
+		return index;
+	}
 
-				i += step * 4;
-			}
+	// Shared globals
+
+	// Types & constants declared through muVGC_module_get_global are shared
+	// between everything that asks for the same one, and are found through
+	// a hash table keyed on their opcode, result type & operands. Globals
+	// that can't be shared (such as structs and arrays laid out for blocks,
+	// which get decorated) are emitted directly and never enter the table.
+
+	uint32_m muVGC_hash_global(uint16_m opcode, uint32_m result_type, const muVGCOperand* operands, size_m operand_len) {
+		// (FNV-1a over the words)
+		uint32_m hash = 2166136261u;
+		hash = (hash ^ opcode) * 16777619u;
+		hash = (hash ^ result_type) * 16777619u;
+		for (size_m i = 0; i < operand_len; i++) {
+			hash = (hash ^ operands[i].word) * 16777619u;
+		}
+		return hash;
+	}
 
-			char* b = mu_malloc(12 + (parameter_len*4));
+	muBool muVGC_global_equals(
+		muVGCModule* module, muVGCInstruction* inst, uint16_m opcode, uint32_m result_type, const muVGCOperand* operands, size_m operand_len) {
 
-			b[0] = 33; b[1] = 0; MUVGC_2_BYTE_LE_SET(b, 3+parameter_len, 2)
-			MUVGC_4_BYTE_LE_SET(b, *global_id, 4)
-			MUVGC_4_BYTE_LE_SET(b, return_type, 8)
-			for (size_m i = 0; i < parameter_len; i++) {
-				MUVGC_4_BYTE_LE_SET(b, parameter_types[i], 12+(i*4))
+		if (inst->active == MU_FALSE || inst->opcode != opcode || inst->result_type != result_type || inst->operand_len != operand_len) {
+			return MU_FALSE;
+		}
+		muVGCOperand* inst_operands = &module->operands[inst->operand_index];
+		for (size_m i = 0; i < operand_len; i++) {
+			if (inst_operands[i].word != operands[i].word) {
+				return MU_FALSE;
 			}
+		}
+		return MU_TRUE;
+	}
 
-			bytecode = mu_string_insert_raw(bytecode, b, 12 + (parameter_len*4), var);
-			mu_free(b);
-			*type = *global_id;
-			*global_id += 1;
-			return bytecode;
+	void muVGC_module_insert_global(muVGCModule* module, size_m instruction) {
+		muVGCInstruction* inst = &module->instructions[instruction];
+		size_m mask = module->global_table_capacity-1;
+		size_m slot = muVGC_hash_global(inst->opcode, inst->result_type, &module->operands[inst->operand_index], inst->operand_len) & mask;
+		while (module->global_table[slot] != 0) {
+			slot = (slot+1) & mask;
 		}
+		module->global_table[slot] = instruction+1;
+		module->global_table_len += 1;
+	}
 
-	// 3.49.9 Function Instructions
+	// Rebuilds the table (at 'capacity'), for after it fills up or after the
+	// ids in its instructions have changed; removed instructions are dropped
+	void muVGC_module_rehash_globals(muVGCModule* module, size_m capacity) {
+		size_m* old_table = module->global_table;
+		size_m old_capacity = module->global_table_capacity;
+		module->global_table = mu_malloc(sizeof(size_m) * capacity);
+		module->global_table_capacity = capacity;
+		module->global_table_len = 0;
+		for (size_m i = 0; i < capacity; i++) {
+			module->global_table[i] = 0;
+		}
+		for (size_m i = 0; i < old_capacity; i++) {
+			if (old_table[i] != 0 && module->instructions[old_table[i]-1].active == MU_TRUE) {
+				muVGC_module_insert_global(module, old_table[i]-1);
+			}
+		}
+		if (old_table != MU_NULL_PTR) {
+			mu_free(old_table);
+		}
+	}
 
-		muString muVGC_op_function(
-			muString bytecode, uint32_m return_type, uint32_m function_control, uint32_m function_type, uint32_m* global_id) {
+	// Returns the id of a shared global identical to the given instruction
+	// (ignoring its result id), or 0 if there is none
+	uint32_m muVGC_module_find_global(
+		muVGCModule* module, uint16_m opcode, uint32_m result_type, const muVGCOperand* operands, size_m operand_len) {
 
-			char b[] = {
-				54, 0, 5, 0,
-				MUVGC_4_BYTE_LE(return_type),
-				MUVGC_4_BYTE_LE(*global_id),
-				MUVGC_4_BYTE_LE(function_control),
-				MUVGC_4_BYTE_LE(function_type)
-			};
-			bytecode = mu_string_insert_raw(bytecode, b, sizeof(b), muVGC_hop_to_function_section(bytecode));
+		if (module->global_table_capacity == 0) {
+			return 0;
+		}
+		size_m mask = module->global_table_capacity-1;
+		size_m slot = muVGC_hash_global(opcode, result_type, operands, operand_len) & mask;
+		while (module->global_table[slot] != 0) {
+			muVGCInstruction* inst = &module->instructions[module->global_table[slot]-1];
+			if (muVGC_global_equals(module, inst, opcode, result_type, operands, operand_len) == MU_TRUE) {
+				return inst->result_id;
+			}
+			slot = (slot+1) & mask;
+		}
+		return 0;
+	}
+
+	// Finds or declares a type/constant in the global section
+	uint32_m muVGC_module_get_global(
+		muVGCModule* module, uint16_m opcode, uint32_m result_type, const muVGCOperand* operands, size_m operand_len) {
 
-			*global_id += 1;
-			return bytecode;
+		uint32_m id = muVGC_module_find_global(module, opcode, result_type, operands, operand_len);
+		if (id != 0) {
+			return id;
 		}
+		id = muVGC_module_new_id(module);
+		size_m instruction = muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, opcode, result_type, id, operands, operand_len);
 
-		muString muVGC_op_function_end(muString bytecode) {
-			char b[] = {
-				56, 0, 1, 0
-			};
-			return mu_string_insert_raw(bytecode, b, sizeof(b), muVGC_hop_to_function_section(bytecode));
+		// (Kept at most half full)
+		if ((module->global_table_len+1)*2 > module->global_table_capacity) {
+			muVGC_module_rehash_globals(module, (module->global_table_capacity == 0) ? 64 : module->global_table_capacity*2);
 		}
+		muVGC_module_insert_global(module, instruction);
+		return id;
+	}
 
-	// 3.49.17 Control-Flow Instructions
+	// Functions & blocks
 
-		muString muVGC_op_label(muString bytecode, uint32_m result_id) {
-			// Thanks GCC (-Woverflow)
-			int n = 248;
-			char b[] = {
-				MUVGC_2_BYTE_LE(n), 2, 0,
-				MUVGC_4_BYTE_LE(result_id)
-			};
-			return mu_string_insert_raw(bytecode, b, sizeof(b), muVGC_hop_to_function_section(bytecode));
+	size_m muVGC_module_add_function(muVGCModule* module, size_m instruction) {
+		if (module->function_len >= module->allocated_function_len) {
+			module->allocated_function_len = (module->allocated_function_len == 0) ? 4 : module->allocated_function_len*2;
+			module->functions = mu_realloc(module->functions, sizeof(muVGCFunction) * module->allocated_function_len);
 		}
+		muVGCFunction function = { 0 };
+		function.active = MU_TRUE;
+		function.instruction = instruction;
+		module->functions[module->function_len] = function;
+		module->function_len += 1;
+		return module->function_len-1;
+	}
 
-		muString muVGC_op_return(muString bytecode) {
-			int n = 253;
-			char b[] = {
-				MUVGC_2_BYTE_LE(n), 1, 0
-			};
-			return mu_string_insert_raw(bytecode, b, sizeof(b), muVGC_hop_to_function_section(bytecode));
+	// Creates a block and places it at 'position' within the function's
+	// block list
+	size_m muVGC_module_insert_block(muVGCModule* module, size_m function, size_m position, uint32_m label_id) {
+		if (module->block_len >= module->allocated_block_len) {
+			module->allocated_block_len = (module->allocated_block_len == 0) ? 8 : module->allocated_block_len*2;
+			module->blocks = mu_realloc(module->blocks, sizeof(muVGCBlock) * module->allocated_block_len);
 		}
+		muVGCBlock block = { 0 };
+		block.label = muVGC_module_add_instruction(module, MUVGC_OP_LABEL, 0, label_id, MU_NULL_PTR, 0);
+		module->blocks[module->block_len] = block;
+		module->block_len += 1;
+		muVGC_index_list_insert(&module->functions[function].blocks, module->block_len-1, position);
+		return module->block_len-1;
+	}
 
-	// Get stuff
+	size_m muVGC_module_add_block(muVGCModule* module, size_m function, uint32_m label_id) {
+		return muVGC_module_insert_block(module, function, module->functions[function].blocks.len, label_id);
+	}
 
-		uint32_m muVGC_get_format(char* format, size_m formatlen) {
-			switch (formatlen) {
-				default: break;
+	size_m muVGC_module_emit_to_block(
+		muVGCModule* module, size_m block, uint16_m opcode, uint32_m result_type, uint32_m result_id,
+		const muVGCOperand* operands, size_m operand_len) {
 
-				case 2: {
-					if (mu_strncmp(format, "r8", 2) == 0) {
-						return 15;
-					}
-				} break;
+		size_m index = muVGC_module_add_instruction(module, opcode, result_type, result_id, operands, operand_len);
+		muVGC_index_list_add(&module->blocks[block].instructions, index);
+		return index;
+	}
 
-				case 3: {
-					if (mu_strncmp(format, "rg8", 3) == 0) {
-						return 13;
-					} else if (mu_strncmp(format, "r16", 3) == 0) {
-						return 14;
-					} else if (mu_strncmp(format, "r8i", 3) == 0) {
-						return 29;
-					}
-				} break;
+	// Use-def
 
-				case 4: {
-					if (mu_strncmp(format, "r32f", 4) == 0) {
-						return 3;
-					} else if (mu_strncmp(format, "r16f", 4) == 0) {
-						return 9;
-					} else if (mu_strncmp(format, "rg16", 4) == 0) {
-						return 12;
-					} else if (mu_strncmp(format, "rg8i", 4) == 0) {
-						return 27;
-					} else if (mu_strncmp(format, "r32i", 4) == 0) {
-						return 24;
-					} else if (mu_strncmp(format, "r16i", 4) == 0) {
-						return 28;
-					} else if (mu_strncmp(format, "r8ui", 4) == 0) {
-						return 39;
-					}
-				} break;
+	void muVGC_module_compute_uses(muVGCModule* module, muVGCUses* uses) {
+		uses->first = mu_malloc(sizeof(size_m) * (module->bound+1));
+		for (size_m i = 0; i <= module->bound; i++) {
+			uses->first[i] = 0;
+		}
 
-				case 5: {
-					if (mu_strncmp(format, "rg32f", 5) == 0) {
-						return 6;
-					} else if (mu_strncmp(format, "rg16f", 5) == 0) {
-						return 7;
-					} else if (mu_strncmp(format, "rgba8", 5) == 0) {
-						return 4;
-					} else if (mu_strncmp(format, "rg32i", 5) == 0) {
-						return 25;
-					} else if (mu_strncmp(format, "rg16i", 5) == 0) {
-						return 26;
-					} else if (mu_strncmp(format, "rg8ui", 5) == 0) {
-						return 37;
-					} else if (mu_strncmp(format, "r32ui", 5) == 0) {
-						return 33;
-					} else if (mu_strncmp(format, "r16ui", 5) == 0) {
-						return 38;
-					}
-				} break;
+		// (Count, then turn counts into offsets, then fill)
+		size_m total = 0;
+		for (size_m i = 0; i < module->instruction_len; i++) {
+			muVGCInstruction* inst = &module->instructions[i];
+			if (inst->active == MU_FALSE) continue;
+			if (inst->result_type != 0 && inst->result_type < module->bound) {
+				uses->first[inst->result_type] += 1;
+				total++;
+			}
+			muVGCOperand* operands = &module->operands[inst->operand_index];
+			for (size_m j = 0; j < inst->operand_len; j++) {
+				if (operands[j].is_id == MU_TRUE && operands[j].word < module->bound) {
+					uses->first[operands[j].word] += 1;
+					total++;
+				}
+			}
+		}
+		size_m offset = 0;
+		for (size_m i = 0; i <= module->bound; i++) {
+			size_m count = uses->first[i];
+			uses->first[i] = offset;
+			offset += count;
+		}
 
-				case 6: {
-					if (mu_strncmp(format, "rgba16", 6) == 0) {
-						return 10;
-					} else if (mu_strncmp(format, "rgba8i", 6) == 0) {
-						return 23;
-					} else if (mu_strncmp(format, "rg32ui", 6) == 0) {
-						return 35;
-					} else if (mu_strncmp(format, "rg16ui", 6) == 0) {
-						return 36;
-					}
-				} break;
+		uses->instructions = mu_malloc(sizeof(size_m) * (total+1));
+		size_m* fill = mu_malloc(sizeof(size_m) * (module->bound+1));
+		for (size_m i = 0; i <= module->bound; i++) {
+			fill[i] = uses->first[i];
+		}
+		for (size_m i = 0; i < module->instruction_len; i++) {
+			muVGCInstruction* inst = &module->instructions[i];
+			if (inst->active == MU_FALSE) continue;
+			if (inst->result_type != 0 && inst->result_type < module->bound) {
+				uses->instructions[fill[inst->result_type]++] = i;
+			}
+			muVGCOperand* operands = &module->operands[inst->operand_index];
+			for (size_m j = 0; j < inst->operand_len; j++) {
+				if (operands[j].is_id == MU_TRUE && operands[j].word < module->bound) {
+					uses->instructions[fill[operands[j].word]++] = i;
+				}
+			}
+		}
+		mu_free(fill);
+	}
 
-				case 7: {
-					if (mu_strncmp(format, "rgba32f", 7) == 0) {
-						return 1;
-					} else if (mu_strncmp(format, "rgba16f", 7) == 0) {
-						return 2;
-					} else if (mu_strncmp(format, "rgba32i", 7) == 0) {
-						return 21;
-					} else if (mu_strncmp(format, "rgba16i", 7) == 0) {
-						return 22;
-					} else if (mu_strncmp(format, "rgba8ui", 7) == 0) {
-						return 32;
-					}
-				} break;
+	size_m muVGC_uses_count(muVGCUses* uses, uint32_m id) {
+		return uses->first[id+1] - uses->first[id];
+	}
 
-				case 8: {
-					if (mu_strncmp(format, "rgb10_a2", 8) == 0) {
-						return 11;
-					} else if (mu_strncmp(format, "r8_snorm", 8) == 0) {
-						return 20;
-					} else if (mu_strncmp(format, "rgba32ui", 8) == 0) {
-						return 30;
-					} else if (mu_strncmp(format, "rgba16ui", 8) == 0) {
-						return 31;
-					}
-				} break;
+	void muVGC_free_uses(muVGCUses* uses) {
+		if (uses->first != MU_NULL_PTR) mu_free(uses->first);
+		if (uses->instructions != MU_NULL_PTR) mu_free(uses->instructions);
+		uses->first = MU_NULL_PTR;
+		uses->instructions = MU_NULL_PTR;
+	}
 
-				case 9: {
-					if (mu_strncmp(format, "rg8_snorm", 9) == 0) {
-						return 18;
-					} else if (mu_strncmp(format, "r16_snorm", 9) == 0) {
-						return 19;
-					}
-				} break;
+	// Replacing uses
 
-				case 10: {
-					if (mu_strncmp(format, "rg16_snorm", 10) == 0) {
-						return 17;
-					} else if (mu_strncmp(format, "rgb10_a2ui", 10) == 0) {
-						return 34;
-					}
-				} break;
+	// Passes note down the ids they replace with muVGC_module_replace_uses,
+	// and then apply all of them in a single sweep over the module with
+	// muVGC_module_apply_replacements (rather than sweeping it once per
+	// replaced id); until then, the old ids are still what's used.
+
+	void muVGC_module_replace_uses(muVGCModule* module, uint32_m old_id, uint32_m new_id) {
+		if (old_id >= module->allocated_replacement_len) {
+			size_m old_len = module->allocated_replacement_len;
+			module->allocated_replacement_len = module->bound;
+			module->replacements = mu_realloc(module->replacements, sizeof(uint32_m) * module->allocated_replacement_len);
+			for (size_m i = old_len; i < module->allocated_replacement_len; i++) {
+				module->replacements[i] = 0;
+			}
+		}
+		module->replacements[old_id] = new_id;
+		module->replacement_len += 1;
+	}
+
+	// (Following replacements of replacements)
+	uint32_m muVGC_module_get_replacement(muVGCModule* module, uint32_m id) {
+		while (id < module->allocated_replacement_len && module->replacements[id] != 0) {
+			id = module->replacements[id];
+		}
+		return id;
+	}
+
+	void muVGC_module_apply_replacements(muVGCModule* module) {
+		if (module->replacement_len == 0) {
+			return;
+		}
+		for (size_m i = 0; i < module->instruction_len; i++) {
+			muVGCInstruction* inst = &module->instructions[i];
+			if (inst->active == MU_FALSE) continue;
+			inst->result_type = muVGC_module_get_replacement(module, inst->result_type);
+			muVGCOperand* operands = &module->operands[inst->operand_index];
+			for (size_m j = 0; j < inst->operand_len; j++) {
+				if (operands[j].is_id == MU_TRUE) {
+					operands[j].word = muVGC_module_get_replacement(module, operands[j].word);
+				}
+			}
+		}
+		for (size_m i = 0; i < module->allocated_replacement_len; i++) {
+			module->replacements[i] = 0;
+		}
+		module->replacement_len = 0;
+
+		// (Shared globals may have changed)
+		if (module->global_table_capacity != 0) {
+			muVGC_module_rehash_globals(module, module->global_table_capacity);
+		}
+	}
+
+	// Reflection
+
+	// What pipeline creation needs to know about a shader is noted down as
+	// its variables get declared, so that it doesn't have to be parsed back
+	// out of the SPIR-V. Variables are kept by id, and id compaction
+	// renumbers them, so once the module has been optimized, whatever was
+	// optimized away (or pruned) is simply left out.
+
+	void muVGC_reflect_variable(muVGCModule* module, muVGCReflectedVariable variable) {
+		if (module->reflected_variable_len >= module->allocated_reflected_variable_len) {
+			module->allocated_reflected_variable_len = (module->allocated_reflected_variable_len == 0) ? 8 : module->allocated_reflected_variable_len*2;
+			module->reflected_variables = mu_realloc(module->reflected_variables, sizeof(muVGCReflectedVariable) * module->allocated_reflected_variable_len);
+		}
+		module->reflected_variables[module->reflected_variable_len] = variable;
+		module->reflected_variable_len += 1;
+	}
+
+	// Is a reflected variable still declared in the module, in the same
+	// storage class?
+	muBool muVGC_is_reflected_variable_live(muVGCModule* module, muVGCReflectedVariable* variable) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, variable->id);
+		return (inst != MU_NULL_PTR && inst->opcode == MUVGC_OP_VARIABLE &&
+			module->operands[inst->operand_index].word == variable->storage_class) ? MU_TRUE : MU_FALSE;
+	}
+
+	muBool muVGC_location_comes_before(muVGCInterfaceLocation* a, muVGCInterfaceLocation* b) {
+		return (a->location < b->location || (a->location == b->location && a->component < b->component)) ? MU_TRUE : MU_FALSE;
+	}
+
+	muBool muVGC_binding_comes_before(muVGCDescriptorBinding* a, muVGCDescriptorBinding* b) {
+		return (a->set < b->set || (a->set == b->set && a->binding < b->binding)) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Fills in the reflection of an optimized module
+	void muVGC_get_reflection(muVGCModule* module, muVGCReflection* reflection) {
+		muVGCReflection empty = { 0 };
+		*reflection = empty;
+		reflection->shader = module->shader;
+		for (size_m d = 0; d < 3; d++) {
+			reflection->workgroup_size[d] = module->local_size[d];
+			reflection->workgroup_size_spec_ids[d] = module->local_size_spec_ids[d];
+		}
 
-				case 11: {
-					if (mu_strncmp(format, "rgba8_snorm", 11) == 0) {
-						return 5;
+		size_m binding_len = 0, input_len = 0, output_len = 0;
+		for (size_m i = 0; i < module->reflected_variable_len; i++) {
+			muVGCReflectedVariable* variable = &module->reflected_variables[i];
+			if (muVGC_is_reflected_variable_live(module, variable) == MU_FALSE) continue;
+			switch (variable->storage_class) {
+				default: break;
+				case MUVGC_STORAGE_CLASS_UNIFORM: case MUVGC_STORAGE_CLASS_STORAGE_BUFFER: binding_len++; break;
+				case MUVGC_STORAGE_CLASS_INPUT: input_len++; break;
+				case MUVGC_STORAGE_CLASS_OUTPUT: output_len++; break;
+			}
+		}
+		if (binding_len != 0) reflection->bindings = mu_malloc(sizeof(muVGCDescriptorBinding) * binding_len);
+		if (input_len != 0) reflection->inputs = mu_malloc(sizeof(muVGCInterfaceLocation) * input_len);
+		if (output_len != 0) reflection->outputs = mu_malloc(sizeof(muVGCInterfaceLocation) * output_len);
+
+		// (Each one is sorted into place as it's added, since there's never
+		// many of them)
+		for (size_m i = 0; i < module->reflected_variable_len; i++) {
+			muVGCReflectedVariable* variable = &module->reflected_variables[i];
+			if (muVGC_is_reflected_variable_live(module, variable) == MU_FALSE) continue;
+			switch (variable->storage_class) {
+				default: break;
+
+				case MUVGC_STORAGE_CLASS_UNIFORM: case MUVGC_STORAGE_CLASS_STORAGE_BUFFER: {
+					muVGCDescriptorBinding binding;
+					binding.set = variable->set;
+					binding.binding = variable->binding;
+					binding.type = (variable->storage_class == MUVGC_STORAGE_CLASS_UNIFORM) ? MUVGC_DESCRIPTOR_TYPE_UNIFORM_BUFFER : MUVGC_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+					binding.count = 1;
+					binding.size = variable->size;
+					size_m j = reflection->binding_len;
+					for (; j > 0 && muVGC_binding_comes_before(&binding, &reflection->bindings[j-1]) == MU_TRUE; j--) {
+						reflection->bindings[j] = reflection->bindings[j-1];
 					}
+					reflection->bindings[j] = binding;
+					reflection->binding_len += 1;
 				} break;
 
-				case 12: {
-					if (mu_strncmp(format, "rgba16_snorm", 12) == 0) {
-						return 16;
-					}
+				case MUVGC_STORAGE_CLASS_PUSH_CONSTANT: {
+					uint32_m offset = (variable->offset / 4) * 4;
+					reflection->push_constants.offset = offset;
+					reflection->push_constants.size = ((variable->size + 3) / 4) * 4 - offset;
 				} break;
 
-				case 14: {
-					if (mu_strncmp(format, "r11f_g11f_b10f", 14) == 0) {
-						return 8;
+				case MUVGC_STORAGE_CLASS_INPUT: case MUVGC_STORAGE_CLASS_OUTPUT: {
+					muBool is_input = (variable->storage_class == MUVGC_STORAGE_CLASS_INPUT) ? MU_TRUE : MU_FALSE;
+					muVGCInterfaceLocation* locations = (is_input == MU_TRUE) ? reflection->inputs : reflection->outputs;
+					size_m* len = (is_input == MU_TRUE) ? &reflection->input_len : &reflection->output_len;
+					size_m j = *len;
+					for (; j > 0 && muVGC_location_comes_before(&variable->location, &locations[j-1]) == MU_TRUE; j--) {
+						locations[j] = locations[j-1];
 					}
+					locations[j] = variable->location;
+					*len += 1;
 				} break;
 			}
+		}
+	}
 
-			return 0;
+	void muVGC_free_reflection(muVGCReflection* reflection) {
+		if (reflection->bindings != MU_NULL_PTR) mu_free(reflection->bindings);
+		if (reflection->inputs != MU_NULL_PTR) mu_free(reflection->inputs);
+		if (reflection->outputs != MU_NULL_PTR) mu_free(reflection->outputs);
+		muVGCReflection empty = { 0 };
+		*reflection = empty;
+	}
+
+	// Serialization
+
+	size_m muVGC_instruction_word_count(muVGCInstruction* inst) {
+		return 1 + (inst->result_type != 0) + (inst->result_id != 0) + inst->operand_len;
+	}
+
+	size_m muVGC_module_write_instruction(muVGCModule* module, char* b, size_m i, muVGCInstruction* inst) {
+		uint32_m first_word = (((uint32_m)muVGC_instruction_word_count(inst)) << 16) | inst->opcode;
+		MUVGC_4_BYTE_LE_SET(b, first_word, i) i += 4;
+		if (inst->result_type != 0) {
+			MUVGC_4_BYTE_LE_SET(b, inst->result_type, i) i += 4;
+		}
+		if (inst->result_id != 0) {
+			MUVGC_4_BYTE_LE_SET(b, inst->result_id, i) i += 4;
+		}
+		muVGCOperand* operands = &module->operands[inst->operand_index];
+		for (size_m j = 0; j < inst->operand_len; j++) {
+			MUVGC_4_BYTE_LE_SET(b, operands[j].word, i) i += 4;
 		}
+		return i;
+	}
 
-/* VARIABLE HANDLING */
+	size_m muVGC_module_word_count(muVGCModule* module) {
+		// (Header)
+		size_m words = 5;
+		for (size_m s = MUVGC_SECTION_FIRST; s < MUVGC_SECTION_FUNCTION; s++) {
+			for (size_m i = 0; i < module->sections[s].len; i++) {
+				muVGCInstruction* inst = &module->instructions[module->sections[s].indexes[i]];
+				if (inst->active == MU_TRUE) {
+					words += muVGC_instruction_word_count(inst);
+				}
+			}
+		}
+		for (size_m f = 0; f < module->function_len; f++) {
+			muVGCFunction* function = &module->functions[f];
+			if (function->active == MU_FALSE) continue;
+			// (OpFunction & OpFunctionEnd)
+			words += muVGC_instruction_word_count(&module->instructions[function->instruction]) + 1;
+			for (size_m p = 0; p < function->parameters.len; p++) {
+				words += muVGC_instruction_word_count(&module->instructions[function->parameters.indexes[p]]);
+			}
+			for (size_m b = 0; b < function->blocks.len; b++) {
+				muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+				words += 2;
+				for (size_m i = 0; i < block->instructions.len; i++) {
+					muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+					if (inst->active == MU_TRUE) {
+						words += muVGC_instruction_word_count(inst);
+					}
+				}
+			}
+		}
+		return words;
+	}
 
-	// Enums
-
-		enum muVGCBasicType {
-			#define MUVGC_BASIC_TYPE_FIRST MUVGC_TYPE_VOID
-			// Transparent types
-			#define MUVGC_TRANSPARENT_TYPE_FIRST MUVGC_TYPE_VOID
-			MUVGC_TYPE_VOID,
-			MUVGC_TYPE_BOOL,
-			MUVGC_TYPE_INT,
-			MUVGC_TYPE_UINT,
-			MUVGC_TYPE_FLOAT,
-			MUVGC_TYPE_DOUBLE,
-			MUVGC_TYPE_VEC2,
-			MUVGC_TYPE_VEC3,
-			MUVGC_TYPE_VEC4,
-			MUVGC_TYPE_DVEC2,
-			MUVGC_TYPE_DVEC3,
-			MUVGC_TYPE_DVEC4,
-			MUVGC_TYPE_BVEC2,
-			MUVGC_TYPE_BVEC3,
-			MUVGC_TYPE_BVEC4,
-			MUVGC_TYPE_IVEC2,
-			MUVGC_TYPE_IVEC3,
-			MUVGC_TYPE_IVEC4,
-			MUVGC_TYPE_UVEC2,
-			MUVGC_TYPE_UVEC3,
-			MUVGC_TYPE_UVEC4,
-			MUVGC_TYPE_MAT2,
-			MUVGC_TYPE_MAT3,
-			MUVGC_TYPE_MAT4,
-			MUVGC_TYPE_MAT2X2,
-			MUVGC_TYPE_MAT2X3,
-			MUVGC_TYPE_MAT2X4,
-			MUVGC_TYPE_MAT3X2,
-			MUVGC_TYPE_MAT3X3,
-			MUVGC_TYPE_MAT3X4,
-			MUVGC_TYPE_MAT4X2,
-			MUVGC_TYPE_MAT4X3,
-			MUVGC_TYPE_MAT4X4,
-			MUVGC_TYPE_DMAT2,
-			MUVGC_TYPE_DMAT3,
-			MUVGC_TYPE_DMAT4,
-			MUVGC_TYPE_DMAT2X2,
-			MUVGC_TYPE_DMAT2X3,
-			MUVGC_TYPE_DMAT2X4,
-			MUVGC_TYPE_DMAT3X2,
-			MUVGC_TYPE_DMAT3X3,
-			MUVGC_TYPE_DMAT3X4,
-			MUVGC_TYPE_DMAT4X2,
-			MUVGC_TYPE_DMAT4X3,
-			MUVGC_TYPE_DMAT4X4,
-			#define MUVGC_TRANSPARENT_TYPE_LAST MUVGC_TYPE_DMAT4X4
-			// Floating-Point Opaque Types
-			#define MUVGC_FLOATING_POINT_OPAQUE_TYPE_FIRST MUVGC_TYPE_SAMPLER1D
-			MUVGC_TYPE_SAMPLER1D,
-			MUVGC_TYPE_IMAGE1D,
-			MUVGC_TYPE_SAMPLER2D,
-			MUVGC_TYPE_IMAGE2D,
-			MUVGC_TYPE_SAMPLER3D,
-			MUVGC_TYPE_IMAGE3D,
-			MUVGC_TYPE_SAMPLERCUBE,
-			MUVGC_TYPE_IMAGECUBE,
-			MUVGC_TYPE_SAMPLER2DRECT,
-			MUVGC_TYPE_IMAGE2DRECT,
-			MUVGC_TYPE_SAMPLER1DARRAY,
-			MUVGC_TYPE_IMAGE1DARRAY,
-			MUVGC_TYPE_SAMPLER2DARRAY,
-			MUVGC_TYPE_IMAGE2DARRAY,
-			MUVGC_TYPE_SAMPLERBUFFER,
-			MUVGC_TYPE_IMAGEBUFFER,
-			MUVGC_TYPE_SAMPLER2DMS,
-			MUVGC_TYPE_IMAGE2DMS,
-			MUVGC_TYPE_SAMPLER2DMSARRAY,
-			MUVGC_TYPE_IMAGE2DMSARRAY,
-			MUVGC_TYPE_SAMPLERCUBEARRAY,
-			MUVGC_TYPE_IMAGECUBEARRAY,
-			MUVGC_TYPE_SAMPLER1DSHADOW,
-			MUVGC_TYPE_SAMPLER2DSHADOW,
-			MUVGC_TYPE_SAMPLER2DRECTSHADOW,
-			MUVGC_TYPE_SAMPLER1DARRAYSHADOW,
-			MUVGC_TYPE_SAMPLER2DARRAYSHADOW,
-			MUVGC_TYPE_SAMPLERCUBESHADOW,
-			MUVGC_TYPE_SAMPLERCUBEARRAYSHADOW,
-			#define MUVGC_FLOATING_POINT_OPAQUE_TYPE_LAST MUVGC_TYPE_SAMPLERCUBEARRAYSHADOW
-			// Signed Integer Opaque Types
-			#define MUVGC_SIGNED_INTEGER_OPAQUE_TYPE_FIRST MUVGC_TYPE_ISAMPLER1D
-			MUVGC_TYPE_ISAMPLER1D,
-			MUVGC_TYPE_IIMAGE1D,
-			MUVGC_TYPE_ISAMPLER2D,
-			MUVGC_TYPE_IIMAGE2D,
-			MUVGC_TYPE_ISAMPLER3D,
-			MUVGC_TYPE_IIMAGE3D,
-			MUVGC_TYPE_ISAMPLERCUBE,
-			MUVGC_TYPE_IIMAGECUBE,
-			MUVGC_TYPE_ISAMPLER2DRECT,
-			MUVGC_TYPE_IIMAGE2DRECT,
-			MUVGC_TYPE_ISAMPLER1DARRAY,
-			MUVGC_TYPE_IIMAGE1DARRAY,
-			MUVGC_TYPE_ISAMPLER2DARRAY,
-			MUVGC_TYPE_IIMAGE2DARRAY,
-			MUVGC_TYPE_ISAMPLERBUFFER,
-			MUVGC_TYPE_IIMAGEBUFFER,
-			MUVGC_TYPE_ISAMPLER2DMS,
-			MUVGC_TYPE_IIMAGE2DMS,
-			MUVGC_TYPE_ISAMPLER2DMSARRAY,
-			MUVGC_TYPE_IIMAGE2DMSARRAY,
-			MUVGC_TYPE_ISAMPLERCUBEARRAY,
-			MUVGC_TYPE_IIMAGECUBEARRAY,
-			#define MUVGC_SIGNED_INTEGER_OPAQUE_TYPE_LAST MUVGC_TYPE_IIMAGECUBEARRAY
-			// Unsigned Integer Opaque Types
-			#define MUVGC_UNSIGNED_INTEGER_OPAQUE_TYPE_FIRST MUVGC_TYPE_USAMPLER1D
-			MUVGC_TYPE_USAMPLER1D,
-			MUVGC_TYPE_UIMAGE1D,
-			MUVGC_TYPE_USAMPLER2D,
-			MUVGC_TYPE_UIMAGE2D,
-			MUVGC_TYPE_USAMPLER3D,
-			MUVGC_TYPE_UIMAGE3D,
-			MUVGC_TYPE_USAMPLERCUBE,
-			MUVGC_TYPE_UIMAGECUBE,
-			MUVGC_TYPE_USAMPLER2DRECT,
-			MUVGC_TYPE_UIMAGE2DRECT,
-			MUVGC_TYPE_USAMPLER1DARRAY,
-			MUVGC_TYPE_UIMAGE1DARRAY,
-			MUVGC_TYPE_USAMPLER2DARRAY,
-			MUVGC_TYPE_UIMAGE2DARRAY,
-			MUVGC_TYPE_USAMPLERBUFFER,
-			MUVGC_TYPE_UIMAGEBUFFER,
-			MUVGC_TYPE_USAMPLER2DMS,
-			MUVGC_TYPE_UIMAGE2DMS,
-			MUVGC_TYPE_USAMPLER2DMSARRAY,
-			MUVGC_TYPE_UIMAGE2DMSARRAY,
-			MUVGC_TYPE_USAMPLERCUBEARRAY,
-			MUVGC_TYPE_UIMAGECUBEARRAY
-			#define MUVGC_UNSIGNED_INTEGER_OPAQUE_TYPE_LAST MUVGC_TYPE_UIMAGECUBEARRAY
-			#define MUVGC_BASIC_TYPE_LAST MUVGC_TYPE_UIMAGECUBEARRAY
-			#define MUVGC_TYPE_UNKNOWN 2345
-		};
-		typedef enum muVGCBasicType muVGCBasicType;
-
-		const char* muVGC_global_basic_type_names[] = {
-			"void",
-			"bool",
-			"int",
-			"uint",
-			"float",
-			"double",
-			"vec2",
-			"vec3",
-			"vec4",
-			"dvec2",
-			"dvec3",
-			"dvec4",
-			"bvec2",
-			"bvec3",
-			"bvec4",
-			"ivec2",
-			"ivec3",
-			"ivec4",
-			"uvec2",
-			"uvec3",
-			"uvec4",
-			"mat2",
-			"mat3",
-			"mat4",
-			"mat2x2",
-			"mat2x3",
-			"mat2x4",
-			"mat3x2",
-			"mat3x3",
-			"mat3x4",
-			"mat4x2",
-			"mat4x3",
-			"mat4x4",
-			"dmat2",
-			"dmat3",
-			"dmat4",
-			"dmat2x2",
-			"dmat2x3",
-			"dmat2x4",
-			"dmat3x2",
-			"dmat3x3",
-			"dmat3x4",
-			"dmat4x2",
-			"dmat4x3",
-			"dmat4x4",
-			"sampler1D",
-			"image1D",
-			"sampler2D",
-			"image2D",
-			"sampler3D",
-			"image3D",
-			"samplerCube",
-			"imageCube",
-			"sampler2DRect",
-			"image2DRect",
-			"sampler1DArray",
-			"image1DArray",
-			"sampler2DArray",
-			"image2DArray",
-			"samplerBuffer",
-			"imageBuffer",
-			"sampler2DMS",
-			"image2DMS",
-			"sampler2DMSArray",
-			"image2DMSArray",
-			"samplerCubeArray",
-			"imageCubeArray",
-			"sampler1DShadow",
-			"sampler2DShadow",
-			"sampler2DRectShadow",
-			"sampler1DArrayShadow",
-			"sampler2DArrayShadow",
-			"samplerCubeShadow",
-			"samplerCubeArrayShadow",
-			"isampler1D",
-			"iimage1D",
-			"isampler2D",
-			"iimage2D",
-			"isampler3D",
-			"iimage3D",
-			"isamplerCube",
-			"iimageCube",
-			"isampler2DRect",
-			"iimage2DRect",
-			"isampler1DArray",
-			"iimage1DArray",
-			"isampler2DArray",
-			"iimage2DArray",
-			"isamplerBuffer",
-			"iimageBuffer",
-			"isampler2DMS",
-			"iimage2DMS",
-			"isampler2DMSArray",
-			"iimage2DMSArray",
-			"isamplerCubeArray",
-			"iimageCubeArray",
-			"usampler1D",
-			"uimage1D",
-			"usampler2D",
-			"uimage2D",
-			"usampler3D",
-			"uimage3D",
-			"usamplerCube",
-			"uimageCube",
-			"usampler2DRect",
-			"uimage2DRect",
-			"usampler1DArray",
-			"uimage1DArray",
-			"usampler2DArray",
-			"uimage2DArray",
-			"usamplerBuffer",
-			"uimageBuffer",
-			"usampler2DMS",
-			"uimage2DMS",
-			"usampler2DMSArray",
-			"uimage2DMSArray",
-			"usamplerCubeArray",
-			"uimageCubeArray"
+	muString muVGC_module_serialize(muVGCModule* module, muString bytecode) {
+		size_m start = mu_string_strlen(bytecode);
+		size_m size = muVGC_module_word_count(module) * 4;
+		bytecode = mu_string_size_check(bytecode, start + size + 1);
+		char* b = bytecode.s;
+		size_m i = start;
+
+		// Header
+		uint32_m header[] = {
+			// Magic number
+			0x07230203,
+			// Version
+			module->version,
+			// Generator number (using glslc's for now)
+			0x000d000b,
+			// Bound
+			module->bound,
+			// Instruction schema
+			0
 		};
+		for (size_m j = 0; j < sizeof(header)/sizeof(header[0]); j++) {
+			MUVGC_4_BYTE_LE_SET(b, header[j], i) i += 4;
+		}
 
-		const char* muVGC_get_basic_type_name(muVGCBasicType type) {
-			return muVGC_global_basic_type_names[type];
+		// Global sections
+		for (size_m s = MUVGC_SECTION_FIRST; s < MUVGC_SECTION_FUNCTION; s++) {
+			for (size_m j = 0; j < module->sections[s].len; j++) {
+				muVGCInstruction* inst = &module->instructions[module->sections[s].indexes[j]];
+				if (inst->active == MU_TRUE) {
+					i = muVGC_module_write_instruction(module, b, i, inst);
+				}
+			}
 		}
 
-		muVGCBasicType muVGC_get_basic_type(const char* name, size_m namelen) {
-			for (size_m i = MUVGC_BASIC_TYPE_FIRST; i < MUVGC_BASIC_TYPE_LAST; i++) {
-				if (mu_strlen(muVGC_get_basic_type_name(i)) == namelen) {
-					if (mu_strncmp(name, muVGC_get_basic_type_name(i), namelen) == 0) {
-						return i;
+		// Functions
+		for (size_m f = 0; f < module->function_len; f++) {
+			muVGCFunction* function = &module->functions[f];
+			if (function->active == MU_FALSE) continue;
+			i = muVGC_module_write_instruction(module, b, i, &module->instructions[function->instruction]);
+			for (size_m p = 0; p < function->parameters.len; p++) {
+				i = muVGC_module_write_instruction(module, b, i, &module->instructions[function->parameters.indexes[p]]);
+			}
+			for (size_m bl = 0; bl < function->blocks.len; bl++) {
+				muVGCBlock* block = &module->blocks[function->blocks.indexes[bl]];
+				i = muVGC_module_write_instruction(module, b, i, &module->instructions[block->label]);
+				for (size_m j = 0; j < block->instructions.len; j++) {
+					muVGCInstruction* inst = &module->instructions[block->instructions.indexes[j]];
+					if (inst->active == MU_TRUE) {
+						i = muVGC_module_write_instruction(module, b, i, inst);
 					}
 				}
 			}
-			return MUVGC_TYPE_UNKNOWN;
+			uint32_m function_end = (1 << 16) | MUVGC_OP_FUNCTION_END;
+			MUVGC_4_BYTE_LE_SET(b, function_end, i) i += 4;
 		}
 
-	// Structs
+		bytecode.len = i;
+		b[i] = 0;
+		return bytecode;
+	}
 
-		struct muVGCParameter {
-			muVGCBasicType type;
-			muVGCToken token_name;
-			muBool is_array;
-			size_m arraylen;
-		};
-		typedef struct muVGCParameter muVGCParameter;
+/* INSTRUCTION HANDLING */
 
-		muBool muVGC_are_two_parameters_equivalent(const char* code, muVGCParameter p0, muVGCParameter p1) {
-			return p0.type == p1.type && p0.token_name.length == p1.token_name.length &&
-			mu_strncmp(muVGC_get_token_value(code, p0.token_name), muVGC_get_token_value(code, p1.token_name), p0.token_name.length) == 0 &&
-			p0.is_array == p1.is_array && p0.arraylen == p1.arraylen;
+	// 3.49.1 Miscellaneous Instructions (Get)
+
+		uint32_m muVGC_get_undef(muVGCModule* module, uint32_m type) {
+			return muVGC_module_get_global(module, MUVGC_OP_UNDEF, type, MU_NULL_PTR, 0);
 		}
 
-		struct muVGCVariable {
-			muBool active;
-			muVGCBasicType type;
-			muVGCToken token_name;
-			muBool is_array;
-			size_m arraylen;
-			muBool is_function;
-			size_m scope;
-			muBool is_function_implemented;
-			muVGCParameter* parameters;
-			size_m parameterlen;
-			uint32_m id;
-		};
-		typedef struct muVGCVariable muVGCVariable;
+	// 3.49.2 Debug Instructions
 
-		muVGCVariable muVGC_make_variable(
-			muBool active, muVGCBasicType type, muVGCToken token_name, muBool is_array, 
-			size_m arraylen, muBool is_function, size_m scope, muBool is_function_implemented,
-			muVGCParameter* parameters, size_m parameterlen, uint32_m id) {
-			muVGCVariable var = {0};
-			var.active = active; var.type = type; var.token_name = token_name;
-			var.is_array = is_array; var.arraylen = arraylen; var.is_function = is_function;
-			var.scope = scope; var.is_function_implemented = is_function_implemented;
-			var.parameters = parameters; var.parameterlen = parameterlen; var.id = id;
-			return var;
+		// (These do nothing if the module strips debug instructions)
+
+		void muVGC_op_source(muVGCModule* module, uint32_m source_language, uint32_m version) {
+			if (module->strip_debug == MU_TRUE) {
+				return;
+			}
+			muVGCOperand operands[] = { MUVGC_LITERAL(source_language), MUVGC_LITERAL(version) };
+			muVGC_module_emit(module, MUVGC_SECTION_DEBUG_SOURCE, MUVGC_OP_SOURCE, 0, 0, operands, 2);
 		}
 
-		struct muVGCVariableList {
-			muVGCVariable* variables;
-			size_m len;
-			size_m allocated_len;
-		};
-		typedef struct muVGCVariableList muVGCVariableList;
+		void muVGC_op_source_extension(muVGCModule* module, const char* extension, size_m extensionlen) {
+			if (module->strip_debug == MU_TRUE) {
+				return;
+			}
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_DEBUG_SOURCE, MUVGC_OP_SOURCE_EXTENSION, 0, 0, MU_NULL_PTR, 0);
+			muVGC_module_add_string_operand(module, i, extension, extensionlen);
+		}
 
-	// Functions
+		void muVGC_op_name(muVGCModule* module, uint32_m id_target, char* name, size_m namelen) {
+			if (module->strip_debug == MU_TRUE) {
+				return;
+			}
+			muVGCOperand operands[] = { MUVGC_ID(id_target) };
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_DEBUG_NAME, MUVGC_OP_NAME, 0, 0, operands, 1);
+			muVGC_module_add_string_operand(module, i, name, namelen);
+		}
 
-		muVGCVariableList muVGC_intialize_empty_variable_list() {
-			muVGCVariableList list = {0};
-			list.variables = MU_NULL_PTR;
-			list.len = 0;
-			list.allocated_len = 0;
-			return list;
+		void muVGC_op_member_name(muVGCModule* module, uint32_m type, uint32_m member, const char* name, size_m namelen) {
+			if (module->strip_debug == MU_TRUE) {
+				return;
+			}
+			muVGCOperand operands[] = { MUVGC_ID(type), MUVGC_LITERAL(member) };
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_DEBUG_NAME, MUVGC_OP_MEMBER_NAME, 0, 0, operands, 2);
+			muVGC_module_add_string_operand(module, i, name, namelen);
 		}
 
-		muVGCVariableList muVGC_empty_variable_list(muVGCVariableList list) {
-			if (list.variables != MU_NULL_PTR) {
-				for (size_m i = 0; i < list.allocated_len; i++) {
-					if (list.variables[i].parameters != MU_NULL_PTR) {
-						mu_free(list.variables[i].parameters);
-						list.variables[i].parameters = MU_NULL_PTR;
-						list.variables[i].parameterlen = 0;
-					}
+	// 3.49.4 Extension Instructions
+
+		void muVGC_op_extension(muVGCModule* module, const char* name, size_m namelen) {
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_EXTENSION, MUVGC_OP_EXTENSION, 0, 0, MU_NULL_PTR, 0);
+			muVGC_module_add_string_operand(module, i, name, namelen);
+		}
+
+		// Declares an extension unless the module already declares it
+		void muVGC_require_extension(muVGCModule* module, const char* name, size_m namelen) {
+			muVGCIndexList* extensions = &module->sections[MUVGC_SECTION_EXTENSION];
+			for (size_m i = 0; i < extensions->len; i++) {
+				if (module->instructions[extensions->indexes[i]].active == MU_TRUE &&
+					muVGC_module_string_operand_equals(module, extensions->indexes[i], 0, name, namelen) == MU_TRUE) {
+					return;
 				}
-				mu_free(list.variables);
-				list.variables = MU_NULL_PTR;
 			}
-			list.len = 0;
-			list.allocated_len = 0;
-			return list;
+			muVGC_op_extension(module, name, namelen);
 		}
 
-		muVGCVariableList muVGC_add_variable(muVGCVariableList list, muVGCVariable var) {
-			if (list.variables == MU_NULL_PTR) {
-				list.len = 1;
-				list.allocated_len = 2;
-				list.variables = mu_malloc(sizeof(muVGCVariable) * list.allocated_len);
-				list.variables[0] = var;
-				list.variables[0].active = MU_TRUE;
-				return list;
+		uint32_m muVGC_op_ext_inst_import(muVGCModule* module, const char* name, size_m namelen) {
+			uint32_m id = muVGC_module_new_id(module);
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_EXT_INST_IMPORT, MUVGC_OP_EXT_INST_IMPORT, 0, id, MU_NULL_PTR, 0);
+			muVGC_module_add_string_operand(module, i, name, namelen);
+			return id;
+		}
+
+		// Emits an instruction of the GLSL.std.450 set (the preamble's
+		// import, being the only one)
+		uint32_m muVGC_op_ext_inst(muVGCModule* module, size_m block, uint32_m result_type, uint32_m instruction, uint32_m* ids, size_m id_len) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[5] = { MUVGC_ID(0), MUVGC_LITERAL(instruction) };
+			operands[0].word = module->instructions[module->sections[MUVGC_SECTION_EXT_INST_IMPORT].indexes[0]].result_id;
+			for (size_m i = 0; i < id_len; i++) {
+				operands[2+i].is_id = MU_TRUE;
+				operands[2+i].word = ids[i];
 			}
-			for (size_m i = 0; i < list.len; i++) {
-				if (list.variables[i].active == MU_FALSE) {
-					list.variables[i] = var;
-					list.variables[i].active = MU_TRUE;
-					return list;
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_EXT_INST, result_type, id, operands, 2+id_len);
+			return id;
+		}
+
+	// 3.49.5 Mode-Setting Instructions
+
+		void muVGC_op_memory_model(muVGCModule* module, uint32_m addressing_model, uint32_m memory_model) {
+			muVGCOperand operands[] = { MUVGC_LITERAL(addressing_model), MUVGC_LITERAL(memory_model) };
+			muVGC_module_emit(module, MUVGC_SECTION_MEMORY_MODEL, MUVGC_OP_MEMORY_MODEL, 0, 0, operands, 2);
+		}
+
+		// Returns the instruction so that interface ids can be appended later
+		size_m muVGC_op_entry_point(muVGCModule* module, uint32_m execution_model, uint32_m entry_point, const char* name, size_m namelen) {
+			muVGCOperand operands[] = { MUVGC_LITERAL(execution_model), MUVGC_ID(entry_point) };
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_ENTRY_POINT, MUVGC_OP_ENTRY_POINT, 0, 0, operands, 2);
+			muVGC_module_add_string_operand(module, i, name, namelen);
+			return i;
+		}
+
+		// Returns the instruction so that the mode's literals can be appended
+		size_m muVGC_op_execution_mode(muVGCModule* module, uint32_m entry_point, uint32_m mode) {
+			muVGCOperand operands[] = { MUVGC_ID(entry_point), MUVGC_LITERAL(mode) };
+			return muVGC_module_emit(module, MUVGC_SECTION_EXECUTION_MODE, MUVGC_OP_EXECUTION_MODE, 0, 0, operands, 2);
+		}
+
+		// Adds a global variable to the interface of the entry point
+		void muVGC_add_interface_variable(muVGCModule* module, uint32_m variable) {
+			muVGCIndexList* entry_points = &module->sections[MUVGC_SECTION_ENTRY_POINT];
+			for (size_m i = 0; i < entry_points->len; i++) {
+				muVGCInstruction* inst = &module->instructions[entry_points->indexes[i]];
+				if (inst->active == MU_TRUE && module->operands[inst->operand_index+1].word == module->entry_point) {
+					muVGCOperand operand = MUVGC_ID(variable);
+					muVGC_module_add_operand(module, entry_points->indexes[i], operand);
+					return;
 				}
 			}
-			list.len += 1;
-			if (list.len >= list.allocated_len) {
-				list.allocated_len *= 2;
-				list.variables = mu_realloc(list.variables, list.allocated_len * sizeof(muVGCVariable));
-			}
-			list.variables[list.len-1] = var;
-			list.variables[list.len-1].active = MU_TRUE;
-			return list;
 		}
 
-		muVGCVariableList muVGC_remove_variable(muVGCVariableList list, size_m i) {
-			if (i < list.len) {
-				list.variables[i].active = MU_FALSE;
-				if (list.variables[i].parameters != MU_NULL_PTR) {
-					mu_free(list.variables[i].parameters);
-					list.variables[i].parameters = MU_NULL_PTR;
-					list.variables[i].parameterlen = 0;
+		void muVGC_op_capability(muVGCModule* module, uint32_m capability) {
+			muVGCOperand operands[] = { MUVGC_LITERAL(capability) };
+			muVGC_module_emit(module, MUVGC_SECTION_CAPABILITY, MUVGC_OP_CAPABILITY, 0, 0, operands, 1);
+		}
+
+		// Declares a capability unless the module already declares it
+		void muVGC_require_capability(muVGCModule* module, uint32_m capability) {
+			muVGCIndexList* capabilities = &module->sections[MUVGC_SECTION_CAPABILITY];
+			for (size_m i = 0; i < capabilities->len; i++) {
+				muVGCInstruction* inst = &module->instructions[capabilities->indexes[i]];
+				if (inst->active == MU_TRUE && module->operands[inst->operand_index].word == capability) {
+					return;
 				}
 			}
-			return list;
+			muVGC_op_capability(module, capability);
 		}
 
-	// Declaration functions
+		// Raises the SPIR-V version of the module to at least 'version'
+		void muVGC_require_version(muVGCModule* module, uint32_m version) {
+			if (module->version < version) {
+				module->version = version;
+			}
+		}
 
-		muString muVGC_get_transparent_type(muString bytecode, muVGCBasicType type, uint32_m* id, uint32_m* global_id) {
-			switch (type) {
-				default: return bytecode; break;
-				case MUVGC_TYPE_VOID: {
-					return muVGC_get_void_type(bytecode, id, global_id);
-				} break;
-				case MUVGC_TYPE_BOOL: {
-					return muVGC_get_bool_type(bytecode, id, global_id);
-				} break;
-				case MUVGC_TYPE_INT: {
-					return muVGC_get_int_type(bytecode, id, global_id, 32, 1);
-				} break;
-				case MUVGC_TYPE_UINT: {
-					return muVGC_get_int_type(bytecode, id, global_id, 32, 0);
-				} break;
-				case MUVGC_TYPE_FLOAT: {
-					return muVGC_get_float_type(bytecode, id, global_id, 32);
-				} break;
-				case MUVGC_TYPE_DOUBLE: {
-					return muVGC_get_float_type(bytecode, id, global_id, 64);
-				} break;
-				case MUVGC_TYPE_VEC2: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 2);
-				} break;
-				case MUVGC_TYPE_VEC3: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 3);
-				} break;
-				case MUVGC_TYPE_VEC4: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 4);
-				} break;
-				case MUVGC_TYPE_DVEC2: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 2);
-				} break;
-				case MUVGC_TYPE_DVEC3: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 3);
-				} break;
-				case MUVGC_TYPE_DVEC4: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 4);
-				} break;
-				case MUVGC_TYPE_BVEC2: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_bool_type(bytecode, &cmp, global_id);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 2);
-				} break;
-				case MUVGC_TYPE_BVEC3: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_bool_type(bytecode, &cmp, global_id);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 3);
+		// Declares what a group non-uniform instruction (or built-in) needs:
+		// SPIR-V 1.3, GroupNonUniform and the given capability
+		void muVGC_require_group_non_uniform(muVGCModule* module, uint32_m capability) {
+			muVGC_require_version(module, MUVGC_SPIRV_VERSION_1_3);
+			muVGC_require_capability(module, MUVGC_CAPABILITY_GROUP_NON_UNIFORM);
+			muVGC_require_capability(module, capability);
+		}
+
+	// 3.49.6 Type-Declaration Instructions (Get)
+
+		uint32_m muVGC_get_void_type(muVGCModule* module) {
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_VOID, 0, MU_NULL_PTR, 0);
+		}
+
+		uint32_m muVGC_get_bool_type(muVGCModule* module) {
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_BOOL, 0, MU_NULL_PTR, 0);
+		}
+
+		uint32_m muVGC_get_int_type(muVGCModule* module, uint32_m width, uint32_m signedness) {
+			if (width != 32) {
+				muVGC_require_capability(module, (width == 8) ? MUVGC_CAPABILITY_INT8 : (width == 16) ? MUVGC_CAPABILITY_INT16 : MUVGC_CAPABILITY_INT64);
+			}
+			muVGCOperand operands[] = { MUVGC_LITERAL(width), MUVGC_LITERAL(signedness) };
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_INT, 0, operands, 2);
+		}
+
+		uint32_m muVGC_get_float_type(muVGCModule* module, uint32_m width) {
+			if (width != 32) {
+				muVGC_require_capability(module, (width == 16) ? MUVGC_CAPABILITY_FLOAT16 : MUVGC_CAPABILITY_FLOAT64);
+			}
+			muVGCOperand operands[] = { MUVGC_LITERAL(width) };
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_FLOAT, 0, operands, 1);
+		}
+
+		uint32_m muVGC_get_vector_type(muVGCModule* module, uint32_m component_type, uint32_m component_count) {
+			muVGCOperand operands[] = { MUVGC_ID(component_type), MUVGC_LITERAL(component_count) };
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_VECTOR, 0, operands, 2);
+		}
+
+		uint32_m muVGC_get_matrix_type(muVGCModule* module, uint32_m column_type, uint32_m column_count) {
+			muVGCOperand operands[] = { MUVGC_ID(column_type), MUVGC_LITERAL(column_count) };
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_MATRIX, 0, operands, 2);
+		}
+
+		uint32_m muVGC_get_image_type(muVGCModule* module,
+			uint32_m sampled_type, uint32_m dim, uint32_m depth, uint32_m arrayed, uint32_m ms,
+			uint32_m sampled, uint32_m image_format, uint32_m access_qualifier, muBool apply_access_qualifier) {
+
+			muVGCOperand operands[] = {
+				MUVGC_ID(sampled_type), MUVGC_LITERAL(dim), MUVGC_LITERAL(depth), MUVGC_LITERAL(arrayed),
+				MUVGC_LITERAL(ms), MUVGC_LITERAL(sampled), MUVGC_LITERAL(image_format), MUVGC_LITERAL(access_qualifier)
+			};
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_IMAGE, 0, operands, (apply_access_qualifier == MU_TRUE) ? 8 : 7);
+		}
+
+		// Whether a type is or contains an integer or float of the given width
+		muBool muVGC_type_contains_width(muVGCModule* module, uint32_m type, uint32_m width) {
+			muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+			if (inst == MU_NULL_PTR) {
+				return MU_FALSE;
+			}
+			muVGCOperand* operands = &module->operands[inst->operand_index];
+			switch (inst->opcode) {
+				default: return MU_FALSE; break;
+				case MUVGC_OP_TYPE_INT: case MUVGC_OP_TYPE_FLOAT: {
+					return (operands[0].word == width) ? MU_TRUE : MU_FALSE;
 				} break;
-				case MUVGC_TYPE_BVEC4: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_bool_type(bytecode, &cmp, global_id);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 4);
+				case MUVGC_OP_TYPE_VECTOR: case MUVGC_OP_TYPE_MATRIX: case MUVGC_OP_TYPE_ARRAY: case MUVGC_OP_TYPE_RUNTIME_ARRAY: {
+					return muVGC_type_contains_width(module, operands[0].word, width);
 				} break;
-				case MUVGC_TYPE_IVEC2: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_int_type(bytecode, &cmp, global_id, 32, 1);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 2);
+				case MUVGC_OP_TYPE_STRUCT: {
+					for (size_m i = 0; i < inst->operand_len; i++) {
+						if (muVGC_type_contains_width(module, operands[i].word, width) == MU_TRUE) {
+							return MU_TRUE;
+						}
+					}
+					return MU_FALSE;
 				} break;
-				case MUVGC_TYPE_IVEC3: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_int_type(bytecode, &cmp, global_id, 32, 1);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 3);
+			}
+		}
+
+		// 16- and 8-bit types in interface storage classes need their own
+		// storage capabilities on top of the arithmetic ones; gives the ones
+		// that a pointer to 'type' in 'storage_class' needs (0 if none)
+		void muVGC_get_storage_capabilities(muVGCModule* module, uint32_m storage_class, uint32_m type, uint32_m* capability16, uint32_m* capability8) {
+			*capability16 = 0;
+			*capability8 = 0;
+			switch (storage_class) {
+				default: return; break;
+				case MUVGC_STORAGE_CLASS_STORAGE_BUFFER: {
+					*capability16 = MUVGC_CAPABILITY_STORAGE_BUFFER_16BIT_ACCESS;
+					*capability8 = MUVGC_CAPABILITY_STORAGE_BUFFER_8BIT_ACCESS;
 				} break;
-				case MUVGC_TYPE_IVEC4: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_int_type(bytecode, &cmp, global_id, 32, 1);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 4);
+				case MUVGC_STORAGE_CLASS_UNIFORM: {
+					*capability16 = MUVGC_CAPABILITY_UNIFORM_AND_STORAGE_BUFFER_16BIT_ACCESS;
+					*capability8 = MUVGC_CAPABILITY_UNIFORM_AND_STORAGE_BUFFER_8BIT_ACCESS;
 				} break;
-				case MUVGC_TYPE_UVEC2: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_int_type(bytecode, &cmp, global_id, 32, 0);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 2);
+				case MUVGC_STORAGE_CLASS_PUSH_CONSTANT: {
+					*capability16 = MUVGC_CAPABILITY_STORAGE_PUSH_CONSTANT_16;
+					*capability8 = MUVGC_CAPABILITY_STORAGE_PUSH_CONSTANT_8;
 				} break;
-				case MUVGC_TYPE_UVEC3: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_int_type(bytecode, &cmp, global_id, 32, 0);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 3);
-				} break;
-				case MUVGC_TYPE_UVEC4: {
-					uint32_m cmp = 0;
-					bytecode = muVGC_get_int_type(bytecode, &cmp, global_id, 32, 0);
-					return muVGC_get_vector_type(bytecode, id, global_id, cmp, 4);
-				} break;
-				case MUVGC_TYPE_MAT2: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 2);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 2);
-				} break;
-				case MUVGC_TYPE_MAT3: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 3);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 3);
-				} break;
-				case MUVGC_TYPE_MAT4: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 4);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 4);
-				} break;
-				case MUVGC_TYPE_MAT2X2: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 2);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 2);
-				} break;
-				case MUVGC_TYPE_MAT2X3: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 3);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 2);
-				} break;
-				case MUVGC_TYPE_MAT2X4: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 4);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 2);
-				} break;
-				case MUVGC_TYPE_MAT3X2: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 2);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 3);
-				} break;
-				case MUVGC_TYPE_MAT3X3: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 3);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 3);
-				} break;
-				case MUVGC_TYPE_MAT3X4: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 4);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 3);
-				} break;
-				case MUVGC_TYPE_MAT4X2: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 2);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 4);
-				} break;
-				case MUVGC_TYPE_MAT4X3: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 3);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 4);
-				} break;
-				case MUVGC_TYPE_MAT4X4: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 32);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 4);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 4);
-				} break;
-				case MUVGC_TYPE_DMAT2: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 2);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 2);
-				} break;
-				case MUVGC_TYPE_DMAT3: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 3);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 3);
-				} break;
-				case MUVGC_TYPE_DMAT4: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 4);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 4);
-				} break;
-				case MUVGC_TYPE_DMAT2X2: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 2);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 2);
-				} break;
-				case MUVGC_TYPE_DMAT2X3: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 3);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 2);
-				} break;
-				case MUVGC_TYPE_DMAT2X4: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 4);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 2);
-				} break;
-				case MUVGC_TYPE_DMAT3X2: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 2);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 3);
-				} break;
-				case MUVGC_TYPE_DMAT3X3: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 3);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 3);
-				} break;
-				case MUVGC_TYPE_DMAT3X4: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 4);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 3);
-				} break;
-				case MUVGC_TYPE_DMAT4X2: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 2);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 4);
-				} break;
-				case MUVGC_TYPE_DMAT4X3: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 3);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 4);
-				} break;
-				case MUVGC_TYPE_DMAT4X4: {
-					uint32_m cmp = 0, cmp2 = 0;
-					bytecode = muVGC_get_float_type(bytecode, &cmp, global_id, 64);
-					bytecode = muVGC_get_vector_type(bytecode, &cmp2, global_id, cmp, 4);
-					return muVGC_get_matrix_type(bytecode, id, global_id, cmp2, 4);
+				// (There's no 8-bit equivalent for inputs and outputs)
+				case MUVGC_STORAGE_CLASS_INPUT: case MUVGC_STORAGE_CLASS_OUTPUT: {
+					*capability16 = MUVGC_CAPABILITY_STORAGE_INPUT_OUTPUT_16;
 				} break;
 			}
+			if (muVGC_type_contains_width(module, type, 16) == MU_FALSE) {
+				*capability16 = 0;
+			}
+			if (muVGC_type_contains_width(module, type, 8) == MU_FALSE) {
+				*capability8 = 0;
+			}
+		}
+
+		void muVGC_require_storage_capabilities(muVGCModule* module, uint32_m storage_class, uint32_m type) {
+			uint32_m capability16, capability8;
+			muVGC_get_storage_capabilities(module, storage_class, type, &capability16, &capability8);
+			if (capability16 != 0) {
+				muVGC_require_capability(module, capability16);
+				muVGC_require_extension(module, "SPV_KHR_16bit_storage", 21);
+			}
+			if (capability8 != 0) {
+				muVGC_require_capability(module, capability8);
+				muVGC_require_extension(module, "SPV_KHR_8bit_storage", 20);
+			}
+		}
+
+		uint32_m muVGC_get_pointer_type(muVGCModule* module, uint32_m storage_class, uint32_m type) {
+			muVGC_require_storage_capabilities(module, storage_class, type);
+			muVGCOperand operands[] = { MUVGC_LITERAL(storage_class), MUVGC_ID(type) };
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_POINTER, 0, operands, 2);
+		}
+
+		// (The length being the id of a constant)
+		uint32_m muVGC_get_array_type(muVGCModule* module, uint32_m element_type, uint32_m length) {
+			muVGCOperand operands[] = { MUVGC_ID(element_type), MUVGC_ID(length) };
+			return muVGC_module_get_global(module, MUVGC_OP_TYPE_ARRAY, 0, operands, 2);
+		}
+
+		// (Not shared, since arrays laid out for blocks get decorated with
+		// their stride; the length being the id of a constant, or 0 for a
+		// runtime array)
+		uint32_m muVGC_op_type_array(muVGCModule* module, uint32_m element_type, uint32_m length) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_ID(element_type), MUVGC_ID(length) };
+			if (length == 0) {
+				muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, MUVGC_OP_TYPE_RUNTIME_ARRAY, 0, id, operands, 1);
+			} else {
+				muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, MUVGC_OP_TYPE_ARRAY, 0, id, operands, 2);
+			}
+			return id;
+		}
+
+		// (Structs are never shared, since their members get decorated)
+		uint32_m muVGC_op_type_struct(muVGCModule* module, uint32_m* member_types, size_m member_len) {
+			uint32_m id = muVGC_module_new_id(module);
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, MUVGC_OP_TYPE_STRUCT, 0, id, MU_NULL_PTR, 0);
+			for (size_m j = 0; j < member_len; j++) {
+				muVGCOperand member = MUVGC_ID(member_types[j]);
+				muVGC_module_add_operand(module, i, member);
+			}
+			return id;
+		}
+
+		uint32_m muVGC_get_function_type(muVGCModule* module, uint32_m return_type, uint32_m* parameter_types, size_m parameter_len) {
+			muVGCOperand* operands = mu_malloc(sizeof(muVGCOperand) * (parameter_len+1));
+			operands[0].is_id = MU_TRUE;
+			operands[0].word = return_type;
+			for (size_m i = 0; i < parameter_len; i++) {
+				operands[i+1].is_id = MU_TRUE;
+				operands[i+1].word = parameter_types[i];
+			}
+			uint32_m type = muVGC_module_get_global(module, MUVGC_OP_TYPE_FUNCTION, 0, operands, parameter_len+1);
+			mu_free(operands);
+			return type;
+		}
+
+	// 3.49.7 Constant-Creation Instructions (Get)
+
+		uint32_m muVGC_get_bool_constant(muVGCModule* module, muBool value) {
+			uint16_m opcode = (value == MU_TRUE) ? MUVGC_OP_CONSTANT_TRUE : MUVGC_OP_CONSTANT_FALSE;
+			return muVGC_module_get_global(module, opcode, muVGC_get_bool_type(module), MU_NULL_PTR, 0);
+		}
+
+		// (32-bit scalars only)
+		uint32_m muVGC_get_scalar_constant(muVGCModule* module, uint32_m type, uint32_m value) {
+			muVGCOperand operands[] = { MUVGC_LITERAL(value) };
+			return muVGC_module_get_global(module, MUVGC_OP_CONSTANT, type, operands, 1);
+		}
+
+		uint32_m muVGC_get_composite_constant(muVGCModule* module, uint32_m type, uint32_m* constituents, size_m constituent_len) {
+			muVGCOperand* operands = mu_malloc(sizeof(muVGCOperand) * constituent_len);
+			for (size_m i = 0; i < constituent_len; i++) {
+				operands[i].is_id = MU_TRUE;
+				operands[i].word = constituents[i];
+			}
+			uint32_m id = muVGC_module_get_global(module, MUVGC_OP_CONSTANT_COMPOSITE, type, operands, constituent_len);
+			mu_free(operands);
+			return id;
+		}
+
+		// (Specialization constants are never shared, since each one gets
+		// its own SpecId)
+		uint32_m muVGC_op_spec_constant(muVGCModule* module, uint32_m type, uint32_m value) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_LITERAL(value) };
+			muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, MUVGC_OP_SPEC_CONSTANT, type, id, operands, 1);
+			return id;
+		}
+
+		uint32_m muVGC_op_spec_constant_bool(muVGCModule* module, muBool value) {
+			uint32_m id = muVGC_module_new_id(module);
+			uint16_m opcode = (value == MU_TRUE) ? MUVGC_OP_SPEC_CONSTANT_TRUE : MUVGC_OP_SPEC_CONSTANT_FALSE;
+			muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, opcode, muVGC_get_bool_type(module), id, MU_NULL_PTR, 0);
+			return id;
+		}
+
+		uint32_m muVGC_op_spec_constant_composite(muVGCModule* module, uint32_m type, uint32_m* constituents, size_m constituent_len) {
+			uint32_m id = muVGC_module_new_id(module);
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, MUVGC_OP_SPEC_CONSTANT_COMPOSITE, type, id, MU_NULL_PTR, 0);
+			for (size_m j = 0; j < constituent_len; j++) {
+				muVGCOperand constituent = MUVGC_ID(constituents[j]);
+				muVGC_module_add_operand(module, i, constituent);
+			}
+			return id;
+		}
+
+		uint32_m muVGC_op_spec_constant_op(muVGCModule* module, uint32_m type, uint16_m opcode, const muVGCOperand* operands, size_m operand_len) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operation = MUVGC_LITERAL(opcode);
+			size_m i = muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, MUVGC_OP_SPEC_CONSTANT_OP, type, id, &operation, 1);
+			for (size_m j = 0; j < operand_len; j++) {
+				muVGC_module_add_operand(module, i, operands[j]);
+			}
+			return id;
+		}
+
+	// 3.49.8 Memory Instructions
+
+		uint32_m muVGC_op_global_variable(muVGCModule* module, uint32_m storage_class, uint32_m pointer_type) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_LITERAL(storage_class) };
+			muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, MUVGC_OP_VARIABLE, pointer_type, id, operands, 1);
+			return id;
+		}
+
+		// Declares a variable of the function storage class in the first
+		// block of a function (where SPIR-V requires them to be)
+		uint32_m muVGC_op_function_variable(muVGCModule* module, size_m function, uint32_m pointer_type) {
+			size_m entry = module->functions[function].blocks.indexes[0];
+			size_m position = 0;
+			while (position < module->blocks[entry].instructions.len) {
+				muVGCInstruction* inst = &module->instructions[module->blocks[entry].instructions.indexes[position]];
+				if (inst->active == MU_TRUE && inst->opcode != MUVGC_OP_VARIABLE) break;
+				position++;
+			}
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_LITERAL(MUVGC_STORAGE_CLASS_FUNCTION) };
+			size_m i = muVGC_module_add_instruction(module, MUVGC_OP_VARIABLE, pointer_type, id, operands, 1);
+			muVGC_index_list_insert(&module->blocks[entry].instructions, i, position);
+			return id;
+		}
+
+		uint32_m muVGC_op_load(muVGCModule* module, size_m block, uint32_m result_type, uint32_m pointer) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_ID(pointer) };
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_LOAD, result_type, id, operands, 1);
+			return id;
+		}
+
+		void muVGC_op_store(muVGCModule* module, size_m block, uint32_m pointer, uint32_m object) {
+			muVGCOperand operands[] = { MUVGC_ID(pointer), MUVGC_ID(object) };
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_STORE, 0, 0, operands, 2);
+		}
+
+		uint32_m muVGC_op_access_chain(muVGCModule* module, size_m block, uint32_m result_type, uint32_m base, uint32_m* indexes, size_m index_len) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_ID(base) };
+			size_m i = muVGC_module_emit_to_block(module, block, MUVGC_OP_ACCESS_CHAIN, result_type, id, operands, 1);
+			for (size_m j = 0; j < index_len; j++) {
+				muVGCOperand index = MUVGC_ID(indexes[j]);
+				muVGC_module_add_operand(module, i, index);
+			}
+			return id;
+		}
+
+	// 3.49.9 Function Instructions
+
+		// Returns the index of the function within the module
+		size_m muVGC_op_function(
+			muVGCModule* module, uint32_m result_id, uint32_m return_type, uint32_m function_control, uint32_m function_type) {
+
+			muVGCOperand operands[] = { MUVGC_LITERAL(function_control), MUVGC_ID(function_type) };
+			size_m i = muVGC_module_add_instruction(module, MUVGC_OP_FUNCTION, return_type, result_id, operands, 2);
+			return muVGC_module_add_function(module, i);
+		}
+
+		uint32_m muVGC_op_function_call(
+			muVGCModule* module, size_m block, uint32_m result_type, uint32_m function, uint32_m* arguments, size_m argument_len) {
+
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_ID(function) };
+			size_m i = muVGC_module_emit_to_block(module, block, MUVGC_OP_FUNCTION_CALL, result_type, id, operands, 1);
+			for (size_m j = 0; j < argument_len; j++) {
+				muVGCOperand argument = MUVGC_ID(arguments[j]);
+				muVGC_module_add_operand(module, i, argument);
+			}
+			return id;
+		}
+
+	// 3.49.10 Annotation Instructions
+
+		void muVGC_op_decorate(muVGCModule* module, uint32_m target, uint32_m decoration) {
+			muVGCOperand operands[] = { MUVGC_ID(target), MUVGC_LITERAL(decoration) };
+			muVGC_module_emit(module, MUVGC_SECTION_ANNOTATION, MUVGC_OP_DECORATE, 0, 0, operands, 2);
+		}
+
+		void muVGC_op_decorate_literal(muVGCModule* module, uint32_m target, uint32_m decoration, uint32_m literal) {
+			muVGCOperand operands[] = { MUVGC_ID(target), MUVGC_LITERAL(decoration), MUVGC_LITERAL(literal) };
+			muVGC_module_emit(module, MUVGC_SECTION_ANNOTATION, MUVGC_OP_DECORATE, 0, 0, operands, 3);
+		}
+
+		void muVGC_op_member_decorate(muVGCModule* module, uint32_m structure, uint32_m member, uint32_m decoration) {
+			muVGCOperand operands[] = { MUVGC_ID(structure), MUVGC_LITERAL(member), MUVGC_LITERAL(decoration) };
+			muVGC_module_emit(module, MUVGC_SECTION_ANNOTATION, MUVGC_OP_MEMBER_DECORATE, 0, 0, operands, 3);
+		}
+
+		void muVGC_op_member_decorate_literal(muVGCModule* module, uint32_m structure, uint32_m member, uint32_m decoration, uint32_m literal) {
+			muVGCOperand operands[] = { MUVGC_ID(structure), MUVGC_LITERAL(member), MUVGC_LITERAL(decoration), MUVGC_LITERAL(literal) };
+			muVGC_module_emit(module, MUVGC_SECTION_ANNOTATION, MUVGC_OP_MEMBER_DECORATE, 0, 0, operands, 4);
+		}
+
+		// Returns the id decorated as the given built-in, or 0 if there's none
+		uint32_m muVGC_find_built_in(muVGCModule* module, uint32_m built_in) {
+			muVGCIndexList* annotations = &module->sections[MUVGC_SECTION_ANNOTATION];
+			for (size_m i = 0; i < annotations->len; i++) {
+				muVGCInstruction* inst = &module->instructions[annotations->indexes[i]];
+				if (inst->active == MU_FALSE || inst->opcode != MUVGC_OP_DECORATE || inst->operand_len < 3) continue;
+				muVGCOperand* operands = &module->operands[inst->operand_index];
+				if (operands[1].word == MUVGC_DECORATION_BUILT_IN && operands[2].word == built_in) {
+					return operands[0].word;
+				}
+			}
+			return 0;
+		}
+
+		// Returns the index of the OpDecorate giving an id a decoration, or
+		// MUVGC_NO_DECORATION if it doesn't have it
+		#define MUVGC_NO_DECORATION ((size_m)-1)
+		size_m muVGC_find_decoration(muVGCModule* module, uint32_m target, uint32_m decoration) {
+			muVGCIndexList* annotations = &module->sections[MUVGC_SECTION_ANNOTATION];
+			for (size_m i = 0; i < annotations->len; i++) {
+				muVGCInstruction* inst = &module->instructions[annotations->indexes[i]];
+				if (inst->active == MU_FALSE || inst->opcode != MUVGC_OP_DECORATE || inst->operand_len < 2) continue;
+				muVGCOperand* operands = &module->operands[inst->operand_index];
+				if (operands[0].word == target && operands[1].word == decoration) {
+					return annotations->indexes[i];
+				}
+			}
+			return MUVGC_NO_DECORATION;
+		}
+
+	// 3.49.12 Composite Instructions
+
+		uint32_m muVGC_op_composite_extract(muVGCModule* module, size_m block, uint32_m result_type, uint32_m composite, uint32_m index) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_ID(composite), MUVGC_LITERAL(index) };
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_COMPOSITE_EXTRACT, result_type, id, operands, 2);
+			return id;
+		}
+
+		uint32_m muVGC_op_composite_construct(muVGCModule* module, size_m block, uint32_m result_type, uint32_m* constituents, size_m constituent_len) {
+			uint32_m id = muVGC_module_new_id(module);
+			size_m i = muVGC_module_emit_to_block(module, block, MUVGC_OP_COMPOSITE_CONSTRUCT, result_type, id, MU_NULL_PTR, 0);
+			for (size_m j = 0; j < constituent_len; j++) {
+				muVGCOperand constituent = MUVGC_ID(constituents[j]);
+				muVGC_module_add_operand(module, i, constituent);
+			}
+			return id;
+		}
+
+	// 3.49.13 Arithmetic Instructions
+
+		// (Any instruction taking one operand, including conversions and
+		// OpLogicalNot)
+		uint32_m muVGC_op_unary(muVGCModule* module, size_m block, uint16_m opcode, uint32_m result_type, uint32_m a) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_ID(a) };
+			muVGC_module_emit_to_block(module, block, opcode, result_type, id, operands, 1);
+			return id;
+		}
+
+		// (Any instruction taking two operands, including the relational and
+		// logical ones)
+		uint32_m muVGC_op_binary(muVGCModule* module, size_m block, uint16_m opcode, uint32_m result_type, uint32_m a, uint32_m b) {
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_ID(a), MUVGC_ID(b) };
+			muVGC_module_emit_to_block(module, block, opcode, result_type, id, operands, 2);
+			return id;
+		}
+
+	// 3.49.17 Control-Flow Instructions
+
+		void muVGC_op_selection_merge(muVGCModule* module, size_m block, uint32_m merge_block, uint32_m selection_control) {
+			muVGCOperand operands[] = { MUVGC_ID(merge_block), MUVGC_LITERAL(selection_control) };
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_SELECTION_MERGE, 0, 0, operands, 2);
+		}
+
+		void muVGC_op_loop_merge(muVGCModule* module, size_m block, uint32_m merge_block, uint32_m continue_target, uint32_m loop_control) {
+			muVGCOperand operands[] = { MUVGC_ID(merge_block), MUVGC_ID(continue_target), MUVGC_LITERAL(loop_control) };
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_LOOP_MERGE, 0, 0, operands, 3);
+		}
+
+		void muVGC_op_branch(muVGCModule* module, size_m block, uint32_m target_label) {
+			muVGCOperand operands[] = { MUVGC_ID(target_label) };
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_BRANCH, 0, 0, operands, 1);
+		}
+
+		void muVGC_op_branch_conditional(muVGCModule* module, size_m block, uint32_m condition, uint32_m true_label, uint32_m false_label) {
+			muVGCOperand operands[] = { MUVGC_ID(condition), MUVGC_ID(true_label), MUVGC_ID(false_label) };
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_BRANCH_CONDITIONAL, 0, 0, operands, 3);
+		}
+
+		// Returns the index of the block within the module
+		size_m muVGC_op_label(muVGCModule* module, size_m function, uint32_m result_id) {
+			return muVGC_module_add_block(module, function, result_id);
+		}
+
+		void muVGC_op_return(muVGCModule* module, size_m block) {
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_RETURN, 0, 0, MU_NULL_PTR, 0);
+		}
+
+		void muVGC_op_return_value(muVGCModule* module, size_m block, uint32_m value) {
+			muVGCOperand operands[] = { MUVGC_ID(value) };
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_RETURN_VALUE, 0, 0, operands, 1);
+		}
+
+	// 3.49.18 Atomic Instructions
+
+		// Emits a read-modify-write instruction of device scope and relaxed
+		// semantics (as GLSL's atomic functions are)
+		uint32_m muVGC_op_atomic(muVGCModule* module, size_m block, uint16_m opcode, uint32_m result_type, uint32_m pointer, uint32_m value) {
+			uint32_m uint_type = muVGC_get_int_type(module, 32, 0);
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[] = { MUVGC_ID(pointer), MUVGC_ID(0), MUVGC_ID(0), MUVGC_ID(value) };
+			operands[1].word = muVGC_get_scalar_constant(module, uint_type, MUVGC_SCOPE_DEVICE);
+			operands[2].word = muVGC_get_scalar_constant(module, uint_type, MUVGC_MEMORY_SEMANTICS_NONE);
+			muVGC_module_emit_to_block(module, block, opcode, result_type, id, operands, 4);
+			return id;
+		}
+
+	// 3.49.20 Barrier Instructions
+
+		void muVGC_op_control_barrier(muVGCModule* module, size_m block, uint32_m execution_scope, uint32_m memory_scope, uint32_m semantics) {
+			uint32_m uint_type = muVGC_get_int_type(module, 32, 0);
+			muVGCOperand operands[] = { MUVGC_ID(0), MUVGC_ID(0), MUVGC_ID(0) };
+			operands[0].word = muVGC_get_scalar_constant(module, uint_type, execution_scope);
+			operands[1].word = muVGC_get_scalar_constant(module, uint_type, memory_scope);
+			operands[2].word = muVGC_get_scalar_constant(module, uint_type, semantics);
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_CONTROL_BARRIER, 0, 0, operands, 3);
+		}
+
+		void muVGC_op_memory_barrier(muVGCModule* module, size_m block, uint32_m memory_scope, uint32_m semantics) {
+			uint32_m uint_type = muVGC_get_int_type(module, 32, 0);
+			muVGCOperand operands[] = { MUVGC_ID(0), MUVGC_ID(0) };
+			operands[0].word = muVGC_get_scalar_constant(module, uint_type, memory_scope);
+			operands[1].word = muVGC_get_scalar_constant(module, uint_type, semantics);
+			muVGC_module_emit_to_block(module, block, MUVGC_OP_MEMORY_BARRIER, 0, 0, operands, 2);
+		}
+
+	// 3.49.24 Non-Uniform Instructions
+
+		// Emits a group non-uniform instruction of subgroup scope; the
+		// group operation comes before the ids if there's one
+		uint32_m muVGC_op_group_non_uniform(
+			muVGCModule* module, size_m block, uint16_m opcode, uint32_m result_type, uint32_m group_operation,
+			uint32_m* ids, size_m id_len) {
+
+			uint32_m id = muVGC_module_new_id(module);
+			muVGCOperand operands[4] = { MUVGC_ID(0) };
+			size_m operand_len = 0;
+			operands[operand_len].word = muVGC_get_scalar_constant(module, muVGC_get_int_type(module, 32, 0), MUVGC_SCOPE_SUBGROUP);
+			operand_len += 1;
+			if (group_operation != MUVGC_NO_GROUP_OPERATION) {
+				operands[operand_len].is_id = MU_FALSE;
+				operands[operand_len].word = group_operation;
+				operand_len += 1;
+			}
+			for (size_m i = 0; i < id_len; i++) {
+				operands[operand_len].is_id = MU_TRUE;
+				operands[operand_len].word = ids[i];
+				operand_len += 1;
+			}
+			muVGC_module_emit_to_block(module, block, opcode, result_type, id, operands, operand_len);
+			return id;
+		}
+
+	// Get stuff
+
+		uint32_m muVGC_get_format(char* format, size_m formatlen) {
+			const muVGCKeyword* keyword = muVGC_find_keyword(format, formatlen);
+			if (keyword == MU_NULL_PTR || keyword->type != MUVGC_KEYWORD_TYPE_FORMAT) {
+				return 0;
+			}
+			return keyword->image_format;
+		}
+
+	// Explicit layouts
+
+	// How the members of uniform, storage & push constant blocks are laid
+	// out in memory. Under std430, scalars are aligned to their size,
+	// vectors of two components to twice that and vectors of three or four
+	// components to four times that; arrays are aligned like their
+	// elements, with a stride of the element size rounded up to that
+	// alignment, and matrices are laid out like arrays of their columns (or
+	// rows, if they're row-major). std140 also rounds the alignment of
+	// arrays, matrices and structs up to 16 bytes, while scalar aligns
+	// everything to the size of its components. Each layout is only worked
+	// out once, the module caching it.
+
+	uint32_m muVGC_round_up(uint32_m value, uint32_m alignment) {
+		return ((value + alignment-1) / alignment) * alignment;
+	}
+
+	void muVGC_add_type_layout(muVGCModule* module, muVGCTypeLayout layout) {
+		if (module->layout_len >= module->allocated_layout_len) {
+			module->allocated_layout_len = (module->allocated_layout_len == 0) ? 8 : module->allocated_layout_len*2;
+			module->layouts = mu_realloc(module->layouts, sizeof(muVGCTypeLayout) * module->allocated_layout_len);
+		}
+		module->layouts[module->layout_len] = layout;
+		module->layout_len += 1;
+	}
+
+	// Fills in the layout of a type (or of an array of it) under the given
+	// rules, declaring the array type the first time it's needed; returns
+	// MU_FALSE if the type can't be laid out. Besides scalars, vectors and
+	// matrices of numbers, only structs whose layout has been added to the
+	// cache can be.
+	muBool muVGC_get_type_layout(
+		muVGCModule* module, uint32_m type, uint32_m array_length, muVGCLayoutRules rules, muBool row_major, muVGCTypeLayout* layout) {
+
+		uint32_m columns = 1, rows = 1;
+		muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+		if (inst != MU_NULL_PTR && inst->opcode == MUVGC_OP_TYPE_MATRIX) {
+			columns = module->operands[inst->operand_index+1].word;
+			inst = muVGC_module_get_definition(module, module->operands[inst->operand_index].word);
+		}
+		if (inst != MU_NULL_PTR && inst->opcode == MUVGC_OP_TYPE_VECTOR) {
+			rows = module->operands[inst->operand_index+1].word;
+			inst = muVGC_module_get_definition(module, module->operands[inst->operand_index].word);
+		}
+		if (columns == 1) {
+			row_major = MU_FALSE;
+		}
+
+		for (size_m i = 0; i < module->layout_len; i++) {
+			muVGCTypeLayout* cached = &module->layouts[i];
+			if (cached->type == type && cached->array_length == array_length && cached->rules == rules && cached->row_major == row_major) {
+				*layout = *cached;
+				return MU_TRUE;
+			}
+		}
+		if (inst == MU_NULL_PTR || (inst->opcode != MUVGC_OP_TYPE_INT && inst->opcode != MUVGC_OP_TYPE_FLOAT)) {
+			return MU_FALSE;
+		}
+		uint32_m component_size = module->operands[inst->operand_index].word / 8;
+
+		muVGCTypeLayout l = { 0 };
+		l.type = type;
+		l.array_length = array_length;
+		l.rules = rules;
+		l.row_major = row_major;
+		l.layout_type = type;
+
+		// Vectors (and the columns or rows of matrices)
+		uint32_m vector_len = (row_major == MU_TRUE) ? columns : rows;
+		l.size = vector_len * component_size;
+		l.alignment = component_size;
+		if (rules != MUVGC_LAYOUT_SCALAR && vector_len > 1) {
+			l.alignment *= (vector_len == 2) ? 2 : 4;
+		}
+
+		// Matrices
+		if (columns > 1) {
+			if (rules == MUVGC_LAYOUT_STD140) {
+				l.alignment = muVGC_round_up(l.alignment, 16);
+			}
+			l.matrix_stride = muVGC_round_up(l.size, l.alignment);
+			l.size = l.matrix_stride * ((row_major == MU_TRUE) ? rows : columns);
+		}
+
+		// Arrays
+		if (array_length != 0) {
+			if (rules == MUVGC_LAYOUT_STD140) {
+				l.alignment = muVGC_round_up(l.alignment, 16);
+			}
+			l.array_stride = muVGC_round_up(l.size, l.alignment);
+			uint32_m length = 0;
+			if (array_length == MUVGC_RUNTIME_ARRAY_LENGTH) {
+				l.size = 0;
+			} else {
+				l.size = l.array_stride * array_length;
+				length = muVGC_get_scalar_constant(module, muVGC_get_int_type(module, 32, 0), array_length);
+			}
+			l.layout_type = muVGC_op_type_array(module, type, length);
+			muVGC_op_decorate_literal(module, l.layout_type, MUVGC_DECORATION_ARRAY_STRIDE, l.array_stride);
+		}
+
+		muVGC_add_type_layout(module, l);
+		*layout = l;
+		return MU_TRUE;
+	}
+
+/* OPTIMIZATION HANDLING */
+
+	// Constant folding
+
+	// Constants are folded in their flattened form: a scalar, vector or
+	// matrix is turned into its 32-bit scalar components (matrices going
+	// column by column), with bools stored as 0 or 1. Anything GLSL leaves
+	// undefined (integer division by zero, out-of-range shifts/conversions,
+	// sqrt of a negative, ...) is left alone and evaluated at runtime.
+
+	#define MUVGC_MAX_CONSTANT_COMPONENTS 16
+
+	enum muVGCScalarKind {
+		MUVGC_SCALAR_UNKNOWN=0,
+		MUVGC_SCALAR_BOOL,
+		MUVGC_SCALAR_INT,
+		MUVGC_SCALAR_UINT,
+		MUVGC_SCALAR_FLOAT
+	};
+	typedef enum muVGCScalarKind muVGCScalarKind;
+
+	struct muVGCConstant {
+		uint32_m type;
+		muVGCScalarKind kind;
+		// Column & row count (1 & 1 for scalars, 1 & n for vectors)
+		size_m columns;
+		size_m rows;
+		size_m len;
+		uint32_m words[MUVGC_MAX_CONSTANT_COMPONENTS];
+	};
+	typedef struct muVGCConstant muVGCConstant;
+
+	#define MUVGC_COMPONENT(c, i) (((c).len == 1) ? (c).words[0] : (c).words[i])
+	#define MUVGC_IS_NAN(w) (((w) & 0x7FFFFFFF) > 0x7F800000)
+	#define MUVGC_IS_INF(w) (((w) & 0x7FFFFFFF) == 0x7F800000)
+
+	float muVGC_word_to_float(uint32_m w) {
+		union { uint32_m w; float f; } u;
+		u.w = w;
+		return u.f;
+	}
+
+	uint32_m muVGC_float_to_word(float f) {
+		union { uint32_m w; float f; } u;
+		u.f = f;
+		return u.w;
+	}
+
+	muVGCScalarKind muVGC_get_scalar_kind(muVGCModule* module, uint32_m type) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+		if (inst == MU_NULL_PTR) {
+			return MUVGC_SCALAR_UNKNOWN;
+		}
+		muVGCOperand* operands = &module->operands[inst->operand_index];
+		switch (inst->opcode) {
+			default: return MUVGC_SCALAR_UNKNOWN; break;
+			case MUVGC_OP_TYPE_BOOL: return MUVGC_SCALAR_BOOL; break;
+			case MUVGC_OP_TYPE_INT: {
+				if (operands[0].word != 32) {
+					return MUVGC_SCALAR_UNKNOWN;
+				}
+				return (operands[1].word != 0) ? MUVGC_SCALAR_INT : MUVGC_SCALAR_UINT;
+			} break;
+			case MUVGC_OP_TYPE_FLOAT: {
+				return (operands[0].word == 32) ? MUVGC_SCALAR_FLOAT : MUVGC_SCALAR_UNKNOWN;
+			} break;
+		}
+	}
+
+	// Returns the scalar kind of a scalar, vector or matrix type and fills
+	// in its shape, or MUVGC_SCALAR_UNKNOWN if it can't be folded
+	muVGCScalarKind muVGC_get_type_shape(muVGCModule* module, uint32_m type, size_m* columns, size_m* rows) {
+		*columns = 1;
+		*rows = 1;
+		muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+		if (inst == MU_NULL_PTR) {
+			return MUVGC_SCALAR_UNKNOWN;
+		}
+		if (inst->opcode == MUVGC_OP_TYPE_MATRIX) {
+			*columns = module->operands[inst->operand_index+1].word;
+			type = module->operands[inst->operand_index].word;
+			inst = muVGC_module_get_definition(module, type);
+			if (inst == MU_NULL_PTR || inst->opcode != MUVGC_OP_TYPE_VECTOR) {
+				return MUVGC_SCALAR_UNKNOWN;
+			}
+		}
+		if (inst->opcode == MUVGC_OP_TYPE_VECTOR) {
+			*rows = module->operands[inst->operand_index+1].word;
+			type = module->operands[inst->operand_index].word;
+		}
+		return muVGC_get_scalar_kind(module, type);
+	}
+
+	// Reads a constant into its flattened form; returns MU_FALSE if the id
+	// isn't a (foldable) constant
+	muBool muVGC_fold_get_constant(muVGCModule* module, uint32_m id, muVGCConstant* c) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, id);
+		if (inst == MU_NULL_PTR || inst->active == MU_FALSE) {
+			return MU_FALSE;
+		}
+		switch (inst->opcode) {
+			default: return MU_FALSE; break;
+			case MUVGC_OP_CONSTANT_TRUE: case MUVGC_OP_CONSTANT_FALSE: case MUVGC_OP_CONSTANT:
+			case MUVGC_OP_CONSTANT_COMPOSITE: case MUVGC_OP_CONSTANT_NULL: break;
+		}
+
+		c->type = inst->result_type;
+		c->kind = muVGC_get_type_shape(module, c->type, &c->columns, &c->rows);
+		c->len = c->columns * c->rows;
+		if (c->kind == MUVGC_SCALAR_UNKNOWN || c->len > MUVGC_MAX_CONSTANT_COMPONENTS) {
+			return MU_FALSE;
+		}
+
+		size_m operand_index = inst->operand_index;
+		size_m operand_len = inst->operand_len;
+		switch (inst->opcode) {
+			default: break;
+			case MUVGC_OP_CONSTANT_TRUE: c->words[0] = 1; break;
+			case MUVGC_OP_CONSTANT_FALSE: c->words[0] = 0; break;
+			case MUVGC_OP_CONSTANT: {
+				if (operand_len != 1) {
+					return MU_FALSE;
+				}
+				c->words[0] = module->operands[operand_index].word;
+			} break;
+			case MUVGC_OP_CONSTANT_NULL: {
+				for (size_m i = 0; i < c->len; i++) {
+					c->words[i] = 0;
+				}
+			} break;
+			case MUVGC_OP_CONSTANT_COMPOSITE: {
+				size_m len = 0;
+				for (size_m i = 0; i < operand_len; i++) {
+					muVGCConstant part;
+					if (muVGC_fold_get_constant(module, module->operands[operand_index+i].word, &part) == MU_FALSE
+						|| len + part.len > c->len) {
+						return MU_FALSE;
+					}
+					for (size_m j = 0; j < part.len; j++) {
+						c->words[len+j] = part.words[j];
+					}
+					len += part.len;
+				}
+				if (len != c->len) {
+					return MU_FALSE;
+				}
+			} break;
+		}
+		return MU_TRUE;
+	}
+
+	// Declares (or finds) the constant of the given type holding 'words'
+	uint32_m muVGC_fold_make_constant(muVGCModule* module, uint32_m type, muVGCScalarKind kind, const uint32_m* words) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+		if (inst->opcode == MUVGC_OP_TYPE_VECTOR || inst->opcode == MUVGC_OP_TYPE_MATRIX) {
+			uint32_m element_type = module->operands[inst->operand_index].word;
+			size_m element_len = module->operands[inst->operand_index+1].word;
+			size_m columns, rows;
+			muVGC_get_type_shape(module, element_type, &columns, &rows);
+
+			uint32_m elements[MUVGC_MAX_CONSTANT_COMPONENTS];
+			for (size_m i = 0; i < element_len; i++) {
+				elements[i] = muVGC_fold_make_constant(module, element_type, kind, &words[i*columns*rows]);
+			}
+			return muVGC_get_composite_constant(module, type, elements, element_len);
+		}
+		if (kind == MUVGC_SCALAR_BOOL) {
+			return muVGC_get_bool_constant(module, (words[0] != 0) ? MU_TRUE : MU_FALSE);
 		}
+		return muVGC_get_scalar_constant(module, type, words[0]);
+	}
+
+	// Evaluates a component-wise SPIR-V operation on one component
+	muBool muVGC_fold_scalar(uint16_m opcode, uint32_m a, uint32_m b, uint32_m* r) {
+		int32_m sa = (int32_m)a, sb = (int32_m)b;
+		float fa = muVGC_word_to_float(a), fb = muVGC_word_to_float(b);
+		muBool nan = (MUVGC_IS_NAN(a) || MUVGC_IS_NAN(b)) ? MU_TRUE : MU_FALSE;
+
+		switch (opcode) {
+			default: return MU_FALSE; break;
+
+			// Arithmetic
+
+			case MUVGC_OP_S_NEGATE: *r = 0u - a; break;
+			case MUVGC_OP_F_NEGATE: *r = a ^ 0x80000000; break;
+			case MUVGC_OP_I_ADD: *r = a + b; break;
+			case MUVGC_OP_F_ADD: *r = muVGC_float_to_word(fa + fb); break;
+			case MUVGC_OP_I_SUB: *r = a - b; break;
+			case MUVGC_OP_F_SUB: *r = muVGC_float_to_word(fa - fb); break;
+			case MUVGC_OP_I_MUL: *r = a * b; break;
+			case MUVGC_OP_F_MUL: case MUVGC_OP_VECTOR_TIMES_SCALAR: case MUVGC_OP_MATRIX_TIMES_SCALAR: {
+				*r = muVGC_float_to_word(fa * fb);
+			} break;
+			case MUVGC_OP_U_DIV: {
+				if (b == 0) return MU_FALSE;
+				*r = a / b;
+			} break;
+			case MUVGC_OP_S_DIV: {
+				if (b == 0 || (a == 0x80000000 && sb == -1)) return MU_FALSE;
+				*r = (uint32_m)(sa / sb);
+			} break;
+			case MUVGC_OP_F_DIV: {
+				if (fb == 0.f) return MU_FALSE;
+				*r = muVGC_float_to_word(fa / fb);
+			} break;
+			case MUVGC_OP_U_MOD: {
+				if (b == 0) return MU_FALSE;
+				*r = a % b;
+			} break;
+			// (sign of the first operand)
+			case MUVGC_OP_S_REM: {
+				if (b == 0 || (a == 0x80000000 && sb == -1)) return MU_FALSE;
+				*r = (uint32_m)(sa % sb);
+			} break;
+			// (sign of the second operand)
+			case MUVGC_OP_S_MOD: {
+				if (b == 0 || (a == 0x80000000 && sb == -1)) return MU_FALSE;
+				int32_m rem = sa % sb;
+				if (rem != 0 && ((rem < 0) != (sb < 0))) {
+					rem += sb;
+				}
+				*r = (uint32_m)rem;
+			} break;
+			case MUVGC_OP_F_REM: {
+				if (fb == 0.f) return MU_FALSE;
+				*r = muVGC_float_to_word(mu_fmodf(fa, fb));
+			} break;
+			// (GLSL's mod: x - y * floor(x/y))
+			case MUVGC_OP_F_MOD: {
+				if (fb == 0.f) return MU_FALSE;
+				*r = muVGC_float_to_word(fa - fb * mu_floorf(fa / fb));
+			} break;
+
+			// Conversion
+
+			case MUVGC_OP_CONVERT_F_TO_U: {
+				if (!(fa > -1.f && fa < 4294967296.f)) return MU_FALSE;
+				*r = (uint32_m)fa;
+			} break;
+			case MUVGC_OP_CONVERT_F_TO_S: {
+				if (!(fa >= -2147483648.f && fa < 2147483648.f)) return MU_FALSE;
+				*r = (uint32_m)(int32_m)fa;
+			} break;
+			case MUVGC_OP_CONVERT_S_TO_F: *r = muVGC_float_to_word((float)sa); break;
+			case MUVGC_OP_CONVERT_U_TO_F: *r = muVGC_float_to_word((float)a); break;
+			case MUVGC_OP_BITCAST: *r = a; break;
+
+			// Relational & logical
+
+			case MUVGC_OP_IS_NAN: *r = MUVGC_IS_NAN(a); break;
+			case MUVGC_OP_IS_INF: *r = MUVGC_IS_INF(a); break;
+			case MUVGC_OP_LOGICAL_EQUAL: *r = ((a != 0) == (b != 0)); break;
+			case MUVGC_OP_LOGICAL_NOT_EQUAL: *r = ((a != 0) != (b != 0)); break;
+			case MUVGC_OP_LOGICAL_OR: *r = ((a != 0) || (b != 0)); break;
+			case MUVGC_OP_LOGICAL_AND: *r = ((a != 0) && (b != 0)); break;
+			case MUVGC_OP_LOGICAL_NOT: *r = (a == 0); break;
+			case MUVGC_OP_I_EQUAL: *r = (a == b); break;
+			case MUVGC_OP_I_NOT_EQUAL: *r = (a != b); break;
+			case MUVGC_OP_U_GREATER_THAN: *r = (a > b); break;
+			case MUVGC_OP_S_GREATER_THAN: *r = (sa > sb); break;
+			case MUVGC_OP_U_GREATER_THAN_EQUAL: *r = (a >= b); break;
+			case MUVGC_OP_S_GREATER_THAN_EQUAL: *r = (sa >= sb); break;
+			case MUVGC_OP_U_LESS_THAN: *r = (a < b); break;
+			case MUVGC_OP_S_LESS_THAN: *r = (sa < sb); break;
+			case MUVGC_OP_U_LESS_THAN_EQUAL: *r = (a <= b); break;
+			case MUVGC_OP_S_LESS_THAN_EQUAL: *r = (sa <= sb); break;
+			// (Ordered comparisons are false if either operand is NaN,
+			// unordered ones are true)
+			case MUVGC_OP_F_ORD_EQUAL: *r = (!nan && fa == fb); break;
+			case MUVGC_OP_F_UNORD_EQUAL: *r = (nan || fa == fb); break;
+			case MUVGC_OP_F_ORD_NOT_EQUAL: *r = (!nan && fa != fb); break;
+			case MUVGC_OP_F_UNORD_NOT_EQUAL: *r = (nan || fa != fb); break;
+			case MUVGC_OP_F_ORD_LESS_THAN: *r = (!nan && fa < fb); break;
+			case MUVGC_OP_F_UNORD_LESS_THAN: *r = (nan || fa < fb); break;
+			case MUVGC_OP_F_ORD_GREATER_THAN: *r = (!nan && fa > fb); break;
+			case MUVGC_OP_F_UNORD_GREATER_THAN: *r = (nan || fa > fb); break;
+			case MUVGC_OP_F_ORD_LESS_THAN_EQUAL: *r = (!nan && fa <= fb); break;
+			case MUVGC_OP_F_UNORD_LESS_THAN_EQUAL: *r = (nan || fa <= fb); break;
+			case MUVGC_OP_F_ORD_GREATER_THAN_EQUAL: *r = (!nan && fa >= fb); break;
+			case MUVGC_OP_F_UNORD_GREATER_THAN_EQUAL: *r = (nan || fa >= fb); break;
+
+			// Bit
+
+			case MUVGC_OP_SHIFT_RIGHT_LOGICAL: {
+				if (b >= 32) return MU_FALSE;
+				*r = a >> b;
+			} break;
+			case MUVGC_OP_SHIFT_RIGHT_ARITHMETIC: {
+				if (b >= 32) return MU_FALSE;
+				*r = a >> b;
+				if (sa < 0 && b != 0) {
+					*r |= ~(0xFFFFFFFFu >> b);
+				}
+			} break;
+			case MUVGC_OP_SHIFT_LEFT_LOGICAL: {
+				if (b >= 32) return MU_FALSE;
+				*r = a << b;
+			} break;
+			case MUVGC_OP_BITWISE_OR: *r = a | b; break;
+			case MUVGC_OP_BITWISE_XOR: *r = a ^ b; break;
+			case MUVGC_OP_BITWISE_AND: *r = a & b; break;
+			case MUVGC_OP_NOT: *r = ~a; break;
+		}
+		return MU_TRUE;
+	}
+
+	float muVGC_fold_dot(const muVGCConstant* x, const muVGCConstant* y) {
+		float sum = 0.f;
+		for (size_m i = 0; i < x->len; i++) {
+			sum += muVGC_word_to_float(x->words[i]) * muVGC_word_to_float(y->words[i]);
+		}
+		return sum;
+	}
+
+	float muVGC_fold_determinant(const float* m, size_m n) {
+		if (n == 1) {
+			return m[0];
+		}
+		// (Laplace expansion along the first column)
+		float det = 0.f;
+		float sign = 1.f;
+		float minor[9];
+		for (size_m row = 0; row < n; row++) {
+			size_m k = 0;
+			for (size_m c = 1; c < n; c++) {
+				for (size_m r = 0; r < n; r++) {
+					if (r != row) {
+						minor[k++] = m[c*n + r];
+					}
+				}
+			}
+			det += sign * m[row] * muVGC_fold_determinant(minor, n-1);
+			sign = -sign;
+		}
+		return det;
+	}
+
+	// GLSL.std.450 instruction numbers
+	enum muVGCGLSLStd450 {
+		MUVGC_GLSL_ROUND=1,
+		MUVGC_GLSL_ROUND_EVEN=2,
+		MUVGC_GLSL_TRUNC=3,
+		MUVGC_GLSL_F_ABS=4,
+		MUVGC_GLSL_S_ABS=5,
+		MUVGC_GLSL_F_SIGN=6,
+		MUVGC_GLSL_S_SIGN=7,
+		MUVGC_GLSL_FLOOR=8,
+		MUVGC_GLSL_CEIL=9,
+		MUVGC_GLSL_FRACT=10,
+		MUVGC_GLSL_RADIANS=11,
+		MUVGC_GLSL_DEGREES=12,
+		MUVGC_GLSL_SIN=13,
+		MUVGC_GLSL_COS=14,
+		MUVGC_GLSL_TAN=15,
+		MUVGC_GLSL_ASIN=16,
+		MUVGC_GLSL_ACOS=17,
+		MUVGC_GLSL_ATAN=18,
+		MUVGC_GLSL_SINH=19,
+		MUVGC_GLSL_COSH=20,
+		MUVGC_GLSL_TANH=21,
+		MUVGC_GLSL_ASINH=22,
+		MUVGC_GLSL_ACOSH=23,
+		MUVGC_GLSL_ATANH=24,
+		MUVGC_GLSL_ATAN2=25,
+		MUVGC_GLSL_POW=26,
+		MUVGC_GLSL_EXP=27,
+		MUVGC_GLSL_LOG=28,
+		MUVGC_GLSL_EXP2=29,
+		MUVGC_GLSL_LOG2=30,
+		MUVGC_GLSL_SQRT=31,
+		MUVGC_GLSL_INVERSE_SQRT=32,
+		MUVGC_GLSL_DETERMINANT=33,
+		MUVGC_GLSL_MODF=35,
+		MUVGC_GLSL_F_MIN=37,
+		MUVGC_GLSL_U_MIN=38,
+		MUVGC_GLSL_S_MIN=39,
+		MUVGC_GLSL_F_MAX=40,
+		MUVGC_GLSL_U_MAX=41,
+		MUVGC_GLSL_S_MAX=42,
+		MUVGC_GLSL_F_CLAMP=43,
+		MUVGC_GLSL_U_CLAMP=44,
+		MUVGC_GLSL_S_CLAMP=45,
+		MUVGC_GLSL_F_MIX=46,
+		MUVGC_GLSL_STEP=48,
+		MUVGC_GLSL_SMOOTH_STEP=49,
+		MUVGC_GLSL_FMA=50,
+		MUVGC_GLSL_FREXP=51,
+		MUVGC_GLSL_LDEXP=53,
+		MUVGC_GLSL_LENGTH=66,
+		MUVGC_GLSL_DISTANCE=67,
+		MUVGC_GLSL_CROSS=68,
+		MUVGC_GLSL_NORMALIZE=69,
+		MUVGC_GLSL_FACE_FORWARD=70,
+		MUVGC_GLSL_REFLECT=71,
+		MUVGC_GLSL_REFRACT=72
+	};
+	typedef enum muVGCGLSLStd450 muVGCGLSLStd450;
+
+	// Returns how many arguments a GLSL.std.450 instruction takes, or 0 if
+	// the folder doesn't understand it
+	size_m muVGC_glsl_std_450_argument_count(uint32_m instruction) {
+		switch (instruction) {
+			default: return 0; break;
+			case MUVGC_GLSL_ATAN2: case MUVGC_GLSL_POW: case MUVGC_GLSL_F_MIN: case MUVGC_GLSL_U_MIN:
+			case MUVGC_GLSL_S_MIN: case MUVGC_GLSL_F_MAX: case MUVGC_GLSL_U_MAX: case MUVGC_GLSL_S_MAX:
+			case MUVGC_GLSL_STEP: case MUVGC_GLSL_LDEXP: case MUVGC_GLSL_DISTANCE: case MUVGC_GLSL_CROSS:
+			case MUVGC_GLSL_REFLECT: {
+				return 2;
+			} break;
+			case MUVGC_GLSL_F_CLAMP: case MUVGC_GLSL_U_CLAMP: case MUVGC_GLSL_S_CLAMP: case MUVGC_GLSL_F_MIX:
+			case MUVGC_GLSL_SMOOTH_STEP: case MUVGC_GLSL_FMA: case MUVGC_GLSL_FACE_FORWARD: case MUVGC_GLSL_REFRACT: {
+				return 3;
+			} break;
+			case MUVGC_GLSL_ROUND: case MUVGC_GLSL_ROUND_EVEN: case MUVGC_GLSL_TRUNC: case MUVGC_GLSL_F_ABS:
+			case MUVGC_GLSL_S_ABS: case MUVGC_GLSL_F_SIGN: case MUVGC_GLSL_S_SIGN: case MUVGC_GLSL_FLOOR:
+			case MUVGC_GLSL_CEIL: case MUVGC_GLSL_FRACT: case MUVGC_GLSL_RADIANS: case MUVGC_GLSL_DEGREES:
+			case MUVGC_GLSL_SIN: case MUVGC_GLSL_COS: case MUVGC_GLSL_TAN: case MUVGC_GLSL_ASIN:
+			case MUVGC_GLSL_ACOS: case MUVGC_GLSL_ATAN: case MUVGC_GLSL_SINH: case MUVGC_GLSL_COSH:
+			case MUVGC_GLSL_TANH: case MUVGC_GLSL_ASINH: case MUVGC_GLSL_ACOSH: case MUVGC_GLSL_ATANH:
+			case MUVGC_GLSL_EXP: case MUVGC_GLSL_LOG: case MUVGC_GLSL_EXP2: case MUVGC_GLSL_LOG2:
+			case MUVGC_GLSL_SQRT: case MUVGC_GLSL_INVERSE_SQRT: case MUVGC_GLSL_DETERMINANT: case MUVGC_GLSL_LENGTH:
+			case MUVGC_GLSL_NORMALIZE: {
+				return 1;
+			} break;
+		}
+	}
+
+	// Evaluates a component-wise GLSL.std.450 instruction on one component
+	muBool muVGC_fold_glsl_std_450_scalar(uint32_m instruction, uint32_m a, uint32_m b, uint32_m c, uint32_m* r) {
+		float x = muVGC_word_to_float(a), y = muVGC_word_to_float(b), z = muVGC_word_to_float(c);
+		int32_m sa = (int32_m)a, sb = (int32_m)b, sc = (int32_m)c;
+		float f = 0.f;
+
+		switch (instruction) {
+			default: return MU_FALSE; break;
+
+			// (Integer results are written straight to 'r')
+			case MUVGC_GLSL_S_ABS: *r = (sa < 0) ? 0u - a : a; return MU_TRUE; break;
+			case MUVGC_GLSL_S_SIGN: *r = (uint32_m)((sa > 0) - (sa < 0)); return MU_TRUE; break;
+			case MUVGC_GLSL_U_MIN: *r = (b < a) ? b : a; return MU_TRUE; break;
+			case MUVGC_GLSL_S_MIN: *r = (sb < sa) ? b : a; return MU_TRUE; break;
+			case MUVGC_GLSL_U_MAX: *r = (a < b) ? b : a; return MU_TRUE; break;
+			case MUVGC_GLSL_S_MAX: *r = (sa < sb) ? b : a; return MU_TRUE; break;
+			case MUVGC_GLSL_U_CLAMP: {
+				if (b > c) return MU_FALSE;
+				*r = (a < b) ? b : ((a > c) ? c : a);
+				return MU_TRUE;
+			} break;
+			case MUVGC_GLSL_S_CLAMP: {
+				if (sb > sc) return MU_FALSE;
+				*r = (sa < sb) ? b : ((sa > sc) ? c : a);
+				return MU_TRUE;
+			} break;
+			case MUVGC_GLSL_F_ABS: *r = a & 0x7FFFFFFF; return MU_TRUE; break;
+
+			case MUVGC_GLSL_ROUND: f = mu_roundf(x); break;
+			case MUVGC_GLSL_ROUND_EVEN: {
+				f = mu_floorf(x);
+				float d = x - f;
+				if (d > .5f || (d == .5f && mu_fmodf(f, 2.f) != 0.f)) {
+					f += 1.f;
+				}
+			} break;
+			case MUVGC_GLSL_TRUNC: f = mu_truncf(x); break;
+			case MUVGC_GLSL_F_SIGN: f = (x > 0.f) ? 1.f : ((x < 0.f) ? -1.f : x); break;
+			case MUVGC_GLSL_FLOOR: f = mu_floorf(x); break;
+			case MUVGC_GLSL_CEIL: f = mu_ceilf(x); break;
+			case MUVGC_GLSL_FRACT: f = x - mu_floorf(x); break;
+			case MUVGC_GLSL_RADIANS: f = x * 0.017453292519943295f; break;
+			case MUVGC_GLSL_DEGREES: f = x * 57.29577951308232f; break;
+			case MUVGC_GLSL_SIN: f = mu_sinf(x); break;
+			case MUVGC_GLSL_COS: f = mu_cosf(x); break;
+			case MUVGC_GLSL_TAN: f = mu_tanf(x); break;
+			case MUVGC_GLSL_ASIN: {
+				if (!(x >= -1.f && x <= 1.f)) return MU_FALSE;
+				f = mu_asinf(x);
+			} break;
+			case MUVGC_GLSL_ACOS: {
+				if (!(x >= -1.f && x <= 1.f)) return MU_FALSE;
+				f = mu_acosf(x);
+			} break;
+			case MUVGC_GLSL_ATAN: f = mu_atanf(x); break;
+			case MUVGC_GLSL_SINH: f = mu_sinhf(x); break;
+			case MUVGC_GLSL_COSH: f = mu_coshf(x); break;
+			case MUVGC_GLSL_TANH: f = mu_tanhf(x); break;
+			case MUVGC_GLSL_ASINH: f = mu_asinhf(x); break;
+			case MUVGC_GLSL_ACOSH: {
+				if (!(x >= 1.f)) return MU_FALSE;
+				f = mu_acoshf(x);
+			} break;
+			case MUVGC_GLSL_ATANH: {
+				if (!(x > -1.f && x < 1.f)) return MU_FALSE;
+				f = mu_atanhf(x);
+			} break;
+			// (atan(y, x))
+			case MUVGC_GLSL_ATAN2: {
+				if (x == 0.f && y == 0.f) return MU_FALSE;
+				f = mu_atan2f(x, y);
+			} break;
+			case MUVGC_GLSL_POW: {
+				if (x < 0.f || (x == 0.f && y <= 0.f)) return MU_FALSE;
+				f = mu_powf(x, y);
+			} break;
+			case MUVGC_GLSL_EXP: f = mu_expf(x); break;
+			case MUVGC_GLSL_LOG: {
+				if (!(x > 0.f)) return MU_FALSE;
+				f = mu_logf(x);
+			} break;
+			case MUVGC_GLSL_EXP2: f = mu_exp2f(x); break;
+			case MUVGC_GLSL_LOG2: {
+				if (!(x > 0.f)) return MU_FALSE;
+				f = mu_log2f(x);
+			} break;
+			case MUVGC_GLSL_SQRT: {
+				if (!(x >= 0.f)) return MU_FALSE;
+				f = mu_sqrtf(x);
+			} break;
+			case MUVGC_GLSL_INVERSE_SQRT: {
+				if (!(x > 0.f)) return MU_FALSE;
+				f = 1.f / mu_sqrtf(x);
+			} break;
+			case MUVGC_GLSL_F_MIN: f = (y < x) ? y : x; break;
+			case MUVGC_GLSL_F_MAX: f = (x < y) ? y : x; break;
+			case MUVGC_GLSL_F_CLAMP: {
+				if (y > z) return MU_FALSE;
+				f = (x < y) ? y : x;
+				f = (z < f) ? z : f;
+			} break;
+			case MUVGC_GLSL_F_MIX: f = x * (1.f - z) + y * z; break;
+			// (step(edge, x))
+			case MUVGC_GLSL_STEP: f = (y < x) ? 0.f : 1.f; break;
+			case MUVGC_GLSL_SMOOTH_STEP: {
+				if (!(x < y)) return MU_FALSE;
+				float t = (z - x) / (y - x);
+				t = (t < 0.f) ? 0.f : ((t > 1.f) ? 1.f : t);
+				f = t * t * (3.f - 2.f * t);
+			} break;
+			case MUVGC_GLSL_FMA: f = mu_fmaf(x, y, z); break;
+			case MUVGC_GLSL_LDEXP: {
+				if (sb > 128 || sb < -126) return MU_FALSE;
+				f = mu_ldexpf(x, (int)sb);
+			} break;
+		}
+
+		*r = muVGC_float_to_word(f);
+		return MU_TRUE;
+	}
+
+	// Folds a GLSL.std.450 instruction into 'r' (whose type & shape is
+	// already set)
+	muBool muVGC_fold_glsl_std_450(uint32_m instruction, muVGCConstant* args, size_m arg_len, muVGCConstant* r) {
+		if (arg_len != muVGC_glsl_std_450_argument_count(instruction)) {
+			return MU_FALSE;
+		}
+		muVGCConstant* x = &args[0];
+
+		switch (instruction) {
+			// Component-wise
+			default: {
+				for (size_m i = 0; i < arg_len; i++) {
+					if (args[i].len != r->len && args[i].len != 1) {
+						return MU_FALSE;
+					}
+				}
+				for (size_m i = 0; i < r->len; i++) {
+					uint32_m a = MUVGC_COMPONENT(args[0], i);
+					uint32_m b = (arg_len > 1) ? MUVGC_COMPONENT(args[1], i) : 0;
+					uint32_m c = (arg_len > 2) ? MUVGC_COMPONENT(args[2], i) : 0;
+					if (muVGC_fold_glsl_std_450_scalar(instruction, a, b, c, &r->words[i]) == MU_FALSE) {
+						return MU_FALSE;
+					}
+				}
+			} break;
+
+			case MUVGC_GLSL_LENGTH: {
+				r->words[0] = muVGC_float_to_word(mu_sqrtf(muVGC_fold_dot(x, x)));
+			} break;
+			case MUVGC_GLSL_DISTANCE: {
+				if (args[1].len != x->len) return MU_FALSE;
+				muVGCConstant d = *x;
+				for (size_m i = 0; i < d.len; i++) {
+					d.words[i] = muVGC_float_to_word(muVGC_word_to_float(x->words[i]) - muVGC_word_to_float(args[1].words[i]));
+				}
+				r->words[0] = muVGC_float_to_word(mu_sqrtf(muVGC_fold_dot(&d, &d)));
+			} break;
+			case MUVGC_GLSL_CROSS: {
+				if (x->len != 3 || args[1].len != 3) return MU_FALSE;
+				float a[3], b[3];
+				for (size_m i = 0; i < 3; i++) {
+					a[i] = muVGC_word_to_float(x->words[i]);
+					b[i] = muVGC_word_to_float(args[1].words[i]);
+				}
+				r->words[0] = muVGC_float_to_word(a[1] * b[2] - b[1] * a[2]);
+				r->words[1] = muVGC_float_to_word(a[2] * b[0] - b[2] * a[0]);
+				r->words[2] = muVGC_float_to_word(a[0] * b[1] - b[0] * a[1]);
+			} break;
+			case MUVGC_GLSL_NORMALIZE: {
+				if (x->len != r->len) return MU_FALSE;
+				float length = mu_sqrtf(muVGC_fold_dot(x, x));
+				if (!(length > 0.f)) return MU_FALSE;
+				for (size_m i = 0; i < r->len; i++) {
+					r->words[i] = muVGC_float_to_word(muVGC_word_to_float(x->words[i]) / length);
+				}
+			} break;
+			// (faceforward(N, I, Nref))
+			case MUVGC_GLSL_FACE_FORWARD: {
+				if (x->len != r->len || args[1].len != r->len || args[2].len != r->len) return MU_FALSE;
+				muBool flip = (muVGC_fold_dot(&args[2], &args[1]) < 0.f) ? MU_FALSE : MU_TRUE;
+				for (size_m i = 0; i < r->len; i++) {
+					r->words[i] = (flip == MU_TRUE) ? (x->words[i] ^ 0x80000000) : x->words[i];
+				}
+			} break;
+			// (reflect(I, N))
+			case MUVGC_GLSL_REFLECT: {
+				if (x->len != r->len || args[1].len != r->len) return MU_FALSE;
+				float d = muVGC_fold_dot(&args[1], x);
+				for (size_m i = 0; i < r->len; i++) {
+					float n = muVGC_word_to_float(args[1].words[i]);
+					r->words[i] = muVGC_float_to_word(muVGC_word_to_float(x->words[i]) - 2.f * d * n);
+				}
+			} break;
+			// (refract(I, N, eta))
+			case MUVGC_GLSL_REFRACT: {
+				if (x->len != r->len || args[1].len != r->len || args[2].len != 1) return MU_FALSE;
+				float eta = muVGC_word_to_float(args[2].words[0]);
+				float d = muVGC_fold_dot(&args[1], x);
+				float k = 1.f - eta * eta * (1.f - d * d);
+				for (size_m i = 0; i < r->len; i++) {
+					if (k < 0.f) {
+						r->words[i] = muVGC_float_to_word(0.f);
+					} else {
+						float n = muVGC_word_to_float(args[1].words[i]);
+						r->words[i] = muVGC_float_to_word(eta * muVGC_word_to_float(x->words[i]) - (eta * d + mu_sqrtf(k)) * n);
+					}
+				}
+			} break;
+			case MUVGC_GLSL_DETERMINANT: {
+				if (x->columns != x->rows || x->columns > 4) return MU_FALSE;
+				float m[16];
+				for (size_m i = 0; i < x->len; i++) {
+					m[i] = muVGC_word_to_float(x->words[i]);
+				}
+				r->words[0] = muVGC_float_to_word(muVGC_fold_determinant(m, x->columns));
+			} break;
+		}
+		return MU_TRUE;
+	}
+
+	// Is an id the import of the GLSL.std.450 instruction set?
+	muBool muVGC_module_is_glsl_std_450(muVGCModule* module, uint32_m id) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, id);
+		if (inst == MU_NULL_PTR || inst->opcode != MUVGC_OP_EXT_INST_IMPORT) {
+			return MU_FALSE;
+		}
+		const char* name = "GLSL.std.450";
+		muVGCOperand* operands = &module->operands[inst->operand_index];
+		for (size_m i = 0; i <= 12; i++) {
+			if (i/4 >= inst->operand_len || ((operands[i/4].word >> ((i%4)*8)) & 0xFF) != (uint32_m)name[i]) {
+				return MU_FALSE;
+			}
+		}
+		return MU_TRUE;
+	}
+
+	// Walks literal composite indexes into a flattened constant of the
+	// given type, returning the offset & length of the indexed part
+	muBool muVGC_fold_walk_indexes(
+		muVGCModule* module, uint32_m type, const muVGCOperand* indexes, size_m index_len, size_m* offset, size_m* len) {
+
+		*offset = 0;
+		for (size_m i = 0; i < index_len; i++) {
+			muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+			if (inst == MU_NULL_PTR || (inst->opcode != MUVGC_OP_TYPE_VECTOR && inst->opcode != MUVGC_OP_TYPE_MATRIX)) {
+				return MU_FALSE;
+			}
+			type = module->operands[inst->operand_index].word;
+			if (indexes[i].word >= module->operands[inst->operand_index+1].word) {
+				return MU_FALSE;
+			}
+			size_m columns, rows;
+			muVGC_get_type_shape(module, type, &columns, &rows);
+			*offset += indexes[i].word * columns * rows;
+		}
+		size_m columns, rows;
+		if (muVGC_get_type_shape(module, type, &columns, &rows) == MUVGC_SCALAR_UNKNOWN) {
+			return MU_FALSE;
+		}
+		*len = columns * rows;
+		return MU_TRUE;
+	}
+
+	// Tries to fold an instruction; returns the id that can replace its
+	// result, or 0 if it can't be folded
+	uint32_m muVGC_fold_instruction(muVGCModule* module, size_m instruction) {
+		muVGCInstruction inst = module->instructions[instruction];
+		muVGCOperand* operands = &module->operands[inst.operand_index];
+
+		// Forwarding (doesn't need constant operands)
+
+		switch (inst.opcode) {
+			default: break;
+			case MUVGC_OP_COPY_OBJECT: return operands[0].word; break;
+			// (A phi whose incoming values are all the same value)
+			case MUVGC_OP_PHI: {
+				uint32_m value = 0;
+				for (size_m i = 0; i+1 < inst.operand_len; i += 2) {
+					if (operands[i].word == inst.result_id) continue;
+					if (value != 0 && operands[i].word != value) return 0;
+					value = operands[i].word;
+				}
+				return value;
+			} break;
+			// (A select on a constant scalar condition)
+			case MUVGC_OP_SELECT: {
+				muVGCConstant condition;
+				if (muVGC_fold_get_constant(module, operands[0].word, &condition) == MU_TRUE && condition.len == 1) {
+					return (condition.words[0] != 0) ? operands[1].word : operands[2].word;
+				}
+			} break;
+		}
+
+		// Folding
+
+		muVGCConstant r = { 0 };
+		r.type = inst.result_type;
+		r.kind = muVGC_get_type_shape(module, r.type, &r.columns, &r.rows);
+		r.len = r.columns * r.rows;
+		if (r.kind == MUVGC_SCALAR_UNKNOWN || r.len > MUVGC_MAX_CONSTANT_COMPONENTS) {
+			return 0;
+		}
+
+		// (Every id operand has to be a constant; OpExtInst's first operand
+		// is the instruction set)
+		muVGCConstant c[4] = { 0 };
+		size_m c_len = 0;
+		size_m first = (inst.opcode == MUVGC_OP_EXT_INST) ? 2 : 0;
+		if (inst.opcode == MUVGC_OP_EXT_INST && (inst.operand_len < 2 || muVGC_module_is_glsl_std_450(module, operands[0].word) == MU_FALSE)) {
+			return 0;
+		}
+		for (size_m i = first; i < inst.operand_len; i++) {
+			if (operands[i].is_id == MU_FALSE) continue;
+			if (c_len >= 4 || muVGC_fold_get_constant(module, operands[i].word, &c[c_len]) == MU_FALSE) {
+				return 0;
+			}
+			c_len++;
+		}
+
+		switch (inst.opcode) {
+			default: return 0; break;
+
+			// Component-wise unary
+			case MUVGC_OP_S_NEGATE: case MUVGC_OP_F_NEGATE: case MUVGC_OP_NOT: case MUVGC_OP_LOGICAL_NOT:
+			case MUVGC_OP_CONVERT_F_TO_U: case MUVGC_OP_CONVERT_F_TO_S: case MUVGC_OP_CONVERT_S_TO_F:
+			case MUVGC_OP_CONVERT_U_TO_F: case MUVGC_OP_BITCAST: case MUVGC_OP_IS_NAN: case MUVGC_OP_IS_INF: {
+				if (c_len != 1 || c[0].len != r.len) return 0;
+				for (size_m i = 0; i < r.len; i++) {
+					if (muVGC_fold_scalar(inst.opcode, c[0].words[i], 0, &r.words[i]) == MU_FALSE) return 0;
+				}
+			} break;
+
+			// Component-wise binary (the second operand can be a scalar for
+			// the *TimesScalar ops)
+			case MUVGC_OP_I_ADD: case MUVGC_OP_F_ADD: case MUVGC_OP_I_SUB: case MUVGC_OP_F_SUB: case MUVGC_OP_I_MUL:
+			case MUVGC_OP_F_MUL: case MUVGC_OP_U_DIV: case MUVGC_OP_S_DIV: case MUVGC_OP_F_DIV: case MUVGC_OP_U_MOD:
+			case MUVGC_OP_S_REM: case MUVGC_OP_S_MOD: case MUVGC_OP_F_REM: case MUVGC_OP_F_MOD:
+			case MUVGC_OP_VECTOR_TIMES_SCALAR: case MUVGC_OP_MATRIX_TIMES_SCALAR:
+			case MUVGC_OP_LOGICAL_EQUAL: case MUVGC_OP_LOGICAL_NOT_EQUAL: case MUVGC_OP_LOGICAL_OR: case MUVGC_OP_LOGICAL_AND:
+			case MUVGC_OP_I_EQUAL: case MUVGC_OP_I_NOT_EQUAL: case MUVGC_OP_U_GREATER_THAN: case MUVGC_OP_S_GREATER_THAN:
+			case MUVGC_OP_U_GREATER_THAN_EQUAL: case MUVGC_OP_S_GREATER_THAN_EQUAL: case MUVGC_OP_U_LESS_THAN:
+			case MUVGC_OP_S_LESS_THAN: case MUVGC_OP_U_LESS_THAN_EQUAL: case MUVGC_OP_S_LESS_THAN_EQUAL:
+			case MUVGC_OP_F_ORD_EQUAL: case MUVGC_OP_F_UNORD_EQUAL: case MUVGC_OP_F_ORD_NOT_EQUAL: case MUVGC_OP_F_UNORD_NOT_EQUAL:
+			case MUVGC_OP_F_ORD_LESS_THAN: case MUVGC_OP_F_UNORD_LESS_THAN: case MUVGC_OP_F_ORD_GREATER_THAN:
+			case MUVGC_OP_F_UNORD_GREATER_THAN: case MUVGC_OP_F_ORD_LESS_THAN_EQUAL: case MUVGC_OP_F_UNORD_LESS_THAN_EQUAL:
+			case MUVGC_OP_F_ORD_GREATER_THAN_EQUAL: case MUVGC_OP_F_UNORD_GREATER_THAN_EQUAL:
+			case MUVGC_OP_SHIFT_RIGHT_LOGICAL: case MUVGC_OP_SHIFT_RIGHT_ARITHMETIC: case MUVGC_OP_SHIFT_LEFT_LOGICAL:
+			case MUVGC_OP_BITWISE_OR: case MUVGC_OP_BITWISE_XOR: case MUVGC_OP_BITWISE_AND: {
+				if (c_len != 2 || c[0].len != r.len || (c[1].len != r.len && c[1].len != 1)) return 0;
+				for (size_m i = 0; i < r.len; i++) {
+					if (muVGC_fold_scalar(inst.opcode, c[0].words[i], MUVGC_COMPONENT(c[1], i), &r.words[i]) == MU_FALSE) return 0;
+				}
+			} break;
+
+			case MUVGC_OP_ANY: case MUVGC_OP_ALL: {
+				if (c_len != 1) return 0;
+				r.words[0] = (inst.opcode == MUVGC_OP_ALL);
+				for (size_m i = 0; i < c[0].len; i++) {
+					if ((c[0].words[i] != 0) != (inst.opcode == MUVGC_OP_ALL)) {
+						r.words[0] = !r.words[0];
+						break;
+					}
+				}
+			} break;
+
+			case MUVGC_OP_SELECT: {
+				if (c_len != 3 || c[0].len != r.len || c[1].len != r.len || c[2].len != r.len) return 0;
+				for (size_m i = 0; i < r.len; i++) {
+					r.words[i] = (c[0].words[i] != 0) ? c[1].words[i] : c[2].words[i];
+				}
+			} break;
+
+			// Linear algebra (matrices being column-major)
+
+			case MUVGC_OP_DOT: {
+				if (c_len != 2 || c[0].len != c[1].len) return 0;
+				r.words[0] = muVGC_float_to_word(muVGC_fold_dot(&c[0], &c[1]));
+			} break;
+			case MUVGC_OP_MATRIX_TIMES_VECTOR: {
+				if (c_len != 2 || c[1].len != c[0].columns || r.len != c[0].rows) return 0;
+				for (size_m row = 0; row < c[0].rows; row++) {
+					float sum = 0.f;
+					for (size_m col = 0; col < c[0].columns; col++) {
+						sum += muVGC_word_to_float(c[0].words[col*c[0].rows + row]) * muVGC_word_to_float(c[1].words[col]);
+					}
+					r.words[row] = muVGC_float_to_word(sum);
+				}
+			} break;
+			case MUVGC_OP_VECTOR_TIMES_MATRIX: {
+				if (c_len != 2 || c[0].len != c[1].rows || r.len != c[1].columns) return 0;
+				for (size_m col = 0; col < c[1].columns; col++) {
+					float sum = 0.f;
+					for (size_m row = 0; row < c[1].rows; row++) {
+						sum += muVGC_word_to_float(c[0].words[row]) * muVGC_word_to_float(c[1].words[col*c[1].rows + row]);
+					}
+					r.words[col] = muVGC_float_to_word(sum);
+				}
+			} break;
+			case MUVGC_OP_MATRIX_TIMES_MATRIX: {
+				if (c_len != 2 || c[0].columns != c[1].rows || r.columns != c[1].columns || r.rows != c[0].rows) return 0;
+				for (size_m col = 0; col < r.columns; col++) {
+					for (size_m row = 0; row < r.rows; row++) {
+						float sum = 0.f;
+						for (size_m k = 0; k < c[0].columns; k++) {
+							sum += muVGC_word_to_float(c[0].words[k*c[0].rows + row]) * muVGC_word_to_float(c[1].words[col*c[1].rows + k]);
+						}
+						r.words[col*r.rows + row] = muVGC_float_to_word(sum);
+					}
+				}
+			} break;
+			case MUVGC_OP_OUTER_PRODUCT: {
+				if (c_len != 2 || r.rows != c[0].len || r.columns != c[1].len) return 0;
+				for (size_m col = 0; col < r.columns; col++) {
+					for (size_m row = 0; row < r.rows; row++) {
+						r.words[col*r.rows + row] = muVGC_float_to_word(muVGC_word_to_float(c[0].words[row]) * muVGC_word_to_float(c[1].words[col]));
+					}
+				}
+			} break;
+			case MUVGC_OP_TRANSPOSE: {
+				if (c_len != 1 || r.columns != c[0].rows || r.rows != c[0].columns) return 0;
+				for (size_m col = 0; col < r.columns; col++) {
+					for (size_m row = 0; row < r.rows; row++) {
+						r.words[col*r.rows + row] = c[0].words[row*c[0].rows + col];
+					}
+				}
+			} break;
+
+			// Composites
+
+			case MUVGC_OP_COMPOSITE_CONSTRUCT: {
+				size_m len = 0;
+				for (size_m i = 0; i < c_len; i++) {
+					if (len + c[i].len > r.len) return 0;
+					for (size_m j = 0; j < c[i].len; j++) {
+						r.words[len+j] = c[i].words[j];
+					}
+					len += c[i].len;
+				}
+				if (len != r.len) return 0;
+			} break;
+			case MUVGC_OP_COMPOSITE_EXTRACT: {
+				size_m offset, len;
+				if (c_len != 1 || muVGC_fold_walk_indexes(module, c[0].type, &operands[1], inst.operand_len-1, &offset, &len) == MU_FALSE
+					|| len != r.len) return 0;
+				for (size_m i = 0; i < len; i++) {
+					r.words[i] = c[0].words[offset+i];
+				}
+			} break;
+			case MUVGC_OP_COMPOSITE_INSERT: {
+				size_m offset, len;
+				if (c_len != 2 || c[1].len != r.len
+					|| muVGC_fold_walk_indexes(module, c[1].type, &operands[2], inst.operand_len-2, &offset, &len) == MU_FALSE
+					|| len != c[0].len) return 0;
+				for (size_m i = 0; i < r.len; i++) {
+					r.words[i] = c[1].words[i];
+				}
+				for (size_m i = 0; i < len; i++) {
+					r.words[offset+i] = c[0].words[i];
+				}
+			} break;
+			case MUVGC_OP_VECTOR_SHUFFLE: {
+				if (c_len != 2 || inst.operand_len-2 != r.len) return 0;
+				for (size_m i = 0; i < r.len; i++) {
+					uint32_m index = operands[2+i].word;
+					if (index < c[0].len) {
+						r.words[i] = c[0].words[index];
+					} else if (index - c[0].len < c[1].len) {
+						r.words[i] = c[1].words[index - c[0].len];
+					} else {
+						// (Undefined component)
+						return 0;
+					}
+				}
+			} break;
+
+			case MUVGC_OP_EXT_INST: {
+				if (muVGC_fold_glsl_std_450(operands[1].word, c, c_len, &r) == MU_FALSE) return 0;
+			} break;
+		}
+
+		return muVGC_fold_make_constant(module, r.type, r.kind, r.words);
+	}
+
+	uint32_m muVGC_fold_resolve(uint32_m* replacements, uint32_m replacement_len, uint32_m id) {
+		while (id < replacement_len && replacements[id] != 0) {
+			id = replacements[id];
+		}
+		return id;
+	}
+
+	// Folds every instruction in every function whose result is known at
+	// compile time, replacing its uses with the folded constant. Since
+	// blocks are laid out in dominance order, operands are rewritten
+	// before their instruction is looked at, which propagates folded
+	// values forward in a single walk; only phis fed by back edges can
+	// need another walk.
+	void muVGC_fold_constants(muVGCModule* module) {
+		uint32_m replacement_len = module->bound;
+		uint32_m* replacements = mu_malloc(sizeof(uint32_m) * replacement_len);
+		for (uint32_m i = 0; i < replacement_len; i++) {
+			replacements[i] = 0;
+		}
+
+		muBool changed = MU_TRUE;
+		while (changed == MU_TRUE) {
+			changed = MU_FALSE;
+			for (size_m f = 0; f < module->function_len; f++) {
+				if (module->functions[f].active == MU_FALSE) continue;
+				for (size_m b = 0; b < module->functions[f].blocks.len; b++) {
+					muVGCBlock* block = &module->blocks[module->functions[f].blocks.indexes[b]];
+					for (size_m i = 0; i < block->instructions.len; i++) {
+						size_m index = block->instructions.indexes[i];
+						muVGCInstruction* inst = &module->instructions[index];
+						if (inst->active == MU_FALSE) continue;
+
+						muVGCOperand* operands = &module->operands[inst->operand_index];
+						for (size_m j = 0; j < inst->operand_len; j++) {
+							if (operands[j].is_id == MU_TRUE) {
+								operands[j].word = muVGC_fold_resolve(replacements, replacement_len, operands[j].word);
+							}
+						}
+						if (inst->result_id == 0 || inst->result_id >= replacement_len) continue;
+
+						uint32_m id = muVGC_fold_instruction(module, index);
+						// (Block pointers may have moved while declaring constants)
+						block = &module->blocks[module->functions[f].blocks.indexes[b]];
+						if (id != 0 && id != module->instructions[index].result_id) {
+							replacements[module->instructions[index].result_id] = id;
+							muVGC_module_remove_instruction(module, index);
+							changed = MU_TRUE;
+						}
+					}
+				}
+			}
+		}
+
+		// Names & decorations of folded ids go away with them
+		for (size_m s = MUVGC_SECTION_DEBUG_NAME; s <= MUVGC_SECTION_ANNOTATION; s++) {
+			for (size_m i = 0; i < module->sections[s].len; i++) {
+				muVGCInstruction* inst = &module->instructions[module->sections[s].indexes[i]];
+				muVGCOperand* operands = &module->operands[inst->operand_index];
+				if (inst->active == MU_TRUE && inst->operand_len != 0 && operands[0].is_id == MU_TRUE
+					&& operands[0].word < replacement_len && replacements[operands[0].word] != 0) {
+					muVGC_module_remove_instruction(module, module->sections[s].indexes[i]);
+				}
+			}
+		}
+
+		mu_free(replacements);
+	}
+
+	// Dead code elimination
+
+	// Does an instruction (within a function) do nothing besides producing
+	// its result? Pure instructions whose result is never used can be
+	// removed.
+	muBool muVGC_module_is_pure(muVGCModule* module, muVGCInstruction* inst) {
+		muVGCOperand* operands = &module->operands[inst->operand_index];
+		switch (inst->opcode) {
+			default: return MU_FALSE; break;
+
+			// (Volatile loads have to stay)
+			case MUVGC_OP_LOAD: {
+				return (inst->operand_len < 2 || (operands[1].word & 1) == 0) ? MU_TRUE : MU_FALSE;
+			} break;
+			// (Other instruction sets might have side effects, and modf/frexp
+			// write through a pointer)
+			case MUVGC_OP_EXT_INST: {
+				if (operands[1].word == MUVGC_GLSL_MODF || operands[1].word == MUVGC_GLSL_FREXP) {
+					return MU_FALSE;
+				}
+				return muVGC_module_is_glsl_std_450(module, operands[0].word);
+			} break;
+
+			case MUVGC_OP_UNDEF: case MUVGC_OP_VARIABLE: case MUVGC_OP_ACCESS_CHAIN: case MUVGC_OP_IN_BOUNDS_ACCESS_CHAIN:
+			case MUVGC_OP_VECTOR_SHUFFLE: case MUVGC_OP_COMPOSITE_CONSTRUCT: case MUVGC_OP_COMPOSITE_EXTRACT:
+			case MUVGC_OP_COMPOSITE_INSERT: case MUVGC_OP_COPY_OBJECT: case MUVGC_OP_TRANSPOSE:
+			case MUVGC_OP_CONVERT_F_TO_U: case MUVGC_OP_CONVERT_F_TO_S: case MUVGC_OP_CONVERT_S_TO_F:
+			case MUVGC_OP_CONVERT_U_TO_F: case MUVGC_OP_BITCAST:
+			case MUVGC_OP_S_NEGATE: case MUVGC_OP_F_NEGATE: case MUVGC_OP_I_ADD: case MUVGC_OP_F_ADD: case MUVGC_OP_I_SUB:
+			case MUVGC_OP_F_SUB: case MUVGC_OP_I_MUL: case MUVGC_OP_F_MUL: case MUVGC_OP_U_DIV: case MUVGC_OP_S_DIV:
+			case MUVGC_OP_F_DIV: case MUVGC_OP_U_MOD: case MUVGC_OP_S_REM: case MUVGC_OP_S_MOD: case MUVGC_OP_F_REM:
+			case MUVGC_OP_F_MOD: case MUVGC_OP_VECTOR_TIMES_SCALAR: case MUVGC_OP_MATRIX_TIMES_SCALAR:
+			case MUVGC_OP_VECTOR_TIMES_MATRIX: case MUVGC_OP_MATRIX_TIMES_VECTOR: case MUVGC_OP_MATRIX_TIMES_MATRIX:
+			case MUVGC_OP_OUTER_PRODUCT: case MUVGC_OP_DOT: case MUVGC_OP_ANY: case MUVGC_OP_ALL:
+			case MUVGC_OP_IS_NAN: case MUVGC_OP_IS_INF:
+			case MUVGC_OP_LOGICAL_EQUAL: case MUVGC_OP_LOGICAL_NOT_EQUAL: case MUVGC_OP_LOGICAL_OR: case MUVGC_OP_LOGICAL_AND:
+			case MUVGC_OP_LOGICAL_NOT: case MUVGC_OP_SELECT:
+			case MUVGC_OP_I_EQUAL: case MUVGC_OP_I_NOT_EQUAL: case MUVGC_OP_U_GREATER_THAN: case MUVGC_OP_S_GREATER_THAN:
+			case MUVGC_OP_U_GREATER_THAN_EQUAL: case MUVGC_OP_S_GREATER_THAN_EQUAL: case MUVGC_OP_U_LESS_THAN:
+			case MUVGC_OP_S_LESS_THAN: case MUVGC_OP_U_LESS_THAN_EQUAL: case MUVGC_OP_S_LESS_THAN_EQUAL:
+			case MUVGC_OP_F_ORD_EQUAL: case MUVGC_OP_F_UNORD_EQUAL: case MUVGC_OP_F_ORD_NOT_EQUAL: case MUVGC_OP_F_UNORD_NOT_EQUAL:
+			case MUVGC_OP_F_ORD_LESS_THAN: case MUVGC_OP_F_UNORD_LESS_THAN: case MUVGC_OP_F_ORD_GREATER_THAN:
+			case MUVGC_OP_F_UNORD_GREATER_THAN: case MUVGC_OP_F_ORD_LESS_THAN_EQUAL: case MUVGC_OP_F_UNORD_LESS_THAN_EQUAL:
+			case MUVGC_OP_F_ORD_GREATER_THAN_EQUAL: case MUVGC_OP_F_UNORD_GREATER_THAN_EQUAL:
+			case MUVGC_OP_SHIFT_RIGHT_LOGICAL: case MUVGC_OP_SHIFT_RIGHT_ARITHMETIC: case MUVGC_OP_SHIFT_LEFT_LOGICAL:
+			case MUVGC_OP_BITWISE_OR: case MUVGC_OP_BITWISE_XOR: case MUVGC_OP_BITWISE_AND: case MUVGC_OP_NOT:
+			case MUVGC_OP_PHI: {
+				return MU_TRUE;
+			} break;
+		}
+	}
+
+	// Is an instruction only there to describe another one?
+	muBool muVGC_opcode_is_debug_or_annotation(uint16_m opcode) {
+		return (opcode == MUVGC_OP_NAME || opcode == MUVGC_OP_MEMBER_NAME
+			|| opcode == MUVGC_OP_DECORATE || opcode == MUVGC_OP_MEMBER_DECORATE) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Removes function/private variables that are only ever stored to,
+	// along with their stores
+	void muVGC_remove_write_only_variables(muVGCModule* module) {
+		muVGCUses uses;
+		muVGC_module_compute_uses(module, &uses);
+
+		for (size_m i = 0; i < module->instruction_len; i++) {
+			muVGCInstruction* inst = &module->instructions[i];
+			if (inst->active == MU_FALSE || inst->opcode != MUVGC_OP_VARIABLE || inst->operand_len < 1) continue;
+			uint32_m storage_class = module->operands[inst->operand_index].word;
+			if (storage_class != MUVGC_STORAGE_CLASS_FUNCTION && storage_class != MUVGC_STORAGE_CLASS_PRIVATE) continue;
+
+			uint32_m variable = inst->result_id;
+			muBool write_only = MU_TRUE;
+			for (size_m u = uses.first[variable]; u < uses.first[variable+1]; u++) {
+				muVGCInstruction* use = &module->instructions[uses.instructions[u]];
+				muVGCOperand* operands = &module->operands[use->operand_index];
+				if (muVGC_opcode_is_debug_or_annotation(use->opcode) == MU_TRUE) continue;
+				if (use->opcode == MUVGC_OP_STORE && operands[0].word == variable && operands[1].word != variable) continue;
+				write_only = MU_FALSE;
+				break;
+			}
+			if (write_only == MU_FALSE) continue;
+
+			for (size_m u = uses.first[variable]; u < uses.first[variable+1]; u++) {
+				if (module->instructions[uses.instructions[u]].opcode == MUVGC_OP_STORE) {
+					muVGC_module_remove_instruction(module, uses.instructions[u]);
+				}
+			}
+			muVGC_module_remove_instruction(module, i);
+		}
+
+		muVGC_free_uses(&uses);
+	}
+
+	void muVGC_dce_mark(muVGCModule* module, muBool* live, size_m* worklist, size_m* worklist_len, size_m instruction) {
+		if (live[instruction] == MU_FALSE && module->instructions[instruction].active == MU_TRUE) {
+			live[instruction] = MU_TRUE;
+			worklist[*worklist_len] = instruction;
+			*worklist_len += 1;
+		}
+	}
+
+	void muVGC_dce_mark_id(muVGCModule* module, muBool* live, size_m* worklist, size_m* worklist_len, uint32_m id) {
+		if (id < module->allocated_definition_len && module->definitions[id] != 0) {
+			muVGC_dce_mark(module, live, worklist, worklist_len, module->definitions[id]-1);
+		}
+	}
+
+	// Removes everything the entry points can't reach: uncalled functions,
+	// unreferenced types, constants, global variables and instruction set
+	// imports, pure instructions whose results are unused, and the names &
+	// decorations of anything removed.
+	// Capabilities & extensions that only the types a module declares need
+	// (scalars of other widths, 16- and 8-bit storage, the StorageBuffer
+	// storage class) are declared along with the types, and dropped here
+	// once none of those types are left
+
+	struct muVGCTypeRequirements {
+		uint32_m capabilities[16];
+		size_m capability_len;
+		muBool storage_buffer;
+		muBool storage16;
+		muBool storage8;
+	};
+	typedef struct muVGCTypeRequirements muVGCTypeRequirements;
+
+	void muVGC_add_type_requirement(muVGCTypeRequirements* requirements, uint32_m capability) {
+		for (size_m i = 0; i < requirements->capability_len; i++) {
+			if (requirements->capabilities[i] == capability) {
+				return;
+			}
+		}
+		requirements->capabilities[requirements->capability_len] = capability;
+		requirements->capability_len += 1;
+	}
+
+	muBool muVGC_is_type_capability(uint32_m capability) {
+		switch (capability) {
+			default: return MU_FALSE; break;
+			case MUVGC_CAPABILITY_FLOAT16: case MUVGC_CAPABILITY_FLOAT64: case MUVGC_CAPABILITY_INT64:
+			case MUVGC_CAPABILITY_INT16: case MUVGC_CAPABILITY_INT8:
+			case MUVGC_CAPABILITY_STORAGE_BUFFER_16BIT_ACCESS: case MUVGC_CAPABILITY_UNIFORM_AND_STORAGE_BUFFER_16BIT_ACCESS:
+			case MUVGC_CAPABILITY_STORAGE_PUSH_CONSTANT_16: case MUVGC_CAPABILITY_STORAGE_INPUT_OUTPUT_16:
+			case MUVGC_CAPABILITY_STORAGE_BUFFER_8BIT_ACCESS: case MUVGC_CAPABILITY_UNIFORM_AND_STORAGE_BUFFER_8BIT_ACCESS:
+			case MUVGC_CAPABILITY_STORAGE_PUSH_CONSTANT_8: {
+				return MU_TRUE;
+			} break;
+		}
+	}
+
+	void muVGC_remove_unused_type_requirements(muVGCModule* module) {
+		muVGCTypeRequirements requirements = { 0 };
+		muVGCIndexList* globals = &module->sections[MUVGC_SECTION_GLOBAL];
+		for (size_m i = 0; i < globals->len; i++) {
+			muVGCInstruction* inst = &module->instructions[globals->indexes[i]];
+			if (inst->active == MU_FALSE) continue;
+			muVGCOperand* operands = &module->operands[inst->operand_index];
+			switch (inst->opcode) {
+				default: break;
+				case MUVGC_OP_TYPE_INT: {
+					uint32_m width = operands[0].word;
+					if (width != 32) {
+						muVGC_add_type_requirement(&requirements, (width == 8) ? MUVGC_CAPABILITY_INT8 : (width == 16) ? MUVGC_CAPABILITY_INT16 : MUVGC_CAPABILITY_INT64);
+					}
+				} break;
+				case MUVGC_OP_TYPE_FLOAT: {
+					uint32_m width = operands[0].word;
+					if (width != 32) {
+						muVGC_add_type_requirement(&requirements, (width == 16) ? MUVGC_CAPABILITY_FLOAT16 : MUVGC_CAPABILITY_FLOAT64);
+					}
+				} break;
+				case MUVGC_OP_TYPE_POINTER: {
+					if (operands[0].word == MUVGC_STORAGE_CLASS_STORAGE_BUFFER) {
+						requirements.storage_buffer = MU_TRUE;
+					}
+					uint32_m capability16, capability8;
+					muVGC_get_storage_capabilities(module, operands[0].word, operands[1].word, &capability16, &capability8);
+					if (capability16 != 0) {
+						muVGC_add_type_requirement(&requirements, capability16);
+						requirements.storage16 = MU_TRUE;
+					}
+					if (capability8 != 0) {
+						muVGC_add_type_requirement(&requirements, capability8);
+						requirements.storage8 = MU_TRUE;
+					}
+				} break;
+			}
+		}
+
+		muVGCIndexList* capabilities = &module->sections[MUVGC_SECTION_CAPABILITY];
+		for (size_m i = 0; i < capabilities->len; i++) {
+			muVGCInstruction* inst = &module->instructions[capabilities->indexes[i]];
+			if (inst->active == MU_FALSE) continue;
+			uint32_m capability = module->operands[inst->operand_index].word;
+			if (muVGC_is_type_capability(capability) == MU_FALSE) continue;
+			muBool needed = MU_FALSE;
+			for (size_m j = 0; j < requirements.capability_len; j++) {
+				if (requirements.capabilities[j] == capability) {
+					needed = MU_TRUE;
+				}
+			}
+			if (needed == MU_FALSE) {
+				muVGC_module_remove_instruction(module, capabilities->indexes[i]);
+			}
+		}
+
+		muVGCIndexList* extensions = &module->sections[MUVGC_SECTION_EXTENSION];
+		for (size_m i = 0; i < extensions->len; i++) {
+			size_m extension = extensions->indexes[i];
+			if (module->instructions[extension].active == MU_FALSE) continue;
+			if (
+				(requirements.storage_buffer == MU_FALSE && muVGC_module_string_operand_equals(module, extension, 0, "SPV_KHR_storage_buffer_storage_class", 36) == MU_TRUE) ||
+				(requirements.storage16 == MU_FALSE && muVGC_module_string_operand_equals(module, extension, 0, "SPV_KHR_16bit_storage", 21) == MU_TRUE) ||
+				(requirements.storage8 == MU_FALSE && muVGC_module_string_operand_equals(module, extension, 0, "SPV_KHR_8bit_storage", 20) == MU_TRUE)
+			) {
+				muVGC_module_remove_instruction(module, extension);
+			}
+		}
+	}
+
+	void muVGC_eliminate_dead_code(muVGCModule* module) {
+		muVGC_remove_write_only_variables(module);
+
+		muBool* live = mu_malloc(sizeof(muBool) * (module->instruction_len+1));
+		size_m* worklist = mu_malloc(sizeof(size_m) * (module->instruction_len+1));
+		size_m worklist_len = 0;
+		for (size_m i = 0; i < module->instruction_len; i++) {
+			live[i] = MU_FALSE;
+		}
+
+		// Roots: mode-setting & source instructions (the entry points
+		// being what pulls in the functions)
+		for (size_m s = MUVGC_SECTION_FIRST; s <= MUVGC_SECTION_DEBUG_SOURCE; s++) {
+			if (s == MUVGC_SECTION_EXT_INST_IMPORT) continue;
+			for (size_m i = 0; i < module->sections[s].len; i++) {
+				muVGC_dce_mark(module, live, worklist, &worklist_len, module->sections[s].indexes[i]);
+			}
+		}
+		// (A WorkgroupSize built-in sets the local size just by existing)
+		muVGC_dce_mark_id(module, live, worklist, &worklist_len, muVGC_find_built_in(module, MUVGC_BUILT_IN_WORKGROUP_SIZE));
+
+		while (worklist_len > 0) {
+			worklist_len -= 1;
+			size_m index = worklist[worklist_len];
+			muVGCInstruction* inst = &module->instructions[index];
+
+			// Whatever it refers to is live
+			muVGC_dce_mark_id(module, live, worklist, &worklist_len, inst->result_type);
+			muVGCOperand* operands = &module->operands[inst->operand_index];
+			for (size_m i = 0; i < inst->operand_len; i++) {
+				if (operands[i].is_id == MU_TRUE) {
+					muVGC_dce_mark_id(module, live, worklist, &worklist_len, operands[i].word);
+				}
+			}
+
+			// A live function keeps its parameters, labels and everything in
+			// it that has side effects
+			if (inst->opcode != MUVGC_OP_FUNCTION) continue;
+			for (size_m f = 0; f < module->function_len; f++) {
+				muVGCFunction* function = &module->functions[f];
+				if (function->instruction != index) continue;
+				for (size_m p = 0; p < function->parameters.len; p++) {
+					muVGC_dce_mark(module, live, worklist, &worklist_len, function->parameters.indexes[p]);
+				}
+				for (size_m b = 0; b < function->blocks.len; b++) {
+					muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+					muVGC_dce_mark(module, live, worklist, &worklist_len, block->label);
+					for (size_m i = 0; i < block->instructions.len; i++) {
+						size_m j = block->instructions.indexes[i];
+						if (muVGC_module_is_pure(module, &module->instructions[j]) == MU_FALSE) {
+							muVGC_dce_mark(module, live, worklist, &worklist_len, j);
+						}
+					}
+				}
+				break;
+			}
+		}
+
+		// Sweep
+
+		for (size_m f = 0; f < module->function_len; f++) {
+			muVGCFunction* function = &module->functions[f];
+			if (function->active == MU_FALSE) continue;
+			if (live[function->instruction] == MU_FALSE) {
+				function->active = MU_FALSE;
+				muVGC_module_remove_instruction(module, function->instruction);
+				for (size_m p = 0; p < function->parameters.len; p++) {
+					muVGC_module_remove_instruction(module, function->parameters.indexes[p]);
+				}
+			}
+			for (size_m b = 0; b < function->blocks.len; b++) {
+				muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+				if (live[block->label] == MU_FALSE) {
+					muVGC_module_remove_instruction(module, block->label);
+				}
+				for (size_m i = 0; i < block->instructions.len; i++) {
+					if (live[block->instructions.indexes[i]] == MU_FALSE) {
+						muVGC_module_remove_instruction(module, block->instructions.indexes[i]);
+					}
+				}
+			}
+		}
+
+		for (size_m s = MUVGC_SECTION_FIRST; s < MUVGC_SECTION_FUNCTION; s++) {
+			muVGCIndexList* section = &module->sections[s];
+			for (size_m i = 0; i < section->len; i++) {
+				muVGCInstruction* inst = &module->instructions[section->indexes[i]];
+				if (inst->active == MU_FALSE) continue;
+
+				if (s == MUVGC_SECTION_DEBUG_NAME || s == MUVGC_SECTION_ANNOTATION) {
+					// (Names & decorations live as long as their target)
+					muVGCOperand* operands = &module->operands[inst->operand_index];
+					uint32_m target = (inst->operand_len != 0) ? operands[0].word : 0;
+					if (target >= module->allocated_definition_len || module->definitions[target] == 0
+						|| live[module->definitions[target]-1] == MU_FALSE) {
+						muVGC_module_remove_instruction(module, section->indexes[i]);
+					}
+				} else if (live[section->indexes[i]] == MU_FALSE) {
+					muVGC_module_remove_instruction(module, section->indexes[i]);
+				}
+			}
+		}
+		muVGC_remove_unused_type_requirements(module);
+
+		mu_free(worklist);
+		mu_free(live);
+	}
+
+	// Control flow
+
+	#define MUVGC_NO_BLOCK ((size_m)-1)
+
+	// The control flow graph of one function; blocks are referred to by
+	// their position in the function's block list
+	struct muVGCCFG {
+		size_m block_len;
+		muVGCIndexList* successors;
+		muVGCIndexList* predecessors;
+		// Immediate dominator of each block (the entry block being its own,
+		// unreachable blocks having MUVGC_NO_BLOCK)
+		size_m* idom;
+		// Reachable blocks in reverse postorder, and each block's position
+		// in it
+		size_m* order;
+		size_m order_len;
+		size_m* order_index;
+	};
+	typedef struct muVGCCFG muVGCCFG;
+
+	// Returns the last active instruction of a block, or MU_NULL_PTR
+	muVGCInstruction* muVGC_block_get_terminator(muVGCModule* module, muVGCBlock* block) {
+		for (size_m i = block->instructions.len; i > 0; i--) {
+			muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i-1]];
+			if (inst->active == MU_TRUE) {
+				return inst;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Returns the position of the block with the given label within a
+	// function, or MUVGC_NO_BLOCK
+	size_m muVGC_function_find_block(muVGCModule* module, muVGCFunction* function, uint32_m label) {
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			if (module->instructions[module->blocks[function->blocks.indexes[b]].label].result_id == label) {
+				return b;
+			}
+		}
+		return MUVGC_NO_BLOCK;
+	}
+
+	size_m muVGC_cfg_intersect(muVGCCFG* cfg, size_m a, size_m b) {
+		while (a != b) {
+			while (cfg->order_index[a] > cfg->order_index[b]) a = cfg->idom[a];
+			while (cfg->order_index[b] > cfg->order_index[a]) b = cfg->idom[b];
+		}
+		return a;
+	}
+
+	void muVGC_compute_cfg(muVGCModule* module, size_m function_index, muVGCCFG* cfg) {
+		muVGCFunction* function = &module->functions[function_index];
+		size_m n = function->blocks.len;
+		cfg->block_len = n;
+		cfg->successors = mu_malloc(sizeof(muVGCIndexList) * (n+1));
+		cfg->predecessors = mu_malloc(sizeof(muVGCIndexList) * (n+1));
+		cfg->idom = mu_malloc(sizeof(size_m) * (n+1));
+		cfg->order = mu_malloc(sizeof(size_m) * (n+1));
+		cfg->order_index = mu_malloc(sizeof(size_m) * (n+1));
+		cfg->order_len = 0;
+		for (size_m b = 0; b < n; b++) {
+			muVGCIndexList empty = { 0 };
+			cfg->successors[b] = empty;
+			cfg->predecessors[b] = empty;
+			cfg->idom[b] = MUVGC_NO_BLOCK;
+			cfg->order_index[b] = MUVGC_NO_BLOCK;
+		}
+
+		// Edges (any label a terminator refers to is a successor)
+		for (size_m b = 0; b < n; b++) {
+			muVGCInstruction* terminator = muVGC_block_get_terminator(module, &module->blocks[function->blocks.indexes[b]]);
+			if (terminator == MU_NULL_PTR) continue;
+			muVGCOperand* operands = &module->operands[terminator->operand_index];
+			for (size_m i = 0; i < terminator->operand_len; i++) {
+				if (operands[i].is_id == MU_FALSE) continue;
+				size_m s = muVGC_function_find_block(module, function, operands[i].word);
+				if (s == MUVGC_NO_BLOCK) continue;
+				// (A switch can list the same target more than once)
+				muBool duplicate = MU_FALSE;
+				for (size_m j = 0; j < cfg->successors[b].len; j++) {
+					if (cfg->successors[b].indexes[j] == s) duplicate = MU_TRUE;
+				}
+				if (duplicate == MU_FALSE) {
+					muVGC_index_list_add(&cfg->successors[b], s);
+					muVGC_index_list_add(&cfg->predecessors[s], b);
+				}
+			}
+		}
+		if (n == 0) return;
+
+		// Postorder (iterative DFS from the entry block), then reversed
+		size_m* stack = mu_malloc(sizeof(size_m) * (n+1));
+		size_m* next_child = mu_malloc(sizeof(size_m) * (n+1));
+		muBool* visited = mu_malloc(sizeof(muBool) * (n+1));
+		for (size_m b = 0; b < n; b++) {
+			visited[b] = MU_FALSE;
+			next_child[b] = 0;
+		}
+		size_m stack_len = 1;
+		stack[0] = 0;
+		visited[0] = MU_TRUE;
+		while (stack_len > 0) {
+			size_m b = stack[stack_len-1];
+			if (next_child[b] < cfg->successors[b].len) {
+				size_m s = cfg->successors[b].indexes[next_child[b]++];
+				if (visited[s] == MU_FALSE) {
+					visited[s] = MU_TRUE;
+					stack[stack_len++] = s;
+				}
+			} else {
+				cfg->order[cfg->order_len++] = b;
+				stack_len--;
+			}
+		}
+		for (size_m i = 0; i < cfg->order_len/2; i++) {
+			size_m t = cfg->order[i];
+			cfg->order[i] = cfg->order[cfg->order_len-1-i];
+			cfg->order[cfg->order_len-1-i] = t;
+		}
+		for (size_m i = 0; i < cfg->order_len; i++) {
+			cfg->order_index[cfg->order[i]] = i;
+		}
+		mu_free(visited);
+		mu_free(next_child);
+		mu_free(stack);
+
+		// Dominators ("A Simple, Fast Dominance Algorithm"; Cooper, Harvey
+		// & Kennedy)
+		cfg->idom[0] = 0;
+		muBool changed = MU_TRUE;
+		while (changed == MU_TRUE) {
+			changed = MU_FALSE;
+			for (size_m i = 1; i < cfg->order_len; i++) {
+				size_m b = cfg->order[i];
+				size_m new_idom = MUVGC_NO_BLOCK;
+				for (size_m p = 0; p < cfg->predecessors[b].len; p++) {
+					size_m pred = cfg->predecessors[b].indexes[p];
+					if (cfg->idom[pred] == MUVGC_NO_BLOCK) continue;
+					new_idom = (new_idom == MUVGC_NO_BLOCK) ? pred : muVGC_cfg_intersect(cfg, pred, new_idom);
+				}
+				if (cfg->idom[b] != new_idom) {
+					cfg->idom[b] = new_idom;
+					changed = MU_TRUE;
+				}
+			}
+		}
+	}
+
+	void muVGC_free_cfg(muVGCCFG* cfg) {
+		for (size_m b = 0; b < cfg->block_len; b++) {
+			muVGC_index_list_free(&cfg->successors[b]);
+			muVGC_index_list_free(&cfg->predecessors[b]);
+		}
+		mu_free(cfg->successors);
+		mu_free(cfg->predecessors);
+		mu_free(cfg->idom);
+		mu_free(cfg->order);
+		mu_free(cfg->order_index);
+	}
+
+	// Does block 'a' dominate block 'b'?
+	muBool muVGC_cfg_dominates(muVGCCFG* cfg, size_m a, size_m b) {
+		if (cfg->idom[b] == MUVGC_NO_BLOCK) {
+			return MU_FALSE;
+		}
+		while (b != a) {
+			if (b == 0) {
+				return MU_FALSE;
+			}
+			b = cfg->idom[b];
+		}
+		return MU_TRUE;
+	}
+
+	// Common subexpression elimination
+
+	// Global value numbering over the dominator tree: every pure
+	// instruction is hashed on its opcode, result type and (already
+	// numbered) operands, and replaced by an identical instruction from a
+	// dominating position if there is one. Loads only match loads in the
+	// same block with nothing in between that could write memory; every
+	// instruction with side effects (stores, calls, atomics, image writes,
+	// barriers, ...) starts a new memory epoch, so loads, atomics and
+	// image accesses are never reordered across each other.
+
+	muBool muVGC_opcode_is_commutative(uint16_m opcode) {
+		switch (opcode) {
+			default: return MU_FALSE; break;
+			case MUVGC_OP_I_ADD: case MUVGC_OP_F_ADD: case MUVGC_OP_I_MUL: case MUVGC_OP_F_MUL: case MUVGC_OP_DOT:
+			case MUVGC_OP_LOGICAL_EQUAL: case MUVGC_OP_LOGICAL_NOT_EQUAL: case MUVGC_OP_LOGICAL_OR: case MUVGC_OP_LOGICAL_AND:
+			case MUVGC_OP_I_EQUAL: case MUVGC_OP_I_NOT_EQUAL: case MUVGC_OP_F_ORD_EQUAL: case MUVGC_OP_F_UNORD_EQUAL:
+			case MUVGC_OP_F_ORD_NOT_EQUAL: case MUVGC_OP_F_UNORD_NOT_EQUAL:
+			case MUVGC_OP_BITWISE_OR: case MUVGC_OP_BITWISE_XOR: case MUVGC_OP_BITWISE_AND: {
+				return MU_TRUE;
+			} break;
+		}
+	}
+
+	struct muVGCValueEntry {
+		size_m instruction;
+		uint32_m hash;
+		// (Memory epoch for loads, 0 otherwise)
+		size_m epoch;
+		// Next entry in the same bucket, +1
+		size_m next;
+	};
+	typedef struct muVGCValueEntry muVGCValueEntry;
+
+	struct muVGCValueTable {
+		muVGCModule* module;
+		muVGCFunction* function;
+		muVGCCFG* cfg;
+		// Dominator tree children of each block
+		muVGCIndexList* children;
+
+		// First entry of each bucket, +1
+		size_m* buckets;
+		size_m bucket_len;
+		// (Used as a stack so that leaving a dominator subtree pops exactly
+		// what was pushed in it)
+		muVGCValueEntry* entries;
+		size_m entry_len;
+
+		uint32_m* replacements;
+		uint32_m replacement_len;
+		size_m epoch;
+	};
+	typedef struct muVGCValueTable muVGCValueTable;
+
+	uint32_m muVGC_hash_instruction(muVGCModule* module, muVGCInstruction* inst, size_m epoch) {
+		uint32_m hash = 2166136261u;
+		uint32_m words[3] = { inst->opcode, inst->result_type, (uint32_m)epoch };
+		for (size_m i = 0; i < 3; i++) {
+			hash = (hash ^ words[i]) * 16777619u;
+		}
+		muVGCOperand* operands = &module->operands[inst->operand_index];
+		for (size_m i = 0; i < inst->operand_len; i++) {
+			hash = (hash ^ operands[i].word) * 16777619u;
+		}
+		return hash;
+	}
+
+	muBool muVGC_instructions_match(muVGCModule* module, muVGCInstruction* a, muVGCInstruction* b) {
+		if (a->opcode != b->opcode || a->result_type != b->result_type || a->operand_len != b->operand_len) {
+			return MU_FALSE;
+		}
+		muVGCOperand* a_operands = &module->operands[a->operand_index];
+		muVGCOperand* b_operands = &module->operands[b->operand_index];
+		for (size_m i = 0; i < a->operand_len; i++) {
+			if (a_operands[i].word != b_operands[i].word) {
+				return MU_FALSE;
+			}
+		}
+		return MU_TRUE;
+	}
+
+	void muVGC_cse_block(muVGCValueTable* table, size_m b) {
+		muVGCModule* module = table->module;
+		muVGCBlock* block = &module->blocks[table->function->blocks.indexes[b]];
+		size_m entry_start = table->entry_len;
+		table->epoch += 1;
+
+		for (size_m i = 0; i < block->instructions.len; i++) {
+			size_m index = block->instructions.indexes[i];
+			muVGCInstruction* inst = &module->instructions[index];
+			if (inst->active == MU_FALSE) continue;
+
+			muVGCOperand* operands = &module->operands[inst->operand_index];
+			for (size_m j = 0; j < inst->operand_len; j++) {
+				if (operands[j].is_id == MU_TRUE && operands[j].word < table->replacement_len
+					&& table->replacements[operands[j].word] != 0) {
+					operands[j].word = table->replacements[operands[j].word];
+				}
+			}
+
+			if (muVGC_module_is_pure(module, inst) == MU_FALSE) {
+				table->epoch += 1;
+				continue;
+			}
+			if (inst->result_id == 0 || inst->opcode == MUVGC_OP_VARIABLE || inst->opcode == MUVGC_OP_PHI || inst->opcode == MUVGC_OP_UNDEF) {
+				continue;
+			}
+			if (muVGC_opcode_is_commutative(inst->opcode) == MU_TRUE && inst->operand_len == 2 && operands[0].word > operands[1].word) {
+				muVGCOperand t = operands[0];
+				operands[0] = operands[1];
+				operands[1] = t;
+			}
+
+			size_m epoch = (inst->opcode == MUVGC_OP_LOAD) ? table->epoch : 0;
+			uint32_m hash = muVGC_hash_instruction(module, inst, epoch);
+			size_m bucket = hash & (table->bucket_len-1);
+
+			muBool found = MU_FALSE;
+			for (size_m e = table->buckets[bucket]; e != 0; e = table->entries[e-1].next) {
+				muVGCValueEntry* entry = &table->entries[e-1];
+				muVGCInstruction* other = &module->instructions[entry->instruction];
+				if (entry->hash == hash && entry->epoch == epoch && muVGC_instructions_match(module, inst, other) == MU_TRUE) {
+					// (The value kept stands in for both, so it can only stay
+					// relaxed precision if both were)
+					size_m relaxed = muVGC_find_decoration(module, other->result_id, MUVGC_DECORATION_RELAXED_PRECISION);
+					if (relaxed != MUVGC_NO_DECORATION && muVGC_find_decoration(module, inst->result_id, MUVGC_DECORATION_RELAXED_PRECISION) == MUVGC_NO_DECORATION) {
+						muVGC_module_remove_instruction(module, relaxed);
+					}
+					table->replacements[inst->result_id] = other->result_id;
+					muVGC_module_remove_instruction(module, index);
+					found = MU_TRUE;
+					break;
+				}
+			}
+			if (found == MU_TRUE) continue;
+
+			muVGCValueEntry entry;
+			entry.instruction = index;
+			entry.hash = hash;
+			entry.epoch = epoch;
+			entry.next = table->buckets[bucket];
+			table->entries[table->entry_len] = entry;
+			table->entry_len += 1;
+			table->buckets[bucket] = table->entry_len;
+		}
+
+		for (size_m c = 0; c < table->children[b].len; c++) {
+			muVGC_cse_block(table, table->children[b].indexes[c]);
+		}
+
+		// Leave the scope
+		while (table->entry_len > entry_start) {
+			table->entry_len -= 1;
+			muVGCValueEntry* entry = &table->entries[table->entry_len];
+			table->buckets[entry->hash & (table->bucket_len-1)] = entry->next;
+		}
+	}
+
+	void muVGC_eliminate_common_subexpressions(muVGCModule* module) {
+		muVGCValueTable table = { 0 };
+		table.module = module;
+		table.replacement_len = module->bound;
+		table.replacements = mu_malloc(sizeof(uint32_m) * table.replacement_len);
+		for (uint32_m i = 0; i < table.replacement_len; i++) {
+			table.replacements[i] = 0;
+		}
+
+		for (size_m f = 0; f < module->function_len; f++) {
+			muVGCFunction* function = &module->functions[f];
+			if (function->active == MU_FALSE || function->blocks.len == 0) continue;
+			table.function = function;
+
+			muVGCCFG cfg;
+			muVGC_compute_cfg(module, f, &cfg);
+			table.cfg = &cfg;
+			table.children = mu_malloc(sizeof(muVGCIndexList) * cfg.block_len);
+			size_m instruction_len = 0;
+			for (size_m b = 0; b < cfg.block_len; b++) {
+				muVGCIndexList empty = { 0 };
+				table.children[b] = empty;
+				instruction_len += module->blocks[function->blocks.indexes[b]].instructions.len;
+			}
+			for (size_m i = 1; i < cfg.order_len; i++) {
+				muVGC_index_list_add(&table.children[cfg.idom[cfg.order[i]]], cfg.order[i]);
+			}
+
+			table.bucket_len = 16;
+			while (table.bucket_len < instruction_len*2) {
+				table.bucket_len *= 2;
+			}
+			table.buckets = mu_malloc(sizeof(size_m) * table.bucket_len);
+			for (size_m i = 0; i < table.bucket_len; i++) {
+				table.buckets[i] = 0;
+			}
+			table.entries = mu_malloc(sizeof(muVGCValueEntry) * (instruction_len+1));
+			table.entry_len = 0;
+
+			muVGC_cse_block(&table, 0);
+
+			// Uses the dominator walk didn't reach (phis fed from later blocks)
+			for (size_m b = 0; b < function->blocks.len; b++) {
+				muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+				for (size_m i = 0; i < block->instructions.len; i++) {
+					muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+					muVGCOperand* operands = &module->operands[inst->operand_index];
+					for (size_m j = 0; j < inst->operand_len; j++) {
+						if (operands[j].is_id == MU_TRUE && operands[j].word < table.replacement_len
+							&& table.replacements[operands[j].word] != 0) {
+							operands[j].word = table.replacements[operands[j].word];
+						}
+					}
+				}
+			}
+
+			mu_free(table.entries);
+			mu_free(table.buckets);
+			for (size_m b = 0; b < cfg.block_len; b++) {
+				muVGC_index_list_free(&table.children[b]);
+			}
+			mu_free(table.children);
+			muVGC_free_cfg(&cfg);
+		}
+
+		mu_free(table.replacements);
+	}
+
+	// Local variable promotion (mem2reg)
+
+	// Function variables that are only ever loaded from & stored to
+	// directly are turned into SSA values: phis are placed on the iterated
+	// dominance frontier of every block storing to a variable, then a walk
+	// over the dominator tree replaces each load with the value currently
+	// reaching it. Loads with no store before them read OpUndef. Phis that
+	// end up unused are left for dead code elimination.
+
+	struct muVGCPromotion {
+		muVGCModule* module;
+		muVGCFunction* function;
+		muVGCCFG* cfg;
+		muVGCIndexList* children;
+
+		// Promoted variables: id, value type, and the stack of values
+		// currently reaching the walk
+		size_m variable_len;
+		uint32_m* variables;
+		uint32_m* types;
+		muVGCIndexList* values;
+		// Promoted variable of each id, +1
+		size_m* variable_of;
+		uint32_m variable_of_len;
+
+		// Phis of each block, and the variable of each phi
+		muVGCIndexList* phis;
+		muVGCIndexList* phi_variables;
+
+		// Which variable each push went to (popped when leaving a dominator
+		// subtree)
+		muVGCIndexList pushes;
+
+		uint32_m* replacements;
+		uint32_m replacement_len;
+	};
+	typedef struct muVGCPromotion muVGCPromotion;
+
+	// Returns the promoted variable an id is, +1
+	size_m muVGC_promotion_get_variable(muVGCPromotion* p, uint32_m id) {
+		return (id < p->variable_of_len) ? p->variable_of[id] : 0;
+	}
+
+	void muVGC_promotion_push(muVGCPromotion* p, size_m variable, uint32_m value) {
+		muVGC_index_list_add(&p->values[variable], value);
+		muVGC_index_list_add(&p->pushes, variable);
+	}
+
+	uint32_m muVGC_promotion_top(muVGCPromotion* p, size_m variable) {
+		if (p->values[variable].len == 0) {
+			return muVGC_get_undef(p->module, p->types[variable]);
+		}
+		return (uint32_m)p->values[variable].indexes[p->values[variable].len-1];
+	}
+
+	uint32_m muVGC_promotion_resolve(muVGCPromotion* p, uint32_m id) {
+		while (id < p->replacement_len && p->replacements[id] != 0) {
+			id = p->replacements[id];
+		}
+		return id;
+	}
+
+	void muVGC_promotion_rename(muVGCPromotion* p, size_m b) {
+		muVGCModule* module = p->module;
+		size_m push_start = p->pushes.len;
+
+		for (size_m i = 0; i < p->phis[b].len; i++) {
+			size_m phi = p->phis[b].indexes[i];
+			muVGC_promotion_push(p, p->phi_variables[b].indexes[i], module->instructions[phi].result_id);
+		}
+
+		muVGCBlock* block = &module->blocks[p->function->blocks.indexes[b]];
+		for (size_m i = 0; i < block->instructions.len; i++) {
+			size_m index = block->instructions.indexes[i];
+			muVGCInstruction* inst = &module->instructions[index];
+			if (inst->active == MU_FALSE) continue;
+			muVGCOperand* operands = &module->operands[inst->operand_index];
+			for (size_m j = 0; j < inst->operand_len; j++) {
+				if (operands[j].is_id == MU_TRUE) {
+					operands[j].word = muVGC_promotion_resolve(p, operands[j].word);
+				}
+			}
+
+			switch (inst->opcode) {
+				default: break;
+				case MUVGC_OP_VARIABLE: {
+					size_m variable = muVGC_promotion_get_variable(p, inst->result_id);
+					if (variable == 0) break;
+					// (Initializer)
+					if (inst->operand_len > 1) {
+						muVGC_promotion_push(p, variable-1, operands[1].word);
+					}
+					muVGC_module_remove_instruction(module, index);
+				} break;
+				case MUVGC_OP_LOAD: {
+					size_m variable = muVGC_promotion_get_variable(p, operands[0].word);
+					if (variable == 0) break;
+					uint32_m result_id = inst->result_id;
+					uint32_m value = muVGC_promotion_top(p, variable-1);
+					p->replacements[result_id] = value;
+					muVGC_module_remove_instruction(module, index);
+				} break;
+				case MUVGC_OP_STORE: {
+					size_m variable = muVGC_promotion_get_variable(p, operands[0].word);
+					if (variable == 0) break;
+					muVGC_promotion_push(p, variable-1, operands[1].word);
+					muVGC_module_remove_instruction(module, index);
+				} break;
+			}
+		}
+
+		// Feed the successors' phis
+		uint32_m label = module->instructions[block->label].result_id;
+		for (size_m s = 0; s < p->cfg->successors[b].len; s++) {
+			size_m successor = p->cfg->successors[b].indexes[s];
+			for (size_m i = 0; i < p->phis[successor].len; i++) {
+				size_m phi = p->phis[successor].indexes[i];
+				uint32_m value = muVGC_promotion_top(p, p->phi_variables[successor].indexes[i]);
+				muVGCOperand value_operand = MUVGC_ID(value);
+				muVGCOperand label_operand = MUVGC_ID(label);
+				muVGC_module_add_operand(module, phi, value_operand);
+				muVGC_module_add_operand(module, phi, label_operand);
+			}
+		}
+
+		for (size_m c = 0; c < p->children[b].len; c++) {
+			muVGC_promotion_rename(p, p->children[b].indexes[c]);
+		}
+
+		while (p->pushes.len > push_start) {
+			p->pushes.len -= 1;
+			p->values[p->pushes.indexes[p->pushes.len]].len -= 1;
+		}
+	}
+
+	void muVGC_promote_function_variables(muVGCModule* module, size_m function_index, muVGCUses* uses) {
+		muVGCFunction* function = &module->functions[function_index];
+		if (function->blocks.len == 0) return;
+		muVGCCFG cfg;
+		muVGC_compute_cfg(module, function_index, &cfg);
+
+		muVGCPromotion p = { 0 };
+		p.module = module;
+		p.function = function;
+		p.cfg = &cfg;
+
+		// Find promotable variables (all declared in the entry block)
+
+		muVGCBlock* entry = &module->blocks[function->blocks.indexes[0]];
+		p.variable_of_len = module->bound;
+		p.variable_of = mu_malloc(sizeof(size_m) * p.variable_of_len);
+		for (uint32_m i = 0; i < p.variable_of_len; i++) {
+			p.variable_of[i] = 0;
+		}
+		p.variables = mu_malloc(sizeof(uint32_m) * (entry->instructions.len+1));
+		p.types = mu_malloc(sizeof(uint32_m) * (entry->instructions.len+1));
+
+		for (size_m i = 0; i < entry->instructions.len; i++) {
+			muVGCInstruction* inst = &module->instructions[entry->instructions.indexes[i]];
+			if (inst->active == MU_FALSE || inst->opcode != MUVGC_OP_VARIABLE
+				|| module->operands[inst->operand_index].word != MUVGC_STORAGE_CLASS_FUNCTION) continue;
+			muVGCInstruction* pointer = muVGC_module_get_definition(module, inst->result_type);
+			if (pointer == MU_NULL_PTR || pointer->opcode != MUVGC_OP_TYPE_POINTER) continue;
+
+			uint32_m variable = inst->result_id;
+			muBool promotable = MU_TRUE;
+			for (size_m u = uses->first[variable]; u < uses->first[variable+1]; u++) {
+				muVGCInstruction* use = &module->instructions[uses->instructions[u]];
+				muVGCOperand* operands = &module->operands[use->operand_index];
+				if (use->active == MU_FALSE || muVGC_opcode_is_debug_or_annotation(use->opcode) == MU_TRUE) continue;
+				if (use->opcode == MUVGC_OP_LOAD && operands[0].word == variable
+					&& (use->operand_len < 2 || (operands[1].word & 1) == 0)) continue;
+				if (use->opcode == MUVGC_OP_STORE && operands[0].word == variable && operands[1].word != variable
+					&& (use->operand_len < 3 || (operands[2].word & 1) == 0)) continue;
+				promotable = MU_FALSE;
+				break;
+			}
+			if (promotable == MU_FALSE) continue;
+
+			p.variables[p.variable_len] = variable;
+			p.types[p.variable_len] = module->operands[pointer->operand_index+1].word;
+			p.variable_len += 1;
+			p.variable_of[variable] = p.variable_len;
+		}
+
+		// Loads & stores in unreachable blocks would be left dangling
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			if (cfg.idom[b] != MUVGC_NO_BLOCK) continue;
+			muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+			for (size_m i = 0; i < block->instructions.len; i++) {
+				muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+				if (inst->active == MU_TRUE && (inst->opcode == MUVGC_OP_LOAD || inst->opcode == MUVGC_OP_STORE)
+					&& inst->operand_len != 0) {
+					size_m variable = muVGC_promotion_get_variable(&p, module->operands[inst->operand_index].word);
+					if (variable != 0) {
+						p.variable_of[p.variables[variable-1]] = 0;
+					}
+				}
+			}
+		}
+
+		muBool any = MU_FALSE;
+		for (size_m v = 0; v < p.variable_len; v++) {
+			if (p.variable_of[p.variables[v]] != 0) any = MU_TRUE;
+		}
+
+		if (any == MU_TRUE) {
+			size_m n = cfg.block_len;
+
+			// Dominance frontiers
+			muVGCIndexList* frontiers = mu_malloc(sizeof(muVGCIndexList) * n);
+			p.children = mu_malloc(sizeof(muVGCIndexList) * n);
+			p.phis = mu_malloc(sizeof(muVGCIndexList) * n);
+			for (size_m b = 0; b < n; b++) {
+				muVGCIndexList empty = { 0 };
+				frontiers[b] = empty;
+				p.children[b] = empty;
+				p.phis[b] = empty;
+			}
+			for (size_m i = 1; i < cfg.order_len; i++) {
+				muVGC_index_list_add(&p.children[cfg.idom[cfg.order[i]]], cfg.order[i]);
+			}
+			for (size_m b = 0; b < n; b++) {
+				if (cfg.idom[b] == MUVGC_NO_BLOCK || cfg.predecessors[b].len < 2) continue;
+				for (size_m i = 0; i < cfg.predecessors[b].len; i++) {
+					size_m runner = cfg.predecessors[b].indexes[i];
+					if (cfg.idom[runner] == MUVGC_NO_BLOCK) continue;
+					while (runner != cfg.idom[b]) {
+						muBool listed = MU_FALSE;
+						for (size_m j = 0; j < frontiers[runner].len; j++) {
+							if (frontiers[runner].indexes[j] == b) listed = MU_TRUE;
+						}
+						if (listed == MU_FALSE) {
+							muVGC_index_list_add(&frontiers[runner], b);
+						}
+						runner = cfg.idom[runner];
+					}
+				}
+			}
+
+			// Phi placement
+			size_m* has_phi = mu_malloc(sizeof(size_m) * n);
+			size_m* in_worklist = mu_malloc(sizeof(size_m) * n);
+			size_m* worklist = mu_malloc(sizeof(size_m) * n);
+			for (size_m b = 0; b < n; b++) {
+				has_phi[b] = 0;
+				in_worklist[b] = 0;
+			}
+			p.phi_variables = mu_malloc(sizeof(muVGCIndexList) * n);
+			for (size_m b = 0; b < n; b++) {
+				muVGCIndexList empty = { 0 };
+				p.phi_variables[b] = empty;
+			}
+			for (size_m v = 0; v < p.variable_len; v++) {
+				if (p.variable_of[p.variables[v]] == 0) continue;
+				size_m worklist_len = 0;
+				for (size_m b = 0; b < n; b++) {
+					if (cfg.idom[b] == MUVGC_NO_BLOCK) continue;
+					muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+					for (size_m i = 0; i < block->instructions.len; i++) {
+						muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+						if (inst->active == MU_TRUE && inst->opcode == MUVGC_OP_STORE
+							&& module->operands[inst->operand_index].word == p.variables[v]) {
+							in_worklist[b] = v+1;
+							worklist[worklist_len++] = b;
+							break;
+						}
+					}
+				}
+				while (worklist_len > 0) {
+					size_m b = worklist[--worklist_len];
+					for (size_m i = 0; i < frontiers[b].len; i++) {
+						size_m d = frontiers[b].indexes[i];
+						if (has_phi[d] == v+1) continue;
+						has_phi[d] = v+1;
+						muVGC_index_list_add(&p.phi_variables[d], v);
+						if (in_worklist[d] != v+1) {
+							in_worklist[d] = v+1;
+							worklist[worklist_len++] = d;
+						}
+					}
+				}
+			}
+			for (size_m b = 0; b < n; b++) {
+				for (size_m i = 0; i < p.phi_variables[b].len; i++) {
+					size_m v = p.phi_variables[b].indexes[i];
+					uint32_m phi_id = muVGC_module_new_id(module);
+					size_m phi = muVGC_module_add_instruction(module, MUVGC_OP_PHI, p.types[v], phi_id, MU_NULL_PTR, 0);
+					muVGC_index_list_insert(&module->blocks[function->blocks.indexes[b]].instructions, phi, i);
+					muVGC_index_list_add(&p.phis[b], phi);
+					// (A phi standing in for a relaxed precision variable is
+					// relaxed too)
+					if (muVGC_find_decoration(module, p.variables[v], MUVGC_DECORATION_RELAXED_PRECISION) != MUVGC_NO_DECORATION) {
+						muVGC_op_decorate(module, phi_id, MUVGC_DECORATION_RELAXED_PRECISION);
+					}
+				}
+			}
+
+			// Renaming
+			p.values = mu_malloc(sizeof(muVGCIndexList) * p.variable_len);
+			for (size_m v = 0; v < p.variable_len; v++) {
+				muVGCIndexList empty = { 0 };
+				p.values[v] = empty;
+			}
+			p.replacement_len = module->bound;
+			p.replacements = mu_malloc(sizeof(uint32_m) * p.replacement_len);
+			for (uint32_m i = 0; i < p.replacement_len; i++) {
+				p.replacements[i] = 0;
+			}
+			muVGC_promotion_rename(&p, 0);
+
+			for (size_m b = 0; b < function->blocks.len; b++) {
+				muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+				for (size_m i = 0; i < block->instructions.len; i++) {
+					muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+					muVGCOperand* operands = &module->operands[inst->operand_index];
+					for (size_m j = 0; j < inst->operand_len; j++) {
+						if (operands[j].is_id == MU_TRUE) {
+							operands[j].word = muVGC_promotion_resolve(&p, operands[j].word);
+						}
+					}
+				}
+			}
+
+			mu_free(p.replacements);
+			for (size_m v = 0; v < p.variable_len; v++) {
+				muVGC_index_list_free(&p.values[v]);
+			}
+			mu_free(p.values);
+			for (size_m b = 0; b < n; b++) {
+				muVGC_index_list_free(&frontiers[b]);
+				muVGC_index_list_free(&p.children[b]);
+				muVGC_index_list_free(&p.phis[b]);
+				muVGC_index_list_free(&p.phi_variables[b]);
+			}
+			mu_free(p.phi_variables);
+			mu_free(worklist);
+			mu_free(in_worklist);
+			mu_free(has_phi);
+			mu_free(frontiers);
+			mu_free(p.children);
+			mu_free(p.phis);
+			muVGC_index_list_free(&p.pushes);
+		}
+
+		mu_free(p.types);
+		mu_free(p.variables);
+		mu_free(p.variable_of);
+		muVGC_free_cfg(&cfg);
+	}
+
+	void muVGC_promote_variables(muVGCModule* module) {
+		muVGCUses uses;
+		muVGC_module_compute_uses(module, &uses);
+		for (size_m f = 0; f < module->function_len; f++) {
+			if (module->functions[f].active == MU_TRUE) {
+				muVGC_promote_function_variables(module, f, &uses);
+			}
+		}
+		muVGC_free_uses(&uses);
+	}
+
+	// Function inlining
+
+	// A call is inlined by splitting its block in two at the call and
+	// placing a copy of the callee's blocks (with fresh ids) in between,
+	// the callee's return becoming a branch to the second half. Callees
+	// marked Inline are always inlined; callees marked DontInline never
+	// are; anything else is inlined if it's small or only called once.
+	// Functions are handled callees-first, so a callee has already had
+	// its own calls inlined by the time it gets copied.
+
+	// Callees with at most this many instructions are inlined unless
+	// they're marked DontInline
+	#ifndef MUVGC_INLINE_THRESHOLD
+		#define MUVGC_INLINE_THRESHOLD 32
+	#endif
+
+	struct muVGCInliner {
+		muVGCModule* module;
+		// 0 if unvisited, 1 if being visited, 2 if visited
+		uint8_m* state;
+		// Can the function end up calling itself?
+		muBool* recursive;
+		// Number of places each function is called from
+		size_m* call_counts;
+		// Functions in callees-first order
+		size_m* order;
+		size_m order_len;
+	};
+	typedef struct muVGCInliner muVGCInliner;
+
+	// Returns the function defined by an id, or module->function_len if
+	// there is none
+	size_m muVGC_module_find_function(muVGCModule* module, uint32_m id) {
+		for (size_m f = 0; f < module->function_len; f++) {
+			if (module->functions[f].active == MU_TRUE && module->instructions[module->functions[f].instruction].result_id == id) {
+				return f;
+			}
+		}
+		return module->function_len;
+	}
+
+	void muVGC_inline_visit(muVGCInliner* inliner, size_m f) {
+		muVGCModule* module = inliner->module;
+		muVGCFunction* function = &module->functions[f];
+		inliner->state[f] = 1;
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+			for (size_m i = 0; i < block->instructions.len; i++) {
+				muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+				if (inst->active == MU_FALSE || inst->opcode != MUVGC_OP_FUNCTION_CALL) continue;
+				size_m callee = muVGC_module_find_function(module, module->operands[inst->operand_index].word);
+				if (callee == module->function_len) continue;
+				inliner->call_counts[callee] += 1;
+				if (inliner->state[callee] == 1) {
+					// (A call back into the current call chain)
+					inliner->recursive[callee] = MU_TRUE;
+				} else if (inliner->state[callee] == 0) {
+					muVGC_inline_visit(inliner, callee);
+				}
+			}
+		}
+		inliner->state[f] = 2;
+		inliner->order[inliner->order_len++] = f;
+	}
+
+	// Can a function's body be copied into a caller? Only if its one
+	// return ends its last block; an early return would have to branch
+	// out of the constructs it's in, which structured control flow
+	// doesn't allow.
+	muBool muVGC_function_can_inline(muVGCModule* module, size_m f) {
+		muVGCFunction* function = &module->functions[f];
+		if (function->blocks.len == 0) {
+			return MU_FALSE;
+		}
+		size_m returns = 0;
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+			for (size_m i = 0; i < block->instructions.len; i++) {
+				muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+				if (inst->active == MU_TRUE && (inst->opcode == MUVGC_OP_RETURN || inst->opcode == MUVGC_OP_RETURN_VALUE)) {
+					returns++;
+				}
+			}
+		}
+		muVGCInstruction* terminator = muVGC_block_get_terminator(module, &module->blocks[function->blocks.indexes[function->blocks.len-1]]);
+		return (returns == 1 && terminator != MU_NULL_PTR &&
+			(terminator->opcode == MUVGC_OP_RETURN || terminator->opcode == MUVGC_OP_RETURN_VALUE)) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Returns the number of instructions in a function's body
+	size_m muVGC_function_cost(muVGCModule* module, size_m f) {
+		muVGCFunction* function = &module->functions[f];
+		size_m cost = 0;
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+			for (size_m i = 0; i < block->instructions.len; i++) {
+				if (module->instructions[block->instructions.indexes[i]].active == MU_TRUE) {
+					cost++;
+				}
+			}
+		}
+		return cost;
+	}
+
+	muBool muVGC_should_inline(muVGCInliner* inliner, size_m callee) {
+		muVGCModule* module = inliner->module;
+		if (inliner->recursive[callee] == MU_TRUE || muVGC_function_can_inline(module, callee) == MU_FALSE) {
+			return MU_FALSE;
+		}
+		uint32_m control = module->operands[module->instructions[module->functions[callee].instruction].operand_index].word;
+		if ((control & MUVGC_FUNCTION_CONTROL_DONT_INLINE) != 0) {
+			return MU_FALSE;
+		}
+		if ((control & MUVGC_FUNCTION_CONTROL_INLINE) != 0) {
+			return MU_TRUE;
+		}
+		return (inliner->call_counts[callee] == 1 || muVGC_function_cost(module, callee) <= MUVGC_INLINE_THRESHOLD) ? MU_TRUE : MU_FALSE;
+	}
+
+	uint32_m muVGC_inline_map(uint32_m* map, uint32_m map_len, uint32_m id) {
+		return (id < map_len && map[id] != 0) ? map[id] : id;
+	}
+
+	// Copies an instruction with its ids mapped; ids the map doesn't cover
+	// (types, constants, globals) stay as they are
+	size_m muVGC_inline_copy(muVGCModule* module, size_m instruction, uint32_m* map, uint32_m map_len) {
+		muVGCInstruction inst = module->instructions[instruction];
+		size_m copy = muVGC_module_add_instruction(module, inst.opcode, inst.result_type, muVGC_inline_map(map, map_len, inst.result_id), MU_NULL_PTR, 0);
+		for (size_m i = 0; i < inst.operand_len; i++) {
+			muVGCOperand operand = module->operands[inst.operand_index+i];
+			if (operand.is_id == MU_TRUE) {
+				operand.word = muVGC_inline_map(map, map_len, operand.word);
+			}
+			muVGC_module_add_operand(module, copy, operand);
+		}
+		return copy;
+	}
+
+	// Inlines the call at 'call_position' within the block at 'position'
+	// of function 'caller'
+	void muVGC_inline_call(muVGCModule* module, size_m caller, size_m position, size_m call_position, size_m callee) {
+		size_m block = module->functions[caller].blocks.indexes[position];
+		size_m call = module->blocks[block].instructions.indexes[call_position];
+		uint32_m block_label = module->instructions[module->blocks[block].label].result_id;
+		uint32_m call_id = module->instructions[call].result_id;
+
+		// The callee's ids map to fresh ones, and its parameters to the
+		// call's arguments
+		uint32_m map_len = module->bound;
+		uint32_m* map = mu_malloc(sizeof(uint32_m) * map_len);
+		for (uint32_m i = 0; i < map_len; i++) {
+			map[i] = 0;
+		}
+		muVGCFunction* function = &module->functions[callee];
+		for (size_m p = 0; p < function->parameters.len && p+1 < module->instructions[call].operand_len; p++) {
+			map[module->instructions[function->parameters.indexes[p]].result_id] = module->operands[module->instructions[call].operand_index+1+p].word;
+		}
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			muVGCBlock* callee_block = &module->blocks[function->blocks.indexes[b]];
+			map[module->instructions[callee_block->label].result_id] = muVGC_module_new_id(module);
+			for (size_m i = 0; i < callee_block->instructions.len; i++) {
+				muVGCInstruction* inst = &module->instructions[callee_block->instructions.indexes[i]];
+				if (inst->active == MU_TRUE && inst->result_id != 0 && inst->result_id < map_len) {
+					map[inst->result_id] = muVGC_module_new_id(module);
+				}
+			}
+		}
+		uint32_m entry_label = map[module->instructions[module->blocks[function->blocks.indexes[0]].label].result_id];
+		size_m callee_block_len = function->blocks.len;
+
+		// Whatever follows the call moves to a new block, which the
+		// inlined body returns to
+		uint32_m return_label = muVGC_module_new_id(module);
+		size_m return_block = muVGC_module_insert_block(module, caller, position+1, return_label);
+		for (size_m i = call_position+1; i < module->blocks[block].instructions.len; i++) {
+			muVGC_index_list_add(&module->blocks[return_block].instructions, module->blocks[block].instructions.indexes[i]);
+		}
+		module->blocks[block].instructions.len = call_position;
+		muVGC_module_remove_instruction(module, call);
+		muVGCOperand branch[] = { MUVGC_ID(entry_label) };
+		muVGC_module_emit_to_block(module, block, MUVGC_OP_BRANCH, 0, 0, branch, 1);
+
+		// Phis in the successors now get their values from the new block
+		muVGCInstruction* terminator = muVGC_block_get_terminator(module, &module->blocks[return_block]);
+		if (terminator != MU_NULL_PTR) {
+			muVGCOperand* operands = &module->operands[terminator->operand_index];
+			for (size_m i = 0; i < terminator->operand_len; i++) {
+				if (operands[i].is_id == MU_FALSE) continue;
+				size_m s = muVGC_function_find_block(module, &module->functions[caller], operands[i].word);
+				if (s == MUVGC_NO_BLOCK) continue;
+				muVGCBlock* successor = &module->blocks[module->functions[caller].blocks.indexes[s]];
+				for (size_m j = 0; j < successor->instructions.len; j++) {
+					muVGCInstruction* phi = &module->instructions[successor->instructions.indexes[j]];
+					if (phi->active == MU_FALSE) continue;
+					if (phi->opcode != MUVGC_OP_PHI) break;
+					muVGCOperand* phi_operands = &module->operands[phi->operand_index];
+					for (size_m k = 1; k < phi->operand_len; k += 2) {
+						if (phi_operands[k].word == block_label) {
+							phi_operands[k].word = return_label;
+						}
+					}
+				}
+			}
+		}
+
+		// Copy the callee's blocks in between
+		size_m entry = module->functions[caller].blocks.indexes[0];
+		size_m variable_position = 0;
+		while (variable_position < module->blocks[entry].instructions.len) {
+			muVGCInstruction* inst = &module->instructions[module->blocks[entry].instructions.indexes[variable_position]];
+			if (inst->active == MU_TRUE && inst->opcode != MUVGC_OP_VARIABLE) break;
+			variable_position++;
+		}
+		uint32_m return_value = 0;
+		for (size_m b = 0; b < callee_block_len; b++) {
+			size_m callee_block = module->functions[callee].blocks.indexes[b];
+			uint32_m label = map[module->instructions[module->blocks[callee_block].label].result_id];
+			size_m copy_block = muVGC_module_insert_block(module, caller, position+1+b, label);
+			for (size_m i = 0; i < module->blocks[callee_block].instructions.len; i++) {
+				size_m instruction = module->blocks[callee_block].instructions.indexes[i];
+				muVGCInstruction* inst = &module->instructions[instruction];
+				if (inst->active == MU_FALSE) continue;
+				switch (inst->opcode) {
+					default: {
+						size_m copy = muVGC_inline_copy(module, instruction, map, map_len);
+						muVGC_index_list_add(&module->blocks[copy_block].instructions, copy);
+					} break;
+
+					// (Variables have to be declared in the first block of a function)
+					case MUVGC_OP_VARIABLE: {
+						size_m copy = muVGC_inline_copy(module, instruction, map, map_len);
+						muVGC_index_list_insert(&module->blocks[entry].instructions, copy, variable_position);
+						variable_position++;
+					} break;
+
+					case MUVGC_OP_RETURN: {
+						muVGCOperand return_branch[] = { MUVGC_ID(return_label) };
+						muVGC_module_emit_to_block(module, copy_block, MUVGC_OP_BRANCH, 0, 0, return_branch, 1);
+					} break;
+
+					case MUVGC_OP_RETURN_VALUE: {
+						return_value = muVGC_inline_map(map, map_len, module->operands[inst->operand_index].word);
+						muVGCOperand return_branch[] = { MUVGC_ID(return_label) };
+						muVGC_module_emit_to_block(module, copy_block, MUVGC_OP_BRANCH, 0, 0, return_branch, 1);
+					} break;
+				}
+			}
+		}
+		if (return_value != 0) {
+			muVGC_module_replace_uses(module, call_id, return_value);
+		}
+
+		// Decorations of the callee's results apply to their copies too
+		size_m annotation_len = module->sections[MUVGC_SECTION_ANNOTATION].len;
+		for (size_m i = 0; i < annotation_len; i++) {
+			size_m instruction = module->sections[MUVGC_SECTION_ANNOTATION].indexes[i];
+			muVGCInstruction* inst = &module->instructions[instruction];
+			if (inst->active == MU_FALSE || inst->opcode != MUVGC_OP_DECORATE || inst->operand_len == 0) continue;
+			uint32_m target = module->operands[inst->operand_index].word;
+			if (target >= map_len || map[target] == 0) continue;
+			muVGCInstruction* definition = muVGC_module_get_definition(module, target);
+			if (definition == MU_NULL_PTR || definition->opcode == MUVGC_OP_FUNCTION_PARAMETER) continue;
+			size_m copy = muVGC_inline_copy(module, instruction, map, map_len);
+			muVGC_index_list_add(&module->sections[MUVGC_SECTION_ANNOTATION], copy);
+		}
+
+		mu_free(map);
+	}
+
+	void muVGC_inline_functions(muVGCModule* module) {
+		size_m n = module->function_len;
+		if (n == 0) {
+			return;
+		}
+
+		muVGCInliner inliner;
+		inliner.module = module;
+		inliner.state = mu_malloc(sizeof(uint8_m) * n);
+		inliner.recursive = mu_malloc(sizeof(muBool) * n);
+		inliner.call_counts = mu_malloc(sizeof(size_m) * n);
+		inliner.order = mu_malloc(sizeof(size_m) * n);
+		inliner.order_len = 0;
+		for (size_m f = 0; f < n; f++) {
+			inliner.state[f] = 0;
+			inliner.recursive[f] = MU_FALSE;
+			inliner.call_counts[f] = 0;
+		}
+		for (size_m f = 0; f < n; f++) {
+			if (module->functions[f].active == MU_TRUE && inliner.state[f] == 0) {
+				muVGC_inline_visit(&inliner, f);
+			}
+		}
+
+		for (size_m o = 0; o < inliner.order_len; o++) {
+			size_m f = inliner.order[o];
+			for (size_m b = 0; b < module->functions[f].blocks.len; b++) {
+				size_m block = module->functions[f].blocks.indexes[b];
+
+				// (Splitting a loop header would separate its OpLoopMerge from
+				// the block its back edge goes to)
+				muBool is_loop_header = MU_FALSE;
+				for (size_m i = 0; i < module->blocks[block].instructions.len; i++) {
+					muVGCInstruction* inst = &module->instructions[module->blocks[block].instructions.indexes[i]];
+					if (inst->active == MU_TRUE && inst->opcode == MUVGC_OP_LOOP_MERGE) {
+						is_loop_header = MU_TRUE;
+					}
+				}
+				if (is_loop_header == MU_TRUE) continue;
+
+				for (size_m i = 0; i < module->blocks[block].instructions.len; i++) {
+					muVGCInstruction* inst = &module->instructions[module->blocks[block].instructions.indexes[i]];
+					if (inst->active == MU_FALSE || inst->opcode != MUVGC_OP_FUNCTION_CALL) continue;
+					size_m callee = muVGC_module_find_function(module, module->operands[inst->operand_index].word);
+					if (callee == module->function_len || muVGC_should_inline(&inliner, callee) == MU_FALSE) continue;
+					// (The rest of the block follows the inlined body, so it's
+					// visited after it)
+					muVGC_inline_call(module, f, b, i, callee);
+					break;
+				}
+			}
+			// (Before the function gets inlined anywhere itself)
+			muVGC_module_apply_replacements(module);
+		}
+
+		mu_free(inliner.order);
+		mu_free(inliner.call_counts);
+		mu_free(inliner.recursive);
+		mu_free(inliner.state);
+	}
+
+	// Block merging
+
+	// Folds a block into its predecessor when that's its only predecessor
+	// and the predecessor unconditionally branches to it, cleaning up the
+	// block chains inlining leaves behind. Merge blocks and continue
+	// targets of structured constructs are left alone.
+
+	void muVGC_merge_function_blocks(muVGCModule* module, size_m function_index) {
+		muVGCFunction* function = &module->functions[function_index];
+
+		// Count the edges into each label, and flag the ones that are named
+		// by a merge instruction
+		size_m* edge_counts = mu_malloc(sizeof(size_m) * module->bound);
+		muBool* is_merge_target = mu_malloc(sizeof(muBool) * module->bound);
+		for (uint32_m i = 0; i < module->bound; i++) {
+			edge_counts[i] = 0;
+			is_merge_target[i] = MU_FALSE;
+		}
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+			for (size_m i = 0; i < block->instructions.len; i++) {
+				muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+				if (inst->active == MU_FALSE) continue;
+				muVGCOperand* operands = &module->operands[inst->operand_index];
+				if (inst->opcode == MUVGC_OP_LOOP_MERGE || inst->opcode == MUVGC_OP_SELECTION_MERGE) {
+					for (size_m j = 0; j < inst->operand_len; j++) {
+						if (operands[j].is_id == MU_TRUE && operands[j].word < module->bound) {
+							is_merge_target[operands[j].word] = MU_TRUE;
+						}
+					}
+				}
+			}
+			muVGCInstruction* terminator = muVGC_block_get_terminator(module, block);
+			if (terminator == MU_NULL_PTR) continue;
+			muVGCOperand* operands = &module->operands[terminator->operand_index];
+			for (size_m j = 0; j < terminator->operand_len; j++) {
+				if (operands[j].is_id == MU_TRUE && operands[j].word < module->bound) {
+					edge_counts[operands[j].word] += 1;
+				}
+			}
+		}
+
+		for (size_m a = 0; a < function->blocks.len; a++) {
+			size_m block = function->blocks.indexes[a];
+			uint32_m label = module->instructions[module->blocks[block].label].result_id;
+			while (MU_TRUE) {
+				muBool is_loop_header = MU_FALSE;
+				for (size_m i = 0; i < module->blocks[block].instructions.len; i++) {
+					muVGCInstruction* inst = &module->instructions[module->blocks[block].instructions.indexes[i]];
+					if (inst->active == MU_TRUE && inst->opcode == MUVGC_OP_LOOP_MERGE) {
+						is_loop_header = MU_TRUE;
+					}
+				}
+				muVGCInstruction* terminator = muVGC_block_get_terminator(module, &module->blocks[block]);
+				if (is_loop_header == MU_TRUE || terminator == MU_NULL_PTR || terminator->opcode != MUVGC_OP_BRANCH) break;
+				uint32_m next_label = module->operands[terminator->operand_index].word;
+				size_m b = muVGC_function_find_block(module, function, next_label);
+				if (b == MUVGC_NO_BLOCK || b == 0 || b == a || edge_counts[next_label] != 1 || is_merge_target[next_label] == MU_TRUE) break;
+				size_m next = function->blocks.indexes[b];
+
+				// (With a single predecessor, phis just forward their value)
+				terminator->active = MU_FALSE;
+				for (size_m i = 0; i < module->blocks[next].instructions.len; i++) {
+					size_m instruction = module->blocks[next].instructions.indexes[i];
+					muVGCInstruction* inst = &module->instructions[instruction];
+					if (inst->active == MU_TRUE && inst->opcode == MUVGC_OP_PHI) {
+						muVGC_module_replace_uses(module, inst->result_id, module->operands[inst->operand_index].word);
+						muVGC_module_remove_instruction(module, instruction);
+						continue;
+					}
+					muVGC_index_list_add(&module->blocks[block].instructions, instruction);
+				}
+
+				// Phis in the successors now get their values from the merged
+				// block
+				terminator = muVGC_block_get_terminator(module, &module->blocks[block]);
+				if (terminator != MU_NULL_PTR) {
+					muVGCOperand* operands = &module->operands[terminator->operand_index];
+					for (size_m i = 0; i < terminator->operand_len; i++) {
+						if (operands[i].is_id == MU_FALSE) continue;
+						size_m s = muVGC_function_find_block(module, function, operands[i].word);
+						if (s == MUVGC_NO_BLOCK) continue;
+						muVGCBlock* successor = &module->blocks[function->blocks.indexes[s]];
+						for (size_m j = 0; j < successor->instructions.len; j++) {
+							muVGCInstruction* phi = &module->instructions[successor->instructions.indexes[j]];
+							if (phi->active == MU_FALSE) continue;
+							if (phi->opcode != MUVGC_OP_PHI) break;
+							muVGCOperand* phi_operands = &module->operands[phi->operand_index];
+							for (size_m k = 1; k < phi->operand_len; k += 2) {
+								if (phi_operands[k].word == next_label) {
+									phi_operands[k].word = label;
+								}
+							}
+						}
+					}
+				}
+
+				muVGC_module_remove_instruction(module, module->blocks[next].label);
+				module->blocks[next].instructions.len = 0;
+				for (size_m i = b; i+1 < function->blocks.len; i++) {
+					function->blocks.indexes[i] = function->blocks.indexes[i+1];
+				}
+				function->blocks.len -= 1;
+				if (b < a) {
+					a--;
+				}
+			}
+		}
+
+		mu_free(is_merge_target);
+		mu_free(edge_counts);
+	}
+
+	void muVGC_merge_blocks(muVGCModule* module) {
+		for (size_m f = 0; f < module->function_len; f++) {
+			if (module->functions[f].active == MU_TRUE) {
+				muVGC_merge_function_blocks(module, f);
+			}
+		}
+		muVGC_module_apply_replacements(module);
+	}
+
+	// Branch folding
+
+	// Turns conditional branches on a constant into unconditional ones,
+	// dropping the selection they headed, then removes the blocks that are
+	// no longer reachable from the entry block along with the phi operands
+	// they fed (a phi left with one operand being replaced by it). Merge
+	// blocks & continue targets still named by a construct stay, emptied
+	// down to OpUnreachable. Loop headers are left to loop unrolling.
+
+	// Removes the operands a phi gets from the block with the given label
+	void muVGC_phi_remove_incoming(muVGCModule* module, size_m instruction, uint32_m label) {
+		muVGCInstruction* phi = &module->instructions[instruction];
+		muVGCOperand* operands = &module->operands[phi->operand_index];
+		size_m kept = 0;
+		for (size_m k = 0; k+1 < phi->operand_len; k += 2) {
+			if (operands[k+1].word == label) continue;
+			operands[kept] = operands[k];
+			operands[kept+1] = operands[k+1];
+			kept += 2;
+		}
+		phi->operand_len = kept;
+		if (kept == 2) {
+			muVGC_module_replace_uses(module, phi->result_id, operands[0].word);
+			muVGC_module_remove_instruction(module, instruction);
+		}
+	}
+
+	// Removes the operands the phis of a block get from the block with the
+	// given label
+	void muVGC_block_remove_incoming(muVGCModule* module, muVGCBlock* block, uint32_m label) {
+		for (size_m i = 0; i < block->instructions.len; i++) {
+			muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+			if (inst->active == MU_FALSE) continue;
+			if (inst->opcode != MUVGC_OP_PHI) break;
+			muVGC_phi_remove_incoming(module, block->instructions.indexes[i], label);
+		}
+	}
+
+	void muVGC_fold_function_branches(muVGCModule* module, size_m function_index) {
+		muVGCFunction* function = &module->functions[function_index];
+
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+			muVGCInstruction* terminator = muVGC_block_get_terminator(module, block);
+			if (terminator == MU_NULL_PTR || terminator->opcode != MUVGC_OP_BRANCH_CONDITIONAL) continue;
+			muVGCOperand* operands = &module->operands[terminator->operand_index];
+			muVGCInstruction* condition = muVGC_module_get_definition(module, operands[0].word);
+			if (condition == MU_NULL_PTR || (condition->opcode != MUVGC_OP_CONSTANT_TRUE && condition->opcode != MUVGC_OP_CONSTANT_FALSE)) continue;
+
+			size_m merge = MUVGC_NO_BLOCK;
+			for (size_m i = 0; i < block->instructions.len; i++) {
+				muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+				if (inst->active == MU_TRUE && (inst->opcode == MUVGC_OP_SELECTION_MERGE || inst->opcode == MUVGC_OP_LOOP_MERGE)) {
+					merge = block->instructions.indexes[i];
+				}
+			}
+			if (merge != MUVGC_NO_BLOCK && module->instructions[merge].opcode == MUVGC_OP_LOOP_MERGE) continue;
+
+			uint32_m label = module->instructions[block->label].result_id;
+			size_m taken = (condition->opcode == MUVGC_OP_CONSTANT_TRUE) ? 1 : 2;
+			uint32_m untaken = operands[3-taken].word;
+			operands[0] = operands[taken];
+			terminator->opcode = MUVGC_OP_BRANCH;
+			terminator->operand_len = 1;
+			if (merge != MUVGC_NO_BLOCK) {
+				muVGC_module_remove_instruction(module, merge);
+			}
+			if (untaken != operands[0].word) {
+				size_m s = muVGC_function_find_block(module, function, untaken);
+				if (s != MUVGC_NO_BLOCK) {
+					muVGC_block_remove_incoming(module, &module->blocks[function->blocks.indexes[s]], label);
+				}
+			}
+		}
+
+		// Unreachable blocks
+		muVGCCFG cfg;
+		muVGC_compute_cfg(module, function_index, &cfg);
+		if (cfg.order_len == cfg.block_len) {
+			muVGC_free_cfg(&cfg);
+			return;
+		}
+		muBool* is_merge_target = mu_malloc(sizeof(muBool) * module->bound);
+		for (uint32_m i = 0; i < module->bound; i++) {
+			is_merge_target[i] = MU_FALSE;
+		}
+		for (size_m o = 0; o < cfg.order_len; o++) {
+			muVGCBlock* block = &module->blocks[function->blocks.indexes[cfg.order[o]]];
+			for (size_m i = 0; i < block->instructions.len; i++) {
+				muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+				if (inst->active == MU_FALSE || (inst->opcode != MUVGC_OP_SELECTION_MERGE && inst->opcode != MUVGC_OP_LOOP_MERGE)) continue;
+				muVGCOperand* operands = &module->operands[inst->operand_index];
+				for (size_m j = 0; j < inst->operand_len; j++) {
+					if (operands[j].is_id == MU_TRUE && operands[j].word < module->bound) {
+						is_merge_target[operands[j].word] = MU_TRUE;
+					}
+				}
+			}
+		}
+		for (size_m b = cfg.block_len; b > 0; b--) {
+			if (cfg.order_index[b-1] != MUVGC_NO_BLOCK) continue;
+			size_m index = function->blocks.indexes[b-1];
+			uint32_m label = module->instructions[module->blocks[index].label].result_id;
+			for (size_m s = 0; s < cfg.successors[b-1].len; s++) {
+				size_m successor = cfg.successors[b-1].indexes[s];
+				if (cfg.order_index[successor] != MUVGC_NO_BLOCK) {
+					muVGC_block_remove_incoming(module, &module->blocks[function->blocks.indexes[successor]], label);
+				}
+			}
+			for (size_m i = 0; i < module->blocks[index].instructions.len; i++) {
+				muVGC_module_remove_instruction(module, module->blocks[index].instructions.indexes[i]);
+			}
+			module->blocks[index].instructions.len = 0;
+			if (is_merge_target[label] == MU_TRUE) {
+				muVGC_module_emit_to_block(module, index, MUVGC_OP_UNREACHABLE, 0, 0, MU_NULL_PTR, 0);
+				continue;
+			}
+			muVGC_module_remove_instruction(module, module->blocks[index].label);
+			for (size_m i = b-1; i+1 < function->blocks.len; i++) {
+				function->blocks.indexes[i] = function->blocks.indexes[i+1];
+			}
+			function->blocks.len -= 1;
+		}
+		mu_free(is_merge_target);
+		muVGC_free_cfg(&cfg);
+	}
+
+	void muVGC_fold_branches(muVGCModule* module) {
+		for (size_m f = 0; f < module->function_len; f++) {
+			if (module->functions[f].active == MU_TRUE) {
+				muVGC_fold_function_branches(module, f);
+			}
+		}
+		muVGC_module_apply_replacements(module);
+	}
+
+	// Loop unrolling
+
+	// Fully unrolls loops whose trip count is known at compile time: the
+	// header has a phi starting at a constant, stepped by a constant in
+	// the continue target and compared against a constant to decide
+	// whether to leave. Each iteration gets its own copy of the loop's
+	// blocks (with the header's phis replaced by that iteration's values),
+	// chained one after the other and followed by a last copy of the
+	// header, which computes what code after the loop sees. Loops marked
+	// DontUnroll are left alone; others are unrolled if marked Unroll or
+	// if unrolling them costs at most MUVGC_UNROLL_THRESHOLD instructions.
+
+	#ifndef MUVGC_UNROLL_THRESHOLD
+		#define MUVGC_UNROLL_THRESHOLD 256
+	#endif
+
+	// Loops running more times than this are never unrolled, even when
+	// marked Unroll
+	#ifndef MUVGC_UNROLL_MAX_TRIP_COUNT
+		#define MUVGC_UNROLL_MAX_TRIP_COUNT 1024
+	#endif
+
+	// A loop that can be unrolled; blocks are referred to by their
+	// position in the function's block list
+	struct muVGCLoop {
+		size_m header;
+		size_m preheader;
+		size_m latch;
+		uint32_m merge_label;
+		uint32_m body_label;
+		size_m trip_count;
+		// Blocks of the loop in layout order (header first), as indexes
+		// into module->blocks
+		muVGCIndexList blocks;
+	};
+	typedef struct muVGCLoop muVGCLoop;
+
+	// Reads a 32-bit integer constant; returns MU_FALSE if the id isn't one
+	muBool muVGC_get_int_constant(muVGCModule* module, uint32_m id, uint32_m* value) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, id);
+		if (inst == MU_NULL_PTR || inst->opcode != MUVGC_OP_CONSTANT || inst->operand_len != 1) {
+			return MU_FALSE;
+		}
+		muVGCInstruction* type = muVGC_module_get_definition(module, inst->result_type);
+		if (type == MU_NULL_PTR || type->opcode != MUVGC_OP_TYPE_INT || module->operands[type->operand_index].word != 32) {
+			return MU_FALSE;
+		}
+		*value = module->operands[inst->operand_index].word;
+		return MU_TRUE;
+	}
+
+	// Returns the value a phi gets from the given block, or 0
+	uint32_m muVGC_phi_get_incoming(muVGCModule* module, muVGCInstruction* phi, uint32_m label) {
+		muVGCOperand* operands = &module->operands[phi->operand_index];
+		for (size_m i = 0; i+1 < phi->operand_len; i += 2) {
+			if (operands[i+1].word == label) {
+				return operands[i].word;
+			}
+		}
+		return 0;
+	}
+
+	// Checks if the block at position 'h' heads a loop that should be
+	// unrolled, filling 'loop' if so
+	muBool muVGC_analyze_loop(muVGCModule* module, size_m function_index, muVGCCFG* cfg, size_m h, muVGCLoop* loop) {
+		muVGCFunction* function = &module->functions[function_index];
+		muVGCBlock* header = &module->blocks[function->blocks.indexes[h]];
+		if (cfg->idom[h] == MUVGC_NO_BLOCK) {
+			return MU_FALSE;
+		}
+
+		// Header: OpLoopMerge, then a conditional branch to the body or the
+		// merge block
+		muVGCInstruction* merge = MU_NULL_PTR;
+		for (size_m i = 0; i < header->instructions.len; i++) {
+			muVGCInstruction* inst = &module->instructions[header->instructions.indexes[i]];
+			if (inst->active == MU_TRUE && inst->opcode == MUVGC_OP_LOOP_MERGE) {
+				merge = inst;
+			}
+		}
+		muVGCInstruction* terminator = muVGC_block_get_terminator(module, header);
+		if (merge == MU_NULL_PTR || terminator == MU_NULL_PTR || terminator->opcode != MUVGC_OP_BRANCH_CONDITIONAL) {
+			return MU_FALSE;
+		}
+		muVGCOperand* merge_operands = &module->operands[merge->operand_index];
+		uint32_m control = merge_operands[2].word;
+		if ((control & MUVGC_LOOP_CONTROL_DONT_UNROLL) != 0) {
+			return MU_FALSE;
+		}
+		loop->merge_label = merge_operands[0].word;
+		uint32_m continue_label = merge_operands[1].word;
+		muVGCOperand* branch = &module->operands[terminator->operand_index];
+		// (Does the loop go on while the condition is true, or while it's
+		// false?)
+		uint32_m continue_while = 1;
+		if (branch[2].word == loop->merge_label) {
+			loop->body_label = branch[1].word;
+		} else if (branch[1].word == loop->merge_label) {
+			loop->body_label = branch[2].word;
+			continue_while = 0;
+		} else {
+			return MU_FALSE;
+		}
+
+		// The header is only entered from before the loop and from the
+		// continue target; the merge block only from the header
+		loop->header = h;
+		loop->latch = muVGC_function_find_block(module, function, continue_label);
+		size_m merge_block = muVGC_function_find_block(module, function, loop->merge_label);
+		if (loop->latch == MUVGC_NO_BLOCK || merge_block == MUVGC_NO_BLOCK ||
+			cfg->predecessors[h].len != 2 || cfg->predecessors[merge_block].len != 1) {
+			return MU_FALSE;
+		}
+		loop->preheader = cfg->predecessors[h].indexes[0];
+		if (loop->preheader == loop->latch) {
+			loop->preheader = cfg->predecessors[h].indexes[1];
+		} else if (cfg->predecessors[h].indexes[1] != loop->latch) {
+			return MU_FALSE;
+		}
+		muVGCInstruction* latch_terminator = muVGC_block_get_terminator(module, &module->blocks[function->blocks.indexes[loop->latch]]);
+		if (latch_terminator == MU_NULL_PTR || latch_terminator->opcode != MUVGC_OP_BRANCH) {
+			return MU_FALSE;
+		}
+		uint32_m preheader_label = module->instructions[module->blocks[function->blocks.indexes[loop->preheader]].label].result_id;
+
+		// Condition: a header phi compared against a constant
+		muVGCInstruction* condition = muVGC_module_get_definition(module, branch[0].word);
+		if (condition == MU_NULL_PTR || condition->operand_len != 2) {
+			return MU_FALSE;
+		}
+		muVGCOperand* condition_operands = &module->operands[condition->operand_index];
+		muVGCInstruction* phi = MU_NULL_PTR;
+		size_m phi_operand = 0;
+		uint32_m bound = 0;
+		for (size_m i = 0; i < 2; i++) {
+			muVGCInstruction* inst = muVGC_module_get_definition(module, condition_operands[i].word);
+			if (inst != MU_NULL_PTR && inst->opcode == MUVGC_OP_PHI &&
+				muVGC_get_int_constant(module, condition_operands[1-i].word, &bound) == MU_TRUE) {
+				phi = inst;
+				phi_operand = i;
+			}
+		}
+		if (phi == MU_NULL_PTR) {
+			return MU_FALSE;
+		}
+		muBool phi_in_header = MU_FALSE;
+		for (size_m i = 0; i < header->instructions.len; i++) {
+			if (&module->instructions[header->instructions.indexes[i]] == phi) {
+				phi_in_header = MU_TRUE;
+			}
+		}
+		if (phi_in_header == MU_FALSE) {
+			return MU_FALSE;
+		}
+
+		// Phi: starts at a constant, and is stepped by a constant
+		uint32_m value = 0;
+		if (muVGC_get_int_constant(module, muVGC_phi_get_incoming(module, phi, preheader_label), &value) == MU_FALSE) {
+			return MU_FALSE;
+		}
+		muVGCInstruction* next = muVGC_module_get_definition(module, muVGC_phi_get_incoming(module, phi, continue_label));
+		if (next == MU_NULL_PTR || next->operand_len != 2 || (next->opcode != MUVGC_OP_I_ADD && next->opcode != MUVGC_OP_I_SUB)) {
+			return MU_FALSE;
+		}
+		muVGCOperand* next_operands = &module->operands[next->operand_index];
+		uint32_m step = 0;
+		if (next_operands[0].word == phi->result_id && muVGC_get_int_constant(module, next_operands[1].word, &step) == MU_TRUE) {
+			step = (next->opcode == MUVGC_OP_I_SUB) ? (~step) + 1 : step;
+		} else if (next->opcode == MUVGC_OP_I_ADD && next_operands[1].word == phi->result_id &&
+			muVGC_get_int_constant(module, next_operands[0].word, &step) == MU_TRUE) {
+		} else {
+			return MU_FALSE;
+		}
+
+		// Trip count
+		loop->trip_count = 0;
+		while (MU_TRUE) {
+			uint32_m result = 0;
+			uint32_m a = (phi_operand == 0) ? value : bound;
+			uint32_m b = (phi_operand == 0) ? bound : value;
+			if (muVGC_fold_scalar(condition->opcode, a, b, &result) == MU_FALSE) {
+				return MU_FALSE;
+			}
+			if (result != continue_while) break;
+			loop->trip_count += 1;
+			if (loop->trip_count > MUVGC_UNROLL_MAX_TRIP_COUNT) {
+				return MU_FALSE;
+			}
+			value += step;
+		}
+
+		// Blocks: the ones the header dominates, besides the merge block and
+		// whatever comes after it
+		muVGCIndexList empty = { 0 };
+		loop->blocks = empty;
+		size_m cost = 0;
+		for (size_m b = 0; b < function->blocks.len; b++) {
+			if (cfg->idom[b] == MUVGC_NO_BLOCK || muVGC_cfg_dominates(cfg, h, b) == MU_FALSE || muVGC_cfg_dominates(cfg, merge_block, b) == MU_TRUE) {
+				continue;
+			}
+			muVGC_index_list_add(&loop->blocks, function->blocks.indexes[b]);
+			muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+			for (size_m i = 0; i < block->instructions.len; i++) {
+				if (module->instructions[block->instructions.indexes[i]].active == MU_TRUE) {
+					cost++;
+				}
+			}
+		}
+		if (loop->blocks.len == 0 || loop->blocks.indexes[0] != function->blocks.indexes[h] ||
+			((control & MUVGC_LOOP_CONTROL_UNROLL) == 0 && cost * loop->trip_count > MUVGC_UNROLL_THRESHOLD)) {
+			muVGC_index_list_free(&loop->blocks);
+			return MU_FALSE;
+		}
+		return MU_TRUE;
+	}
+
+	void muVGC_unroll_loop(muVGCModule* module, size_m function_index, muVGCLoop* loop) {
+		muVGCFunction* function = &module->functions[function_index];
+		size_m header = function->blocks.indexes[loop->header];
+		size_m latch = function->blocks.indexes[loop->latch];
+		uint32_m header_label = module->instructions[module->blocks[header].label].result_id;
+		uint32_m preheader_label = module->instructions[module->blocks[function->blocks.indexes[loop->preheader]].label].result_id;
+		uint32_m latch_label = module->instructions[module->blocks[latch].label].result_id;
+
+		// Each iteration maps the loop's ids to its own; 'previous' holds the
+		// last iteration's mapping, which the header's phis continue from
+		uint32_m map_len = module->bound;
+		uint32_m* map = mu_malloc(sizeof(uint32_m) * map_len);
+		uint32_m* previous = mu_malloc(sizeof(uint32_m) * map_len);
+		for (uint32_m i = 0; i < map_len; i++) {
+			map[i] = 0;
+			previous[i] = 0;
+		}
+		uint32_m* header_labels = mu_malloc(sizeof(uint32_m) * (loop->trip_count+1));
+		for (size_m k = 0; k <= loop->trip_count; k++) {
+			header_labels[k] = muVGC_module_new_id(module);
+		}
+
+		size_m position = loop->header;
+		size_m annotation_len = module->sections[MUVGC_SECTION_ANNOTATION].len;
+		for (size_m k = 0; k <= loop->trip_count; k++) {
+			uint32_m* t = previous;
+			previous = map;
+			map = t;
+			for (uint32_m i = 0; i < map_len; i++) {
+				map[i] = 0;
+			}
+
+			// (The last copy only has the header)
+			size_m block_len = (k == loop->trip_count) ? 1 : loop->blocks.len;
+			map[header_label] = header_labels[k];
+			for (size_m b = 0; b < block_len; b++) {
+				muVGCBlock* block = &module->blocks[loop->blocks.indexes[b]];
+				if (b != 0) {
+					map[module->instructions[block->label].result_id] = muVGC_module_new_id(module);
+				}
+				for (size_m i = 0; i < block->instructions.len; i++) {
+					muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+					if (inst->active == MU_FALSE || inst->result_id == 0 || inst->result_id >= map_len) continue;
+					if (b == 0 && inst->opcode == MUVGC_OP_PHI) {
+						map[inst->result_id] = (k == 0) ?
+							muVGC_phi_get_incoming(module, inst, preheader_label) :
+							muVGC_inline_map(previous, map_len, muVGC_phi_get_incoming(module, inst, latch_label));
+					} else {
+						map[inst->result_id] = muVGC_module_new_id(module);
+					}
+				}
+			}
+
+			for (size_m b = 0; b < block_len; b++) {
+				size_m block = loop->blocks.indexes[b];
+				size_m copy_block = muVGC_module_insert_block(module, function_index, position, map[module->instructions[module->blocks[block].label].result_id]);
+				position++;
+				size_m terminator = module->blocks[block].instructions.len;
+				while (terminator > 0 && module->instructions[module->blocks[block].instructions.indexes[terminator-1]].active == MU_FALSE) {
+					terminator--;
+				}
+				for (size_m i = 0; i+1 < terminator; i++) {
+					size_m instruction = module->blocks[block].instructions.indexes[i];
+					muVGCInstruction* inst = &module->instructions[instruction];
+					if (inst->active == MU_FALSE) continue;
+					if (b == 0 && (inst->opcode == MUVGC_OP_PHI || inst->opcode == MUVGC_OP_LOOP_MERGE)) continue;
+					size_m copy = muVGC_inline_copy(module, instruction, map, map_len);
+					muVGC_index_list_add(&module->blocks[copy_block].instructions, copy);
+				}
+
+				// The header goes on to the body (or, after the last iteration,
+				// to the merge block) and the continue target to the next
+				// iteration
+				if (b == 0) {
+					muVGC_op_branch(module, copy_block, (k == loop->trip_count) ? loop->merge_label : map[loop->body_label]);
+				} else if (block == latch) {
+					muVGC_op_branch(module, copy_block, header_labels[k+1]);
+				} else if (terminator > 0) {
+					size_m copy = muVGC_inline_copy(module, module->blocks[block].instructions.indexes[terminator-1], map, map_len);
+					muVGC_index_list_add(&module->blocks[copy_block].instructions, copy);
+				}
+			}
+
+			// Decorations of the loop's results apply to their copies too
+			for (size_m i = 0; i < annotation_len; i++) {
+				size_m instruction = module->sections[MUVGC_SECTION_ANNOTATION].indexes[i];
+				muVGCInstruction* inst = &module->instructions[instruction];
+				if (inst->active == MU_FALSE || inst->opcode != MUVGC_OP_DECORATE || inst->operand_len == 0) continue;
+				uint32_m target = module->operands[inst->operand_index].word;
+				if (target >= map_len || map[target] == 0) continue;
+				muVGCInstruction* definition = muVGC_module_get_definition(module, target);
+				if (definition == MU_NULL_PTR || definition->opcode == MUVGC_OP_PHI || definition->opcode == MUVGC_OP_LABEL) continue;
+				size_m copy = muVGC_inline_copy(module, instruction, map, map_len);
+				muVGC_index_list_add(&module->sections[MUVGC_SECTION_ANNOTATION], copy);
+			}
+		}
+
+		// Phis of the merge block now come from the last header copy
+		size_m merge_block = function->blocks.indexes[muVGC_function_find_block(module, function, loop->merge_label)];
+		for (size_m i = 0; i < module->blocks[merge_block].instructions.len; i++) {
+			muVGCInstruction* phi = &module->instructions[module->blocks[merge_block].instructions.indexes[i]];
+			if (phi->active == MU_FALSE) continue;
+			if (phi->opcode != MUVGC_OP_PHI) break;
+			muVGCOperand* operands = &module->operands[phi->operand_index];
+			for (size_m j = 1; j < phi->operand_len; j += 2) {
+				if (operands[j].word == header_label) {
+					operands[j].word = header_labels[loop->trip_count];
+				}
+			}
+		}
+
+		// Remove the loop, then point whatever's outside of it at the copies
+		// (the header's results at the last header copy, branches to the
+		// header at the first)
+		for (size_m b = 0; b < loop->blocks.len; b++) {
+			size_m block = loop->blocks.indexes[b];
+			for (size_m i = 0; i < module->blocks[block].instructions.len; i++) {
+				muVGC_module_remove_instruction(module, module->blocks[block].instructions.indexes[i]);
+			}
+			muVGC_module_remove_instruction(module, module->blocks[block].label);
+			for (size_m i = 0; i < function->blocks.len; i++) {
+				if (function->blocks.indexes[i] == block) {
+					for (size_m j = i; j+1 < function->blocks.len; j++) {
+						function->blocks.indexes[j] = function->blocks.indexes[j+1];
+					}
+					function->blocks.len -= 1;
+					break;
+				}
+			}
+		}
+		for (size_m i = 0; i < module->blocks[header].instructions.len; i++) {
+			muVGCInstruction* inst = &module->instructions[module->blocks[header].instructions.indexes[i]];
+			if (inst->result_id != 0 && inst->result_id < map_len && map[inst->result_id] != 0) {
+				muVGC_module_replace_uses(module, inst->result_id, map[inst->result_id]);
+			}
+		}
+		muVGC_module_replace_uses(module, header_label, header_labels[0]);
+		// (Before the next loop is looked at)
+		muVGC_module_apply_replacements(module);
+
+		mu_free(header_labels);
+		mu_free(previous);
+		mu_free(map);
+	}
+
+	void muVGC_unroll_loops(muVGCModule* module) {
+		for (size_m f = 0; f < module->function_len; f++) {
+			if (module->functions[f].active == MU_FALSE) continue;
+			muBool unrolled = MU_TRUE;
+			while (unrolled == MU_TRUE) {
+				unrolled = MU_FALSE;
+				muVGCCFG cfg;
+				muVGC_compute_cfg(module, f, &cfg);
+				// (Inner loops come after the loops around them)
+				for (size_m h = cfg.block_len; h > 0; h--) {
+					muVGCLoop loop;
+					if (muVGC_analyze_loop(module, f, &cfg, h-1, &loop) == MU_TRUE) {
+						muVGC_unroll_loop(module, f, &loop);
+						muVGC_index_list_free(&loop.blocks);
+						unrolled = MU_TRUE;
+						break;
+					}
+				}
+				muVGC_free_cfg(&cfg);
+			}
+		}
+	}
+
+	// If conversion
+
+	// Turns small if/else constructs into straight-line code: when the
+	// sides of a selection (one side for an if without an else) only
+	// compute values, they're hoisted into the header and the phis in the
+	// merge block become OpSelects on the condition. Selections marked
+	// DontFlatten are left alone; others are converted if marked Flatten
+	// or if the hoisted code is at most MUVGC_SELECT_THRESHOLD
+	// instructions. Selections on a constant condition are left to branch
+	// folding (run before this), which drops the side that can't run
+	// rather than computing both.
+
+	#ifndef MUVGC_SELECT_THRESHOLD
+		#define MUVGC_SELECT_THRESHOLD 8
+	#endif
+
+	// Can an instruction run even on paths that wouldn't have reached it?
+	muBool muVGC_module_is_speculatable(muVGCModule* module, muVGCInstruction* inst) {
+		switch (inst->opcode) {
+			default: return muVGC_module_is_pure(module, inst); break;
+			// (A load might read through a pointer that's only valid on its
+			// own path, integer division by zero is undefined, and variables &
+			// phis can't be moved)
+			case MUVGC_OP_LOAD: case MUVGC_OP_VARIABLE: case MUVGC_OP_PHI: case MUVGC_OP_U_DIV: case MUVGC_OP_S_DIV:
+			case MUVGC_OP_U_MOD: case MUVGC_OP_S_REM: case MUVGC_OP_S_MOD: {
+				return MU_FALSE;
+			} break;
+		}
+	}
+
+	// Returns the number of instructions a side of a selection would hoist,
+	// or MUVGC_NO_BLOCK if it can't be hoisted. A side is a single block
+	// whose only predecessor is the header and which branches straight to
+	// the merge block.
+	size_m muVGC_selection_side_cost(muVGCModule* module, size_m function_index, muVGCCFG* cfg, size_m header, uint32_m label, uint32_m merge_label) {
+		muVGCFunction* function = &module->functions[function_index];
+		size_m side = muVGC_function_find_block(module, function, label);
+		if (side == MUVGC_NO_BLOCK || side == 0 || side == header || cfg->predecessors[side].len != 1) {
+			return MUVGC_NO_BLOCK;
+		}
+		muVGCBlock* block = &module->blocks[function->blocks.indexes[side]];
+		muVGCInstruction* terminator = muVGC_block_get_terminator(module, block);
+		if (terminator == MU_NULL_PTR || terminator->opcode != MUVGC_OP_BRANCH || module->operands[terminator->operand_index].word != merge_label) {
+			return MUVGC_NO_BLOCK;
+		}
+		size_m cost = 0;
+		for (size_m i = 0; i < block->instructions.len; i++) {
+			muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+			if (inst->active == MU_FALSE || inst == terminator) continue;
+			if (muVGC_module_is_speculatable(module, inst) == MU_FALSE) {
+				return MUVGC_NO_BLOCK;
+			}
+			cost++;
+		}
+		return cost;
+	}
+
+	// Converts the selection headed by the given block if it can; returns
+	// whether it did
+	muBool muVGC_convert_selection(muVGCModule* module, size_m function_index, muVGCCFG* cfg, size_m header) {
+		muVGCFunction* function = &module->functions[function_index];
+		size_m header_block = function->blocks.indexes[header];
+		muVGCIndexList* instructions = &module->blocks[header_block].instructions;
+
+		// Header: OpSelectionMerge followed by OpBranchConditional
+		size_m branch = MUVGC_NO_BLOCK, merge = MUVGC_NO_BLOCK;
+		for (size_m i = instructions->len; i > 0; i--) {
+			if (module->instructions[instructions->indexes[i-1]].active == MU_FALSE) continue;
+			if (branch == MUVGC_NO_BLOCK) {
+				branch = instructions->indexes[i-1];
+				continue;
+			}
+			merge = instructions->indexes[i-1];
+			break;
+		}
+		if (merge == MUVGC_NO_BLOCK || module->instructions[branch].opcode != MUVGC_OP_BRANCH_CONDITIONAL ||
+			module->instructions[merge].opcode != MUVGC_OP_SELECTION_MERGE) {
+			return MU_FALSE;
+		}
+		muVGCOperand* branch_operands = muVGC_module_get_operands(module, branch);
+		uint32_m condition = branch_operands[0].word;
+		uint32_m true_label = branch_operands[1].word;
+		uint32_m false_label = branch_operands[2].word;
+		muVGCOperand* merge_operands = muVGC_module_get_operands(module, merge);
+		uint32_m merge_label = merge_operands[0].word;
+		uint32_m selection_control = merge_operands[1].word;
+		if ((selection_control & MUVGC_SELECTION_CONTROL_DONT_FLATTEN) != 0 || true_label == false_label) {
+			return MU_FALSE;
+		}
+		muVGCInstruction* constant = muVGC_module_get_definition(module, condition);
+		if (constant != MU_NULL_PTR && (constant->opcode == MUVGC_OP_CONSTANT_TRUE || constant->opcode == MUVGC_OP_CONSTANT_FALSE)) {
+			return MU_FALSE;
+		}
+
+		// Sides (the header itself standing in for a missing one)
+		uint32_m header_label = module->instructions[module->blocks[header_block].label].result_id;
+		size_m cost = 0;
+		uint32_m sides[2] = { true_label, false_label };
+		uint32_m incoming[2] = { true_label, false_label };
+		for (size_m s = 0; s < 2; s++) {
+			if (sides[s] == merge_label) {
+				incoming[s] = header_label;
+				continue;
+			}
+			size_m side_cost = muVGC_selection_side_cost(module, function_index, cfg, header, sides[s], merge_label);
+			if (side_cost == MUVGC_NO_BLOCK) {
+				return MU_FALSE;
+			}
+			cost += side_cost;
+		}
+		if ((selection_control & MUVGC_SELECTION_CONTROL_FLATTEN) == 0 && cost > MUVGC_SELECT_THRESHOLD) {
+			return MU_FALSE;
+		}
+
+		// Merge block: reached from the sides only, with phis OpSelect can
+		// stand in for
+		size_m m = muVGC_function_find_block(module, function, merge_label);
+		if (m == MUVGC_NO_BLOCK || cfg->predecessors[m].len != 2) {
+			return MU_FALSE;
+		}
+		muVGCBlock* merge_block = &module->blocks[function->blocks.indexes[m]];
+		for (size_m i = 0; i < merge_block->instructions.len; i++) {
+			muVGCInstruction* phi = &module->instructions[merge_block->instructions.indexes[i]];
+			if (phi->active == MU_FALSE) continue;
+			if (phi->opcode != MUVGC_OP_PHI) break;
+			if (phi->operand_len != 4 || muVGC_phi_get_incoming(module, phi, incoming[0]) == 0 || muVGC_phi_get_incoming(module, phi, incoming[1]) == 0) {
+				return MU_FALSE;
+			}
+			muVGCInstruction* type = muVGC_module_get_definition(module, phi->result_type);
+			if (type == MU_NULL_PTR || (type->opcode != MUVGC_OP_TYPE_BOOL && type->opcode != MUVGC_OP_TYPE_INT &&
+				type->opcode != MUVGC_OP_TYPE_FLOAT && type->opcode != MUVGC_OP_TYPE_VECTOR)) {
+				return MU_FALSE;
+			}
+			if (type->opcode == MUVGC_OP_TYPE_VECTOR && module->operands[type->operand_index+1].word > 4) {
+				return MU_FALSE;
+			}
+		}
+
+		// Hoist the sides into the header, in place of its branch
+		muVGC_module_remove_instruction(module, merge);
+		muVGC_module_remove_instruction(module, branch);
+		for (size_m s = 0; s < 2; s++) {
+			if (sides[s] == merge_label) continue;
+			size_m b = muVGC_function_find_block(module, function, sides[s]);
+			size_m block = function->blocks.indexes[b];
+			muVGCInstruction* terminator = muVGC_block_get_terminator(module, &module->blocks[block]);
+			terminator->active = MU_FALSE;
+			for (size_m i = 0; i < module->blocks[block].instructions.len; i++) {
+				size_m instruction = module->blocks[block].instructions.indexes[i];
+				if (module->instructions[instruction].active == MU_TRUE) {
+					muVGC_index_list_add(&module->blocks[header_block].instructions, instruction);
+				}
+			}
+			muVGC_module_remove_instruction(module, module->blocks[block].label);
+			module->blocks[block].instructions.len = 0;
+			for (size_m i = b; i+1 < function->blocks.len; i++) {
+				function->blocks.indexes[i] = function->blocks.indexes[i+1];
+			}
+			function->blocks.len -= 1;
+		}
+
+		// Phis become selects (keeping their result ids); vector results
+		// need the condition as a vector of bools
+		size_m m_block = function->blocks.indexes[muVGC_function_find_block(module, function, merge_label)];
+		uint32_m vector_conditions[5] = { 0, 0, 0, 0, 0 };
+		for (size_m i = 0; i < module->blocks[m_block].instructions.len; i++) {
+			size_m instruction = module->blocks[m_block].instructions.indexes[i];
+			muVGCInstruction* phi = &module->instructions[instruction];
+			if (phi->active == MU_FALSE) continue;
+			if (phi->opcode != MUVGC_OP_PHI) break;
+			uint32_m result_type = phi->result_type;
+			uint32_m result_id = phi->result_id;
+			uint32_m true_value = muVGC_phi_get_incoming(module, phi, incoming[0]);
+			uint32_m false_value = muVGC_phi_get_incoming(module, phi, incoming[1]);
+			muVGC_module_remove_instruction(module, instruction);
+
+			uint32_m selector = condition;
+			muVGCInstruction* type = muVGC_module_get_definition(module, result_type);
+			if (type->opcode == MUVGC_OP_TYPE_VECTOR) {
+				uint32_m component_count = module->operands[type->operand_index+1].word;
+				if (vector_conditions[component_count] == 0) {
+					vector_conditions[component_count] = muVGC_module_new_id(module);
+					uint32_m bool_vector = muVGC_get_vector_type(module, muVGC_get_bool_type(module), component_count);
+					muVGCOperand operands[] = { MUVGC_ID(condition), MUVGC_ID(condition), MUVGC_ID(condition), MUVGC_ID(condition) };
+					muVGC_module_emit_to_block(module, header_block, MUVGC_OP_COMPOSITE_CONSTRUCT, bool_vector, vector_conditions[component_count], operands, component_count);
+				}
+				selector = vector_conditions[component_count];
+			}
+			muVGCOperand operands[] = { MUVGC_ID(selector), MUVGC_ID(true_value), MUVGC_ID(false_value) };
+			muVGC_module_emit_to_block(module, header_block, MUVGC_OP_SELECT, result_type, result_id, operands, 3);
+		}
+		muVGC_op_branch(module, header_block, merge_label);
+		return MU_TRUE;
+	}
+
+	void muVGC_convert_branches_to_selects(muVGCModule* module) {
+		for (size_m f = 0; f < module->function_len; f++) {
+			if (module->functions[f].active == MU_FALSE) continue;
+			muBool converted = MU_TRUE;
+			while (converted == MU_TRUE) {
+				converted = MU_FALSE;
+				muVGCCFG cfg;
+				muVGC_compute_cfg(module, f, &cfg);
+				// (Inner selections first, so that outer ones can be converted
+				// once they're straight-line code)
+				for (size_m h = cfg.block_len; h > 0; h--) {
+					if (muVGC_convert_selection(module, f, &cfg, h-1) == MU_TRUE) {
+						converted = MU_TRUE;
+						break;
+					}
+				}
+				muVGC_free_cfg(&cfg);
+				if (converted == MU_TRUE) {
+					muVGC_merge_function_blocks(module, f);
+				}
+			}
+		}
+	}
+
+	// Id compaction
+
+	// Renumbers every id in the order it first shows up in the module's
+	// binary, so that ids are packed densely (making the bound the number
+	// of live ids plus one) and the same module always ends up numbered
+	// the same way, no matter which ids passes made & abandoned along the
+	// way. Only what gets serialized is renumbered, so this has to be the
+	// last pass.
+
+	void muVGC_compact_instruction_ids(muVGCModule* module, muVGCInstruction* inst, uint32_m* map, uint32_m* next) {
+		if (inst->result_type != 0 && inst->result_type < module->bound) {
+			if (map[inst->result_type] == 0) {
+				map[inst->result_type] = (*next)++;
+			}
+			inst->result_type = map[inst->result_type];
+		}
+		if (inst->result_id != 0 && inst->result_id < module->bound) {
+			if (map[inst->result_id] == 0) {
+				map[inst->result_id] = (*next)++;
+			}
+			inst->result_id = map[inst->result_id];
+		}
+		muVGCOperand* operands = &module->operands[inst->operand_index];
+		for (size_m i = 0; i < inst->operand_len; i++) {
+			if (operands[i].is_id == MU_FALSE || operands[i].word == 0 || operands[i].word >= module->bound) continue;
+			if (map[operands[i].word] == 0) {
+				map[operands[i].word] = (*next)++;
+			}
+			operands[i].word = map[operands[i].word];
+		}
+	}
+
+	void muVGC_compact_ids(muVGCModule* module) {
+		uint32_m* map = mu_malloc(sizeof(uint32_m) * module->bound);
+		for (uint32_m i = 0; i < module->bound; i++) {
+			map[i] = 0;
+		}
+		uint32_m next = 1;
+
+		// (Same order as muVGC_module_serialize)
+		for (size_m s = MUVGC_SECTION_FIRST; s < MUVGC_SECTION_FUNCTION; s++) {
+			for (size_m i = 0; i < module->sections[s].len; i++) {
+				muVGCInstruction* inst = &module->instructions[module->sections[s].indexes[i]];
+				if (inst->active == MU_TRUE) {
+					muVGC_compact_instruction_ids(module, inst, map, &next);
+				}
+			}
+		}
+		for (size_m f = 0; f < module->function_len; f++) {
+			muVGCFunction* function = &module->functions[f];
+			if (function->active == MU_FALSE) continue;
+			muVGC_compact_instruction_ids(module, &module->instructions[function->instruction], map, &next);
+			for (size_m p = 0; p < function->parameters.len; p++) {
+				muVGC_compact_instruction_ids(module, &module->instructions[function->parameters.indexes[p]], map, &next);
+			}
+			for (size_m b = 0; b < function->blocks.len; b++) {
+				muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+				muVGC_compact_instruction_ids(module, &module->instructions[block->label], map, &next);
+				for (size_m i = 0; i < block->instructions.len; i++) {
+					muVGCInstruction* inst = &module->instructions[block->instructions.indexes[i]];
+					if (inst->active == MU_TRUE) {
+						muVGC_compact_instruction_ids(module, inst, map, &next);
+					}
+				}
+			}
+		}
+
+		if (module->entry_point != 0 && module->entry_point < module->bound) {
+			module->entry_point = map[module->entry_point];
+		}
+		for (size_m i = 0; i < module->reflected_variable_len; i++) {
+			muVGCReflectedVariable* variable = &module->reflected_variables[i];
+			variable->id = (variable->id < module->bound) ? map[variable->id] : 0;
+		}
+
+		// Rebuild the definitions from whatever is still defined
+		for (size_m i = 0; i < module->allocated_definition_len; i++) {
+			module->definitions[i] = 0;
+		}
+		module->bound = next;
+		for (size_m s = MUVGC_SECTION_FIRST; s < MUVGC_SECTION_FUNCTION; s++) {
+			for (size_m i = 0; i < module->sections[s].len; i++) {
+				size_m instruction = module->sections[s].indexes[i];
+				if (module->instructions[instruction].active == MU_TRUE && module->instructions[instruction].result_id != 0) {
+					muVGC_module_set_definition(module, module->instructions[instruction].result_id, instruction+1);
+				}
+			}
+		}
+		for (size_m f = 0; f < module->function_len; f++) {
+			muVGCFunction* function = &module->functions[f];
+			if (function->active == MU_FALSE) continue;
+			muVGC_module_set_definition(module, module->instructions[function->instruction].result_id, function->instruction+1);
+			for (size_m p = 0; p < function->parameters.len; p++) {
+				size_m instruction = function->parameters.indexes[p];
+				muVGC_module_set_definition(module, module->instructions[instruction].result_id, instruction+1);
+			}
+			for (size_m b = 0; b < function->blocks.len; b++) {
+				muVGCBlock* block = &module->blocks[function->blocks.indexes[b]];
+				muVGC_module_set_definition(module, module->instructions[block->label].result_id, block->label+1);
+				for (size_m i = 0; i < block->instructions.len; i++) {
+					size_m instruction = block->instructions.indexes[i];
+					if (module->instructions[instruction].active == MU_TRUE && module->instructions[instruction].result_id != 0) {
+						muVGC_module_set_definition(module, module->instructions[instruction].result_id, instruction+1);
+					}
+				}
+			}
+		}
+
+		// (Shared globals were renumbered too)
+		if (module->global_table_capacity != 0) {
+			muVGC_module_rehash_globals(module, module->global_table_capacity);
+		}
+
+		mu_free(map);
+	}
+
+	// Interface footprints
+
+	// How much of the location space an input/output of a type takes up:
+	// types fitting in a single location use some of its four 32-bit
+	// components (16-bit components using up a whole one, 64-bit ones two),
+	// while matrices, arrays and 64-bit vectors of more than two components
+	// take up whole locations. Variables sharing a location must have the
+	// same kind of components.
+	struct muVGCFootprint {
+		uint32_m locations;
+		// (4 for types taking up whole locations)
+		uint32_m components;
+		// (opcode, width and signedness of the component type; 0 for
+		// anything else)
+		uint32_m kind;
+		// (64-bit types can only start at component 0 or 2)
+		uint32_m alignment;
+	};
+	typedef struct muVGCFootprint muVGCFootprint;
+
+	muVGCFootprint muVGC_get_footprint(muVGCModule* module, uint32_m type) {
+		muVGCFootprint footprint = { 1, 4, 0, 1 };
+		muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+		if (inst != MU_NULL_PTR && inst->opcode == MUVGC_OP_TYPE_ARRAY) {
+			muVGCConstant length;
+			footprint = muVGC_get_footprint(module, module->operands[inst->operand_index].word);
+			if (muVGC_fold_get_constant(module, module->operands[inst->operand_index+1].word, &length) == MU_TRUE) {
+				footprint.locations *= length.words[0];
+			}
+			footprint.components = 4;
+			return footprint;
+		}
+
+		uint32_m columns = 1, rows = 1;
+		if (inst != MU_NULL_PTR && inst->opcode == MUVGC_OP_TYPE_MATRIX) {
+			columns = module->operands[inst->operand_index+1].word;
+			inst = muVGC_module_get_definition(module, module->operands[inst->operand_index].word);
+		}
+		if (inst != MU_NULL_PTR && inst->opcode == MUVGC_OP_TYPE_VECTOR) {
+			rows = module->operands[inst->operand_index+1].word;
+			inst = muVGC_module_get_definition(module, module->operands[inst->operand_index].word);
+		}
+		if (inst == MU_NULL_PTR || (inst->opcode != MUVGC_OP_TYPE_INT && inst->opcode != MUVGC_OP_TYPE_FLOAT)) {
+			return footprint;
+		}
+
+		uint32_m width = module->operands[inst->operand_index].word;
+		uint32_m signedness = (inst->opcode == MUVGC_OP_TYPE_INT) ? module->operands[inst->operand_index+1].word : 0;
+		footprint.kind = ((uint32_m)inst->opcode << 16) | (width << 1) | signedness;
+		uint32_m components = (width == 64) ? rows*2 : rows;
+		footprint.alignment = (width == 64) ? 2 : 1;
+		if (columns > 1 || components > 4) {
+			footprint.locations = columns * ((components > 4) ? 2 : 1);
+			footprint.components = 4;
+		} else {
+			footprint.components = components;
+		}
+		return footprint;
+	}
+
+	// Output pruning
+
+	// Outputs the next stage never reads still cost bandwidth (on tile-based
+	// GPUs, they get written out to memory for every vertex), so once the
+	// locations the next stage reads are known, any other output is turned
+	// into a private variable, which dead code elimination then removes
+	// along with its stores. Nothing gets moved to another location, since
+	// the next stage expects the ones it was compiled with.
+
+	// Turns an output that none of the read locations overlap into a
+	// private variable; returns MU_FALSE if it's kept
+	muBool muVGC_prune_output(muVGCModule* module, uint32_m variable, uint32_m read_locations) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, variable);
+		if (inst == MU_NULL_PTR || inst->opcode != MUVGC_OP_VARIABLE || module->operands[inst->operand_index].word != MUVGC_STORAGE_CLASS_OUTPUT) {
+			return MU_FALSE;
+		}
+		// (Built-ins have no location)
+		size_m location = muVGC_find_decoration(module, variable, MUVGC_DECORATION_LOCATION);
+		if (location == MUVGC_NO_DECORATION) {
+			return MU_FALSE;
+		}
+		uint32_m first = module->operands[module->instructions[location].operand_index+2].word;
+		muVGCInstruction* pointer_type = muVGC_module_get_definition(module, inst->result_type);
+		uint32_m type = module->operands[pointer_type->operand_index+1].word;
+		muVGCFootprint footprint = muVGC_get_footprint(module, type);
+		for (uint32_m l = first; l < first+footprint.locations; l++) {
+			if (l >= 32 || (read_locations & ((uint32_m)1 << l)) != 0) {
+				return MU_FALSE;
+			}
+		}
+
+		// (The variable is declared again so that it comes after its new
+		// pointer type)
+		muVGC_module_remove_instruction(module, module->definitions[variable]-1);
+		uint32_m private_pointer_type = muVGC_get_pointer_type(module, MUVGC_STORAGE_CLASS_PRIVATE, type);
+		muVGCOperand operands[] = { MUVGC_LITERAL(MUVGC_STORAGE_CLASS_PRIVATE) };
+		muVGC_module_emit(module, MUVGC_SECTION_GLOBAL, MUVGC_OP_VARIABLE, private_pointer_type, variable, operands, 1);
+
+		// (Private variables can't have interface decorations)
+		muVGCIndexList* annotations = &module->sections[MUVGC_SECTION_ANNOTATION];
+		for (size_m i = 0; i < annotations->len; i++) {
+			muVGCInstruction* annotation = &module->instructions[annotations->indexes[i]];
+			if (annotation->active == MU_TRUE && annotation->opcode == MUVGC_OP_DECORATE && module->operands[annotation->operand_index].word == variable) {
+				muVGC_module_remove_instruction(module, annotations->indexes[i]);
+			}
+		}
+		return MU_TRUE;
+	}
+
+	void muVGC_prune_outputs(muVGCModule* module, uint32_m read_locations) {
+		muVGCIndexList* entry_points = &module->sections[MUVGC_SECTION_ENTRY_POINT];
+		for (size_m e = 0; e < entry_points->len; e++) {
+			size_m index = entry_points->indexes[e];
+			if (module->instructions[index].active == MU_FALSE) continue;
+
+			// (Interface ids come after the execution model, entry point
+			// and name, which is all literals)
+			size_m kept = 0;
+			for (size_m i = 0; i < module->instructions[index].operand_len; i++) {
+				muVGCOperand operand = module->operands[module->instructions[index].operand_index+i];
+				if (i < 2 || operand.is_id == MU_FALSE || muVGC_prune_output(module, operand.word, read_locations) == MU_FALSE) {
+					module->operands[module->instructions[index].operand_index+kept] = operand;
+					kept++;
+				}
+			}
+			module->instructions[index].operand_len = kept;
+		}
+	}
+
+	// Pass pipeline
+
+	void muVGC_optimize_module(muVGCModule* module) {
+		muVGC_inline_functions(module);
+		muVGC_merge_blocks(module);
+		muVGC_promote_variables(module);
+		muVGC_fold_constants(module);
+		muVGC_unroll_loops(module);
+		muVGC_merge_blocks(module);
+		muVGC_fold_constants(module);
+		muVGC_fold_branches(module);
+		muVGC_merge_blocks(module);
+		muVGC_convert_branches_to_selects(module);
+		muVGC_eliminate_common_subexpressions(module);
+		muVGC_eliminate_dead_code(module);
+		muVGC_compact_ids(module);
+	}
+
+/* MACRO HANDLING */
+
+	muResult muVGC_is_version_valid(muString code, const char* og, size_m* number_index, size_m* beg, size_m* end) {
+		size_m i = muVGC_get_next_non_empty_char(code.s, mu_string_strlen(code), 0);
+		if (i >= mu_string_strlen(code)) {
+			muVGC_print_syntax_error(og, 0);
+			mu_print("string passed contains no readable code\n");
+			return MU_FAILURE;
+		}
+
+		*beg = i;
+		if (code.s[i] != '#') {
+			muVGC_print_syntax_error(og, i);
+			mu_print("expected '#' as first token to specify version\n");
+			return MU_FAILURE;
+		}
+
+		i = muVGC_get_next_non_space(code.s, mu_string_strlen(code), i+1);
+		if ((i+8 >= mu_string_strlen(code)) || (mu_strncmp(&code.s[i], "version ", 8) != 0)) {
+			muVGC_print_syntax_error(og, i);
+			mu_print("expected 'version' after token '#'\n");
+			return MU_FAILURE;
+		}
+
+		i = muVGC_get_next_non_space(code.s, mu_string_strlen(code), i+7);
+		*number_index = i;
+		if (i >= mu_string_strlen(code) || (code.s[i] >= '0' && code.s[i] <= '9') == MU_FALSE) {
+			muVGC_print_syntax_error(og, i);
+			mu_print("expected number after '#version'\n");
+			return MU_FAILURE;
+		}
+
+		size_m end_i = muVGC_get_next_empty_char(code.s, mu_string_strlen(code), i);
+		for (size_m j = i; j < end_i; j++) {
+			if ((code.s[j] >= '0' && code.s[j] <= '9') == MU_FALSE) {
+				muVGC_print_syntax_error(og, i);
+				mu_print("expected number after '#version'\n");
+				return MU_FAILURE;
+			}
+		}
+		i = end_i;
+		*end = end_i;
+
+		i = muVGC_get_next_non_space(code.s, mu_string_strlen(code), i);
+		if (i >= mu_string_strlen(code) || code.s[i] == '\n') {
+			return MU_SUCCESS;
+		}
+
+		end_i = muVGC_get_next_empty_char(code.s, mu_string_strlen(code), i);
+		if ((end_i-i != 4) || (mu_strncmp(&code.s[i], "core", 4) != 0)) {
+			muVGC_print_syntax_error(og, i);
+			mu_print("expected anything after '#version N' to be 'core'\n");
+			return MU_FAILURE;
+		}
+
+		i = end_i;
+		end_i = muVGC_get_next_new_line(code.s, mu_string_strlen(code), end_i);
+		for (size_m j = i; j < end_i; j++) {
+			if (muVGC_is_character_empty(code.s[j]) == MU_FALSE) {
+				muVGC_print_syntax_error(og, j);
+				mu_print("expected only newline after version directive\n");
+				return MU_FAILURE;
+			}
+		}
+		*end = end_i;
+
+		return MU_SUCCESS;
+	}
+
+	// Module preamble
+
+	// Every module starts with the same instructions, only a few operands
+	// (the execution model, the id of 'main' and the GLSL version) and
+	// whether the debug ones are stripped changing between them. They're
+	// kept here with their operands (strings included) as ready-made words,
+	// so that starting a module just copies each one in and patches the
+	// operands that change.
+
+	#define MUVGC_STRING_WORD(a, b, c, d) MUVGC_LITERAL((uint32_m)(a) | ((uint32_m)(b) << 8) | ((uint32_m)(c) << 16) | ((uint32_m)(d) << 24))
+
+	struct muVGCPreambleInstruction {
+		muVGCSection section;
+		uint16_m opcode;
+		const muVGCOperand* operands;
+		size_m operand_len;
+	};
+	typedef struct muVGCPreambleInstruction muVGCPreambleInstruction;
+
+	// OpCapability Shader
+	static const muVGCOperand muVGC_global_preamble_capability[] = {
+		MUVGC_LITERAL(MUVGC_CAPABILITY_SHADER)
+	};
+	// %1 = OpExtInstImport "GLSL.std.450"
+	static const muVGCOperand muVGC_global_preamble_ext_inst_import[] = {
+		MUVGC_STRING_WORD('G', 'L', 'S', 'L'), MUVGC_STRING_WORD('.', 's', 't', 'd'), MUVGC_STRING_WORD('.', '4', '5', '0'), MUVGC_LITERAL(0)
+	};
+	// OpMemoryModel Logical GLSL450
+	static const muVGCOperand muVGC_global_preamble_memory_model[] = {
+		MUVGC_LITERAL(0), MUVGC_LITERAL(1)
+	};
+	// OpEntryPoint (execution model) %main "main"
+	static const muVGCOperand muVGC_global_preamble_entry_point[] = {
+		MUVGC_LITERAL(0), MUVGC_ID(0), MUVGC_STRING_WORD('m', 'a', 'i', 'n'), MUVGC_LITERAL(0)
+	};
+	// OpSource GLSL (version)
+	static const muVGCOperand muVGC_global_preamble_source[] = {
+		MUVGC_LITERAL(2), MUVGC_LITERAL(0)
+	};
+	// OpSourceExtension "GL_GOOGLE_cpp_style_line_directive"
+	static const muVGCOperand muVGC_global_preamble_line_directive[] = {
+		MUVGC_STRING_WORD('G', 'L', '_', 'G'), MUVGC_STRING_WORD('O', 'O', 'G', 'L'), MUVGC_STRING_WORD('E', '_', 'c', 'p'),
+		MUVGC_STRING_WORD('p', '_', 's', 't'), MUVGC_STRING_WORD('y', 'l', 'e', '_'), MUVGC_STRING_WORD('l', 'i', 'n', 'e'),
+		MUVGC_STRING_WORD('_', 'd', 'i', 'r'), MUVGC_STRING_WORD('e', 'c', 't', 'i'), MUVGC_STRING_WORD('v', 'e', 0, 0)
+	};
+	// OpSourceExtension "GL_GOOGLE_include_directive"
+	static const muVGCOperand muVGC_global_preamble_include_directive[] = {
+		MUVGC_STRING_WORD('G', 'L', '_', 'G'), MUVGC_STRING_WORD('O', 'O', 'G', 'L'), MUVGC_STRING_WORD('E', '_', 'i', 'n'),
+		MUVGC_STRING_WORD('c', 'l', 'u', 'd'), MUVGC_STRING_WORD('e', '_', 'd', 'i'), MUVGC_STRING_WORD('r', 'e', 'c', 't'),
+		MUVGC_STRING_WORD('i', 'v', 'e', 0)
+	};
+
+	#define MUVGC_PREAMBLE_INSTRUCTION(section, opcode, operands) { section, opcode, operands, sizeof(operands)/sizeof(operands[0]) }
+
+	static const muVGCPreambleInstruction muVGC_global_preamble[] = {
+		MUVGC_PREAMBLE_INSTRUCTION(MUVGC_SECTION_CAPABILITY, MUVGC_OP_CAPABILITY, muVGC_global_preamble_capability),
+		MUVGC_PREAMBLE_INSTRUCTION(MUVGC_SECTION_EXT_INST_IMPORT, MUVGC_OP_EXT_INST_IMPORT, muVGC_global_preamble_ext_inst_import),
+		MUVGC_PREAMBLE_INSTRUCTION(MUVGC_SECTION_MEMORY_MODEL, MUVGC_OP_MEMORY_MODEL, muVGC_global_preamble_memory_model),
+		MUVGC_PREAMBLE_INSTRUCTION(MUVGC_SECTION_ENTRY_POINT, MUVGC_OP_ENTRY_POINT, muVGC_global_preamble_entry_point),
+		MUVGC_PREAMBLE_INSTRUCTION(MUVGC_SECTION_DEBUG_SOURCE, MUVGC_OP_SOURCE, muVGC_global_preamble_source),
+		MUVGC_PREAMBLE_INSTRUCTION(MUVGC_SECTION_DEBUG_SOURCE, MUVGC_OP_SOURCE_EXTENSION, muVGC_global_preamble_line_directive),
+		MUVGC_PREAMBLE_INSTRUCTION(MUVGC_SECTION_DEBUG_SOURCE, MUVGC_OP_SOURCE_EXTENSION, muVGC_global_preamble_include_directive)
+	};
+	#define MUVGC_PREAMBLE_LEN (sizeof(muVGC_global_preamble)/sizeof(muVGC_global_preamble[0]))
+
+	// Emits the preamble, reserving the id of 'main' as the entry point
+	// (it's used once 'main' is implemented, and interface variables are
+	// added to OpEntryPoint as they're declared)
+	void muVGC_emit_preamble(muVGCModule* module, uint32_m execution_model, uint32_m version) {
+		uint32_m ext_inst_import = muVGC_module_new_id(module);
+		module->entry_point = muVGC_module_new_id(module);
+		for (size_m i = 0; i < MUVGC_PREAMBLE_LEN; i++) {
+			const muVGCPreambleInstruction* inst = &muVGC_global_preamble[i];
+			if (inst->section == MUVGC_SECTION_DEBUG_SOURCE && module->strip_debug == MU_TRUE) continue;
+
+			uint32_m result_id = (inst->opcode == MUVGC_OP_EXT_INST_IMPORT) ? ext_inst_import : 0;
+			size_m index = muVGC_module_emit(module, inst->section, inst->opcode, 0, result_id, inst->operands, inst->operand_len);
+			muVGCOperand* operands = muVGC_module_get_operands(module, index);
+			switch (inst->opcode) {
+				default: break;
+				case MUVGC_OP_ENTRY_POINT: {
+					operands[0].word = execution_model;
+					operands[1].word = module->entry_point;
+				} break;
+				case MUVGC_OP_SOURCE: {
+					operands[1].word = version;
+				} break;
+			}
+		}
+	}
+
+	void muVGC_macro_handle_first_instructions(muResult* result, muVGCModule* module, muVGCShader shader, int64_m version) {
+		uint32_m execution_model = 0;
+
+		switch (shader) {
+			default: {
+				mu_print("[muVGC] Error compiling Vulkan GLSL code; shader passed in is unknown value\n");
+				*result = MU_FAILURE;
+				return;
+			} break;
+			case MUVGC_TESSELLATION_CONTROL: case MUVGC_TESSELLATION_EVALUATION: case MUVGC_GEOMETRY: {
+				mu_print("[muVGC] Error compiling Vulkan GLSL code; shader passed in has not been implemented yet. Sorry\n");
+				*result = MU_FAILURE;
+				return;
+			} break;
+			case MUVGC_VERTEX: {
+				execution_model = 0;
+			} break;
+			case MUVGC_FRAGMENT: {
+				execution_model = 4;
+			} break;
+			case MUVGC_COMPUTE: {
+				if (version < 430) {
+					mu_print("[muVGC] Error compiling Vulkan GLSL code; compute shaders require a version number of at least 430\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				execution_model = 5;
+			} break;
+		}
+		module->shader = shader;
+
+		switch (version) {
+			default: {
+				mu_print("[muVGC] Error compiling Vulkan GLSL code; invalid version number\n");
+				*result = MU_FAILURE;
+				return;
+			}
+
+			case 110: case 120: case 130: {
+				mu_print("[muVGC] Error compiling Vulkan GLSL code; version number must be at least 140\n");
+				*result = MU_FAILURE;
+				return;
+			} break;
+
+			case 140: case 150:
+			case 330: case 400: case 410: case 420: case 430:
+			case 440: case 450: case 460: break;
+		}
+
+		muVGC_emit_preamble(module, execution_model, (uint32_m)version);
+		// OpExecutionMode %main OriginUpperLeft
+		// (The local size of compute shaders is only known once their
+		// statements have been executed)
+		if (shader == MUVGC_FRAGMENT) {
+			muVGC_op_execution_mode(module, module->entry_point, MUVGC_EXECUTION_MODE_ORIGIN_UPPER_LEFT);
+		}
+	}
+
+	void muVGC_macro_handle_version(muResult* result, muString code, const char* og, muVGCModule* module, muVGCShader shader, uint32_m* version_number) {
+		size_m number_index = 0, beg = 0, end = 0;
+		if (muVGC_is_version_valid(code, og, &number_index, &beg, &end) != MU_SUCCESS) {
+			*result = MU_FAILURE;
+			return;
+		}
+
+		int64_m version = mu_get_integer_from_string(&code.s[number_index], (end-beg)-number_index);
+		muVGC_clear_code(code.s, beg, end);
+
+		muResult res = MU_SUCCESS;
+		muVGC_macro_handle_first_instructions(&res, module, shader, version);
+		if (res != MU_SUCCESS) {
+			*result = MU_FAILURE;
+			return;
+		}
+		*version_number = (uint32_m)version;
+	}
+
+	// Preprocessing
+
+	// The preprocessor pulls tokens straight from the code, handling the
+	// directives that start lines as it reaches them, and leaves behind the
+	// tokens that the statements are made of. Tokens that macros expand to
+	// are copies of the tokens of the macro's definition, so they point at
+	// its text; the few tokens with new text (pasted tokens, __LINE__, ...)
+	// have it added past the end of the code. Macros are kept in a hash
+	// table, and the full expansion of an object-like macro is cached the
+	// first time it's used, until a macro is next defined or undefined.
+	// Groups that a conditional leaves out are skipped a line at a time,
+	// only the names of the directives within them being looked at.
+	// Included files are lexed in full once per include cache, and their
+	// tokens are read (directives and all) from the cache from then on.
+
+	struct muVGCTokenList {
+		muVGCToken* tokens;
+		size_m len;
+		size_m allocated_len;
+	};
+	typedef struct muVGCTokenList muVGCTokenList;
+
+	void muVGC_token_list_reserve(muVGCTokenList* list, size_m len) {
+		if (list->len + len <= list->allocated_len) {
+			return;
+		}
+		if (list->allocated_len == 0) {
+			list->allocated_len = 8;
+		}
+		while (list->len + len > list->allocated_len) {
+			list->allocated_len *= 2;
+		}
+		list->tokens = (muVGCToken*)mu_realloc(list->tokens, sizeof(muVGCToken) * list->allocated_len);
+	}
+
+	void muVGC_token_list_add(muVGCTokenList* list, muVGCToken token) {
+		muVGC_token_list_reserve(list, 1);
+		list->tokens[list->len] = token;
+		list->len += 1;
+	}
+
+	void muVGC_token_list_add_tokens(muVGCTokenList* list, const muVGCToken* tokens, size_m len) {
+		muVGC_token_list_reserve(list, len);
+		for (size_m i = 0; i < len; i++) {
+			list->tokens[list->len+i] = tokens[i];
+		}
+		list->len += len;
+	}
+
+	void muVGC_token_list_free(muVGCTokenList* list) {
+		if (list->tokens != MU_NULL_PTR) {
+			mu_free(list->tokens);
+		}
+		list->tokens = MU_NULL_PTR;
+		list->len = 0;
+		list->allocated_len = 0;
+	}
+
+	// Macros
+
+	#define MUVGC_MAX_MACRO_PARAMETERS 32
+
+	// Predefined macros whose expansion changes as the code goes on
+	enum muVGCDynamicMacro {
+		MUVGC_MACRO_STATIC=0,
+		MUVGC_MACRO_LINE,
+		MUVGC_MACRO_FILE
+	};
+	typedef enum muVGCDynamicMacro muVGCDynamicMacro;
+
+	struct muVGCMacro {
+		// (A slot with an empty name is free)
+		muVGCToken name;
+		uint32_m hash;
+		// (Undefined macros keep their slot so that lookups keep probing
+		// past it)
+		muBool defined;
+		muBool predefined;
+		muVGCDynamicMacro dynamic;
+		muBool is_function;
+		// Whether its replacement list uses '##'
+		muBool pastes;
+		// Its parameters and then its replacement list, in the
+		// preprocessor's macro tokens
+		size_m first_token;
+		size_m parameter_len;
+		size_m replacement_len;
+		// Whether it's being expanded (and so can't be again until that's
+		// done)
+		muBool expanding;
+		// The full expansion of an object-like macro, cached in the
+		// preprocessor's cache tokens, valid while 'cache_generation' is the
+		// preprocessor's generation
+		size_m cache_generation;
+		muBool cacheable;
+		size_m first_cached;
+		size_m cached_len;
+		// Which of the watched names it is (+1, 0 meaning none); see
+		// muVGCMacroWatch
+		size_m watched;
+	};
+	typedef struct muVGCMacro muVGCMacro;
+
+	// Includes
+
+	#define MUVGC_MAX_INCLUDE_DEPTH 32
+
+	struct muVGCCachedFile {
+		char* name;
+		size_m namelen;
+		uint32_m hash;
+		// Its code (with comments handled) and all of its tokens, indexed
+		// from the start of that code, along with whether each starts a line
+		muString code;
+		muVGCToken* tokens;
+		muBool* line_starts;
+		size_m token_len;
+	};
+	typedef struct muVGCCachedFile muVGCCachedFile;
+
+	struct muVGCIncludeCache {
+		muVGCCachedFile* files;
+		size_m file_len;
+		size_m allocated_file_len;
+	};
+
+	void muVGC_free_cached_file(muVGCCachedFile* file) {
+		if (file->name != MU_NULL_PTR) {
+			mu_free(file->name);
+		}
+		file->code = mu_string_destroy(file->code);
+		if (file->tokens != MU_NULL_PTR) {
+			mu_free(file->tokens);
+			mu_free(file->line_starts);
+		}
+	}
+
+	void muVGC_free_include_cache(muVGCIncludeCache* cache) {
+		for (size_m i = 0; i < cache->file_len; i++) {
+			muVGC_free_cached_file(&cache->files[i]);
+		}
+		if (cache->files != MU_NULL_PTR) {
+			mu_free(cache->files);
+		}
+		*cache = (muVGCIncludeCache){ 0 };
+	}
+
+	// Stands for the shader's own code (lexed ahead of time) in place of a
+	// file within the include cache, or for the text of the options'
+	// defines in place of an included file
+	#define MUVGC_NO_FILE ((size_m)-1)
+
+	// Where an included file's code was added to the code
+	struct muVGCIncludedText {
+		size_m base;
+		size_m len;
+		// (Within the include cache)
+		size_m file;
+	};
+	typedef struct muVGCIncludedText muVGCIncludedText;
+
+	struct muVGCConditional {
+		// The '#' of the directive opening it
+		size_m index;
+		// Whether one of its groups has been included, and whether it's
+		// reached its #else
+		muBool taken;
+		muBool has_else;
+	};
+	typedef struct muVGCConditional muVGCConditional;
+
+	struct muVGCPreprocessor {
+		const muVGCOptions* options;
+		muString* code;
+		// Length of the code itself, and of it with the text added past it
+		size_m code_len;
+		size_m text_len;
+		const char* og;
+		uint32_m version;
+
+		// Hash table of macros (its capacity being a power of 2)
+		muVGCMacro* macros;
+		size_m macro_capacity;
+		size_m macro_slot_len;
+		// The tokens of macro definitions, along with which parameter (+1,
+		// 0 meaning none) each is
+		muVGCTokenList macro_tokens;
+		uint32_m* macro_token_parameters;
+		size_m allocated_macro_token_parameter_len;
+
+		// Bumped whenever a macro is defined or undefined, invalidating
+		// cached expansions
+		size_m generation;
+		muVGCTokenList cache;
+		// Number of macros being expanded
+		size_m expanding_len;
+		// Whether __LINE__ or __FILE__ has been expanded (since last reset)
+		muBool used_dynamic;
+		// Whether a macro's arguments are being read from the code
+		muBool reading_arguments;
+
+		// Open conditionals, innermost last, and where the ones opened in
+		// the file being read start
+		muVGCConditional* conditionals;
+		size_m conditional_len;
+		size_m allocated_conditional_len;
+		size_m conditional_base;
+
+		muVGCIncludeCache* include_cache;
+		// The shader's code lexed ahead of time (if it was)
+		muVGCCachedFile* lexed_source;
+		muVGCIncludedText* included_texts;
+		size_m included_text_len;
+		size_m allocated_included_text_len;
+
+		// Index of the last token (or directive) read from the code, and
+		// what #line has changed line numbers by & the source string number
+		size_m last_index;
+		int64_m line_offset;
+		uint32_m source;
+
+		// Tokens of a directive's line
+		muVGCTokenList line;
+		// The 0 & 1 that 'defined' becomes
+		muVGCToken zero;
+		muVGCToken one;
+
+		// Whether each watched name has been looked up (once the given
+		// macros are defined), if names are being watched
+		muBool* watched_read;
+	};
+	typedef struct muVGCPreprocessor muVGCPreprocessor;
+
+	// Tokens of an expansion being read
+	struct muVGCMacroContext {
+		// Its tokens within the reader's stack, and the next one to read
+		size_m first;
+		size_m end;
+		size_m position;
+		// The macro expanded (its slot in the preprocessor's macros)
+		size_m macro;
+	};
+	typedef struct muVGCMacroContext muVGCMacroContext;
+
+	// An included file being read
+	struct muVGCIncludeFrame {
+		// The file (within the include cache), where its code was added to
+		// the code, and its next token
+		size_m file;
+		size_m base;
+		size_m position;
+		// What the including file's conditional base & line numbering were
+		size_m conditional_base;
+		int64_m line_offset;
+		uint32_m source;
+	};
+	typedef struct muVGCIncludeFrame muVGCIncludeFrame;
+
+	struct muVGCTokenReader {
+		// Whether tokens are read from the code (handling directives) or
+		// from a fixed list
+		muBool lexing;
+		size_m position;
+		muBool line_start;
+		const muVGCToken* tokens;
+		size_m token_len;
+		// Included files being read (for readers lexing the code), innermost
+		// last
+		muVGCIncludeFrame* files;
+		size_m file_len;
+		size_m allocated_file_len;
+		// Expansions being read, innermost last
+		muVGCTokenList stack;
+		muVGCMacroContext* contexts;
+		size_m context_len;
+		size_m allocated_context_len;
+	};
+	typedef struct muVGCTokenReader muVGCTokenReader;
+
+	struct muVGCMacroArguments {
+		// As they were written, and with their macros expanded
+		muVGCTokenList raw;
+		muVGCTokenList expanded;
+		size_m raw_first[MUVGC_MAX_MACRO_PARAMETERS];
+		size_m raw_len[MUVGC_MAX_MACRO_PARAMETERS];
+		size_m expanded_first[MUVGC_MAX_MACRO_PARAMETERS];
+		size_m expanded_len[MUVGC_MAX_MACRO_PARAMETERS];
+		size_m len;
+	};
+	typedef struct muVGCMacroArguments muVGCMacroArguments;
+
+	// Returns the included file's code that an index is in, or MU_NULL_PTR
+	// if it's in the shader's own code (or other added text)
+	muVGCIncludedText* muVGC_find_included_text(muVGCPreprocessor* pp, size_m index) {
+		if (index < pp->code_len) {
+			return MU_NULL_PTR;
+		}
+		for (size_m i = 0; i < pp->included_text_len; i++) {
+			muVGCIncludedText* text = &pp->included_texts[i];
+			if (index >= text->base && index <= text->base + text->len) {
+				return text;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Prints the start of a syntax error for the code at 'index', naming the
+	// file if it's in an included one
+	void muVGC_print_preprocessor_error(muVGCPreprocessor* pp, size_m index) {
+		muVGCIncludedText* text = muVGC_find_included_text(pp, index);
+		if (text == MU_NULL_PTR) {
+			muVGC_print_syntax_error(pp->og, index);
+			return;
+		}
+		if (text->file == MUVGC_NO_FILE) {
+			mu_printf("[muVGC] Syntax error (define '%.*s'); ", (int)text->len, &pp->code->s[text->base]);
+			return;
+		}
+		muVGCCachedFile* file = &pp->include_cache->files[text->file];
+		mu_print("[muVGC] Syntax error (%s, line %zu, character %zu); ", file->name, muVGC_get_line_of_code(file->code.s, index - text->base), muVGC_get_character(file->code.s, index - text->base));
+	}
+
+	// Returns the line of the code at 'index' (within its file)
+	size_m muVGC_get_preprocessor_line(muVGCPreprocessor* pp, size_m index) {
+		muVGCIncludedText* text = muVGC_find_included_text(pp, index);
+		if (text == MU_NULL_PTR) {
+			return muVGC_get_line_of_code(pp->og, index);
+		}
+		if (text->file == MUVGC_NO_FILE) {
+			return 0;
+		}
+		return muVGC_get_line_of_code(pp->include_cache->files[text->file].code.s, index - text->base);
+	}
+
+	// Skips spaces & tabs (and newlines if 'lines' is MU_TRUE, noting
+	// whether any were in *newline)
+	size_m muVGC_skip_spaces(const char* code, size_m codelen, size_m i, muBool lines, muBool* newline) {
+		while (i < codelen && (code[i] == ' ' || code[i] == '\t' || (lines == MU_TRUE && code[i] == '\n'))) {
+			if (code[i] == '\n') {
+				*newline = MU_TRUE;
+			}
+			i++;
+		}
+		return i;
+	}
+
+	// Adds text past the end of the code (after the nul ending it, so that
+	// it's never read as code), returning where it starts; 'from' is taken
+	// as an index into the code if 'text' is MU_NULL_PTR
+	size_m muVGC_add_code_text(muVGCPreprocessor* pp, const char* text, size_m from, size_m len) {
+		size_m index = pp->text_len + 1;
+		*pp->code = mu_string_size_check(*pp->code, index + len + 1);
+		char* s = pp->code->s;
+		for (size_m i = 0; i < len; i++) {
+			s[index+i] = (text == MU_NULL_PTR) ? s[from+i] : text[i];
+		}
+		s[index+len] = '\0';
+		pp->text_len = index + len;
+		return index;
+	}
+
+	muVGCToken muVGC_make_code_token(muVGCPreprocessor* pp, const char* text, size_m len) {
+		size_m index = muVGC_add_code_text(pp, text, 0, len);
+		return muVGC_get_token(pp->code->s, pp->text_len, index);
+	}
+
+	muVGCToken muVGC_make_integer_token(muVGCPreprocessor* pp, uint32_m value) {
+		char digits[10];
+		size_m len = 0;
+		do {
+			digits[sizeof(digits)-1-len] = (char)('0' + value%10);
+			value /= 10;
+			len++;
+		} while (value != 0);
+		return muVGC_make_code_token(pp, &digits[sizeof(digits)-len], len);
+	}
+
+	muBool muVGC_token_text_equals(const char* code, muVGCToken token, const char* text, size_m len) {
+		return (token.length == len && mu_strncmp(&code[token.index], text, len) == 0) ? MU_TRUE : MU_FALSE;
+	}
+
+	muBool muVGC_is_macro_name_token(muVGCToken token) {
+		return (token.type == MUVGC_TOKEN_IDENTIFIER || token.type == MUVGC_TOKEN_KEYWORD || token.type == MUVGC_TOKEN_RESERVED_KEYWORD) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Returns the slot of the macro with the given name (defined or not), or
+	// of the free slot where it would go
+	size_m muVGC_find_macro_slot(muVGCPreprocessor* pp, const char* name, size_m len, uint32_m hash) {
+		size_m mask = pp->macro_capacity - 1;
+		for (size_m i = hash & mask; ; i = (i+1) & mask) {
+			muVGCMacro* macro = &pp->macros[i];
+			if (macro->name.length == 0) {
+				return i;
+			}
+			if (macro->hash == hash && muVGC_token_text_equals(pp->code->s, macro->name, name, len) == MU_TRUE) {
+				if (macro->watched != 0 && pp->watched_read != MU_NULL_PTR) {
+					pp->watched_read[macro->watched-1] = MU_TRUE;
+				}
+				return i;
+			}
+		}
+	}
+
+	// Returns the slot (+1) of the defined macro that a token names, or 0
+	size_m muVGC_find_macro(muVGCPreprocessor* pp, muVGCToken token) {
+		if (muVGC_is_macro_name_token(token) == MU_FALSE) {
+			return 0;
+		}
+		const char* name = &pp->code->s[token.index];
+		size_m slot = muVGC_find_macro_slot(pp, name, token.length, muVGC_hash_name(name, token.length));
+		return (pp->macros[slot].defined == MU_TRUE) ? slot+1 : 0;
+	}
+
+	// Doubles the macro table, dropping the slots of undefined macros (other
+	// than watched ones)
+	void muVGC_grow_macros(muVGCPreprocessor* pp) {
+		muVGCMacro* old = pp->macros;
+		size_m old_capacity = pp->macro_capacity;
+		pp->macro_capacity *= 2;
+		pp->macros = (muVGCMacro*)mu_malloc(sizeof(muVGCMacro) * pp->macro_capacity);
+		for (size_m i = 0; i < pp->macro_capacity; i++) {
+			pp->macros[i] = (muVGCMacro){ 0 };
+		}
+		pp->macro_slot_len = 0;
+		for (size_m i = 0; i < old_capacity; i++) {
+			if (old[i].defined == MU_TRUE || old[i].watched != 0) {
+				size_m slot = muVGC_find_macro_slot(pp, &pp->code->s[old[i].name.index], old[i].name.length, old[i].hash);
+				pp->macros[slot] = old[i];
+				pp->macro_slot_len += 1;
+			}
+		}
+		mu_free(old);
+	}
+
+	// Returns the slot for a macro to be defined with the given name
+	size_m muVGC_get_macro_slot(muVGCPreprocessor* pp, muVGCToken name) {
+		if ((pp->macro_slot_len+1)*4 > pp->macro_capacity*3) {
+			muVGC_grow_macros(pp);
+		}
+		const char* s = &pp->code->s[name.index];
+		uint32_m hash = muVGC_hash_name(s, name.length);
+		size_m slot = muVGC_find_macro_slot(pp, s, name.length, hash);
+		if (pp->macros[slot].name.length == 0) {
+			pp->macros[slot].name = name;
+			pp->macros[slot].hash = hash;
+			pp->macro_slot_len += 1;
+		}
+		return slot;
+	}
+
+	void muVGC_add_macro_token(muVGCPreprocessor* pp, muVGCToken token, uint32_m parameter) {
+		muVGC_token_list_add(&pp->macro_tokens, token);
+		if (pp->macro_tokens.len > pp->allocated_macro_token_parameter_len) {
+			pp->allocated_macro_token_parameter_len = pp->macro_tokens.allocated_len;
+			pp->macro_token_parameters = (uint32_m*)mu_realloc(pp->macro_token_parameters, sizeof(uint32_m) * pp->allocated_macro_token_parameter_len);
+		}
+		pp->macro_token_parameters[pp->macro_tokens.len-1] = parameter;
+	}
+
+	struct muVGCPredefinedMacro {
+		const char* name;
+		size_m namelen;
+		const char* value;
+		size_m valuelen;
+		muVGCDynamicMacro dynamic;
+	};
+	typedef struct muVGCPredefinedMacro muVGCPredefinedMacro;
+
+	void muVGC_define_predefined_macros(muVGCPreprocessor* pp) {
+		// (__VERSION__'s value is filled in below)
+		static const muVGCPredefinedMacro predefined[] = {
+			{ "__VERSION__", 11, 0, 0, MUVGC_MACRO_STATIC },
+			{ "GL_core_profile", 15, "1", 1, MUVGC_MACRO_STATIC },
+			{ "VULKAN", 6, "100", 3, MUVGC_MACRO_STATIC },
+			{ "GL_SPIRV", 8, "100", 3, MUVGC_MACRO_STATIC },
+			{ "GL_KHR_shader_subgroup_basic", 28, "1", 1, MUVGC_MACRO_STATIC },
+			{ "GL_KHR_shader_subgroup_vote", 27, "1", 1, MUVGC_MACRO_STATIC },
+			{ "GL_KHR_shader_subgroup_arithmetic", 33, "1", 1, MUVGC_MACRO_STATIC },
+			{ "GL_KHR_shader_subgroup_ballot", 29, "1", 1, MUVGC_MACRO_STATIC },
+			{ "GL_KHR_shader_subgroup_shuffle", 30, "1", 1, MUVGC_MACRO_STATIC },
+			{ "GL_KHR_shader_subgroup_shuffle_relative", 39, "1", 1, MUVGC_MACRO_STATIC },
+			{ "GL_KHR_shader_subgroup_clustered", 32, "1", 1, MUVGC_MACRO_STATIC },
+			{ "GL_EXT_control_flow_attributes", 30, "1", 1, MUVGC_MACRO_STATIC },
+			{ "GL_EXT_scalar_block_layout", 26, "1", 1, MUVGC_MACRO_STATIC },
+			{ "__LINE__", 8, 0, 0, MUVGC_MACRO_LINE },
+			{ "__FILE__", 8, 0, 0, MUVGC_MACRO_FILE }
+		};
+		for (size_m i = 0; i < sizeof(predefined)/sizeof(predefined[0]); i++) {
+			size_m slot = muVGC_get_macro_slot(pp, muVGC_make_code_token(pp, predefined[i].name, predefined[i].namelen));
+			muVGCMacro* macro = &pp->macros[slot];
+			macro->defined = MU_TRUE;
+			macro->predefined = MU_TRUE;
+			macro->dynamic = predefined[i].dynamic;
+			macro->first_token = pp->macro_tokens.len;
+
+			if (macro->dynamic == MUVGC_MACRO_STATIC) {
+				muVGCToken value = (predefined[i].value == MU_NULL_PTR)
+					? muVGC_make_integer_token(pp, pp->version)
+					: muVGC_make_code_token(pp, predefined[i].value, predefined[i].valuelen);
+				muVGC_add_macro_token(pp, value, 0);
+				macro->replacement_len = 1;
+			}
+		}
+	}
+
+	// Reading tokens
+
+	void muVGC_push_macro_context(muVGCPreprocessor* pp, muVGCTokenReader* reader, size_m macro, const muVGCToken* tokens, size_m len) {
+		if (reader->context_len == reader->allocated_context_len) {
+			reader->allocated_context_len = (reader->allocated_context_len == 0) ? 8 : reader->allocated_context_len*2;
+			reader->contexts = (muVGCMacroContext*)mu_realloc(reader->contexts, sizeof(muVGCMacroContext) * reader->allocated_context_len);
+		}
+
+		muVGCMacroContext* context = &reader->contexts[reader->context_len];
+		context->first = reader->stack.len;
+		muVGC_token_list_add_tokens(&reader->stack, tokens, len);
+		context->end = reader->stack.len;
+		context->position = context->first;
+		context->macro = macro;
+		reader->context_len += 1;
+
+		pp->macros[macro].expanding = MU_TRUE;
+		pp->expanding_len += 1;
+	}
+
+	void muVGC_pop_macro_context(muVGCPreprocessor* pp, muVGCTokenReader* reader) {
+		muVGCMacroContext* context = &reader->contexts[reader->context_len-1];
+		pp->macros[context->macro].expanding = MU_FALSE;
+		pp->expanding_len -= 1;
+		reader->stack.len = context->first;
+		reader->context_len -= 1;
+	}
+
+	// The lexed file an include frame reads
+	muVGCCachedFile* muVGC_get_frame_file(muVGCPreprocessor* pp, muVGCIncludeFrame* frame) {
+		return (frame->file == MUVGC_NO_FILE) ? pp->lexed_source : &pp->include_cache->files[frame->file];
+	}
+
+	void muVGC_free_token_reader(muVGCPreprocessor* pp, muVGCTokenReader* reader) {
+		while (reader->context_len != 0) {
+			muVGC_pop_macro_context(pp, reader);
+		}
+		muVGC_token_list_free(&reader->stack);
+		if (reader->contexts != MU_NULL_PTR) {
+			mu_free(reader->contexts);
+		}
+		if (reader->files != MU_NULL_PTR) {
+			mu_free(reader->files);
+		}
+	}
+
+	// Goes back to reading the file that included the one being read
+	void muVGC_pop_include_frame(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader) {
+		muVGCIncludeFrame* frame = &reader->files[reader->file_len-1];
+		// (Conditionals can't go on past the end of the file they're in)
+		if (pp->conditional_len > pp->conditional_base) {
+			muVGC_print_preprocessor_error(pp, pp->conditionals[pp->conditional_len-1].index);
+			mu_print("expected #endif to close this conditional\n");
+			*result = MU_FAILURE;
+		}
+		pp->conditional_base = frame->conditional_base;
+		pp->line_offset = frame->line_offset;
+		pp->source = frame->source;
+		reader->file_len -= 1;
+	}
+
+	size_m muVGC_handle_code_directive(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader, size_m i);
+	void muVGC_handle_file_directive(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader);
+
+	// Reads the next token, the end of the file being returned once there are
+	// no more (or if reading them failed)
+	muVGCToken muVGC_read_token(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader) {
+		muVGCToken end = { 0 };
+		end.type = MUVGC_TOKEN_END_OF_FILE;
+
+		while (MU_TRUE) {
+			// Expansions come first, their macros being re-enabled once
+			// they've been read
+			if (reader->context_len != 0) {
+				muVGCMacroContext* context = &reader->contexts[reader->context_len-1];
+				if (context->position < context->end) {
+					context->position += 1;
+					return reader->stack.tokens[context->position-1];
+				}
+				muVGC_pop_macro_context(pp, reader);
+				continue;
+			}
+
+			// Then included files
+			if (reader->file_len != 0) {
+				muVGCIncludeFrame* frame = &reader->files[reader->file_len-1];
+				muVGCCachedFile* file = muVGC_get_frame_file(pp, frame);
+				if (frame->position >= file->token_len) {
+					muVGC_pop_include_frame(result, pp, reader);
+					if (*result != MU_SUCCESS) {
+						return end;
+					}
+					continue;
+				}
+
+				muVGCToken token = file->tokens[frame->position];
+				token.index += frame->base;
+				if (file->line_starts[frame->position] == MU_TRUE && token.type == MUVGC_TOKEN_HASH) {
+					if (pp->reading_arguments == MU_TRUE) {
+						muVGC_print_preprocessor_error(pp, token.index);
+						mu_print("preprocessor directives can't be used within macro arguments\n");
+						*result = MU_FAILURE;
+						return end;
+					}
+					muVGC_handle_file_directive(result, pp, reader);
+					if (*result != MU_SUCCESS) {
+						return end;
+					}
+					continue;
+				}
+
+				if (token.type == MUVGC_TOKEN_UNKNOWN) {
+					muVGC_print_preprocessor_error(pp, token.index);
+					mu_print("unrecognized symbol\n");
+					*result = MU_FAILURE;
+					return end;
+				}
+				frame->position += 1;
+				pp->last_index = token.index;
+				return token;
+			}
+
+			if (reader->lexing == MU_FALSE) {
+				if (reader->position >= reader->token_len) {
+					return end;
+				}
+				reader->position += 1;
+				return reader->tokens[reader->position-1];
+			}
+
+			const char* code = pp->code->s;
+			muBool newline = MU_FALSE;
+			reader->position = muVGC_skip_spaces(code, pp->code_len, reader->position, MU_TRUE, &newline);
+			if (newline == MU_TRUE) {
+				reader->line_start = MU_TRUE;
+			}
+
+			muVGCToken token = muVGC_get_token(code, pp->code_len, reader->position);
+			if (token.type == MUVGC_TOKEN_END_OF_FILE) {
+				return token;
+			}
+
+			if (reader->line_start == MU_TRUE && token.type == MUVGC_TOKEN_HASH) {
+				if (pp->reading_arguments == MU_TRUE) {
+					muVGC_print_preprocessor_error(pp, token.index);
+					mu_print("preprocessor directives can't be used within macro arguments\n");
+					*result = MU_FAILURE;
+					return end;
+				}
+				reader->position = muVGC_handle_code_directive(result, pp, reader, token.index);
+				if (*result != MU_SUCCESS) {
+					return end;
+				}
+				continue;
+			}
+
+			if (token.type == MUVGC_TOKEN_UNKNOWN) {
+				muVGC_print_preprocessor_error(pp, token.index);
+				mu_print("unrecognized symbol\n");
+				*result = MU_FAILURE;
+				return end;
+			}
+
+			reader->line_start = MU_FALSE;
+			reader->position = token.index + token.length;
+			pp->last_index = token.index;
+			return token;
+		}
+	}
+
+	// Returns the next token without reading it; directives aren't handled,
+	// the '#' of one being returned as it is
+	muVGCToken muVGC_peek_token(muVGCPreprocessor* pp, muVGCTokenReader* reader) {
+		while (reader->context_len != 0) {
+			muVGCMacroContext* context = &reader->contexts[reader->context_len-1];
+			if (context->position < context->end) {
+				return reader->stack.tokens[context->position];
+			}
+			muVGC_pop_macro_context(pp, reader);
+		}
+		// (Included files are only left once read past, so the next token
+		// can be in a file that's still open below the top one)
+		for (size_m f = reader->file_len; f > 0; f--) {
+			muVGCIncludeFrame* frame = &reader->files[f-1];
+			muVGCCachedFile* file = muVGC_get_frame_file(pp, frame);
+			if (frame->position < file->token_len) {
+				muVGCToken token = file->tokens[frame->position];
+				token.index += frame->base;
+				return token;
+			}
+		}
+
+		if (reader->lexing == MU_FALSE) {
+			if (reader->position >= reader->token_len) {
+				muVGCToken end = { 0 };
+				end.type = MUVGC_TOKEN_END_OF_FILE;
+				return end;
+			}
+			return reader->tokens[reader->position];
+		}
+
+		muBool newline = MU_FALSE;
+		size_m i = muVGC_skip_spaces(pp->code->s, pp->code_len, reader->position, MU_TRUE, &newline);
+		return muVGC_get_token(pp->code->s, pp->code_len, i);
+	}
+
+	// Expansion
+
+	void muVGC_expand_tokens(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader, muVGCTokenList* out);
+
+	// Pastes two tokens together into one
+	muVGCToken muVGC_paste_tokens(muResult* result, muVGCPreprocessor* pp, muVGCToken left, muVGCToken right) {
+		size_m index = muVGC_add_code_text(pp, MU_NULL_PTR, left.index, left.length);
+		muVGC_add_code_text(pp, MU_NULL_PTR, right.index, right.length);
+		// (Both are added so that 'right' is read before the code can move;
+		// the second is then copied back over the nul between them)
+		char* s = pp->code->s;
+		for (size_m i = 0; i < right.length; i++) {
+			s[index+left.length+i] = s[index+left.length+1+i];
+		}
+		s[index+left.length+right.length] = '\0';
+		pp->text_len = index + left.length + right.length;
+
+		muVGCToken token = muVGC_get_token(s, pp->text_len, index);
+		if (token.type == MUVGC_TOKEN_UNKNOWN || token.length != left.length+right.length) {
+			muVGC_print_preprocessor_error(pp, left.index);
+			mu_print("pasting tokens together doesn't give a valid token\n");
+			*result = MU_FAILURE;
+		}
+		return token;
+	}
+
+	// Fills in a macro's replacement list with its arguments (MU_NULL_PTR for
+	// object-like macros), pasting tokens around '##'
+	void muVGC_substitute_macro(muResult* result, muVGCPreprocessor* pp, muVGCMacro* macro, muVGCMacroArguments* args, muVGCTokenList* replacement) {
+		size_m first = macro->first_token + macro->parameter_len;
+		// (The definitions won't move while substituting, but the tokens are
+		// indexed fresh anyway)
+		#define MUVGC_BODY(i) pp->macro_tokens.tokens[first+(i)]
+		#define MUVGC_PARAMETER(i) pp->macro_token_parameters[first+(i)]
+
+		// Where the operand of the next '##' starts (it being empty if it's
+		// the end of the replacement)
+		size_m operand = replacement->len;
+
+		for (size_m i = 0; i < macro->replacement_len; i++) {
+			if (MUVGC_BODY(i).type == MUVGC_TOKEN_DOUBLE_HASH) {
+				// ('##' can't end a replacement list)
+				i += 1;
+				const muVGCToken* right = &MUVGC_BODY(i);
+				size_m right_len = 1;
+				if (MUVGC_PARAMETER(i) != 0) {
+					uint32_m p = MUVGC_PARAMETER(i)-1;
+					right = &args->raw.tokens[args->raw_first[p]];
+					right_len = args->raw_len[p];
+				}
+				if (right_len == 0) {
+					continue;
+				}
+
+				if (replacement->len == operand) {
+					muVGC_token_list_add_tokens(replacement, right, right_len);
+				} else {
+					muVGCToken pasted = muVGC_paste_tokens(result, pp, replacement->tokens[replacement->len-1], right[0]);
+					if (*result != MU_SUCCESS) {
+						break;
+					}
+					replacement->tokens[replacement->len-1] = pasted;
+					muVGC_token_list_add_tokens(replacement, &right[1], right_len-1);
+				}
+				operand = replacement->len-1;
+				continue;
+			}
+
+			operand = replacement->len;
+			if (MUVGC_PARAMETER(i) == 0) {
+				muVGC_token_list_add(replacement, MUVGC_BODY(i));
+				continue;
+			}
+
+			// (Operands of '##' aren't expanded first)
+			uint32_m p = MUVGC_PARAMETER(i)-1;
+			if (i+1 < macro->replacement_len && MUVGC_BODY(i+1).type == MUVGC_TOKEN_DOUBLE_HASH) {
+				muVGC_token_list_add_tokens(replacement, &args->raw.tokens[args->raw_first[p]], args->raw_len[p]);
+			} else {
+				muVGC_token_list_add_tokens(replacement, &args->expanded.tokens[args->expanded_first[p]], args->expanded_len[p]);
+			}
+		}
+
+		#undef MUVGC_BODY
+		#undef MUVGC_PARAMETER
+	}
+
+	// Reads the arguments of a call to a function-like macro, its '(' having
+	// been read, and expands their macros
+	void muVGC_read_macro_arguments(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader, muVGCMacro* macro, muVGCToken name, muVGCMacroArguments* args) {
+		muBool was_reading_arguments = pp->reading_arguments;
+		if (reader->lexing == MU_TRUE) {
+			pp->reading_arguments = MU_TRUE;
+		}
+
+		size_m depth = 0;
+		args->len = 1;
+		args->raw_first[0] = 0;
+		while (MU_TRUE) {
+			muVGCToken token = muVGC_read_token(result, pp, reader);
+			if (*result != MU_SUCCESS) {
+				break;
+			}
+			if (token.type == MUVGC_TOKEN_END_OF_FILE) {
+				muVGC_print_preprocessor_error(pp, name.index);
+				mu_print("expected ')' to end the macro's arguments\n");
+				*result = MU_FAILURE;
+				break;
+			}
+
+			if (token.type == MUVGC_TOKEN_OPEN_PARENTHESIS) {
+				depth++;
+			} else if (token.type == MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+				if (depth == 0) {
+					break;
+				}
+				depth--;
+			} else if (token.type == MUVGC_TOKEN_COMMA && depth == 0) {
+				args->raw_len[args->len-1] = args->raw.len - args->raw_first[args->len-1];
+				if (args->len == MUVGC_MAX_MACRO_PARAMETERS) {
+					muVGC_print_preprocessor_error(pp, token.index);
+					mu_print("too many macro arguments\n");
+					*result = MU_FAILURE;
+					break;
+				}
+				args->raw_first[args->len] = args->raw.len;
+				args->len += 1;
+				continue;
+			}
+
+			muVGC_token_list_add(&args->raw, token);
+		}
+
+		pp->reading_arguments = was_reading_arguments;
+		if (*result != MU_SUCCESS) {
+			return;
+		}
+		args->raw_len[args->len-1] = args->raw.len - args->raw_first[args->len-1];
+
+		// (A macro without parameters is called as 'f()')
+		if (macro->parameter_len == 0 && args->len == 1 && args->raw_len[0] == 0) {
+			args->len = 0;
+		}
+		if (args->len != macro->parameter_len) {
+			muVGC_print_preprocessor_error(pp, name.index);
+			mu_print("expected %zu macro arguments, got %zu\n", macro->parameter_len, args->len);
+			*result = MU_FAILURE;
+			return;
+		}
+
+		for (size_m a = 0; a < args->len; a++) {
+			muVGCTokenReader arg_reader = { 0 };
+			arg_reader.tokens = &args->raw.tokens[args->raw_first[a]];
+			arg_reader.token_len = args->raw_len[a];
+			args->expanded_first[a] = args->expanded.len;
+			muVGC_expand_tokens(result, pp, &arg_reader, &args->expanded);
+			muVGC_free_token_reader(pp, &arg_reader);
+			if (*result != MU_SUCCESS) {
+				return;
+			}
+			args->expanded_len[a] = args->expanded.len - args->expanded_first[a];
+		}
+	}
+
+	// Works out the full expansion of an object-like macro (as it is wherever
+	// no other macro is being expanded) and caches it if it can be
+	void muVGC_cache_macro(muResult* result, muVGCPreprocessor* pp, size_m slot) {
+		muVGCTokenList replacement = { 0 };
+		muVGC_substitute_macro(result, pp, &pp->macros[slot], MU_NULL_PTR, &replacement);
+
+		muVGCTokenReader reader = { 0 };
+		reader.tokens = replacement.tokens;
+		reader.token_len = replacement.len;
+		size_m first = pp->cache.len;
+		pp->used_dynamic = MU_FALSE;
+
+		pp->macros[slot].expanding = MU_TRUE;
+		pp->expanding_len += 1;
+		if (*result == MU_SUCCESS) {
+			muVGC_expand_tokens(result, pp, &reader, &pp->cache);
+		}
+		pp->macros[slot].expanding = MU_FALSE;
+		pp->expanding_len -= 1;
+
+		muVGC_free_token_reader(pp, &reader);
+		muVGC_token_list_free(&replacement);
+
+		muVGCMacro* macro = &pp->macros[slot];
+		macro->cache_generation = pp->generation;
+		macro->first_cached = first;
+		macro->cached_len = pp->cache.len - first;
+
+		// (It can't be cached if what comes after it could change it, which
+		// is the case if it ends with the name of a function-like macro)
+		size_m last = (macro->cached_len == 0) ? 0 : muVGC_find_macro(pp, pp->cache.tokens[pp->cache.len-1]);
+		macro->cacheable = (*result == MU_SUCCESS && pp->used_dynamic == MU_FALSE && (last == 0 || pp->macros[last-1].is_function == MU_FALSE)) ? MU_TRUE : MU_FALSE;
+		if (macro->cacheable == MU_FALSE) {
+			pp->cache.len = first;
+		}
+	}
+
+	// Expands the macro that a token (just read from the reader) names, onto
+	// the reader (or straight onto 'out' when it's known in full)
+	void muVGC_expand_macro(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader, size_m slot, muVGCToken name, muVGCTokenList* out) {
+		muVGCMacro* macro = &pp->macros[slot];
+
+		if (macro->dynamic != MUVGC_MACRO_STATIC) {
+			pp->used_dynamic = MU_TRUE;
+			uint32_m value = pp->source;
+			if (macro->dynamic == MUVGC_MACRO_LINE) {
+				value = (uint32_m)((int64_m)muVGC_get_preprocessor_line(pp, pp->last_index) + pp->line_offset);
+			}
+			muVGC_token_list_add(out, muVGC_make_integer_token(pp, value));
+			return;
+		}
+
+		muVGCTokenList replacement = { 0 };
+
+		if (macro->is_function == MU_FALSE) {
+			if (pp->expanding_len == 0) {
+				if (macro->cache_generation != pp->generation) {
+					muVGC_cache_macro(result, pp, slot);
+					if (*result != MU_SUCCESS) {
+						return;
+					}
+					macro = &pp->macros[slot];
+				}
+				if (macro->cacheable == MU_TRUE) {
+					muVGC_token_list_add_tokens(out, &pp->cache.tokens[macro->first_cached], macro->cached_len);
+					return;
+				}
+			}
+
+			if (macro->pastes == MU_FALSE) {
+				muVGC_push_macro_context(pp, reader, slot, &pp->macro_tokens.tokens[macro->first_token], macro->replacement_len);
+				return;
+			}
+			muVGC_substitute_macro(result, pp, macro, MU_NULL_PTR, &replacement);
+		} else {
+			// (A function-like macro's name without '(' after it is just a
+			// name)
+			if (muVGC_peek_token(pp, reader).type != MUVGC_TOKEN_OPEN_PARENTHESIS) {
+				muVGC_token_list_add(out, name);
+				return;
+			}
+			muVGC_read_token(result, pp, reader);
+
+			muVGCMacroArguments args;
+			args.raw = (muVGCTokenList){ 0 };
+			args.expanded = (muVGCTokenList){ 0 };
+			muVGC_read_macro_arguments(result, pp, reader, macro, name, &args);
+			if (*result == MU_SUCCESS) {
+				muVGC_substitute_macro(result, pp, &pp->macros[slot], &args, &replacement);
+			}
+			muVGC_token_list_free(&args.raw);
+			muVGC_token_list_free(&args.expanded);
+		}
+
+		if (*result == MU_SUCCESS) {
+			muVGC_push_macro_context(pp, reader, slot, replacement.tokens, replacement.len);
+		}
+		muVGC_token_list_free(&replacement);
+	}
+
+	// Reads every token left in the reader onto the end of 'out', expanding
+	// macros
+	void muVGC_expand_tokens(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader, muVGCTokenList* out) {
+		while (MU_TRUE) {
+			muVGCToken token = muVGC_read_token(result, pp, reader);
+			if (*result != MU_SUCCESS || token.type == MUVGC_TOKEN_END_OF_FILE) {
+				return;
+			}
+
+			size_m macro = muVGC_find_macro(pp, token);
+			if (macro != 0 && pp->macros[macro-1].expanding == MU_FALSE) {
+				muVGC_expand_macro(result, pp, reader, macro-1, token, out);
+				if (*result != MU_SUCCESS) {
+					return;
+				}
+				continue;
+			}
+
+			muVGC_token_list_add(out, token);
+		}
+	}
+
+	// Expressions
+
+	// Evaluated as glslang does: the right side of && when the left is
+	// false and of || when the left is true isn't evaluated, so undefined
+	// macros & division by zero within it aren't errors (as in
+	// #if defined(A) && A >= 2)
+
+	enum muVGCExpressionOperator {
+		MUVGC_EXPRESSION_NONE=0,
+		MUVGC_EXPRESSION_LOGICAL_OR,
+		MUVGC_EXPRESSION_LOGICAL_AND,
+		MUVGC_EXPRESSION_BITWISE_OR,
+		MUVGC_EXPRESSION_BITWISE_XOR,
+		MUVGC_EXPRESSION_BITWISE_AND,
+		MUVGC_EXPRESSION_EQUAL,
+		MUVGC_EXPRESSION_NOT_EQUAL,
+		MUVGC_EXPRESSION_LESS,
+		MUVGC_EXPRESSION_GREATER,
+		MUVGC_EXPRESSION_LESS_EQUAL,
+		MUVGC_EXPRESSION_GREATER_EQUAL,
+		MUVGC_EXPRESSION_SHIFT_LEFT,
+		MUVGC_EXPRESSION_SHIFT_RIGHT,
+		MUVGC_EXPRESSION_ADD,
+		MUVGC_EXPRESSION_SUBTRACT,
+		MUVGC_EXPRESSION_MULTIPLY,
+		MUVGC_EXPRESSION_DIVIDE,
+		MUVGC_EXPRESSION_MODULO
+	};
+	typedef enum muVGCExpressionOperator muVGCExpressionOperator;
+
+	// How tightly each operator binds (1 being the loosest)
+	static const uint32_m muVGC_expression_precedence[] = {
+		0, 1, 2, 3, 4, 5, 6, 6, 7, 7, 7, 7, 8, 8, 9, 9, 10, 10, 10
+	};
+
+	// Returns the binary operator at tokens[i], setting how many tokens it
+	// is made of (two-character operators being two tokens right next to
+	// each other)
+	muVGCExpressionOperator muVGC_get_expression_operator(const muVGCToken* tokens, size_m len, size_m i, size_m* op_len) {
+		if (i >= len) {
+			return MUVGC_EXPRESSION_NONE;
+		}
+		muVGCTokenType type = tokens[i].type;
+		muVGCTokenType next = MUVGC_TOKEN_UNKNOWN;
+		if (i+1 < len && tokens[i+1].index == tokens[i].index+1) {
+			next = tokens[i+1].type;
+		}
+		*op_len = 2;
+
+		switch (type) {
+			default: return MUVGC_EXPRESSION_NONE;
+			case MUVGC_TOKEN_VERTICAL_BAR: {
+				if (next == MUVGC_TOKEN_VERTICAL_BAR) return MUVGC_EXPRESSION_LOGICAL_OR;
+				*op_len = 1; return MUVGC_EXPRESSION_BITWISE_OR;
+			}
+			case MUVGC_TOKEN_AMPERSAND: {
+				if (next == MUVGC_TOKEN_AMPERSAND) return MUVGC_EXPRESSION_LOGICAL_AND;
+				*op_len = 1; return MUVGC_EXPRESSION_BITWISE_AND;
+			}
+			case MUVGC_TOKEN_CARET: {
+				*op_len = 1; return MUVGC_EXPRESSION_BITWISE_XOR;
+			}
+			case MUVGC_TOKEN_EQUALS: {
+				if (next == MUVGC_TOKEN_EQUALS) return MUVGC_EXPRESSION_EQUAL;
+				return MUVGC_EXPRESSION_NONE;
+			}
+			case MUVGC_TOKEN_EXCLAMATION_POINT: {
+				if (next == MUVGC_TOKEN_EQUALS) return MUVGC_EXPRESSION_NOT_EQUAL;
+				return MUVGC_EXPRESSION_NONE;
+			}
+			case MUVGC_TOKEN_LESS_THAN_ANGLED_BRACKET: {
+				if (next == MUVGC_TOKEN_EQUALS) return MUVGC_EXPRESSION_LESS_EQUAL;
+				if (next == MUVGC_TOKEN_LESS_THAN_ANGLED_BRACKET) return MUVGC_EXPRESSION_SHIFT_LEFT;
+				*op_len = 1; return MUVGC_EXPRESSION_LESS;
+			}
+			case MUVGC_TOKEN_GREATER_THAN_ANGLED_BRACKET: {
+				if (next == MUVGC_TOKEN_EQUALS) return MUVGC_EXPRESSION_GREATER_EQUAL;
+				if (next == MUVGC_TOKEN_GREATER_THAN_ANGLED_BRACKET) return MUVGC_EXPRESSION_SHIFT_RIGHT;
+				*op_len = 1; return MUVGC_EXPRESSION_GREATER;
+			}
+			case MUVGC_TOKEN_PLUS: { *op_len = 1; return MUVGC_EXPRESSION_ADD; }
+			case MUVGC_TOKEN_DASH: { *op_len = 1; return MUVGC_EXPRESSION_SUBTRACT; }
+			case MUVGC_TOKEN_ASTERIK: { *op_len = 1; return MUVGC_EXPRESSION_MULTIPLY; }
+			case MUVGC_TOKEN_SLASH: { *op_len = 1; return MUVGC_EXPRESSION_DIVIDE; }
+			case MUVGC_TOKEN_PERCENT: { *op_len = 1; return MUVGC_EXPRESSION_MODULO; }
+		}
+	}
+
+	int64_m muVGC_evaluate_expression(
+		muResult* result, muVGCPreprocessor* pp, const muVGCToken* tokens, size_m len, size_m* i, uint32_m min_precedence, muBool evaluated);
+
+	// ('evaluated' is MU_FALSE within an operand that short-circuiting
+	// skips)
+	int64_m muVGC_evaluate_unary_expression(muResult* result, muVGCPreprocessor* pp, const muVGCToken* tokens, size_m len, size_m* i, muBool evaluated) {
+		if (*i >= len) {
+			muVGC_print_preprocessor_error(pp, (len == 0) ? pp->last_index : tokens[len-1].index);
+			mu_print("expected a value at the end of the expression\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+
+		muVGCToken token = tokens[*i];
+		*i += 1;
+		switch (token.type) {
+			default: break;
+			case MUVGC_TOKEN_INTEGER_CONSTANT: return (int64_m)muVGC_get_integer_token_value(pp->code->s, token);
+			case MUVGC_TOKEN_PLUS: return muVGC_evaluate_unary_expression(result, pp, tokens, len, i, evaluated);
+			case MUVGC_TOKEN_DASH: return (int64_m)(0 - (uint64_m)muVGC_evaluate_unary_expression(result, pp, tokens, len, i, evaluated));
+			case MUVGC_TOKEN_TILDE: return ~muVGC_evaluate_unary_expression(result, pp, tokens, len, i, evaluated);
+			case MUVGC_TOKEN_EXCLAMATION_POINT: return (muVGC_evaluate_unary_expression(result, pp, tokens, len, i, evaluated) == 0) ? 1 : 0;
+			case MUVGC_TOKEN_OPEN_PARENTHESIS: {
+				int64_m value = muVGC_evaluate_expression(result, pp, tokens, len, i, 1, evaluated);
+				if (*result != MU_SUCCESS) {
+					return 0;
+				}
+				if (*i >= len || tokens[*i].type != MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+					muVGC_print_preprocessor_error(pp, token.index);
+					mu_print("expected ')' to close '('\n");
+					*result = MU_FAILURE;
+					return 0;
+				}
+				*i += 1;
+				return value;
+			}
+			case MUVGC_TOKEN_IDENTIFIER: case MUVGC_TOKEN_KEYWORD: case MUVGC_TOKEN_RESERVED_KEYWORD: {
+				if (evaluated == MU_FALSE) {
+					return 0;
+				}
+				muVGC_print_preprocessor_error(pp, token.index);
+				mu_print("undefined macro used in preprocessor expression\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+		}
+
+		muVGC_print_preprocessor_error(pp, token.index);
+		mu_print("expected an integer value in preprocessor expression\n");
+		*result = MU_FAILURE;
+		return 0;
+	}
+
+	// Evaluates operators binding at least as tightly as 'min_precedence'
+	int64_m muVGC_evaluate_expression(
+		muResult* result, muVGCPreprocessor* pp, const muVGCToken* tokens, size_m len, size_m* i, uint32_m min_precedence, muBool evaluated) {
+
+		int64_m left = muVGC_evaluate_unary_expression(result, pp, tokens, len, i, evaluated);
+
+		while (*result == MU_SUCCESS) {
+			size_m op_len = 0;
+			muVGCExpressionOperator op = muVGC_get_expression_operator(tokens, len, *i, &op_len);
+			if (op == MUVGC_EXPRESSION_NONE || muVGC_expression_precedence[op] < min_precedence) {
+				break;
+			}
+			size_m op_index = tokens[*i].index;
+			*i += op_len;
+
+			// (The left side deciding && or || skips the right side)
+			muBool right_evaluated = evaluated;
+			if ((op == MUVGC_EXPRESSION_LOGICAL_AND && left == 0) || (op == MUVGC_EXPRESSION_LOGICAL_OR && left != 0)) {
+				right_evaluated = MU_FALSE;
+			}
+			int64_m right = muVGC_evaluate_expression(result, pp, tokens, len, i, muVGC_expression_precedence[op]+1, right_evaluated);
+			if (*result != MU_SUCCESS) {
+				return 0;
+			}
+
+			// (Wrapping around rather than overflowing)
+			uint64_m l = (uint64_m)left, r = (uint64_m)right;
+			switch (op) {
+				default: break;
+				case MUVGC_EXPRESSION_LOGICAL_OR: left = (left != 0 || right != 0) ? 1 : 0; break;
+				case MUVGC_EXPRESSION_LOGICAL_AND: left = (left != 0 && right != 0) ? 1 : 0; break;
+				case MUVGC_EXPRESSION_BITWISE_OR: left = (int64_m)(l | r); break;
+				case MUVGC_EXPRESSION_BITWISE_XOR: left = (int64_m)(l ^ r); break;
+				case MUVGC_EXPRESSION_BITWISE_AND: left = (int64_m)(l & r); break;
+				case MUVGC_EXPRESSION_EQUAL: left = (left == right) ? 1 : 0; break;
+				case MUVGC_EXPRESSION_NOT_EQUAL: left = (left != right) ? 1 : 0; break;
+				case MUVGC_EXPRESSION_LESS: left = (left < right) ? 1 : 0; break;
+				case MUVGC_EXPRESSION_GREATER: left = (left > right) ? 1 : 0; break;
+				case MUVGC_EXPRESSION_LESS_EQUAL: left = (left <= right) ? 1 : 0; break;
+				case MUVGC_EXPRESSION_GREATER_EQUAL: left = (left >= right) ? 1 : 0; break;
+				case MUVGC_EXPRESSION_SHIFT_LEFT: left = (right < 0 || right > 63) ? 0 : (int64_m)(l << r); break;
+				case MUVGC_EXPRESSION_SHIFT_RIGHT: left = (right < 0 || right > 63) ? 0 : (left >> right); break;
+				case MUVGC_EXPRESSION_ADD: left = (int64_m)(l + r); break;
+				case MUVGC_EXPRESSION_SUBTRACT: left = (int64_m)(l - r); break;
+				case MUVGC_EXPRESSION_MULTIPLY: left = (int64_m)(l * r); break;
+				case MUVGC_EXPRESSION_DIVIDE: case MUVGC_EXPRESSION_MODULO: {
+					if (right == 0 && evaluated == MU_FALSE) {
+						left = 0;
+						break;
+					}
+					if (right == 0) {
+						muVGC_print_preprocessor_error(pp, op_index);
+						mu_print("division by zero in preprocessor expression\n");
+						*result = MU_FAILURE;
+						return 0;
+					}
+					// (-1 is handled apart since the minimum value divided by
+					// it overflows)
+					if (right == -1) {
+						left = (op == MUVGC_EXPRESSION_DIVIDE) ? (int64_m)(0 - l) : 0;
+					} else {
+						left = (op == MUVGC_EXPRESSION_DIVIDE) ? (left / right) : (left % right);
+					}
+				} break;
+			}
+		}
+
+		return left;
+	}
+
+	// Directives
+
+	enum muVGCDirective {
+		MUVGC_DIRECTIVE_UNKNOWN=0,
+		MUVGC_DIRECTIVE_DEFINE,
+		MUVGC_DIRECTIVE_UNDEF,
+		MUVGC_DIRECTIVE_IF,
+		MUVGC_DIRECTIVE_IFDEF,
+		MUVGC_DIRECTIVE_IFNDEF,
+		MUVGC_DIRECTIVE_ELIF,
+		MUVGC_DIRECTIVE_ELSE,
+		MUVGC_DIRECTIVE_ENDIF,
+		MUVGC_DIRECTIVE_ERROR,
+		MUVGC_DIRECTIVE_PRAGMA,
+		MUVGC_DIRECTIVE_EXTENSION,
+		MUVGC_DIRECTIVE_LINE,
+		MUVGC_DIRECTIVE_VERSION,
+		MUVGC_DIRECTIVE_INCLUDE
+	};
+	typedef enum muVGCDirective muVGCDirective;
+
+	struct muVGCDirectiveName {
+		const char* name;
+		size_m namelen;
+		muVGCDirective directive;
+	};
+	typedef struct muVGCDirectiveName muVGCDirectiveName;
+
+	muVGCDirective muVGC_get_directive(const char* code, muVGCToken name) {
+		static const muVGCDirectiveName directives[] = {
+			{ "define", 6, MUVGC_DIRECTIVE_DEFINE },
+			{ "undef", 5, MUVGC_DIRECTIVE_UNDEF },
+			{ "if", 2, MUVGC_DIRECTIVE_IF },
+			{ "ifdef", 5, MUVGC_DIRECTIVE_IFDEF },
+			{ "ifndef", 6, MUVGC_DIRECTIVE_IFNDEF },
+			{ "elif", 4, MUVGC_DIRECTIVE_ELIF },
+			{ "else", 4, MUVGC_DIRECTIVE_ELSE },
+			{ "endif", 5, MUVGC_DIRECTIVE_ENDIF },
+			{ "error", 5, MUVGC_DIRECTIVE_ERROR },
+			{ "pragma", 6, MUVGC_DIRECTIVE_PRAGMA },
+			{ "extension", 9, MUVGC_DIRECTIVE_EXTENSION },
+			{ "line", 4, MUVGC_DIRECTIVE_LINE },
+			{ "version", 7, MUVGC_DIRECTIVE_VERSION },
+			{ "include", 7, MUVGC_DIRECTIVE_INCLUDE }
+		};
+		if (name.type != MUVGC_TOKEN_IDENTIFIER && name.type != MUVGC_TOKEN_KEYWORD) {
+			return MUVGC_DIRECTIVE_UNKNOWN;
+		}
+		for (size_m i = 0; i < sizeof(directives)/sizeof(directives[0]); i++) {
+			if (muVGC_token_text_equals(code, name, directives[i].name, directives[i].namelen) == MU_TRUE) {
+				return directives[i].directive;
+			}
+		}
+		return MUVGC_DIRECTIVE_UNKNOWN;
+	}
+
+	// Reads the tokens of the rest of a directive's line onto the
+	// preprocessor's line, returning where the line ends
+	size_m muVGC_read_directive_line(muResult* result, muVGCPreprocessor* pp, size_m i) {
+		const char* code = pp->code->s;
+		pp->line.len = 0;
+		while (MU_TRUE) {
+			i = muVGC_skip_spaces(code, pp->code_len, i, MU_FALSE, MU_NULL_PTR);
+			muVGCToken token = muVGC_get_token(code, pp->code_len, i);
+			if (token.type == MUVGC_TOKEN_END_OF_FILE || code[i] == '\n') {
+				return i;
+			}
+			if (token.type == MUVGC_TOKEN_UNKNOWN) {
+				muVGC_print_preprocessor_error(pp, i);
+				mu_print("unrecognized symbol\n");
+				*result = MU_FAILURE;
+				return i;
+			}
+			muVGC_token_list_add(&pp->line, token);
+			i = token.index + token.length;
+		}
+	}
+
+	// Checks that a directive's line is a single macro name, returning it
+	muVGCToken muVGC_get_directive_macro_name(muResult* result, muVGCPreprocessor* pp, size_m hash) {
+		if (pp->line.len == 0 || muVGC_is_macro_name_token(pp->line.tokens[0]) == MU_FALSE) {
+			muVGC_print_preprocessor_error(pp, (pp->line.len == 0) ? hash : pp->line.tokens[0].index);
+			mu_print("expected a macro name\n");
+			*result = MU_FAILURE;
+			return (muVGCToken){ 0 };
+		}
+		if (pp->line.len > 1) {
+			muVGC_print_preprocessor_error(pp, pp->line.tokens[1].index);
+			mu_print("expected a newline after the macro name\n");
+			*result = MU_FAILURE;
+		}
+		return pp->line.tokens[0];
+	}
+
+	// Checks that nothing follows a directive that takes nothing
+	void muVGC_check_empty_directive(muResult* result, muVGCPreprocessor* pp) {
+		if (pp->line.len != 0) {
+			muVGC_print_preprocessor_error(pp, pp->line.tokens[0].index);
+			mu_print("expected a newline after the directive\n");
+			*result = MU_FAILURE;
+		}
+	}
+
+	void muVGC_directive_define(muResult* result, muVGCPreprocessor* pp, size_m hash) {
+		const char* code = pp->code->s;
+		muVGCToken* line = pp->line.tokens;
+		size_m len = pp->line.len;
+
+		if (len == 0 || muVGC_is_macro_name_token(line[0]) == MU_FALSE) {
+			muVGC_print_preprocessor_error(pp, (len == 0) ? hash : line[0].index);
+			mu_print("expected a macro name\n");
+			*result = MU_FAILURE;
+			return;
+		}
+		muVGCToken name = line[0];
+		if (muVGC_token_text_equals(code, name, "defined", 7) == MU_TRUE) {
+			muVGC_print_preprocessor_error(pp, name.index);
+			mu_print("'defined' can't be a macro name\n");
+			*result = MU_FAILURE;
+			return;
+		}
+		if (name.length >= 3 && mu_strncmp(&code[name.index], "GL_", 3) == 0) {
+			muVGC_print_preprocessor_error(pp, name.index);
+			mu_print("macro names starting with 'GL_' are reserved\n");
+			*result = MU_FAILURE;
+			return;
+		}
+
+		// It's function-like if '(' comes right after its name
+		muBool is_function = (len > 1 && line[1].type == MUVGC_TOKEN_OPEN_PARENTHESIS && line[1].index == name.index+name.length) ? MU_TRUE : MU_FALSE;
+		size_m i = 1;
+		size_m parameter_len = 0;
+		if (is_function == MU_TRUE) {
+			i = 2;
+			if (i < len && line[i].type == MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+				i++;
+			} else while (MU_TRUE) {
+				if (i >= len || muVGC_is_macro_name_token(line[i]) == MU_FALSE) {
+					muVGC_print_preprocessor_error(pp, (i >= len) ? line[i-1].index : line[i].index);
+					mu_print("expected a macro parameter name\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				for (size_m p = 0; p < parameter_len; p++) {
+					if (muVGC_token_text_equals(code, line[2+p*2], &code[line[i].index], line[i].length) == MU_TRUE) {
+						muVGC_print_preprocessor_error(pp, line[i].index);
+						mu_print("macro parameter name used twice\n");
+						*result = MU_FAILURE;
+						return;
+					}
+				}
+				if (parameter_len == MUVGC_MAX_MACRO_PARAMETERS) {
+					muVGC_print_preprocessor_error(pp, line[i].index);
+					mu_print("too many macro parameters (the max is %i)\n", MUVGC_MAX_MACRO_PARAMETERS);
+					*result = MU_FAILURE;
+					return;
+				}
+				parameter_len++;
+				i++;
+
+				if (i < len && line[i].type == MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+					i++;
+					break;
+				}
+				if (i >= len || line[i].type != MUVGC_TOKEN_COMMA) {
+					muVGC_print_preprocessor_error(pp, (i >= len) ? line[i-1].index : line[i].index);
+					mu_print("expected ',' or ')' after macro parameter name\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				i++;
+			}
+		}
+		size_m first_replacement = i;
+		size_m replacement_len = len - i;
+
+		muBool pastes = MU_FALSE;
+		for (size_m r = first_replacement; r < len; r++) {
+			if (line[r].type == MUVGC_TOKEN_HASH) {
+				muVGC_print_preprocessor_error(pp, line[r].index);
+				mu_print("'#' can't be used in a macro's replacement list\n");
+				*result = MU_FAILURE;
+				return;
+			}
+			if (line[r].type == MUVGC_TOKEN_DOUBLE_HASH) {
+				if (r == first_replacement || r == len-1) {
+					muVGC_print_preprocessor_error(pp, line[r].index);
+					mu_print("'##' can't start or end a macro's replacement list\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				pastes = MU_TRUE;
+			}
+		}
+
+		size_m slot = muVGC_get_macro_slot(pp, name);
+		muVGCMacro* macro = &pp->macros[slot];
+
+		// Redefining a macro is only allowed if nothing changes
+		if (macro->defined == MU_TRUE) {
+			if (macro->predefined == MU_TRUE) {
+				muVGC_print_preprocessor_error(pp, name.index);
+				mu_print("predefined macros can't be redefined\n");
+				*result = MU_FAILURE;
+				return;
+			}
+			muBool same = (macro->is_function == is_function && macro->parameter_len == parameter_len && macro->replacement_len == replacement_len) ? MU_TRUE : MU_FALSE;
+			for (size_m p = 0; same == MU_TRUE && p < parameter_len; p++) {
+				muVGCToken old = pp->macro_tokens.tokens[macro->first_token+p];
+				same = muVGC_token_text_equals(code, old, &code[line[2+p*2].index], line[2+p*2].length);
+			}
+			for (size_m r = 0; same == MU_TRUE && r < replacement_len; r++) {
+				muVGCToken old = pp->macro_tokens.tokens[macro->first_token+parameter_len+r];
+				same = muVGC_token_text_equals(code, old, &code[line[first_replacement+r].index], line[first_replacement+r].length);
+			}
+			if (same == MU_FALSE) {
+				muVGC_print_preprocessor_error(pp, name.index);
+				mu_print("macro redefined differently\n");
+				*result = MU_FAILURE;
+			}
+			return;
+		}
+
+		macro->defined = MU_TRUE;
+		macro->is_function = is_function;
+		macro->pastes = pastes;
+		macro->first_token = pp->macro_tokens.len;
+		macro->parameter_len = parameter_len;
+		macro->replacement_len = replacement_len;
+		macro->cache_generation = 0;
+
+		for (size_m p = 0; p < parameter_len; p++) {
+			muVGC_add_macro_token(pp, line[2+p*2], 0);
+		}
+		for (size_m r = first_replacement; r < len; r++) {
+			uint32_m parameter = 0;
+			if (line[r].type == MUVGC_TOKEN_IDENTIFIER || line[r].type == MUVGC_TOKEN_KEYWORD || line[r].type == MUVGC_TOKEN_RESERVED_KEYWORD) {
+				for (size_m p = 0; p < parameter_len; p++) {
+					if (muVGC_token_text_equals(code, line[2+p*2], &code[line[r].index], line[r].length) == MU_TRUE) {
+						parameter = (uint32_m)p+1;
+						break;
+					}
+				}
+			}
+			muVGC_add_macro_token(pp, line[r], parameter);
+		}
+
+		pp->generation += 1;
+	}
+
+	void muVGC_directive_undef(muResult* result, muVGCPreprocessor* pp, size_m hash) {
+		muVGCToken name = muVGC_get_directive_macro_name(result, pp, hash);
+		if (*result != MU_SUCCESS) {
+			return;
+		}
+		size_m macro = muVGC_find_macro(pp, name);
+		if (macro == 0) {
+			return;
+		}
+		if (pp->macros[macro-1].predefined == MU_TRUE) {
+			muVGC_print_preprocessor_error(pp, name.index);
+			mu_print("predefined macros can't be undefined\n");
+			*result = MU_FAILURE;
+			return;
+		}
+		pp->macros[macro-1].defined = MU_FALSE;
+		pp->generation += 1;
+	}
+
+	// Evaluates the expression of an #if or #elif
+	muBool muVGC_evaluate_condition(muResult* result, muVGCPreprocessor* pp, size_m hash) {
+		const char* code = pp->code->s;
+		muVGCToken* line = pp->line.tokens;
+		size_m len = pp->line.len;
+		if (len == 0) {
+			muVGC_print_preprocessor_error(pp, hash);
+			mu_print("expected an expression\n");
+			*result = MU_FAILURE;
+			return MU_FALSE;
+		}
+
+		// 'defined' is handled first, since the names it takes aren't
+		// expanded
+		muVGCTokenList replaced = { 0 };
+		for (size_m i = 0; i < len; i++) {
+			if (line[i].type != MUVGC_TOKEN_IDENTIFIER || muVGC_token_text_equals(code, line[i], "defined", 7) == MU_FALSE) {
+				muVGC_token_list_add(&replaced, line[i]);
+				continue;
+			}
+
+			muBool parenthesis = (i+1 < len && line[i+1].type == MUVGC_TOKEN_OPEN_PARENTHESIS) ? MU_TRUE : MU_FALSE;
+			size_m n = i + 1 + (parenthesis == MU_TRUE ? 1 : 0);
+			if (n >= len || muVGC_is_macro_name_token(line[n]) == MU_FALSE) {
+				muVGC_print_preprocessor_error(pp, line[i].index);
+				mu_print("expected a macro name after 'defined'\n");
+				*result = MU_FAILURE;
+				break;
+			}
+			if (parenthesis == MU_TRUE && (n+1 >= len || line[n+1].type != MUVGC_TOKEN_CLOSE_PARENTHESIS)) {
+				muVGC_print_preprocessor_error(pp, line[n].index);
+				mu_print("expected ')' after the macro name\n");
+				*result = MU_FAILURE;
+				break;
+			}
+			muVGC_token_list_add(&replaced, (muVGC_find_macro(pp, line[n]) != 0) ? pp->one : pp->zero);
+			i = n + (parenthesis == MU_TRUE ? 1 : 0);
+		}
+
+		// Then macros are expanded
+		muVGCTokenList expanded = { 0 };
+		if (*result == MU_SUCCESS) {
+			muVGCTokenReader reader = { 0 };
+			reader.tokens = replaced.tokens;
+			reader.token_len = replaced.len;
+			muVGC_expand_tokens(result, pp, &reader, &expanded);
+			muVGC_free_token_reader(pp, &reader);
+		}
+
+		int64_m value = 0;
+		if (*result == MU_SUCCESS) {
+			size_m i = 0;
+			value = muVGC_evaluate_expression(result, pp, expanded.tokens, expanded.len, &i, 1, MU_TRUE);
+			if (*result == MU_SUCCESS && i != expanded.len) {
+				muVGC_print_preprocessor_error(pp, expanded.tokens[i].index);
+				mu_print("unexpected token in preprocessor expression\n");
+				*result = MU_FAILURE;
+			}
+		}
+
+		muVGC_token_list_free(&replaced);
+		muVGC_token_list_free(&expanded);
+		return (value != 0) ? MU_TRUE : MU_FALSE;
+	}
+
+	void muVGC_push_conditional(muVGCPreprocessor* pp, size_m hash, muBool taken) {
+		if (pp->conditional_len == pp->allocated_conditional_len) {
+			pp->allocated_conditional_len = (pp->allocated_conditional_len == 0) ? 8 : pp->allocated_conditional_len*2;
+			pp->conditionals = (muVGCConditional*)mu_realloc(pp->conditionals, sizeof(muVGCConditional) * pp->allocated_conditional_len);
+		}
+		pp->conditionals[pp->conditional_len] = (muVGCConditional){ hash, taken, MU_FALSE };
+		pp->conditional_len += 1;
+	}
+
+	// Returns the directive that an index into the code is a depth change
+	// for while skipping groups: 1 for what opens a conditional, 2 for what
+	// ends a group (#elif & #else), 3 for #endif, and 0 for anything else
+	uint32_m muVGC_get_skipped_directive(const char* code, muVGCToken name) {
+		switch (muVGC_get_directive(code, name)) {
+			default: return 0;
+			case MUVGC_DIRECTIVE_IF: case MUVGC_DIRECTIVE_IFDEF: case MUVGC_DIRECTIVE_IFNDEF: return 1;
+			case MUVGC_DIRECTIVE_ELIF: case MUVGC_DIRECTIVE_ELSE: return 2;
+			case MUVGC_DIRECTIVE_ENDIF: return 3;
+		}
+	}
+
+	// Skips the lines of a group that a conditional leaves out (starting at
+	// the end of the directive's line) up to the #elif, #else or #endif
+	// ending it, returning where that directive's '#' is
+	size_m muVGC_skip_group(muVGCPreprocessor* pp, size_m i) {
+		const char* code = pp->code->s;
+		size_m depth = 0;
+		while (MU_TRUE) {
+			i = muVGC_get_next_new_line(code, pp->code_len, i);
+			if (i >= pp->code_len) {
+				return pp->code_len;
+			}
+			i = muVGC_skip_spaces(code, pp->code_len, i+1, MU_FALSE, MU_NULL_PTR);
+			if (code[i] != '#') {
+				continue;
+			}
+
+			size_m hash = i;
+			i = muVGC_skip_spaces(code, pp->code_len, i+1, MU_FALSE, MU_NULL_PTR);
+			uint32_m skipped = muVGC_get_skipped_directive(code, muVGC_get_token(code, pp->code_len, i));
+			if (skipped == 1) {
+				depth++;
+			} else if (skipped != 0 && depth == 0) {
+				return hash;
+			} else if (skipped == 3) {
+				depth--;
+			}
+		}
+	}
+
+	// The same for the tokens of an included file, starting at 'position'
+	size_m muVGC_skip_file_group(muVGCCachedFile* file, size_m position) {
+		size_m depth = 0;
+		for (size_m i = position; i < file->token_len; i++) {
+			if (file->line_starts[i] == MU_FALSE || file->tokens[i].type != MUVGC_TOKEN_HASH) {
+				continue;
+			}
+			if (i+1 >= file->token_len || file->line_starts[i+1] == MU_TRUE) {
+				continue;
+			}
+
+			uint32_m skipped = muVGC_get_skipped_directive(file->code.s, file->tokens[i+1]);
+			if (skipped == 1) {
+				depth++;
+			} else if (skipped != 0 && depth == 0) {
+				return i;
+			} else if (skipped == 3) {
+				depth--;
+			}
+		}
+		return file->token_len;
+	}
+
+	// Returns where the line that 'i' is in ends
+	size_m muVGC_get_line_end(muVGCPreprocessor* pp, size_m i) {
+		const char* code = pp->code->s;
+		while (code[i] != '\n' && code[i] != '\0') {
+			i++;
+		}
+		return i;
+	}
+
+	// Lexes all of a file's code
+	void muVGC_lex_cached_file(muVGCCachedFile* file) {
+		muVGCTokenList tokens = { 0 };
+		size_m allocated_line_start_len = 0;
+		muBool line_start = MU_TRUE;
+		size_m codelen = mu_string_strlen(file->code);
+		size_m i = 0;
+		while (MU_TRUE) {
+			i = muVGC_skip_spaces(file->code.s, codelen, i, MU_TRUE, &line_start);
+			muVGCToken token = muVGC_get_token(file->code.s, codelen, i);
+			if (token.type == MUVGC_TOKEN_END_OF_FILE) {
+				break;
+			}
+			muVGC_token_list_add(&tokens, token);
+			if (tokens.allocated_len > allocated_line_start_len) {
+				allocated_line_start_len = tokens.allocated_len;
+				file->line_starts = (muBool*)mu_realloc(file->line_starts, sizeof(muBool) * allocated_line_start_len);
+			}
+			file->line_starts[tokens.len-1] = line_start;
+			line_start = MU_FALSE;
+			i = token.index + token.length;
+		}
+		file->tokens = tokens.tokens;
+		file->token_len = tokens.len;
+	}
+
+	// Returns the cached file (+1) with the given name, reading it in if it
+	// isn't cached yet, or 0 if there's no such file
+	size_m muVGC_get_included_file(muResult* result, muVGCPreprocessor* pp, const char* name, size_m namelen) {
+		muVGCIncludeCache* cache = pp->include_cache;
+		uint32_m hash = muVGC_hash_name(name, namelen);
+		for (size_m i = 0; i < cache->file_len; i++) {
+			if (cache->files[i].hash == hash && cache->files[i].namelen == namelen && mu_strncmp(cache->files[i].name, name, namelen) == 0) {
+				return i+1;
+			}
+		}
+
+		muVGCCachedFile file = { 0 };
+		file.name = (char*)mu_malloc(namelen+1);
+		for (size_m i = 0; i < namelen; i++) {
+			file.name[i] = name[i];
+		}
+		file.name[namelen] = '\0';
+		file.namelen = namelen;
+		file.hash = hash;
+
+		const char* code = MU_NULL_PTR;
+		const muVGCOptions* options = pp->options;
+		for (size_m i = 0; i < options->include_file_len && code == MU_NULL_PTR; i++) {
+			if (mu_strlen(options->include_files[i].name) == namelen && mu_strncmp(options->include_files[i].name, name, namelen) == 0) {
+				code = options->include_files[i].code;
+			}
+		}
+		if (code == MU_NULL_PTR && options->include_callback != MU_NULL_PTR) {
+			code = options->include_callback(options->include_user_data, file.name);
+		}
+		if (code == MU_NULL_PTR) {
+			mu_free(file.name);
+			return 0;
+		}
+
+		muResult res = MU_SUCCESS;
+		file.code = muVGC_handle_comments(&res, mu_string_create((char*)code));
+		if (res != MU_SUCCESS) {
+			mu_print("[muVGC] Error in included file '%s'\n", file.name);
+			mu_free(file.name);
+			file.code = mu_string_destroy(file.code);
+			*result = MU_FAILURE;
+			return 0;
+		}
+
+		// (All of it is lexed, since which groups are left out changes with
+		// where it's included)
+		muVGC_lex_cached_file(&file);
+
+		if (cache->file_len == cache->allocated_file_len) {
+			cache->allocated_file_len = (cache->allocated_file_len == 0) ? 8 : cache->allocated_file_len*2;
+			cache->files = (muVGCCachedFile*)mu_realloc(cache->files, sizeof(muVGCCachedFile) * cache->allocated_file_len);
+		}
+		cache->files[cache->file_len] = file;
+		cache->file_len += 1;
+		return cache->file_len;
+	}
+
+	// Starts reading a file's tokens, its code being at 'base' in the code
+	void muVGC_push_include_frame(muVGCPreprocessor* pp, muVGCTokenReader* reader, size_m file, size_m base) {
+		if (reader->file_len == reader->allocated_file_len) {
+			reader->allocated_file_len = (reader->allocated_file_len == 0) ? 8 : reader->allocated_file_len*2;
+			reader->files = (muVGCIncludeFrame*)mu_realloc(reader->files, sizeof(muVGCIncludeFrame) * reader->allocated_file_len);
+		}
+		reader->files[reader->file_len] = (muVGCIncludeFrame){ file, base, 0, pp->conditional_base, pp->line_offset, pp->source };
+		reader->file_len += 1;
+
+		pp->conditional_base = pp->conditional_len;
+		pp->line_offset = 0;
+	}
+
+	// Starts reading the file with the given name (in the code)
+	void muVGC_include_file(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader, size_m name, size_m namelen, size_m hash) {
+		if (reader->file_len == MUVGC_MAX_INCLUDE_DEPTH) {
+			muVGC_print_preprocessor_error(pp, hash);
+			mu_print("#include nested too deeply (the max depth is %i)\n", MUVGC_MAX_INCLUDE_DEPTH);
+			*result = MU_FAILURE;
+			return;
+		}
+
+		size_m file = muVGC_get_included_file(result, pp, &pp->code->s[name], namelen);
+		if (*result != MU_SUCCESS) {
+			return;
+		}
+		if (file == 0) {
+			muVGC_print_preprocessor_error(pp, hash);
+			mu_printf("couldn't find included file '%.*s'\n", (int)namelen, &pp->code->s[name]);
+			*result = MU_FAILURE;
+			return;
+		}
+		file -= 1;
+
+		// Its code is added to the code for its tokens to point at
+		muString* code = &pp->include_cache->files[file].code;
+		size_m base = muVGC_add_code_text(pp, code->s, 0, mu_string_strlen(*code));
+
+		if (pp->included_text_len == pp->allocated_included_text_len) {
+			pp->allocated_included_text_len = (pp->allocated_included_text_len == 0) ? 8 : pp->allocated_included_text_len*2;
+			pp->included_texts = (muVGCIncludedText*)mu_realloc(pp->included_texts, sizeof(muVGCIncludedText) * pp->allocated_included_text_len);
+		}
+		pp->included_texts[pp->included_text_len] = (muVGCIncludedText){ base, mu_string_strlen(*code), file };
+		pp->included_text_len += 1;
+
+		muVGC_push_include_frame(pp, reader, file, base);
+	}
+
+	// Handles a directive, the tokens after its name being the preprocessor's
+	// line (except for #pragma, #error & #include, whose lines are read as
+	// text), returning whether the group after it is to be skipped
+	muBool muVGC_run_directive(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader, size_m hash, muVGCToken name) {
+		const char* code = pp->code->s;
+		muVGCDirective directive = muVGC_get_directive(code, name);
+		muVGCConditional* conditional = (pp->conditional_len == pp->conditional_base) ? MU_NULL_PTR : &pp->conditionals[pp->conditional_len-1];
+
+		switch (directive) {
+			default: {
+				muVGC_print_preprocessor_error(pp, name.index);
+				mu_print("unknown preprocessor directive\n");
+				*result = MU_FAILURE;
+			} break;
+
+			case MUVGC_DIRECTIVE_PRAGMA: break;
+
+			case MUVGC_DIRECTIVE_ERROR: {
+				size_m i = muVGC_skip_spaces(code, pp->text_len, name.index+name.length, MU_FALSE, MU_NULL_PTR);
+				muVGC_print_preprocessor_error(pp, hash);
+				mu_printf("#error %.*s\n", (int)(muVGC_get_line_end(pp, i)-i), &code[i]);
+				*result = MU_FAILURE;
+			} break;
+
+			case MUVGC_DIRECTIVE_VERSION: {
+				muVGC_print_preprocessor_error(pp, hash);
+				mu_print("#version can only come before anything else\n");
+				*result = MU_FAILURE;
+			} break;
+
+			// '#include "name"' or '#include <name>' (both looked up the same
+			// way)
+			case MUVGC_DIRECTIVE_INCLUDE: {
+				size_m i = muVGC_skip_spaces(code, pp->text_len, name.index+name.length, MU_FALSE, MU_NULL_PTR);
+				char close = (code[i] == '"') ? '"' : ((code[i] == '<') ? '>' : '\0');
+				size_m end = i+1;
+				while (close != '\0' && code[end] != close && code[end] != '\n' && code[end] != '\0') {
+					end++;
+				}
+				if (close == '\0' || code[end] != close || end == i+1) {
+					muVGC_print_preprocessor_error(pp, hash);
+					mu_print("expected '#include \"name\"' or '#include <name>'\n");
+					*result = MU_FAILURE;
+					return MU_FALSE;
+				}
+				size_m after = muVGC_skip_spaces(code, pp->text_len, end+1, MU_FALSE, MU_NULL_PTR);
+				if (code[after] != '\n' && code[after] != '\0') {
+					muVGC_print_preprocessor_error(pp, after);
+					mu_print("expected a newline after the included file's name\n");
+					*result = MU_FAILURE;
+					return MU_FALSE;
+				}
+				muVGC_include_file(result, pp, reader, i+1, end-(i+1), hash);
+			} break;
+
+			case MUVGC_DIRECTIVE_DEFINE: muVGC_directive_define(result, pp, hash); break;
+			case MUVGC_DIRECTIVE_UNDEF: muVGC_directive_undef(result, pp, hash); break;
+
+			case MUVGC_DIRECTIVE_IF: case MUVGC_DIRECTIVE_IFDEF: case MUVGC_DIRECTIVE_IFNDEF: {
+				muBool taken = MU_FALSE;
+				if (directive == MUVGC_DIRECTIVE_IF) {
+					taken = muVGC_evaluate_condition(result, pp, hash);
+				} else {
+					muVGCToken macro_name = muVGC_get_directive_macro_name(result, pp, hash);
+					if (*result != MU_SUCCESS) {
+						return MU_FALSE;
+					}
+					taken = (muVGC_find_macro(pp, macro_name) != 0) ? MU_TRUE : MU_FALSE;
+					if (directive == MUVGC_DIRECTIVE_IFNDEF) {
+						taken = (taken == MU_TRUE) ? MU_FALSE : MU_TRUE;
+					}
+				}
+				if (*result != MU_SUCCESS) {
+					return MU_FALSE;
+				}
+				muVGC_push_conditional(pp, hash, taken);
+				return (taken == MU_TRUE) ? MU_FALSE : MU_TRUE;
+			}
+
+			// (Reaching these while including code means that either the
+			// group before them was included, or that they're where a
+			// skipped group ended)
+			case MUVGC_DIRECTIVE_ELIF: case MUVGC_DIRECTIVE_ELSE: {
+				if (conditional == MU_NULL_PTR || conditional->has_else == MU_TRUE) {
+					muVGC_print_preprocessor_error(pp, hash);
+					if (conditional == MU_NULL_PTR) {
+						mu_print("expected #if before this directive\n");
+					} else {
+						mu_print("expected #endif after #else\n");
+					}
+					*result = MU_FAILURE;
+					return MU_FALSE;
+				}
+				if (conditional->taken == MU_TRUE) {
+					if (directive == MUVGC_DIRECTIVE_ELSE) {
+						conditional->has_else = MU_TRUE;
+					}
+					return MU_TRUE;
+				}
+				if (directive == MUVGC_DIRECTIVE_ELSE) {
+					muVGC_check_empty_directive(result, pp);
+					conditional->has_else = MU_TRUE;
+					conditional->taken = MU_TRUE;
+				} else {
+					conditional->taken = muVGC_evaluate_condition(result, pp, hash);
+					// (The conditionals may have moved while expanding)
+					conditional = &pp->conditionals[pp->conditional_len-1];
+					return (*result == MU_SUCCESS && conditional->taken == MU_FALSE) ? MU_TRUE : MU_FALSE;
+				}
+			} break;
+
+			case MUVGC_DIRECTIVE_ENDIF: {
+				if (conditional == MU_NULL_PTR) {
+					muVGC_print_preprocessor_error(pp, hash);
+					mu_print("expected #if before #endif\n");
+					*result = MU_FAILURE;
+					return MU_FALSE;
+				}
+				muVGC_check_empty_directive(result, pp);
+				pp->conditional_len -= 1;
+			} break;
+
+			// '#extension name : behavior' is checked but otherwise ignored,
+			// since every extension the compiler supports is always enabled
+			case MUVGC_DIRECTIVE_EXTENSION: {
+				muVGCToken* line = pp->line.tokens;
+				muBool valid = (pp->line.len == 3 && muVGC_is_macro_name_token(line[0]) == MU_TRUE && line[1].type == MUVGC_TOKEN_COLON) ? MU_TRUE : MU_FALSE;
+				if (valid == MU_TRUE) {
+					code = pp->code->s;
+					valid = (
+						muVGC_token_text_equals(code, line[2], "require", 7) == MU_TRUE || muVGC_token_text_equals(code, line[2], "enable", 6) == MU_TRUE ||
+						muVGC_token_text_equals(code, line[2], "warn", 4) == MU_TRUE || muVGC_token_text_equals(code, line[2], "disable", 7) == MU_TRUE
+					) ? MU_TRUE : MU_FALSE;
+				}
+				if (valid == MU_FALSE) {
+					muVGC_print_preprocessor_error(pp, hash);
+					mu_print("expected '#extension name : behavior', behavior being 'require', 'enable', 'warn' or 'disable'\n");
+					*result = MU_FAILURE;
+				}
+			} break;
+
+			// '#line line [source]' changes what __LINE__ and __FILE__ expand
+			// to from the next line on
+			case MUVGC_DIRECTIVE_LINE: {
+				muVGCTokenList expanded = { 0 };
+				muVGCTokenReader line_reader = { 0 };
+				line_reader.tokens = pp->line.tokens;
+				line_reader.token_len = pp->line.len;
+				muVGC_expand_tokens(result, pp, &line_reader, &expanded);
+				muVGC_free_token_reader(pp, &line_reader);
+
+				if (*result == MU_SUCCESS) {
+					if (expanded.len == 0 || expanded.len > 2 || expanded.tokens[0].type != MUVGC_TOKEN_INTEGER_CONSTANT || (expanded.len == 2 && expanded.tokens[1].type != MUVGC_TOKEN_INTEGER_CONSTANT)) {
+						muVGC_print_preprocessor_error(pp, hash);
+						mu_print("expected '#line line' or '#line line source'\n");
+						*result = MU_FAILURE;
+					} else {
+						int64_m line = (int64_m)muVGC_get_integer_token_value(pp->code->s, expanded.tokens[0]);
+						pp->line_offset = line - (int64_m)(muVGC_get_preprocessor_line(pp, hash) + 1);
+						if (expanded.len == 2) {
+							pp->source = muVGC_get_integer_token_value(pp->code->s, expanded.tokens[1]);
+						}
+					}
+				}
+				muVGC_token_list_free(&expanded);
+			} break;
+		}
+
+		return MU_FALSE;
+	}
+
+	// Handles the directive whose '#' is at 'i' in the shader's code,
+	// returning where the code goes on from
+	size_m muVGC_handle_code_directive(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader, size_m i) {
+		const char* code = pp->code->s;
+		size_m hash = i;
+		pp->last_index = hash;
+
+		i = muVGC_skip_spaces(code, pp->code_len, i+1, MU_FALSE, MU_NULL_PTR);
+		// (A '#' on its own does nothing)
+		if (i >= pp->code_len || code[i] == '\n') {
+			return i;
+		}
+		muVGCToken name = muVGC_get_token(code, pp->code_len, i);
+
+		size_m end = 0;
+		muVGCDirective directive = muVGC_get_directive(code, name);
+		if (directive == MUVGC_DIRECTIVE_PRAGMA || directive == MUVGC_DIRECTIVE_ERROR || directive == MUVGC_DIRECTIVE_INCLUDE) {
+			pp->line.len = 0;
+			end = muVGC_get_line_end(pp, name.index+name.length);
+		} else {
+			end = muVGC_read_directive_line(result, pp, name.index+name.length);
+			if (*result != MU_SUCCESS) {
+				return end;
+			}
+		}
+
+		if (muVGC_run_directive(result, pp, reader, hash, name) == MU_TRUE) {
+			return muVGC_skip_group(pp, end);
+		}
+		return end;
+	}
+
+	// Handles the directive whose '#' is the next token of the included file
+	// being read
+	void muVGC_handle_file_directive(muResult* result, muVGCPreprocessor* pp, muVGCTokenReader* reader) {
+		muVGCIncludeFrame* frame = &reader->files[reader->file_len-1];
+		muVGCCachedFile* file = muVGC_get_frame_file(pp, frame);
+		size_m base = frame->base;
+		size_m hash = file->tokens[frame->position].index + base;
+		pp->last_index = hash;
+
+		size_m first = frame->position+1;
+		size_m end = first;
+		while (end < file->token_len && file->line_starts[end] == MU_FALSE) {
+			end++;
+		}
+		frame->position = end;
+		// (A '#' on its own does nothing)
+		if (first == end) {
+			return;
+		}
+
+		muVGCToken name = file->tokens[first];
+		name.index += base;
+		muVGCDirective directive = muVGC_get_directive(pp->code->s, name);
+		pp->line.len = 0;
+		if (directive != MUVGC_DIRECTIVE_PRAGMA && directive != MUVGC_DIRECTIVE_ERROR && directive != MUVGC_DIRECTIVE_INCLUDE) {
+			for (size_m i = first+1; i < end; i++) {
+				muVGCToken token = file->tokens[i];
+				token.index += base;
+				if (token.type == MUVGC_TOKEN_UNKNOWN) {
+					muVGC_print_preprocessor_error(pp, token.index);
+					mu_print("unrecognized symbol\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				muVGC_token_list_add(&pp->line, token);
+			}
+		}
+
+		if (muVGC_run_directive(result, pp, reader, hash, name) == MU_TRUE) {
+			// (Skipping never comes with including, so the frame hasn't
+			// moved)
+			frame->position = muVGC_skip_file_group(file, frame->position);
+		}
+	}
+
+	// Defines a macro given outside of the code, as if by '#define name value'
+	// (the value being 1 if it isn't given)
+	void muVGC_define_given_macro(muResult* result, muVGCPreprocessor* pp, const muVGCDefine* define) {
+		const char* value = (define->value == MU_NULL_PTR) ? "1" : define->value;
+		size_m namelen = mu_strlen(define->name);
+		size_m valuelen = mu_strlen(value);
+
+		// Its text is added past the code for its tokens to point at
+		// (the nul skipped between the name & value being made a space)
+		size_m base = muVGC_add_code_text(pp, define->name, 0, namelen);
+		muVGC_add_code_text(pp, value, 0, valuelen);
+		pp->code->s[base+namelen] = ' ';
+		size_m len = pp->text_len - base;
+
+		if (pp->included_text_len == pp->allocated_included_text_len) {
+			pp->allocated_included_text_len = (pp->allocated_included_text_len == 0) ? 8 : pp->allocated_included_text_len*2;
+			pp->included_texts = (muVGCIncludedText*)mu_realloc(pp->included_texts, sizeof(muVGCIncludedText) * pp->allocated_included_text_len);
+		}
+		pp->included_texts[pp->included_text_len] = (muVGCIncludedText){ base, len, MUVGC_NO_FILE };
+		pp->included_text_len += 1;
+
+		const char* code = pp->code->s;
+		pp->line.len = 0;
+		size_m i = base;
+		while (MU_TRUE) {
+			i = muVGC_skip_spaces(code, pp->text_len, i, MU_FALSE, MU_NULL_PTR);
+			muVGCToken token = muVGC_get_token(code, pp->text_len, i);
+			if (token.type == MUVGC_TOKEN_END_OF_FILE || code[i] == '\n') {
+				break;
+			}
+			if (token.type == MUVGC_TOKEN_UNKNOWN) {
+				muVGC_print_preprocessor_error(pp, base);
+				mu_print("unrecognized symbol\n");
+				*result = MU_FAILURE;
+				return;
+			}
+			muVGC_token_list_add(&pp->line, token);
+			i = token.index + token.length;
+		}
+		if (code[i] == '\n') {
+			muVGC_print_preprocessor_error(pp, base);
+			mu_print("defines can't span multiple lines\n");
+			*result = MU_FAILURE;
+			return;
+		}
+
+		muVGC_directive_define(result, pp, base);
+	}
+
+	// Final handling
+
+	// Preprocesses the code (the version having been cleared), returning its
+	// tokens; if the code was lexed ahead of time, its tokens are read from
+	// 'lexed_source', and the given defines are defined after the options'
+	// Watched macros
+
+	// Compiling permutations (see mu_compile_vulkan_glsl_permutations)
+	// watches the names of the macros that the define sets give. The ones
+	// that preprocessing a permutation looks up (to expand them, for
+	// 'defined' or #ifdef, or to #define or #undef them) are the only given
+	// macros its result can depend on, so a later permutation whose define
+	// set gives the same definitions of all of them would be preprocessed
+	// (and compiled) exactly the same way, and takes its result instead.
+
+	#define MUVGC_NO_PERMUTATION ((size_m)-1)
+
+	struct muVGCMacroWatch {
+		const muVGCDefineSet* define_sets;
+		// The watched names (pointing into the defines' names), and whether
+		// each was looked up when preprocessing each permutation (name_len
+		// of them per permutation)
+		const char** names;
+		size_m* name_lens;
+		size_m name_len;
+		muBool* read;
+		// Whether each permutation was preprocessed, and so whether what it
+		// looked up is known
+		muBool* preprocessed;
+		// The permutation being preprocessed, and the earlier one whose
+		// result it takes (or MUVGC_NO_PERMUTATION)
+		size_m current;
+		size_m reused;
+	};
+	typedef struct muVGCMacroWatch muVGCMacroWatch;
+
+	// Returns the length of the macro name of a given define (its
+	// parameters excluded)
+	size_m muVGC_get_define_name_length(const char* name) {
+		size_m len = 0;
+		while (name[len] != '\0' && name[len] != '(' && name[len] != ' ' && name[len] != '\t') {
+			len++;
+		}
+		return len;
+	}
+
+	muBool muVGC_define_has_name(const muVGCDefine* define, const char* name, size_m namelen) {
+		return (muVGC_get_define_name_length(define->name) == namelen && mu_strncmp(define->name, name, namelen) == 0) ? MU_TRUE : MU_FALSE;
+	}
+
+	muBool muVGC_define_strings_equal(const char* a, const char* b) {
+		size_m len = mu_strlen(a);
+		return (mu_strlen(b) == len && mu_strncmp(a, b, len) == 0) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Whether two define sets give the same definitions (in the same order)
+	// of the macro with the given name, not giving it at all included
+	muBool muVGC_define_sets_agree(const muVGCDefineSet* a, const muVGCDefineSet* b, const char* name, size_m namelen) {
+		size_m i = 0, j = 0;
+		while (MU_TRUE) {
+			while (i < a->define_len && muVGC_define_has_name(&a->defines[i], name, namelen) == MU_FALSE) {
+				i++;
+			}
+			while (j < b->define_len && muVGC_define_has_name(&b->defines[j], name, namelen) == MU_FALSE) {
+				j++;
+			}
+			if (i == a->define_len || j == b->define_len) {
+				return (i == a->define_len && j == b->define_len) ? MU_TRUE : MU_FALSE;
+			}
+			const char* a_value = (a->defines[i].value == MU_NULL_PTR) ? "1" : a->defines[i].value;
+			const char* b_value = (b->defines[j].value == MU_NULL_PTR) ? "1" : b->defines[j].value;
+			if (muVGC_define_strings_equal(a->defines[i].name, b->defines[j].name) == MU_FALSE ||
+				muVGC_define_strings_equal(a_value, b_value) == MU_FALSE) {
+				return MU_FALSE;
+			}
+			i++;
+			j++;
+		}
+	}
+
+	// Returns the earlier permutation whose result the one being
+	// preprocessed would have, or MUVGC_NO_PERMUTATION
+	size_m muVGC_find_reusable_permutation(muVGCMacroWatch* watch) {
+		const muVGCDefineSet* set = &watch->define_sets[watch->current];
+		for (size_m p = 0; p < watch->current; p++) {
+			if (watch->preprocessed[p] == MU_FALSE) continue;
+			muBool agree = MU_TRUE;
+			for (size_m n = 0; n < watch->name_len && agree == MU_TRUE; n++) {
+				if (watch->read[p*watch->name_len + n] == MU_TRUE) {
+					agree = muVGC_define_sets_agree(set, &watch->define_sets[p], watch->names[n], watch->name_lens[n]);
+				}
+			}
+			if (agree == MU_TRUE) {
+				return p;
+			}
+		}
+		return MUVGC_NO_PERMUTATION;
+	}
+
+	// Gives the watched names slots (whether they're defined or not), so
+	// that looking them up from here on is noted
+	void muVGC_watch_macros(muVGCPreprocessor* pp, muVGCMacroWatch* watch) {
+		for (size_m n = 0; n < watch->name_len; n++) {
+			muVGCToken name = muVGC_make_code_token(pp, watch->names[n], watch->name_lens[n]);
+			name.length = watch->name_lens[n];
+			pp->macros[muVGC_get_macro_slot(pp, name)].watched = n+1;
+		}
+		pp->watched_read = &watch->read[watch->current * watch->name_len];
+		watch->preprocessed[watch->current] = MU_TRUE;
+	}
+
+	// Preprocesses the code; if 'watch' isn't MU_NULL_PTR, a permutation
+	// that can take an earlier one's result stops once its defines are
+	// (giving no tokens)
+	muVGCToken* muVGC_preprocess(
+		muResult* result, muString* code, const char* og, uint32_m version, const muVGCOptions* options,
+		muVGCCachedFile* lexed_source, const muVGCDefineSet* define_set, muVGCMacroWatch* watch, size_m* len) {
+
+		muVGCPreprocessor pp = { 0 };
+		pp.options = options;
+		muVGCIncludeCache compile_include_cache = { 0 };
+		pp.include_cache = (options->include_cache != MU_NULL_PTR) ? options->include_cache : &compile_include_cache;
+		pp.code = code;
+		pp.code_len = mu_string_strlen(*code);
+		pp.text_len = pp.code_len;
+		pp.og = og;
+		pp.version = version;
+		pp.generation = 1;
+		pp.macro_capacity = 64;
+		pp.macros = (muVGCMacro*)mu_malloc(sizeof(muVGCMacro) * pp.macro_capacity);
+		for (size_m i = 0; i < pp.macro_capacity; i++) {
+			pp.macros[i] = (muVGCMacro){ 0 };
+		}
+		muVGC_define_predefined_macros(&pp);
+		pp.zero = muVGC_make_code_token(&pp, "0", 1);
+		pp.one = muVGC_make_code_token(&pp, "1", 1);
+
+		muVGCTokenReader reader = { 0 };
+		reader.lexing = MU_TRUE;
+		reader.line_start = MU_TRUE;
+		muVGCTokenList out = { 0 };
+
+		muResult res = MU_SUCCESS;
+		for (size_m i = 0; res == MU_SUCCESS && i < options->define_len; i++) {
+			muVGC_define_given_macro(&res, &pp, &options->defines[i]);
+		}
+		for (size_m i = 0; res == MU_SUCCESS && define_set != MU_NULL_PTR && i < define_set->define_len; i++) {
+			muVGC_define_given_macro(&res, &pp, &define_set->defines[i]);
+		}
+		muBool reused = MU_FALSE;
+		if (res == MU_SUCCESS && watch != MU_NULL_PTR) {
+			watch->reused = muVGC_find_reusable_permutation(watch);
+			if (watch->reused != MUVGC_NO_PERMUTATION) {
+				reused = MU_TRUE;
+			} else {
+				muVGC_watch_macros(&pp, watch);
+			}
+		}
+
+		// (Code lexed ahead of time is read like an included file, lexing
+		// starting at the end of the code)
+		if (lexed_source != MU_NULL_PTR) {
+			pp.lexed_source = lexed_source;
+			muVGC_push_include_frame(&pp, &reader, MUVGC_NO_FILE, 0);
+			reader.position = pp.code_len;
+		}
+
+		if (res == MU_SUCCESS && reused == MU_FALSE) {
+			muVGC_expand_tokens(&res, &pp, &reader, &out);
+		}
+
+		if (res == MU_SUCCESS && pp.conditional_len != 0) {
+			muVGC_print_preprocessor_error(&pp, pp.conditionals[pp.conditional_len-1].index);
+			mu_print("expected #endif to close this conditional\n");
+			res = MU_FAILURE;
+		}
+		// ('#' and '##' are only valid in directives)
+		for (size_m i = 0; res == MU_SUCCESS && i < out.len; i++) {
+			if (out.tokens[i].type == MUVGC_TOKEN_HASH || out.tokens[i].type == MUVGC_TOKEN_DOUBLE_HASH) {
+				muVGC_print_preprocessor_error(&pp, out.tokens[i].index);
+				mu_print("'#' can only start a preprocessor directive\n");
+				res = MU_FAILURE;
+			}
+		}
+		if (res == MU_SUCCESS && reused == MU_FALSE && out.len == 0) {
+			mu_print("[muVGC] Syntax error; expected at least one token after version\n");
+			res = MU_FAILURE;
+		}
+
+		muVGC_free_token_reader(&pp, &reader);
+		mu_free(pp.macros);
+		muVGC_token_list_free(&pp.macro_tokens);
+		if (pp.macro_token_parameters != MU_NULL_PTR) {
+			mu_free(pp.macro_token_parameters);
+		}
+		muVGC_token_list_free(&pp.cache);
+		muVGC_token_list_free(&pp.line);
+		if (pp.conditionals != MU_NULL_PTR) {
+			mu_free(pp.conditionals);
+		}
+		if (pp.included_texts != MU_NULL_PTR) {
+			mu_free(pp.included_texts);
+		}
+		muVGC_free_include_cache(&compile_include_cache);
+
+		if (res != MU_SUCCESS) {
+			muVGC_token_list_free(&out);
+			*result = MU_FAILURE;
+			return MU_NULL_PTR;
+		}
+		*len = out.len;
+		return out.tokens;
+	}
+
+	muVGCToken* muVGC_handle_macros(muResult* result, muString* code, const char* og, muVGCModule* module, muVGCShader shader, const muVGCOptions* options, muVGCCachedFile* lexed_source, const muVGCDefineSet* define_set, muVGCMacroWatch* watch, size_m* token_len) {
+		muResult res = MU_SUCCESS;
+
+		uint32_m version = 0;
+		muVGC_macro_handle_version(&res, *code, og, module, shader, &version);
+		if (res != MU_SUCCESS) {
+			*result = MU_FAILURE;
+			return MU_NULL_PTR;
+		}
+
+		muVGCToken* tokens = muVGC_preprocess(&res, code, og, version, options, lexed_source, define_set, watch, token_len);
+		if (res != MU_SUCCESS) {
+			*result = MU_FAILURE;
+			return MU_NULL_PTR;
+		}
+		return tokens;
+	}
+
+/* VARIABLE HANDLING */
+
+	// Structs
+
+		struct muVGCParameter {
+			muVGCBasicType type;
+			muVGCToken token_name;
+			muBool is_array;
+			size_m arraylen;
+		};
+		typedef struct muVGCParameter muVGCParameter;
+
+		muBool muVGC_are_two_parameters_equivalent(const char* code, muVGCParameter p0, muVGCParameter p1) {
+			return p0.type == p1.type && p0.token_name.length == p1.token_name.length &&
+			mu_strncmp(muVGC_get_token_value(code, p0.token_name), muVGC_get_token_value(code, p1.token_name), p0.token_name.length) == 0 &&
+			p0.is_array == p1.is_array && p0.arraylen == p1.arraylen;
+		}
+
+		struct muVGCVariable {
+			muBool active;
+			muVGCBasicType type;
+			muVGCToken token_name;
+			muBool is_array;
+			size_m arraylen;
+			muBool is_function;
+			size_m scope;
+			muBool is_function_implemented;
+			muVGCParameter* parameters;
+			size_m parameterlen;
+			uint32_m id;
+		};
+		typedef struct muVGCVariable muVGCVariable;
+
+		muVGCVariable muVGC_make_variable(
+			muBool active, muVGCBasicType type, muVGCToken token_name, muBool is_array, 
+			size_m arraylen, muBool is_function, size_m scope, muBool is_function_implemented,
+			muVGCParameter* parameters, size_m parameterlen, uint32_m id) {
+			muVGCVariable var = {0};
+			var.active = active; var.type = type; var.token_name = token_name;
+			var.is_array = is_array; var.arraylen = arraylen; var.is_function = is_function;
+			var.scope = scope; var.is_function_implemented = is_function_implemented;
+			var.parameters = parameters; var.parameterlen = parameterlen; var.id = id;
+			return var;
+		}
+
+		struct muVGCVariableList {
+			muVGCVariable* variables;
+			size_m len;
+			size_m allocated_len;
+		};
+		typedef struct muVGCVariableList muVGCVariableList;
+
+	// Functions
+
+		muVGCVariableList muVGC_intialize_empty_variable_list() {
+			muVGCVariableList list = {0};
+			list.variables = MU_NULL_PTR;
+			list.len = 0;
+			list.allocated_len = 0;
+			return list;
+		}
+
+		muVGCVariableList muVGC_empty_variable_list(muVGCVariableList list) {
+			if (list.variables != MU_NULL_PTR) {
+				for (size_m i = 0; i < list.len; i++) {
+					if (list.variables[i].parameters != MU_NULL_PTR) {
+						mu_free(list.variables[i].parameters);
+						list.variables[i].parameters = MU_NULL_PTR;
+						list.variables[i].parameterlen = 0;
+					}
+				}
+				mu_free(list.variables);
+				list.variables = MU_NULL_PTR;
+			}
+			list.len = 0;
+			list.allocated_len = 0;
+			return list;
+		}
+
+		muVGCVariableList muVGC_add_variable(muVGCVariableList list, muVGCVariable var) {
+			if (list.variables == MU_NULL_PTR) {
+				list.len = 1;
+				list.allocated_len = 2;
+				list.variables = mu_malloc(sizeof(muVGCVariable) * list.allocated_len);
+				list.variables[0] = var;
+				list.variables[0].active = MU_TRUE;
+				return list;
+			}
+			for (size_m i = 0; i < list.len; i++) {
+				if (list.variables[i].active == MU_FALSE) {
+					list.variables[i] = var;
+					list.variables[i].active = MU_TRUE;
+					return list;
+				}
+			}
+			list.len += 1;
+			if (list.len >= list.allocated_len) {
+				list.allocated_len *= 2;
+				list.variables = mu_realloc(list.variables, list.allocated_len * sizeof(muVGCVariable));
+			}
+			list.variables[list.len-1] = var;
+			list.variables[list.len-1].active = MU_TRUE;
+			return list;
+		}
+
+		muVGCVariableList muVGC_remove_variable(muVGCVariableList list, size_m i) {
+			if (i < list.len) {
+				list.variables[i].active = MU_FALSE;
+				if (list.variables[i].parameters != MU_NULL_PTR) {
+					mu_free(list.variables[i].parameters);
+					list.variables[i].parameters = MU_NULL_PTR;
+					list.variables[i].parameterlen = 0;
+				}
+			}
+			return list;
+		}
+
+	// Declaration functions
+
+		uint32_m muVGC_get_transparent_type(muVGCModule* module, muVGCBasicType type) {
+			switch (type) {
+				default: return 0; break;
+				case MUVGC_TYPE_VOID: {
+					return muVGC_get_void_type(module);
+				} break;
+				case MUVGC_TYPE_BOOL: {
+					return muVGC_get_bool_type(module);
+				} break;
+				case MUVGC_TYPE_INT: {
+					return muVGC_get_int_type(module, 32, 1);
+				} break;
+				case MUVGC_TYPE_UINT: {
+					return muVGC_get_int_type(module, 32, 0);
+				} break;
+				case MUVGC_TYPE_FLOAT: {
+					return muVGC_get_float_type(module, 32);
+				} break;
+				case MUVGC_TYPE_DOUBLE: {
+					return muVGC_get_float_type(module, 64);
+				} break;
+				case MUVGC_TYPE_VEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 2);
+				} break;
+				case MUVGC_TYPE_VEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 3);
+				} break;
+				case MUVGC_TYPE_VEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 4);
+				} break;
+				case MUVGC_TYPE_DVEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 2);
+				} break;
+				case MUVGC_TYPE_DVEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 3);
+				} break;
+				case MUVGC_TYPE_DVEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 4);
+				} break;
+				case MUVGC_TYPE_BVEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_bool_type(module), 2);
+				} break;
+				case MUVGC_TYPE_BVEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_bool_type(module), 3);
+				} break;
+				case MUVGC_TYPE_BVEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_bool_type(module), 4);
+				} break;
+				case MUVGC_TYPE_IVEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 32, 1), 2);
+				} break;
+				case MUVGC_TYPE_IVEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 32, 1), 3);
+				} break;
+				case MUVGC_TYPE_IVEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 32, 1), 4);
+				} break;
+				case MUVGC_TYPE_UVEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 32, 0), 2);
+				} break;
+				case MUVGC_TYPE_UVEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 32, 0), 3);
+				} break;
+				case MUVGC_TYPE_UVEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 32, 0), 4);
+				} break;
+				case MUVGC_TYPE_MAT2: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 2), 2);
+				} break;
+				case MUVGC_TYPE_MAT3: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 3), 3);
+				} break;
+				case MUVGC_TYPE_MAT4: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 4), 4);
+				} break;
+				case MUVGC_TYPE_MAT2X2: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 2), 2);
+				} break;
+				case MUVGC_TYPE_MAT2X3: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 3), 2);
+				} break;
+				case MUVGC_TYPE_MAT2X4: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 4), 2);
+				} break;
+				case MUVGC_TYPE_MAT3X2: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 2), 3);
+				} break;
+				case MUVGC_TYPE_MAT3X3: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 3), 3);
+				} break;
+				case MUVGC_TYPE_MAT3X4: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 4), 3);
+				} break;
+				case MUVGC_TYPE_MAT4X2: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 2), 4);
+				} break;
+				case MUVGC_TYPE_MAT4X3: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 3), 4);
+				} break;
+				case MUVGC_TYPE_MAT4X4: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 32), 4), 4);
+				} break;
+				case MUVGC_TYPE_DMAT2: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 2), 2);
+				} break;
+				case MUVGC_TYPE_DMAT3: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 3), 3);
+				} break;
+				case MUVGC_TYPE_DMAT4: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 4), 4);
+				} break;
+				case MUVGC_TYPE_DMAT2X2: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 2), 2);
+				} break;
+				case MUVGC_TYPE_DMAT2X3: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 3), 2);
+				} break;
+				case MUVGC_TYPE_DMAT2X4: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 4), 2);
+				} break;
+				case MUVGC_TYPE_DMAT3X2: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 2), 3);
+				} break;
+				case MUVGC_TYPE_DMAT3X3: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 3), 3);
+				} break;
+				case MUVGC_TYPE_DMAT3X4: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 4), 3);
+				} break;
+				case MUVGC_TYPE_DMAT4X2: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 2), 4);
+				} break;
+				case MUVGC_TYPE_DMAT4X3: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 3), 4);
+				} break;
+				case MUVGC_TYPE_DMAT4X4: {
+					return muVGC_get_matrix_type(module, muVGC_get_vector_type(module, muVGC_get_float_type(module, 64), 4), 4);
+				} break;
+				case MUVGC_TYPE_FLOAT16: {
+					return muVGC_get_float_type(module, 16);
+				} break;
+				case MUVGC_TYPE_F16VEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 16), 2);
+				} break;
+				case MUVGC_TYPE_F16VEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 16), 3);
+				} break;
+				case MUVGC_TYPE_F16VEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_float_type(module, 16), 4);
+				} break;
+				case MUVGC_TYPE_INT16: {
+					return muVGC_get_int_type(module, 16, 1);
+				} break;
+				case MUVGC_TYPE_I16VEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 16, 1), 2);
+				} break;
+				case MUVGC_TYPE_I16VEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 16, 1), 3);
+				} break;
+				case MUVGC_TYPE_I16VEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 16, 1), 4);
+				} break;
+				case MUVGC_TYPE_UINT16: {
+					return muVGC_get_int_type(module, 16, 0);
+				} break;
+				case MUVGC_TYPE_U16VEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 16, 0), 2);
+				} break;
+				case MUVGC_TYPE_U16VEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 16, 0), 3);
+				} break;
+				case MUVGC_TYPE_U16VEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 16, 0), 4);
+				} break;
+				case MUVGC_TYPE_INT8: {
+					return muVGC_get_int_type(module, 8, 1);
+				} break;
+				case MUVGC_TYPE_I8VEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 8, 1), 2);
+				} break;
+				case MUVGC_TYPE_I8VEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 8, 1), 3);
+				} break;
+				case MUVGC_TYPE_I8VEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 8, 1), 4);
+				} break;
+				case MUVGC_TYPE_UINT8: {
+					return muVGC_get_int_type(module, 8, 0);
+				} break;
+				case MUVGC_TYPE_U8VEC2: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 8, 0), 2);
+				} break;
+				case MUVGC_TYPE_U8VEC3: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 8, 0), 3);
+				} break;
+				case MUVGC_TYPE_U8VEC4: {
+					return muVGC_get_vector_type(module, muVGC_get_int_type(module, 8, 0), 4);
+				} break;
+			}
+		}
+
+	// Built-in variables
+
+		struct muVGCBuiltInVariable {
+			const char* name;
+			size_m namelen;
+			// Stage it's available in, unless it's available in all of them
+			muVGCShader shader;
+			muBool any_shader;
+			muVGCBasicType type;
+			muVGCBuiltIn built_in;
+			// Group non-uniform capability it needs, or 0
+			uint32_m capability;
+		};
+		typedef struct muVGCBuiltInVariable muVGCBuiltInVariable;
+
+		#define MUVGC_BUILT_IN_VARIABLE(name, shader, type, built_in) { name, sizeof(name)-1, shader, MU_FALSE, type, built_in, 0 }
+		#define MUVGC_SUBGROUP_BUILT_IN_VARIABLE(name, compute_only, type, built_in, capability) { name, sizeof(name)-1, MUVGC_COMPUTE, (compute_only) ? MU_FALSE : MU_TRUE, type, built_in, capability }
+
+		// (gl_WorkGroupSize is a constant rather than a variable, and the
+		// outputs of vertex shaders are members of their gl_PerVertex block,
+		// so they're handled on their own)
+		const muVGCBuiltInVariable muVGC_global_built_in_variables[] = {
+			MUVGC_BUILT_IN_VARIABLE("gl_NumWorkGroups", MUVGC_COMPUTE, MUVGC_TYPE_UVEC3, MUVGC_BUILT_IN_NUM_WORKGROUPS),
+			MUVGC_BUILT_IN_VARIABLE("gl_WorkGroupID", MUVGC_COMPUTE, MUVGC_TYPE_UVEC3, MUVGC_BUILT_IN_WORKGROUP_ID),
+			MUVGC_BUILT_IN_VARIABLE("gl_LocalInvocationID", MUVGC_COMPUTE, MUVGC_TYPE_UVEC3, MUVGC_BUILT_IN_LOCAL_INVOCATION_ID),
+			MUVGC_BUILT_IN_VARIABLE("gl_GlobalInvocationID", MUVGC_COMPUTE, MUVGC_TYPE_UVEC3, MUVGC_BUILT_IN_GLOBAL_INVOCATION_ID),
+			MUVGC_BUILT_IN_VARIABLE("gl_LocalInvocationIndex", MUVGC_COMPUTE, MUVGC_TYPE_UINT, MUVGC_BUILT_IN_LOCAL_INVOCATION_INDEX),
+			MUVGC_BUILT_IN_VARIABLE("gl_VertexIndex", MUVGC_VERTEX, MUVGC_TYPE_INT, MUVGC_BUILT_IN_VERTEX_INDEX),
+			MUVGC_BUILT_IN_VARIABLE("gl_InstanceIndex", MUVGC_VERTEX, MUVGC_TYPE_INT, MUVGC_BUILT_IN_INSTANCE_INDEX),
+			MUVGC_BUILT_IN_VARIABLE("gl_FragCoord", MUVGC_FRAGMENT, MUVGC_TYPE_VEC4, MUVGC_BUILT_IN_FRAG_COORD),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_NumSubgroups", MU_TRUE, MUVGC_TYPE_UINT, MUVGC_BUILT_IN_NUM_SUBGROUPS, MUVGC_CAPABILITY_GROUP_NON_UNIFORM),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_SubgroupID", MU_TRUE, MUVGC_TYPE_UINT, MUVGC_BUILT_IN_SUBGROUP_ID, MUVGC_CAPABILITY_GROUP_NON_UNIFORM),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_SubgroupSize", MU_FALSE, MUVGC_TYPE_UINT, MUVGC_BUILT_IN_SUBGROUP_SIZE, MUVGC_CAPABILITY_GROUP_NON_UNIFORM),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_SubgroupInvocationID", MU_FALSE, MUVGC_TYPE_UINT, MUVGC_BUILT_IN_SUBGROUP_LOCAL_INVOCATION_ID, MUVGC_CAPABILITY_GROUP_NON_UNIFORM),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_SubgroupEqMask", MU_FALSE, MUVGC_TYPE_UVEC4, MUVGC_BUILT_IN_SUBGROUP_EQ_MASK, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_SubgroupGeMask", MU_FALSE, MUVGC_TYPE_UVEC4, MUVGC_BUILT_IN_SUBGROUP_GE_MASK, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_SubgroupGtMask", MU_FALSE, MUVGC_TYPE_UVEC4, MUVGC_BUILT_IN_SUBGROUP_GT_MASK, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_SubgroupLeMask", MU_FALSE, MUVGC_TYPE_UVEC4, MUVGC_BUILT_IN_SUBGROUP_LE_MASK, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT),
+			MUVGC_SUBGROUP_BUILT_IN_VARIABLE("gl_SubgroupLtMask", MU_FALSE, MUVGC_TYPE_UVEC4, MUVGC_BUILT_IN_SUBGROUP_LT_MASK, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT)
+		};
+		#define MUVGC_BUILT_IN_VARIABLE_COUNT (sizeof(muVGC_global_built_in_variables) / sizeof(muVGCBuiltInVariable))
+
+		// Returns the built-in variable of the module's stage with the given
+		// name, or MU_NULL_PTR if there's none
+		const muVGCBuiltInVariable* muVGC_find_built_in_variable(muVGCModule* module, const char* name, size_m namelen) {
+			for (size_m i = 0; i < MUVGC_BUILT_IN_VARIABLE_COUNT; i++) {
+				const muVGCBuiltInVariable* variable = &muVGC_global_built_in_variables[i];
+				if ((variable->any_shader == MU_TRUE || variable->shader == module->shader) &&
+					variable->namelen == namelen && mu_strncmp(variable->name, name, namelen) == 0) {
+					return variable;
+				}
+			}
+			return MU_NULL_PTR;
+		}
+
+		// Returns the input variable of a built-in, declaring it (and adding
+		// it to the entry point's interface) the first time it's used
+		uint32_m muVGC_get_built_in_variable(muVGCModule* module, const muVGCBuiltInVariable* variable) {
+			uint32_m id = muVGC_find_built_in(module, variable->built_in);
+			if (id != 0) {
+				return id;
+			}
+			if (variable->capability != 0) {
+				muVGC_require_group_non_uniform(module, variable->capability);
+			}
+			uint32_m type = muVGC_get_transparent_type(module, variable->type);
+			uint32_m pointer_type = muVGC_get_pointer_type(module, MUVGC_STORAGE_CLASS_INPUT, type);
+			id = muVGC_op_global_variable(module, MUVGC_STORAGE_CLASS_INPUT, pointer_type);
+			muVGC_op_name(module, id, (char*)variable->name, variable->namelen);
+			muVGC_op_decorate_literal(module, id, MUVGC_DECORATION_BUILT_IN, variable->built_in);
+			// (Integer inputs of fragment shaders can't be interpolated)
+			size_m columns = 1, rows = 1;
+			muVGCScalarKind kind = muVGC_get_type_shape(module, type, &columns, &rows);
+			if (module->shader == MUVGC_FRAGMENT && (kind == MUVGC_SCALAR_INT || kind == MUVGC_SCALAR_UINT)) {
+				muVGC_op_decorate(module, id, MUVGC_DECORATION_FLAT);
+			}
+			muVGC_add_interface_variable(module, id);
+			return id;
+		}
+
+		// Members of the gl_PerVertex block, which vertex shaders output
+		// built-ins through (gl_ClipDistance and gl_CullDistance are left
+		// out, since they'd need capabilities of their own)
+		const muVGCBuiltInVariable muVGC_global_per_vertex_members[] = {
+			MUVGC_BUILT_IN_VARIABLE("gl_Position", MUVGC_VERTEX, MUVGC_TYPE_VEC4, MUVGC_BUILT_IN_POSITION),
+			MUVGC_BUILT_IN_VARIABLE("gl_PointSize", MUVGC_VERTEX, MUVGC_TYPE_FLOAT, MUVGC_BUILT_IN_POINT_SIZE)
+		};
+		#define MUVGC_PER_VERTEX_MEMBER_COUNT (sizeof(muVGC_global_per_vertex_members) / sizeof(muVGCBuiltInVariable))
+
+/* STATEMENT TYPE HANDLING */
+
+	// Statement types
+
+	enum muVGCStatementType {
+		MUVGC_STATEMENT_UNKNOWN=0,
+		MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION=1,
+		MUVGC_STATEMENT_SCOPE_OPEN=2,
+		MUVGC_STATEMENT_SCOPE_CLOSE=3,
+		MUVGC_STATEMENT_ATTRIBUTE=4,
+		MUVGC_STATEMENT_FUNCTION_CALL=5,
+		MUVGC_STATEMENT_FOR_LOOP=6,
+		MUVGC_STATEMENT_IF=7,
+		MUVGC_STATEMENT_ELSE=8,
+		MUVGC_STATEMENT_PRECISION=9,
+		MUVGC_STATEMENT_LAYOUT_IN=10,
+		MUVGC_STATEMENT_SHARED_VARIABLE=11,
+		MUVGC_STATEMENT_INTERFACE_VARIABLE=12,
+		MUVGC_STATEMENT_ASSIGNMENT=13,
+		MUVGC_STATEMENT_CONSTANT=14,
+		MUVGC_STATEMENT_BLOCK=15,
+		MUVGC_STATEMENT_LOCAL_VARIABLE=16,
+		MUVGC_STATEMENT_RETURN=17
+
+		#define MUVGC_STATEMENT_FIRST MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION
+		#define MUVGC_STATEMENT_LAST  MUVGC_STATEMENT_RETURN
+	};
+	typedef enum muVGCStatementType muVGCStatementType;
+
+	// @DEBUG
+	void muVGC_print_statement_type(muVGCStatementType type) {
+		switch (type) {
+			default: mu_print("unknown"); break;
+			case MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION: mu_print("function implementation"); break;
+			case MUVGC_STATEMENT_SCOPE_OPEN: mu_print("scope open"); break;
+			case MUVGC_STATEMENT_SCOPE_CLOSE: mu_print("scope close"); break;
+			case MUVGC_STATEMENT_ATTRIBUTE: mu_print("attribute"); break;
+			case MUVGC_STATEMENT_FUNCTION_CALL: mu_print("function call"); break;
+			case MUVGC_STATEMENT_FOR_LOOP: mu_print("for loop"); break;
+			case MUVGC_STATEMENT_IF: mu_print("if"); break;
+			case MUVGC_STATEMENT_ELSE: mu_print("else"); break;
+			case MUVGC_STATEMENT_PRECISION: mu_print("precision"); break;
+			case MUVGC_STATEMENT_LAYOUT_IN: mu_print("layout in"); break;
+			case MUVGC_STATEMENT_SHARED_VARIABLE: mu_print("shared variable"); break;
+			case MUVGC_STATEMENT_INTERFACE_VARIABLE: mu_print("interface variable"); break;
+			case MUVGC_STATEMENT_ASSIGNMENT: mu_print("assignment"); break;
+			case MUVGC_STATEMENT_CONSTANT: mu_print("constant"); break;
+			case MUVGC_STATEMENT_BLOCK: mu_print("block"); break;
+			case MUVGC_STATEMENT_LOCAL_VARIABLE: mu_print("local variable"); break;
+			case MUVGC_STATEMENT_RETURN: mu_print("return"); break;
+		}
+	}
+
+	// Attributes
+
+	// Attributes ([[...]], from GL_EXT_control_flow_attributes) apply to the
+	// statement right after them; unrecognized ones are ignored
+
+	// Returns the attribute the token names, or 0 if it names none
+	uint32_m muVGC_get_attribute(muVGCToken token) {
+		return (token.keyword == MU_NULL_PTR) ? 0 : token.keyword->attribute;
+	}
+
+	// Are two attributes that contradict each other both given?
+	muBool muVGC_attributes_conflict(uint32_m attributes) {
+		return (
+			((attributes & MUVGC_ATTRIBUTE_INLINE) != 0 && (attributes & MUVGC_ATTRIBUTE_DONT_INLINE) != 0) ||
+			((attributes & MUVGC_ATTRIBUTE_UNROLL) != 0 && (attributes & MUVGC_ATTRIBUTE_DONT_UNROLL) != 0) ||
+			((attributes & MUVGC_ATTRIBUTE_FLATTEN) != 0 && (attributes & MUVGC_ATTRIBUTE_BRANCH) != 0)
+		) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Precision
+
+	// Precision qualifiers (and default precision statements, such as
+	// precision mediump float;) apply to float- and int-based types; lowp
+	// and mediump values get decorated RelaxedPrecision. Without a
+	// qualifier or default, values are highp.
+
+	// Which default precision a type falls under
+	enum muVGCPrecisionType {
+		MUVGC_PRECISION_TYPE_NONE=0,
+		MUVGC_PRECISION_TYPE_FLOAT=1,
+		MUVGC_PRECISION_TYPE_INT=2
+	};
+	typedef enum muVGCPrecisionType muVGCPrecisionType;
+
+	// Returns MUVGC_PRECISION_NONE if the token isn't a precision qualifier
+	muVGCPrecision muVGC_get_precision_qualifier(muVGCToken token) {
+		return (token.keyword == MU_NULL_PTR) ? MUVGC_PRECISION_NONE : token.keyword->precision;
+	}
+
+	muVGCPrecisionType muVGC_get_precision_type(muVGCBasicType type) {
+		switch (type) {
+			default: return MUVGC_PRECISION_TYPE_NONE; break;
+			case MUVGC_TYPE_FLOAT: case MUVGC_TYPE_VEC2: case MUVGC_TYPE_VEC3: case MUVGC_TYPE_VEC4:
+			case MUVGC_TYPE_MAT2: case MUVGC_TYPE_MAT3: case MUVGC_TYPE_MAT4: case MUVGC_TYPE_MAT2X2:
+			case MUVGC_TYPE_MAT2X3: case MUVGC_TYPE_MAT2X4: case MUVGC_TYPE_MAT3X2: case MUVGC_TYPE_MAT3X3:
+			case MUVGC_TYPE_MAT3X4: case MUVGC_TYPE_MAT4X2: case MUVGC_TYPE_MAT4X3: case MUVGC_TYPE_MAT4X4: {
+				return MUVGC_PRECISION_TYPE_FLOAT;
+			} break;
+			case MUVGC_TYPE_INT: case MUVGC_TYPE_UINT: case MUVGC_TYPE_IVEC2: case MUVGC_TYPE_IVEC3: case MUVGC_TYPE_IVEC4:
+			case MUVGC_TYPE_UVEC2: case MUVGC_TYPE_UVEC3: case MUVGC_TYPE_UVEC4: {
+				return MUVGC_PRECISION_TYPE_INT;
+			} break;
+		}
+	}
+
+	// Offset of the return type in a function implementation (past its
+	// precision qualifier, if any)
+	size_m muVGC_get_function_implementation_offset(muVGCToken* tokens, size_m token_len) {
+		return (token_len > 0 && muVGC_get_precision_qualifier(tokens[0]) != MUVGC_PRECISION_NONE) ? 1 : 0;
+	}
+
+	// Shared parsing
+
+	// Reads a possibly negated integer constant at tokens[*i]
+	muResult muVGC_get_integer_literal(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* i, uint32_m* value) {
+
+		muBool negate = MU_FALSE;
+		if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_DASH) {
+			negate = MU_TRUE;
+			*i += 1;
+		}
+		if (*i >= token_len || tokens[*i].type != MUVGC_TOKEN_INTEGER_CONSTANT) {
+			muVGC_print_syntax_error(og, tokens[(*i >= token_len) ? token_len-1 : *i].index);
+			mu_print("expected integer constant\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		*value = muVGC_get_integer_token_value(code, tokens[*i]);
+		if (negate == MU_TRUE) {
+			*value = (~*value) + 1;
+		}
+		*i += 1;
+		return MU_SUCCESS;
+	}
+
+	// Prints a syntax error unless tokens[i] is of the given type
+	muResult muVGC_expect_token(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* og, size_m i, muVGCTokenType type, const char* message) {
+
+		if (i < token_len && tokens[i].type == type) {
+			return MU_SUCCESS;
+		}
+		muVGC_print_syntax_error(og, tokens[(i >= token_len) ? token_len-1 : i].index);
+		mu_print(message);
+		*result = MU_FAILURE;
+		return MU_FAILURE;
+	}
+
+	// Reads a signed integer comparison (< <= > >= == !=) at tokens[*i]
+	muResult muVGC_get_comparison(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* og, size_m* i, uint16_m* comparison) {
+
+		if (*i+1 >= token_len) {
+			muVGC_print_syntax_error(og, tokens[token_len-1].index);
+			mu_print("expected comparison\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		muBool equals = (tokens[*i+1].type == MUVGC_TOKEN_EQUALS) ? MU_TRUE : MU_FALSE;
+		if (tokens[*i].type == MUVGC_TOKEN_LESS_THAN_ANGLED_BRACKET) {
+			*comparison = (equals == MU_TRUE) ? MUVGC_OP_S_LESS_THAN_EQUAL : MUVGC_OP_S_LESS_THAN;
+		} else if (tokens[*i].type == MUVGC_TOKEN_GREATER_THAN_ANGLED_BRACKET) {
+			*comparison = (equals == MU_TRUE) ? MUVGC_OP_S_GREATER_THAN_EQUAL : MUVGC_OP_S_GREATER_THAN;
+		} else if (tokens[*i].type == MUVGC_TOKEN_EQUALS && equals == MU_TRUE) {
+			*comparison = MUVGC_OP_I_EQUAL;
+		} else if (tokens[*i].type == MUVGC_TOKEN_EXCLAMATION_POINT && equals == MU_TRUE) {
+			*comparison = MUVGC_OP_I_NOT_EQUAL;
+		} else {
+			muVGC_print_syntax_error(og, tokens[*i].index);
+			mu_print("expected comparison\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		*i += (equals == MU_TRUE) ? 2 : 1;
+		return MU_SUCCESS;
+	}
+
+	// The unsigned version of a comparison from muVGC_get_comparison
+	uint16_m muVGC_get_unsigned_comparison(uint16_m comparison) {
+		switch (comparison) {
+			default: return comparison; break;
+			case MUVGC_OP_S_LESS_THAN: return MUVGC_OP_U_LESS_THAN; break;
+			case MUVGC_OP_S_LESS_THAN_EQUAL: return MUVGC_OP_U_LESS_THAN_EQUAL; break;
+			case MUVGC_OP_S_GREATER_THAN: return MUVGC_OP_U_GREATER_THAN; break;
+			case MUVGC_OP_S_GREATER_THAN_EQUAL: return MUVGC_OP_U_GREATER_THAN_EQUAL; break;
+		}
+	}
+
+	// Is the token the given keyword?
+	muBool muVGC_token_is_keyword(const char* code, muVGCToken token, const char* keyword, size_m keywordlen) {
+		return (token.type == MUVGC_TOKEN_KEYWORD && token.length == keywordlen &&
+			mu_strncmp(muVGC_get_token_value(code, token), keyword, keywordlen) == 0) ? MU_TRUE : MU_FALSE;
+	}
+
+	// A variable, a member of a block or a component of a vector (A.B), or
+	// an element of either of the first two (A[C] or A.B[C], C being an
+	// integer literal or a variable), optionally followed by a component of
+	// a vector (A.B.D or A[C].D or A.B[C].D)
+	struct muVGCReference {
+		muVGCToken name;
+		muBool has_member;
+		muVGCToken member;
+		muBool has_index;
+		muVGCToken index;
+		muBool has_component;
+		muVGCToken component;
+	};
+	typedef struct muVGCReference muVGCReference;
+
+	// Reads a reference at tokens[*i]
+	muResult muVGC_get_reference(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* og, size_m* i, muVGCReference* reference) {
+
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_IDENTIFIER, "expected identifier\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		reference->name = tokens[*i];
+		reference->has_member = MU_FALSE;
+		reference->has_index = MU_FALSE;
+		reference->has_component = MU_FALSE;
+		*i += 1;
+		if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_PERIOD) {
+			*i += 1;
+			if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_IDENTIFIER, "expected member or vector component after '.'\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			reference->has_member = MU_TRUE;
+			reference->member = tokens[*i];
+			*i += 1;
+		}
+		if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_OPEN_SQUARE_BRACKET) {
+			*i += 1;
+			if (*i >= token_len || (tokens[*i].type != MUVGC_TOKEN_INTEGER_CONSTANT && tokens[*i].type != MUVGC_TOKEN_IDENTIFIER)) {
+				muVGC_print_syntax_error(og, tokens[(*i >= token_len) ? token_len-1 : *i].index);
+				mu_print("expected integer literal or variable as index\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			reference->has_index = MU_TRUE;
+			reference->index = tokens[*i];
+			*i += 1;
+			if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_SQUARE_BRACKET, "expected ']'\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			*i += 1;
+		}
+		if ((reference->has_member == MU_TRUE || reference->has_index == MU_TRUE) && *i < token_len && tokens[*i].type == MUVGC_TOKEN_PERIOD) {
+			*i += 1;
+			if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_IDENTIFIER, "expected vector component after '.'\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			reference->has_component = MU_TRUE;
+			reference->component = tokens[*i];
+			*i += 1;
+		}
+		return MU_SUCCESS;
+	}
+
+	// Is the token the given identifier?
+	muBool muVGC_token_is_identifier(const char* code, muVGCToken token, const char* identifier, size_m identifierlen) {
+		return (token.type == MUVGC_TOKEN_IDENTIFIER && token.length == identifierlen &&
+			mu_strncmp(muVGC_get_token_value(code, token), identifier, identifierlen) == 0) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Operands
+
+	// A reference or a literal (an integer or float constant, optionally
+	// negated, or true/false), as assignments, constructors and built-in
+	// function calls take them
+
+	struct muVGCAssignmentOperand {
+		// (An identifier, an integer or float constant, or true/false)
+		muVGCToken token;
+		muBool negate;
+		// (For identifiers, whose name is 'token')
+		muVGCReference reference;
+	};
+	typedef struct muVGCAssignmentOperand muVGCAssignmentOperand;
+
+	// Is the token true or false?
+	muBool muVGC_token_is_bool_literal(const char* code, muVGCToken token) {
+		return (muVGC_token_is_keyword(code, token, "true", 4) == MU_TRUE || muVGC_token_is_keyword(code, token, "false", 5) == MU_TRUE) ? MU_TRUE : MU_FALSE;
+	}
+
+	muResult muVGC_get_assignment_operand(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* i, muVGCAssignmentOperand* operand) {
+
+		operand->negate = MU_FALSE;
+		if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_DASH) {
+			operand->negate = MU_TRUE;
+			*i += 1;
+		}
+		if (*i >= token_len || (tokens[*i].type != MUVGC_TOKEN_INTEGER_CONSTANT && tokens[*i].type != MUVGC_TOKEN_FLOAT_CONSTANT &&
+			(operand->negate == MU_TRUE || (tokens[*i].type != MUVGC_TOKEN_IDENTIFIER && muVGC_token_is_bool_literal(code, tokens[*i]) == MU_FALSE)))) {
+			muVGC_print_syntax_error(og, tokens[(*i >= token_len) ? token_len-1 : *i].index);
+			if (operand->negate == MU_TRUE) {
+				mu_print("expected literal after '-'\n");
+			} else {
+				mu_print("expected variable or literal\n");
+			}
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		operand->token = tokens[*i];
+		if (operand->token.type == MUVGC_TOKEN_IDENTIFIER) {
+			return muVGC_get_reference(result, tokens, token_len, og, i, &operand->reference);
+		}
+		*i += 1;
+		return MU_SUCCESS;
+	}
+
+	// Built-in function calls
+
+	// F(A, B), where F is a subgroup function and its arguments are
+	// operands (the other built-in functions taking expressions instead;
+	// see muVGC_load_math_call and muVGC_load_atomic_call)
+
+	#define MUVGC_MAX_CALL_ARGUMENTS 2
+
+	struct muVGCCall {
+		muVGCToken name;
+		muVGCAssignmentOperand arguments[MUVGC_MAX_CALL_ARGUMENTS];
+		size_m argument_len;
+	};
+	typedef struct muVGCCall muVGCCall;
+
+	// Is there a call at tokens[i]?
+	muBool muVGC_is_call(muVGCToken* tokens, size_m token_len, size_m i) {
+		return (i+1 < token_len && tokens[i].type == MUVGC_TOKEN_IDENTIFIER && tokens[i+1].type == MUVGC_TOKEN_OPEN_PARENTHESIS) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Reads a call at tokens[*i]
+	muResult muVGC_get_call(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* i, muVGCCall* call) {
+
+		call->name = tokens[*i];
+		call->argument_len = 0;
+		*i += 2;
+		if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+			*i += 1;
+			return MU_SUCCESS;
+		}
+		while (MU_TRUE) {
+			if (call->argument_len == MUVGC_MAX_CALL_ARGUMENTS) {
+				muVGC_print_syntax_error(og, tokens[(*i >= token_len) ? token_len-1 : *i].index);
+				mu_print("too many arguments\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			if (muVGC_get_assignment_operand(result, tokens, token_len, code, og, i, &call->arguments[call->argument_len]) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			call->argument_len += 1;
+			if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_COMMA) {
+				*i += 1;
+				continue;
+			}
+			break;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*i += 1;
+		return MU_SUCCESS;
+	}
+
+	// For loops
+
+	// Only counted loops are supported for now:
+	// for (p int A = B; A < C; A++) {, where p is an optional precision
+	// qualifier, B is an integer literal, C is an integer literal or an int
+	// constant (a specialized one keeping the loop from being unrolled),
+	// the comparison is any of < <= > >= == != and the update is one of
+	// A++, A--, ++A, --A, A += D or A -= D
+
+	struct muVGCForLoop {
+		muVGCToken name;
+		muVGCPrecision precision;
+		uint32_m init;
+		// (The comparison opcode)
+		uint16_m comparison;
+		// (An identifier if the bound is a constant)
+		muVGCToken bound_token;
+		uint32_m bound;
+		uint32_m step;
+	};
+	typedef struct muVGCForLoop muVGCForLoop;
+
+	// Returns MU_FAILURE if the tokens aren't a for loop, also setting
+	// 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_for_loop(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og,
+		muVGCForLoop* loop, size_m* length) {
+
+		if (token_len < 2 || muVGC_token_is_keyword(code, tokens[0], "for", 3) == MU_FALSE) {
+			return MU_FAILURE;
+		}
+		size_m i = 1;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_OPEN_PARENTHESIS, "expected '(' after 'for'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+
+		// (p) int A = B;
+		loop->precision = (i < token_len) ? muVGC_get_precision_qualifier(tokens[i]) : MUVGC_PRECISION_NONE;
+		if (loop->precision != MUVGC_PRECISION_NONE) {
+			i++;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_KEYWORD, "expected loop variable declaration\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		if (tokens[i].length != 3 || mu_strncmp(muVGC_get_token_value(code, tokens[i]), "int", 3) != 0) {
+			muVGC_print_syntax_error(og, tokens[i].index);
+			mu_print("only int loop variables are supported\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		i++;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_IDENTIFIER, "expected identifier\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		loop->name = tokens[i];
+		i++;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_EQUALS, "expected '='\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+		if (muVGC_get_integer_literal(result, tokens, token_len, code, og, &i, &loop->init) != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected ';'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+
+		// A < C;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_IDENTIFIER, "expected identifier\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+		if (muVGC_get_comparison(result, tokens, token_len, og, &i, &loop->comparison) != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		loop->bound_token = tokens[(i >= token_len) ? token_len-1 : i];
+		if (loop->bound_token.type == MUVGC_TOKEN_IDENTIFIER) {
+			i++;
+		} else if (muVGC_get_integer_literal(result, tokens, token_len, code, og, &i, &loop->bound) != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected ';'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+
+		// A++) {
+		if (i+2 < token_len && (tokens[i].type == MUVGC_TOKEN_PLUS || tokens[i].type == MUVGC_TOKEN_DASH) &&
+			tokens[i+1].type == tokens[i].type && tokens[i+2].type == MUVGC_TOKEN_IDENTIFIER) {
+			// (++A, --A)
+			loop->step = (tokens[i].type == MUVGC_TOKEN_PLUS) ? 1 : (uint32_m)-1;
+			i += 3;
+		} else {
+			if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_IDENTIFIER, "expected identifier\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			i++;
+			if (i+1 >= token_len || (tokens[i].type != MUVGC_TOKEN_PLUS && tokens[i].type != MUVGC_TOKEN_DASH)) {
+				muVGC_print_syntax_error(og, tokens[(i >= token_len) ? token_len-1 : i].index);
+				mu_print("expected loop variable update\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			muBool increment = (tokens[i].type == MUVGC_TOKEN_PLUS) ? MU_TRUE : MU_FALSE;
+			if (tokens[i+1].type == tokens[i].type) {
+				// (A++, A--)
+				loop->step = (increment == MU_TRUE) ? 1 : (uint32_m)-1;
+				i += 2;
+			} else {
+				// (A += D, A -= D)
+				if (muVGC_expect_token(result, tokens, token_len, og, i+1, MUVGC_TOKEN_EQUALS, "expected loop variable update\n") != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+				i += 2;
+				if (muVGC_get_integer_literal(result, tokens, token_len, code, og, &i, &loop->step) != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+				if (increment == MU_FALSE) {
+					loop->step = (~loop->step) + 1;
+				}
+			}
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_OPEN_BRACE, "expected '{' after for loop\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+
+		*length = i;
+		return MU_SUCCESS;
+	}
+
+	// If statements
+
+	// Only simple conditions are supported for now:
+	// if (true) {, if (false) {, if (A) {, where A is a boolean constant or
+	// a call of a built-in function returning a bool (as in
+	// subgroupElect()), or if (A < B) {, where A and B are integer literals
+	// or constants, variables of enclosing for loops, scalar inputs,
+	// built-ins or block members (or a component of a vector one, as in
+	// gl_GlobalInvocationID.x) or calls returning an integer scalar, and
+	// the comparison is any of < <= > >= == !=. An else has to directly
+	// follow the closing brace, as in } else {
+
+	struct muVGCConditionOperand {
+		muBool is_variable;
+		muVGCReference reference;
+		uint32_m value;
+		// (A call counts as a variable)
+		muBool is_call;
+		muVGCCall call;
+	};
+	typedef struct muVGCConditionOperand muVGCConditionOperand;
+
+	struct muVGCIfStatement {
+		// (if (true)/if (false))
+		muBool is_constant;
+		muBool value;
+		// (if (A), with 'a' naming A)
+		muBool is_boolean;
+		// (if (A < B))
+		muVGCConditionOperand a;
+		uint16_m comparison;
+		muVGCConditionOperand b;
+	};
+	typedef struct muVGCIfStatement muVGCIfStatement;
+
+	muResult muVGC_get_condition_operand(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* i, muVGCConditionOperand* operand) {
+
+		operand->is_call = muVGC_is_call(tokens, token_len, *i);
+		if (operand->is_call == MU_TRUE) {
+			operand->is_variable = MU_TRUE;
+			return muVGC_get_call(result, tokens, token_len, code, og, i, &operand->call);
+		}
+		if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_IDENTIFIER) {
+			operand->is_variable = MU_TRUE;
+			return muVGC_get_reference(result, tokens, token_len, og, i, &operand->reference);
+		}
+		operand->is_variable = MU_FALSE;
+		return muVGC_get_integer_literal(result, tokens, token_len, code, og, i, &operand->value);
+	}
+
+	// Returns MU_FAILURE if the tokens aren't an if statement, also setting
+	// 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_if_statement(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og,
+		muVGCIfStatement* statement, size_m* length) {
+
+		if (token_len < 2 || muVGC_token_is_keyword(code, tokens[0], "if", 2) == MU_FALSE) {
+			return MU_FAILURE;
+		}
+		size_m i = 1;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_OPEN_PARENTHESIS, "expected '(' after 'if'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+
+		if (i < token_len && (muVGC_token_is_keyword(code, tokens[i], "true", 4) == MU_TRUE || muVGC_token_is_keyword(code, tokens[i], "false", 5) == MU_TRUE)) {
+			statement->is_constant = MU_TRUE;
+			statement->is_boolean = MU_FALSE;
+			statement->value = (tokens[i].length == 4) ? MU_TRUE : MU_FALSE;
+			i++;
+		} else if (i+1 < token_len && tokens[i].type == MUVGC_TOKEN_IDENTIFIER && tokens[i+1].type == MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+			statement->is_constant = MU_FALSE;
+			statement->is_boolean = MU_TRUE;
+			statement->a.is_variable = MU_TRUE;
+			statement->a.is_call = MU_FALSE;
+			if (muVGC_get_reference(result, tokens, token_len, og, &i, &statement->a.reference) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+		} else {
+			statement->is_constant = MU_FALSE;
+			statement->is_boolean = MU_FALSE;
+			if (muVGC_get_condition_operand(result, tokens, token_len, code, og, &i, &statement->a) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			// (A call on its own, as in if (subgroupElect()))
+			if (statement->a.is_call == MU_TRUE && i < token_len && tokens[i].type == MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+				statement->is_boolean = MU_TRUE;
+			} else {
+				if (muVGC_get_comparison(result, tokens, token_len, og, &i, &statement->comparison) != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+				if (muVGC_get_condition_operand(result, tokens, token_len, code, og, &i, &statement->b) != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+			}
+		}
+
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_OPEN_BRACE, "expected '{' after if statement\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+
+		*length = i;
+		return MU_SUCCESS;
+	}
+
+	// Input layouts
+
+	// Only the local size of compute shaders is supported for now:
+	// layout(A = B, ...) in;, where each A is one of local_size_x/y/z or
+	// local_size_x/y/z_id and B is an integer constant. Other layouts
+	// aren't statements of their own.
+
+	const char* muVGC_global_local_size_qualifiers[] = {
+		"local_size_x", "local_size_y", "local_size_z",
+		"local_size_x_id", "local_size_y_id", "local_size_z_id"
+	};
+
+	// Returns MU_FAILURE if the tokens aren't an input layout, also setting
+	// 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_layout_in(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* length) {
+
+		if (token_len < 2 || muVGC_token_is_keyword(code, tokens[0], "layout", 6) == MU_FALSE) {
+			return MU_FAILURE;
+		}
+		size_m close = 1;
+		while (close < token_len && tokens[close].type != MUVGC_TOKEN_CLOSE_PARENTHESIS && tokens[close].type != MUVGC_TOKEN_SEMICOLON) {
+			close++;
+		}
+		if (close+2 >= token_len || tokens[close].type != MUVGC_TOKEN_CLOSE_PARENTHESIS ||
+			muVGC_token_is_keyword(code, tokens[close+1], "in", 2) == MU_FALSE || tokens[close+2].type != MUVGC_TOKEN_SEMICOLON) {
+			return MU_FAILURE;
+		}
+
+		size_m i = 1;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_OPEN_PARENTHESIS, "expected '(' after 'layout'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+		while (MU_TRUE) {
+			if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_IDENTIFIER, "expected layout qualifier\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			i++;
+			if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_EQUALS, "expected '=' after layout qualifier\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			i++;
+			uint32_m value = 0;
+			if (muVGC_get_integer_literal(result, tokens, token_len, code, og, &i, &value) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			if (i < token_len && tokens[i].type == MUVGC_TOKEN_COMMA) {
+				i++;
+				continue;
+			}
+			break;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*length = i+3;
+		return MU_SUCCESS;
+	}
+
+	// Shared variables
+
+	// shared A B; or shared A B[C];, where C is an integer constant
+
+	struct muVGCSharedVariable {
+		muVGCToken type;
+		muVGCToken name;
+		muBool is_array;
+		uint32_m length;
+	};
+	typedef struct muVGCSharedVariable muVGCSharedVariable;
+
+	// Returns MU_FAILURE if the tokens aren't a shared variable declaration,
+	// also setting 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_shared_variable(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og,
+		muVGCSharedVariable* variable, size_m* length) {
+
+		if (token_len < 1 || muVGC_token_is_keyword(code, tokens[0], "shared", 6) == MU_FALSE) {
+			return MU_FAILURE;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, 1, MUVGC_TOKEN_KEYWORD, "expected type after 'shared'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		variable->type = tokens[1];
+		if (muVGC_expect_token(result, tokens, token_len, og, 2, MUVGC_TOKEN_IDENTIFIER, "expected identifier\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		variable->name = tokens[2];
+		size_m i = 3;
+		variable->is_array = MU_FALSE;
+		if (i < token_len && tokens[i].type == MUVGC_TOKEN_OPEN_SQUARE_BRACKET) {
+			i++;
+			variable->is_array = MU_TRUE;
+			if (muVGC_get_integer_literal(result, tokens, token_len, code, og, &i, &variable->length) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_CLOSE_SQUARE_BRACKET, "expected ']'\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			i++;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected semicolon after shared variable declaration\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*length = i+1;
+		return MU_SUCCESS;
+	}
+
+	// Interface variables
+
+	// Q in p A B; or Q out p A B;, where p is an optional precision
+	// qualifier and Q is any of layout(location = C, component = D) (either
+	// one being optional), flat, noperspective and smooth. Inputs & outputs
+	// declared without a location get one once every statement has been
+	// executed, in the order they were declared; the outputs of vertex
+	// shaders and inputs of fragment shaders get packed into the free
+	// components of the lowest locations they fit in, so two stages
+	// declaring the same varyings in the same order agree on where each
+	// one is.
+
+	struct muVGCInterfaceDeclaration {
+		// MUVGC_STORAGE_CLASS_INPUT or MUVGC_STORAGE_CLASS_OUTPUT
+		uint32_m storage_class;
+		// Location & component given by the layout (+1, 0 meaning none)
+		uint32_m location;
+		uint32_m component;
+		// MUVGC_DECORATION_FLAT/NO_PERSPECTIVE (0 for smooth), if there's an
+		// interpolation qualifier
+		muBool has_interpolation;
+		uint32_m interpolation;
+		muVGCPrecision precision;
+		muVGCToken type;
+		muVGCToken name;
+	};
+	typedef struct muVGCInterfaceDeclaration muVGCInterfaceDeclaration;
+
+	// Reads layout(location = C, component = D) at tokens[*i]
+	muResult muVGC_get_interface_layout(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* i,
+		muVGCInterfaceDeclaration* declaration) {
+
+		*i += 1;
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_OPEN_PARENTHESIS, "expected '(' after 'layout'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*i += 1;
+		while (MU_TRUE) {
+			if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_IDENTIFIER, "expected layout qualifier\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			muVGCToken qualifier = tokens[*i];
+			uint32_m* value = MU_NULL_PTR;
+			if (qualifier.length == 8 && mu_strncmp(muVGC_get_token_value(code, qualifier), "location", 8) == 0) {
+				value = &declaration->location;
+			} else if (qualifier.length == 9 && mu_strncmp(muVGC_get_token_value(code, qualifier), "component", 9) == 0) {
+				value = &declaration->component;
+			} else {
+				muVGC_print_syntax_error(og, qualifier.index);
+				mu_print("unrecognized layout qualifier\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			*i += 1;
+			if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_EQUALS, "expected '=' after layout qualifier\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			*i += 1;
+			if (muVGC_get_integer_literal(result, tokens, token_len, code, og, i, value) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			if (*value > 0x7FFFFFFF) {
+				muVGC_print_syntax_error(og, qualifier.index);
+				mu_print("layout qualifier value can't be negative\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			*value += 1;
+			if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_COMMA) {
+				*i += 1;
+				continue;
+			}
+			break;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*i += 1;
+		return MU_SUCCESS;
+	}
+
+	// Returns MU_FAILURE if the tokens aren't an input/output declaration,
+	// also setting 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_interface_declaration(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og,
+		muVGCInterfaceDeclaration* declaration, size_m* length) {
+
+		if (token_len < 1 || (
+			muVGC_token_is_keyword(code, tokens[0], "layout", 6) == MU_FALSE && muVGC_token_is_keyword(code, tokens[0], "in", 2) == MU_FALSE &&
+			muVGC_token_is_keyword(code, tokens[0], "out", 3) == MU_FALSE && muVGC_token_is_keyword(code, tokens[0], "flat", 4) == MU_FALSE &&
+			muVGC_token_is_keyword(code, tokens[0], "noperspective", 13) == MU_FALSE && muVGC_token_is_keyword(code, tokens[0], "smooth", 6) == MU_FALSE)) {
+			return MU_FAILURE;
+		}
+		// (Constants and blocks can have layouts too)
+		for (size_m c = 0; c < token_len && tokens[c].type != MUVGC_TOKEN_SEMICOLON; c++) {
+			if (muVGC_token_is_keyword(code, tokens[c], "const", 5) == MU_TRUE ||
+				muVGC_token_is_keyword(code, tokens[c], "uniform", 7) == MU_TRUE || muVGC_token_is_keyword(code, tokens[c], "buffer", 6) == MU_TRUE) {
+				return MU_FAILURE;
+			}
+		}
+
+		declaration->storage_class = 0;
+		declaration->location = 0;
+		declaration->component = 0;
+		declaration->has_interpolation = MU_FALSE;
+		declaration->interpolation = 0;
+		declaration->precision = MUVGC_PRECISION_NONE;
+
+		// Qualifiers
+		size_m i = 0;
+		while (i < token_len) {
+			muVGCToken token = tokens[i];
+			if (muVGC_token_is_keyword(code, token, "layout", 6) == MU_TRUE) {
+				if (muVGC_get_interface_layout(result, tokens, token_len, code, og, &i, declaration) != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+				continue;
+			}
+
+			uint32_m storage_class = 0, interpolation = 0;
+			muBool is_interpolation = MU_FALSE;
+			if (muVGC_token_is_keyword(code, token, "in", 2) == MU_TRUE) {
+				storage_class = MUVGC_STORAGE_CLASS_INPUT;
+			} else if (muVGC_token_is_keyword(code, token, "out", 3) == MU_TRUE) {
+				storage_class = MUVGC_STORAGE_CLASS_OUTPUT;
+			} else if (muVGC_token_is_keyword(code, token, "flat", 4) == MU_TRUE) {
+				is_interpolation = MU_TRUE;
+				interpolation = MUVGC_DECORATION_FLAT;
+			} else if (muVGC_token_is_keyword(code, token, "noperspective", 13) == MU_TRUE) {
+				is_interpolation = MU_TRUE;
+				interpolation = MUVGC_DECORATION_NO_PERSPECTIVE;
+			} else if (muVGC_token_is_keyword(code, token, "smooth", 6) == MU_TRUE) {
+				is_interpolation = MU_TRUE;
+			} else if (muVGC_get_precision_qualifier(token) != MUVGC_PRECISION_NONE) {
+				if (declaration->precision != MUVGC_PRECISION_NONE) {
+					muVGC_print_syntax_error(og, token.index);
+					mu_print("multiple precision qualifiers\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+				declaration->precision = muVGC_get_precision_qualifier(token);
+				i++;
+				continue;
+			} else {
+				break;
+			}
+
+			if (storage_class != 0) {
+				if (declaration->storage_class != 0) {
+					muVGC_print_syntax_error(og, token.index);
+					mu_print("multiple storage qualifiers\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+				declaration->storage_class = storage_class;
+			}
+			if (is_interpolation == MU_TRUE) {
+				if (declaration->has_interpolation == MU_TRUE) {
+					muVGC_print_syntax_error(og, token.index);
+					mu_print("multiple interpolation qualifiers\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+				declaration->has_interpolation = MU_TRUE;
+				declaration->interpolation = interpolation;
+			}
+			i++;
+		}
+		if (declaration->storage_class == 0) {
+			muVGC_print_syntax_error(og, tokens[(i >= token_len) ? token_len-1 : i].index);
+			mu_print("expected 'in' or 'out'\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_KEYWORD, "expected type\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		declaration->type = tokens[i];
+		i++;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_IDENTIFIER, "expected identifier\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		declaration->name = tokens[i];
+		i++;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected semicolon after input/output declaration\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*length = i+1;
+		return MU_SUCCESS;
+	}
+
+	// Assignments
+
+	// A = E;, where A is an output (or gl_Position/gl_PointSize in a vertex
+	// shader), a local variable or a member of a buffer block (or an
+	// element of one), and E is an expression (see muVGC_load_expression).
+
+	#define MUVGC_MAX_CONSTRUCTOR_ARGUMENTS 16
+
+	struct muVGCAssignment {
+		muVGCReference target;
+		// (Index of the expression's first token; it's only read as it's
+		// evaluated)
+		size_m expression;
+	};
+	typedef struct muVGCAssignment muVGCAssignment;
+
+	// Finds the semicolon ending the expression at tokens[i], filling in
+	// its index
+	muResult muVGC_find_expression_end(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* og, size_m i, const char* message, size_m* end) {
+
+		size_m depth = 0;
+		for (*end = i; *end < token_len; *end += 1) {
+			muVGCTokenType type = tokens[*end].type;
+			if (type == MUVGC_TOKEN_SEMICOLON && depth == 0 && *end != i) {
+				return MU_SUCCESS;
+			}
+			if (type == MUVGC_TOKEN_OPEN_PARENTHESIS) {
+				depth++;
+			} else if (type == MUVGC_TOKEN_CLOSE_PARENTHESIS && depth > 0) {
+				depth--;
+			} else if (type == MUVGC_TOKEN_CLOSE_PARENTHESIS || type == MUVGC_TOKEN_SEMICOLON ||
+				type == MUVGC_TOKEN_OPEN_BRACE || type == MUVGC_TOKEN_CLOSE_BRACE) {
+				break;
+			}
+		}
+		muVGC_print_syntax_error(og, tokens[(*end >= token_len) ? token_len-1 : *end].index);
+		mu_print(message);
+		*result = MU_FAILURE;
+		return MU_FAILURE;
+	}
+
+	// Returns MU_FAILURE if the tokens aren't an assignment, also setting
+	// 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_assignment(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* og,
+		muVGCAssignment* assignment, size_m* length) {
+
+		if (token_len < 3 || tokens[0].type != MUVGC_TOKEN_IDENTIFIER || (tokens[1].type != MUVGC_TOKEN_EQUALS &&
+			tokens[1].type != MUVGC_TOKEN_PERIOD && tokens[1].type != MUVGC_TOKEN_OPEN_SQUARE_BRACKET) || tokens[2].type == MUVGC_TOKEN_EQUALS) {
+			return MU_FAILURE;
+		}
+		size_m i = 0;
+		if (muVGC_get_reference(result, tokens, token_len, og, &i, &assignment->target) != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		if (i+1 >= token_len || tokens[i].type != MUVGC_TOKEN_EQUALS || tokens[i+1].type == MUVGC_TOKEN_EQUALS) {
+			muVGC_print_syntax_error(og, tokens[(i >= token_len) ? token_len-1 : i].index);
+			mu_print("expected '=' after assignment target\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		i++;
+		assignment->expression = i;
+		if (muVGC_find_expression_end(result, tokens, token_len, og, i, "expected semicolon after assignment\n", &i) != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*length = i+1;
+		return MU_SUCCESS;
+	}
+
+	// Local variables
+
+	// p A B; or p A B = E;, inside of a function, where p is an optional
+	// precision qualifier and E is an expression
+
+	struct muVGCLocalDeclaration {
+		muVGCPrecision precision;
+		muVGCToken type;
+		muBool has_value;
+		// (Read as an assignment to the variable)
+		muVGCAssignment value;
+	};
+	typedef struct muVGCLocalDeclaration muVGCLocalDeclaration;
+
+	// Returns MU_FAILURE if the tokens aren't a local variable declaration,
+	// also setting 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_local_declaration(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og,
+		muVGCLocalDeclaration* declaration, size_m* length) {
+
+		size_m i = 0;
+		declaration->precision = (token_len > 0) ? muVGC_get_precision_qualifier(tokens[0]) : MUVGC_PRECISION_NONE;
+		if (declaration->precision != MUVGC_PRECISION_NONE) {
+			i++;
+		}
+		if (i+2 >= token_len || tokens[i].type != MUVGC_TOKEN_KEYWORD || tokens[i+1].type != MUVGC_TOKEN_IDENTIFIER ||
+			muVGC_get_basic_type(muVGC_get_token_value(code, tokens[i]), tokens[i].length) == MUVGC_TYPE_UNKNOWN) {
+			return MU_FAILURE;
+		}
+		declaration->type = tokens[i];
+		declaration->value.target.name = tokens[i+1];
+		declaration->value.target.has_member = MU_FALSE;
+		declaration->value.target.has_index = MU_FALSE;
+		declaration->value.target.has_component = MU_FALSE;
+		i += 2;
+
+		declaration->has_value = (tokens[i].type == MUVGC_TOKEN_EQUALS) ? MU_TRUE : MU_FALSE;
+		if (declaration->has_value == MU_TRUE) {
+			i++;
+			declaration->value.expression = i;
+			if (muVGC_find_expression_end(result, tokens, token_len, og, i, "expected semicolon after variable declaration\n", &i) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+		} else if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected semicolon after variable declaration\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*length = i+1;
+		return MU_SUCCESS;
+	}
+
+	// Constants
+
+	// Q const p A B = E;, where Q is an optional layout(constant_id = D), p
+	// is an optional precision qualifier and E is an expression (see
+	// muVGC_load_expression) whose every variable is a constant (or a
+	// component of one) and which calls no functions, computed as the
+	// constant is declared.
+	// A constant with a constant_id is a specialization constant, whose
+	// value is only a default that can be overridden when a pipeline is
+	// created, so it has to be a literal (and its type a 32-bit scalar or
+	// bool). Constants computed from specialization constants are
+	// specialization constants too, which only allow integer & boolean
+	// operations.
+
+	enum muVGCOperator {
+		MUVGC_OPERATOR_NONE=0,
+		MUVGC_OPERATOR_ADD=1,
+		MUVGC_OPERATOR_SUBTRACT=2,
+		MUVGC_OPERATOR_MULTIPLY=3,
+		MUVGC_OPERATOR_DIVIDE=4,
+		MUVGC_OPERATOR_MODULO=5,
+		MUVGC_OPERATOR_BITWISE_AND=6,
+		MUVGC_OPERATOR_BITWISE_OR=7,
+		MUVGC_OPERATOR_BITWISE_XOR=8,
+		MUVGC_OPERATOR_SHIFT_LEFT=9,
+		MUVGC_OPERATOR_SHIFT_RIGHT=10,
+		MUVGC_OPERATOR_LOGICAL_AND=11,
+		MUVGC_OPERATOR_LOGICAL_OR=12,
+		MUVGC_OPERATOR_LOGICAL_XOR=13,
+		MUVGC_OPERATOR_EQUAL=14,
+		MUVGC_OPERATOR_NOT_EQUAL=15,
+		MUVGC_OPERATOR_LESS_THAN=16,
+		MUVGC_OPERATOR_LESS_THAN_EQUAL=17,
+		MUVGC_OPERATOR_GREATER_THAN=18,
+		MUVGC_OPERATOR_GREATER_THAN_EQUAL=19
+	};
+	typedef enum muVGCOperator muVGCOperator;
+
+	struct muVGCOperatorTokens {
+		muVGCTokenType first;
+		// (MUVGC_TOKEN_UNKNOWN for single-token operators)
+		muVGCTokenType second;
+		muVGCOperator operation;
+	};
+	typedef struct muVGCOperatorTokens muVGCOperatorTokens;
+
+	// Reads a binary operator at tokens[*i]; returns MUVGC_OPERATOR_NONE if
+	// there isn't one
+	muVGCOperator muVGC_get_operator(muVGCToken* tokens, size_m token_len, size_m* i) {
+		// (Two-token operators first, so that && isn't read as &)
+		static const muVGCOperatorTokens operators[] = {
+			{ MUVGC_TOKEN_LESS_THAN_ANGLED_BRACKET, MUVGC_TOKEN_LESS_THAN_ANGLED_BRACKET, MUVGC_OPERATOR_SHIFT_LEFT },
+			{ MUVGC_TOKEN_GREATER_THAN_ANGLED_BRACKET, MUVGC_TOKEN_GREATER_THAN_ANGLED_BRACKET, MUVGC_OPERATOR_SHIFT_RIGHT },
+			{ MUVGC_TOKEN_AMPERSAND, MUVGC_TOKEN_AMPERSAND, MUVGC_OPERATOR_LOGICAL_AND },
+			{ MUVGC_TOKEN_VERTICAL_BAR, MUVGC_TOKEN_VERTICAL_BAR, MUVGC_OPERATOR_LOGICAL_OR },
+			{ MUVGC_TOKEN_CARET, MUVGC_TOKEN_CARET, MUVGC_OPERATOR_LOGICAL_XOR },
+			{ MUVGC_TOKEN_EQUALS, MUVGC_TOKEN_EQUALS, MUVGC_OPERATOR_EQUAL },
+			{ MUVGC_TOKEN_EXCLAMATION_POINT, MUVGC_TOKEN_EQUALS, MUVGC_OPERATOR_NOT_EQUAL },
+			{ MUVGC_TOKEN_LESS_THAN_ANGLED_BRACKET, MUVGC_TOKEN_EQUALS, MUVGC_OPERATOR_LESS_THAN_EQUAL },
+			{ MUVGC_TOKEN_GREATER_THAN_ANGLED_BRACKET, MUVGC_TOKEN_EQUALS, MUVGC_OPERATOR_GREATER_THAN_EQUAL },
+			{ MUVGC_TOKEN_PLUS, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_ADD },
+			{ MUVGC_TOKEN_DASH, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_SUBTRACT },
+			{ MUVGC_TOKEN_ASTERIK, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_MULTIPLY },
+			{ MUVGC_TOKEN_SLASH, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_DIVIDE },
+			{ MUVGC_TOKEN_PERCENT, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_MODULO },
+			{ MUVGC_TOKEN_AMPERSAND, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_BITWISE_AND },
+			{ MUVGC_TOKEN_VERTICAL_BAR, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_BITWISE_OR },
+			{ MUVGC_TOKEN_CARET, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_BITWISE_XOR },
+			{ MUVGC_TOKEN_LESS_THAN_ANGLED_BRACKET, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_LESS_THAN },
+			{ MUVGC_TOKEN_GREATER_THAN_ANGLED_BRACKET, MUVGC_TOKEN_UNKNOWN, MUVGC_OPERATOR_GREATER_THAN }
+		};
+		for (size_m o = 0; o < sizeof(operators)/sizeof(operators[0]); o++) {
+			if (*i >= token_len || tokens[*i].type != operators[o].first) continue;
+			if (operators[o].second == MUVGC_TOKEN_UNKNOWN) {
+				*i += 1;
+				return operators[o].operation;
+			}
+			if (*i+1 < token_len && tokens[*i+1].type == operators[o].second) {
+				*i += 2;
+				return operators[o].operation;
+			}
+		}
+		return MUVGC_OPERATOR_NONE;
+	}
+
+	// Does the operator compare its operands (giving a bool)?
+	muBool muVGC_operator_is_comparison(muVGCOperator operation) {
+		return (operation >= MUVGC_OPERATOR_EQUAL) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Returns how tightly an operator binds, as in GLSL (higher binding
+	// tighter), or 0 for MUVGC_OPERATOR_NONE
+	size_m muVGC_get_operator_precedence(muVGCOperator operation) {
+		switch (operation) {
+			default: return 0; break;
+			case MUVGC_OPERATOR_LOGICAL_OR: return 1; break;
+			case MUVGC_OPERATOR_LOGICAL_XOR: return 2; break;
+			case MUVGC_OPERATOR_LOGICAL_AND: return 3; break;
+			case MUVGC_OPERATOR_BITWISE_OR: return 4; break;
+			case MUVGC_OPERATOR_BITWISE_XOR: return 5; break;
+			case MUVGC_OPERATOR_BITWISE_AND: return 6; break;
+			case MUVGC_OPERATOR_EQUAL: case MUVGC_OPERATOR_NOT_EQUAL: return 7; break;
+			case MUVGC_OPERATOR_LESS_THAN: case MUVGC_OPERATOR_LESS_THAN_EQUAL:
+			case MUVGC_OPERATOR_GREATER_THAN: case MUVGC_OPERATOR_GREATER_THAN_EQUAL: return 8; break;
+			case MUVGC_OPERATOR_SHIFT_LEFT: case MUVGC_OPERATOR_SHIFT_RIGHT: return 9; break;
+			case MUVGC_OPERATOR_ADD: case MUVGC_OPERATOR_SUBTRACT: return 10; break;
+			case MUVGC_OPERATOR_MULTIPLY: case MUVGC_OPERATOR_DIVIDE: case MUVGC_OPERATOR_MODULO: return 11; break;
+		}
+	}
+
+	// Returns the opcode of an operator applied to scalars of the given
+	// kind, or 0 if it can't be
+	uint16_m muVGC_get_operator_opcode(muVGCOperator operation, muVGCScalarKind kind) {
+		if (kind == MUVGC_SCALAR_BOOL) {
+			switch (operation) {
+				default: return 0; break;
+				case MUVGC_OPERATOR_LOGICAL_AND: return MUVGC_OP_LOGICAL_AND; break;
+				case MUVGC_OPERATOR_LOGICAL_OR: return MUVGC_OP_LOGICAL_OR; break;
+				case MUVGC_OPERATOR_LOGICAL_XOR: case MUVGC_OPERATOR_NOT_EQUAL: return MUVGC_OP_LOGICAL_NOT_EQUAL; break;
+				case MUVGC_OPERATOR_EQUAL: return MUVGC_OP_LOGICAL_EQUAL; break;
+			}
+		}
+		if (kind == MUVGC_SCALAR_FLOAT) {
+			switch (operation) {
+				default: return 0; break;
+				case MUVGC_OPERATOR_ADD: return MUVGC_OP_F_ADD; break;
+				case MUVGC_OPERATOR_SUBTRACT: return MUVGC_OP_F_SUB; break;
+				case MUVGC_OPERATOR_MULTIPLY: return MUVGC_OP_F_MUL; break;
+				case MUVGC_OPERATOR_DIVIDE: return MUVGC_OP_F_DIV; break;
+				case MUVGC_OPERATOR_EQUAL: return MUVGC_OP_F_ORD_EQUAL; break;
+				case MUVGC_OPERATOR_NOT_EQUAL: return MUVGC_OP_F_UNORD_NOT_EQUAL; break;
+				case MUVGC_OPERATOR_LESS_THAN: return MUVGC_OP_F_ORD_LESS_THAN; break;
+				case MUVGC_OPERATOR_LESS_THAN_EQUAL: return MUVGC_OP_F_ORD_LESS_THAN_EQUAL; break;
+				case MUVGC_OPERATOR_GREATER_THAN: return MUVGC_OP_F_ORD_GREATER_THAN; break;
+				case MUVGC_OPERATOR_GREATER_THAN_EQUAL: return MUVGC_OP_F_ORD_GREATER_THAN_EQUAL; break;
+			}
+		}
+		if (kind != MUVGC_SCALAR_INT && kind != MUVGC_SCALAR_UINT) {
+			return 0;
+		}
+		muBool is_unsigned = (kind == MUVGC_SCALAR_UINT) ? MU_TRUE : MU_FALSE;
+		switch (operation) {
+			default: return 0; break;
+			case MUVGC_OPERATOR_ADD: return MUVGC_OP_I_ADD; break;
+			case MUVGC_OPERATOR_SUBTRACT: return MUVGC_OP_I_SUB; break;
+			case MUVGC_OPERATOR_MULTIPLY: return MUVGC_OP_I_MUL; break;
+			case MUVGC_OPERATOR_DIVIDE: return (is_unsigned == MU_TRUE) ? MUVGC_OP_U_DIV : MUVGC_OP_S_DIV; break;
+			// (GLSL's % is undefined for negative operands, so either works)
+			case MUVGC_OPERATOR_MODULO: return (is_unsigned == MU_TRUE) ? MUVGC_OP_U_MOD : MUVGC_OP_S_REM; break;
+			case MUVGC_OPERATOR_BITWISE_AND: return MUVGC_OP_BITWISE_AND; break;
+			case MUVGC_OPERATOR_BITWISE_OR: return MUVGC_OP_BITWISE_OR; break;
+			case MUVGC_OPERATOR_BITWISE_XOR: return MUVGC_OP_BITWISE_XOR; break;
+			case MUVGC_OPERATOR_SHIFT_LEFT: return MUVGC_OP_SHIFT_LEFT_LOGICAL; break;
+			case MUVGC_OPERATOR_SHIFT_RIGHT: return (is_unsigned == MU_TRUE) ? MUVGC_OP_SHIFT_RIGHT_LOGICAL : MUVGC_OP_SHIFT_RIGHT_ARITHMETIC; break;
+			case MUVGC_OPERATOR_EQUAL: return MUVGC_OP_I_EQUAL; break;
+			case MUVGC_OPERATOR_NOT_EQUAL: return MUVGC_OP_I_NOT_EQUAL; break;
+			case MUVGC_OPERATOR_LESS_THAN: return (is_unsigned == MU_TRUE) ? MUVGC_OP_U_LESS_THAN : MUVGC_OP_S_LESS_THAN; break;
+			case MUVGC_OPERATOR_LESS_THAN_EQUAL: return (is_unsigned == MU_TRUE) ? MUVGC_OP_U_LESS_THAN_EQUAL : MUVGC_OP_S_LESS_THAN_EQUAL; break;
+			case MUVGC_OPERATOR_GREATER_THAN: return (is_unsigned == MU_TRUE) ? MUVGC_OP_U_GREATER_THAN : MUVGC_OP_S_GREATER_THAN; break;
+			case MUVGC_OPERATOR_GREATER_THAN_EQUAL: return (is_unsigned == MU_TRUE) ? MUVGC_OP_U_GREATER_THAN_EQUAL : MUVGC_OP_S_GREATER_THAN_EQUAL; break;
+		}
+	}
+
+	struct muVGCConstantDeclaration {
+		// SpecId given by the layout (+1, 0 meaning it isn't a
+		// specialization constant)
+		uint32_m spec_id;
+		muVGCPrecision precision;
+		muVGCToken type;
+		muVGCToken name;
+		// Token its value's expression starts at
+		size_m expression;
+	};
+	typedef struct muVGCConstantDeclaration muVGCConstantDeclaration;
+
+	// Returns MU_FAILURE if the tokens aren't a constant declaration, also
+	// setting 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_constant_declaration(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og,
+		muVGCConstantDeclaration* declaration, size_m* length) {
+
+		declaration->spec_id = 0;
+		size_m i = 0;
+		if (token_len > 0 && muVGC_token_is_keyword(code, tokens[0], "layout", 6) == MU_TRUE) {
+			// (A layout not followed by const is some other declaration's)
+			size_m close = 1;
+			while (close < token_len && tokens[close].type != MUVGC_TOKEN_CLOSE_PARENTHESIS && tokens[close].type != MUVGC_TOKEN_SEMICOLON) {
+				close++;
+			}
+			if (close+1 >= token_len || tokens[close].type != MUVGC_TOKEN_CLOSE_PARENTHESIS || muVGC_token_is_keyword(code, tokens[close+1], "const", 5) == MU_FALSE) {
+				return MU_FAILURE;
+			}
+
+			i = 1;
+			if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_OPEN_PARENTHESIS, "expected '(' after 'layout'\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			i++;
+			if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_IDENTIFIER, "expected layout qualifier\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			muVGCToken qualifier = tokens[i];
+			if (qualifier.length != 11 || mu_strncmp(muVGC_get_token_value(code, qualifier), "constant_id", 11) != 0) {
+				muVGC_print_syntax_error(og, qualifier.index);
+				mu_print("unrecognized layout qualifier\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			i++;
+			if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_EQUALS, "expected '=' after layout qualifier\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			i++;
+			uint32_m spec_id = 0;
+			if (muVGC_get_integer_literal(result, tokens, token_len, code, og, &i, &spec_id) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			if (spec_id > 0x7FFFFFFF) {
+				muVGC_print_syntax_error(og, qualifier.index);
+				mu_print("layout qualifier value can't be negative\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			declaration->spec_id = spec_id+1;
+			if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			i++;
+		}
+		if (i >= token_len || muVGC_token_is_keyword(code, tokens[i], "const", 5) == MU_FALSE) {
+			return MU_FAILURE;
+		}
+		i++;
+
+		// p A B =
+		declaration->precision = (i < token_len) ? muVGC_get_precision_qualifier(tokens[i]) : MUVGC_PRECISION_NONE;
+		if (declaration->precision != MUVGC_PRECISION_NONE) {
+			i++;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_KEYWORD, "expected type after 'const'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		declaration->type = tokens[i];
+		i++;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_IDENTIFIER, "expected identifier\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		declaration->name = tokens[i];
+		i++;
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_EQUALS, "constants must be initialized\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		i++;
+
+		// E (evaluated along with the statement)
+		declaration->expression = i;
+		if (muVGC_find_expression_end(result, tokens, token_len, og, i, "expected semicolon after constant declaration\n", &i) != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*length = i+1;
+		return MU_SUCCESS;
+	}
+
+	// Interface blocks
+
+	// Q uniform A { M } B; or Q buffer A { M } B;, where B is an optional
+	// instance name (the members of a block without one being referred to
+	// by their own names), Q is any of layout(...) and, for buffers, the
+	// memory qualifiers readonly, writeonly, coherent, volatile and
+	// restrict, which apply to every member. The layout can give a packing
+	// (std140, the default for uniform blocks, std430, the default for
+	// others, or scalar), row_major or column_major, push_constant (making
+	// the uniform block a push constant block) and set = C & binding = D.
+	// Each member of M is q p T E;, q p T E[F]; or, for the last member of a
+	// buffer, q p T E[];, where q is an optional layout(offset = G,
+	// row_major, column_major) (any of the three being optional), p an
+	// optional precision qualifier and F an integer constant. Members
+	// without an offset come right after the previous one, as aligned by
+	// the packing.
+
+	#define MUVGC_MAX_BLOCK_MEMBERS 64
+
+	struct muVGCMemoryQualifier {
+		const char* name;
+		size_m namelen;
+		// (The decoration it gives every member)
+		uint32_m decoration;
+	};
+	typedef struct muVGCMemoryQualifier muVGCMemoryQualifier;
+
+	// (In the order of the bits of muVGCBlockDeclaration::memory_qualifiers)
+	const muVGCMemoryQualifier muVGC_global_memory_qualifiers[] = {
+		{ "readonly", 8, MUVGC_DECORATION_NON_WRITABLE },
+		{ "writeonly", 9, MUVGC_DECORATION_NON_READABLE },
+		{ "coherent", 8, MUVGC_DECORATION_COHERENT },
+		{ "volatile", 8, MUVGC_DECORATION_VOLATILE },
+		{ "restrict", 8, MUVGC_DECORATION_RESTRICT }
+	};
+	#define MUVGC_MEMORY_QUALIFIER_COUNT (sizeof(muVGC_global_memory_qualifiers) / sizeof(muVGCMemoryQualifier))
+	#define MUVGC_MEMORY_READONLY 1
+	#define MUVGC_MEMORY_WRITEONLY 2
+
+	struct muVGCBlockMemberDeclaration {
+		muVGCPrecision precision;
+		muVGCToken type;
+		muVGCToken name;
+		// (0 if it isn't an array, MUVGC_RUNTIME_ARRAY_LENGTH if it has no
+		// length)
+		uint32_m array_length;
+		// (+1, 0 meaning none)
+		uint32_m offset;
+		// MUVGC_DECORATION_ROW_MAJOR/COL_MAJOR, or 0 if none is given
+		uint32_m matrix_layout;
+	};
+	typedef struct muVGCBlockMemberDeclaration muVGCBlockMemberDeclaration;
+
+	struct muVGCBlockDeclaration {
+		// MUVGC_STORAGE_CLASS_UNIFORM, STORAGE_BUFFER or PUSH_CONSTANT
+		uint32_m storage_class;
+		muBool has_rules;
+		muVGCLayoutRules rules;
+		uint32_m matrix_layout;
+		// (+1, 0 meaning none)
+		uint32_m set;
+		uint32_m binding;
+		// (Bit i being muVGC_global_memory_qualifiers[i])
+		uint32_m memory_qualifiers;
+		muVGCToken name;
+		muBool has_instance_name;
+		muVGCToken instance_name;
+		muVGCBlockMemberDeclaration members[MUVGC_MAX_BLOCK_MEMBERS];
+		size_m member_len;
+	};
+	typedef struct muVGCBlockDeclaration muVGCBlockDeclaration;
+
+	// Reads the layout(...) of a block, or of a member if 'member' isn't
+	// MU_NULL_PTR, at tokens[*i]
+	muResult muVGC_get_block_layout(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* i,
+		muVGCBlockDeclaration* declaration, muVGCBlockMemberDeclaration* member) {
+
+		*i += 1;
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_OPEN_PARENTHESIS, "expected '(' after 'layout'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*i += 1;
+		while (MU_TRUE) {
+			if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_IDENTIFIER, "expected layout qualifier\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			muVGCToken qualifier = tokens[*i];
+			uint32_m* matrix_layout = (member != MU_NULL_PTR) ? &member->matrix_layout : &declaration->matrix_layout;
+			uint32_m* value = MU_NULL_PTR;
+			if (muVGC_token_is_identifier(code, qualifier, "row_major", 9) == MU_TRUE) {
+				*matrix_layout = MUVGC_DECORATION_ROW_MAJOR;
+			} else if (muVGC_token_is_identifier(code, qualifier, "column_major", 12) == MU_TRUE) {
+				*matrix_layout = MUVGC_DECORATION_COL_MAJOR;
+			} else if (member != MU_NULL_PTR && muVGC_token_is_identifier(code, qualifier, "offset", 6) == MU_TRUE) {
+				value = &member->offset;
+			} else if (member == MU_NULL_PTR && muVGC_token_is_identifier(code, qualifier, "set", 3) == MU_TRUE) {
+				value = &declaration->set;
+			} else if (member == MU_NULL_PTR && muVGC_token_is_identifier(code, qualifier, "binding", 7) == MU_TRUE) {
+				value = &declaration->binding;
+			} else if (member == MU_NULL_PTR && muVGC_token_is_identifier(code, qualifier, "push_constant", 13) == MU_TRUE) {
+				declaration->storage_class = MUVGC_STORAGE_CLASS_PUSH_CONSTANT;
+			} else if (member == MU_NULL_PTR && (muVGC_token_is_identifier(code, qualifier, "std140", 6) == MU_TRUE ||
+				muVGC_token_is_identifier(code, qualifier, "std430", 6) == MU_TRUE || muVGC_token_is_identifier(code, qualifier, "scalar", 6) == MU_TRUE)) {
+				if (declaration->has_rules == MU_TRUE) {
+					muVGC_print_syntax_error(og, qualifier.index);
+					mu_print("multiple packing layouts\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+				const char* packing = muVGC_get_token_value(code, qualifier);
+				declaration->has_rules = MU_TRUE;
+				declaration->rules = (packing[0] == 's' && packing[1] == 'c') ? MUVGC_LAYOUT_SCALAR : (packing[3] == '1') ? MUVGC_LAYOUT_STD140 : MUVGC_LAYOUT_STD430;
+			} else {
+				muVGC_print_syntax_error(og, qualifier.index);
+				mu_print("unrecognized layout qualifier\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			*i += 1;
+
+			if (value != MU_NULL_PTR) {
+				if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_EQUALS, "expected '=' after layout qualifier\n") != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+				*i += 1;
+				if (muVGC_get_integer_literal(result, tokens, token_len, code, og, i, value) != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+				if (*value > 0x7FFFFFFF) {
+					muVGC_print_syntax_error(og, qualifier.index);
+					mu_print("layout qualifier value can't be negative\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+				*value += 1;
+			}
+			if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_COMMA) {
+				*i += 1;
+				continue;
+			}
+			break;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*i += 1;
+		return MU_SUCCESS;
+	}
+
+	// Returns the index of the memory qualifier the token is, or
+	// MUVGC_MEMORY_QUALIFIER_COUNT if it isn't one
+	size_m muVGC_get_memory_qualifier(const char* code, muVGCToken token) {
+		for (size_m q = 0; q < MUVGC_MEMORY_QUALIFIER_COUNT; q++) {
+			if (muVGC_token_is_keyword(code, token, muVGC_global_memory_qualifiers[q].name, muVGC_global_memory_qualifiers[q].namelen) == MU_TRUE) {
+				return q;
+			}
+		}
+		return MUVGC_MEMORY_QUALIFIER_COUNT;
+	}
+
+	// Reads q p T E; at tokens[*i]
+	muResult muVGC_get_block_member_declaration(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* i,
+		muVGCBlockMemberDeclaration* member) {
+
+		member->precision = MUVGC_PRECISION_NONE;
+		member->array_length = 0;
+		member->offset = 0;
+		member->matrix_layout = 0;
+		if (*i < token_len && muVGC_token_is_keyword(code, tokens[*i], "layout", 6) == MU_TRUE) {
+			if (muVGC_get_block_layout(result, tokens, token_len, code, og, i, MU_NULL_PTR, member) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+		}
+		if (*i < token_len && muVGC_get_precision_qualifier(tokens[*i]) != MUVGC_PRECISION_NONE) {
+			member->precision = muVGC_get_precision_qualifier(tokens[*i]);
+			*i += 1;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_KEYWORD, "expected member type\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		member->type = tokens[*i];
+		*i += 1;
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_IDENTIFIER, "expected identifier\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		member->name = tokens[*i];
+		*i += 1;
+		if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_OPEN_SQUARE_BRACKET) {
+			*i += 1;
+			member->array_length = MUVGC_RUNTIME_ARRAY_LENGTH;
+			if (*i < token_len && tokens[*i].type != MUVGC_TOKEN_CLOSE_SQUARE_BRACKET) {
+				if (muVGC_get_integer_literal(result, tokens, token_len, code, og, i, &member->array_length) != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+				if (member->array_length == 0 || member->array_length > 0x7FFFFFFF) {
+					muVGC_print_syntax_error(og, member->name.index);
+					mu_print("array size must be positive\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+			}
+			if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_SQUARE_BRACKET, "expected ']'\n") != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			*i += 1;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_SEMICOLON, "expected semicolon after block member\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*i += 1;
+		return MU_SUCCESS;
+	}
+
+	// Returns MU_FAILURE if the tokens aren't a block declaration, also
+	// setting 'result' to MU_FAILURE if they're a malformed one
+	muResult muVGC_get_block_declaration(
+		muResult* result, muVGCToken* tokens, size_m token_len, const char* code, const char* og,
+		muVGCBlockDeclaration* declaration, size_m* length) {
+
+		// (Q uniform/buffer A {)
+		if (token_len < 1 || (muVGC_token_is_keyword(code, tokens[0], "layout", 6) == MU_FALSE &&
+			muVGC_token_is_keyword(code, tokens[0], "uniform", 7) == MU_FALSE && muVGC_token_is_keyword(code, tokens[0], "buffer", 6) == MU_FALSE &&
+			muVGC_get_memory_qualifier(code, tokens[0]) == MUVGC_MEMORY_QUALIFIER_COUNT)) {
+			return MU_FAILURE;
+		}
+		muBool has_storage = MU_FALSE;
+		size_m open = 0;
+		while (open < token_len && tokens[open].type != MUVGC_TOKEN_OPEN_BRACE && tokens[open].type != MUVGC_TOKEN_SEMICOLON) {
+			if (muVGC_token_is_keyword(code, tokens[open], "uniform", 7) == MU_TRUE || muVGC_token_is_keyword(code, tokens[open], "buffer", 6) == MU_TRUE) {
+				has_storage = MU_TRUE;
+			}
+			open++;
+		}
+		if (has_storage == MU_FALSE || open >= token_len || tokens[open].type != MUVGC_TOKEN_OPEN_BRACE) {
+			return MU_FAILURE;
+		}
+
+		declaration->storage_class = 0;
+		declaration->has_rules = MU_FALSE;
+		declaration->rules = MUVGC_LAYOUT_STD430;
+		declaration->matrix_layout = 0;
+		declaration->set = 0;
+		declaration->binding = 0;
+		declaration->memory_qualifiers = 0;
+		declaration->has_instance_name = MU_FALSE;
+		declaration->member_len = 0;
+
+		// Qualifiers
+		size_m i = 0;
+		muBool push_constant = MU_FALSE;
+		uint32_m storage_class = 0;
+		while (i < open) {
+			muVGCToken token = tokens[i];
+			size_m memory_qualifier = muVGC_get_memory_qualifier(code, token);
+			if (muVGC_token_is_keyword(code, token, "layout", 6) == MU_TRUE) {
+				if (muVGC_get_block_layout(result, tokens, token_len, code, og, &i, declaration, MU_NULL_PTR) != MU_SUCCESS) {
+					return MU_FAILURE;
+				}
+				if (declaration->storage_class == MUVGC_STORAGE_CLASS_PUSH_CONSTANT) {
+					push_constant = MU_TRUE;
+				}
+				continue;
+			} else if (memory_qualifier != MUVGC_MEMORY_QUALIFIER_COUNT) {
+				declaration->memory_qualifiers |= 1 << memory_qualifier;
+			} else if (muVGC_token_is_keyword(code, token, "uniform", 7) == MU_TRUE || muVGC_token_is_keyword(code, token, "buffer", 6) == MU_TRUE) {
+				if (storage_class != 0) {
+					muVGC_print_syntax_error(og, token.index);
+					mu_print("multiple storage qualifiers\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+				storage_class = (token.length == 7) ? MUVGC_STORAGE_CLASS_UNIFORM : MUVGC_STORAGE_CLASS_STORAGE_BUFFER;
+			} else {
+				break;
+			}
+			i++;
+		}
+		if (i+1 != open || storage_class == 0 || tokens[i].type != MUVGC_TOKEN_IDENTIFIER) {
+			muVGC_print_syntax_error(og, tokens[i].index);
+			mu_print("expected block name before '{'\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		if (push_constant == MU_TRUE && storage_class != MUVGC_STORAGE_CLASS_UNIFORM) {
+			muVGC_print_syntax_error(og, tokens[0].index);
+			mu_print("push constant blocks must be uniform blocks\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		declaration->storage_class = (push_constant == MU_TRUE) ? MUVGC_STORAGE_CLASS_PUSH_CONSTANT : storage_class;
+		if (declaration->has_rules == MU_FALSE) {
+			declaration->rules = (declaration->storage_class == MUVGC_STORAGE_CLASS_UNIFORM) ? MUVGC_LAYOUT_STD140 : MUVGC_LAYOUT_STD430;
+		}
+		declaration->name = tokens[i];
+		i = open+1;
+
+		// Members
+		while (i < token_len && tokens[i].type != MUVGC_TOKEN_CLOSE_BRACE) {
+			if (declaration->member_len == MUVGC_MAX_BLOCK_MEMBERS) {
+				muVGC_print_syntax_error(og, tokens[i].index);
+				mu_print("too many block members\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			}
+			if (muVGC_get_block_member_declaration(result, tokens, token_len, code, og, &i, &declaration->members[declaration->member_len]) != MU_SUCCESS) {
+				return MU_FAILURE;
+			}
+			declaration->member_len += 1;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_CLOSE_BRACE, "expected '}' after block members\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		if (declaration->member_len == 0) {
+			muVGC_print_syntax_error(og, tokens[i].index);
+			mu_print("blocks must have at least one member\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+		i++;
+		if (i < token_len && tokens[i].type == MUVGC_TOKEN_IDENTIFIER) {
+			declaration->has_instance_name = MU_TRUE;
+			declaration->instance_name = tokens[i];
+			i++;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected semicolon after block declaration\n") != MU_SUCCESS) {
+			return MU_FAILURE;
+		}
+		*length = i+1;
+		return MU_SUCCESS;
+	}
+
+	// Statement state
+
+	enum muVGCConstructType {
+		MUVGC_CONSTRUCT_LOOP=0,
+		MUVGC_CONSTRUCT_SELECTION=1
+	};
+	typedef enum muVGCConstructType muVGCConstructType;
+
+	// A construct whose end (a close brace) needs to emit something
+	struct muVGCConstruct {
+		muVGCConstructType type;
+		// Scope count the construct closes back to
+		size_m scope;
+		uint32_m merge_label;
+		// (For loops)
+		muVGCToken name;
+		uint32_m variable;
+		uint32_m step;
+		uint32_m header_label;
+		uint32_m continue_label;
+		// (Whether the loop variable is RelaxedPrecision)
+		muBool relaxed;
+		// (If statements; the branch's false target is patched to the merge
+		// block if there turns out to be no else)
+		size_m branch;
+		uint32_m else_label;
+		muBool has_else;
+	};
+	typedef struct muVGCConstruct muVGCConstruct;
+
+	// A declared input or output
+	struct muVGCInterfaceVariable {
+		muVGCToken name;
+		uint32_m storage_class;
+		uint32_m type;
+		uint32_m id;
+		// (+1, 0 meaning it hasn't been given one yet)
+		uint32_m location;
+		uint32_m component;
+		// MUVGC_DECORATION_FLAT/NO_PERSPECTIVE, or 0 for smooth (which
+		// variables can share a location)
+		uint32_m interpolation;
+		muBool relaxed;
+	};
+	typedef struct muVGCInterfaceVariable muVGCInterfaceVariable;
+
+	// A declared constant
+	struct muVGCNamedConstant {
+		muVGCToken name;
+		uint32_m type;
+		uint32_m id;
+		// (+1, 0 meaning it isn't a specialization constant of its own)
+		uint32_m spec_id;
+	};
+	typedef struct muVGCNamedConstant muVGCNamedConstant;
+
+	// A member of a declared block
+	struct muVGCBlockMember {
+		muVGCToken name;
+		// Its type within the block's struct (for arrays, the laid out
+		// array type)
+		uint32_m type;
+		// (0 if it isn't an array)
+		uint32_m element_type;
+		uint32_m array_length;
+		muBool relaxed;
+	};
+	typedef struct muVGCBlockMember muVGCBlockMember;
+
+	// A declared uniform, storage or push constant block
+	struct muVGCInterfaceBlock {
+		muVGCToken name;
+		muBool has_instance_name;
+		muVGCToken instance_name;
+		uint32_m storage_class;
+		uint32_m memory_qualifiers;
+		uint32_m id;
+		// (Into state->block_members)
+		size_m first_member;
+		size_m member_len;
+	};
+	typedef struct muVGCInterfaceBlock muVGCInterfaceBlock;
+
+	// A declared local variable
+	struct muVGCLocalVariable {
+		muVGCToken name;
+		uint32_m type;
+		uint32_m id;
+		muBool relaxed;
+		// Scope count it was declared at (it goes away once its scope
+		// closes)
+		size_m scope;
+	};
+	typedef struct muVGCLocalVariable muVGCLocalVariable;
+
+	// What executing one statement leaves behind for the next ones
+	struct muVGCStatementState {
+		size_m scope_count;
+		// Function (and block within it) being implemented, if scope_count
+		// is above 0
+		size_m function;
+		size_m block;
+		muVGCBasicType return_type;
+		// Whether the block has already returned (code after a return going
+		// in a block of its own, which nothing branches to)
+		muBool returned;
+		// Whether the expression being evaluated is a constant's
+		// initializer, which is computed as a constant instead of within
+		// the block
+		muBool constant_expression;
+		// Attributes for the next statement
+		uint32_m attributes;
+		// Default precision set by precision statements, by precision type
+		muVGCPrecision default_precisions[3];
+		// Local size of a compute shader (0 meaning undeclared, so 1) and
+		// the SpecIds specializing it (+1, 0 meaning none)
+		uint32_m local_size[3];
+		uint32_m local_size_spec_ids[3];
+		// The gl_WorkGroupSize constant, once it's been declared
+		uint32_m workgroup_size;
+		// The gl_PerVertex block of a vertex shader, once it's been declared
+		uint32_m per_vertex;
+		// Inputs & outputs, in the order they were declared
+		muVGCInterfaceVariable* interface_variables;
+		size_m interface_variable_len;
+		size_m allocated_interface_variable_len;
+		// Constants, in the order they were declared
+		muVGCNamedConstant* constants;
+		size_m constant_len;
+		size_m allocated_constant_len;
+		// Blocks, in the order they were declared, and their members
+		muVGCInterfaceBlock* interface_blocks;
+		size_m interface_block_len;
+		size_m allocated_interface_block_len;
+		muVGCBlockMember* block_members;
+		size_m block_member_len;
+		size_m allocated_block_member_len;
+		// Open constructs, innermost last
+		muVGCConstruct* constructs;
+		size_m construct_len;
+		size_m allocated_construct_len;
+		// Local variables of the scopes that are open, innermost last
+		muVGCLocalVariable* local_variables;
+		size_m local_variable_len;
+		size_m allocated_local_variable_len;
+	};
+	typedef struct muVGCStatementState muVGCStatementState;
+
+	// Whether a value of the given type and precision qualifier (falling back
+	// to the default precision) is RelaxedPrecision
+	muBool muVGC_is_relaxed_precision(muVGCStatementState* state, muVGCPrecision precision, muVGCBasicType type) {
+		if (precision == MUVGC_PRECISION_NONE) {
+			precision = state->default_precisions[muVGC_get_precision_type(type)];
+		}
+		return (precision == MUVGC_PRECISION_LOW || precision == MUVGC_PRECISION_MEDIUM) ? MU_TRUE : MU_FALSE;
+	}
+
+	// Returns the constant with the given name, or MU_NULL_PTR
+	muVGCNamedConstant* muVGC_find_constant(muVGCStatementState* state, const char* code, muVGCToken name) {
+		for (size_m i = 0; i < state->constant_len; i++) {
+			muVGCNamedConstant* constant = &state->constants[i];
+			if (constant->name.length == name.length &&
+				mu_strncmp(muVGC_get_token_value(code, constant->name), muVGC_get_token_value(code, name), name.length) == 0) {
+				return constant;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Returns the innermost local variable with the given name, or
+	// MU_NULL_PTR
+	muVGCLocalVariable* muVGC_find_local_variable(muVGCStatementState* state, const char* code, muVGCToken name) {
+		for (size_m i = state->local_variable_len; i > 0; i--) {
+			muVGCLocalVariable* variable = &state->local_variables[i-1];
+			if (variable->name.length == name.length &&
+				mu_strncmp(muVGC_get_token_value(code, variable->name), muVGC_get_token_value(code, name), name.length) == 0) {
+				return variable;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Forgets the local variables declared in scopes above the given scope
+	// count
+	void muVGC_close_local_variables(muVGCStatementState* state, size_m scope) {
+		while (state->local_variable_len > 0 && state->local_variables[state->local_variable_len-1].scope > scope) {
+			state->local_variable_len -= 1;
+		}
+	}
+
+	// Is the id a specialization constant (or computed from one)?
+	muBool muVGC_is_spec_constant(muVGCModule* module, uint32_m id) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, id);
+		if (inst == MU_NULL_PTR) {
+			return MU_FALSE;
+		}
+		switch (inst->opcode) {
+			default: return MU_FALSE; break;
+			case MUVGC_OP_SPEC_CONSTANT_TRUE: case MUVGC_OP_SPEC_CONSTANT_FALSE: case MUVGC_OP_SPEC_CONSTANT:
+			case MUVGC_OP_SPEC_CONSTANT_COMPOSITE: case MUVGC_OP_SPEC_CONSTANT_OP: return MU_TRUE; break;
+		}
+	}
+
+	// Is the id a constant (specialized or not)?
+	muBool muVGC_is_constant(muVGCModule* module, uint32_m id) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, id);
+		if (inst == MU_NULL_PTR) {
+			return MU_FALSE;
+		}
+		switch (inst->opcode) {
+			default: return muVGC_is_spec_constant(module, id); break;
+			case MUVGC_OP_CONSTANT_TRUE: case MUVGC_OP_CONSTANT_FALSE: case MUVGC_OP_CONSTANT:
+			case MUVGC_OP_CONSTANT_COMPOSITE: case MUVGC_OP_CONSTANT_NULL: return MU_TRUE; break;
+		}
+	}
+
+	// Can OpSpecConstantOp perform the operation in a shader?
+	muBool muVGC_is_spec_constant_opcode(uint16_m opcode) {
+		switch (opcode) {
+			default: return MU_FALSE; break;
+			case MUVGC_OP_S_NEGATE: case MUVGC_OP_NOT: case MUVGC_OP_I_ADD: case MUVGC_OP_I_SUB: case MUVGC_OP_I_MUL:
+			case MUVGC_OP_U_DIV: case MUVGC_OP_S_DIV: case MUVGC_OP_U_MOD: case MUVGC_OP_S_REM: case MUVGC_OP_S_MOD:
+			case MUVGC_OP_SHIFT_RIGHT_LOGICAL: case MUVGC_OP_SHIFT_RIGHT_ARITHMETIC: case MUVGC_OP_SHIFT_LEFT_LOGICAL:
+			case MUVGC_OP_BITWISE_OR: case MUVGC_OP_BITWISE_XOR: case MUVGC_OP_BITWISE_AND:
+			case MUVGC_OP_VECTOR_SHUFFLE: case MUVGC_OP_COMPOSITE_EXTRACT: case MUVGC_OP_COMPOSITE_INSERT:
+			case MUVGC_OP_LOGICAL_OR: case MUVGC_OP_LOGICAL_AND: case MUVGC_OP_LOGICAL_NOT:
+			case MUVGC_OP_LOGICAL_EQUAL: case MUVGC_OP_LOGICAL_NOT_EQUAL: case MUVGC_OP_SELECT:
+			case MUVGC_OP_I_EQUAL: case MUVGC_OP_I_NOT_EQUAL: case MUVGC_OP_U_LESS_THAN: case MUVGC_OP_S_LESS_THAN:
+			case MUVGC_OP_U_GREATER_THAN: case MUVGC_OP_S_GREATER_THAN: case MUVGC_OP_U_LESS_THAN_EQUAL:
+			case MUVGC_OP_S_LESS_THAN_EQUAL: case MUVGC_OP_U_GREATER_THAN_EQUAL: case MUVGC_OP_S_GREATER_THAN_EQUAL: return MU_TRUE; break;
+		}
+	}
+
+	// Computes an operation of a constant expression as a constant of the
+	// given type: if any of its operands is specialized, so is the result;
+	// otherwise, it's folded right away. Returns 0 on failure.
+	uint32_m muVGC_get_constant_result(
+		muResult* result, muVGCModule* module, const char* og, muVGCToken token,
+		uint16_m opcode, uint32_m type, const muVGCOperand* operands, size_m operand_len) {
+
+		size_m columns = 1, rows = 1;
+		muBool specialized = MU_FALSE, is_float = (muVGC_get_type_shape(module, type, &columns, &rows) == MUVGC_SCALAR_FLOAT) ? MU_TRUE : MU_FALSE;
+		for (size_m i = 0; i < operand_len; i++) {
+			if (operands[i].is_id == MU_FALSE) continue;
+			if (muVGC_is_spec_constant(module, operands[i].word) == MU_TRUE) {
+				specialized = MU_TRUE;
+			}
+			uint32_m operand_type = muVGC_module_get_definition(module, operands[i].word)->result_type;
+			if (muVGC_get_type_shape(module, operand_type, &columns, &rows) == MUVGC_SCALAR_FLOAT) {
+				is_float = MU_TRUE;
+			}
+		}
+
+		if (specialized == MU_TRUE) {
+			if (opcode == MUVGC_OP_COMPOSITE_CONSTRUCT) {
+				uint32_m constituents[MUVGC_MAX_CONSTRUCTOR_ARGUMENTS];
+				for (size_m i = 0; i < operand_len; i++) {
+					constituents[i] = operands[i].word;
+				}
+				return muVGC_op_spec_constant_composite(module, type, constituents, operand_len);
+			}
+			// (Signedness is changed by adding 0, OpBitcast not being
+			// allowed)
+			if (opcode == MUVGC_OP_BITCAST && is_float == MU_FALSE) {
+				uint32_m operand_type = muVGC_module_get_definition(module, operands[0].word)->result_type;
+				uint32_m zeros[MUVGC_MAX_CONSTANT_COMPONENTS] = { 0 };
+				muVGCOperand addition[] = { operands[0], MUVGC_ID(muVGC_fold_make_constant(module, operand_type, MUVGC_SCALAR_INT, zeros)) };
+				return muVGC_op_spec_constant_op(module, type, MUVGC_OP_I_ADD, addition, 2);
+			}
+			// (OpSpecConstantOp only allows floating-point operations in
+			// kernels)
+			if (is_float == MU_TRUE || muVGC_is_spec_constant_opcode(opcode) == MU_FALSE) {
+				muVGC_print_syntax_error(og, token.index);
+				if (is_float == MU_TRUE) {
+					mu_print("float specialization constants can't be operated on\n");
+				} else {
+					mu_print("operator can't be used on specialization constants\n");
+				}
+				*result = MU_FAILURE;
+				return 0;
+			}
+			return muVGC_op_spec_constant_op(module, type, opcode, operands, operand_len);
+		}
+
+		// (Folded as an instruction that's never emitted)
+		size_m instruction = muVGC_module_add_instruction(module, opcode, type, 0, operands, operand_len);
+		uint32_m id = muVGC_fold_instruction(module, instruction);
+		muVGC_module_remove_instruction(module, instruction);
+		if (id == 0) {
+			muVGC_print_syntax_error(og, token.index);
+			mu_print("constant expression has an undefined result\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		return id;
+	}
+
+	// Returns the specialization constant with the given SpecId (+1), or
+	// MU_NULL_PTR
+	muVGCNamedConstant* muVGC_find_spec_constant(muVGCStatementState* state, uint32_m spec_id) {
+		for (size_m i = 0; i < state->constant_len; i++) {
+			if (state->constants[i].spec_id == spec_id) {
+				return &state->constants[i];
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Returns the gl_WorkGroupSize constant, declaring it the first time;
+	// if any dimension is specialized, it's a specialization constant
+	// decorated as the WorkgroupSize built-in, which then takes over from
+	// the LocalSize execution mode. A dimension whose SpecId a declared
+	// constant already has uses that constant.
+	uint32_m muVGC_get_workgroup_size(muVGCModule* module, muVGCStatementState* state) {
+		if (state->workgroup_size != 0) {
+			return state->workgroup_size;
+		}
+		uint32_m uint_type = muVGC_get_int_type(module, 32, 0);
+		uint32_m constituents[3];
+		muBool specialized = MU_FALSE;
+		for (size_m d = 0; d < 3; d++) {
+			uint32_m size = (state->local_size[d] != 0) ? state->local_size[d] : 1;
+			muVGCNamedConstant* constant = (state->local_size_spec_ids[d] != 0) ? muVGC_find_spec_constant(state, state->local_size_spec_ids[d]) : MU_NULL_PTR;
+			if (constant != MU_NULL_PTR) {
+				constituents[d] = constant->id;
+				specialized = MU_TRUE;
+			} else if (state->local_size_spec_ids[d] != 0) {
+				constituents[d] = muVGC_op_spec_constant(module, uint_type, size);
+				muVGC_op_decorate_literal(module, constituents[d], MUVGC_DECORATION_SPEC_ID, state->local_size_spec_ids[d]-1);
+				specialized = MU_TRUE;
+			} else {
+				constituents[d] = muVGC_get_scalar_constant(module, uint_type, size);
+			}
+		}
+		uint32_m uvec3_type = muVGC_get_transparent_type(module, MUVGC_TYPE_UVEC3);
+		if (specialized == MU_TRUE) {
+			state->workgroup_size = muVGC_op_spec_constant_composite(module, uvec3_type, constituents, 3);
+			muVGC_op_decorate_literal(module, state->workgroup_size, MUVGC_DECORATION_BUILT_IN, MUVGC_BUILT_IN_WORKGROUP_SIZE);
+		} else {
+			state->workgroup_size = muVGC_get_composite_constant(module, uvec3_type, constituents, 3);
+		}
+		return state->workgroup_size;
+	}
+
+	// Declares the local size of a compute shader once all of its
+	// statements have been executed
+	void muVGC_declare_local_size(muVGCModule* module, muVGCStatementState* state) {
+		size_m mode = muVGC_op_execution_mode(module, module->entry_point, MUVGC_EXECUTION_MODE_LOCAL_SIZE);
+		muBool specialized = MU_FALSE;
+		for (size_m d = 0; d < 3; d++) {
+			muVGCOperand size = MUVGC_LITERAL((state->local_size[d] != 0) ? state->local_size[d] : 1);
+			muVGC_module_add_operand(module, mode, size);
+			module->local_size[d] = size.word;
+			module->local_size_spec_ids[d] = state->local_size_spec_ids[d];
+			if (state->local_size_spec_ids[d] != 0) {
+				specialized = MU_TRUE;
+			}
+		}
+		if (specialized == MU_TRUE) {
+			muVGC_get_workgroup_size(module, state);
+		}
+	}
+
+	// Returns the input/output with the given name, or MU_NULL_PTR
+	muVGCInterfaceVariable* muVGC_find_interface_variable(muVGCStatementState* state, const char* code, muVGCToken name) {
+		for (size_m i = 0; i < state->interface_variable_len; i++) {
+			muVGCInterfaceVariable* variable = &state->interface_variables[i];
+			if (variable->name.length == name.length &&
+				mu_strncmp(muVGC_get_token_value(code, variable->name), muVGC_get_token_value(code, name), name.length) == 0) {
+				return variable;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Returns the block with the given instance name, or MU_NULL_PTR
+	muVGCInterfaceBlock* muVGC_find_interface_block(muVGCStatementState* state, const char* code, muVGCToken name) {
+		for (size_m i = 0; i < state->interface_block_len; i++) {
+			muVGCInterfaceBlock* block = &state->interface_blocks[i];
+			if (block->has_instance_name == MU_TRUE && block->instance_name.length == name.length &&
+				mu_strncmp(muVGC_get_token_value(code, block->instance_name), muVGC_get_token_value(code, name), name.length) == 0) {
+				return block;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Returns the member of a block with the given name, or MU_NULL_PTR
+	muVGCBlockMember* muVGC_find_block_member(muVGCStatementState* state, const char* code, muVGCInterfaceBlock* block, muVGCToken name) {
+		for (size_m i = block->first_member; i < block->first_member + block->member_len; i++) {
+			muVGCBlockMember* member = &state->block_members[i];
+			if (member->name.length == name.length &&
+				mu_strncmp(muVGC_get_token_value(code, member->name), muVGC_get_token_value(code, name), name.length) == 0) {
+				return member;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Returns the member with the given name of a block without an instance
+	// name, filling in the block, or MU_NULL_PTR
+	muVGCBlockMember* muVGC_find_anonymous_block_member(
+		muVGCStatementState* state, const char* code, muVGCToken name, muVGCInterfaceBlock** block) {
+
+		for (size_m i = 0; i < state->interface_block_len; i++) {
+			if (state->interface_blocks[i].has_instance_name == MU_TRUE) continue;
+			muVGCBlockMember* member = muVGC_find_block_member(state, code, &state->interface_blocks[i], name);
+			if (member != MU_NULL_PTR) {
+				*block = &state->interface_blocks[i];
+				return member;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Notes down where an input/output ended up, for reflection
+	void muVGC_reflect_interface_variable(muVGCModule* module, muVGCInterfaceVariable* variable, uint32_m component, muVGCFootprint footprint) {
+		muVGCReflectedVariable reflected = { 0 };
+		reflected.id = variable->id;
+		reflected.storage_class = variable->storage_class;
+		reflected.location.location = variable->location-1;
+		reflected.location.component = component;
+		reflected.location.location_count = footprint.locations;
+		reflected.location.component_count = footprint.components;
+		muVGC_reflect_variable(module, reflected);
+	}
+
+	#define MUVGC_MAX_LOCATIONS 32
+
+	// Marks the components a variable takes up within the locations of one
+	// storage class ('used' being a bitmask of components per location) as
+	// used; returns MU_FALSE if they're taken or can't be shared with what's
+	// already there (variables sharing a location need the same component
+	// type and the same interpolation)
+	muBool muVGC_use_locations(
+		uint32_m* used, uint32_m* kinds, uint32_m* interpolations, uint32_m location, uint32_m component,
+		muVGCFootprint footprint, uint32_m interpolation) {
+
+		uint32_m mask = (((uint32_m)1 << footprint.components) - 1) << component;
+		if (location >= MUVGC_MAX_LOCATIONS || footprint.locations > MUVGC_MAX_LOCATIONS - location) {
+			return MU_FALSE;
+		}
+		for (uint32_m l = location; l < location+footprint.locations; l++) {
+			if ((used[l] & mask) != 0 || (used[l] != 0 && (kinds[l] != footprint.kind || interpolations[l] != interpolation))) {
+				return MU_FALSE;
+			}
+		}
+		for (uint32_m l = location; l < location+footprint.locations; l++) {
+			used[l] |= mask;
+			kinds[l] = footprint.kind;
+			interpolations[l] = interpolation;
+		}
+		return MU_TRUE;
+	}
+
+	// Gives every input & output its location (and component) once all of
+	// them have been declared
+	void muVGC_declare_interface_locations(muResult* result, muVGCModule* module, muVGCStatementState* state, const char* og) {
+		const uint32_m storage_classes[2] = { MUVGC_STORAGE_CLASS_INPUT, MUVGC_STORAGE_CLASS_OUTPUT };
+		for (size_m s = 0; s < 2; s++) {
+			uint32_m used[MUVGC_MAX_LOCATIONS] = { 0 };
+			uint32_m kinds[MUVGC_MAX_LOCATIONS] = { 0 };
+			uint32_m interpolations[MUVGC_MAX_LOCATIONS] = { 0 };
+			// (Vertex inputs are fed by vertex buffers and fragment outputs go
+			// to attachments, so only what passes between stages is packed)
+			muBool pack = ((storage_classes[s] == MUVGC_STORAGE_CLASS_OUTPUT && module->shader == MUVGC_VERTEX) ||
+				(storage_classes[s] == MUVGC_STORAGE_CLASS_INPUT && module->shader == MUVGC_FRAGMENT)) ? MU_TRUE : MU_FALSE;
+
+			// Explicit locations first, since the others fill in around them
+			for (size_m i = 0; i < state->interface_variable_len; i++) {
+				muVGCInterfaceVariable* variable = &state->interface_variables[i];
+				if (variable->storage_class != storage_classes[s] || variable->location == 0) continue;
+
+				muVGCFootprint footprint = muVGC_get_footprint(module, variable->type);
+				uint32_m component = (variable->component != 0) ? variable->component-1 : 0;
+				if (variable->component != 0 && footprint.locations > 1) {
+					muVGC_print_syntax_error(og, variable->name.index);
+					mu_print("component can't be given for types taking up several locations\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (component % footprint.alignment != 0) {
+					muVGC_print_syntax_error(og, variable->name.index);
+					mu_print("64-bit types can only start at component 0 or 2\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (component + footprint.components > 4) {
+					muVGC_print_syntax_error(og, variable->name.index);
+					mu_print("component out of range\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (muVGC_use_locations(used, kinds, interpolations, variable->location-1, component, footprint, variable->interpolation) == MU_FALSE) {
+					muVGC_print_syntax_error(og, variable->name.index);
+					if (variable->location-1 >= MUVGC_MAX_LOCATIONS || footprint.locations > MUVGC_MAX_LOCATIONS - (variable->location-1)) {
+						mu_print("location out of range\n");
+					} else {
+						mu_print("location overlaps another variable's, or one it can't share a location with\n");
+					}
+					*result = MU_FAILURE;
+					return;
+				}
+				muVGC_op_decorate_literal(module, variable->id, MUVGC_DECORATION_LOCATION, variable->location-1);
+				if (component != 0) {
+					muVGC_op_decorate_literal(module, variable->id, MUVGC_DECORATION_COMPONENT, component);
+				}
+				muVGC_reflect_interface_variable(module, variable, component, footprint);
+			}
+
+			// Then the rest, in the order they were declared
+			for (size_m i = 0; i < state->interface_variable_len; i++) {
+				muVGCInterfaceVariable* variable = &state->interface_variables[i];
+				if (variable->storage_class != storage_classes[s] || variable->location != 0) continue;
+
+				muVGCFootprint footprint = muVGC_get_footprint(module, variable->type);
+				uint32_m last_component = (pack == MU_TRUE) ? 4 - footprint.components : 0;
+				for (uint32_m l = 0; l < MUVGC_MAX_LOCATIONS && variable->location == 0; l++) {
+					for (uint32_m c = 0; c <= last_component; c += footprint.alignment) {
+						if (muVGC_use_locations(used, kinds, interpolations, l, c, footprint, variable->interpolation) == MU_TRUE) {
+							variable->location = l+1;
+							variable->component = c+1;
+							break;
+						}
+					}
+				}
+				if (variable->location == 0) {
+					muVGC_print_syntax_error(og, variable->name.index);
+					mu_print("ran out of locations\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				muVGC_op_decorate_literal(module, variable->id, MUVGC_DECORATION_LOCATION, variable->location-1);
+				if (variable->component != 1) {
+					muVGC_op_decorate_literal(module, variable->id, MUVGC_DECORATION_COMPONENT, variable->component-1);
+				}
+				muVGC_reflect_interface_variable(module, variable, variable->component-1, footprint);
+			}
+		}
+	}
+
+	// Returns the gl_PerVertex output block of a vertex shader, declaring it
+	// (and adding it to the entry point's interface) the first time one of
+	// its members is written to
+	uint32_m muVGC_get_per_vertex(muVGCModule* module, muVGCStatementState* state) {
+		if (state->per_vertex != 0) {
+			return state->per_vertex;
+		}
+		uint32_m member_types[MUVGC_PER_VERTEX_MEMBER_COUNT];
+		for (size_m m = 0; m < MUVGC_PER_VERTEX_MEMBER_COUNT; m++) {
+			member_types[m] = muVGC_get_transparent_type(module, muVGC_global_per_vertex_members[m].type);
+		}
+		uint32_m block = muVGC_op_type_struct(module, member_types, MUVGC_PER_VERTEX_MEMBER_COUNT);
+		muVGC_op_name(module, block, (char*)"gl_PerVertex", 12);
+		for (size_m m = 0; m < MUVGC_PER_VERTEX_MEMBER_COUNT; m++) {
+			const muVGCBuiltInVariable* member = &muVGC_global_per_vertex_members[m];
+			muVGC_op_member_name(module, block, (uint32_m)m, member->name, member->namelen);
+			muVGC_op_member_decorate_literal(module, block, (uint32_m)m, MUVGC_DECORATION_BUILT_IN, member->built_in);
+		}
+		muVGC_op_decorate(module, block, MUVGC_DECORATION_BLOCK);
+		state->per_vertex = muVGC_op_global_variable(module, MUVGC_STORAGE_CLASS_OUTPUT, muVGC_get_pointer_type(module, MUVGC_STORAGE_CLASS_OUTPUT, block));
+		muVGC_add_interface_variable(module, state->per_vertex);
+		return state->per_vertex;
+	}
+
+	// Loads an input (or built-in) by name, filling in the type of the
+	// value; returns 0 if there's no input with that name. Constants need
+	// no loading, so they're returned as they are.
+	uint32_m muVGC_load_input(muVGCModule* module, muVGCStatementState* state, const char* code, muVGCToken name, uint32_m* type) {
+		const char* value = muVGC_get_token_value(code, name);
+
+		muVGCNamedConstant* constant = muVGC_find_constant(state, code, name);
+		if (constant != MU_NULL_PTR) {
+			*type = constant->type;
+			return constant->id;
+		}
+
+		muVGCInterfaceVariable* variable = muVGC_find_interface_variable(state, code, name);
+		if (variable != MU_NULL_PTR) {
+			if (variable->storage_class != MUVGC_STORAGE_CLASS_INPUT) {
+				return 0;
+			}
+			*type = variable->type;
+			uint32_m id = muVGC_op_load(module, state->block, variable->type, variable->id);
+			if (variable->relaxed == MU_TRUE) {
+				muVGC_op_decorate(module, id, MUVGC_DECORATION_RELAXED_PRECISION);
+			}
+			return id;
+		}
+
+		if (module->shader == MUVGC_COMPUTE && name.length == 16 && mu_strncmp(value, "gl_WorkGroupSize", 16) == 0) {
+			*type = muVGC_get_transparent_type(module, MUVGC_TYPE_UVEC3);
+			return muVGC_get_workgroup_size(module, state);
+		}
+		const muVGCBuiltInVariable* built_in = muVGC_find_built_in_variable(module, value, name.length);
+		if (built_in == MU_NULL_PTR) {
+			return 0;
+		}
+		*type = muVGC_get_transparent_type(module, built_in->type);
+		return muVGC_op_load(module, state->block, *type, muVGC_get_built_in_variable(module, built_in));
+	}
+
+	// Returns the innermost loop whose variable has the given name, or
+	// MU_NULL_PTR
+	muVGCConstruct* muVGC_find_loop(muVGCStatementState* state, const char* code, muVGCToken name) {
+		for (size_m c = state->construct_len; c > 0; c--) {
+			muVGCConstruct* construct = &state->constructs[c-1];
+			if (construct->type == MUVGC_CONSTRUCT_LOOP && construct->name.length == name.length &&
+				mu_strncmp(muVGC_get_token_value(code, construct->name), muVGC_get_token_value(code, name), name.length) == 0) {
+				return construct;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	uint32_m muVGC_load_loop_variable(muVGCModule* module, muVGCStatementState* state, muVGCConstruct* loop) {
+		uint32_m id = muVGC_op_load(module, state->block, muVGC_get_int_type(module, 32, 1), loop->variable);
+		if (loop->relaxed == MU_TRUE) {
+			muVGC_op_decorate(module, id, MUVGC_DECORATION_RELAXED_PRECISION);
+		}
+		return id;
+	}
+
+	uint32_m muVGC_load_local_variable(muVGCModule* module, muVGCStatementState* state, muVGCLocalVariable* variable) {
+		uint32_m id = muVGC_op_load(module, state->block, variable->type, variable->id);
+		if (variable->relaxed == MU_TRUE) {
+			muVGC_op_decorate(module, id, MUVGC_DECORATION_RELAXED_PRECISION);
+		}
+		return id;
+	}
+
+	// Evaluates an index (an integer literal, or a local or loop variable,
+	// constant, input or built-in), filling in its value if it's a literal
+	// (leaving 'literal' untouched otherwise); returns 0 on failure
+	uint32_m muVGC_load_index(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCToken index, uint32_m* literal) {
+
+		if (index.type == MUVGC_TOKEN_INTEGER_CONSTANT) {
+			*literal = muVGC_get_integer_token_value(code, index);
+			return muVGC_get_scalar_constant(module, muVGC_get_int_type(module, 32, 1), *literal);
+		}
+		muVGCConstruct* loop = muVGC_find_loop(state, code, index);
+		if (loop != MU_NULL_PTR) {
+			return muVGC_load_loop_variable(module, state, loop);
+		}
+		uint32_m type = 0;
+		uint32_m id = 0;
+		muVGCLocalVariable* local = muVGC_find_local_variable(state, code, index);
+		if (local != MU_NULL_PTR) {
+			type = local->type;
+			id = muVGC_load_local_variable(module, state, local);
+		} else {
+			id = muVGC_load_input(module, state, code, index, &type);
+		}
+		if (id == 0) {
+			muVGC_print_syntax_error(og, index.index);
+			mu_print("unknown variable as index\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		size_m columns = 1, rows = 1;
+		muVGCScalarKind kind = muVGC_get_type_shape(module, type, &columns, &rows);
+		if ((kind != MUVGC_SCALAR_INT && kind != MUVGC_SCALAR_UINT) || columns != 1 || rows != 1) {
+			muVGC_print_syntax_error(og, index.index);
+			mu_print("indexes must be integer scalars\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		return id;
+	}
+
+	// Finds the block member a reference refers to, if any: A.B, A being
+	// the instance name of a block, or A, A being a member of a block
+	// without one. 'member' is left as MU_NULL_PTR if the reference isn't
+	// to a block member; returns MU_FALSE on failure.
+	muBool muVGC_resolve_block_member(
+		muResult* result, muVGCStatementState* state, const char* code, const char* og,
+		muVGCReference* reference, muVGCInterfaceBlock** block, muVGCBlockMember** member) {
+
+		*member = MU_NULL_PTR;
+		if (reference->has_member == MU_TRUE) {
+			*block = muVGC_find_interface_block(state, code, reference->name);
+			if (*block != MU_NULL_PTR) {
+				*member = muVGC_find_block_member(state, code, *block, reference->member);
+				if (*member == MU_NULL_PTR) {
+					muVGC_print_syntax_error(og, reference->member.index);
+					mu_print("unknown block member\n");
+					*result = MU_FAILURE;
+					return MU_FALSE;
+				}
+				return MU_TRUE;
+			}
+		}
+		*member = muVGC_find_anonymous_block_member(state, code, reference->name, block);
+		return MU_TRUE;
+	}
+
+	// Returns a pointer to a block member (or to the element of it the
+	// reference indexes), filling in the type it points to; returns 0 on
+	// failure
+	uint32_m muVGC_access_block_member(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCReference* reference, muVGCInterfaceBlock* block, muVGCBlockMember* member, uint32_m* type) {
+
+		uint32_m indexes[2] = { muVGC_get_scalar_constant(module, muVGC_get_int_type(module, 32, 1), (uint32_m)(member - &state->block_members[block->first_member])), 0 };
+		*type = member->type;
+		if (reference->has_index == MU_FALSE) {
+			if (member->element_type != 0) {
+				muVGC_print_syntax_error(og, reference->name.index);
+				mu_print("arrays can only be accessed one element at a time\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			return muVGC_op_access_chain(module, state->block, muVGC_get_pointer_type(module, block->storage_class, *type), block->id, indexes, 1);
+		}
+
+		// (Elements of arrays, columns of matrices & components of vectors)
+		uint32_m length = member->array_length;
+		if (member->element_type != 0) {
+			*type = member->element_type;
+		} else {
+			muVGCInstruction* inst = muVGC_module_get_definition(module, member->type);
+			if (inst->opcode != MUVGC_OP_TYPE_VECTOR && inst->opcode != MUVGC_OP_TYPE_MATRIX) {
+				muVGC_print_syntax_error(og, reference->index.index);
+				mu_print("scalars can't be indexed\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			*type = module->operands[inst->operand_index].word;
+			length = module->operands[inst->operand_index+1].word;
+		}
+		uint32_m literal = 0;
+		indexes[1] = muVGC_load_index(result, module, state, code, og, reference->index, &literal);
+		if (indexes[1] == 0) {
+			return 0;
+		}
+		if (literal >= length) {
+			muVGC_print_syntax_error(og, reference->index.index);
+			mu_print("index out of range\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		return muVGC_op_access_chain(module, state->block, muVGC_get_pointer_type(module, block->storage_class, *type), block->id, indexes, 2);
+	}
+
+	// Loads the value a reference refers to (a local or loop variable, a
+	// block member or anything muVGC_load_input can load, or a component
+	// of any of those), filling in its type; returns 0 on failure
+	uint32_m muVGC_load_reference(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCReference* reference, uint32_m* type) {
+
+		muVGCToken name = reference->name;
+		muVGCLocalVariable* local = muVGC_find_local_variable(state, code, name);
+		muVGCConstruct* loop = (local == MU_NULL_PTR) ? muVGC_find_loop(state, code, name) : MU_NULL_PTR;
+		muVGCInterfaceBlock* block = MU_NULL_PTR;
+		muVGCBlockMember* member = MU_NULL_PTR;
+		if (local == MU_NULL_PTR && loop == MU_NULL_PTR && muVGC_resolve_block_member(result, state, code, og, reference, &block, &member) == MU_FALSE) {
+			return 0;
+		}
+
+		uint32_m value = 0;
+		if (member != MU_NULL_PTR) {
+			if ((block->memory_qualifiers & MUVGC_MEMORY_WRITEONLY) != 0) {
+				muVGC_print_syntax_error(og, name.index);
+				mu_print("members of writeonly blocks can't be read\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			uint32_m pointer = muVGC_access_block_member(result, module, state, code, og, reference, block, member, type);
+			if (pointer == 0) {
+				return 0;
+			}
+			value = muVGC_op_load(module, state->block, *type, pointer);
+			if (member->relaxed == MU_TRUE) {
+				muVGC_op_decorate(module, value, MUVGC_DECORATION_RELAXED_PRECISION);
+			}
+		} else {
+			if (reference->has_index == MU_TRUE) {
+				muVGC_print_syntax_error(og, reference->index.index);
+				mu_print("only block members can be indexed for now\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			if (local != MU_NULL_PTR) {
+				*type = local->type;
+				value = muVGC_load_local_variable(module, state, local);
+			} else if (loop != MU_NULL_PTR) {
+				*type = muVGC_get_int_type(module, 32, 1);
+				value = muVGC_load_loop_variable(module, state, loop);
+			} else {
+				value = muVGC_load_input(module, state, code, name, type);
+				if (value == 0) {
+					muVGC_print_syntax_error(og, name.index);
+					mu_print("unknown variable\n");
+					*result = MU_FAILURE;
+					return 0;
+				}
+			}
+		}
+
+		// Vector components (.x/.y/.z/.w); A.B is a component unless A is
+		// the instance name of a block
+		muBool has_component = reference->has_component;
+		muVGCToken component_token = reference->component;
+		if (reference->has_member == MU_TRUE && (member == MU_NULL_PTR || block->has_instance_name == MU_FALSE)) {
+			if (has_component == MU_TRUE) {
+				muVGC_print_syntax_error(og, component_token.index);
+				mu_print("can't take a component of a scalar\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			has_component = MU_TRUE;
+			component_token = reference->member;
+		}
+		if (has_component == MU_FALSE) {
+			return value;
+		}
+
+		const char* components = "xyzwrgbastpq";
+		uint32_m component = 4;
+		if (component_token.length == 1) {
+			char c = muVGC_get_token_value(code, component_token)[0];
+			for (uint32_m j = 0; j < 12; j++) {
+				if (components[j] == c) {
+					component = j % 4;
+				}
+			}
+		}
+		if (component == 4) {
+			muVGC_print_syntax_error(og, component_token.index);
+			mu_print("expected vector component\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		muVGCInstruction* inst = muVGC_module_get_definition(module, *type);
+		if (inst == MU_NULL_PTR || inst->opcode != MUVGC_OP_TYPE_VECTOR) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("can't take a component of a scalar\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		if (component >= module->operands[inst->operand_index+1].word) {
+			muVGC_print_syntax_error(og, component_token.index);
+			mu_print("vector component out of range\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		*type = module->operands[inst->operand_index].word;
+		if (state->constant_expression == MU_TRUE) {
+			muVGCOperand operands[] = { MUVGC_ID(value), MUVGC_LITERAL(component) };
+			return muVGC_get_constant_result(result, module, og, component_token, MUVGC_OP_COMPOSITE_EXTRACT, *type, operands, 2);
+		}
+		return muVGC_op_composite_extract(module, state->block, *type, value, component);
+	}
+
+	// Finds what an assignment stores to, filling in its pointer & the type
+	// it points to; returns MU_FALSE on failure
+	muBool muVGC_get_assignment_target(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCReference* target, uint32_m* pointer, uint32_m* type) {
+
+		muVGCToken name = target->name;
+		muVGCLocalVariable* local = muVGC_find_local_variable(state, code, name);
+		muVGCInterfaceBlock* block = MU_NULL_PTR;
+		muVGCBlockMember* member = MU_NULL_PTR;
+		if (local == MU_NULL_PTR && muVGC_resolve_block_member(result, state, code, og, target, &block, &member) == MU_FALSE) {
+			return MU_FALSE;
+		}
+		if (member != MU_NULL_PTR && (target->has_member == MU_FALSE || block->has_instance_name == MU_TRUE)) {
+			if (block->storage_class != MUVGC_STORAGE_CLASS_STORAGE_BUFFER) {
+				muVGC_print_syntax_error(og, name.index);
+				mu_print("only members of buffer blocks can be assigned to\n");
+				*result = MU_FAILURE;
+				return MU_FALSE;
+			}
+			if ((block->memory_qualifiers & MUVGC_MEMORY_READONLY) != 0) {
+				muVGC_print_syntax_error(og, name.index);
+				mu_print("members of readonly blocks can't be assigned to\n");
+				*result = MU_FAILURE;
+				return MU_FALSE;
+			}
+			if (target->has_component == MU_TRUE) {
+				muVGC_print_syntax_error(og, target->component.index);
+				mu_print("vector components can't be assigned to for now\n");
+				*result = MU_FAILURE;
+				return MU_FALSE;
+			}
+			*pointer = muVGC_access_block_member(result, module, state, code, og, target, block, member, type);
+			return (*pointer != 0) ? MU_TRUE : MU_FALSE;
+		}
+		if (target->has_member == MU_TRUE || target->has_index == MU_TRUE || target->has_component == MU_TRUE) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("only whole variables and block members can be assigned to for now\n");
+			*result = MU_FAILURE;
+			return MU_FALSE;
+		}
+
+		if (local != MU_NULL_PTR) {
+			*pointer = local->id;
+			*type = local->type;
+			return MU_TRUE;
+		}
+
+		muVGCInterfaceVariable* variable = muVGC_find_interface_variable(state, code, name);
+		if (variable != MU_NULL_PTR) {
+			if (variable->storage_class != MUVGC_STORAGE_CLASS_OUTPUT) {
+				muVGC_print_syntax_error(og, name.index);
+				mu_print("inputs can't be assigned to\n");
+				*result = MU_FAILURE;
+				return MU_FALSE;
+			}
+			*pointer = variable->id;
+			*type = variable->type;
+			return MU_TRUE;
+		}
+
+		if (module->shader == MUVGC_VERTEX) {
+			for (size_m m = 0; m < MUVGC_PER_VERTEX_MEMBER_COUNT; m++) {
+				const muVGCBuiltInVariable* member = &muVGC_global_per_vertex_members[m];
+				if (member->namelen != name.length || mu_strncmp(member->name, muVGC_get_token_value(code, name), name.length) != 0) continue;
+
+				uint32_m per_vertex = muVGC_get_per_vertex(module, state);
+				uint32_m index = muVGC_get_scalar_constant(module, muVGC_get_int_type(module, 32, 1), (uint32_m)m);
+				*type = muVGC_get_transparent_type(module, member->type);
+				*pointer = muVGC_op_access_chain(module, state->block, muVGC_get_pointer_type(module, MUVGC_STORAGE_CLASS_OUTPUT, *type), per_vertex, &index, 1);
+				return MU_TRUE;
+			}
+		}
+
+		muVGC_print_syntax_error(og, name.index);
+		mu_print("unknown variable in assignment\n");
+		*result = MU_FAILURE;
+		return MU_FALSE;
+	}
+
+	// Reads the value of a literal operand as a scalar of the given kind
+	// (booleans being 0 or 1); returns MU_FALSE on failure
+	muBool muVGC_get_literal_word(
+		muResult* result, const char* code, const char* og,
+		muVGCAssignmentOperand* operand, muVGCScalarKind kind, uint32_m* word) {
+
+		if (kind == MUVGC_SCALAR_BOOL || muVGC_token_is_bool_literal(code, operand->token) == MU_TRUE) {
+			if (kind != MUVGC_SCALAR_BOOL || muVGC_token_is_bool_literal(code, operand->token) == MU_FALSE) {
+				muVGC_print_syntax_error(og, operand->token.index);
+				mu_print("booleans and numbers can't be converted to each other\n");
+				*result = MU_FAILURE;
+				return MU_FALSE;
+			}
+			*word = (operand->token.length == 4) ? 1 : 0;
+			return MU_TRUE;
+		}
+
+		if (operand->token.type == MUVGC_TOKEN_FLOAT_CONSTANT) {
+			if (kind != MUVGC_SCALAR_FLOAT) {
+				muVGC_print_syntax_error(og, operand->token.index);
+				mu_print("can't convert a float literal to an integer\n");
+				*result = MU_FAILURE;
+				return MU_FALSE;
+			}
+			float value = muVGC_get_float_token_value(code, operand->token);
+			*word = muVGC_float_to_word((operand->negate == MU_TRUE) ? -value : value);
+		} else {
+			uint32_m value = muVGC_get_integer_token_value(code, operand->token);
+			if (kind == MUVGC_SCALAR_FLOAT) {
+				*word = muVGC_float_to_word((operand->negate == MU_TRUE) ? -(float)value : (float)value);
+			} else {
+				*word = (operand->negate == MU_TRUE) ? (~value)+1 : value;
+			}
+		}
+		return MU_TRUE;
+	}
+
+	// Returns the constant a literal operand stands for, as a scalar of the
+	// given kind & type; returns 0 on failure
+	uint32_m muVGC_get_literal_constant(
+		muResult* result, muVGCModule* module, const char* code, const char* og,
+		muVGCAssignmentOperand* operand, muVGCScalarKind kind, uint32_m type) {
+
+		uint32_m word = 0;
+		if (muVGC_get_literal_word(result, code, og, operand, kind, &word) == MU_FALSE) {
+			return 0;
+		}
+		if (kind == MUVGC_SCALAR_BOOL) {
+			return muVGC_get_bool_constant(module, (word != 0) ? MU_TRUE : MU_FALSE);
+		}
+		return muVGC_get_scalar_constant(module, type, word);
+	}
+
+	// Subgroup functions
+
+	// The GL_KHR_shader_subgroup_* functions with results, each one group
+	// non-uniform instruction of subgroup scope (the quad ones are left out
+	// for now). Every arithmetic function comes as a reduction, an
+	// inclusive & an exclusive scan and a clustered reduction, picking its
+	// instruction by the component type of its value.
+
+	// What a subgroup function takes or returns
+	enum muVGCSubgroupValue {
+		MUVGC_SUBGROUP_VALUE_NONE=0,
+		// (A scalar or vector of any 32-bit or bool type)
+		MUVGC_SUBGROUP_VALUE_ANY,
+		// (The same, without bools)
+		MUVGC_SUBGROUP_VALUE_ARITHMETIC,
+		// (The same, without floats)
+		MUVGC_SUBGROUP_VALUE_BITWISE,
+		MUVGC_SUBGROUP_VALUE_BOOL,
+		MUVGC_SUBGROUP_VALUE_UINT,
+		// (A uint known at compile time)
+		MUVGC_SUBGROUP_VALUE_CONSTANT_UINT,
+		// (A uvec4 with a bit per invocation)
+		MUVGC_SUBGROUP_VALUE_BALLOT,
+		// (Of the same type as the first argument)
+		MUVGC_SUBGROUP_VALUE_SAME
+	};
+	typedef enum muVGCSubgroupValue muVGCSubgroupValue;
+
+	struct muVGCSubgroupFunction {
+		const char* name;
+		size_m namelen;
+		// (The signed integer one for arithmetic; see
+		// muVGC_get_subgroup_opcode)
+		uint16_m opcode;
+		uint32_m capability;
+		uint32_m group_operation;
+		muVGCSubgroupValue arguments[MUVGC_MAX_CALL_ARGUMENTS];
+		muVGCSubgroupValue result;
+	};
+	typedef struct muVGCSubgroupFunction muVGCSubgroupFunction;
+
+	#define MUVGC_SUBGROUP_FUNCTION(name, opcode, capability, group_operation, argument0, argument1, result) { name, sizeof(name)-1, opcode, capability, group_operation, { argument0, argument1 }, result }
+	#define MUVGC_SUBGROUP_ARITHMETIC_FUNCTIONS(name, opcode, value) \
+		MUVGC_SUBGROUP_FUNCTION("subgroup" name, opcode, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_ARITHMETIC, MUVGC_GROUP_OPERATION_REDUCE, value, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_SAME), \
+		MUVGC_SUBGROUP_FUNCTION("subgroupInclusive" name, opcode, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_ARITHMETIC, MUVGC_GROUP_OPERATION_INCLUSIVE_SCAN, value, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_SAME), \
+		MUVGC_SUBGROUP_FUNCTION("subgroupExclusive" name, opcode, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_ARITHMETIC, MUVGC_GROUP_OPERATION_EXCLUSIVE_SCAN, value, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_SAME), \
+		MUVGC_SUBGROUP_FUNCTION("subgroupClustered" name, opcode, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_CLUSTERED, MUVGC_GROUP_OPERATION_CLUSTERED_REDUCE, value, MUVGC_SUBGROUP_VALUE_CONSTANT_UINT, MUVGC_SUBGROUP_VALUE_SAME)
+
+	const muVGCSubgroupFunction muVGC_global_subgroup_functions[] = {
+		// Basic
+		MUVGC_SUBGROUP_FUNCTION("subgroupElect", MUVGC_OP_GROUP_NON_UNIFORM_ELECT, MUVGC_CAPABILITY_GROUP_NON_UNIFORM, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_BOOL),
+		// Vote
+		MUVGC_SUBGROUP_FUNCTION("subgroupAll", MUVGC_OP_GROUP_NON_UNIFORM_ALL, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_VOTE, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_BOOL, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_BOOL),
+		MUVGC_SUBGROUP_FUNCTION("subgroupAny", MUVGC_OP_GROUP_NON_UNIFORM_ANY, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_VOTE, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_BOOL, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_BOOL),
+		MUVGC_SUBGROUP_FUNCTION("subgroupAllEqual", MUVGC_OP_GROUP_NON_UNIFORM_ALL_EQUAL, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_VOTE, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_ANY, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_BOOL),
+		// Ballot
+		MUVGC_SUBGROUP_FUNCTION("subgroupBroadcast", MUVGC_OP_GROUP_NON_UNIFORM_BROADCAST, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_ANY, MUVGC_SUBGROUP_VALUE_CONSTANT_UINT, MUVGC_SUBGROUP_VALUE_SAME),
+		MUVGC_SUBGROUP_FUNCTION("subgroupBroadcastFirst", MUVGC_OP_GROUP_NON_UNIFORM_BROADCAST_FIRST, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_ANY, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_SAME),
+		MUVGC_SUBGROUP_FUNCTION("subgroupBallot", MUVGC_OP_GROUP_NON_UNIFORM_BALLOT, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_BOOL, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_BALLOT),
+		MUVGC_SUBGROUP_FUNCTION("subgroupInverseBallot", MUVGC_OP_GROUP_NON_UNIFORM_INVERSE_BALLOT, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_BALLOT, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_BOOL),
+		MUVGC_SUBGROUP_FUNCTION("subgroupBallotBitExtract", MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_BIT_EXTRACT, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_BALLOT, MUVGC_SUBGROUP_VALUE_UINT, MUVGC_SUBGROUP_VALUE_BOOL),
+		MUVGC_SUBGROUP_FUNCTION("subgroupBallotBitCount", MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_BIT_COUNT, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_GROUP_OPERATION_REDUCE, MUVGC_SUBGROUP_VALUE_BALLOT, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_UINT),
+		MUVGC_SUBGROUP_FUNCTION("subgroupBallotInclusiveBitCount", MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_BIT_COUNT, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_GROUP_OPERATION_INCLUSIVE_SCAN, MUVGC_SUBGROUP_VALUE_BALLOT, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_UINT),
+		MUVGC_SUBGROUP_FUNCTION("subgroupBallotExclusiveBitCount", MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_BIT_COUNT, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_GROUP_OPERATION_EXCLUSIVE_SCAN, MUVGC_SUBGROUP_VALUE_BALLOT, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_UINT),
+		MUVGC_SUBGROUP_FUNCTION("subgroupBallotFindLSB", MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_FIND_LSB, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_BALLOT, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_UINT),
+		MUVGC_SUBGROUP_FUNCTION("subgroupBallotFindMSB", MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_FIND_MSB, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_BALLOT, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_BALLOT, MUVGC_SUBGROUP_VALUE_NONE, MUVGC_SUBGROUP_VALUE_UINT),
+		// Shuffle
+		MUVGC_SUBGROUP_FUNCTION("subgroupShuffle", MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_SHUFFLE, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_ANY, MUVGC_SUBGROUP_VALUE_UINT, MUVGC_SUBGROUP_VALUE_SAME),
+		MUVGC_SUBGROUP_FUNCTION("subgroupShuffleXor", MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_XOR, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_SHUFFLE, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_ANY, MUVGC_SUBGROUP_VALUE_UINT, MUVGC_SUBGROUP_VALUE_SAME),
+		MUVGC_SUBGROUP_FUNCTION("subgroupShuffleUp", MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_UP, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_SHUFFLE_RELATIVE, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_ANY, MUVGC_SUBGROUP_VALUE_UINT, MUVGC_SUBGROUP_VALUE_SAME),
+		MUVGC_SUBGROUP_FUNCTION("subgroupShuffleDown", MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_DOWN, MUVGC_CAPABILITY_GROUP_NON_UNIFORM_SHUFFLE_RELATIVE, MUVGC_NO_GROUP_OPERATION, MUVGC_SUBGROUP_VALUE_ANY, MUVGC_SUBGROUP_VALUE_UINT, MUVGC_SUBGROUP_VALUE_SAME),
+		// Arithmetic & clustered
+		MUVGC_SUBGROUP_ARITHMETIC_FUNCTIONS("Add", MUVGC_OP_GROUP_NON_UNIFORM_I_ADD, MUVGC_SUBGROUP_VALUE_ARITHMETIC),
+		MUVGC_SUBGROUP_ARITHMETIC_FUNCTIONS("Mul", MUVGC_OP_GROUP_NON_UNIFORM_I_MUL, MUVGC_SUBGROUP_VALUE_ARITHMETIC),
+		MUVGC_SUBGROUP_ARITHMETIC_FUNCTIONS("Min", MUVGC_OP_GROUP_NON_UNIFORM_S_MIN, MUVGC_SUBGROUP_VALUE_ARITHMETIC),
+		MUVGC_SUBGROUP_ARITHMETIC_FUNCTIONS("Max", MUVGC_OP_GROUP_NON_UNIFORM_S_MAX, MUVGC_SUBGROUP_VALUE_ARITHMETIC),
+		MUVGC_SUBGROUP_ARITHMETIC_FUNCTIONS("And", MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_AND, MUVGC_SUBGROUP_VALUE_BITWISE),
+		MUVGC_SUBGROUP_ARITHMETIC_FUNCTIONS("Or", MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_OR, MUVGC_SUBGROUP_VALUE_BITWISE),
+		MUVGC_SUBGROUP_ARITHMETIC_FUNCTIONS("Xor", MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_XOR, MUVGC_SUBGROUP_VALUE_BITWISE)
+	};
+	#define MUVGC_SUBGROUP_FUNCTION_COUNT (sizeof(muVGC_global_subgroup_functions) / sizeof(muVGCSubgroupFunction))
+
+	// Returns the instruction of an arithmetic function for values of the
+	// given component kind
+	uint16_m muVGC_get_subgroup_opcode(uint16_m opcode, muVGCScalarKind kind) {
+		switch (opcode) {
+			default: return opcode; break;
+			case MUVGC_OP_GROUP_NON_UNIFORM_I_ADD: case MUVGC_OP_GROUP_NON_UNIFORM_I_MUL: {
+				return (kind == MUVGC_SCALAR_FLOAT) ? opcode+1 : opcode;
+			} break;
+			case MUVGC_OP_GROUP_NON_UNIFORM_S_MIN: case MUVGC_OP_GROUP_NON_UNIFORM_S_MAX: {
+				return (kind == MUVGC_SCALAR_UINT) ? opcode+1 : (kind == MUVGC_SCALAR_FLOAT) ? opcode+2 : opcode;
+			} break;
+			// (The logical versions follow the bitwise ones)
+			case MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_AND: case MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_OR: case MUVGC_OP_GROUP_NON_UNIFORM_BITWISE_XOR: {
+				return (kind == MUVGC_SCALAR_BOOL) ? opcode+3 : opcode;
+			} break;
+		}
+	}
+
+	// Evaluates an argument of a subgroup function, checking it against what
+	// the function takes; 'value_type' is the type a literal value is taken
+	// as (0 if there's none to go by). Returns 0 on failure.
+	uint32_m muVGC_load_subgroup_argument(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCAssignmentOperand* argument, muVGCSubgroupValue expected, uint32_m value_type, uint32_m* type) {
+
+		switch (expected) {
+			default: *type = value_type; break;
+			case MUVGC_SUBGROUP_VALUE_BOOL: *type = muVGC_get_bool_type(module); break;
+			case MUVGC_SUBGROUP_VALUE_UINT: case MUVGC_SUBGROUP_VALUE_CONSTANT_UINT: *type = muVGC_get_int_type(module, 32, 0); break;
+			case MUVGC_SUBGROUP_VALUE_BALLOT: *type = muVGC_get_transparent_type(module, MUVGC_TYPE_UVEC4); break;
+		}
+
+		uint32_m id = 0;
+		size_m columns = 1, rows = 1;
+		if (argument->token.type == MUVGC_TOKEN_IDENTIFIER) {
+			uint32_m expected_type = *type;
+			id = muVGC_load_reference(result, module, state, code, og, &argument->reference, type);
+			if (id == 0) {
+				return 0;
+			}
+			if (expected != MUVGC_SUBGROUP_VALUE_ANY && expected != MUVGC_SUBGROUP_VALUE_ARITHMETIC &&
+				expected != MUVGC_SUBGROUP_VALUE_BITWISE && *type != expected_type) {
+				muVGC_print_syntax_error(og, argument->token.index);
+				switch (expected) {
+					default: mu_print("expected a bool\n"); break;
+					case MUVGC_SUBGROUP_VALUE_UINT: case MUVGC_SUBGROUP_VALUE_CONSTANT_UINT: mu_print("expected a uint\n"); break;
+					case MUVGC_SUBGROUP_VALUE_BALLOT: mu_print("expected a uvec4 ballot\n"); break;
+				}
+				*result = MU_FAILURE;
+				return 0;
+			}
+		} else {
+			muVGCScalarKind kind = muVGC_get_type_shape(module, *type, &columns, &rows);
+			if (*type == 0 || kind == MUVGC_SCALAR_UNKNOWN || columns != 1 || rows != 1) {
+				muVGC_print_syntax_error(og, argument->token.index);
+				if (expected == MUVGC_SUBGROUP_VALUE_BALLOT) {
+					mu_print("expected a uvec4 ballot\n");
+				} else {
+					mu_print("can't tell the type of a literal argument here\n");
+				}
+				*result = MU_FAILURE;
+				return 0;
+			}
+			id = muVGC_get_literal_constant(result, module, code, og, argument, kind, *type);
+			if (id == 0) {
+				return 0;
+			}
+		}
+
+		muVGCScalarKind kind = muVGC_get_type_shape(module, *type, &columns, &rows);
+		if ((expected == MUVGC_SUBGROUP_VALUE_ANY || expected == MUVGC_SUBGROUP_VALUE_ARITHMETIC || expected == MUVGC_SUBGROUP_VALUE_BITWISE) &&
+			(kind == MUVGC_SCALAR_UNKNOWN || columns != 1 ||
+			(expected == MUVGC_SUBGROUP_VALUE_ARITHMETIC && kind == MUVGC_SCALAR_BOOL) ||
+			(expected == MUVGC_SUBGROUP_VALUE_BITWISE && kind == MUVGC_SCALAR_FLOAT))) {
+			muVGC_print_syntax_error(og, argument->token.index);
+			if (expected == MUVGC_SUBGROUP_VALUE_ARITHMETIC) {
+				mu_print("expected a 32-bit integer or float scalar or vector\n");
+			} else if (expected == MUVGC_SUBGROUP_VALUE_BITWISE) {
+				mu_print("expected a 32-bit integer or bool scalar or vector\n");
+			} else {
+				mu_print("expected a 32-bit or bool scalar or vector\n");
+			}
+			*result = MU_FAILURE;
+			return 0;
+		}
+		// (Constants that aren't specialized)
+		if (expected == MUVGC_SUBGROUP_VALUE_CONSTANT_UINT) {
+			muVGCConstant constant;
+			if (muVGC_fold_get_constant(module, id, &constant) == MU_FALSE) {
+				muVGC_print_syntax_error(og, argument->token.index);
+				mu_print("expected a constant that isn't specialized\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+		}
+		return id;
+	}
+
+	// Evaluates a call of a built-in function, filling in the type of its
+	// result; 'value_type' is the type the result is expected to have (0
+	// if there's none), which literal values are taken as. Returns 0 on
+	// failure.
+	uint32_m muVGC_load_call(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCCall* call, uint32_m value_type, uint32_m* type) {
+
+		const muVGCSubgroupFunction* function = MU_NULL_PTR;
+		for (size_m i = 0; i < MUVGC_SUBGROUP_FUNCTION_COUNT; i++) {
+			if (muVGC_global_subgroup_functions[i].namelen == call->name.length &&
+				mu_strncmp(muVGC_global_subgroup_functions[i].name, muVGC_get_token_value(code, call->name), call->name.length) == 0) {
+				function = &muVGC_global_subgroup_functions[i];
+				break;
+			}
+		}
+		if (function == MU_NULL_PTR) {
+			muVGC_print_syntax_error(og, call->name.index);
+			mu_print("unknown built-in function\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		size_m argument_len = 0;
+		while (argument_len < MUVGC_MAX_CALL_ARGUMENTS && function->arguments[argument_len] != MUVGC_SUBGROUP_VALUE_NONE) {
+			argument_len++;
+		}
+		if (call->argument_len != argument_len) {
+			muVGC_print_syntax_error(og, call->name.index);
+			mu_print("wrong number of arguments\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+
+		uint32_m ids[MUVGC_MAX_CALL_ARGUMENTS];
+		uint32_m argument_types[MUVGC_MAX_CALL_ARGUMENTS];
+		for (size_m i = 0; i < argument_len; i++) {
+			ids[i] = muVGC_load_subgroup_argument(result, module, state, code, og, &call->arguments[i], function->arguments[i], value_type, &argument_types[i]);
+			if (ids[i] == 0) {
+				return 0;
+			}
+		}
+		// (Clusters are powers of two)
+		if (function->group_operation == MUVGC_GROUP_OPERATION_CLUSTERED_REDUCE) {
+			muVGCConstant constant;
+			muVGC_fold_get_constant(module, ids[1], &constant);
+			if (constant.words[0] == 0 || (constant.words[0] & (constant.words[0]-1)) != 0) {
+				muVGC_print_syntax_error(og, call->arguments[1].token.index);
+				mu_print("cluster size must be a power of two\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+		}
+
+		switch (function->result) {
+			default: *type = argument_types[0]; break;
+			case MUVGC_SUBGROUP_VALUE_BOOL: *type = muVGC_get_bool_type(module); break;
+			case MUVGC_SUBGROUP_VALUE_UINT: *type = muVGC_get_int_type(module, 32, 0); break;
+			case MUVGC_SUBGROUP_VALUE_BALLOT: *type = muVGC_get_transparent_type(module, MUVGC_TYPE_UVEC4); break;
+		}
+		size_m columns = 1, rows = 1;
+		muVGCScalarKind kind = (argument_len != 0) ? muVGC_get_type_shape(module, argument_types[0], &columns, &rows) : MUVGC_SCALAR_UNKNOWN;
+		muVGC_require_group_non_uniform(module, function->capability);
+		return muVGC_op_group_non_uniform(module, state->block, muVGC_get_subgroup_opcode(function->opcode, kind), *type, function->group_operation, ids, argument_len);
+	}
+
+	// Loads a variable operand of a condition; returns 0 on failure
+	uint32_m muVGC_load_condition_variable(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCConditionOperand* operand, muBool* is_unsigned) {
+
+		uint32_m type = 0;
+		uint32_m value = 0;
+		muVGCToken name = operand->reference.name;
+		if (operand->is_call == MU_TRUE) {
+			name = operand->call.name;
+			value = muVGC_load_call(result, module, state, code, og, &operand->call, 0, &type);
+		} else {
+			value = muVGC_load_reference(result, module, state, code, og, &operand->reference, &type);
+		}
+		if (value == 0) {
+			return 0;
+		}
+		size_m columns = 1, components = 1;
+		muVGCScalarKind kind = muVGC_get_type_shape(module, type, &columns, &components);
+		if ((kind != MUVGC_SCALAR_INT && kind != MUVGC_SCALAR_UINT) || columns != 1) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("conditions can only compare integers\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		if (components != 1) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("conditions can only compare scalars\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		*is_unsigned = (kind == MUVGC_SCALAR_UINT) ? MU_TRUE : MU_FALSE;
+		return value;
+	}
+
+	// Expressions
+
+	// Any combination of literals, references (anything
+	// muVGC_load_reference can load), built-in function calls, constructors
+	// and parenthesized expressions, negated (- ! ~) and joined by the
+	// operators muVGC_get_operator reads, which bind as tightly as they do
+	// in GLSL. Literals are read as the component type expected of them:
+	// that of what's assigned, of the constructor they're an argument of or
+	// of the other operand of their operator (int, float or bool if there's
+	// no such type, or it's of the other kind). Both operands of an
+	// operator have the same component type; a scalar can be applied to a
+	// vector, and float matrices can be multiplied by matrices, vectors and
+	// scalars. Everything is computed within the current block, folding
+	// what turns out to be constant being left to the optimizer.
+
+	// Returns the scalar type of the components of a scalar, vector or
+	// matrix type
+	uint32_m muVGC_get_component_type(muVGCModule* module, uint32_m type) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+		while (inst != MU_NULL_PTR && (inst->opcode == MUVGC_OP_TYPE_VECTOR || inst->opcode == MUVGC_OP_TYPE_MATRIX)) {
+			type = module->operands[inst->operand_index].word;
+			inst = muVGC_module_get_definition(module, type);
+		}
+		return type;
+	}
+
+	// Decorates the result of an operation as RelaxedPrecision if its
+	// operands are (constants having no precision, as long as one of them
+	// isn't a constant)
+	void muVGC_relax_result(muVGCModule* module, uint32_m id, uint32_m* operands, size_m operand_len) {
+		muBool relaxed = MU_FALSE;
+		for (size_m i = 0; i < operand_len; i++) {
+			if (muVGC_is_constant(module, operands[i]) == MU_TRUE) continue;
+			if (muVGC_find_decoration(module, operands[i], MUVGC_DECORATION_RELAXED_PRECISION) == MUVGC_NO_DECORATION) {
+				return;
+			}
+			relaxed = MU_TRUE;
+		}
+		if (relaxed == MU_TRUE) {
+			muVGC_op_decorate(module, id, MUVGC_DECORATION_RELAXED_PRECISION);
+		}
+	}
+
+	// Returns the constant a literal stands for, filling in its type;
+	// returns 0 on failure
+	uint32_m muVGC_load_literal(
+		muResult* result, muVGCModule* module, const char* code, const char* og,
+		muVGCAssignmentOperand* operand, uint32_m expected, uint32_m* type) {
+
+		*type = (expected != 0) ? muVGC_get_component_type(module, expected) : 0;
+		muVGCScalarKind kind = (*type != 0) ? muVGC_get_scalar_kind(module, *type) : MUVGC_SCALAR_UNKNOWN;
+		muBool is_bool = muVGC_token_is_bool_literal(code, operand->token);
+		if (kind == MUVGC_SCALAR_UNKNOWN || (kind == MUVGC_SCALAR_BOOL) != (is_bool == MU_TRUE)) {
+			if (is_bool == MU_TRUE) {
+				kind = MUVGC_SCALAR_BOOL;
+				*type = muVGC_get_bool_type(module);
+			} else if (operand->token.type == MUVGC_TOKEN_FLOAT_CONSTANT) {
+				kind = MUVGC_SCALAR_FLOAT;
+				*type = muVGC_get_transparent_type(module, MUVGC_TYPE_FLOAT);
+			} else {
+				kind = MUVGC_SCALAR_INT;
+				*type = muVGC_get_int_type(module, 32, 1);
+			}
+		}
+		return muVGC_get_literal_constant(result, module, code, og, operand, kind, *type);
+	}
+
+	// Returns a vector of the given type whose every component is the given
+	// scalar
+	uint32_m muVGC_splat(muVGCModule* module, muVGCStatementState* state, uint32_m scalar, uint32_m type) {
+		muVGCInstruction* inst = muVGC_module_get_definition(module, type);
+		size_m len = module->operands[inst->operand_index+1].word;
+		uint32_m constituents[4];
+		for (size_m i = 0; i < len; i++) {
+			constituents[i] = scalar;
+		}
+		if (muVGC_is_constant(module, scalar) == MU_TRUE && muVGC_is_spec_constant(module, scalar) == MU_FALSE) {
+			return muVGC_get_composite_constant(module, type, constituents, len);
+		}
+		if (state->constant_expression == MU_TRUE) {
+			return muVGC_op_spec_constant_composite(module, type, constituents, len);
+		}
+		return muVGC_op_composite_construct(module, state->block, type, constituents, len);
+	}
+
+	// Returns the opcode converting components of one kind to another, or
+	// 0 if they can't be
+	uint16_m muVGC_get_conversion_opcode(muVGCScalarKind from, muVGCScalarKind to) {
+		if (from == MUVGC_SCALAR_FLOAT) {
+			return (to == MUVGC_SCALAR_INT) ? MUVGC_OP_CONVERT_F_TO_S : (to == MUVGC_SCALAR_UINT) ? MUVGC_OP_CONVERT_F_TO_U : 0;
+		}
+		if (from == MUVGC_SCALAR_INT) {
+			return (to == MUVGC_SCALAR_FLOAT) ? MUVGC_OP_CONVERT_S_TO_F : (to == MUVGC_SCALAR_UINT) ? MUVGC_OP_BITCAST : 0;
+		}
+		if (from == MUVGC_SCALAR_UINT) {
+			return (to == MUVGC_SCALAR_FLOAT) ? MUVGC_OP_CONVERT_U_TO_F : (to == MUVGC_SCALAR_INT) ? MUVGC_OP_BITCAST : 0;
+		}
+		return 0;
+	}
+
+	// Applies an operation to one value (b being 0) or two within the
+	// current block, or as a constant in a constant expression; returns 0
+	// on failure
+	uint32_m muVGC_apply_operation(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* og, muVGCToken token,
+		uint16_m opcode, uint32_m type, uint32_m a, uint32_m b) {
+
+		uint32_m ids[2] = { a, b };
+		size_m id_len = (b == 0) ? 1 : 2;
+		if (state->constant_expression == MU_TRUE) {
+			muVGCOperand operands[] = { MUVGC_ID(a), MUVGC_ID(b) };
+			return muVGC_get_constant_result(result, module, og, token, opcode, type, operands, id_len);
+		}
+		uint32_m id = (b == 0) ? muVGC_op_unary(module, state->block, opcode, type, a) : muVGC_op_binary(module, state->block, opcode, type, a, b);
+		muVGC_relax_result(module, id, ids, id_len);
+		return id;
+	}
+
+	uint32_m muVGC_load_expression(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCToken* tokens, size_m token_len, size_m* i, uint32_m expected, size_m min_precedence, uint32_m* type);
+
+	// Evaluates a constructor (A(...) at tokens[*i]), filling in its type;
+	// returns 0 on failure. The components of its arguments fill in those
+	// of the vector in order, though a single scalar fills every one, and
+	// a single argument of another component type is converted.
+	uint32_m muVGC_load_constructor(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCToken* tokens, size_m token_len, size_m* i, uint32_m* type) {
+
+		muVGCToken name = tokens[*i];
+		muVGCBasicType constructed = muVGC_get_basic_type(muVGC_get_token_value(code, name), name.length);
+		if (constructed == MUVGC_TYPE_VOID || constructed < MUVGC_TRANSPARENT_TYPE_FIRST || constructed > MUVGC_TRANSPARENT_TYPE_LAST) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("only non-void transparent types can be constructed\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		*type = muVGC_get_transparent_type(module, constructed);
+		size_m columns = 1, rows = 1;
+		muVGCScalarKind kind = muVGC_get_type_shape(module, *type, &columns, &rows);
+		if (kind == MUVGC_SCALAR_UNKNOWN || kind == MUVGC_SCALAR_BOOL || columns != 1) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("only 32-bit scalar and vector constructors are supported for now\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		uint32_m component_type = muVGC_get_component_type(module, *type);
+		*i += 2;
+
+		uint32_m constituents[MUVGC_MAX_CONSTRUCTOR_ARGUMENTS];
+		size_m constituent_len = 0, component_len = 0;
+		muBool constant = MU_TRUE, specialized = MU_FALSE;
+		// (Kind of the first argument, and where the first argument of
+		// another kind than it starts)
+		muVGCScalarKind argument_kind = MUVGC_SCALAR_UNKNOWN;
+		size_m other_kind = 0;
+		while (MU_TRUE) {
+			if (constituent_len == MUVGC_MAX_CONSTRUCTOR_ARGUMENTS) {
+				muVGC_print_syntax_error(og, tokens[(*i >= token_len) ? token_len-1 : *i].index);
+				mu_print("too many constructor arguments\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			size_m argument = *i;
+			uint32_m value_type = 0;
+			uint32_m id = muVGC_load_expression(result, module, state, code, og, tokens, token_len, i, component_type, 1, &value_type);
+			if (id == 0) {
+				return 0;
+			}
+			size_m value_columns = 1, components = 1;
+			muVGCScalarKind value_kind = muVGC_get_type_shape(module, value_type, &value_columns, &components);
+			if (value_kind == MUVGC_SCALAR_UNKNOWN || value_columns != 1) {
+				muVGC_print_syntax_error(og, tokens[argument].index);
+				mu_print("constructor arguments must be 32-bit or boolean scalars or vectors\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			if (constituent_len == 0) {
+				argument_kind = value_kind;
+			} else if (value_kind != argument_kind && other_kind == 0) {
+				other_kind = argument;
+			}
+			if (component_len + components > rows) {
+				muVGC_print_syntax_error(og, tokens[argument].index);
+				mu_print("too many components in constructor\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			if (muVGC_is_constant(module, id) == MU_FALSE) {
+				constant = MU_FALSE;
+			} else if (muVGC_is_spec_constant(module, id) == MU_TRUE) {
+				specialized = MU_TRUE;
+			}
+			constituents[constituent_len] = id;
+			constituent_len += 1;
+			component_len += components;
+			if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_COMMA) {
+				*i += 1;
+				continue;
+			}
+			break;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+			return 0;
+		}
+		*i += 1;
+
+		// (Only a single argument can be converted)
+		if (argument_kind != kind && constituent_len == 1) {
+			uint16_m opcode = muVGC_get_conversion_opcode(argument_kind, kind);
+			if (opcode == 0) {
+				muVGC_print_syntax_error(og, name.index);
+				mu_print("booleans and numbers can't be converted to each other\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			uint32_m converted_type = (component_len == 1) ? component_type : *type;
+			constituents[0] = muVGC_apply_operation(result, module, state, og, name, opcode, converted_type, constituents[0], 0);
+			if (constituents[0] == 0) {
+				return 0;
+			}
+			constant = state->constant_expression;
+			specialized = muVGC_is_spec_constant(module, constituents[0]);
+		} else if (argument_kind != kind || other_kind != 0) {
+			muVGC_print_syntax_error(og, tokens[(other_kind != 0) ? other_kind : name.index].index);
+			mu_print("constructor argument has a different component type\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		// (A single scalar fills every component)
+		if (constituent_len == 1 && component_len == 1) {
+			for (; constituent_len < rows; constituent_len++) {
+				constituents[constituent_len] = constituents[0];
+			}
+			component_len = rows;
+		}
+		if (component_len != rows) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("too few components in constructor\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		if (constituent_len == 1) {
+			return constituents[0];
+		}
+		if (constant == MU_TRUE && specialized == MU_TRUE) {
+			return muVGC_op_spec_constant_composite(module, *type, constituents, constituent_len);
+		}
+		if (constant == MU_TRUE) {
+			return muVGC_get_composite_constant(module, *type, constituents, constituent_len);
+		}
+		return muVGC_op_composite_construct(module, state->block, *type, constituents, constituent_len);
+	}
+
+	// Applies a binary operator to two values, filling in the type of the
+	// result; returns 0 on failure
+	uint32_m muVGC_apply_operator(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* og,
+		muVGCToken token, muVGCOperator operation, uint32_m a, uint32_m a_type, uint32_m b, uint32_m b_type, uint32_m* type) {
+
+		size_m a_columns = 1, a_rows = 1, b_columns = 1, b_rows = 1;
+		muVGCScalarKind kind = muVGC_get_type_shape(module, a_type, &a_columns, &a_rows);
+		if (kind == MUVGC_SCALAR_UNKNOWN || muVGC_get_type_shape(module, b_type, &b_columns, &b_rows) != kind) {
+			muVGC_print_syntax_error(og, token.index);
+			mu_print("operands are of different types\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+
+		uint16_m opcode = 0;
+		muBool sizes_match = MU_TRUE;
+		if (a_columns != 1 || b_columns != 1) {
+			// Matrices
+			if (operation != MUVGC_OPERATOR_MULTIPLY) {
+				muVGC_print_syntax_error(og, token.index);
+				mu_print("matrices can only be multiplied for now\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			uint32_m a_column_type = module->operands[muVGC_module_get_definition(module, a_type)->operand_index].word;
+			if (a_columns != 1 && b_columns != 1) {
+				opcode = MUVGC_OP_MATRIX_TIMES_MATRIX;
+				sizes_match = (a_columns == b_rows) ? MU_TRUE : MU_FALSE;
+				*type = muVGC_get_matrix_type(module, a_column_type, (uint32_m)b_columns);
+			} else if (a_columns != 1 && b_rows != 1) {
+				opcode = MUVGC_OP_MATRIX_TIMES_VECTOR;
+				sizes_match = (a_columns == b_rows) ? MU_TRUE : MU_FALSE;
+				*type = a_column_type;
+			} else if (a_rows != 1 && b_columns != 1) {
+				opcode = MUVGC_OP_VECTOR_TIMES_MATRIX;
+				sizes_match = (a_rows == b_rows) ? MU_TRUE : MU_FALSE;
+				*type = muVGC_get_vector_type(module, muVGC_get_component_type(module, a_type), (uint32_m)b_columns);
+			} else {
+				// (The matrix comes first)
+				opcode = MUVGC_OP_MATRIX_TIMES_SCALAR;
+				if (a_columns == 1) {
+					uint32_m t = a; a = b; b = t;
+					a_type = b_type;
+				}
+				*type = a_type;
+			}
+		} else {
+			// Scalars & vectors
+			if (a_rows != b_rows && a_rows != 1 && b_rows != 1) {
+				sizes_match = MU_FALSE;
+			} else if (muVGC_operator_is_comparison(operation) == MU_TRUE && a_rows != 1) {
+				muVGC_print_syntax_error(og, token.index);
+				mu_print("only scalars can be compared for now\n");
+				*result = MU_FAILURE;
+				return 0;
+			} else if (a_rows != b_rows && operation == MUVGC_OPERATOR_MULTIPLY && kind == MUVGC_SCALAR_FLOAT) {
+				// (The vector comes first)
+				opcode = MUVGC_OP_VECTOR_TIMES_SCALAR;
+				if (a_rows == 1) {
+					uint32_m t = a; a = b; b = t;
+					a_type = b_type;
+				}
+			} else if (a_rows != b_rows) {
+				if (a_rows == 1) {
+					a = muVGC_splat(module, state, a, b_type);
+					a_type = b_type;
+				} else {
+					b = muVGC_splat(module, state, b, a_type);
+				}
+			}
+			if (opcode == 0) {
+				opcode = muVGC_get_operator_opcode(operation, kind);
+			}
+			*type = (muVGC_operator_is_comparison(operation) == MU_TRUE) ? muVGC_get_bool_type(module) : a_type;
+		}
+		if (sizes_match == MU_FALSE) {
+			muVGC_print_syntax_error(og, token.index);
+			mu_print("operands' sizes don't match\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		if (opcode == 0) {
+			muVGC_print_syntax_error(og, token.index);
+			mu_print("operator can't be used on operands of this type\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+
+		return muVGC_apply_operation(result, module, state, og, token, opcode, *type, a, b);
+	}
+
+	// Built-in functions taking expressions: the GLSL.std.450 ones (and
+	// dot, being OpDot), each picking its instruction by the component type
+	// of its arguments, and the atomic ones, whose first argument is a
+	// member of a buffer block
+
+	// (Scalar arguments are splatted to the widest argument, as in
+	// min(v, 0.0))
+	#define MUVGC_FUNCTION_SPLATS 1
+	// (The result is a scalar of the arguments' component type)
+	#define MUVGC_FUNCTION_RETURNS_COMPONENT 2
+
+	struct muVGCMathFunction {
+		const char* name;
+		size_m namelen;
+		size_m argument_len;
+		// (GLSL.std.450 instructions for float, int and uint arguments, 0
+		// where there's none)
+		uint32_m instructions[3];
+		// (An opcode used instead for floats, 0 if there's none)
+		uint16_m opcode;
+		uint32_m flags;
+	};
+	typedef struct muVGCMathFunction muVGCMathFunction;
+
+	#define MUVGC_MATH_FUNCTION(name, argument_len, f, s, u, flags) { name, sizeof(name)-1, argument_len, { f, s, u }, 0, flags }
+	#define MUVGC_FLOAT_FUNCTION(name, argument_len, f) MUVGC_MATH_FUNCTION(name, argument_len, f, 0, 0, 0)
+
+	const muVGCMathFunction muVGC_global_math_functions[] = {
+		// Angle & trigonometry
+		MUVGC_FLOAT_FUNCTION("radians", 1, MUVGC_GLSL_RADIANS),
+		MUVGC_FLOAT_FUNCTION("degrees", 1, MUVGC_GLSL_DEGREES),
+		MUVGC_FLOAT_FUNCTION("sin", 1, MUVGC_GLSL_SIN),
+		MUVGC_FLOAT_FUNCTION("cos", 1, MUVGC_GLSL_COS),
+		MUVGC_FLOAT_FUNCTION("tan", 1, MUVGC_GLSL_TAN),
+		MUVGC_FLOAT_FUNCTION("asin", 1, MUVGC_GLSL_ASIN),
+		MUVGC_FLOAT_FUNCTION("acos", 1, MUVGC_GLSL_ACOS),
+		MUVGC_FLOAT_FUNCTION("atan", 1, MUVGC_GLSL_ATAN),
+		MUVGC_FLOAT_FUNCTION("atan", 2, MUVGC_GLSL_ATAN2),
+		MUVGC_FLOAT_FUNCTION("sinh", 1, MUVGC_GLSL_SINH),
+		MUVGC_FLOAT_FUNCTION("cosh", 1, MUVGC_GLSL_COSH),
+		MUVGC_FLOAT_FUNCTION("tanh", 1, MUVGC_GLSL_TANH),
+		MUVGC_FLOAT_FUNCTION("asinh", 1, MUVGC_GLSL_ASINH),
+		MUVGC_FLOAT_FUNCTION("acosh", 1, MUVGC_GLSL_ACOSH),
+		MUVGC_FLOAT_FUNCTION("atanh", 1, MUVGC_GLSL_ATANH),
+		// Exponential
+		MUVGC_FLOAT_FUNCTION("pow", 2, MUVGC_GLSL_POW),
+		MUVGC_FLOAT_FUNCTION("exp", 1, MUVGC_GLSL_EXP),
+		MUVGC_FLOAT_FUNCTION("log", 1, MUVGC_GLSL_LOG),
+		MUVGC_FLOAT_FUNCTION("exp2", 1, MUVGC_GLSL_EXP2),
+		MUVGC_FLOAT_FUNCTION("log2", 1, MUVGC_GLSL_LOG2),
+		MUVGC_FLOAT_FUNCTION("sqrt", 1, MUVGC_GLSL_SQRT),
+		MUVGC_FLOAT_FUNCTION("inversesqrt", 1, MUVGC_GLSL_INVERSE_SQRT),
+		// Common
+		MUVGC_MATH_FUNCTION("abs", 1, MUVGC_GLSL_F_ABS, MUVGC_GLSL_S_ABS, 0, 0),
+		MUVGC_MATH_FUNCTION("sign", 1, MUVGC_GLSL_F_SIGN, MUVGC_GLSL_S_SIGN, 0, 0),
+		MUVGC_FLOAT_FUNCTION("floor", 1, MUVGC_GLSL_FLOOR),
+		MUVGC_FLOAT_FUNCTION("trunc", 1, MUVGC_GLSL_TRUNC),
+		MUVGC_FLOAT_FUNCTION("round", 1, MUVGC_GLSL_ROUND),
+		MUVGC_FLOAT_FUNCTION("roundEven", 1, MUVGC_GLSL_ROUND_EVEN),
+		MUVGC_FLOAT_FUNCTION("ceil", 1, MUVGC_GLSL_CEIL),
+		MUVGC_FLOAT_FUNCTION("fract", 1, MUVGC_GLSL_FRACT),
+		MUVGC_MATH_FUNCTION("min", 2, MUVGC_GLSL_F_MIN, MUVGC_GLSL_S_MIN, MUVGC_GLSL_U_MIN, MUVGC_FUNCTION_SPLATS),
+		MUVGC_MATH_FUNCTION("max", 2, MUVGC_GLSL_F_MAX, MUVGC_GLSL_S_MAX, MUVGC_GLSL_U_MAX, MUVGC_FUNCTION_SPLATS),
+		MUVGC_MATH_FUNCTION("clamp", 3, MUVGC_GLSL_F_CLAMP, MUVGC_GLSL_S_CLAMP, MUVGC_GLSL_U_CLAMP, MUVGC_FUNCTION_SPLATS),
+		MUVGC_MATH_FUNCTION("mix", 3, MUVGC_GLSL_F_MIX, 0, 0, MUVGC_FUNCTION_SPLATS),
+		MUVGC_MATH_FUNCTION("step", 2, MUVGC_GLSL_STEP, 0, 0, MUVGC_FUNCTION_SPLATS),
+		MUVGC_MATH_FUNCTION("smoothstep", 3, MUVGC_GLSL_SMOOTH_STEP, 0, 0, MUVGC_FUNCTION_SPLATS),
+		MUVGC_FLOAT_FUNCTION("fma", 3, MUVGC_GLSL_FMA),
+		// Geometric
+		MUVGC_MATH_FUNCTION("length", 1, MUVGC_GLSL_LENGTH, 0, 0, MUVGC_FUNCTION_RETURNS_COMPONENT),
+		MUVGC_MATH_FUNCTION("distance", 2, MUVGC_GLSL_DISTANCE, 0, 0, MUVGC_FUNCTION_RETURNS_COMPONENT),
+		{ "dot", 3, 2, { 0, 0, 0 }, MUVGC_OP_DOT, MUVGC_FUNCTION_RETURNS_COMPONENT },
+		MUVGC_FLOAT_FUNCTION("cross", 2, MUVGC_GLSL_CROSS),
+		MUVGC_FLOAT_FUNCTION("normalize", 1, MUVGC_GLSL_NORMALIZE),
+		MUVGC_FLOAT_FUNCTION("faceforward", 3, MUVGC_GLSL_FACE_FORWARD),
+		MUVGC_FLOAT_FUNCTION("reflect", 2, MUVGC_GLSL_REFLECT)
+	};
+	#define MUVGC_MATH_FUNCTION_COUNT (sizeof(muVGC_global_math_functions) / sizeof(muVGCMathFunction))
+
+	// Finds a math function by name, taking the given number of arguments
+	// (any number if 0); returns 0 if there's none
+	const muVGCMathFunction* muVGC_find_math_function(const char* code, muVGCToken name, size_m argument_len) {
+		for (size_m i = 0; i < MUVGC_MATH_FUNCTION_COUNT; i++) {
+			const muVGCMathFunction* function = &muVGC_global_math_functions[i];
+			if (function->namelen == name.length && mu_strncmp(function->name, muVGC_get_token_value(code, name), name.length) == 0 &&
+				(argument_len == 0 || function->argument_len == argument_len)) {
+				return function;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	struct muVGCAtomicFunction {
+		const char* name;
+		size_m namelen;
+		// (For int and uint values)
+		uint16_m opcodes[2];
+	};
+	typedef struct muVGCAtomicFunction muVGCAtomicFunction;
+
+	#define MUVGC_ATOMIC_FUNCTION(name, s, u) { name, sizeof(name)-1, { s, u } }
+
+	const muVGCAtomicFunction muVGC_global_atomic_functions[] = {
+		MUVGC_ATOMIC_FUNCTION("atomicAdd", MUVGC_OP_ATOMIC_I_ADD, MUVGC_OP_ATOMIC_I_ADD),
+		MUVGC_ATOMIC_FUNCTION("atomicMin", MUVGC_OP_ATOMIC_S_MIN, MUVGC_OP_ATOMIC_U_MIN),
+		MUVGC_ATOMIC_FUNCTION("atomicMax", MUVGC_OP_ATOMIC_S_MAX, MUVGC_OP_ATOMIC_U_MAX),
+		MUVGC_ATOMIC_FUNCTION("atomicAnd", MUVGC_OP_ATOMIC_AND, MUVGC_OP_ATOMIC_AND),
+		MUVGC_ATOMIC_FUNCTION("atomicOr", MUVGC_OP_ATOMIC_OR, MUVGC_OP_ATOMIC_OR),
+		MUVGC_ATOMIC_FUNCTION("atomicXor", MUVGC_OP_ATOMIC_XOR, MUVGC_OP_ATOMIC_XOR),
+		MUVGC_ATOMIC_FUNCTION("atomicExchange", MUVGC_OP_ATOMIC_EXCHANGE, MUVGC_OP_ATOMIC_EXCHANGE)
+	};
+	#define MUVGC_ATOMIC_FUNCTION_COUNT (sizeof(muVGC_global_atomic_functions) / sizeof(muVGCAtomicFunction))
+
+	const muVGCAtomicFunction* muVGC_find_atomic_function(const char* code, muVGCToken name) {
+		for (size_m i = 0; i < MUVGC_ATOMIC_FUNCTION_COUNT; i++) {
+			const muVGCAtomicFunction* function = &muVGC_global_atomic_functions[i];
+			if (function->namelen == name.length && mu_strncmp(function->name, muVGC_get_token_value(code, name), name.length) == 0) {
+				return function;
+			}
+		}
+		return MU_NULL_PTR;
+	}
+
+	// Evaluates a call of an atomic function (at tokens[*i]), filling in
+	// the type of its result; returns 0 on failure
+	uint32_m muVGC_load_atomic_call(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCToken* tokens, size_m token_len, size_m* i, const muVGCAtomicFunction* function, uint32_m* type) {
+
+		*i += 2;
+		muVGCReference target;
+		if (muVGC_get_reference(result, tokens, token_len, og, i, &target) != MU_SUCCESS) {
+			return 0;
+		}
+		uint32_m pointer = 0;
+		if (muVGC_get_assignment_target(result, module, state, code, og, &target, &pointer, type) == MU_FALSE) {
+			return 0;
+		}
+		muVGCInstruction* pointer_type = muVGC_module_get_definition(module, muVGC_module_get_definition(module, pointer)->result_type);
+		if (module->operands[pointer_type->operand_index].word != MUVGC_STORAGE_CLASS_STORAGE_BUFFER) {
+			muVGC_print_syntax_error(og, target.name.index);
+			mu_print("atomic functions only apply to members of buffer blocks for now\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		size_m columns = 1, rows = 1;
+		muVGCScalarKind kind = muVGC_get_type_shape(module, *type, &columns, &rows);
+		if ((kind != MUVGC_SCALAR_INT && kind != MUVGC_SCALAR_UINT) || rows != 1) {
+			muVGC_print_syntax_error(og, target.name.index);
+			mu_print("atomic functions only apply to int and uint scalars\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_COMMA, "expected ','\n") != MU_SUCCESS) {
+			return 0;
+		}
+		*i += 1;
+
+		size_m argument = *i;
+		uint32_m value_type = 0;
+		uint32_m value = muVGC_load_expression(result, module, state, code, og, tokens, token_len, i, *type, 1, &value_type);
+		if (value == 0) {
+			return 0;
+		}
+		if (value_type != *type) {
+			muVGC_print_syntax_error(og, tokens[argument].index);
+			mu_print("atomic function's value is of a different type than its member\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+			return 0;
+		}
+		*i += 1;
+		return muVGC_op_atomic(module, state->block, function->opcodes[(kind == MUVGC_SCALAR_UINT) ? 1 : 0], *type, pointer, value);
+	}
+
+	// Evaluates a call of a math function (at tokens[*i]), filling in the
+	// type of its result; 'expected' is the type the result is expected to
+	// have (0 if there's none), which literal arguments are read as (later
+	// ones as the first argument's type). Returns 0 on failure.
+	uint32_m muVGC_load_math_call(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCToken* tokens, size_m token_len, size_m* i, uint32_m expected, uint32_m* type) {
+
+		muVGCToken name = tokens[*i];
+		*i += 2;
+		uint32_m ids[3];
+		uint32_m argument_types[3];
+		size_m arguments[3];
+		size_m argument_len = 0;
+		while (*i >= token_len || tokens[*i].type != MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+			if (argument_len == 3) {
+				muVGC_print_syntax_error(og, tokens[(*i >= token_len) ? token_len-1 : *i].index);
+				mu_print("too many arguments\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			arguments[argument_len] = *i;
+			ids[argument_len] = muVGC_load_expression(
+				result, module, state, code, og, tokens, token_len, i,
+				(argument_len == 0) ? expected : argument_types[0], 1, &argument_types[argument_len]
+			);
+			if (ids[argument_len] == 0) {
+				return 0;
+			}
+			argument_len += 1;
+			if (*i < token_len && tokens[*i].type == MUVGC_TOKEN_COMMA) {
+				*i += 1;
+				continue;
+			}
+			if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')'\n") != MU_SUCCESS) {
+				return 0;
+			}
+		}
+		*i += 1;
+
+		const muVGCMathFunction* function = (argument_len != 0) ? muVGC_find_math_function(code, name, argument_len) : MU_NULL_PTR;
+		if (function == MU_NULL_PTR) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("wrong number of arguments\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+
+		// (The widest argument gives the type of the others)
+		uint32_m widest = argument_types[0];
+		size_m columns = 1, rows = 1;
+		muVGCScalarKind kind = muVGC_get_type_shape(module, widest, &columns, &rows);
+		for (size_m a = 0; a < argument_len; a++) {
+			size_m argument_columns = 1, argument_rows = 1;
+			muVGCScalarKind argument_kind = muVGC_get_type_shape(module, argument_types[a], &argument_columns, &argument_rows);
+			if (argument_kind != kind || argument_columns != 1) {
+				muVGC_print_syntax_error(og, tokens[arguments[a]].index);
+				mu_print("arguments must be scalars or vectors of the same component type\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			if (argument_rows == rows) continue;
+			if ((function->flags & MUVGC_FUNCTION_SPLATS) == 0 || (argument_rows != 1 && rows != 1)) {
+				muVGC_print_syntax_error(og, tokens[arguments[a]].index);
+				mu_print("arguments' sizes don't match\n");
+				*result = MU_FAILURE;
+				return 0;
+			}
+			if (argument_rows > rows) {
+				rows = argument_rows;
+				widest = argument_types[a];
+			}
+		}
+		uint32_m instruction = 0;
+		switch (kind) {
+			default: break;
+			case MUVGC_SCALAR_FLOAT: instruction = (function->opcode != 0) ? function->opcode : function->instructions[0]; break;
+			case MUVGC_SCALAR_INT: instruction = function->instructions[1]; break;
+			case MUVGC_SCALAR_UINT: instruction = function->instructions[2]; break;
+		}
+		if (instruction == 0) {
+			muVGC_print_syntax_error(og, name.index);
+			mu_print("function can't be used on arguments of this type\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		for (size_m a = 0; a < argument_len; a++) {
+			if (argument_types[a] != widest) {
+				ids[a] = muVGC_splat(module, state, ids[a], widest);
+			}
+		}
+
+		*type = ((function->flags & MUVGC_FUNCTION_RETURNS_COMPONENT) != 0) ? muVGC_get_component_type(module, widest) : widest;
+		uint32_m id = 0;
+		if (function->opcode != 0) {
+			id = muVGC_op_binary(module, state->block, function->opcode, *type, ids[0], ids[1]);
+		} else {
+			id = muVGC_op_ext_inst(module, state->block, *type, instruction, ids, argument_len);
+		}
+		muVGC_relax_result(module, id, ids, argument_len);
+		return id;
+	}
+
+	// Evaluates an operand of an operator at tokens[*i] (along with the
+	// unary operators applied to it), filling in its type; returns 0 on
+	// failure
+	uint32_m muVGC_load_unary_expression(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCToken* tokens, size_m token_len, size_m* i, uint32_m expected, uint32_m* type) {
+
+		if (*i >= token_len) {
+			muVGC_print_syntax_error(og, tokens[token_len-1].index);
+			mu_print("expected expression\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		muVGCToken token = tokens[*i];
+
+		// Literals (negated numbers included)
+		if (token.type == MUVGC_TOKEN_INTEGER_CONSTANT || token.type == MUVGC_TOKEN_FLOAT_CONSTANT || muVGC_token_is_bool_literal(code, token) == MU_TRUE ||
+			(token.type == MUVGC_TOKEN_DASH && *i+1 < token_len &&
+			(tokens[*i+1].type == MUVGC_TOKEN_INTEGER_CONSTANT || tokens[*i+1].type == MUVGC_TOKEN_FLOAT_CONSTANT))) {
+			muVGCAssignmentOperand operand;
+			if (muVGC_get_assignment_operand(result, tokens, token_len, code, og, i, &operand) != MU_SUCCESS) {
+				return 0;
+			}
+			return muVGC_load_literal(result, module, code, og, &operand, expected, type);
+		}
+
+		switch (token.type) {
+			default: break;
+
+			case MUVGC_TOKEN_DASH: case MUVGC_TOKEN_EXCLAMATION_POINT: case MUVGC_TOKEN_TILDE: {
+				*i += 1;
+				uint32_m value = muVGC_load_unary_expression(result, module, state, code, og, tokens, token_len, i, expected, type);
+				if (value == 0) {
+					return 0;
+				}
+				size_m columns = 1, rows = 1;
+				muVGCScalarKind kind = muVGC_get_type_shape(module, *type, &columns, &rows);
+				muBool is_integer = (kind == MUVGC_SCALAR_INT || kind == MUVGC_SCALAR_UINT) ? MU_TRUE : MU_FALSE;
+				uint16_m opcode = 0;
+				if (token.type == MUVGC_TOKEN_DASH) {
+					opcode = (kind == MUVGC_SCALAR_FLOAT) ? MUVGC_OP_F_NEGATE : (is_integer == MU_TRUE) ? MUVGC_OP_S_NEGATE : 0;
+				} else if (token.type == MUVGC_TOKEN_EXCLAMATION_POINT) {
+					opcode = (kind == MUVGC_SCALAR_BOOL) ? MUVGC_OP_LOGICAL_NOT : 0;
+				} else {
+					opcode = (is_integer == MU_TRUE) ? MUVGC_OP_NOT : 0;
+				}
+				if (opcode == 0 || columns != 1) {
+					muVGC_print_syntax_error(og, token.index);
+					mu_print("operator can't be used on operands of this type\n");
+					*result = MU_FAILURE;
+					return 0;
+				}
+				return muVGC_apply_operation(result, module, state, og, token, opcode, *type, value, 0);
+			} break;
+
+			case MUVGC_TOKEN_OPEN_PARENTHESIS: {
+				*i += 1;
+				uint32_m value = muVGC_load_expression(result, module, state, code, og, tokens, token_len, i, expected, 1, type);
+				if (value == 0) {
+					return 0;
+				}
+				if (muVGC_expect_token(result, tokens, token_len, og, *i, MUVGC_TOKEN_CLOSE_PARENTHESIS, "expected ')' to close '('\n") != MU_SUCCESS) {
+					return 0;
+				}
+				*i += 1;
+				return value;
+			} break;
+
+			case MUVGC_TOKEN_KEYWORD: {
+				if (*i+1 < token_len && tokens[*i+1].type == MUVGC_TOKEN_OPEN_PARENTHESIS) {
+					return muVGC_load_constructor(result, module, state, code, og, tokens, token_len, i, type);
+				}
+			} break;
+
+			case MUVGC_TOKEN_IDENTIFIER: {
+				if (muVGC_is_call(tokens, token_len, *i) == MU_TRUE) {
+					if (state->constant_expression == MU_TRUE) {
+						muVGC_print_syntax_error(og, token.index);
+						mu_print("constants can't be initialized with function calls\n");
+						*result = MU_FAILURE;
+						return 0;
+					}
+					const muVGCAtomicFunction* atomic = muVGC_find_atomic_function(code, token);
+					if (atomic != MU_NULL_PTR) {
+						return muVGC_load_atomic_call(result, module, state, code, og, tokens, token_len, i, atomic, type);
+					}
+					if (muVGC_find_math_function(code, token, 0) != MU_NULL_PTR) {
+						return muVGC_load_math_call(result, module, state, code, og, tokens, token_len, i, expected, type);
+					}
+					muVGCCall call;
+					if (muVGC_get_call(result, tokens, token_len, code, og, i, &call) != MU_SUCCESS) {
+						return 0;
+					}
+					return muVGC_load_call(result, module, state, code, og, &call, expected, type);
+				}
+				muVGCReference reference;
+				if (muVGC_get_reference(result, tokens, token_len, og, i, &reference) != MU_SUCCESS) {
+					return 0;
+				}
+				if (state->constant_expression == MU_TRUE && (reference.has_index == MU_TRUE || muVGC_find_constant(state, code, reference.name) == MU_NULL_PTR)) {
+					muVGC_print_syntax_error(og, token.index);
+					mu_print("constants can only be computed from literals and other constants\n");
+					*result = MU_FAILURE;
+					return 0;
+				}
+				return muVGC_load_reference(result, module, state, code, og, &reference, type);
+			} break;
+		}
+
+		muVGC_print_syntax_error(og, token.index);
+		mu_print("expected expression\n");
+		*result = MU_FAILURE;
+		return 0;
+	}
+
+	// Evaluates the operators binding at least as tightly as
+	// 'min_precedence' in the expression at tokens[*i], filling in the
+	// type of its value; 'expected' is the type it's expected to have (0
+	// if there's none), which literals are read as. Returns 0 on failure.
+	uint32_m muVGC_load_expression(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCToken* tokens, size_m token_len, size_m* i, uint32_m expected, size_m min_precedence, uint32_m* type) {
+
+		uint32_m value = muVGC_load_unary_expression(result, module, state, code, og, tokens, token_len, i, expected, type);
+		while (value != 0) {
+			size_m next = *i;
+			muVGCOperator operation = muVGC_get_operator(tokens, token_len, &next);
+			if (operation == MUVGC_OPERATOR_NONE || muVGC_get_operator_precedence(operation) < min_precedence) {
+				break;
+			}
+			muVGCToken token = tokens[*i];
+			*i = next;
+
+			// (Literals on the right are read as the left's type)
+			uint32_m right_type = 0;
+			uint32_m right = muVGC_load_expression(result, module, state, code, og, tokens, token_len, i, *type, muVGC_get_operator_precedence(operation)+1, &right_type);
+			if (right == 0) {
+				return 0;
+			}
+			value = muVGC_apply_operator(result, module, state, og, token, operation, value, *type, right, right_type, type);
+		}
+		return value;
+	}
+
+	// Evaluates the expression of an assignment (or a local variable's
+	// initialization) as a value of the given type; returns 0 on failure
+	uint32_m muVGC_load_assigned_expression(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og,
+		muVGCToken* tokens, size_m token_len, muVGCAssignment* assignment, uint32_m type) {
+
+		size_m i = assignment->expression;
+		uint32_m value_type = 0;
+		uint32_m value = muVGC_load_expression(result, module, state, code, og, tokens, token_len, &i, type, 1, &value_type);
+		if (value == 0) {
+			return 0;
+		}
+		if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected operator or semicolon\n") != MU_SUCCESS) {
+			return 0;
+		}
+		if (value_type != type) {
+			muVGC_print_syntax_error(og, tokens[assignment->expression].index);
+			mu_print("assigned value is of a different type\n");
+			*result = MU_FAILURE;
+			return 0;
+		}
+		return value;
+	}
+
+	// Built-in functions without arguments or results
+
+	struct muVGCBarrierFunction {
+		const char* name;
+		size_m namelen;
+		// (OpControlBarrier instead of OpMemoryBarrier)
+		muBool control;
+		// Whether only compute shaders can use it
+		muBool compute_only;
+		uint32_m scope;
+		uint32_m semantics;
+	};
+	typedef struct muVGCBarrierFunction muVGCBarrierFunction;
+
+	#define MUVGC_BARRIER_FUNCTION(name, control, compute_only, scope, semantics) { name, sizeof(name)-1, control, compute_only, scope, MUVGC_MEMORY_SEMANTICS_ACQUIRE_RELEASE | (semantics) }
+	#define MUVGC_ALL_MEMORY (MUVGC_MEMORY_SEMANTICS_UNIFORM_MEMORY | MUVGC_MEMORY_SEMANTICS_WORKGROUP_MEMORY | MUVGC_MEMORY_SEMANTICS_IMAGE_MEMORY)
+
+	const muVGCBarrierFunction muVGC_global_barrier_functions[] = {
+		MUVGC_BARRIER_FUNCTION("barrier", MU_TRUE, MU_TRUE, MUVGC_SCOPE_WORKGROUP, MUVGC_MEMORY_SEMANTICS_WORKGROUP_MEMORY),
+		MUVGC_BARRIER_FUNCTION("memoryBarrier", MU_FALSE, MU_FALSE, MUVGC_SCOPE_DEVICE, MUVGC_ALL_MEMORY),
+		MUVGC_BARRIER_FUNCTION("memoryBarrierBuffer", MU_FALSE, MU_FALSE, MUVGC_SCOPE_DEVICE, MUVGC_MEMORY_SEMANTICS_UNIFORM_MEMORY),
+		MUVGC_BARRIER_FUNCTION("memoryBarrierImage", MU_FALSE, MU_FALSE, MUVGC_SCOPE_DEVICE, MUVGC_MEMORY_SEMANTICS_IMAGE_MEMORY),
+		MUVGC_BARRIER_FUNCTION("memoryBarrierShared", MU_FALSE, MU_TRUE, MUVGC_SCOPE_DEVICE, MUVGC_MEMORY_SEMANTICS_WORKGROUP_MEMORY),
+		MUVGC_BARRIER_FUNCTION("groupMemoryBarrier", MU_FALSE, MU_TRUE, MUVGC_SCOPE_WORKGROUP, MUVGC_ALL_MEMORY),
+		MUVGC_BARRIER_FUNCTION("subgroupBarrier", MU_TRUE, MU_FALSE, MUVGC_SCOPE_SUBGROUP, MUVGC_ALL_MEMORY),
+		MUVGC_BARRIER_FUNCTION("subgroupMemoryBarrier", MU_FALSE, MU_FALSE, MUVGC_SCOPE_SUBGROUP, MUVGC_ALL_MEMORY),
+		MUVGC_BARRIER_FUNCTION("subgroupMemoryBarrierBuffer", MU_FALSE, MU_FALSE, MUVGC_SCOPE_SUBGROUP, MUVGC_MEMORY_SEMANTICS_UNIFORM_MEMORY),
+		MUVGC_BARRIER_FUNCTION("subgroupMemoryBarrierImage", MU_FALSE, MU_FALSE, MUVGC_SCOPE_SUBGROUP, MUVGC_MEMORY_SEMANTICS_IMAGE_MEMORY),
+		MUVGC_BARRIER_FUNCTION("subgroupMemoryBarrierShared", MU_FALSE, MU_TRUE, MUVGC_SCOPE_SUBGROUP, MUVGC_MEMORY_SEMANTICS_WORKGROUP_MEMORY)
+	};
+	#define MUVGC_BARRIER_FUNCTION_COUNT (sizeof(muVGC_global_barrier_functions) / sizeof(muVGCBarrierFunction))
+
+	// Emits a call to a barrier function; returns MU_FALSE if the name isn't
+	// one
+	muBool muVGC_call_barrier_function(
+		muResult* result, muVGCModule* module, muVGCStatementState* state, const char* code, const char* og, muVGCToken name) {
+
+		for (size_m i = 0; i < MUVGC_BARRIER_FUNCTION_COUNT; i++) {
+			const muVGCBarrierFunction* function = &muVGC_global_barrier_functions[i];
+			if (function->namelen != name.length || mu_strncmp(function->name, muVGC_get_token_value(code, name), name.length) != 0) continue;
+
+			if (function->compute_only == MU_TRUE && module->shader != MUVGC_COMPUTE) {
+				muVGC_print_syntax_error(og, name.index);
+				mu_print("function can only be called in compute shaders\n");
+				*result = MU_FAILURE;
+				return MU_TRUE;
+			}
+			if (function->scope == MUVGC_SCOPE_SUBGROUP) {
+				muVGC_require_group_non_uniform(module, MUVGC_CAPABILITY_GROUP_NON_UNIFORM);
+			}
+			if (function->control == MU_TRUE) {
+				muVGC_op_control_barrier(module, state->block, function->scope, function->scope, function->semantics);
+			} else {
+				muVGC_op_memory_barrier(module, state->block, function->scope, function->semantics);
+			}
+			return MU_TRUE;
+		}
+		return MU_FALSE;
+	}
+
+	void muVGC_free_statement_state(muVGCStatementState* state) {
+		if (state->constructs != MU_NULL_PTR) {
+			mu_free(state->constructs);
+			state->constructs = MU_NULL_PTR;
+		}
+		state->construct_len = 0;
+		state->allocated_construct_len = 0;
+		if (state->interface_variables != MU_NULL_PTR) {
+			mu_free(state->interface_variables);
+			state->interface_variables = MU_NULL_PTR;
+		}
+		state->interface_variable_len = 0;
+		state->allocated_interface_variable_len = 0;
+		if (state->constants != MU_NULL_PTR) {
+			mu_free(state->constants);
+			state->constants = MU_NULL_PTR;
+		}
+		state->constant_len = 0;
+		state->allocated_constant_len = 0;
+		if (state->interface_blocks != MU_NULL_PTR) {
+			mu_free(state->interface_blocks);
+			state->interface_blocks = MU_NULL_PTR;
+		}
+		state->interface_block_len = 0;
+		state->allocated_interface_block_len = 0;
+		if (state->block_members != MU_NULL_PTR) {
+			mu_free(state->block_members);
+			state->block_members = MU_NULL_PTR;
+		}
+		state->block_member_len = 0;
+		state->allocated_block_member_len = 0;
+		if (state->local_variables != MU_NULL_PTR) {
+			mu_free(state->local_variables);
+			state->local_variables = MU_NULL_PTR;
+		}
+		state->local_variable_len = 0;
+		state->allocated_local_variable_len = 0;
+	}
+
+	void muVGC_push_construct(muVGCStatementState* state, muVGCConstruct construct) {
+		if (state->construct_len >= state->allocated_construct_len) {
+			state->allocated_construct_len = (state->allocated_construct_len == 0) ? 4 : state->allocated_construct_len*2;
+			state->constructs = mu_realloc(state->constructs, sizeof(muVGCConstruct) * state->allocated_construct_len);
+		}
+		state->constructs[state->construct_len] = construct;
+		state->construct_len += 1;
+	}
+
+	void muVGC_push_interface_variable(muVGCStatementState* state, muVGCInterfaceVariable variable) {
+		if (state->interface_variable_len >= state->allocated_interface_variable_len) {
+			state->allocated_interface_variable_len = (state->allocated_interface_variable_len == 0) ? 4 : state->allocated_interface_variable_len*2;
+			state->interface_variables = mu_realloc(state->interface_variables, sizeof(muVGCInterfaceVariable) * state->allocated_interface_variable_len);
+		}
+		state->interface_variables[state->interface_variable_len] = variable;
+		state->interface_variable_len += 1;
+	}
+
+	void muVGC_push_constant(muVGCStatementState* state, muVGCNamedConstant constant) {
+		if (state->constant_len >= state->allocated_constant_len) {
+			state->allocated_constant_len = (state->allocated_constant_len == 0) ? 4 : state->allocated_constant_len*2;
+			state->constants = mu_realloc(state->constants, sizeof(muVGCNamedConstant) * state->allocated_constant_len);
+		}
+		state->constants[state->constant_len] = constant;
+		state->constant_len += 1;
+	}
+
+	void muVGC_push_interface_block(muVGCStatementState* state, muVGCInterfaceBlock block) {
+		if (state->interface_block_len >= state->allocated_interface_block_len) {
+			state->allocated_interface_block_len = (state->allocated_interface_block_len == 0) ? 4 : state->allocated_interface_block_len*2;
+			state->interface_blocks = mu_realloc(state->interface_blocks, sizeof(muVGCInterfaceBlock) * state->allocated_interface_block_len);
+		}
+		state->interface_blocks[state->interface_block_len] = block;
+		state->interface_block_len += 1;
+	}
+
+	void muVGC_push_block_member(muVGCStatementState* state, muVGCBlockMember member) {
+		if (state->block_member_len >= state->allocated_block_member_len) {
+			state->allocated_block_member_len = (state->allocated_block_member_len == 0) ? 8 : state->allocated_block_member_len*2;
+			state->block_members = mu_realloc(state->block_members, sizeof(muVGCBlockMember) * state->allocated_block_member_len);
+		}
+		state->block_members[state->block_member_len] = member;
+		state->block_member_len += 1;
+	}
+
+	void muVGC_push_local_variable(muVGCStatementState* state, muVGCLocalVariable variable) {
+		if (state->local_variable_len >= state->allocated_local_variable_len) {
+			state->allocated_local_variable_len = (state->allocated_local_variable_len == 0) ? 8 : state->allocated_local_variable_len*2;
+			state->local_variables = mu_realloc(state->local_variables, sizeof(muVGCLocalVariable) * state->allocated_local_variable_len);
+		}
+		state->local_variables[state->local_variable_len] = variable;
+		state->local_variable_len += 1;
+	}
+
+	// Statement type handling
+
+	muResult muVGC_check_statement_type(muResult* result,
+		muVGCStatementType type, muVGCToken* tokens, 
+		size_m token_len, const char* code, const char* og, size_m* length) {
+
+		switch (type) {
+			default: {
+				muVGC_print_syntax_error(og, tokens[0].index);
+				mu_print("unexpected token '");
+				muVGC_print_token_type(tokens[0].type);
+				mu_print("\n");
+				*result = MU_FAILURE;
+				return MU_FAILURE;
+			} break;
+
+			case MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION: {
+				// (p) A A(...
+				size_m q = muVGC_get_function_implementation_offset(tokens, token_len);
+				if (token_len > q+3) {
+					// (return A(...); is a return statement)
+					if (
+						(tokens[q].type == MUVGC_TOKEN_KEYWORD || tokens[q].type == MUVGC_TOKEN_IDENTIFIER) &&
+						muVGC_token_is_keyword(code, tokens[q], "return", 6) == MU_FALSE &&
+						(tokens[q+1].type == MUVGC_TOKEN_IDENTIFIER) &&
+						(tokens[q+2].type == MUVGC_TOKEN_OPEN_PARENTHESIS)
+					) {
+						// A A(...,... ...)
+						size_m i = q+3;
+						while (tokens[i].type != MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+							// Qualifiers
+							size_m qualifier_count = 0;
+							while (
+								tokens[i+qualifier_count].type == MUVGC_TOKEN_KEYWORD &&
+								((tokens[i+qualifier_count].length == 5 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "const", 5) == 0) ||
+								(tokens[i+qualifier_count].length == 2 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "in", 2) == 0) ||
+								(tokens[i+qualifier_count].length == 3 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "out", 3) == 0) ||
+								(tokens[i+qualifier_count].length == 5 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "inout", 5) == 0) ||
+								(tokens[i+qualifier_count].length == 7 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "precise", 7) == 0))
+							) {
+								qualifier_count++;
+							}
+							if (qualifier_count > 2) {
+								muVGC_print_syntax_error(og, tokens[i+3].index);
+								mu_print("too many storage qualifiers\n");
+								*result = MU_FAILURE;
+								return MU_FAILURE;
+							}
+							i += qualifier_count;
+							if (muVGC_get_precision_qualifier(tokens[i]) != MUVGC_PRECISION_NONE) {
+								i++;
+							}
+
+							// Type
+							if (tokens[i].type != MUVGC_TOKEN_KEYWORD && tokens[i].type != MUVGC_TOKEN_IDENTIFIER) {
+								muVGC_print_syntax_error(og, tokens[i].index);
+								mu_print("expected keyword or identifier\n");
+								*result = MU_FAILURE;
+								return MU_FAILURE;
+							}
+							i++;
+
+							// Name
+							if (tokens[i].type != MUVGC_TOKEN_IDENTIFIER) {
+								muVGC_print_syntax_error(og, tokens[i].index);
+								mu_print("expected identifier\n");
+								*result = MU_FAILURE;
+								return MU_FAILURE;
+							}
+							i++;
+
+							// Array
+							if (tokens[i].type == MUVGC_TOKEN_OPEN_SQUARE_BRACKET) {
+								if (tokens[i+1].type != MUVGC_TOKEN_INTEGER_CONSTANT) {
+									muVGC_print_syntax_error(og, tokens[i+1].index);
+									mu_print("expected integer after '['\n");
+									*result = MU_FAILURE;
+									return MU_FAILURE;
+								}
+								if (tokens[i+2].type != MUVGC_TOKEN_CLOSE_SQUARE_BRACKET) {
+									muVGC_print_syntax_error(og, tokens[i+2].index);
+									mu_print("expected ']' after integer\n");
+									*result = MU_FAILURE;
+									return MU_FAILURE;
+								}
+								i += 3;
+							}
+
+							// End of parameter
+							if (tokens[i].type == MUVGC_TOKEN_COMMA) {
+								i++;
+							} else if (tokens[i].type != MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+								muVGC_print_syntax_error(og, tokens[i].index);
+								mu_print("expected comma or close parenthesis\n");
+								*result = MU_FAILURE;
+								return MU_FAILURE;
+							}
+						}
+						// A A(){...
+						// A A();
+						if (tokens[i+1].type != MUVGC_TOKEN_SEMICOLON && tokens[i+1].type != MUVGC_TOKEN_OPEN_BRACE) {
+							muVGC_print_syntax_error(og, tokens[i+1].index);
+							mu_print("expected semicolon or open brace\n");
+							*result = MU_FAILURE;
+							return MU_FAILURE;
+						} else if (tokens[i+1].type == MUVGC_TOKEN_OPEN_BRACE) {
+							*length = i+2;
+							return MU_SUCCESS;
+						}
+						return MU_FAILURE;
+					}
+				}
+				return MU_FAILURE;
+			} break;
+
+			case MUVGC_STATEMENT_SCOPE_OPEN: {
+				if (tokens[0].type == MUVGC_TOKEN_OPEN_BRACE) {
+					*length = 1;
+					return MU_SUCCESS;
+				}
+				return MU_FAILURE;
+			} break;
+
+			case MUVGC_STATEMENT_SCOPE_CLOSE: {
+				// (} else { is its own statement)
+				if (tokens[0].type == MUVGC_TOKEN_CLOSE_BRACE &&
+					(token_len < 2 || muVGC_token_is_keyword(code, tokens[1], "else", 4) == MU_FALSE)) {
+					*length = 1;
+					return MU_SUCCESS;
+				}
+				return MU_FAILURE;
+			} break;
+
+			case MUVGC_STATEMENT_ATTRIBUTE: {
+				// [[A, A...]]
+				if (token_len > 1 && tokens[0].type == MUVGC_TOKEN_OPEN_SQUARE_BRACKET && tokens[1].type == MUVGC_TOKEN_OPEN_SQUARE_BRACKET) {
+					size_m i = 2;
+					while (MU_TRUE) {
+						if (i >= token_len || (
+							tokens[i].type != MUVGC_TOKEN_IDENTIFIER && tokens[i].type != MUVGC_TOKEN_KEYWORD &&
+							tokens[i].type != MUVGC_TOKEN_RESERVED_KEYWORD)) {
+							muVGC_print_syntax_error(og, tokens[(i >= token_len) ? token_len-1 : i].index);
+							mu_print("expected attribute name\n");
+							*result = MU_FAILURE;
+							return MU_FAILURE;
+						}
+						i++;
+						if (i < token_len && tokens[i].type == MUVGC_TOKEN_COMMA) {
+							i++;
+							continue;
+						}
+						break;
+					}
+					if (i+1 >= token_len || tokens[i].type != MUVGC_TOKEN_CLOSE_SQUARE_BRACKET || tokens[i+1].type != MUVGC_TOKEN_CLOSE_SQUARE_BRACKET) {
+						muVGC_print_syntax_error(og, tokens[(i >= token_len) ? token_len-1 : i].index);
+						mu_print("expected ']]' after attributes\n");
+						*result = MU_FAILURE;
+						return MU_FAILURE;
+					}
+					*length = i+2;
+					return MU_SUCCESS;
+				}
+				return MU_FAILURE;
+			} break;
+
+			case MUVGC_STATEMENT_FOR_LOOP: {
+				muVGCForLoop loop;
+				return muVGC_get_for_loop(result, tokens, token_len, code, og, &loop, length);
+			} break;
+
+			case MUVGC_STATEMENT_IF: {
+				muVGCIfStatement statement;
+				return muVGC_get_if_statement(result, tokens, token_len, code, og, &statement, length);
+			} break;
+
+			case MUVGC_STATEMENT_ELSE: {
+				// } else {
+				if (token_len > 1 && tokens[0].type == MUVGC_TOKEN_CLOSE_BRACE && muVGC_token_is_keyword(code, tokens[1], "else", 4) == MU_TRUE) {
+					// @TODO else if
+					if (muVGC_expect_token(result, tokens, token_len, og, 2, MUVGC_TOKEN_OPEN_BRACE, "expected '{' after else\n") != MU_SUCCESS) {
+						return MU_FAILURE;
+					}
+					*length = 3;
+					return MU_SUCCESS;
+				}
+				return MU_FAILURE;
+			} break;
+
+			case MUVGC_STATEMENT_PRECISION: {
+				// precision p A;
+				if (muVGC_token_is_keyword(code, tokens[0], "precision", 9) == MU_TRUE) {
+					if (token_len < 2 || muVGC_get_precision_qualifier(tokens[1]) == MUVGC_PRECISION_NONE) {
+						muVGC_print_syntax_error(og, tokens[(token_len < 2) ? 0 : 1].index);
+						mu_print("expected precision qualifier\n");
+						*result = MU_FAILURE;
+						return MU_FAILURE;
+					}
+					if (muVGC_expect_token(result, tokens, token_len, og, 2, MUVGC_TOKEN_KEYWORD, "expected type after precision qualifier\n") != MU_SUCCESS) {
+						return MU_FAILURE;
+					}
+					if (muVGC_expect_token(result, tokens, token_len, og, 3, MUVGC_TOKEN_SEMICOLON, "expected semicolon after precision statement\n") != MU_SUCCESS) {
+						return MU_FAILURE;
+					}
+					*length = 4;
+					return MU_SUCCESS;
+				}
+				return MU_FAILURE;
+			} break;
+
+			case MUVGC_STATEMENT_LAYOUT_IN: {
+				return muVGC_get_layout_in(result, tokens, token_len, code, og, length);
+			} break;
+
+			case MUVGC_STATEMENT_SHARED_VARIABLE: {
+				muVGCSharedVariable variable;
+				return muVGC_get_shared_variable(result, tokens, token_len, code, og, &variable, length);
+			} break;
+
+			case MUVGC_STATEMENT_INTERFACE_VARIABLE: {
+				muVGCInterfaceDeclaration declaration;
+				return muVGC_get_interface_declaration(result, tokens, token_len, code, og, &declaration, length);
+			} break;
+
+			case MUVGC_STATEMENT_ASSIGNMENT: {
+				muVGCAssignment assignment;
+				return muVGC_get_assignment(result, tokens, token_len, og, &assignment, length);
+			} break;
+
+			case MUVGC_STATEMENT_CONSTANT: {
+				muVGCConstantDeclaration declaration;
+				return muVGC_get_constant_declaration(result, tokens, token_len, code, og, &declaration, length);
+			} break;
+
+			case MUVGC_STATEMENT_BLOCK: {
+				muVGCBlockDeclaration declaration;
+				return muVGC_get_block_declaration(result, tokens, token_len, code, og, &declaration, length);
+			} break;
+
+			case MUVGC_STATEMENT_LOCAL_VARIABLE: {
+				muVGCLocalDeclaration declaration;
+				return muVGC_get_local_declaration(result, tokens, token_len, code, og, &declaration, length);
+			} break;
+
+			case MUVGC_STATEMENT_RETURN: {
+				// return; or return E;
+				if (muVGC_token_is_keyword(code, tokens[0], "return", 6) == MU_TRUE) {
+					size_m end = 1;
+					if ((token_len < 2 || tokens[1].type != MUVGC_TOKEN_SEMICOLON) &&
+						muVGC_find_expression_end(result, tokens, token_len, og, 1, "expected semicolon after return statement\n", &end) != MU_SUCCESS) {
+						return MU_FAILURE;
+					}
+					*length = end+1;
+					return MU_SUCCESS;
+				}
+				return MU_FAILURE;
+			} break;
+
+			case MUVGC_STATEMENT_FUNCTION_CALL: {
+				// A();
+				if (token_len > 3 &&
+					tokens[0].type == MUVGC_TOKEN_IDENTIFIER &&
+					tokens[1].type == MUVGC_TOKEN_OPEN_PARENTHESIS
+				) {
+					// @TODO Arguments
+					if (tokens[2].type != MUVGC_TOKEN_CLOSE_PARENTHESIS) {
+						muVGC_print_syntax_error(og, tokens[2].index);
+						mu_print("function call arguments are not supported yet\n");
+						*result = MU_FAILURE;
+						return MU_FAILURE;
+					}
+					if (tokens[3].type != MUVGC_TOKEN_SEMICOLON) {
+						muVGC_print_syntax_error(og, tokens[3].index);
+						mu_print("expected semicolon after function call\n");
+						*result = MU_FAILURE;
+						return MU_FAILURE;
+					}
+					*length = 4;
+					return MU_SUCCESS;
+				}
+				return MU_FAILURE;
+			} break;
+		}
+	}
+
+	void muVGC_execute_statement_type(
+		muResult* result, muVGCStatementType type, muVGCToken* tokens, 
+		size_m token_len, const char* code, const char* og, muVGCModule* module,
+		muVGCStatementState* state, muVGCVariableList* varlist) {
+
+		//muResult res = MU_SUCCESS;
+
+		switch (type) {
+			default: *result = MU_FAILURE; return; break;
+
+			case MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION: {
+				// @TODO check for variable name duplication here
+				size_m q = muVGC_get_function_implementation_offset(tokens, token_len);
+
+				if (state->scope_count != 0) {
+					muVGC_print_syntax_error(og, tokens[q+1].index);
+					mu_print("functions can only be implemented at global scope\n");
+					*result = MU_FAILURE;
+					return;
+				}
+
+				muVGCBasicType return_type = muVGC_get_basic_type(muVGC_get_token_value(code, tokens[q]), tokens[q].length);
+				if (return_type == MUVGC_TYPE_UNKNOWN) {
+					// @TODO add struct checking
+					muVGC_print_syntax_error(og, tokens[q].index);
+					mu_print("unrecognized type specified\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (return_type < MUVGC_TRANSPARENT_TYPE_FIRST || return_type > MUVGC_TRANSPARENT_TYPE_LAST) {
+					muVGC_print_syntax_error(og,tokens[q].index);
+					mu_print("only transparent types can be used as a return value\n");
+					*result = MU_FAILURE;
+					return;
+				}
+
+				uint32_m return_type_id = muVGC_get_transparent_type(module, return_type);
+				if (return_type_id == 0) {
+					// This should never trigger but still
+					muVGC_print_syntax_error(og, tokens[q].index);
+					mu_print("failed to declare type\n");
+					*result = MU_FAILURE;
+					return;
+				}
+
+				// @TODO Find a clean way (or way at all) to gather parameters
+				size_m parameter_count = 0;
+				uint32_m function_type = muVGC_get_function_type(module, return_type_id, MU_NULL_PTR, 0);
+				uint32_m function_id = 0;
+				if (tokens[q+1].length == 4 && mu_strncmp(muVGC_get_token_value(code, tokens[q+1]), "main", 4) == 0) {
+					// (Id reserved by the entry point)
+					function_id = module->entry_point;
+				} else {
+					function_id = muVGC_module_new_id(module);
+				}
+				uint32_m function_control = MUVGC_FUNCTION_CONTROL_NONE;
+				if ((state->attributes & MUVGC_ATTRIBUTE_INLINE) != 0) {
+					function_control |= MUVGC_FUNCTION_CONTROL_INLINE;
+				}
+				if ((state->attributes & MUVGC_ATTRIBUTE_DONT_INLINE) != 0) {
+					function_control |= MUVGC_FUNCTION_CONTROL_DONT_INLINE;
+				}
+				size_m function = muVGC_op_function(module, function_id, return_type_id, function_control, function_type);
+				muVGC_op_name(module, function_id, muVGC_get_token_value(code, tokens[q+1]), tokens[q+1].length);
+				if (return_type != MUVGC_TYPE_VOID && muVGC_is_relaxed_precision(state, muVGC_get_precision_qualifier(tokens[0]), return_type) == MU_TRUE) {
+					muVGC_op_decorate(module, function_id, MUVGC_DECORATION_RELAXED_PRECISION);
+				}
+				state->function = function;
+				state->block = muVGC_op_label(module, function, muVGC_module_new_id(module));
+				state->return_type = return_type;
+
+				for (size_m i = 0; i < varlist->len; i++) {
+					if (varlist->variables[i].active == MU_TRUE && 
+						varlist->variables[i].token_name.length == tokens[q+1].length &&
+						mu_strncmp(muVGC_get_token_value(code, varlist->variables[i].token_name), muVGC_get_token_value(code, tokens[q+1]), tokens[q+1].length) == 0) {
+
+						if (varlist->variables[i].is_function == MU_FALSE) {
+							muVGC_print_syntax_error(og, tokens[q+1].index);
+							mu_print("variable declared again as function\n");
+							*result = MU_FAILURE;
+							return;
+						}
+
+						if (varlist->variables[i].is_function_implemented == MU_TRUE) {
+							muVGC_print_syntax_error(og, tokens[q+1].index);
+							mu_print("function implemented numerous times\n");
+							*result = MU_FAILURE;
+							return;
+						}
+
+						if (varlist->variables[i].type != return_type) {
+							muVGC_print_syntax_error(og, tokens[q+1].index);
+							mu_print("function redeclared with different return type\n");
+							*result = MU_FAILURE;
+							return;
+						}
+
+						if (varlist->variables[i].parameterlen != parameter_count) {
+							muVGC_print_syntax_error(og, tokens[q+1].index);
+							mu_print("function redeclared with different number of parameters\n");
+							*result = MU_FAILURE;
+							return;
+						}
+
+						// @TODO check for parameter equivalence
+						/*for (size_m j = 0; j < parameter_count; j++) {
+							if (muVGC_are_two_parameters_equivalent(code, varlist->variables[i].parameters[j], ))
+						}*/
+					}
+				}
+
+				*varlist = muVGC_add_variable(*varlist, muVGC_make_variable(MU_TRUE, return_type, tokens[q+1], MU_FALSE, 0, MU_TRUE, 0, MU_TRUE, MU_NULL_PTR, 0, function_id));
+
+				state->scope_count += 1;
+				return;
+			} break;
+
+			case MUVGC_STATEMENT_SCOPE_OPEN: {
+				state->scope_count += 1;
+				return;
+			} break;
+
+			case MUVGC_STATEMENT_SCOPE_CLOSE: {
+				if (state->scope_count == 0) {
+					muVGC_print_syntax_error(og, tokens[0].index);
+					mu_print("too many close braces\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				state->scope_count -= 1;
+
+				if (state->construct_len > 0 && state->constructs[state->construct_len-1].scope == state->scope_count) {
+					muVGCConstruct construct = state->constructs[state->construct_len-1];
+					state->construct_len -= 1;
+
+					switch (construct.type) {
+						// End of a for loop: continue target (incrementing the loop
+						// variable) and merge block, which code after the loop goes to
+						case MUVGC_CONSTRUCT_LOOP: {
+							uint32_m int_type = muVGC_get_int_type(module, 32, 1);
+							if (state->returned == MU_FALSE) {
+								muVGC_op_branch(module, state->block, construct.continue_label);
+							}
+							size_m continue_block = muVGC_op_label(module, state->function, construct.continue_label);
+							uint32_m value = muVGC_op_load(module, continue_block, int_type, construct.variable);
+							if (construct.relaxed == MU_TRUE) {
+								muVGC_op_decorate(module, value, MUVGC_DECORATION_RELAXED_PRECISION);
+							}
+							value = muVGC_op_binary(module, continue_block, MUVGC_OP_I_ADD, int_type, value, muVGC_get_scalar_constant(module, int_type, construct.step));
+							if (construct.relaxed == MU_TRUE) {
+								muVGC_op_decorate(module, value, MUVGC_DECORATION_RELAXED_PRECISION);
+							}
+							muVGC_op_store(module, continue_block, construct.variable, value);
+							muVGC_op_branch(module, continue_block, construct.header_label);
+						} break;
+
+						// End of an if statement: without an else, its condition
+						// being false goes straight to the merge block
+						case MUVGC_CONSTRUCT_SELECTION: {
+							if (construct.has_else == MU_FALSE) {
+								muVGC_module_get_operands(module, construct.branch)[2].word = construct.merge_label;
+							}
+							if (state->returned == MU_FALSE) {
+								muVGC_op_branch(module, state->block, construct.merge_label);
+							}
+						} break;
+					}
+					state->block = muVGC_op_label(module, state->function, construct.merge_label);
+					state->returned = MU_FALSE;
+				}
+				muVGC_close_local_variables(state, state->scope_count);
+
+				// End of a function implementation
+				if (state->scope_count == 0) {
+					if (state->returned == MU_TRUE) {
+						state->returned = MU_FALSE;
+					} else if (state->return_type == MUVGC_TYPE_VOID) {
+						muVGC_op_return(module, state->block);
+					} else {
+						// (Falling off the end of a non-void function gives an
+						// undefined value, as GLSL leaves it undefined)
+						uint32_m return_type_id = muVGC_get_transparent_type(module, state->return_type);
+						muVGC_op_return_value(module, state->block, muVGC_get_undef(module, return_type_id));
+					}
+				}
+				return;
+			} break;
+
+			case MUVGC_STATEMENT_ATTRIBUTE: {
+				for (size_m i = 2; tokens[i].type != MUVGC_TOKEN_CLOSE_SQUARE_BRACKET; i += 2) {
+					state->attributes |= muVGC_get_attribute(tokens[i]);
+					if (muVGC_attributes_conflict(state->attributes) == MU_TRUE) {
+						muVGC_print_syntax_error(og, tokens[i].index);
+						mu_print("conflicting attributes\n");
+						*result = MU_FAILURE;
+						return;
+					}
+				}
+				return;
+			} break;
+
+			case MUVGC_STATEMENT_FOR_LOOP: {
+				if (state->scope_count == 0) {
+					muVGC_print_syntax_error(og, tokens[0].index);
+					mu_print("for loop outside of a function\n");
+					*result = MU_FAILURE;
+					return;
+				}
+
+				muVGCForLoop loop;
+				size_m length = 0;
+				muVGC_get_for_loop(result, tokens, token_len, code, og, &loop, &length);
+
+				uint32_m loop_control = MUVGC_LOOP_CONTROL_NONE;
+				if ((state->attributes & MUVGC_ATTRIBUTE_UNROLL) != 0) {
+					loop_control |= MUVGC_LOOP_CONTROL_UNROLL;
+				}
+				if ((state->attributes & MUVGC_ATTRIBUTE_DONT_UNROLL) != 0) {
+					loop_control |= MUVGC_LOOP_CONTROL_DONT_UNROLL;
+				}
+				if ((state->attributes & MUVGC_ATTRIBUTE_DEPENDENCY_INFINITE) != 0) {
+					loop_control |= MUVGC_LOOP_CONTROL_DEPENDENCY_INFINITE;
+				}
+
+				// @TODO Add the loop variable to the variable list once
+				// expressions can refer to it
+				uint32_m int_type = muVGC_get_int_type(module, 32, 1);
+				// (0 if it's a literal)
+				uint32_m bound_constant = 0;
+				if (loop.bound_token.type == MUVGC_TOKEN_IDENTIFIER) {
+					muVGCNamedConstant* constant = muVGC_find_constant(state, code, loop.bound_token);
+					if (constant == MU_NULL_PTR || constant->type != int_type) {
+						muVGC_print_syntax_error(og, loop.bound_token.index);
+						mu_print("loop bounds must be integer literals or int constants\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					bound_constant = constant->id;
+				}
+				muVGCConstruct construct = { 0 };
+				construct.type = MUVGC_CONSTRUCT_LOOP;
+				construct.scope = state->scope_count;
+				construct.name = loop.name;
+				construct.step = loop.step;
+				construct.variable = muVGC_op_function_variable(module, state->function, muVGC_get_pointer_type(module, MUVGC_STORAGE_CLASS_FUNCTION, int_type));
+				muVGC_op_name(module, construct.variable, muVGC_get_token_value(code, loop.name), loop.name.length);
+				construct.relaxed = muVGC_is_relaxed_precision(state, loop.precision, MUVGC_TYPE_INT);
+				if (construct.relaxed == MU_TRUE) {
+					muVGC_op_decorate(module, construct.variable, MUVGC_DECORATION_RELAXED_PRECISION);
+				}
+				construct.header_label = muVGC_module_new_id(module);
+				construct.continue_label = muVGC_module_new_id(module);
+				construct.merge_label = muVGC_module_new_id(module);
+				uint32_m body_label = muVGC_module_new_id(module);
+
+				muVGC_op_store(module, state->block, construct.variable, muVGC_get_scalar_constant(module, int_type, loop.init));
+				muVGC_op_branch(module, state->block, construct.header_label);
+
+				// Header: check the condition, then go to the body or exit
+				size_m header = muVGC_op_label(module, state->function, construct.header_label);
+				uint32_m value = muVGC_op_load(module, header, int_type, construct.variable);
+				if (construct.relaxed == MU_TRUE) {
+					muVGC_op_decorate(module, value, MUVGC_DECORATION_RELAXED_PRECISION);
+				}
+				uint32_m bound = (bound_constant != 0) ? bound_constant : muVGC_get_scalar_constant(module, int_type, loop.bound);
+				uint32_m condition = muVGC_op_binary(module, header, loop.comparison, muVGC_get_bool_type(module), value, bound);
+				muVGC_op_loop_merge(module, header, construct.merge_label, construct.continue_label, loop_control);
+				muVGC_op_branch_conditional(module, header, condition, body_label, construct.merge_label);
+				state->block = muVGC_op_label(module, state->function, body_label);
+
+				muVGC_push_construct(state, construct);
+
+				state->scope_count += 1;
+				return;
+			} break;
+
+			case MUVGC_STATEMENT_IF: {
+				if (state->scope_count == 0) {
+					muVGC_print_syntax_error(og, tokens[0].index);
+					mu_print("if statement outside of a function\n");
+					*result = MU_FAILURE;
+					return;
+				}
+
+				muVGCIfStatement statement;
+				size_m length = 0;
+				muVGC_get_if_statement(result, tokens, token_len, code, og, &statement, &length);
+
+				uint32_m condition = 0;
+				if (statement.is_constant == MU_TRUE) {
+					condition = muVGC_get_bool_constant(module, statement.value);
+				} else if (statement.is_boolean == MU_TRUE && statement.a.is_call == MU_TRUE) {
+					uint32_m type = 0;
+					condition = muVGC_load_call(result, module, state, code, og, &statement.a.call, 0, &type);
+					if (condition == 0) {
+						return;
+					}
+					if (type != muVGC_get_bool_type(module)) {
+						muVGC_print_syntax_error(og, statement.a.call.name.index);
+						mu_print("conditions without a comparison must be boolean\n");
+						*result = MU_FAILURE;
+						return;
+					}
+				} else if (statement.is_boolean == MU_TRUE) {
+					uint32_m type = 0;
+					condition = muVGC_load_input(module, state, code, statement.a.reference.name, &type);
+					if (condition == 0 || type != muVGC_get_bool_type(module)) {
+						muVGC_print_syntax_error(og, statement.a.reference.name.index);
+						mu_print("conditions without a comparison must be boolean constants\n");
+						*result = MU_FAILURE;
+						return;
+					}
+				} else {
+					uint32_m int_type = muVGC_get_int_type(module, 32, 1);
+					uint32_m uint_type = muVGC_get_int_type(module, 32, 0);
+					uint32_m operands[2] = { 0, 0 };
+					muVGCConditionOperand* condition_operands[2] = { &statement.a, &statement.b };
+					// (Constants compared with an unsigned variable are unsigned too)
+					muBool is_unsigned = MU_FALSE;
+					for (size_m o = 0; o < 2; o++) {
+						if (condition_operands[o]->is_variable == MU_FALSE) continue;
+						muBool operand_is_unsigned = MU_FALSE;
+						operands[o] = muVGC_load_condition_variable(result, module, state, code, og, condition_operands[o], &operand_is_unsigned);
+						if (operands[o] == 0) {
+							return;
+						}
+						if (operand_is_unsigned == MU_TRUE) {
+							is_unsigned = MU_TRUE;
+						}
+					}
+					for (size_m o = 0; o < 2; o++) {
+						if (condition_operands[o]->is_variable == MU_FALSE) {
+							operands[o] = muVGC_get_scalar_constant(module, (is_unsigned == MU_TRUE) ? uint_type : int_type, condition_operands[o]->value);
+						}
+					}
+					uint16_m comparison = (is_unsigned == MU_TRUE) ? muVGC_get_unsigned_comparison(statement.comparison) : statement.comparison;
+					condition = muVGC_op_binary(module, state->block, comparison, muVGC_get_bool_type(module), operands[0], operands[1]);
+				}
+
+				uint32_m selection_control = MUVGC_SELECTION_CONTROL_NONE;
+				if ((state->attributes & MUVGC_ATTRIBUTE_FLATTEN) != 0) {
+					selection_control |= MUVGC_SELECTION_CONTROL_FLATTEN;
+				}
+				if ((state->attributes & MUVGC_ATTRIBUTE_BRANCH) != 0) {
+					selection_control |= MUVGC_SELECTION_CONTROL_DONT_FLATTEN;
+				}
+
+				muVGCConstruct construct = { 0 };
+				construct.type = MUVGC_CONSTRUCT_SELECTION;
+				construct.scope = state->scope_count;
+				construct.merge_label = muVGC_module_new_id(module);
+				construct.else_label = muVGC_module_new_id(module);
+				uint32_m then_label = muVGC_module_new_id(module);
+
+				muVGC_op_selection_merge(module, state->block, construct.merge_label, selection_control);
+				muVGC_op_branch_conditional(module, state->block, condition, then_label, construct.else_label);
+				muVGCIndexList* instructions = &module->blocks[state->block].instructions;
+				construct.branch = instructions->indexes[instructions->len-1];
+				state->block = muVGC_op_label(module, state->function, then_label);
+
+				muVGC_push_construct(state, construct);
+				state->scope_count += 1;
+				return;
+			} break;
+
+			case MUVGC_STATEMENT_ELSE: {
+				if (state->construct_len == 0 || state->scope_count == 0 ||
+					state->constructs[state->construct_len-1].scope != state->scope_count-1 ||
+					state->constructs[state->construct_len-1].type != MUVGC_CONSTRUCT_SELECTION ||
+					state->constructs[state->construct_len-1].has_else == MU_TRUE) {
+					muVGC_print_syntax_error(og, tokens[1].index);
+					mu_print("else without a matching if\n");
+					*result = MU_FAILURE;
+					return;
+				}
+
+				// (The scope closes and reopens, so scope_count stays the same)
+				muVGC_close_local_variables(state, state->scope_count-1);
+				muVGCConstruct* construct = &state->constructs[state->construct_len-1];
+				construct->has_else = MU_TRUE;
+				if (state->returned == MU_FALSE) {
+					muVGC_op_branch(module, state->block, construct->merge_label);
+				}
+				state->block = muVGC_op_label(module, state->function, construct->else_label);
+				state->returned = MU_FALSE;
+				return;
+			} break;
 
-/* STATEMENT TYPE HANDLING */
+			case MUVGC_STATEMENT_PRECISION: {
+				// @TODO Scope default precision to the block it's declared in
+				muVGCBasicType type = muVGC_get_basic_type(muVGC_get_token_value(code, tokens[2]), tokens[2].length);
+				if (type != MUVGC_TYPE_INT && type != MUVGC_TYPE_FLOAT) {
+					muVGC_print_syntax_error(og, tokens[2].index);
+					mu_print("default precision can only be set for int and float\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				state->default_precisions[muVGC_get_precision_type(type)] = muVGC_get_precision_qualifier(tokens[1]);
+				return;
+			} break;
 
-	// Statement types
+			case MUVGC_STATEMENT_LAYOUT_IN: {
+				for (size_m i = 2; tokens[i-1].type != MUVGC_TOKEN_CLOSE_PARENTHESIS; i++) {
+					muVGCToken name = tokens[i];
+					i += 2;
+					uint32_m value = 0;
+					muVGC_get_integer_literal(result, tokens, token_len, code, og, &i, &value);
+
+					size_m qualifier = 0;
+					while (qualifier < 6) {
+						const char* qualifier_name = muVGC_global_local_size_qualifiers[qualifier];
+						if (mu_strlen(qualifier_name) == name.length && mu_strncmp(qualifier_name, muVGC_get_token_value(code, name), name.length) == 0) break;
+						qualifier++;
+					}
+					if (qualifier == 6) {
+						muVGC_print_syntax_error(og, name.index);
+						mu_print("unrecognized layout qualifier\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					if (module->shader != MUVGC_COMPUTE) {
+						muVGC_print_syntax_error(og, name.index);
+						mu_print("local size can only be declared in compute shaders\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					if (qualifier < 3 && value == 0) {
+						muVGC_print_syntax_error(og, name.index);
+						mu_print("local size must be at least 1\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					if (state->workgroup_size != 0) {
+						muVGC_print_syntax_error(og, name.index);
+						mu_print("local size declared after gl_WorkGroupSize was used\n");
+						*result = MU_FAILURE;
+						return;
+					}
 
-	enum muVGCStatementType {
-		MUVGC_STATEMENT_UNKNOWN=0,
-		MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION=1,
-		MUVGC_STATEMENT_SCOPE_OPEN=2,
-		MUVGC_STATEMENT_SCOPE_CLOSE=3
+					uint32_m* declared = (qualifier < 3) ? &state->local_size[qualifier] : &state->local_size_spec_ids[qualifier-3];
+					uint32_m stored = (qualifier < 3) ? value : value+1;
+					if (*declared != 0 && *declared != stored) {
+						muVGC_print_syntax_error(og, name.index);
+						mu_print("conflicting local size declarations\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					muVGCNamedConstant* constant = (qualifier < 3) ? MU_NULL_PTR : muVGC_find_spec_constant(state, stored);
+					if (constant != MU_NULL_PTR && constant->type != muVGC_get_int_type(module, 32, 0)) {
+						muVGC_print_syntax_error(og, name.index);
+						mu_print("specialization constants of the local size must be uints\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					*declared = stored;
+				}
+				return;
+			} break;
 
-		#define MUVGC_STATEMENT_FIRST MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION
-		#define MUVGC_STATEMENT_LAST  MUVGC_STATEMENT_SCOPE_CLOSE
-	};
-	typedef enum muVGCStatementType muVGCStatementType;
+			case MUVGC_STATEMENT_SHARED_VARIABLE: {
+				muVGCSharedVariable variable;
+				size_m length = 0;
+				muVGC_get_shared_variable(result, tokens, token_len, code, og, &variable, &length);
 
-	// @DEBUG
-	void muVGC_print_statement_type(muVGCStatementType type) {
-		switch (type) {
-			default: mu_print("unknown"); break;
-			case MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION: mu_print("function implementation"); break;
-			case MUVGC_STATEMENT_SCOPE_OPEN: mu_print("scope open"); break;
-			case MUVGC_STATEMENT_SCOPE_CLOSE: mu_print("scope close"); break;
-		}
-	}
+				if (module->shader != MUVGC_COMPUTE) {
+					muVGC_print_syntax_error(og, tokens[0].index);
+					mu_print("shared variables can only be declared in compute shaders\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (state->scope_count != 0) {
+					muVGC_print_syntax_error(og, tokens[0].index);
+					mu_print("shared variables can only be declared at global scope\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				muVGCBasicType type = muVGC_get_basic_type(muVGC_get_token_value(code, variable.type), variable.type.length);
+				if (type == MUVGC_TYPE_VOID || type < MUVGC_TRANSPARENT_TYPE_FIRST || type > MUVGC_TRANSPARENT_TYPE_LAST) {
+					muVGC_print_syntax_error(og, variable.type.index);
+					mu_print("only non-void transparent types can be shared\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (variable.is_array == MU_TRUE && (variable.length == 0 || variable.length > 0x7FFFFFFF)) {
+					muVGC_print_syntax_error(og, variable.name.index);
+					mu_print("array size must be positive\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				for (size_m i = 0; i < varlist->len; i++) {
+					if (varlist->variables[i].active == MU_TRUE &&
+						varlist->variables[i].token_name.length == variable.name.length &&
+						mu_strncmp(muVGC_get_token_value(code, varlist->variables[i].token_name), muVGC_get_token_value(code, variable.name), variable.name.length) == 0) {
+						muVGC_print_syntax_error(og, variable.name.index);
+						mu_print("variable name already in use\n");
+						*result = MU_FAILURE;
+						return;
+					}
+				}
 
-	// Statement type handling
+				uint32_m type_id = muVGC_get_transparent_type(module, type);
+				if (variable.is_array == MU_TRUE) {
+					type_id = muVGC_get_array_type(module, type_id, muVGC_get_scalar_constant(module, muVGC_get_int_type(module, 32, 0), variable.length));
+				}
+				uint32_m id = muVGC_op_global_variable(module, MUVGC_STORAGE_CLASS_WORKGROUP, muVGC_get_pointer_type(module, MUVGC_STORAGE_CLASS_WORKGROUP, type_id));
+				muVGC_op_name(module, id, muVGC_get_token_value(code, variable.name), variable.name.length);
+				*varlist = muVGC_add_variable(*varlist, muVGC_make_variable(MU_TRUE, type, variable.name, variable.is_array, variable.length, MU_FALSE, 0, MU_FALSE, MU_NULL_PTR, 0, id));
+				return;
+			} break;
 
-	muResult muVGC_check_statement_type(muResult* result,
-		muVGCStatementType type, muVGCToken* tokens, 
-		size_m token_len, const char* code, const char* og, size_m* length) {
+			case MUVGC_STATEMENT_INTERFACE_VARIABLE: {
+				muVGCInterfaceDeclaration declaration;
+				size_m length = 0;
+				muVGC_get_interface_declaration(result, tokens, token_len, code, og, &declaration, &length);
 
-		switch (type) {
-			default: {
-				muVGC_print_syntax_error(og, tokens[0].index);
-				mu_print("unexpected token '");
-				muVGC_print_token_type(tokens[0].type);
-				mu_print("\n");
-				*result = MU_FAILURE;
-				return MU_FAILURE;
+				if (module->shader == MUVGC_COMPUTE) {
+					muVGC_print_syntax_error(og, declaration.name.index);
+					mu_print("compute shaders can't declare inputs or outputs\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (state->scope_count != 0) {
+					muVGC_print_syntax_error(og, declaration.name.index);
+					mu_print("inputs and outputs can only be declared at global scope\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				muVGCBasicType type = muVGC_get_basic_type(muVGC_get_token_value(code, declaration.type), declaration.type.length);
+				if (type == MUVGC_TYPE_VOID || type < MUVGC_TRANSPARENT_TYPE_FIRST || type > MUVGC_TRANSPARENT_TYPE_LAST) {
+					muVGC_print_syntax_error(og, declaration.type.index);
+					mu_print("only non-void transparent types can be inputs or outputs\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				uint32_m type_id = muVGC_get_transparent_type(module, type);
+				muVGCFootprint footprint = muVGC_get_footprint(module, type_id);
+				if (footprint.kind == 0) {
+					muVGC_print_syntax_error(og, declaration.type.index);
+					mu_print("booleans can't be inputs or outputs\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (muVGC_type_contains_width(module, type_id, 8) == MU_TRUE) {
+					muVGC_print_syntax_error(og, declaration.type.index);
+					mu_print("8-bit types can't be inputs or outputs\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (declaration.component != 0 && declaration.location == 0) {
+					muVGC_print_syntax_error(og, declaration.name.index);
+					mu_print("component can only be given along with a location\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				muBool is_input = (declaration.storage_class == MUVGC_STORAGE_CLASS_INPUT) ? MU_TRUE : MU_FALSE;
+				if (declaration.has_interpolation == MU_TRUE &&
+					((module->shader == MUVGC_VERTEX && is_input == MU_TRUE) || (module->shader == MUVGC_FRAGMENT && is_input == MU_FALSE))) {
+					muVGC_print_syntax_error(og, declaration.name.index);
+					mu_print("interpolation qualifiers can't be used on vertex inputs or fragment outputs\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				// (Integers and doubles can't be interpolated)
+				if (module->shader == MUVGC_FRAGMENT && is_input == MU_TRUE && declaration.interpolation != MUVGC_DECORATION_FLAT &&
+					((footprint.kind >> 16) == MUVGC_OP_TYPE_INT || muVGC_type_contains_width(module, type_id, 64) == MU_TRUE)) {
+					muVGC_print_syntax_error(og, declaration.name.index);
+					mu_print("integer and double fragment inputs must be flat\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				for (size_m i = 0; i < varlist->len; i++) {
+					if (varlist->variables[i].active == MU_TRUE &&
+						varlist->variables[i].token_name.length == declaration.name.length &&
+						mu_strncmp(muVGC_get_token_value(code, varlist->variables[i].token_name), muVGC_get_token_value(code, declaration.name), declaration.name.length) == 0) {
+						muVGC_print_syntax_error(og, declaration.name.index);
+						mu_print("variable name already in use\n");
+						*result = MU_FAILURE;
+						return;
+					}
+				}
+
+				muVGCInterfaceVariable variable = { 0 };
+				variable.name = declaration.name;
+				variable.storage_class = declaration.storage_class;
+				variable.type = type_id;
+				variable.location = declaration.location;
+				variable.component = declaration.component;
+				variable.interpolation = declaration.interpolation;
+				// (Integers and doubles are flat on the fragment side whether or
+				// not the vertex side says so, and both sides must pack alike)
+				if ((footprint.kind >> 16) == MUVGC_OP_TYPE_INT || muVGC_type_contains_width(module, type_id, 64) == MU_TRUE) {
+					variable.interpolation = MUVGC_DECORATION_FLAT;
+				}
+				variable.relaxed = muVGC_is_relaxed_precision(state, declaration.precision, type);
+				variable.id = muVGC_op_global_variable(module, declaration.storage_class, muVGC_get_pointer_type(module, declaration.storage_class, type_id));
+				muVGC_op_name(module, variable.id, muVGC_get_token_value(code, declaration.name), declaration.name.length);
+				if (declaration.interpolation != 0) {
+					muVGC_op_decorate(module, variable.id, declaration.interpolation);
+				}
+				if (variable.relaxed == MU_TRUE) {
+					muVGC_op_decorate(module, variable.id, MUVGC_DECORATION_RELAXED_PRECISION);
+				}
+				muVGC_add_interface_variable(module, variable.id);
+				muVGC_push_interface_variable(state, variable);
+				*varlist = muVGC_add_variable(*varlist, muVGC_make_variable(MU_TRUE, type, declaration.name, MU_FALSE, 0, MU_FALSE, 0, MU_FALSE, MU_NULL_PTR, 0, variable.id));
+				return;
 			} break;
 
-			case MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION: {
-				// A A(...
-				if (token_len > 3) {
-					if (
-						(tokens[0].type == MUVGC_TOKEN_KEYWORD || tokens[0].type == MUVGC_TOKEN_IDENTIFIER) &&
-						(tokens[1].type == MUVGC_TOKEN_IDENTIFIER) &&
-						(tokens[2].type == MUVGC_TOKEN_OPEN_PARENTHESIS)
-					) {
-						// A A(...,... ...)
-						size_m i = 3;
-						while (tokens[i].type != MUVGC_TOKEN_CLOSE_PARENTHESIS) {
-							// Qualifiers
-							size_m qualifier_count = 0;
-							while (
-								tokens[i+qualifier_count].type == MUVGC_TOKEN_KEYWORD &&
-								((tokens[i+qualifier_count].length == 5 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "const", 5) == 0) ||
-								(tokens[i+qualifier_count].length == 2 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "in", 2) == 0) ||
-								(tokens[i+qualifier_count].length == 3 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "out", 3) == 0) ||
-								(tokens[i+qualifier_count].length == 5 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "inout", 5) == 0) ||
-								(tokens[i+qualifier_count].length == 7 && mu_strncmp(muVGC_get_token_value(code, tokens[i+qualifier_count]), "precise", 7) == 0))
-							) {
-								qualifier_count++;
-							}
-							if (qualifier_count > 2) {
-								muVGC_print_syntax_error(og, tokens[i+3].index);
-								mu_print("too many storage qualifiers\n");
-								*result = MU_FAILURE;
-								return MU_FAILURE;
-							}
-							i += qualifier_count;
+			case MUVGC_STATEMENT_ASSIGNMENT: {
+				muVGCAssignment assignment;
+				size_m length = 0;
+				muVGC_get_assignment(result, tokens, token_len, og, &assignment, &length);
 
-							// Type
-							if (tokens[i].type != MUVGC_TOKEN_KEYWORD && tokens[i].type != MUVGC_TOKEN_IDENTIFIER) {
-								muVGC_print_syntax_error(og, tokens[i].index);
-								mu_print("expected keyword or identifier\n");
-								*result = MU_FAILURE;
-								return MU_FAILURE;
-							}
-							i++;
+				if (state->scope_count == 0) {
+					muVGC_print_syntax_error(og, tokens[0].index);
+					mu_print("assignments can only be made inside of functions\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				uint32_m pointer = 0, type = 0;
+				if (muVGC_get_assignment_target(result, module, state, code, og, &assignment.target, &pointer, &type) == MU_FALSE) {
+					return;
+				}
+				uint32_m value = muVGC_load_assigned_expression(result, module, state, code, og, tokens, token_len, &assignment, type);
+				if (value == 0) {
+					return;
+				}
+				muVGC_op_store(module, state->block, pointer, value);
+				return;
+			} break;
 
-							// Name
-							if (tokens[i].type != MUVGC_TOKEN_IDENTIFIER) {
-								muVGC_print_syntax_error(og, tokens[i].index);
-								mu_print("expected identifier\n");
-								*result = MU_FAILURE;
-								return MU_FAILURE;
-							}
-							i++;
+			case MUVGC_STATEMENT_CONSTANT: {
+				muVGCConstantDeclaration declaration;
+				size_m length = 0;
+				muVGC_get_constant_declaration(result, tokens, token_len, code, og, &declaration, &length);
+				muVGCToken name = declaration.name;
 
-							// Array
-							if (tokens[i].type == MUVGC_TOKEN_OPEN_SQUARE_BRACKET) {
-								if (tokens[i+1].type != MUVGC_TOKEN_INTEGER_CONSTANT) {
-									muVGC_print_syntax_error(og, tokens[i+1].index);
-									mu_print("expected integer after '['\n");
-									*result = MU_FAILURE;
-									return MU_FAILURE;
-								}
-								if (tokens[i+2].type != MUVGC_TOKEN_CLOSE_SQUARE_BRACKET) {
-									muVGC_print_syntax_error(og, tokens[i+2].index);
-									mu_print("expected ']' after integer\n");
-									*result = MU_FAILURE;
-									return MU_FAILURE;
-								}
-								i += 3;
-							}
+				if (state->scope_count != 0) {
+					muVGC_print_syntax_error(og, name.index);
+					mu_print("constants can only be declared at global scope for now\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				muVGCBasicType type = muVGC_get_basic_type(muVGC_get_token_value(code, declaration.type), declaration.type.length);
+				if (type == MUVGC_TYPE_VOID || type < MUVGC_TRANSPARENT_TYPE_FIRST || type > MUVGC_TRANSPARENT_TYPE_LAST) {
+					muVGC_print_syntax_error(og, declaration.type.index);
+					mu_print("only non-void transparent types can be constants\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				uint32_m type_id = muVGC_get_transparent_type(module, type);
+				size_m columns = 1, rows = 1;
+				muVGCScalarKind kind = muVGC_get_type_shape(module, type_id, &columns, &rows);
+				if (kind == MUVGC_SCALAR_UNKNOWN || columns != 1) {
+					muVGC_print_syntax_error(og, declaration.type.index);
+					mu_print("only 32-bit and boolean scalars and vectors can be constants for now\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				for (size_m i = 0; i < varlist->len; i++) {
+					if (varlist->variables[i].active == MU_TRUE &&
+						varlist->variables[i].token_name.length == name.length &&
+						mu_strncmp(muVGC_get_token_value(code, varlist->variables[i].token_name), muVGC_get_token_value(code, name), name.length) == 0) {
+						muVGC_print_syntax_error(og, name.index);
+						mu_print("variable name already in use\n");
+						*result = MU_FAILURE;
+						return;
+					}
+				}
 
-							// End of parameter
-							if (tokens[i].type == MUVGC_TOKEN_COMMA) {
-								i++;
-							} else if (tokens[i].type != MUVGC_TOKEN_CLOSE_PARENTHESIS) {
-								muVGC_print_syntax_error(og, tokens[i].index);
-								mu_print("expected comma or close parenthesis\n");
-								*result = MU_FAILURE;
-								return MU_FAILURE;
-							}
+				muVGCNamedConstant constant = { 0 };
+				constant.name = name;
+				constant.type = type_id;
+				constant.spec_id = declaration.spec_id;
+				if (declaration.spec_id != 0) {
+					if (rows != 1) {
+						muVGC_print_syntax_error(og, declaration.type.index);
+						mu_print("specialization constants must be scalars\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					// (A literal, negated numbers included, and nothing else)
+					size_m i = declaration.expression;
+					muVGCAssignmentOperand operand;
+					muBool is_number = (tokens[i].type == MUVGC_TOKEN_INTEGER_CONSTANT || tokens[i].type == MUVGC_TOKEN_FLOAT_CONSTANT) ? MU_TRUE : MU_FALSE;
+					if (tokens[i].type == MUVGC_TOKEN_DASH && (tokens[i+1].type == MUVGC_TOKEN_INTEGER_CONSTANT || tokens[i+1].type == MUVGC_TOKEN_FLOAT_CONSTANT)) {
+						is_number = MU_TRUE;
+					}
+					if ((is_number == MU_FALSE && muVGC_token_is_bool_literal(code, tokens[i]) == MU_FALSE) ||
+						muVGC_get_assignment_operand(result, tokens, token_len, code, og, &i, &operand) != MU_SUCCESS ||
+						tokens[i].type != MUVGC_TOKEN_SEMICOLON) {
+						muVGC_print_syntax_error(og, tokens[declaration.expression].index);
+						mu_print("specialization constants must be initialized with a literal\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					if (muVGC_find_spec_constant(state, declaration.spec_id) != MU_NULL_PTR) {
+						muVGC_print_syntax_error(og, name.index);
+						mu_print("constant_id already in use\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					// (A local size specialized by the same SpecId is this
+					// constant)
+					for (size_m d = 0; d < 3; d++) {
+						if (state->local_size_spec_ids[d] != declaration.spec_id) continue;
+						if (type_id != muVGC_get_int_type(module, 32, 0)) {
+							muVGC_print_syntax_error(og, declaration.type.index);
+							mu_print("specialization constants of the local size must be uints\n");
+							*result = MU_FAILURE;
+							return;
 						}
-						// A A(){...
-						// A A();
-						if (tokens[i+1].type != MUVGC_TOKEN_SEMICOLON && tokens[i+1].type != MUVGC_TOKEN_OPEN_BRACE) {
-							muVGC_print_syntax_error(og, tokens[i+1].index);
-							mu_print("expected semicolon or open brace\n");
+						if (state->workgroup_size != 0) {
+							muVGC_print_syntax_error(og, name.index);
+							mu_print("specialization constant of the local size declared after gl_WorkGroupSize was used\n");
 							*result = MU_FAILURE;
-							return MU_FAILURE;
-						} else if (tokens[i+1].type == MUVGC_TOKEN_OPEN_BRACE) {
-							*length = i+2;
-							return MU_SUCCESS;
+							return;
 						}
-						return MU_FAILURE;
+					}
+
+					uint32_m word = 0;
+					if (muVGC_get_literal_word(result, code, og, &operand, kind, &word) == MU_FALSE) {
+						return;
+					}
+					if (kind == MUVGC_SCALAR_BOOL) {
+						constant.id = muVGC_op_spec_constant_bool(module, (word != 0) ? MU_TRUE : MU_FALSE);
+					} else {
+						constant.id = muVGC_op_spec_constant(module, type_id, word);
+					}
+					muVGC_op_decorate_literal(module, constant.id, MUVGC_DECORATION_SPEC_ID, declaration.spec_id-1);
+				} else {
+					size_m i = declaration.expression;
+					uint32_m value_type = 0;
+					state->constant_expression = MU_TRUE;
+					constant.id = muVGC_load_expression(result, module, state, code, og, tokens, token_len, &i, type_id, 1, &value_type);
+					state->constant_expression = MU_FALSE;
+					if (constant.id == 0) {
+						return;
+					}
+					if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected operator or semicolon\n") != MU_SUCCESS) {
+						return;
+					}
+					if (value_type != type_id) {
+						muVGC_print_syntax_error(og, tokens[declaration.expression].index);
+						mu_print("value is of a different type than the constant\n");
+						*result = MU_FAILURE;
+						return;
 					}
 				}
-				return MU_FAILURE;
-			} break;
 
-			case MUVGC_STATEMENT_SCOPE_OPEN: {
-				if (tokens[0].type == MUVGC_TOKEN_OPEN_BRACE) {
-					*length = 1;
-					return MU_SUCCESS;
+				// (Regular constants are shared by whatever has the same
+				// value, so only specialization constants get named, unless
+				// they're just another name for one)
+				muBool named = MU_FALSE;
+				for (size_m i = 0; i < state->constant_len; i++) {
+					if (state->constants[i].id == constant.id) {
+						named = MU_TRUE;
+					}
 				}
-				return MU_FAILURE;
+				if (named == MU_FALSE && muVGC_is_spec_constant(module, constant.id) == MU_TRUE) {
+					muVGC_op_name(module, constant.id, muVGC_get_token_value(code, name), name.length);
+				}
+				muVGC_push_constant(state, constant);
+				*varlist = muVGC_add_variable(*varlist, muVGC_make_variable(MU_TRUE, type, name, MU_FALSE, 0, MU_FALSE, 0, MU_FALSE, MU_NULL_PTR, 0, constant.id));
+				return;
 			} break;
 
-			case MUVGC_STATEMENT_SCOPE_CLOSE: {
-				if (tokens[0].type == MUVGC_TOKEN_CLOSE_BRACE) {
-					*length = 1;
-					return MU_SUCCESS;
+			case MUVGC_STATEMENT_BLOCK: {
+				muVGCBlockDeclaration declaration;
+				size_m length = 0;
+				muVGC_get_block_declaration(result, tokens, token_len, code, og, &declaration, &length);
+
+				if (state->scope_count != 0) {
+					muVGC_print_syntax_error(og, declaration.name.index);
+					mu_print("blocks can only be declared at global scope\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				if (declaration.storage_class == MUVGC_STORAGE_CLASS_PUSH_CONSTANT) {
+					if (declaration.set != 0 || declaration.binding != 0) {
+						muVGC_print_syntax_error(og, declaration.name.index);
+						mu_print("push constant blocks can't have a set or binding\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					for (size_m i = 0; i < state->interface_block_len; i++) {
+						if (state->interface_blocks[i].storage_class == MUVGC_STORAGE_CLASS_PUSH_CONSTANT) {
+							muVGC_print_syntax_error(og, declaration.name.index);
+							mu_print("only one push constant block can be declared\n");
+							*result = MU_FAILURE;
+							return;
+						}
+					}
+				}
+				if (declaration.memory_qualifiers != 0 && declaration.storage_class != MUVGC_STORAGE_CLASS_STORAGE_BUFFER) {
+					muVGC_print_syntax_error(og, declaration.name.index);
+					mu_print("memory qualifiers can only be used on buffer blocks\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				for (size_m i = 0; i < state->interface_block_len; i++) {
+					muVGCToken other = state->interface_blocks[i].name;
+					if (other.length == declaration.name.length &&
+						mu_strncmp(muVGC_get_token_value(code, other), muVGC_get_token_value(code, declaration.name), other.length) == 0) {
+						muVGC_print_syntax_error(og, declaration.name.index);
+						mu_print("block name already in use\n");
+						*result = MU_FAILURE;
+						return;
+					}
+				}
+				// (The members of a block without an instance name are
+				// variables of their own)
+				for (size_m m = 0; m < ((declaration.has_instance_name == MU_TRUE) ? 1 : declaration.member_len); m++) {
+					muVGCToken name = (declaration.has_instance_name == MU_TRUE) ? declaration.instance_name : declaration.members[m].name;
+					for (size_m i = 0; i < varlist->len; i++) {
+						if (varlist->variables[i].active == MU_TRUE &&
+							varlist->variables[i].token_name.length == name.length &&
+							mu_strncmp(muVGC_get_token_value(code, varlist->variables[i].token_name), muVGC_get_token_value(code, name), name.length) == 0) {
+							muVGC_print_syntax_error(og, name.index);
+							mu_print("variable name already in use\n");
+							*result = MU_FAILURE;
+							return;
+						}
+					}
 				}
-				return MU_FAILURE;
-			} break;
-		}
-	}
 
-	muString muVGC_execute_statement_type(
-		muResult* result, muVGCStatementType type, muVGCToken* tokens, 
-		size_m token_len, const char* code, const char* og, muString bytecode,
-		size_m* scope_count, uint32_m* global_id, muVGCVariableList* varlist) {
+				// Members, laid out one after the other
+				uint32_m member_types[MUVGC_MAX_BLOCK_MEMBERS];
+				uint32_m offsets[MUVGC_MAX_BLOCK_MEMBERS];
+				muVGCTypeLayout layouts[MUVGC_MAX_BLOCK_MEMBERS];
+				muVGCBasicType basic_types[MUVGC_MAX_BLOCK_MEMBERS];
+				uint32_m offset = 0, alignment = 1;
+				for (size_m m = 0; m < declaration.member_len; m++) {
+					muVGCBlockMemberDeclaration* member = &declaration.members[m];
+					basic_types[m] = muVGC_get_basic_type(muVGC_get_token_value(code, member->type), member->type.length);
+					if (basic_types[m] == MUVGC_TYPE_VOID || basic_types[m] < MUVGC_TRANSPARENT_TYPE_FIRST || basic_types[m] > MUVGC_TRANSPARENT_TYPE_LAST) {
+						muVGC_print_syntax_error(og, member->type.index);
+						mu_print("only non-void transparent types can be block members\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					for (size_m n = 0; n < m; n++) {
+						if (declaration.members[n].name.length == member->name.length &&
+							mu_strncmp(muVGC_get_token_value(code, declaration.members[n].name), muVGC_get_token_value(code, member->name), member->name.length) == 0) {
+							muVGC_print_syntax_error(og, member->name.index);
+							mu_print("member name already in use\n");
+							*result = MU_FAILURE;
+							return;
+						}
+					}
+					if (member->array_length == MUVGC_RUNTIME_ARRAY_LENGTH &&
+						(declaration.storage_class != MUVGC_STORAGE_CLASS_STORAGE_BUFFER || m+1 != declaration.member_len)) {
+						muVGC_print_syntax_error(og, member->name.index);
+						mu_print("only the last member of a buffer block can be an array without a length\n");
+						*result = MU_FAILURE;
+						return;
+					}
 
-		//muResult res = MU_SUCCESS;
+					uint32_m matrix_layout = (member->matrix_layout != 0) ? member->matrix_layout : declaration.matrix_layout;
+					muBool row_major = (matrix_layout == MUVGC_DECORATION_ROW_MAJOR) ? MU_TRUE : MU_FALSE;
+					uint32_m type = muVGC_get_transparent_type(module, basic_types[m]);
+					if (muVGC_get_type_layout(module, type, member->array_length, declaration.rules, row_major, &layouts[m]) == MU_FALSE) {
+						muVGC_print_syntax_error(og, member->type.index);
+						mu_print("booleans can't be block members\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					member_types[m] = layouts[m].layout_type;
 
-		switch (type) {
-			default: *result = MU_FAILURE; return bytecode; break;
+					if (member->offset != 0) {
+						if (member->offset-1 < offset) {
+							muVGC_print_syntax_error(og, member->name.index);
+							mu_print("member offset overlaps the previous member\n");
+							*result = MU_FAILURE;
+							return;
+						}
+						if ((member->offset-1) % layouts[m].alignment != 0) {
+							muVGC_print_syntax_error(og, member->name.index);
+							mu_print("member offset isn't a multiple of the member's alignment\n");
+							*result = MU_FAILURE;
+							return;
+						}
+						offset = member->offset-1;
+					} else {
+						offset = muVGC_round_up(offset, layouts[m].alignment);
+					}
+					if ((member->array_length != 0 && member->array_length != MUVGC_RUNTIME_ARRAY_LENGTH && layouts[m].size / layouts[m].array_stride != member->array_length) ||
+						offset + layouts[m].size < offset || offset > 0x7FFFFFFF) {
+						muVGC_print_syntax_error(og, member->name.index);
+						mu_print("block is too large\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					offsets[m] = offset;
+					offset += layouts[m].size;
+					if (layouts[m].alignment > alignment) {
+						alignment = layouts[m].alignment;
+					}
+				}
 
-			case MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION: {
-				// @TODO check for variable name duplication here
+				muVGCInterfaceBlock block = { 0 };
+				block.name = declaration.name;
+				block.has_instance_name = declaration.has_instance_name;
+				block.instance_name = declaration.instance_name;
+				block.storage_class = declaration.storage_class;
+				block.memory_qualifiers = declaration.memory_qualifiers;
+				block.first_member = state->block_member_len;
+				block.member_len = declaration.member_len;
+
+				uint32_m struct_type = muVGC_op_type_struct(module, member_types, declaration.member_len);
+				muVGC_op_name(module, struct_type, muVGC_get_token_value(code, declaration.name), declaration.name.length);
+				for (size_m m = 0; m < declaration.member_len; m++) {
+					muVGCBlockMemberDeclaration* member = &declaration.members[m];
+					muVGC_op_member_name(module, struct_type, (uint32_m)m, muVGC_get_token_value(code, member->name), member->name.length);
+					muVGC_op_member_decorate_literal(module, struct_type, (uint32_m)m, MUVGC_DECORATION_OFFSET, offsets[m]);
+					if (layouts[m].matrix_stride != 0) {
+						muVGC_op_member_decorate(module, struct_type, (uint32_m)m, (layouts[m].row_major == MU_TRUE) ? MUVGC_DECORATION_ROW_MAJOR : MUVGC_DECORATION_COL_MAJOR);
+						muVGC_op_member_decorate_literal(module, struct_type, (uint32_m)m, MUVGC_DECORATION_MATRIX_STRIDE, layouts[m].matrix_stride);
+					}
+					for (size_m q = 0; q < MUVGC_MEMORY_QUALIFIER_COUNT; q++) {
+						if ((declaration.memory_qualifiers & (1 << q)) != 0) {
+							muVGC_op_member_decorate(module, struct_type, (uint32_m)m, muVGC_global_memory_qualifiers[q].decoration);
+						}
+					}
 
-				muVGCBasicType return_type = muVGC_get_basic_type(muVGC_get_token_value(code, tokens[0]), tokens[0].length);
-				if (return_type == MUVGC_TYPE_UNKNOWN) {
-					// @TODO add struct checking
-					muVGC_print_syntax_error(og, tokens[0].index);
-					mu_print("unrecognized type specified\n");
+					muVGCBlockMember block_member = { 0 };
+					block_member.name = member->name;
+					block_member.type = layouts[m].layout_type;
+					if (member->array_length != 0) {
+						block_member.element_type = layouts[m].type;
+						block_member.array_length = member->array_length;
+					}
+					block_member.relaxed = muVGC_is_relaxed_precision(state, member->precision, basic_types[m]);
+					if (block_member.relaxed == MU_TRUE) {
+						muVGC_op_member_decorate(module, struct_type, (uint32_m)m, MUVGC_DECORATION_RELAXED_PRECISION);
+					}
+					muVGC_push_block_member(state, block_member);
+				}
+				muVGC_op_decorate(module, struct_type, MUVGC_DECORATION_BLOCK);
+
+				// (Blocks aren't rounded up to their alignment, since nothing
+				// comes after them)
+				muVGCTypeLayout layout = { 0 };
+				layout.type = struct_type;
+				layout.rules = declaration.rules;
+				layout.layout_type = struct_type;
+				layout.size = offset;
+				layout.alignment = (declaration.rules == MUVGC_LAYOUT_STD140) ? muVGC_round_up(alignment, 16) : alignment;
+				muVGC_add_type_layout(module, layout);
+
+				// (SPIR-V 1.0 only has the StorageBuffer storage class through
+				// an extension)
+				if (declaration.storage_class == MUVGC_STORAGE_CLASS_STORAGE_BUFFER) {
+					muVGC_require_extension(module, "SPV_KHR_storage_buffer_storage_class", 36);
+				}
+				block.id = muVGC_op_global_variable(module, declaration.storage_class, muVGC_get_pointer_type(module, declaration.storage_class, struct_type));
+				if (declaration.has_instance_name == MU_TRUE) {
+					muVGC_op_name(module, block.id, muVGC_get_token_value(code, declaration.instance_name), declaration.instance_name.length);
+				} else {
+					muVGC_op_name(module, block.id, (char*)"", 0);
+				}
+				if (declaration.storage_class != MUVGC_STORAGE_CLASS_PUSH_CONSTANT) {
+					muVGC_op_decorate_literal(module, block.id, MUVGC_DECORATION_DESCRIPTOR_SET, (declaration.set != 0) ? declaration.set-1 : 0);
+					muVGC_op_decorate_literal(module, block.id, MUVGC_DECORATION_BINDING, (declaration.binding != 0) ? declaration.binding-1 : 0);
+				}
+				muVGC_push_interface_block(state, block);
+
+				muVGCReflectedVariable reflected = { 0 };
+				reflected.id = block.id;
+				reflected.storage_class = declaration.storage_class;
+				reflected.set = (declaration.set != 0) ? declaration.set-1 : 0;
+				reflected.binding = (declaration.binding != 0) ? declaration.binding-1 : 0;
+				reflected.offset = (declaration.member_len != 0) ? offsets[0] : 0;
+				reflected.size = offset;
+				muVGC_reflect_variable(module, reflected);
+
+				if (declaration.has_instance_name == MU_TRUE) {
+					*varlist = muVGC_add_variable(*varlist, muVGC_make_variable(MU_TRUE, MUVGC_TYPE_UNKNOWN, declaration.instance_name, MU_FALSE, 0, MU_FALSE, 0, MU_FALSE, MU_NULL_PTR, 0, block.id));
+				} else {
+					for (size_m m = 0; m < declaration.member_len; m++) {
+						muVGCBlockMemberDeclaration* member = &declaration.members[m];
+						*varlist = muVGC_add_variable(*varlist, muVGC_make_variable(MU_TRUE, basic_types[m], member->name, (member->array_length != 0) ? MU_TRUE : MU_FALSE, member->array_length, MU_FALSE, 0, MU_FALSE, MU_NULL_PTR, 0, block.id));
+					}
+				}
+				return;
+			} break;
+
+			case MUVGC_STATEMENT_LOCAL_VARIABLE: {
+				muVGCLocalDeclaration declaration;
+				size_m length = 0;
+				muVGC_get_local_declaration(result, tokens, token_len, code, og, &declaration, &length);
+				muVGCToken name = declaration.value.target.name;
+
+				if (state->scope_count == 0) {
+					muVGC_print_syntax_error(og, declaration.type.index);
+					mu_print("global variables other than inputs, outputs and constants aren't supported yet\n");
+					*result = MU_FAILURE;
+					return;
+				}
+				muVGCBasicType type = muVGC_get_basic_type(muVGC_get_token_value(code, declaration.type), declaration.type.length);
+				if (type == MUVGC_TYPE_VOID || type < MUVGC_TRANSPARENT_TYPE_FIRST || type > MUVGC_TRANSPARENT_TYPE_LAST) {
+					muVGC_print_syntax_error(og, declaration.type.index);
+					mu_print("only non-void transparent types can be local variables\n");
 					*result = MU_FAILURE;
-					return bytecode;
+					return;
 				}
-				if (return_type < MUVGC_TRANSPARENT_TYPE_FIRST || return_type > MUVGC_TRANSPARENT_TYPE_LAST) {
-					muVGC_print_syntax_error(og,tokens[0].index);
-					mu_print("only transparent types can be used as a return value\n");
+				muVGCLocalVariable* other = muVGC_find_local_variable(state, code, name);
+				if (other != MU_NULL_PTR && other->scope == state->scope_count) {
+					muVGC_print_syntax_error(og, name.index);
+					mu_print("variable name already in use\n");
 					*result = MU_FAILURE;
-					return bytecode;
+					return;
 				}
 
-				uint32_m return_type_id = 0;
-				bytecode = muVGC_get_transparent_type(bytecode, return_type, &return_type_id, global_id);
-				if (return_type_id == 0) {
-					// This should never trigger but still
+				muVGCLocalVariable variable = { 0 };
+				variable.name = name;
+				variable.type = muVGC_get_transparent_type(module, type);
+				variable.relaxed = muVGC_is_relaxed_precision(state, declaration.precision, type);
+				variable.scope = state->scope_count;
+				// (The value is evaluated before the variable exists, so it
+				// can't refer to itself)
+				uint32_m value = 0;
+				if (declaration.has_value == MU_TRUE) {
+					value = muVGC_load_assigned_expression(result, module, state, code, og, tokens, token_len, &declaration.value, variable.type);
+					if (value == 0) {
+						return;
+					}
+				}
+				variable.id = muVGC_op_function_variable(module, state->function, muVGC_get_pointer_type(module, MUVGC_STORAGE_CLASS_FUNCTION, variable.type));
+				muVGC_op_name(module, variable.id, muVGC_get_token_value(code, name), name.length);
+				if (variable.relaxed == MU_TRUE) {
+					muVGC_op_decorate(module, variable.id, MUVGC_DECORATION_RELAXED_PRECISION);
+				}
+				if (value != 0) {
+					muVGC_op_store(module, state->block, variable.id, value);
+				}
+				muVGC_push_local_variable(state, variable);
+				return;
+			} break;
+
+			case MUVGC_STATEMENT_FUNCTION_CALL: {
+				if (state->scope_count == 0) {
 					muVGC_print_syntax_error(og, tokens[0].index);
-					mu_print("failed to declare type\n");
+					mu_print("function called outside of a function\n");
 					*result = MU_FAILURE;
-					return bytecode;
+					return;
 				}
 
-				// @TODO Find a clean way (or way at all) to gather parameters
-				size_m parameter_count = 0;
-				uint32_m function_type = 0;
-				bytecode = muVGC_get_function_type(bytecode, &function_type, global_id, return_type_id, MU_NULL_PTR, 0);
-				bytecode = muVGC_op_function(bytecode, return_type_id, 0, function_type, global_id);
-				size_m function_id = *global_id - 1;
-				bytecode = muVGC_op_name(bytecode, function_id, muVGC_get_token_value(code, tokens[1]), tokens[1].length);
-				bytecode = muVGC_op_label(bytecode, *global_id);
-				*global_id += 1;
-				if (return_type == MUVGC_TYPE_VOID) {
-					bytecode = muVGC_op_return(bytecode);
-				}
-				bytecode = muVGC_op_function_end(bytecode);
+				if (muVGC_call_barrier_function(result, module, state, code, og, tokens[0]) == MU_TRUE) {
+					return;
+				}
 
 				for (size_m i = 0; i < varlist->len; i++) {
-					if (varlist->variables[i].active == MU_TRUE && 
-						varlist->variables[i].token_name.length == tokens[1].length &&
-						mu_strncmp(muVGC_get_token_value(code, varlist->variables[i].token_name), muVGC_get_token_value(code, tokens[1]), tokens[1].length) == 0) {
+					if (varlist->variables[i].active == MU_TRUE &&
+						varlist->variables[i].token_name.length == tokens[0].length &&
+						mu_strncmp(muVGC_get_token_value(code, varlist->variables[i].token_name), muVGC_get_token_value(code, tokens[0]), tokens[0].length) == 0) {
 
 						if (varlist->variables[i].is_function == MU_FALSE) {
-							muVGC_print_syntax_error(og, tokens[1].index);
-							mu_print("variable declared again as function\n");
+							muVGC_print_syntax_error(og, tokens[0].index);
+							mu_print("called variable is not a function\n");
 							*result = MU_FAILURE;
-							return bytecode;
+							return;
 						}
 
-						if (varlist->variables[i].is_function_implemented == MU_TRUE) {
-							muVGC_print_syntax_error(og, tokens[1].index);
-							mu_print("function implemented numerous times\n");
+						if (varlist->variables[i].id == module->instructions[module->functions[state->function].instruction].result_id) {
+							muVGC_print_syntax_error(og, tokens[0].index);
+							mu_print("recursive function calls are not allowed\n");
 							*result = MU_FAILURE;
-							return bytecode;
+							return;
 						}
 
-						if (varlist->variables[i].type != return_type) {
-							muVGC_print_syntax_error(og, tokens[1].index);
-							mu_print("function redeclared with different return type\n");
+						if (varlist->variables[i].parameterlen != 0) {
+							muVGC_print_syntax_error(og, tokens[0].index);
+							mu_print("function called with too few arguments\n");
 							*result = MU_FAILURE;
-							return bytecode;
+							return;
 						}
 
-						if (varlist->variables[i].parameterlen != parameter_count) {
-							muVGC_print_syntax_error(og, tokens[1].index);
-							mu_print("function redeclared with different number of parameters\n");
-							*result = MU_FAILURE;
-							return bytecode;
+						uint32_m return_type_id = muVGC_get_transparent_type(module, varlist->variables[i].type);
+						uint32_m call = muVGC_op_function_call(module, state->block, return_type_id, varlist->variables[i].id, MU_NULL_PTR, 0);
+						// (Calls to RelaxedPrecision functions return RelaxedPrecision results)
+						if (muVGC_find_decoration(module, varlist->variables[i].id, MUVGC_DECORATION_RELAXED_PRECISION) != MUVGC_NO_DECORATION) {
+							muVGC_op_decorate(module, call, MUVGC_DECORATION_RELAXED_PRECISION);
 						}
-
-						// @TODO check for parameter equivalence
-						/*for (size_m j = 0; j < parameter_count; j++) {
-							if (muVGC_are_two_parameters_equivalent(code, varlist->variables[i].parameters[j], ))
-						}*/
+						return;
 					}
 				}
 
-				*varlist = muVGC_add_variable(*varlist, muVGC_make_variable(MU_TRUE, return_type, tokens[1], MU_FALSE, 0, MU_TRUE, 0, MU_TRUE, MU_NULL_PTR, 0, function_id));
-
-				*scope_count += 1;
-				return bytecode;
-			} break;
-
-			case MUVGC_STATEMENT_SCOPE_OPEN: {
-				*scope_count += 1;
-				return bytecode;
+				muVGC_print_syntax_error(og, tokens[0].index);
+				mu_print("call to undeclared function\n");
+				*result = MU_FAILURE;
+				return;
 			} break;
 
-			case MUVGC_STATEMENT_SCOPE_CLOSE: {
-				if (scope_count == 0) {
+			case MUVGC_STATEMENT_RETURN: {
+				if (state->scope_count == 0) {
 					muVGC_print_syntax_error(og, tokens[0].index);
-					mu_print("too many close braces\n");
+					mu_print("return outside of a function\n");
+					*result = MU_FAILURE;
+					return;
+				}
+
+				if (state->return_type == MUVGC_TYPE_VOID) {
+					if (tokens[1].type != MUVGC_TOKEN_SEMICOLON) {
+						muVGC_print_syntax_error(og, tokens[1].index);
+						mu_print("void functions can't return a value\n");
+						*result = MU_FAILURE;
+						return;
+					}
+					muVGC_op_return(module, state->block);
+					state->returned = MU_TRUE;
+					return;
+				}
+				if (tokens[1].type == MUVGC_TOKEN_SEMICOLON) {
+					muVGC_print_syntax_error(og, tokens[1].index);
+					mu_print("expected value to return\n");
+					*result = MU_FAILURE;
+					return;
+				}
+
+				uint32_m return_type_id = muVGC_get_transparent_type(module, state->return_type);
+				size_m i = 1;
+				uint32_m value_type = 0;
+				uint32_m value = muVGC_load_expression(result, module, state, code, og, tokens, token_len, &i, return_type_id, 1, &value_type);
+				if (value == 0) {
+					return;
+				}
+				if (muVGC_expect_token(result, tokens, token_len, og, i, MUVGC_TOKEN_SEMICOLON, "expected operator or semicolon\n") != MU_SUCCESS) {
+					return;
+				}
+				if (value_type != return_type_id) {
+					muVGC_print_syntax_error(og, tokens[1].index);
+					mu_print("returned value is of a different type than the function's\n");
 					*result = MU_FAILURE;
-					return bytecode;
+					return;
 				}
-				*scope_count -= 1;
-				return bytecode;
+				muVGC_op_return_value(module, state->block, value);
+				state->returned = MU_TRUE;
+				return;
 			} break;
 		}
 	}
@@ -3615,194 +16290,785 @@ extern "C" { // }
 	muVGCStatement muVGC_get_statement(
 		muResult* result, muVGCToken* tokens, size_m token_len, size_m total_token_len, const char* code, const char* og) {
 
-		muVGCStatement statement = { 0 };
-		statement.type = MUVGC_STATEMENT_UNKNOWN;
-		muResult res = MU_SUCCESS;
+		muVGCStatement statement = { 0 };
+		statement.type = MUVGC_STATEMENT_UNKNOWN;
+		muResult res = MU_SUCCESS;
+
+		for (muVGCStatementType type = MUVGC_STATEMENT_FIRST; type <= MUVGC_STATEMENT_LAST; type++) {
+			if (muVGC_check_statement_type(&res, type, tokens, token_len, code, og, &statement.length) == MU_SUCCESS) {
+				if (res != MU_SUCCESS) {
+					*result = MU_FAILURE;
+					return statement;
+				}
+
+				statement.type = type;
+				statement.index = total_token_len-token_len;
+				return statement;
+			}
+			if (res != MU_SUCCESS) {
+				*result = MU_FAILURE;
+				return statement;
+			}
+		}
+
+		muVGC_print_syntax_error(og, tokens[0].index);
+		mu_print("unrecognized statement\n");
+
+		*result = MU_FAILURE;
+		return statement;
+	}
+
+	muVGCStatement* muVGC_get_statements(
+		muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* statement_length) {
+
+		// Similar issue to retrieving tokens, as I have to do the process twice
+
+		muResult res = MU_SUCCESS;
+		size_m statement_len = 0;
+
+		for (size_m i = 0; i < token_len;) {
+			muVGCStatement statement = muVGC_get_statement(&res, &tokens[i], token_len-i, token_len, code, og);
+
+			if (res != MU_SUCCESS) {
+				return MU_NULL_PTR;
+			}
+			statement_len++;
+			i += statement.length;
+		}
+
+		if (statement_len == 0) {
+			// Not exactly sure what would ever cause this, but allowing malloc to call will
+			// cause an immediate crash, so, yeah
+			mu_print("[muVGC] Syntax error; expected at least one statement after version\n");
+			return MU_NULL_PTR;
+		}
+		muVGCStatement* statements = mu_malloc(sizeof(muVGCStatement) * statement_len);
+
+		size_m index = 0;
+		for (size_m i = 0; i < token_len;) {
+			muVGCStatement statement = muVGC_get_statement(&res, &tokens[i], token_len-i, token_len, code, og);
+
+			if (res != MU_SUCCESS) {
+				mu_free(statements);
+				return MU_NULL_PTR;
+			}
+			statements[index] = statement;
+			index++;
+			i += statement.length;
+		}
+
+		*statement_length = statement_len;
+		return statements;
+	}
+
+	// Statement execution
+
+	muResult muVGC_declare_main_function(
+		muResult* result, muVGCStatement* statements, size_m statement_len,
+		muVGCToken* tokens, const char* code, const char* og) {
+
+		muBool found_main = MU_FALSE;
+		for (size_m i = 0; i < statement_len; i++) {
+			if (statements[i].type != MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION) continue;
+			size_m index = statements[i].index + muVGC_get_function_implementation_offset(&tokens[statements[i].index], statements[i].length);
+			if (tokens[index+1].length == 4 &&
+				mu_strncmp(muVGC_get_token_value(code, tokens[index+1]), "main", 4) == 0) {
+
+				if (found_main == MU_TRUE) {
+					muVGC_print_syntax_error(og, tokens[index+1].index);
+					mu_print("multiple entry point 'main' functions declared\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+				found_main = MU_TRUE;
+
+				if ((tokens[index].length != 4) ||
+					(mu_strncmp(muVGC_get_token_value(code, tokens[index]), "void", 4) != 0)) {
+
+					muVGC_print_syntax_error(og, tokens[index].index);
+					mu_print("entry point 'main' function declared as something else than void\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+
+				if ((tokens[index+3].type != MUVGC_TOKEN_CLOSE_PARENTHESIS)) {
+					muVGC_print_syntax_error(og, tokens[index+3].index);
+					mu_print("entry point 'main' function declared with parameters\n");
+					*result = MU_FAILURE;
+					return MU_FAILURE;
+				}
+			}
+		}
+
+		if (found_main == MU_FALSE) {
+			mu_print("[muVGC] Error while compiling; no entry point 'main' function found\n");
+			*result = MU_FAILURE;
+			return MU_FAILURE;
+		}
+
+		return MU_SUCCESS;
+	}
+
+	void muVGC_execute_statements(
+		muResult* result, muVGCModule* module, muVGCStatement* statements, size_m statement_len,
+		muVGCToken* tokens, size_m token_len, const char* code, const char* og,
+		muVGCVariableList* varlist) {
+
+		muResult res = MU_SUCCESS;
+
+		if (muVGC_declare_main_function(&res, statements, statement_len, tokens, code, og) != MU_SUCCESS) {
+			*result = MU_FAILURE;
+			return;
+		}
+
+		muVGCStatementState state = { 0 };
+		for (size_m i = 0; i < statement_len; i++) {
+			// (Code after a return goes in a new block, which nothing branches
+			// to; the ends of scopes just don't branch from the returned one)
+			if (state.returned == MU_TRUE && statements[i].type != MUVGC_STATEMENT_SCOPE_CLOSE && statements[i].type != MUVGC_STATEMENT_ELSE) {
+				state.block = muVGC_op_label(module, state.function, muVGC_module_new_id(module));
+				state.returned = MU_FALSE;
+			}
+			muVGC_execute_statement_type(&res, statements[i].type, &tokens[statements[i].index], token_len-statements[i].index, code, og, module, &state, varlist);
+			if (res != MU_SUCCESS) {
+				muVGC_free_statement_state(&state);
+				*result = MU_FAILURE;
+				return;
+			}
+			if (statements[i].type != MUVGC_STATEMENT_ATTRIBUTE) {
+				state.attributes = 0;
+			}
+		}
+		if (module->shader == MUVGC_COMPUTE) {
+			muVGC_declare_local_size(module, &state);
+		}
+		muVGC_declare_interface_locations(&res, module, &state, og);
+		muVGC_free_statement_state(&state);
+		if (res != MU_SUCCESS) {
+			*result = MU_FAILURE;
+			return;
+		}
+
+		if (state.scope_count > 0) {
+			muVGC_print_syntax_error(og, tokens[token_len-1].index);
+			mu_print("expected a close brace before end of file\n");
+			*result = MU_FAILURE;
+			return;
+		}
+	}
+
+/* COMPRESSION HANDLING */
+
+	// A smaller encoding of SPIR-V binaries for shipping, in the spirit of
+	// SMOL-V: every word becomes a varint, and ids are stored as deltas
+	// from the last result id (ids used tend to be defined shortly before),
+	// which keeps most of them to one byte. Decoding gives back the exact
+	// original words.
+	//
+	// Layout: the magic number MUVGC_COMPRESSED_MAGIC (4 bytes, little
+	// endian), then varints for the SPIR-V version, generator, bound,
+	// schema and the total word count, then the instructions. Each
+	// instruction is a varint of (opcode << 4 | operand count), with
+	// operand counts of 15 or more continued in another varint, followed
+	// by its operands as described by muVGC_get_opcode_layout.
+
+	#define MUVGC_COMPRESSED_MAGIC 0x4347564D
+
+	// (id_count meaning every remaining operand is an id)
+	#define MUVGC_ALL_OPERANDS 0xFFFF
+
+	struct muVGCOpcodeLayout {
+		muBool has_type;
+		muBool has_result;
+		// Number of operands after the result type/id that are ids
+		uint16_m id_count;
+		// Whether the operands after those are better stored as they are
+		// (strings)
+		muBool raw_words;
+	};
+	typedef struct muVGCOpcodeLayout muVGCOpcodeLayout;
+
+	// Describes the operands of an opcode; anything not listed here is
+	// treated as a list of literals, which is still lossless, just bigger
+	muVGCOpcodeLayout muVGC_get_opcode_layout(uint16_m opcode) {
+		muVGCOpcodeLayout layout = { MU_FALSE, MU_FALSE, 0, MU_FALSE };
+		switch (opcode) {
+			default: break;
+
+			// Strings
+			case MUVGC_OP_SOURCE_EXTENSION: case MUVGC_OP_EXTENSION: {
+				layout.raw_words = MU_TRUE;
+			} break;
+			case MUVGC_OP_NAME: case MUVGC_OP_MEMBER_NAME: {
+				layout.id_count = 1;
+				layout.raw_words = MU_TRUE;
+			} break;
+			case MUVGC_OP_STRING: case MUVGC_OP_EXT_INST_IMPORT: {
+				layout.has_result = MU_TRUE;
+				layout.raw_words = MU_TRUE;
+			} break;
+
+			// Result id only
+			case MUVGC_OP_TYPE_VOID: case MUVGC_OP_TYPE_BOOL: case MUVGC_OP_TYPE_INT: case MUVGC_OP_TYPE_FLOAT:
+			case MUVGC_OP_TYPE_SAMPLER: case MUVGC_OP_TYPE_POINTER: case MUVGC_OP_LABEL: {
+				layout.has_result = MU_TRUE;
+			} break;
+			case MUVGC_OP_TYPE_VECTOR: case MUVGC_OP_TYPE_MATRIX: case MUVGC_OP_TYPE_IMAGE: case MUVGC_OP_TYPE_SAMPLED_IMAGE:
+			case MUVGC_OP_TYPE_RUNTIME_ARRAY: {
+				layout.has_result = MU_TRUE;
+				layout.id_count = 1;
+			} break;
+			case MUVGC_OP_TYPE_ARRAY: {
+				layout.has_result = MU_TRUE;
+				layout.id_count = 2;
+			} break;
+			case MUVGC_OP_TYPE_STRUCT: case MUVGC_OP_TYPE_FUNCTION: {
+				layout.has_result = MU_TRUE;
+				layout.id_count = MUVGC_ALL_OPERANDS;
+			} break;
+
+			// Result type & id
+			case MUVGC_OP_UNDEF: case MUVGC_OP_CONSTANT_TRUE: case MUVGC_OP_CONSTANT_FALSE: case MUVGC_OP_CONSTANT:
+			case MUVGC_OP_CONSTANT_NULL: case MUVGC_OP_SPEC_CONSTANT_TRUE: case MUVGC_OP_SPEC_CONSTANT_FALSE: case MUVGC_OP_SPEC_CONSTANT:
+			case MUVGC_OP_FUNCTION: case MUVGC_OP_FUNCTION_PARAMETER: case MUVGC_OP_VARIABLE: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+			} break;
+			// (The operation's opcode comes before its ids, so those are
+			// stored as literals)
+			case MUVGC_OP_SPEC_CONSTANT_OP: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+			} break;
+			case MUVGC_OP_EXT_INST: case MUVGC_OP_LOAD: case MUVGC_OP_COMPOSITE_EXTRACT: case MUVGC_OP_COPY_OBJECT:
+			case MUVGC_OP_TRANSPOSE: case MUVGC_OP_CONVERT_F_TO_U: case MUVGC_OP_CONVERT_F_TO_S: case MUVGC_OP_CONVERT_S_TO_F:
+			case MUVGC_OP_CONVERT_U_TO_F: case MUVGC_OP_BITCAST: case MUVGC_OP_S_NEGATE: case MUVGC_OP_F_NEGATE:
+			case MUVGC_OP_ANY: case MUVGC_OP_ALL: case MUVGC_OP_IS_NAN: case MUVGC_OP_IS_INF: case MUVGC_OP_LOGICAL_NOT:
+			case MUVGC_OP_NOT: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+				layout.id_count = 1;
+			} break;
+			case MUVGC_OP_VECTOR_SHUFFLE: case MUVGC_OP_COMPOSITE_INSERT:
+			case MUVGC_OP_I_ADD: case MUVGC_OP_F_ADD: case MUVGC_OP_I_SUB: case MUVGC_OP_F_SUB: case MUVGC_OP_I_MUL:
+			case MUVGC_OP_F_MUL: case MUVGC_OP_U_DIV: case MUVGC_OP_S_DIV: case MUVGC_OP_F_DIV: case MUVGC_OP_U_MOD:
+			case MUVGC_OP_S_REM: case MUVGC_OP_S_MOD: case MUVGC_OP_F_REM: case MUVGC_OP_F_MOD:
+			case MUVGC_OP_VECTOR_TIMES_SCALAR: case MUVGC_OP_MATRIX_TIMES_SCALAR: case MUVGC_OP_VECTOR_TIMES_MATRIX:
+			case MUVGC_OP_MATRIX_TIMES_VECTOR: case MUVGC_OP_MATRIX_TIMES_MATRIX: case MUVGC_OP_OUTER_PRODUCT: case MUVGC_OP_DOT:
+			case MUVGC_OP_LOGICAL_EQUAL: case MUVGC_OP_LOGICAL_NOT_EQUAL: case MUVGC_OP_LOGICAL_OR: case MUVGC_OP_LOGICAL_AND:
+			case MUVGC_OP_I_EQUAL: case MUVGC_OP_I_NOT_EQUAL: case MUVGC_OP_U_GREATER_THAN: case MUVGC_OP_S_GREATER_THAN:
+			case MUVGC_OP_U_GREATER_THAN_EQUAL: case MUVGC_OP_S_GREATER_THAN_EQUAL: case MUVGC_OP_U_LESS_THAN:
+			case MUVGC_OP_S_LESS_THAN: case MUVGC_OP_U_LESS_THAN_EQUAL: case MUVGC_OP_S_LESS_THAN_EQUAL:
+			case MUVGC_OP_F_ORD_EQUAL: case MUVGC_OP_F_UNORD_EQUAL: case MUVGC_OP_F_ORD_NOT_EQUAL: case MUVGC_OP_F_UNORD_NOT_EQUAL:
+			case MUVGC_OP_F_ORD_LESS_THAN: case MUVGC_OP_F_UNORD_LESS_THAN: case MUVGC_OP_F_ORD_GREATER_THAN:
+			case MUVGC_OP_F_UNORD_GREATER_THAN: case MUVGC_OP_F_ORD_LESS_THAN_EQUAL: case MUVGC_OP_F_UNORD_LESS_THAN_EQUAL:
+			case MUVGC_OP_F_ORD_GREATER_THAN_EQUAL: case MUVGC_OP_F_UNORD_GREATER_THAN_EQUAL:
+			case MUVGC_OP_SHIFT_RIGHT_LOGICAL: case MUVGC_OP_SHIFT_RIGHT_ARITHMETIC: case MUVGC_OP_SHIFT_LEFT_LOGICAL:
+			case MUVGC_OP_BITWISE_OR: case MUVGC_OP_BITWISE_XOR: case MUVGC_OP_BITWISE_AND: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+				layout.id_count = 2;
+			} break;
+			case MUVGC_OP_SELECT: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+				layout.id_count = 3;
+			} break;
+			// (Group instructions taking a group operation have it before
+			// their values, so they're left as literals)
+			case MUVGC_OP_GROUP_NON_UNIFORM_ELECT: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+				layout.id_count = 1;
+			} break;
+			case MUVGC_OP_GROUP_NON_UNIFORM_ALL: case MUVGC_OP_GROUP_NON_UNIFORM_ANY: case MUVGC_OP_GROUP_NON_UNIFORM_ALL_EQUAL:
+			case MUVGC_OP_GROUP_NON_UNIFORM_BROADCAST_FIRST: case MUVGC_OP_GROUP_NON_UNIFORM_BALLOT:
+			case MUVGC_OP_GROUP_NON_UNIFORM_INVERSE_BALLOT: case MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_FIND_LSB:
+			case MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_FIND_MSB: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+				layout.id_count = 2;
+			} break;
+			case MUVGC_OP_GROUP_NON_UNIFORM_BROADCAST: case MUVGC_OP_GROUP_NON_UNIFORM_BALLOT_BIT_EXTRACT:
+			case MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE: case MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_XOR:
+			case MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_UP: case MUVGC_OP_GROUP_NON_UNIFORM_SHUFFLE_DOWN: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+				layout.id_count = 3;
+			} break;
+			case MUVGC_OP_CONSTANT_COMPOSITE: case MUVGC_OP_SPEC_CONSTANT_COMPOSITE: case MUVGC_OP_FUNCTION_CALL:
+			case MUVGC_OP_ACCESS_CHAIN: case MUVGC_OP_IN_BOUNDS_ACCESS_CHAIN: case MUVGC_OP_COMPOSITE_CONSTRUCT: case MUVGC_OP_PHI:
+			case MUVGC_OP_ATOMIC_EXCHANGE: case MUVGC_OP_ATOMIC_I_ADD: case MUVGC_OP_ATOMIC_S_MIN: case MUVGC_OP_ATOMIC_U_MIN:
+			case MUVGC_OP_ATOMIC_S_MAX: case MUVGC_OP_ATOMIC_U_MAX: case MUVGC_OP_ATOMIC_AND: case MUVGC_OP_ATOMIC_OR:
+			case MUVGC_OP_ATOMIC_XOR: {
+				layout.has_type = MU_TRUE;
+				layout.has_result = MU_TRUE;
+				layout.id_count = MUVGC_ALL_OPERANDS;
+			} break;
+
+			// No result
+			case MUVGC_OP_EXECUTION_MODE: case MUVGC_OP_DECORATE: case MUVGC_OP_MEMBER_DECORATE:
+			case MUVGC_OP_SELECTION_MERGE: case MUVGC_OP_BRANCH: case MUVGC_OP_RETURN_VALUE: {
+				layout.id_count = 1;
+			} break;
+			case MUVGC_OP_STORE: case MUVGC_OP_LOOP_MERGE: case MUVGC_OP_SWITCH: {
+				layout.id_count = 2;
+			} break;
+			case MUVGC_OP_BRANCH_CONDITIONAL: {
+				layout.id_count = 3;
+			} break;
+			case MUVGC_OP_CONTROL_BARRIER: case MUVGC_OP_MEMORY_BARRIER: {
+				layout.id_count = MUVGC_ALL_OPERANDS;
+			} break;
+		}
+		return layout;
+	}
+
+	// Varints: 7 bits per byte, lowest first, the top bit meaning that
+	// more bytes follow
+
+	size_m muVGC_write_varint(char* b, size_m i, uint32_m value) {
+		while (value >= 0x80) {
+			b[i++] = (char)((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		b[i++] = (char)value;
+		return i;
+	}
+
+	// Returns MU_FALSE if the data ends in the middle of the varint
+	muBool muVGC_read_varint(const unsigned char* b, size_m len, size_m* i, uint32_m* value) {
+		// (Most varints are a single byte)
+		if (*i < len && b[*i] < 0x80) {
+			*value = b[(*i)++];
+			return MU_TRUE;
+		}
+		uint32_m v = 0;
+		for (uint32_m shift = 0; shift < 35; shift += 7) {
+			if (*i >= len) {
+				return MU_FALSE;
+			}
+			unsigned char c = b[(*i)++];
+			v |= ((uint32_m)(c & 0x7F)) << shift;
+			if ((c & 0x80) == 0) {
+				*value = v;
+				return MU_TRUE;
+			}
+		}
+		return MU_FALSE;
+	}
+
+	// Reads a varint without bounds checks; only used where at least 5
+	// bytes are known to be left
+	#define MUVGC_VARINT_GET(b, i, v) { \
+		v = (b)[(i)++]; \
+		if (v >= 0x80) { \
+			v &= 0x7F; \
+			for (uint32_m shift_ = 7; shift_ < 35; shift_ += 7) { \
+				unsigned char c_ = (b)[(i)++]; \
+				v |= ((uint32_m)(c_ & 0x7F)) << shift_; \
+				if ((c_ & 0x80) == 0) break; \
+			} \
+		} \
+	}
+
+	// (Small negative deltas are as cheap as small positive ones)
+	uint32_m muVGC_zigzag(uint32_m delta) {
+		return (delta << 1) ^ ((delta & 0x80000000) ? 0xFFFFFFFF : 0);
+	}
+
+	uint32_m muVGC_unzigzag(uint32_m value) {
+		return (value >> 1) ^ ((value & 1) ? 0xFFFFFFFF : 0);
+	}
+
+	uint32_m muVGC_read_word(const unsigned char* b, size_m i) {
+		return ((uint32_m)b[i]) | (((uint32_m)b[i+1]) << 8) | (((uint32_m)b[i+2]) << 16) | (((uint32_m)b[i+3]) << 24);
+	}
+
+	muString muVGC_compress(muResult* result, const unsigned char* spirv, size_m spirv_len, muString data) {
+		size_m word_len = spirv_len / 4;
+		if (spirv_len % 4 != 0 || word_len < 5 || muVGC_read_word(spirv, 0) != 0x07230203) {
+			*result = MU_FAILURE;
+			return data;
+		}
+
+		// (Worst case: 5 bytes per word, plus 3 more per instruction header)
+		size_m start = data.len;
+		data = mu_string_size_check(data, start + 4 + (word_len * 10) + 1);
+		char* b = data.s;
+		size_m i = start;
+
+		MUVGC_4_BYTE_LE_SET(b, MUVGC_COMPRESSED_MAGIC, i) i += 4;
+		for (size_m w = 1; w < 5; w++) {
+			i = muVGC_write_varint(b, i, muVGC_read_word(spirv, w*4));
+		}
+		i = muVGC_write_varint(b, i, (uint32_m)word_len);
+
+		uint32_m last_result = 0;
+		for (size_m w = 5; w < word_len;) {
+			uint32_m first_word = muVGC_read_word(spirv, w*4);
+			uint32_m word_count = first_word >> 16;
+			uint16_m opcode = (uint16_m)(first_word & 0xFFFF);
+			if (word_count == 0 || w + word_count > word_len) {
+				*result = MU_FAILURE;
+				return data;
+			}
+
+			uint32_m operand_len = word_count - 1;
+			i = muVGC_write_varint(b, i, (((uint32_m)opcode) << 4) | ((operand_len < 15) ? operand_len : 15));
+			if (operand_len >= 15) {
+				i = muVGC_write_varint(b, i, operand_len - 15);
+			}
+
+			muVGCOpcodeLayout layout = muVGC_get_opcode_layout(opcode);
+			size_m o = w+1;
+			size_m end = w + word_count;
+			if (layout.has_type == MU_TRUE && o < end) {
+				i = muVGC_write_varint(b, i, muVGC_read_word(spirv, (o++)*4));
+			}
+			if (layout.has_result == MU_TRUE && o < end) {
+				uint32_m result_id = muVGC_read_word(spirv, (o++)*4);
+				i = muVGC_write_varint(b, i, muVGC_zigzag(result_id - last_result));
+				last_result = result_id;
+			}
+			for (uint16_m id = 0; id < layout.id_count && o < end; id++) {
+				i = muVGC_write_varint(b, i, muVGC_zigzag(last_result - muVGC_read_word(spirv, (o++)*4)));
+			}
+			if (layout.raw_words == MU_TRUE) {
+				for (; o < end; o++) {
+					uint32_m word = muVGC_read_word(spirv, o*4);
+					MUVGC_4_BYTE_LE_SET(b, word, i) i += 4;
+				}
+			}
+			for (; o < end; o++) {
+				i = muVGC_write_varint(b, i, muVGC_read_word(spirv, o*4));
+			}
+
+			w = end;
+		}
+
+		data.len = i;
+		b[i] = 0;
+		return data;
+	}
+
+	muString muVGC_decompress(muResult* result, const unsigned char* data, size_m data_len, muString spirv) {
+		if (data_len < 4 || muVGC_read_word(data, 0) != MUVGC_COMPRESSED_MAGIC) {
+			*result = MU_FAILURE;
+			return spirv;
+		}
+		size_m i = 4;
+		uint32_m header[5] = { 0x07230203, 0, 0, 0, 0 };
+		for (size_m w = 1; w < 5; w++) {
+			if (muVGC_read_varint(data, data_len, &i, &header[w]) == MU_FALSE) {
+				*result = MU_FAILURE;
+				return spirv;
+			}
+		}
+		uint32_m word_len = 0;
+		if (muVGC_read_varint(data, data_len, &i, &word_len) == MU_FALSE || word_len < 5) {
+			*result = MU_FAILURE;
+			return spirv;
+		}
+
+		size_m start = spirv.len;
+		spirv = mu_string_size_check(spirv, start + ((size_m)word_len * 4) + 1);
+		char* b = spirv.s;
+		size_m out = start;
+		size_m out_end = start + ((size_m)word_len * 4);
+		for (size_m w = 0; w < 5; w++) {
+			MUVGC_4_BYTE_LE_SET(b, header[w], out) out += 4;
+		}
+
+		// (Looked up once for the opcodes in the core range rather than per
+		// instruction)
+		muVGCOpcodeLayout layouts[256];
+		for (uint16_m op = 0; op < 256; op++) {
+			layouts[op] = muVGC_get_opcode_layout(op);
+		}
 
-		for (muVGCStatementType type = MUVGC_STATEMENT_FIRST; type <= MUVGC_STATEMENT_LAST; type++) {
-			if (muVGC_check_statement_type(&res, type, tokens, token_len, code, og, &statement.length) == MU_SUCCESS) {
-				if (res != MU_SUCCESS) {
+		uint32_m last_result = 0;
+		while (i < data_len) {
+			uint32_m value = 0;
+			if (muVGC_read_varint(data, data_len, &i, &value) == MU_FALSE) {
+				*result = MU_FAILURE;
+				return spirv;
+			}
+			uint16_m opcode = (uint16_m)(value >> 4);
+			uint32_m operand_len = value & 15;
+			if (operand_len == 15) {
+				uint32_m extra = 0;
+				if (muVGC_read_varint(data, data_len, &i, &extra) == MU_FALSE || extra > 0xFFFF - 16) {
 					*result = MU_FAILURE;
-					return statement;
+					return spirv;
+				}
+				operand_len += extra;
+			}
+			if (out + ((size_m)(operand_len+1) * 4) > out_end) {
+				*result = MU_FAILURE;
+				return spirv;
+			}
+			uint32_m first_word = ((operand_len+1) << 16) | opcode;
+			MUVGC_4_BYTE_LE_SET(b, first_word, out) out += 4;
+
+			muVGCOpcodeLayout layout = (opcode < 256) ? layouts[opcode] : muVGC_get_opcode_layout(opcode);
+			uint32_m o = 0;
+
+			// (With enough data left for the longest possible encoding of the
+			// operands, they can be read without bounds checks; the position
+			// & value are kept in locals whose address is never taken so that
+			// the byte stores can't alias them)
+			if (data_len - i >= (size_m)operand_len * 5) {
+				size_m in = i;
+				uint32_m v = 0;
+				uint32_m last = last_result;
+				if (layout.has_type == MU_TRUE && o < operand_len) {
+					MUVGC_VARINT_GET(data, in, v)
+					MUVGC_4_BYTE_LE_SET(b, v, out) out += 4;
+					o++;
+				}
+				if (layout.has_result == MU_TRUE && o < operand_len) {
+					MUVGC_VARINT_GET(data, in, v)
+					last += muVGC_unzigzag(v);
+					MUVGC_4_BYTE_LE_SET(b, last, out) out += 4;
+					o++;
+				}
+				for (uint16_m id = 0; id < layout.id_count && o < operand_len; id++) {
+					MUVGC_VARINT_GET(data, in, v)
+					v = last - muVGC_unzigzag(v);
+					MUVGC_4_BYTE_LE_SET(b, v, out) out += 4;
+					o++;
 				}
+				if (layout.raw_words == MU_TRUE) {
+					for (; o < operand_len; o++) {
+						b[out++] = (char)data[in++]; b[out++] = (char)data[in++];
+						b[out++] = (char)data[in++]; b[out++] = (char)data[in++];
+					}
+				}
+				for (; o < operand_len; o++) {
+					MUVGC_VARINT_GET(data, in, v)
+					MUVGC_4_BYTE_LE_SET(b, v, out) out += 4;
+				}
+				i = in;
+				last_result = last;
+				continue;
+			}
 
-				statement.type = type;
-				statement.index = total_token_len-token_len;
-				return statement;
+			muBool good = MU_TRUE;
+			if (layout.has_type == MU_TRUE && o < operand_len) {
+				good = muVGC_read_varint(data, data_len, &i, &value);
+				MUVGC_4_BYTE_LE_SET(b, value, out) out += 4;
+				o++;
 			}
-			if (res != MU_SUCCESS) {
+			if (good == MU_TRUE && layout.has_result == MU_TRUE && o < operand_len) {
+				good = muVGC_read_varint(data, data_len, &i, &value);
+				last_result += muVGC_unzigzag(value);
+				MUVGC_4_BYTE_LE_SET(b, last_result, out) out += 4;
+				o++;
+			}
+			for (uint16_m id = 0; good == MU_TRUE && id < layout.id_count && o < operand_len; id++) {
+				good = muVGC_read_varint(data, data_len, &i, &value);
+				uint32_m word = last_result - muVGC_unzigzag(value);
+				MUVGC_4_BYTE_LE_SET(b, word, out) out += 4;
+				o++;
+			}
+			if (good == MU_TRUE && layout.raw_words == MU_TRUE) {
+				if (i + ((size_m)(operand_len - o) * 4) > data_len) {
+					good = MU_FALSE;
+				} else {
+					for (; o < operand_len; o++) {
+						b[out++] = (char)data[i++]; b[out++] = (char)data[i++];
+						b[out++] = (char)data[i++]; b[out++] = (char)data[i++];
+					}
+				}
+			}
+			for (; good == MU_TRUE && o < operand_len; o++) {
+				good = muVGC_read_varint(data, data_len, &i, &value);
+				MUVGC_4_BYTE_LE_SET(b, value, out) out += 4;
+			}
+			if (good == MU_FALSE) {
 				*result = MU_FAILURE;
-				return statement;
+				return spirv;
 			}
 		}
+		if (out != out_end) {
+			*result = MU_FAILURE;
+			return spirv;
+		}
 
-		muVGC_print_syntax_error(og, tokens[0].index);
-		mu_print("unrecognized statement\n");
-
-		*result = MU_FAILURE;
-		return statement;
+		spirv.len = out;
+		b[out] = 0;
+		return spirv;
 	}
 
-	muVGCStatement* muVGC_get_statements(
-		muVGCToken* tokens, size_m token_len, const char* code, const char* og, size_m* statement_length) {
-
-		// Similar issue to retrieving tokens, as I have to do the process twice
+/* COMPILE HANDLING */
 
+	// Compiles the code's tokens (once macros have been handled) into
+	// bytecode, freeing the tokens, code & module
+	muString muVGC_compile_tokens(muResult* result, muVGCToken* tokens, size_m token_len, muString code_str, const char* code, muVGCModule* module, muVGCShader shader, const muVGCOptions* options, muVGCReflection* reflection) {
 		muResult res = MU_SUCCESS;
-		size_m statement_len = 0;
 
-		for (size_m i = 0; i < token_len;) {
-			muVGCStatement statement = muVGC_get_statement(&res, &tokens[i], token_len-i, token_len, code, og);
+		// Statement-ize code
 
-			if (res != MU_SUCCESS) {
-				return MU_NULL_PTR;
+		size_m statement_len = 0;
+		muVGCStatement* statements = muVGC_get_statements(tokens, token_len, code_str.s, code, &statement_len);
+		if (statements == MU_NULL_PTR) {
+			if (result != MU_NULL_PTR) {
+				*result = MU_FAILURE;
 			}
-			statement_len++;
-			i += statement.length;
-		}
-
-		if (statement_len == 0) {
-			// Not exactly sure what would ever cause this, but allowing malloc to call will
-			// cause an immediate crash, so, yeah
-			mu_print("[muVGC] Syntax error; expected at least one statement after version\n");
-			return MU_NULL_PTR;
-		}
-		muVGCStatement* statements = mu_malloc(sizeof(muVGCStatement) * statement_len);
-
-		size_m index = 0;
-		for (size_m i = 0; i < token_len;) {
-			muVGCStatement statement = muVGC_get_statement(&res, &tokens[i], token_len-i, token_len, code, og);
 
-			if (res != MU_SUCCESS) {
-				mu_free(statements);
-				return MU_NULL_PTR;
-			}
-			statements[index] = statement;
-			index++;
-			i += statement.length;
+			mu_free(tokens);
+			code_str = mu_string_destroy(code_str);
+			muVGC_free_module(module);
+			return (muString){ 0 };
 		}
 
-		*statement_length = statement_len;
-		return statements;
-	}
-
-	// Statement execution
+		// Start variable list
 
-	muString muVGC_execute_function(
-		muResult* result, muString bytecode, muVGCStatement* statements, size_m statement_len,
-		muVGCToken* tokens, size_m token_len, const char* code, const char* og,
-		uint32_m* global_id, muVGCVariableList* varlist) {
+		muVGCVariableList varlist = muVGC_intialize_empty_variable_list();
 
-		size_m scope_count = 0;
-		muResult res = MU_SUCCESS;
-		size_m i = 1;
+		// Execute statements
 
-		bytecode = muVGC_execute_statement_type(&res, statements[0].type, tokens, token_len, code, og, bytecode, &scope_count, global_id, varlist);
+		muVGC_execute_statements(&res, module, statements, statement_len, tokens, token_len, code_str.s, code, &varlist);
 		if (res != MU_SUCCESS) {
-			*result = MU_FAILURE;
-			return bytecode;
-		}
-
-		while (scope_count > 0 && i < token_len && tokens[i].type != MUVGC_TOKEN_END_OF_FILE) {
-			bytecode = muVGC_execute_statement_type(&res, statements[i].type, &tokens[i], token_len-i, code, og, bytecode, &scope_count, global_id, varlist);
-			if (res != MU_SUCCESS) {
+			if (result != MU_NULL_PTR) {
 				*result = MU_FAILURE;
-				return bytecode;
 			}
 
-			i++;
-		}
-
-		if (scope_count > 0 && (i >= token_len || tokens[i].type == MUVGC_TOKEN_END_OF_FILE)) {
-			muVGC_print_syntax_error(og, tokens[token_len-1].index);
-			mu_print("expected a close brace before end of file\n");
-			*result = MU_FAILURE;
-			return bytecode;
+			varlist = muVGC_empty_variable_list(varlist);
+			mu_free(statements);
+			mu_free(tokens);
+			code_str = mu_string_destroy(code_str);
+			muVGC_free_module(module);
+			return (muString){ 0 };
 		}
 
-		return bytecode;
-	}
+		// Prune outputs
 
-	muString muVGC_declare_main_function(
-		muResult* result, muString bytecode, muVGCStatement* statements, size_m statement_len,
-		muVGCToken* tokens, size_m token_len, const char* code, const char* og,
-		uint32_m* global_id, muVGCVariableList* varlist) {
+		if (options->prune_outputs == MU_TRUE && shader == MUVGC_VERTEX) {
+			muVGC_prune_outputs(module, options->next_stage_input_locations);
+		}
 
-		muBool found_main = MU_FALSE;
-		for (size_m i = 0; i < statement_len; i++) {
-			if (statements[i].type == MUVGC_STATEMENT_FUNCTION_IMPLEMENTATION &&
-				tokens[statements[i].index+1].length == 4 &&
-				mu_strncmp(muVGC_get_token_value(code, tokens[statements[i].index+1]), "main", 4) == 0) {
+		// Optimize module
 
-				if (found_main == MU_TRUE) {
-					muVGC_print_syntax_error(og, tokens[statements[i].index+1].index);
-					mu_print("multiple entry point 'main' functions declared\n");
-					*result = MU_FAILURE;
-					return bytecode;
-				}
-				found_main = MU_TRUE;
+		muVGC_optimize_module(module);
 
-				if ((tokens[statements[i].index].length != 4) ||
-					(mu_strncmp(muVGC_get_token_value(code, tokens[statements[i].index]), "void", 4) != 0)) {
+		// Reflect module
 
-					muVGC_print_syntax_error(og, tokens[statements[i].index].index);
-					mu_print("entry point 'main' function declared as something else than void\n");
-					*result = MU_FAILURE;
-					return bytecode;
-				}
+		if (reflection != MU_NULL_PTR) {
+			muVGC_get_reflection(module, reflection);
+		}
 
-				if ((tokens[statements[i].index+3].type != MUVGC_TOKEN_CLOSE_PARENTHESIS)) {
-					muVGC_print_syntax_error(og, tokens[statements[i].index+3].index);
-					mu_print("entry point 'main' function declared with parameters\n");
-					*result = MU_FAILURE;
-					return bytecode;
-				}
+		// Serialize module
 
-				muResult res = MU_SUCCESS;
-				bytecode = muVGC_execute_function(&res, bytecode, statements, statement_len, tokens, token_len, code, og, global_id, varlist);
-				if (res != MU_SUCCESS) {
-					*result = MU_FAILURE;
-					return bytecode;
-				}
-			}
-		}
+		muString bytecode_str = mu_string_create_raw((char*)"\0", 1);
+		bytecode_str = mu_string_delete(bytecode_str, 0, 1);
+		bytecode_str = muVGC_module_serialize(module, bytecode_str);
 
-		if (found_main == MU_FALSE) {
-			mu_print("[muVGC] Error while compiling; no entry point 'main' function found\n");
-			*result = MU_FAILURE;
-			return bytecode;
-		}
+		// Deallocate and return
 
-		return bytecode;
+		varlist = muVGC_empty_variable_list(varlist);
+		mu_free(statements);
+		mu_free(tokens);
+		code_str = mu_string_destroy(code_str);
+		muVGC_free_module(module);
+		return bytecode_str;
 	}
 
-	muString muVGC_execute_statements(
-		muResult* result, muString bytecode, muVGCStatement* statements, size_m statement_len,
-		muVGCToken* tokens, size_m token_len, const char* code, const char* og,
-		uint32_m* global_id, muVGCVariableList* varlist) {
+	// Permutations
+
+	// Permutations of a shader are compiled from the same lexed code: the
+	// code has its comments & version handled and is lexed once, and each
+	// permutation then preprocesses those tokens under its defines. Work is
+	// shared between permutations in two ways:
+	// * A permutation whose define set agrees with an earlier one's on every
+	// given macro that preprocessing the earlier one looked up takes its
+	// result without being preprocessed (see muVGCMacroWatch); defines
+	// that the code never checks cost nothing.
+	// * What's compiled is just the text of the tokens that come out of
+	// preprocessing, so permutations whose defines checked by the code
+	// still come out as the same text (checks to the same effect) share a
+	// compile, found by comparing the text of their tokens.
+
+	// The text of a permutation's tokens (a space between each)
+	struct muVGCPermutationText {
+		muString text;
+		uint32_m hash;
+		// Whether it was preprocessed (and so can be shared)
+		muBool valid;
+	};
+	typedef struct muVGCPermutationText muVGCPermutationText;
 
-		muResult res = MU_SUCCESS;
+	muVGCPermutationText muVGC_get_permutation_text(const char* code, const muVGCToken* tokens, size_m token_len) {
+		size_m len = 0;
+		for (size_m i = 0; i < token_len; i++) {
+			len += tokens[i].length + 1;
+		}
 
-		bytecode = muVGC_declare_main_function(&res, bytecode, statements, statement_len, tokens, token_len, code, og, global_id, varlist);
-		if (res != MU_SUCCESS) {
-			*result = MU_FAILURE;
-			return bytecode;
+		muVGCPermutationText text = { 0 };
+		text.text = mu_string_create_raw((char*)"\0", 1);
+		text.text = mu_string_size_check(text.text, len + 1);
+		size_m t = 0;
+		for (size_m i = 0; i < token_len; i++) {
+			for (size_m c = 0; c < tokens[i].length; c++) {
+				text.text.s[t++] = code[tokens[i].index + c];
+			}
+			text.text.s[t++] = ' ';
 		}
+		text.text.s[t] = '\0';
+		text.text.len = t;
+		text.hash = muVGC_hash_name(text.text.s, t);
+		text.valid = MU_TRUE;
+		return text;
+	}
 
-		return bytecode;
+	muBool muVGC_are_permutation_texts_equal(muVGCPermutationText* a, muVGCPermutationText* b) {
+		if (a->valid == MU_FALSE || b->valid == MU_FALSE || a->hash != b->hash || a->text.len != b->text.len) {
+			return MU_FALSE;
+		}
+		return (mu_strncmp(a->text.s, b->text.s, a->text.len) == 0) ? MU_TRUE : MU_FALSE;
 	}
 
 /* API-LEVEL FUNCS */
 
 	MUDEF muString mu_compile_vulkan_glsl(muResult* result, const char* code, muVGCShader shader) {
+		return mu_compile_vulkan_glsl_with_options(result, code, shader, MU_NULL_PTR);
+	}
+
+	MUDEF muString mu_compile_vulkan_glsl_with_options(muResult* result, const char* code, muVGCShader shader, const muVGCOptions* options) {
+		return mu_compile_vulkan_glsl_with_reflection(result, code, shader, options, MU_NULL_PTR);
+	}
+
+	MUDEF muString mu_compile_vulkan_glsl_with_reflection(muResult* result, const char* code, muVGCShader shader, const muVGCOptions* options, muVGCReflection* reflection) {
 		if (result != MU_NULL_PTR) {
 			*result = MU_SUCCESS;
 		}
+		// (Left empty if compiling fails)
+		if (reflection != MU_NULL_PTR) {
+			muVGCReflection empty = { 0 };
+			*reflection = empty;
+		}
 		muResult res = MU_SUCCESS;
 
+		#ifndef NDEBUG
+		if (muVGC_keyword_hash_table_is_current() == MU_FALSE) {
+			mu_print("[muVGC] Internal error; muVGC_global_keyword_hash_table is out of date with muVGC_global_keywords\n");
+			if (result != MU_NULL_PTR) {
+				*result = MU_FAILURE;
+			}
+			return (muString){ 0 };
+		}
+		#endif
+
+		muVGCOptions default_options = { 0 };
+		if (options == MU_NULL_PTR) {
+			options = &default_options;
+		}
+
 		muString code_str = mu_string_create((char*)code);
-		muString bytecode_str = mu_string_create_raw((char*)"\0", 1);
-		bytecode_str = mu_string_delete(bytecode_str, 0, 1);
+		muVGCModule module;
+		muVGC_initialize_module(&module);
+		module.strip_debug = options->strip_debug;
 
 		// Handle comments
 
@@ -3813,81 +17079,245 @@ extern "C" { // }
 			}
 
 			code_str = mu_string_destroy(code_str);
-			bytecode_str = mu_string_destroy(bytecode_str);
+			muVGC_free_module(&module);
 			return (muString){ 0 };
 		}
 
-		// Handle macros
+		// Handle macros & tokenize code
 
-		bytecode_str = muVGC_handle_macros(&res, code_str, code, bytecode_str, shader);
+		size_m token_len = 0;
+		muVGCToken* tokens = muVGC_handle_macros(&res, &code_str, code, &module, shader, options, MU_NULL_PTR, MU_NULL_PTR, MU_NULL_PTR, &token_len);
 		if (res != MU_SUCCESS) {
 			if (result != MU_NULL_PTR) {
 				*result = MU_FAILURE;
 			}
 
 			code_str = mu_string_destroy(code_str);
-			bytecode_str = mu_string_destroy(bytecode_str);
+			muVGC_free_module(&module);
 			return (muString){ 0 };
 		}
 
-		// Tokenize code
+		return muVGC_compile_tokens(result, tokens, token_len, code_str, code, &module, shader, options, reflection);
+	}
+
+	MUDEF void mu_free_vulkan_glsl_reflection(muVGCReflection* reflection) {
+		muVGC_free_reflection(reflection);
+	}
 
-		size_m token_len = 0;
-		muVGCToken* tokens = muVGC_tokenize_code(code_str.s, mu_string_strlen(code_str), code, &token_len);
-		if (tokens == MU_NULL_PTR) {
-			if (result != MU_NULL_PTR) {
-				*result = MU_FAILURE;
+	MUDEF void mu_compile_vulkan_glsl_permutations(muResult* results, muString* bytecodes, const char* code, muVGCShader shader, const muVGCOptions* options, const muVGCDefineSet* define_sets, size_m define_set_len) {
+		for (size_m i = 0; i < define_set_len; i++) {
+			if (results != MU_NULL_PTR) {
+				results[i] = MU_SUCCESS;
 			}
+			bytecodes[i] = (muString){ 0 };
+		}
+		if (define_set_len == 0) {
+			return;
+		}
+		muResult res = MU_SUCCESS;
 
-			code_str = mu_string_destroy(code_str);
-			bytecode_str = mu_string_destroy(bytecode_str);
-			return (muString){ 0 };
+		#ifndef NDEBUG
+		if (muVGC_keyword_hash_table_is_current() == MU_FALSE) {
+			mu_print("[muVGC] Internal error; muVGC_global_keyword_hash_table is out of date with muVGC_global_keywords\n");
+			for (size_m i = 0; results != MU_NULL_PTR && i < define_set_len; i++) {
+				results[i] = MU_FAILURE;
+			}
+			return;
 		}
+		#endif
 
-		// Statement-ize code
+		muVGCOptions default_options = { 0 };
+		if (options == MU_NULL_PTR) {
+			options = &default_options;
+		}
 
-		size_m statement_len = 0;
-		muVGCStatement* statements = muVGC_get_statements(tokens, token_len, code_str.s, code, &statement_len);
-		if (statements == MU_NULL_PTR) {
-			if (result != MU_NULL_PTR) {
-				*result = MU_FAILURE;
-			}
+		// Handle comments
 
-			mu_free(tokens);
+		muString code_str = mu_string_create((char*)code);
+		code_str = muVGC_handle_comments(&res, code_str);
+		if (res != MU_SUCCESS) {
+			for (size_m i = 0; results != MU_NULL_PTR && i < define_set_len; i++) {
+				results[i] = MU_FAILURE;
+			}
 			code_str = mu_string_destroy(code_str);
-			bytecode_str = mu_string_destroy(bytecode_str);
-			return (muString){ 0 };
+			return;
 		}
 
-		// Start variable list
+		// Lex code (with its version cleared, as it is when preprocessed)
+
+		muVGCCachedFile source = { 0 };
+		source.code = mu_string_create(code_str.s);
+		muVGCModule version_module;
+		muVGC_initialize_module(&version_module);
+		uint32_m version = 0;
+		muVGC_macro_handle_version(&res, source.code, code, &version_module, shader, &version);
+		muVGC_free_module(&version_module);
+		if (res == MU_SUCCESS) {
+			muVGC_lex_cached_file(&source);
+		}
 
-		muVGCVariableList varlist = muVGC_intialize_empty_variable_list();
+		// (Included files are shared between permutations)
+		muVGCOptions permutation_options = *options;
+		if (permutation_options.include_cache == MU_NULL_PTR) {
+			permutation_options.include_cache = mu_create_vulkan_glsl_include_cache();
+		}
 
-		// Execute statements
+		// Watch the names of every define set's macros
 
-		uint32_m global_id = 2;
-		bytecode_str = muVGC_execute_statements(&res, bytecode_str, statements, statement_len, tokens, token_len, code_str.s, code, &global_id, &varlist);
-		if (res != MU_SUCCESS) {
-			if (result != MU_NULL_PTR) {
-				*result = MU_FAILURE;
+		muVGCMacroWatch watch = { 0 };
+		watch.define_sets = define_sets;
+		size_m define_len = 0;
+		for (size_m i = 0; i < define_set_len; i++) {
+			define_len += define_sets[i].define_len;
+		}
+		watch.names = (const char**)mu_malloc(sizeof(const char*) * (define_len+1));
+		watch.name_lens = (size_m*)mu_malloc(sizeof(size_m) * (define_len+1));
+		for (size_m i = 0; i < define_set_len; i++) {
+			for (size_m d = 0; d < define_sets[i].define_len; d++) {
+				const char* name = define_sets[i].defines[d].name;
+				size_m namelen = muVGC_get_define_name_length(name);
+				size_m n = 0;
+				while (n < watch.name_len && (watch.name_lens[n] != namelen || mu_strncmp(watch.names[n], name, namelen) != 0)) {
+					n++;
+				}
+				if (n == watch.name_len) {
+					watch.names[n] = name;
+					watch.name_lens[n] = namelen;
+					watch.name_len += 1;
+				}
+			}
+		}
+		watch.read = (muBool*)mu_malloc(sizeof(muBool) * (watch.name_len * define_set_len + 1));
+		for (size_m i = 0; i < watch.name_len * define_set_len; i++) {
+			watch.read[i] = MU_FALSE;
+		}
+		watch.preprocessed = (muBool*)mu_malloc(sizeof(muBool) * define_set_len);
+		for (size_m i = 0; i < define_set_len; i++) {
+			watch.preprocessed[i] = MU_FALSE;
+		}
+
+		// Compile each permutation
+
+		muVGCPermutationText* texts = (muVGCPermutationText*)mu_malloc(sizeof(muVGCPermutationText) * define_set_len);
+		for (size_m i = 0; i < define_set_len; i++) {
+			texts[i] = (muVGCPermutationText){ 0 };
+			// (An invalid version fails every permutation, as a compile
+			// would)
+			if (res != MU_SUCCESS) {
+				if (results != MU_NULL_PTR) {
+					results[i] = MU_FAILURE;
+				}
+				continue;
 			}
 
-			mu_free(statements);
-			mu_free(tokens);
-			code_str = mu_string_destroy(code_str);
-			bytecode_str = mu_string_destroy(bytecode_str);
-			return (muString){ 0 };
+			muResult permutation_res = MU_SUCCESS;
+			muString permutation_code = mu_string_create(code_str.s);
+			muVGCModule module;
+			muVGC_initialize_module(&module);
+			module.strip_debug = options->strip_debug;
+
+			size_m token_len = 0;
+			watch.current = i;
+			watch.reused = MUVGC_NO_PERMUTATION;
+			muVGCToken* tokens = muVGC_handle_macros(&permutation_res, &permutation_code, code, &module, shader, &permutation_options, &source, &define_sets[i], &watch, &token_len);
+			if (permutation_res != MU_SUCCESS) {
+				if (results != MU_NULL_PTR) {
+					results[i] = MU_FAILURE;
+				}
+				permutation_code = mu_string_destroy(permutation_code);
+				muVGC_free_module(&module);
+				continue;
+			}
+
+			// Share the result of an earlier permutation that read the same
+			// defines, or the compile of one with the same tokens
+			size_m same = watch.reused;
+			if (same == MUVGC_NO_PERMUTATION) {
+				texts[i] = muVGC_get_permutation_text(permutation_code.s, tokens, token_len);
+				for (size_m j = 0; j < i; j++) {
+					if (muVGC_are_permutation_texts_equal(&texts[i], &texts[j]) == MU_TRUE) {
+						same = j;
+						break;
+					}
+				}
+			}
+			if (same != MUVGC_NO_PERMUTATION) {
+				if (results != MU_NULL_PTR) {
+					results[i] = results[same];
+				}
+				if (bytecodes[same].s != MU_NULL_PTR) {
+					bytecodes[i] = mu_string_create_raw(bytecodes[same].s, bytecodes[same].len);
+				}
+				if (tokens != MU_NULL_PTR) {
+					mu_free(tokens);
+				}
+				permutation_code = mu_string_destroy(permutation_code);
+				muVGC_free_module(&module);
+				continue;
+			}
+
+			bytecodes[i] = muVGC_compile_tokens(&permutation_res, tokens, token_len, permutation_code, code, &module, shader, &permutation_options, MU_NULL_PTR);
+			if (results != MU_NULL_PTR) {
+				results[i] = permutation_res;
+			}
 		}
 
-		// Deallocate and return
+		// Deallocate
 
-		varlist = muVGC_empty_variable_list(varlist);
-		mu_free(statements);
-		mu_free(tokens);
+		for (size_m i = 0; i < define_set_len; i++) {
+			texts[i].text = mu_string_destroy(texts[i].text);
+		}
+		mu_free(texts);
+		mu_free(watch.names);
+		mu_free(watch.name_lens);
+		mu_free(watch.read);
+		mu_free(watch.preprocessed);
+		if (options->include_cache == MU_NULL_PTR) {
+			mu_destroy_vulkan_glsl_include_cache(permutation_options.include_cache);
+		}
+		muVGC_free_cached_file(&source);
 		code_str = mu_string_destroy(code_str);
-		// (+ set max bound)
-		MUVGC_4_BYTE_LE_SET(bytecode_str.s, global_id, 12)
-		return bytecode_str;
+	}
+
+	MUDEF muVGCIncludeCache* mu_create_vulkan_glsl_include_cache(void) {
+		muVGCIncludeCache* cache = (muVGCIncludeCache*)mu_malloc(sizeof(muVGCIncludeCache));
+		*cache = (muVGCIncludeCache){ 0 };
+		return cache;
+	}
+
+	MUDEF void mu_destroy_vulkan_glsl_include_cache(muVGCIncludeCache* cache) {
+		muVGC_free_include_cache(cache);
+		mu_free(cache);
+	}
+
+	MUDEF muString mu_compress_spirv(muResult* result, const char* spirv, size_m spirv_len) {
+		muResult res = MU_SUCCESS;
+		muString data = mu_string_create_raw((char*)"\0", 1);
+		data = mu_string_delete(data, 0, 1);
+		data = muVGC_compress(&res, (const unsigned char*)spirv, spirv_len, data);
+		if (result != MU_NULL_PTR) {
+			*result = res;
+		}
+		if (res != MU_SUCCESS) {
+			data = mu_string_destroy(data);
+			return (muString){ 0 };
+		}
+		return data;
+	}
+
+	MUDEF muString mu_decompress_spirv(muResult* result, const char* data, size_m data_len) {
+		muResult res = MU_SUCCESS;
+		muString spirv = mu_string_create_raw((char*)"\0", 1);
+		spirv = mu_string_delete(spirv, 0, 1);
+		spirv = muVGC_decompress(&res, (const unsigned char*)data, data_len, spirv);
+		if (result != MU_NULL_PTR) {
+			*result = res;
+		}
+		if (res != MU_SUCCESS) {
+			spirv = mu_string_destroy(spirv);
+			return (muString){ 0 };
+		}
+		return spirv;
 	}
 
 /* end */